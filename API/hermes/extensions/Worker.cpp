@@ -552,7 +552,10 @@ std::string copyBufferBytes(
 /// Shared by all constructor input types.
 void startWorker(jsi::Runtime &rt, jsi::Object self, std::string script) {
   auto *api = jsi::castInterface<IHermesRootAPI>(makeHermesRootAPI());
-  auto workerRuntime = api->makeHermesRuntime(::hermes::vm::RuntimeConfig());
+  // Workers run on their own thread, so unlike the main runtime they may
+  // block in Atomics.wait.
+  auto workerRuntime = api->makeHermesRuntime(
+      ::hermes::vm::RuntimeConfig::Builder().withAgentCanSuspend(true).build());
   auto workerState = std::make_shared<WorkerState>(rt, self);
 
   installPostMessageFromWorker(*workerRuntime, workerState);
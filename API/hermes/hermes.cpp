@@ -22,7 +22,6 @@
 #include "hermes/Support/Buffer.h"
 #include "hermes/Support/SerialExecutor.h"
 #include "hermes/Support/SimpleDiagHandler.h"
-#include "hermes/Support/UTF16Stream.h"
 #include "hermes/Support/UTF8.h"
 #include "hermes/VM/CallResult.h"
 #include "hermes/VM/Debugger/Debugger.h"
@@ -34,6 +33,7 @@
 #include "hermes/VM/JSLib.h"
 #include "hermes/VM/JSLib/JSLibStorage.h"
 #include "hermes/VM/JSLib/RuntimeJSONParse.h"
+#include "hermes/VM/JSLib/RuntimeJSONStringify.h"
 #include "hermes/VM/JSTypedArray.h"
 #include "hermes/VM/NativeState.h"
 #include "hermes/VM/Operations.h"
@@ -252,6 +252,7 @@ using ScheduleCallbackFunc = std::function<void(EventLoopCallback)>;
 
 class HermesRuntimeImpl final : public HermesRuntime,
                                 private IHermesTestHelpers,
+                                private IHermesJSON,
                                 private InstallHermesFatalErrorHandler,
                                 private jsi::Instrumentation,
                                 public ISetEventLoopControl
@@ -412,6 +413,7 @@ class HermesRuntimeImpl final : public HermesRuntime,
     BRIDGE_INFO(double, info, heapSize);
     BRIDGE_INFO(double, info, va);
     BRIDGE_INFO(double, info, externalBytes);
+    BRIDGE_INFO(double, info, numParallelYoungCollections);
     if (includeExpensive) {
       BRIDGE_INFO(double, info, mallocSizeEstimate);
     }
@@ -431,6 +433,10 @@ class HermesRuntimeImpl final : public HermesRuntime,
     jsInfo["hermes_peakAllocatedBytes"] =
         runtime_.getHeap().getPeakAllocatedBytes();
     jsInfo["hermes_peakLiveAfterGC"] = runtime_.getHeap().getPeakLiveAfterGC();
+    for (size_t i = 0; i < info.youngGenEvacuatedBytesPerWorker.size(); ++i) {
+      jsInfo["hermes_yg_evacuatedBytes_worker" + std::to_string(i)] =
+          info.youngGenEvacuatedBytesPerWorker[i];
+    }
 
 #define BRIDGE_GEN_INFO(NAME, STAT_EXPR, FACTOR)                    \
   jsInfo["hermes_full_" #NAME] = info.fullStats.STAT_EXPR * FACTOR; \
@@ -1335,6 +1341,12 @@ class HermesRuntimeImpl final : public HermesRuntime,
   void *getVMRuntimeUnsafe() const override;
   size_t rootsListLengthForTests() const override;
 
+  bool stringifyJSON(
+      const jsi::Value &value,
+      const JSONSink &sink,
+      unsigned indent,
+      size_t chunkSize) override;
+
   ManagedValues<vm::PinnedHermesValue> hermesValues_;
   ManagedValues<vm::WeakRoot<vm::JSObject>> weakHermesValues_;
   std::shared_ptr<::hermes::vm::Runtime> rt_;
@@ -1618,6 +1630,8 @@ jsi::ICast *HermesRuntimeImpl::getHermesRootAPI() {
 jsi::ICast *HermesRuntimeImpl::castInterface(const jsi::UUID &interfaceUUID) {
   if (interfaceUUID == IHermesTestHelpers::uuid) {
     return static_cast<IHermesTestHelpers *>(this);
+  } else if (interfaceUUID == IHermesJSON::uuid) {
+    return static_cast<IHermesJSON *>(this);
   } else if (interfaceUUID == IHermes::uuid) {
     return static_cast<IHermes *>(this);
   } else if (interfaceUUID == IHermesSHUnit::uuid) {
@@ -2548,13 +2562,33 @@ jsi::Value HermesRuntimeImpl::createValueFromJsonUtf8(
     size_t length) {
   ExecutionScopeRAII scopeRAII(mutatorScope);
   vm::GCScope gcScope(runtime_);
-  llvh::ArrayRef<uint8_t> ref(json, length);
   vm::CallResult<vm::HermesValue> res =
-      runtimeJSONParseRef(runtime_, ::hermes::UTF16Stream(ref));
+      vm::runtimeJSONParseUTF8(runtime_, llvh::ArrayRef<uint8_t>(json, length));
   checkStatus(res.getStatus());
   return valueFromHermesValue(*res);
 }
 
+bool HermesRuntimeImpl::stringifyJSON(
+    const jsi::Value &value,
+    const JSONSink &sink,
+    unsigned indent,
+    size_t chunkSize) {
+  ExecutionScopeRAII scopeRAII(mutatorScope);
+  vm::GCScope gcScope(runtime_);
+  vm::PinnedHermesValue numberStorage;
+  vm::PinnedHermesValue space =
+      vm::HermesValue::encodeTrustedNumberValue(indent);
+  vm::CallResult<bool> res = vm::runtimeJSONStringifyToSink(
+      runtime_,
+      vmHandleFromValue(value, &numberStorage),
+      vm::Runtime::getUndefinedValue(),
+      vm::Handle<>(&space),
+      [&sink](llvh::StringRef chunk) { sink(chunk.data(), chunk.size()); },
+      chunkSize);
+  checkStatus(res.getStatus());
+  return *res;
+}
+
 jsi::Object HermesRuntimeImpl::createObject() {
   ExecutionScopeRAII scopeRAII(mutatorScope);
   vm::GCScope gcScope(runtime_);
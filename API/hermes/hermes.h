@@ -8,6 +8,7 @@
 #pragma once
 
 #include <exception>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -172,6 +173,39 @@ class HERMES_EXPORT IHermesTestHelpers : public jsi::ICast {
   ~IHermesTestHelpers() = default;
 };
 
+/// Interface for exchanging JSON text with native code directly, without
+/// creating a JS string to hold it.
+class HERMES_EXPORT IHermesJSON : public jsi::ICast {
+ public:
+  static constexpr jsi::UUID uuid{
+      0x3437a0eb,
+      0x55bc,
+      0x483e,
+      0x9378,
+      0x14819dfda8fa};
+
+  /// Receives a chunk of UTF-8 encoded JSON output.
+  using JSONSink = std::function<void(const char *data, size_t size)>;
+
+  /// Serialize \p value as if by JSON.stringify(value, null, indent), but pass
+  /// the UTF-8 output to \p sink in chunks of about \p chunkSize bytes instead
+  /// of creating a string. Only about one chunk is buffered at a time, although
+  /// a single string or property name is never split across chunks.
+  /// \return false if \p value has no JSON representation (e.g. a function),
+  ///   in which case \p sink is not called.
+  /// \throw jsi::JSError if serialization throws (e.g. on a cycle or in a
+  ///   toJSON method), in which case part of the output may already have been
+  ///   passed to \p sink.
+  virtual bool stringifyJSON(
+      const jsi::Value &value,
+      const JSONSink &sink,
+      unsigned indent = 0,
+      size_t chunkSize = 64 * 1024) = 0;
+
+ protected:
+  ~IHermesJSON() = default;
+};
+
 #ifdef JSI_UNSTABLE
 // Interface for methods that are exposed for tracing purposes.
 class IHermesTracingHelpers : public jsi::ICast {
@@ -157,9 +157,11 @@ napi_detach_arraybuffer(napi_env env, napi_value arraybuffer) {
       napi_arraybuffer_expected);
 
   auto *ab = vmcast<JSArrayBuffer>(*phv);
-  // An already-detached buffer is not detachable.
+  // An already-detached buffer or a SharedArrayBuffer is not detachable.
   RETURN_STATUS_IF_FALSE(
-      env, ab->attached(), napi_detachable_arraybuffer_expected);
+      env,
+      ab->attached() && !ab->shared(),
+      napi_detachable_arraybuffer_expected);
 
   Runtime &runtime = env->runtime;
 
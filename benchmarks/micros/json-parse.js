@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Benchmark for JSON.parse throughput, in MB/s of JSON text.
+
+(function () {
+  var ITERATIONS = 20;
+  var NUM_RECORDS = 20000;
+  var log = typeof print === "undefined" ? console.log : print;
+  var parse = JSON.parse;
+
+  // Build an array of records resembling an API response.
+  function makeRecords(nonASCII) {
+    var records = [];
+    for (var i = 0; i < NUM_RECORDS; i++) {
+      records.push({
+        id: i,
+        name: (nonASCII ? "näme " : "name ") + i,
+        email: "user" + i + "@example.com",
+        score: i * 1.5,
+        active: i % 2 === 0,
+        tags: ["alpha", "beta", "gamma"],
+        bio:
+          "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do " +
+          'eiusmod tempor "incididunt" ut labore\\et dolore magna aliqua.',
+        parent: null,
+      });
+    }
+    return records;
+  }
+
+  function bench(name, text) {
+    var start = Date.now();
+    for (var i = 0; i < ITERATIONS; i++) {
+      parse(text);
+    }
+    var elapsed = Date.now() - start;
+    var mb = (text.length * ITERATIONS) / (1024 * 1024);
+    var mbPerSec = (mb / (elapsed / 1000)).toFixed(1);
+    log(name + ": " + elapsed + " ms, " + mbPerSec + " MB/s");
+  }
+
+  var ascii = makeRecords(false);
+  var nonASCII = makeRecords(true);
+  var compact = JSON.stringify(ascii);
+  log("JSON.parse benchmark");
+  var sizeMB = (compact.length / (1024 * 1024)).toFixed(1);
+  log("Input size: " + sizeMB + " MB, iterations: " + ITERATIONS);
+  log("--------------------------------------------");
+  bench("compact ASCII", compact);
+  bench("indented ASCII", JSON.stringify(ascii, null, 2));
+  bench("compact UTF-16", JSON.stringify(nonASCII));
+  bench("indented UTF-16", JSON.stringify(nonASCII, null, 2));
+})();
@@ -6,8 +6,10 @@
  */
 
 (function() {
-  var ARRAY_SIZE = 10000;
-  var ITERATIONS = 2000;
+  // Array sizes to sweep. Each size sorts roughly TOTAL_ELEMENTS elements in
+  // total, so the times of different sizes are comparable per element.
+  var ARRAY_SIZES = [16, 256, 4096, 65536, 1048576];
+  var TOTAL_ELEMENTS = 1 << 23;
 
   var int8Sort = Int8Array.prototype.sort;
   var uint8Sort = Uint8Array.prototype.sort;
@@ -22,32 +24,44 @@
   var float64Sort = Float64Array.prototype.sort;
 
   // Generate a template of random bytes to fill arrays from.
-  var templateBuf = new ArrayBuffer(ARRAY_SIZE * 8); // big enough for Float64
+  var maxSize = ARRAY_SIZES[ARRAY_SIZES.length - 1];
+  var templateBuf = new ArrayBuffer(maxSize * 8); // big enough for Float64
   var templateBytes = new Uint8Array(templateBuf);
   for (var i = 0; i < templateBytes.length; i++) {
     templateBytes[i] = (Math.random() * 256) | 0;
   }
 
   function bench(name, TypedArrayCtor, sortFn) {
-    // Create the source array from our random template buffer.
-    var source = new TypedArrayCtor(
-      templateBuf.slice(0, ARRAY_SIZE * TypedArrayCtor.BYTES_PER_ELEMENT)
-    );
-    var arr = new TypedArrayCtor(ARRAY_SIZE);
-    var start = Date.now();
-    for (var i = 0; i < ITERATIONS; i++) {
-      // Reset to unsorted data.
-      arr.set(source);
-      // Sort using the captured function.
-      sortFn.call(arr);
+    var line = name;
+    for (var s = 0; s < ARRAY_SIZES.length; s++) {
+      var size = ARRAY_SIZES[s];
+      var iterations = Math.max(1, TOTAL_ELEMENTS / size);
+      // Create the source array from our random template buffer.
+      var source = new TypedArrayCtor(
+        templateBuf.slice(0, size * TypedArrayCtor.BYTES_PER_ELEMENT)
+      );
+      var arr = new TypedArrayCtor(size);
+      var start = Date.now();
+      for (var i = 0; i < iterations; i++) {
+        // Reset to unsorted data.
+        arr.set(source);
+        // Sort using the captured function.
+        sortFn.call(arr);
+      }
+      var elapsed = Date.now() - start;
+      line += ("        " + elapsed).slice(-9);
     }
-    var elapsed = Date.now() - start;
-    print(name + ": " + elapsed + " ms");
+    print(line + " ms");
   }
 
   print("TypedArray.prototype.sort benchmark");
-  print("Array size: " + ARRAY_SIZE + ", iterations: " + ITERATIONS);
-  print("--------------------------------------------");
+  print("Elements sorted per size: " + TOTAL_ELEMENTS);
+  var header = "Size            ";
+  for (var s = 0; s < ARRAY_SIZES.length; s++) {
+    header += ("        " + ARRAY_SIZES[s]).slice(-9);
+  }
+  print(header);
+  print("----------------------------------------------------------------");
 
   bench("Int8Array       ", Int8Array, int8Sort);
   bench("Uint8Array      ", Uint8Array, uint8Sort);
@@ -11,6 +11,7 @@
 #include "llvh/Support/MathExtras.h"
 
 #include <array>
+#include <atomic>
 #include <bitset>
 
 namespace hermes {
@@ -141,6 +142,20 @@ class BitArray {
       allBits_[wordIdx] &= ~mask;
   }
 
+  /// Set the bit at \p idx to 1 with an atomic read-modify-write, so that
+  /// other threads may concurrently set bits that share the same word.
+  /// \return true if the bit was 0 before this call.
+  inline bool setAtomic(size_t idx) {
+    static_assert(
+        sizeof(std::atomic<uintptr_t>) == sizeof(uintptr_t),
+        "Words must be usable as atomics");
+    const uintptr_t mask = 1ULL << (idx % kBitsPerWord);
+    const size_t wordIdx = idx / kBitsPerWord;
+    return !(reinterpret_cast<std::atomic<uintptr_t> *>(&allBits_[wordIdx])
+                 ->fetch_or(mask, std::memory_order_relaxed) &
+             mask);
+  }
+
   /// Set all bits to 0.
   inline void reset() {
     std::fill_n(allBits_.begin(), kNumWords, 0);
@@ -11,6 +11,7 @@
 #include "hermes/BCGen/HBC/BCProvider.h"
 #include "hermes/BCGen/HBC/BCProviderFromSrc.h"
 #include "hermes/Utils/CompilerRuntimeFlags.h"
+#include "llvh/ADT/ArrayRef.h"
 #include "llvh/Support/raw_ostream.h"
 
 namespace hermes {
@@ -89,8 +90,11 @@ struct VMFeatures {
 OutputFormatKind outputFormatFromCommandLineOptions();
 
 /// Drive the Hermes compiler according to the command line options.
+/// \param args the command line that the options were parsed from. It is
+///   part of the key of the compile cache, which is disabled if it is empty.
 /// \return an exit status.
-CompileResult compileFromCommandLineOptions();
+CompileResult compileFromCommandLineOptions(
+    llvh::ArrayRef<const char *> args = {});
 
 /// Print the Hermes version (with VM) to the given stream \p s.
 /// \param vmFeatures describes which VM features are compiled in.
@@ -12,6 +12,8 @@
 #include "hermes/Regex/RegexTypes.h"
 #include "hermes/Support/StackOverflowGuard.h"
 
+#include <memory>
+
 // This file contains the machinery for executing a regexp compiled to bytecode.
 
 namespace hermes {
@@ -53,11 +55,50 @@ struct CapturedRange {
   }
 };
 
+/// \return whether the regex compiled to \p bytecode can be searched in time
+/// linear in the length of the input, with constants::matchLinearTime. This
+/// requires that it has no backreferences or lookarounds, and that its
+/// counted loops are small enough for every combination of loop counts to be
+/// tracked separately.
+bool canSearchInLinearTime(llvh::ArrayRef<uint8_t> bytecode);
+
+/// The analyses of a compiled regex that only depend on its bytecode: the
+/// prefilters that skip positions where no match can start, and the program
+/// run by linear time searches. They are computed once and passed to every
+/// search of that regex, instead of being recomputed by each search.
+class SearchAnalysis {
+ public:
+  /// Analyze the regex compiled to \p bytecode. The linear time program is
+  /// only built if \p linearTime is set, since it is only used by searches
+  /// with constants::matchLinearTime.
+  SearchAnalysis(llvh::ArrayRef<uint8_t> bytecode, bool linearTime);
+  ~SearchAnalysis();
+
+  SearchAnalysis(const SearchAnalysis &) = delete;
+  SearchAnalysis &operator=(const SearchAnalysis &) = delete;
+
+  /// Defined in Executor.cpp, which knows the analyses.
+  struct Impl;
+
+  const Impl &impl() const {
+    return *impl_;
+  }
+
+  /// \return the number of bytes of malloc memory used by the analysis.
+  size_t getMemorySize() const;
+
+ private:
+  std::unique_ptr<Impl> impl_;
+};
+
 /// Given a string \p first with length \p length, look for regex matches
 /// starting at offset \p start. We must have 0 <= start <= length.
 /// Search using the compiled regex represented by \p bytecode with the flags \p
 /// matchFlags. If the search succeeds, populate \p captures with the capture
 /// groups.
+/// \param analysis if not null, the analysis of \p bytecode, built with
+///   linearTime set if \p matchFlags has constants::matchLinearTime.
+///   Otherwise the search analyzes the bytecode itself.
 /// \param guard is used to implement stack overflow prevention.
 /// \return true if some portion of the string matched the regex
 /// represented by the bytecode, false otherwise. This is the char16_t overload.
@@ -68,6 +109,7 @@ MatchRuntimeResult searchWithBytecode(
     uint32_t length,
     std::vector<CapturedRange> *captures,
     constants::MatchFlagType matchFlags,
+    const SearchAnalysis *analysis = nullptr,
     StackOverflowGuard guard =
 #ifdef HERMES_CHECK_NATIVE_STACK
         StackOverflowGuard::nativeStackGuard(
@@ -86,6 +128,7 @@ MatchRuntimeResult searchWithBytecode(
     uint32_t length,
     std::vector<CapturedRange> *captures,
     constants::MatchFlagType matchFlags,
+    const SearchAnalysis *analysis = nullptr,
     StackOverflowGuard guard =
 #ifdef HERMES_CHECK_NATIVE_STACK
         StackOverflowGuard::nativeStackGuard(
@@ -45,6 +45,10 @@ enum MatchFlagType {
 
   /// Do not search for a match past the search start location.
   matchOnlyAtStart = 1 << 3,
+
+  /// Search in time linear in the length of the input instead of
+  /// backtracking, if the regex allows it. See canSearchInLinearTime().
+  matchLinearTime = 1 << 4,
 };
 
 inline constexpr MatchFlagType operator~(MatchFlagType x) {
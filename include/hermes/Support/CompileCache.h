@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_SUPPORT_COMPILECACHE_H
+#define HERMES_SUPPORT_COMPILECACHE_H
+
+#include "llvh/ADT/ArrayRef.h"
+#include "llvh/ADT/StringRef.h"
+#include "llvh/Support/MemoryBuffer.h"
+#include "llvh/Support/SHA1.h"
+
+#include <memory>
+#include <string>
+
+namespace hermes {
+
+/// An on-disk cache of the output of whole compilations. Each entry is a file
+/// in the cache directory, named after the key of the compilation that
+/// produced it. The key must cover everything that can affect the output; see
+/// KeyBuilder. It is built from the command line and the input files alone,
+/// so a hit skips parsing and IR generation as well as code generation.
+/// Caching is not done per function: the output of a function refers to
+/// tables shared by the whole module, such as the string and literal tables,
+/// and depends on other functions through inlining, so any change to the
+/// inputs misses.
+/// Entries are written atomically, so several compilers may share a cache
+/// directory.
+class CompileCache {
+ public:
+  /// Accumulates the inputs of a compilation into a cache key.
+  class KeyBuilder {
+   public:
+    /// Add \p data to the key. Each piece is length-prefixed, so that
+    /// different splits of the same bytes produce different keys.
+    void add(llvh::StringRef data);
+
+    /// Add the integer \p value to the key.
+    void add(uint64_t value);
+
+    /// Add the command line \p args to the key. args[0] is the compiler
+    /// executable: its size and modification time are added instead of its
+    /// name, so that rebuilding the compiler invalidates the cache. The
+    /// options named in \p ignoredOptions (without leading dashes) must take
+    /// a value and not affect the output; they are skipped together with
+    /// their values. The contents of every existing file named by an argument
+    /// are added too, so that editing an input that is not a source file,
+    /// such as a global definitions file, invalidates the cache.
+    void addCommandLine(
+        llvh::ArrayRef<const char *> args,
+        llvh::ArrayRef<llvh::StringRef> ignoredOptions);
+
+    /// \return the key, as a string of hex digits. The builder must not be
+    /// used afterwards.
+    std::string finish();
+
+   private:
+    /// If \p arg, or the value of the option it spells, is the path of an
+    /// existing regular file, add the contents of that file.
+    void addFileNamedBy(llvh::StringRef arg);
+
+    llvh::SHA1 hasher_{};
+  };
+
+  /// Create a cache stored in directory \p dir, which is created on the first
+  /// store() if it does not exist.
+  explicit CompileCache(std::string dir) : dir_(std::move(dir)) {}
+
+  /// \return the output stored for \p key, or nullptr if there is none.
+  std::unique_ptr<llvh::MemoryBuffer> lookup(llvh::StringRef key) const;
+
+  /// Store \p output for \p key, replacing any existing entry. Errors are
+  /// reported to llvh::errs().
+  /// \return true on success.
+  bool store(llvh::StringRef key, llvh::StringRef output) const;
+
+ private:
+  /// \return the path of the entry for \p key.
+  std::string entryPath(llvh::StringRef key) const;
+
+  /// The cache directory.
+  std::string dir_;
+};
+
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_COMPILECACHE_H
@@ -83,6 +83,29 @@ int64_t searchReverseU64(
     size_t end,
     uint64_t target);
 
+/// The maximum number of targets accepted by searchAnyU8 and searchAnyU16.
+constexpr size_t kMaxSearchAnyTargets = 4;
+
+/// Search the range [start, end) of \p arr forward for any of \p targets.
+/// \pre start <= end <= arr.size(), and \p targets has between 1 and
+///   kMaxSearchAnyTargets elements.
+/// \return the index of the first match, or -1 if not found.
+int64_t searchAnyU8(
+    llvh::ArrayRef<uint8_t> arr,
+    size_t start,
+    size_t end,
+    llvh::ArrayRef<uint8_t> targets);
+
+/// Search the range [start, end) of \p arr forward for any of \p targets.
+/// \pre start <= end <= arr.size(), and \p targets has between 1 and
+///   kMaxSearchAnyTargets elements.
+/// \return the index of the first match, or -1 if not found.
+int64_t searchAnyU16(
+    llvh::ArrayRef<uint16_t> arr,
+    size_t start,
+    size_t end,
+    llvh::ArrayRef<uint16_t> targets);
+
 /// Scan [start, end) for the first byte that requires escaping in a JSON
 /// string per ECMA-404: '"' (0x22), '\\' (0x5C), or any control character
 /// (<= 0x1F).
@@ -95,4 +118,16 @@ const char *scanJsonEscapeU8(const char *start, const char *end);
 /// \return pointer to the first such character, or \p end if none found.
 const char16_t *scanJsonEscapeU16(const char16_t *start, const char16_t *end);
 
+/// Scan [start, end) for the first byte that is not JSON whitespace per
+/// ECMA-404: ' ', '\t', '\n' or '\r'.
+/// \return pointer to the first such character, or \p end if none found.
+const char *scanJsonNonWhitespaceU8(const char *start, const char *end);
+
+/// Scan [start, end) for the first char16_t that is not JSON whitespace per
+/// ECMA-404: ' ', '\t', '\n' or '\r'.
+/// \return pointer to the first such character, or \p end if none found.
+const char16_t *scanJsonNonWhitespaceU16(
+    const char16_t *start,
+    const char16_t *end);
+
 } // namespace hermes
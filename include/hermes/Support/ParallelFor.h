@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_SUPPORT_PARALLELFOR_H
+#define HERMES_SUPPORT_PARALLELFOR_H
+
+#include "llvh/ADT/STLExtras.h"
+
+#include <cstddef>
+
+namespace hermes {
+
+/// \return the number of threads to use when \p requested threads were asked
+/// for. Zero means one thread per hardware thread. The result is at least 1.
+unsigned resolveThreadCount(unsigned requested);
+
+/// Call \p fn(i) for every i in [0, count), spreading the calls over at most
+/// \p numThreads threads, one of which is the calling thread. Indices are
+/// handed out in increasing order, but the calls may complete in any order.
+/// Returns once every call has completed. With a single thread (or a single
+/// index), \p fn is simply called in order on the calling thread.
+void parallelFor(
+    unsigned numThreads,
+    size_t count,
+    llvh::function_ref<void(size_t)> fn);
+
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_PARALLELFOR_H
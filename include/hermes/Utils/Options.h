@@ -92,6 +92,16 @@ struct BytecodeGenerationOptions {
   // Emit asserts in the bytecode.
   bool emitAsserts = false;
 
+  /// Number of threads used for the per-function backend work (register
+  /// allocation and post-allocation lowering). Zero means one per hardware
+  /// thread. The generated code does not depend on this value.
+  unsigned codegenThreads = 1;
+
+  /// Number of shards the SH backend splits the generated C into, so that
+  /// they can be compiled in parallel. Shard n is selected by defining
+  /// SHERMES_SHARD to n; without it, the C contains all the shards.
+  unsigned cShards = 1;
+
   /* implicit */ BytecodeGenerationOptions(OutputFormatKind format)
       : format(format) {}
 
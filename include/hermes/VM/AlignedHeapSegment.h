@@ -394,6 +394,15 @@ class AlignedHeapSegment {
     markBits->set(ind, true);
   }
 
+  /// Like setCellMarkBit, but safe to call while other threads are marking
+  /// cells whose bits share a word with \p cell.
+  /// \return true if \p cell was not marked before this call.
+  static bool setCellMarkBitAtomic(const GCCell *cell) {
+    auto *markBits = markBitArrayCovering(cell);
+    size_t ind = addressToMarkBitArrayIndex(cell);
+    return markBits->setAtomic(ind);
+  }
+
   /// Return whether the given \p cell is marked. Assumes the given address is
   /// a valid heap object.
   static bool getCellMarkBit(const GCCell *cell) {
@@ -1010,6 +1010,13 @@ class JSFunction : public Callable {
       JITCompiledFunctionPtr functionPtr,
       Runtime &runtime);
 
+  /// Like _jittedCall(), but for an on-stack replacement entry point, which
+  /// continues the current interpreter frame in JIT'ed code. The frame has
+  /// been popped when this returns, whether or not an exception was thrown.
+  static CallResult<HermesValue> _jittedOSRCall(
+      JITCompiledFunctionPtr entryPtr,
+      Runtime &runtime);
+
   /// Create a Function with no environment and a CodeBlock simply returning
   /// undefined, with the prototype property auto-initialized to new Object().
   static PseudoHandle<JSFunction> create(
@@ -22,6 +22,7 @@
 #include "llvh/ADT/Optional.h"
 #include "llvh/Support/TrailingObjects.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -34,6 +35,16 @@ class CodeBlock;
 /// A pointer to JIT-compiled function.
 typedef HermesValue (*JITCompiledFunctionPtr)(Runtime *runtime);
 
+/// An entry point into JIT-compiled code at a loop header, used to continue
+/// an interpreted call of the function in native code (on-stack replacement).
+struct JITOSREntry {
+  /// Bytecode offset of the loop header.
+  uint32_t offset;
+  /// The native entry point. Unlike the function entry, it doesn't allocate a
+  /// frame, but takes over the current frame set up by the interpreter.
+  JITCompiledFunctionPtr entry;
+};
+
 /// A sequence of instructions representing the body of a function.
 class CodeBlock final : private llvh::TrailingObjects<
                             CodeBlock,
@@ -64,6 +75,10 @@ class CodeBlock final : private llvh::TrailingObjects<
   /// example because it contains constructs that the JIT can't handle.
   bool dontJIT_ = false;
 
+  /// Set once this block has been handed to the background JIT compiler, so
+  /// that it is not queued again while the compilation is pending.
+  bool jitQueued_ = false;
+
   /// If this CodeBlock was compiled, a pointer to the body.
   JITCompiledFunctionPtr JITCompiled_ = nullptr;
 
@@ -71,6 +86,14 @@ class CodeBlock final : private llvh::TrailingObjects<
   /// Ideally, a function's hotness should also include if it has a loop and how
   /// hot that loop is.
   uint32_t executionCount_ = 0;
+
+  /// Number of loop iterations executed by the interpreter since the last
+  /// attempt to enter JIT-compiled code in the middle of a loop.
+  uint32_t loopIterationCount_ = 0;
+
+  /// If this CodeBlock was compiled, the on-stack replacement entry points,
+  /// sorted by bytecode offset.
+  std::vector<JITOSREntry> JITOSREntries_{};
 #endif
 
 #ifdef HERMES_ENABLE_DEBUGGER
@@ -270,6 +293,16 @@ class CodeBlock final : private llvh::TrailingObjects<
     dontJIT_ = dontJIT;
   }
 
+  /// \return true if this block has been queued for background compilation.
+  bool getJITQueued() const {
+    return jitQueued_;
+  }
+
+  /// Record whether this block has been queued for background compilation.
+  void setJITQueued(bool queued) {
+    jitQueued_ = queued;
+  }
+
   /// \return the native code for this function, or null if it hasn't been
   ///   compiled to native.
   JITCompiledFunctionPtr getJITCompiled() const {
@@ -295,6 +328,35 @@ class CodeBlock final : private llvh::TrailingObjects<
   void clearExecutionCount() {
     executionCount_ = 0;
   }
+
+  /// Count a loop iteration executed by the interpreter.
+  /// \return the number of iterations since the last reset.
+  uint32_t incrementLoopIterationCount() {
+    return ++loopIterationCount_;
+  }
+
+  /// Reset the loop iteration count to 0.
+  void clearLoopIterationCount() {
+    loopIterationCount_ = 0;
+  }
+
+  /// Set the on-stack replacement entry points of the native code.
+  /// \pre \p entries is sorted by bytecode offset.
+  void setJITOSREntries(std::vector<JITOSREntry> entries) {
+    JITOSREntries_ = std::move(entries);
+  }
+
+  /// \return the native entry point continuing the current interpreter frame
+  ///   at the loop header at bytecode \p offset, or null if there is none.
+  JITCompiledFunctionPtr getJITOSREntry(uint32_t offset) const {
+    auto it = std::lower_bound(
+        JITOSREntries_.begin(),
+        JITOSREntries_.end(),
+        offset,
+        [](const JITOSREntry &e, uint32_t ofs) { return e.offset < ofs; });
+    return it != JITOSREntries_.end() && it->offset == offset ? it->entry
+                                                              : nullptr;
+  }
 #else
   /// \return true if JIT is disabled for this function.
   bool getDontJIT() const {
@@ -481,6 +481,18 @@ class GCBase {
     uint64_t numLargeAllocations{0};
     /// Bytes of alive large objects (zero if non-generational  GC).
     uint64_t allocatedLargeObjectBytes{0};
+    /// Number of allocations made directly in the old generation, including
+    /// long-lived allocations (zero if non-generational GC).
+    uint64_t numOldGenAllocations{0};
+    /// Number of times the old generation allocation chunk was refilled from
+    /// the freelist (zero if non-generational GC).
+    uint64_t numOldGenAllocChunkRefills{0};
+    /// Number of young generation collections that were evacuated by
+    /// multiple workers (zero if non-generational GC).
+    uint64_t numParallelYoungCollections{0};
+    /// Total bytes copied by each worker in parallel young generation
+    /// collections, indexed by worker (empty if they are not enabled).
+    std::vector<uint64_t> youngGenEvacuatedBytesPerWorker;
     /// Stats for general collection (including both YG and OG).
     CumulativeHeapStats generalStats;
     /// Stats for full collections (zeroes if non-generational GC).
@@ -1059,6 +1071,11 @@ class GCBase {
   /// logging.
   virtual void collect(std::string cause, bool canEffectiveOOM = false) = 0;
 
+  /// Called by the mutator while it is blocked for a long time (e.g. in
+  /// Atomics.wait), to let a collection that is waiting on the mutator make
+  /// progress.
+  virtual void yieldToGC() {}
+
   /// Iterate over all objects in the heap, and call \p callback on them.
   /// \param callback A function to call on each found object.
   virtual void forAllObjs(const std::function<void(GCCell *)> &callback) = 0;
@@ -19,6 +19,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 namespace hermes {
 namespace vm {
@@ -264,6 +265,41 @@ class GCCell {
   }
 #endif
 
+  /// Atomically read the header of this cell, which another GC thread may be
+  /// concurrently replacing with a forwarding pointer.
+  /// \return true and set \p forwardedCell if the cell has already been
+  ///   forwarded. Otherwise, return false and set \p kindAndSize.
+  /// NOTE: this should only be used by the GC.
+  bool loadHeaderAtomic(
+      KindAndSize &kindAndSize,
+      AssignableCompressedPointer &forwardedCell) const {
+    return decodeHeader(
+        headerAtomic()->load(std::memory_order_acquire),
+        kindAndSize,
+        forwardedCell);
+  }
+
+  /// Atomically replace the header \p kindAndSize, as previously read by
+  /// loadHeaderAtomic, with a marked forwarding pointer to \p cell.
+  /// \return true on success. On failure another GC thread forwarded this cell
+  ///   first, and \p forwardedCell is set to its forwarding pointer.
+  /// NOTE: this should only be used by the GC.
+  bool trySetMarkedForwardingPointer(
+      KindAndSize kindAndSize,
+      CompressedPointer cell,
+      AssignableCompressedPointer &forwardedCell) {
+    HeaderRawType expected;
+    std::memcpy(&expected, &kindAndSize, sizeof(expected));
+    if (headerAtomic()->compare_exchange_strong(
+            expected, cell.getRaw() | 0x1, std::memory_order_acq_rel))
+      return true;
+    KindAndSize unused;
+    bool forwarded = decodeHeader(expected, unused, forwardedCell);
+    (void)forwarded;
+    assert(forwarded && "Header can only change by being forwarded");
+    return false;
+  }
+
   /// Returns whether the cell's mark bit is set.
   bool isMarked() const {
     return forwardingPointer_.getRaw() & 0x1;
@@ -276,6 +312,36 @@ class GCCell {
   static constexpr uint32_t maxNormalSize() {
     return KindAndSize::maxSize();
   }
+
+ private:
+  using HeaderRawType = CompressedPointer::RawType;
+  static_assert(
+      sizeof(KindAndSize) == sizeof(HeaderRawType),
+      "KindAndSize must occupy exactly one header word");
+  static_assert(
+      sizeof(std::atomic<HeaderRawType>) == sizeof(HeaderRawType) &&
+          std::atomic<HeaderRawType>::is_always_lock_free,
+      "The header must be usable as a lock-free atomic");
+
+  /// \return the header of this cell as an atomic word.
+  std::atomic<HeaderRawType> *headerAtomic() const {
+    return reinterpret_cast<std::atomic<HeaderRawType> *>(
+        const_cast<AssignableCompressedPointer *>(&forwardingPointer_));
+  }
+
+  /// Split the raw header word \p raw into either a KindAndSize or a
+  /// forwarding pointer. \return true if it held a forwarding pointer.
+  static bool decodeHeader(
+      HeaderRawType raw,
+      KindAndSize &kindAndSize,
+      AssignableCompressedPointer &forwardedCell) {
+    if (raw & 0x1) {
+      forwardedCell = CompressedPointer::fromRaw(raw - 0x1);
+      return true;
+    }
+    std::memcpy(&kindAndSize, &raw, sizeof(raw));
+    return false;
+  }
 };
 
 static_assert(sizeof(GCCell) == sizeof(SHGCCell));
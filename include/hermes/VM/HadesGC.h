@@ -157,6 +157,23 @@ class HadesGC final : public GCBase {
   /// \name GC non-virtual API
   /// \{
 
+  /// \return the number of YG collections that were evacuated in parallel.
+  /// These counters are updated by the GC threads, so they should only be read
+  /// when no collection is in progress.
+  size_t getNumParallelYoungCollections() const {
+    return numParallelYoungCollections_;
+  }
+
+  /// \return the number of OG marking rounds that were done in parallel.
+  size_t getNumParallelMarkRounds() const {
+    return numParallelMarkRounds_;
+  }
+
+  /// \return the number of times several OG segments were swept in parallel.
+  size_t getNumParallelSweepRounds() const {
+    return numParallelSweepRounds_;
+  }
+
   template <typename T, class... Args>
   static T *constructCellCanBeLarge(void *ptr, uint32_t size, Args &&...args) {
     assert(ptr && "constructCellCanBeLarge() can't be called on null ptr");
@@ -225,6 +242,10 @@ class HadesGC final : public GCBase {
   /// (Part of general GC API defined in GCBase.h).
   void collect(std::string cause, bool canEffectiveOOM = false) override;
 
+  /// Do a YG collection if an OG collection is waiting on the mutator.
+  /// (Part of general GC API defined in GCBase.h).
+  void yieldToGC() override;
+
   /// Run the finalizers for all heap objects.
   void finalizeAll() override;
 
@@ -686,6 +707,9 @@ class HadesGC final : public GCBase {
   class MarkWeakRootsAcceptor;
   class OldGen;
   class Executor;
+  class WorkerPool;
+  class EvacWorkQueue;
+  class ParallelEvacAcceptor;
 
   struct CopyListCell final : public GCCell {
     // Linked list of cells pointing to the next cell that was copied.
@@ -772,6 +796,12 @@ class HadesGC final : public GCBase {
     /// \return the total number of large allocations.
     unsigned numLargeAllocations() const;
 
+    /// \return the total number of allocations made with alloc().
+    uint64_t numAllocations() const;
+
+    /// \return the number of times allocChunk_ was refilled from the freelist.
+    uint64_t numAllocChunkRefills() const;
+
     /// Increase the allocated bytes tracker by \p incr.
     void incrementAllocatedBytes(size_t incr);
 
@@ -832,12 +862,66 @@ class HadesGC final : public GCBase {
       }
     };
 
+   private:
+    struct SegmentBucket;
+
+   public:
+    /// A free block of the OG handed to a single GC thread, which carves cells
+    /// out of it without synchronisation. This is what lets multiple threads
+    /// evacuate the YG into the OG at the same time. The space handed out is
+    /// only accounted for in allocatedBytes() once the buffer is retired.
+    class EvacBuffer {
+     public:
+      /// Carve \p sz bytes out of the buffer. The new cell's head is set, but
+      /// it is not marked. \return null if the buffer is too small.
+      GCCell *alloc(uint32_t sz);
+
+      /// Give back \p cell, of size \p sz, which must be the result of the
+      /// most recent call to alloc().
+      void undoAlloc(GCCell *cell, uint32_t sz);
+
+      /// \return true if the buffer holds no space and no unaccounted bytes.
+      bool empty() const {
+        return !cell_ && !allocatedBytes_;
+      }
+
+     private:
+      friend class OldGen;
+
+      /// The unused part of the buffer. Cells are carved from its end.
+      FreelistCell *cell_{nullptr};
+
+      /// The first SegmentBucket for the segment cell_ is in, used to return
+      /// the unused part to the freelist.
+      SegmentBucket *baseBucket_{nullptr};
+
+      /// Bytes carved out of the buffer since it was last retired.
+      uint64_t allocatedBytes_{0};
+    };
+
+    /// Retire \p buf and replace it with a new free block of at least \p sz
+    /// bytes, creating a new segment if necessary. Unlike alloc(), this never
+    /// waits for a collection to finish.
+    /// \return false if no such block exists, in which case \p buf is left
+    ///   empty.
+    /// \pre The caller must have exclusive access to the OG freelist.
+    bool refillEvacBuffer(EvacBuffer &buf, uint32_t sz);
+
+    /// Return the unused part of \p buf to the freelist, and account for the
+    /// bytes allocated from it.
+    /// \pre The caller must have exclusive access to the OG freelist.
+    void retireEvacBuffer(EvacBuffer &buf);
+
     /// Sweep the next segment and advance the internal sweep iterator. If there
     /// are no more segments left to sweep, calls endSweep(). \p
     /// backgroundThread indicates whether this call was made from the
     /// background thread.
     bool sweepNext(bool backgroundThread);
 
+    /// Like sweepNext(), but sweeps as many segments as \p workers has workers
+    /// at once, one per worker. Must not be used while tracking IDs.
+    bool sweepNextParallel(WorkerPool &workers, bool backgroundThread);
+
     /// When no more segments to sweep, update OG collection stats with numbers
     /// from the sweep. Note that freeUnusedJumboSegments() is also called here.
     void endSweep();
@@ -974,6 +1058,12 @@ class HadesGC final : public GCBase {
     /// Number of large allocations that have occurred in this execution.
     unsigned numLargeAllocations_{0};
 
+    /// Number of allocations made with alloc() in this execution.
+    uint64_t numAllocations_{0};
+
+    /// Number of times allocChunk_ was refilled by refillAllocChunk().
+    uint64_t numAllocChunkRefills_{0};
+
     /// Sum of all bytes currently allocated in the heap by large allocation.
     /// This is a subset of allocatedBytes_ below.
     uint64_t allocatedLargeObjectBytes_{0};
@@ -1010,8 +1100,10 @@ class HadesGC final : public GCBase {
     std::array<SegmentBucket, kNumFreelistBuckets> buckets_{};
 
     /// A FreelistCell that has been set aside as an arena to try allocating
-    /// from before we fall back to a full freelist search. This may be null if
-    /// no such chunk is set.
+    /// from before we fall back to a full freelist search. Long-lived and
+    /// other direct OG allocations bump allocate out of it, and it is refilled
+    /// with a large free block when exhausted. This may be null if no such
+    /// chunk is set.
     FreelistCell *allocChunk_ = nullptr;
 
     /// A pointer to the first SegmentBucket for the segment that allocChunk_ is
@@ -1037,16 +1129,65 @@ class HadesGC final : public GCBase {
 #endif
     } sweepIterator_;
 
+    /// Allocate \p sz bytes out of the freelist. Small sizes take an exact fit
+    /// if there is one, and otherwise refill allocChunk_. Larger sizes only
+    /// search for a fit.
+    /// \return A pointer to uninitialized memory that can be written into, null
+    ///   if no such space exists.
+    GCCell *allocFromFreelist(uint32_t sz);
+
+    /// Take a free cell of exactly \p sz bytes from the small section of the
+    /// freelist.
+    /// \pre sz < kMinSizeForLargeBlock
+    /// \return A pointer to uninitialized memory that can be written into, null
+    ///   if the bucket for \p sz is empty.
+    GCCell *allocExactFit(uint32_t sz);
+
+    /// Replace allocChunk_ with a free block big enough to bump allocate many
+    /// cells out of, and carve \p sz bytes from it. The leftover part of the
+    /// old allocChunk_ is returned to the freelist.
+    /// \return A pointer to uninitialized memory that can be written into, null
+    ///   if the freelist has no block big enough.
+    GCCell *refillAllocChunk(uint32_t sz);
+
     /// Searches the OG for a space to allocate memory into.
     /// \return A pointer to uninitialized memory that can be written into, null
     ///   if no such space exists.
     GCCell *search(uint32_t sz);
 
+    /// Remove the segment at \p segIdx from the freelists, so that sweeping
+    /// can build new freelists for it.
+    void prepareSegmentForSweep(size_t segIdx);
+
+    /// Coalesce the dead cells in the segment at \p segIdx into freelist cells
+    /// in its SegmentBuckets, calling \p onDeadCell(cell, size) on each dead
+    /// cell before its memory is reused. If \p trim is true, also trim the
+    /// live cells, adding the number of bytes trimmed to \p trimmedBytes. Only
+    /// touches the memory and freelists of that segment, so different
+    /// segments may be swept at the same time.
+    /// \return the number of bytes freed.
+    template <typename DeadCellCallback>
+    int32_t sweepSegment(
+        size_t segIdx,
+        bool trim,
+        uint64_t &trimmedBytes,
+        const DeadCellCallback &onDeadCell);
+
+    /// Add the freelists built by sweepSegment() for the segment at \p segIdx
+    /// back to the OG freelists, and account for \p segmentSweptBytes.
+    void finishSegmentSweep(size_t segIdx, int32_t segmentSweptBytes);
+
     /// Common path for when an allocation has succeeded.
     /// \param cell The free memory that will soon have an object allocated into
     ///   it.
     /// \param sz The number of bytes associated with the free memory.
     GCCell *finishAlloc(GCCell *cell, uint32_t sz);
+
+    /// Remove a free cell of at least \p sz bytes from the freelist, without
+    /// splitting it.
+    /// \return the cell and the first SegmentBucket of its segment, or a null
+    ///   cell if there is no such free cell.
+    std::pair<FreelistCell *, SegmentBucket *> removeFirstFit(uint32_t sz);
   };
 
  private:
@@ -1164,7 +1305,7 @@ class HadesGC final : public GCBase {
     /// A worklist local to the marking thread, that is only pushed onto by the
     /// marking thread. If this is empty, the global worklist must be consulted
     /// to ensure that pointers modified in write barriers are handled.
-    std::stack<GCCell *, std::vector<GCCell *>> localWorklist;
+    std::vector<GCCell *> localWorklist;
 
     /// A fixed size local buffer that the mutator can push elements onto
     /// without needing to acquire the lock. This allows us to batch writes
@@ -1205,6 +1346,11 @@ class HadesGC final : public GCBase {
     /// synchronization.
     llvh::BitVector writeBarrierMarkedSymbols;
 
+    /// The symbols marked by each parallel marking worker other than the
+    /// thread that started the round, which uses markedSymbols directly. Merged
+    /// into markedSymbols once marking completes.
+    std::vector<llvh::BitVector> workerMarkedSymbols;
+
     /// The number of bytes to drain per call to drainSomeWork. A higher rate
     /// means more objects will be marked.
     /// Only used by incremental collections.
@@ -1226,6 +1372,18 @@ class HadesGC final : public GCBase {
   /// concurrently with the mutator.
   std::unique_ptr<Executor> backgroundExecutor_;
 
+  /// Helper threads for evacuating the YG in parallel. Null if the YG is
+  /// evacuated on the mutator thread only.
+  std::unique_ptr<WorkerPool> ygEvacuationWorkers_;
+
+  /// Helper threads for marking the OG in parallel. Null if the OG is marked
+  /// by a single thread.
+  std::unique_ptr<WorkerPool> ogMarkingWorkers_;
+
+  /// Helper threads for sweeping the OG in parallel. Null if the OG is swept
+  /// one segment at a time.
+  std::unique_ptr<WorkerPool> ogSweepingWorkers_;
+
   /// True from the time the background task is created, to the time it exits
   /// the collection loop. False otherwise. Protected by gcMutex_.
   bool backgroundTaskActive_{false};
@@ -1236,6 +1394,10 @@ class HadesGC final : public GCBase {
   /// If true, turn off promoteYGToOG_ as soon as ttiReached() is called.
   bool revertToYGAtTTI_;
 
+  /// If true, an OG allocation that finds no free space while the OG is being
+  /// swept sweeps the remaining segments itself before growing the heap.
+  const bool sweepOnAllocation_;
+
   /// If true, overwrite the allocation region in the YG with kInvalidHeapValue
   /// at the end of each YG collection.
   bool overwriteDeadYGObjects_;
@@ -1310,6 +1472,17 @@ class HadesGC final : public GCBase {
   size_t numYoungCollections_{0};
   size_t numOldCollections_{0};
 
+  /// The number of YG collections that were evacuated in parallel, and the
+  /// total number of bytes each worker has copied in those collections.
+  size_t numParallelYoungCollections_{0};
+  std::vector<uint64_t> ygEvacuatedBytesPerWorker_;
+
+  /// The number of calls to incrementalMark that were done in parallel.
+  size_t numParallelMarkRounds_{0};
+
+  /// The number of calls to sweepNextParallel that swept at least one segment.
+  size_t numParallelSweepRounds_{0};
+
   struct NativeIDs {
     HeapSnapshot::NodeID ygFinalizables{IDTracker::kInvalidNode};
     HeapSnapshot::NodeID og{IDTracker::kInvalidNode};
@@ -1352,6 +1525,13 @@ class HadesGC final : public GCBase {
   template <bool CompactionEnabled>
   uint64_t youngGenEvacuateImpl(bool doCompaction);
 
+  /// Like youngGenEvacuateImpl<false>, but splits the dirty card scan and the
+  /// copying of reachable objects across ygEvacuationWorkers_. Roots are still
+  /// marked on the calling thread. If the OG cannot grow without waiting for a
+  /// collection, the remaining work is finished on the calling thread.
+  /// \return the number of bytes evacuated.
+  uint64_t youngGenEvacuateParallel();
+
   /// In the "no GC before TTI" mode, move the Young Gen heap segment to the
   /// Old Gen without scanning for garbage.
   /// \return true if a promotion occurred, false if it did not.
@@ -1423,6 +1603,11 @@ class HadesGC final : public GCBase {
   /// \return true if there is any remaining work in the local worklist.
   bool incrementalMark(size_t markLimit);
 
+  /// Implementation of incrementalMark once the barrier worklist has been
+  /// drained into the local worklist, which splits the work across
+  /// ogMarkingWorkers_. Each worker marks at most \p markLimit bytes.
+  bool incrementalMarkParallel(size_t markLimit);
+
   /// Iterate the list of `weakMapEntrySlots_`, for each non-free slot, if
   /// both the key and the owner are marked, mark the mapped value.
   /// Note that this may further cause other values to be marked, so we need to
@@ -1450,6 +1635,20 @@ class HadesGC final : public GCBase {
   /// Run finalizers on the compactee and clear any compaction state.
   void finalizeCompactee();
 
+  /// Walk the dirty cards of \p seg, calling \p visitCell(cell) on each cell
+  /// that lies entirely within a run of dirty cards, and \p
+  /// visitCellWithinRange(cell, begin, end) on each cell that straddles the
+  /// boundary of a run [begin, end). Dead cells are skipped while sweeping.
+  template <typename VisitCell, typename VisitCellWithinRange>
+  void visitDirtyCardsForSegment(
+      FixedSizeHeapSegment &seg,
+      VisitCell visitCell,
+      VisitCellWithinRange visitCellWithinRange);
+  template <typename VisitCellWithinRange>
+  void visitDirtyCardsForSegment(
+      JumboHeapSegment &seg,
+      VisitCellWithinRange visitCellWithinRange);
+
   /// Search a single segment for pointers that may need to be updated as the
   /// YG/compactee are evacuated.
   template <bool CompactionEnabled>
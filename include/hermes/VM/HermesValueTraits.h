@@ -120,6 +120,10 @@ template <typename T>
 class BufferedStringPrimitive;
 template <typename T>
 struct IsGCObject<BufferedStringPrimitive<T>> : public std::true_type {};
+template <typename T>
+class RopeStringPrimitive;
+template <typename T>
+struct IsGCObject<RopeStringPrimitive<T>> : public std::true_type {};
 
 template <size_t Size>
 struct EmptyCell;
@@ -259,6 +263,12 @@ struct HermesValueTraits<BufferedStringPrimitive<char>, true>
 template <>
 struct HermesValueTraits<BufferedStringPrimitive<char16_t>, true>
     : public StringTraitsImpl<BufferedStringPrimitive<char16_t>> {};
+template <>
+struct HermesValueTraits<RopeStringPrimitive<char>, true>
+    : public StringTraitsImpl<RopeStringPrimitive<char>> {};
+template <>
+struct HermesValueTraits<RopeStringPrimitive<char16_t>, true>
+    : public StringTraitsImpl<RopeStringPrimitive<char16_t>> {};
 
 template <class T>
 struct HermesValueTraits<T, true> {
@@ -31,9 +31,11 @@
 #endif
 
 // If the JIT is allowed by configuration, enable it on platforms that support
-// it.
-#if !defined(HERMESVM_JIT) && (defined(__aarch64__) || defined(_M_ARM64)) && \
-    (!defined(HERMESVM_COMPRESSED_POINTERS) ||                               \
+// it. The x86-64 backend only implements the System V calling convention.
+#if !defined(HERMESVM_JIT) &&                      \
+    (defined(__aarch64__) || defined(_M_ARM64) ||  \
+     (defined(__x86_64__) && !defined(_WIN32))) && \
+    (!defined(HERMESVM_COMPRESSED_POINTERS) ||     \
      defined(HERMESVM_CONTIGUOUS_HEAP))
 #define HERMESVM_JIT 1
 #else
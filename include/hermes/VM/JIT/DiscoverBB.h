@@ -23,10 +23,13 @@ class CodeBlock;
 ///     every basic block in order. The last entry is the end of the bytecode.
 /// \param[out] labels Map from a bytecode target label offset to a basic block
 ///     index.
+/// \param[out] loopHeaders if not null, on output it will contain the sorted
+///     offsets of the targets of backward branches, i.e. the loop headers.
 void discoverBasicBlocks(
     CodeBlock *codeBlock,
     std::vector<uint32_t> &basicBlocks,
-    llvh::DenseMap<uint32_t, unsigned> &labels);
+    llvh::DenseMap<uint32_t, unsigned> &labels,
+    std::vector<uint32_t> *loopHeaders = nullptr);
 
 } // namespace vm
 } // namespace hermes
@@ -31,7 +31,12 @@ class Emitter;
   friend class arm64::Emitter;
 #elif defined(__x86_64__) || defined(_M_X64)
 using x86_64::JITContext;
-#define FRIEND_JIT friend class x86_64::JITContext;
+namespace x86_64 {
+class Emitter;
+}
+#define FRIEND_JIT                 \
+  friend class x86_64::JITContext; \
+  friend class x86_64::Emitter;
 #endif
 
 } // namespace vm
@@ -40,6 +45,7 @@ using x86_64::JITContext;
 #else
 
 #include "hermes/VM/CodeBlock.h"
+#include "hermes/VM/sh_native_regexp.h"
 
 #define FRIEND_JIT
 
@@ -120,6 +126,23 @@ class JITContext {
   /// Can be overridden by setForceJIT(true).
   void setDefaultExecThreshold(uint32_t threshold) {}
 
+  /// Whether setOSRThreshold() has any effect.
+  static constexpr bool kOSRSupported = false;
+
+  /// Set the number of loop iterations before on-stack replacement.
+  void setOSRThreshold(uint32_t threshold) {}
+
+  /// Set the number of searches of a regexp before it is compiled.
+  void setRegExpThreshold(uint32_t threshold) {}
+
+  /// Whether setRegExpThreshold() has any effect.
+  static constexpr bool kRegExpCompileSupported = false;
+
+  /// \return native matchers for the regex \p bytecode, always nullptr.
+  const SHNativeRegExp *getNativeRegExp(llvh::ArrayRef<uint8_t> bytecode) {
+    return nullptr;
+  }
+
   /// Set the flag to emit asserts in the JIT'ed code.
   void setEmitAsserts(bool emitAsserts) {}
 
@@ -129,6 +152,24 @@ class JITContext {
   /// Dump the counters to the given stream. Counters must be enabled.
   void dumpCounters(llvh::raw_ostream &) {}
 
+  /// Whether setBackgroundCompile() has any effect.
+  static constexpr bool kBackgroundCompileSupported = false;
+
+  /// Enable or disable compilation on a background thread.
+  void setBackgroundCompile(bool background) {}
+
+  /// Set the maximum number of CodeBlocks queued for background compilation.
+  void setMaxQueuedCompiles(uint32_t maxQueued) {}
+
+  /// Block until every queued background compilation has been installed.
+  void waitForBackgroundCompiles() {}
+
+  /// Drop the queued background compilations and stop the background thread.
+  void stopBackgroundCompiles() {}
+
+  /// Dump the background compilation statistics to the given stream.
+  void dumpBackgroundCompileStats(llvh::raw_ostream &) {}
+
   /// \return true if we should emit asserts in the JIT'ed code.
   bool getEmitAsserts() {
     return false;
@@ -11,6 +11,7 @@
 #include "hermes/ADT/TransparentOwningPtr.h"
 #include "hermes/VM/CodeBlock.h"
 #include "hermes/VM/JIT/PerfJitDump.h"
+#include "hermes/VM/sh_native_regexp.h"
 
 namespace hermes {
 namespace vm {
@@ -88,6 +89,26 @@ class JITContext {
     defaultExecThreshold_ = threshold;
   }
 
+  /// Whether setOSRThreshold() has any effect. On-stack replacement is off on
+  /// arm64 until it has test coverage on this backend, so no OSR entries are
+  /// emitted and running calls always finish in the interpreter.
+  static constexpr bool kOSRSupported = false;
+
+  /// Set the number of loop iterations the interpreter executes in a function
+  /// before continuing the call in JIT'ed code. Ignored, see kOSRSupported.
+  void setOSRThreshold(uint32_t threshold) {}
+
+  /// Called by the interpreter on every taken backward jump in \p codeBlock.
+  /// \return true if the loop is hot and getOSREntry() should be called.
+  inline bool countLoopIteration(CodeBlock *codeBlock);
+
+  /// Find the entry point that continues the current interpreter frame of
+  /// \p codeBlock at the loop header at bytecode \p offset, compiling the
+  /// function first if needed. This may allocate.
+  /// \return the entry point, nullptr if the interpreter must continue.
+  JITCompiledFunctionPtr
+  getOSREntry(Runtime &runtime, CodeBlock *codeBlock, uint32_t offset);
+
   /// Enable or disable dumping JIT'ed Code.
   void setDumpJITCode(unsigned dump) {
     dumpJITCode_ = dump;
@@ -152,6 +173,24 @@ class JITContext {
   /// Dump the counters to the given stream. Counters must be enabled.
   void dumpCounters(llvh::raw_ostream &os);
 
+  /// Regexps are not compiled by this backend, so every search is
+  /// interpreted unless the regexp has matchers generated by the SH backend.
+  static constexpr bool kRegExpCompileSupported = false;
+  void setRegExpThreshold(uint32_t threshold) {}
+  const SHNativeRegExp *getNativeRegExp(llvh::ArrayRef<uint8_t> bytecode) {
+    return nullptr;
+  }
+
+  /// Background compilation is not supported, because the generated code
+  /// embeds hidden classes that must be read on the mutator thread. These
+  /// methods are no-ops and functions are always compiled synchronously.
+  static constexpr bool kBackgroundCompileSupported = false;
+  void setBackgroundCompile(bool background) {}
+  void setMaxQueuedCompiles(uint32_t maxQueued) {}
+  void waitForBackgroundCompiles() {}
+  void stopBackgroundCompiles() {}
+  void dumpBackgroundCompileStats(llvh::raw_ostream &) {}
+
   /// \return true if we should emit asserts in the JIT'ed code.
   bool getEmitAsserts() {
     return emitAsserts_;
@@ -222,6 +261,11 @@ inline bool JITContext::shouldCompile(CodeBlock *codeBlock) {
   return true;
 }
 
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+inline bool JITContext::countLoopIteration(CodeBlock *codeBlock) {
+  return false;
+}
+
 LLVM_ATTRIBUTE_ALWAYS_INLINE
 inline JITCompiledFunctionPtr JITContext::compile(
     Runtime &runtime,
@@ -0,0 +1,409 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JIT_X86_64_JIT_H
+#define HERMES_VM_JIT_X86_64_JIT_H
+
+#include "hermes/ADT/TransparentOwningPtr.h"
+#include "hermes/VM/CodeBlock.h"
+#include "hermes/VM/JIT/PerfJitDump.h"
+#include "hermes/VM/sh_native_regexp.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace hermes {
+namespace vm {
+struct RuntimeOffsets;
+
+namespace x86_64 {
+
+namespace DumpJitCode {
+enum : unsigned {
+  Code = 0x01,
+  CompileStatus = 0x02,
+  InstErr = 0x04,
+  BRK = 0x40,
+  EntryExit = 0x80,
+};
+}
+
+/// List of counters that can be incremented from JIT emitted code.
+#define JIT_COUNTERS(X) \
+  X(NumCall)            \
+  X(NumCallSlow)
+
+/// Enum with an entry for each JIT counter. This is used to index into the list
+/// of counters.
+enum class JitCounter : unsigned {
+#define COUNTER_NAME(name) name,
+  JIT_COUNTERS(COUNTER_NAME)
+#undef COUNTER_NAME
+      _Last,
+};
+
+/// All state related to JIT compilation.
+class JITContext {
+  class Compiler;
+  struct CompileResult;
+  friend RuntimeOffsets;
+
+ public:
+  class Impl;
+
+  /// Statistics about background compilation.
+  struct BackgroundCompileStats {
+    /// Number of CodeBlocks handed to the background compiler.
+    uint64_t numQueued = 0;
+    /// Number of compilation requests dropped because the queue was full.
+    uint64_t numRejected = 0;
+    /// Number of CodeBlocks that were compiled and installed.
+    uint64_t numCompiled = 0;
+    /// Number of CodeBlocks that could not be compiled.
+    uint64_t numFailed = 0;
+    /// Time spent between queueing a CodeBlock and starting its compilation.
+    std::chrono::microseconds totalQueueDelay{0};
+    std::chrono::microseconds maxQueueDelay{0};
+    /// Time spent compiling on the background thread.
+    std::chrono::microseconds totalCompileTime{0};
+    std::chrono::microseconds maxCompileTime{0};
+  };
+
+  /// Construct a JIT context. No executable memory is allocated before it is
+  /// needed.
+  /// \param enable whether JIT is enabled.
+  JITContext(bool enable);
+  ~JITContext();
+
+  JITContext(const JITContext &) = delete;
+  void operator=(const JITContext &) = delete;
+
+  /// \return whether compile() should be called for \p codeBlock, either
+  /// because it should be JIT compiled or because background compilations have
+  /// finished and must be installed.
+  /// \pre codeBlock does not already have a JITCompiledFunctionPtr.
+  /// Has no side effects and does not allocate.
+  inline bool shouldCompile(CodeBlock *codeBlock);
+
+  /// Install the finished background compilations, then compile a function to
+  /// native code if it is still needed, and return the native pointer. This
+  /// may allocate.
+  /// \pre codeBlock does not already have a JITCompiledFunctionPtr.
+  /// \pre shouldCompile() must be true.
+  /// \return the native pointer, nullptr if compilation failed or did not
+  ///   happen.
+  inline JITCompiledFunctionPtr compile(Runtime &runtime, CodeBlock *codeBlock);
+
+  /// \return true if JIT compilation is enabled.
+  bool isEnabled() const {
+    return enabled_;
+  }
+
+  /// Enable or disable JIT compilation.
+  void setEnabled(bool enabled) {
+    enabled_ = enabled;
+  }
+
+  /// Set the default threshold for function execution count before a function
+  /// is compiled. On a per-function basis, the count may be altered based on
+  /// internal heuristics.
+  /// Can be overridden by setForceJIT(true).
+  void setDefaultExecThreshold(uint32_t threshold) {
+    defaultExecThreshold_ = threshold;
+  }
+
+  /// Whether setOSRThreshold() has any effect.
+  static constexpr bool kOSRSupported = true;
+
+  /// Set the number of loop iterations the interpreter executes in a function
+  /// before continuing the call in JIT'ed code. 0 disables on-stack
+  /// replacement.
+  void setOSRThreshold(uint32_t threshold) {
+    osrThreshold_ = threshold;
+  }
+
+  /// Called by the interpreter on every taken backward jump in \p codeBlock.
+  /// \return true if the loop is hot and getOSREntry() should be called.
+  inline bool countLoopIteration(CodeBlock *codeBlock);
+
+  /// Find the entry point that continues the current interpreter frame of
+  /// \p codeBlock at the loop header at bytecode \p offset, compiling the
+  /// function first if needed. This may allocate.
+  /// \return the entry point, nullptr if the interpreter must continue.
+  JITCompiledFunctionPtr
+  getOSREntry(Runtime &runtime, CodeBlock *codeBlock, uint32_t offset);
+
+  /// Set the number of times the same regex bytecode is searched by the
+  /// interpreter before it is compiled to native matchers. 0 disables regexp
+  /// compilation.
+  void setRegExpThreshold(uint32_t threshold) {
+    regExpThreshold_ = threshold;
+  }
+
+  /// Whether setRegExpThreshold() has any effect.
+  static constexpr bool kRegExpCompileSupported = true;
+
+  /// Called before every interpreted search of a regexp with the given
+  /// \p bytecode. Regexps built at runtime are often recreated with the same
+  /// pattern, so searches are counted per bytecode rather than per JSRegExp.
+  /// Does not allocate on the JS heap.
+  /// \return native matchers for \p bytecode once it is hot, nullptr if the
+  /// search must be interpreted.
+  inline const SHNativeRegExp *getNativeRegExp(
+      llvh::ArrayRef<uint8_t> bytecode);
+
+  /// Enable or disable dumping JIT'ed Code.
+  void setDumpJITCode(unsigned dump) {
+    dumpJITCode_ = dump;
+  }
+
+  /// \return true if dumping JIT'ed Code is enabled.
+  unsigned getDumpJITCode() {
+    return dumpJITCode_;
+  }
+
+  /// Construct data structure used for perf profiling support. This should be
+  /// called only when PerfProf is enabled and perf JITContext.
+  /// \param jitdumpFd The file descriptor of the opened jitdump file.
+  /// \param commentFd The file descriptor of the opended \p commentFile.
+  /// \param commentFile The path of the file to store the comments.
+  void initPerfProfData(
+      int jitdumpFd,
+      int commentFd,
+      const std::string &commentFile) {
+    assert(
+        !perfJitDump_ &&
+        "perfJitDump_ should be constructed once per JITContext");
+    perfJitDump_ =
+        std::make_unique<PerfJitDump>(jitdumpFd, commentFd, commentFile);
+  }
+
+  /// Set the flag to fatally crash on JIT compilation errors.
+  void setCrashOnError(bool crash) {
+    crashOnError_ = crash;
+  }
+
+  /// \return true if we should fatally crash on JIT compilation errors.
+  bool getCrashOnError() {
+    return crashOnError_;
+  }
+
+  /// Set the flag to force jitting of all functions.
+  void setForceJIT(bool force) {
+    forceJIT_ = force;
+  }
+
+  /// Set the memory limit for JIT'ed code in bytes.
+  void setMemoryLimit(uint32_t memoryLimit) {
+    memoryLimit_ = memoryLimit;
+  }
+
+  /// Set the flag to emit asserts in the JIT'ed code.
+  void setEmitAsserts(bool emitAsserts) {
+    emitAsserts_ = emitAsserts;
+  }
+
+  /// Set whether we should emit counters in the JIT'ed code.
+  void setEmitCounters(bool emitCounters) {
+    assert(
+        (emitCounters || !counters_.get()) && "Can't disable enabled counters");
+    if (emitCounters && !counters_.get()) {
+      counters_.reset((uint64_t *)checkedCalloc(
+          (unsigned)JitCounter::_Last, sizeof(uint64_t)));
+    }
+  }
+
+  /// Dump the counters to the given stream. Counters must be enabled.
+  void dumpCounters(llvh::raw_ostream &os);
+
+  /// Whether setBackgroundCompile() has any effect.
+  static constexpr bool kBackgroundCompileSupported = true;
+
+  /// Enable or disable compilation on a background thread. When enabled,
+  /// compile() queues the CodeBlock and returns nullptr, so the interpreter
+  /// keeps executing it. Finished compilations are installed on the mutator
+  /// thread by the next call to compile() or getOSREntry().
+  /// Disabling waits for the queued compilations and installs them.
+  void setBackgroundCompile(bool background);
+
+  /// \return true if functions are compiled on a background thread.
+  bool getBackgroundCompile() const {
+    return backgroundCompile_;
+  }
+
+  /// Set the maximum number of CodeBlocks that can be waiting for, or being
+  /// compiled by, the background thread. Functions crossing the threshold
+  /// while the queue is full stay in the interpreter and are retried later.
+  void setMaxQueuedCompiles(uint32_t maxQueued) {
+    maxQueuedCompiles_ = maxQueued;
+  }
+
+  /// Block until every queued background compilation has finished, then
+  /// install the results.
+  void waitForBackgroundCompiles();
+
+  /// Drop the queued background compilations and stop the background thread.
+  /// This must be called before any queued CodeBlock can be destroyed.
+  void stopBackgroundCompiles();
+
+  /// \return the statistics about background compilation.
+  const BackgroundCompileStats &getBackgroundCompileStats() const {
+    return backgroundStats_;
+  }
+
+  /// Dump the background compilation statistics to the given stream.
+  void dumpBackgroundCompileStats(llvh::raw_ostream &os);
+
+  /// \return true if we should emit asserts in the JIT'ed code.
+  bool getEmitAsserts() {
+    return emitAsserts_;
+  }
+
+  /// Called by the GC at the beginning of a collection. This method informs the
+  /// GC of all runtime roots.  The \p markLongLived argument
+  /// indicates whether root data structures that contain only
+  /// references to long-lived objects (allocated directly as long lived)
+  /// are required to be scanned.
+  void markRoots(RootAcceptorWithNames &acceptor, bool markLongLived);
+
+ private:
+  /// \return whether \p codeBlock has run often enough to be compiled, and
+  /// is neither queued for nor excluded from compilation.
+  inline bool isReadyToCompile(CodeBlock *codeBlock) const;
+
+  /// Slow path that actually performs the compilation of the specified
+  /// CodeBlock.
+  JITCompiledFunctionPtr compileImpl(Runtime &runtime, CodeBlock *codeBlock);
+
+  /// Queue \p codeBlock for compilation on the background thread.
+  /// \return nullptr, the native code is installed later.
+  JITCompiledFunctionPtr enqueueCompile(Runtime &runtime, CodeBlock *codeBlock);
+
+  /// Install the compilations finished by the background thread.
+  void installBackgroundCompiles();
+
+  /// Slow path of getNativeRegExp(), which counts the search and compiles the
+  /// regexp once it is hot.
+  const SHNativeRegExp *getNativeRegExpImpl(llvh::ArrayRef<uint8_t> bytecode);
+
+  /// Apply the result \p res of compiling \p codeBlock.
+  /// \return the native pointer, nullptr if compilation failed.
+  JITCompiledFunctionPtr installCompileResult(
+      CodeBlock *codeBlock,
+      const CompileResult &res);
+
+ private:
+  /// Only initialized if JIT is enabled.
+  std::unique_ptr<Impl> impl_{};
+
+  /// Whether JIT compilation is enabled.
+  bool enabled_{false};
+  /// The memory limit for JIT'ed code in bytes.
+  /// Once the limit is reached, no more code will be JIT'ed.
+  uint32_t memoryLimit_{32u << 20};
+  /// whether to dump JIT'ed code
+  unsigned dumpJITCode_{0};
+  /// whether to fatally crash on JIT compilation errors
+  bool crashOnError_{false};
+  /// Whether to emit asserts in the JIT'ed code.
+  bool emitAsserts_{false};
+  /// Whether to force jitting of all functions.
+  /// If true, ignores the default exec threshold completely.
+  bool forceJIT_{false};
+
+  /// Generate jitdump for all jitted functions.
+  std::unique_ptr<PerfJitDump> perfJitDump_{};
+
+  /// The JIT threshold for function execution count.
+  /// Lowered based on the loop depth before deciding whether to JIT.
+  uint32_t defaultExecThreshold_ = 1 << 5;
+
+  /// The number of loop iterations in the interpreter before on-stack
+  /// replacement is attempted. 0 if it is disabled.
+  uint32_t osrThreshold_ = 1 << 10;
+
+  /// The number of interpreted searches of the same regex bytecode before it
+  /// is compiled. 0 if regexps are not compiled.
+  uint32_t regExpThreshold_ = 0;
+
+  /// Array of counters for use by the emitted code.
+  TransparentOwningPtr<uint64_t, llvh::FreeDeleter> counters_;
+
+  /// Whether compilation happens on a background thread.
+  bool backgroundCompile_{false};
+  /// Maximum number of CodeBlocks queued for background compilation.
+  uint32_t maxQueuedCompiles_{16};
+  /// Set by the background thread when there are compilations waiting to be
+  /// installed.
+  std::atomic<bool> compilesFinished_{false};
+  /// Statistics about background compilation, only accessed by the mutator.
+  BackgroundCompileStats backgroundStats_{};
+};
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+inline bool JITContext::shouldCompile(CodeBlock *codeBlock) {
+  assert(!codeBlock->getJITCompiled() && "already compiled");
+
+  if (LLVM_LIKELY(!enabled_))
+    return false;
+  // Installing the finished compilations may allocate, so it is left to
+  // compile(), which the interpreter calls with the IP saved.
+  if (LLVM_UNLIKELY(compilesFinished_.load(std::memory_order_acquire)))
+    return true;
+  return isReadyToCompile(codeBlock);
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+inline bool JITContext::isReadyToCompile(CodeBlock *codeBlock) const {
+  if (LLVM_LIKELY(codeBlock->getDontJIT()))
+    return false;
+  // A queued block is installed by installBackgroundCompiles().
+  if (LLVM_UNLIKELY(codeBlock->getJITQueued()))
+    return false;
+
+  uint32_t loopDepth = codeBlock->getFunctionHeader().getLoopDepth();
+  // It's possible that if the loop depth is too high, we will set the
+  // execThreshold to 0 for this function, but that's OK because we want to JIT
+  // it immediately.
+  assert(loopDepth <= 3 && "loopDepth is larger than expected");
+  uint32_t execThreshold =
+      forceJIT_ ? 0 : (defaultExecThreshold_ >> (loopDepth * 2));
+
+  if (LLVM_LIKELY(codeBlock->getExecutionCount() < execThreshold))
+    return false;
+
+  return true;
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+inline bool JITContext::countLoopIteration(CodeBlock *codeBlock) {
+  if (LLVM_LIKELY(!enabled_ || !osrThreshold_))
+    return false;
+  return codeBlock->incrementLoopIterationCount() >= osrThreshold_;
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+inline const SHNativeRegExp *JITContext::getNativeRegExp(
+    llvh::ArrayRef<uint8_t> bytecode) {
+  if (LLVM_LIKELY(!enabled_ || !regExpThreshold_))
+    return nullptr;
+  return getNativeRegExpImpl(bytecode);
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+inline JITCompiledFunctionPtr JITContext::compile(
+    Runtime &runtime,
+    CodeBlock *codeBlock) {
+  assert(!codeBlock->getJITCompiled() && "already compiled");
+  assert(shouldCompile(codeBlock) && "should not be compiled");
+  return compileImpl(runtime, codeBlock);
+}
+
+} // namespace x86_64
+} // namespace vm
+} // namespace hermes
+#endif // HERMES_VM_JIT_X86_64_JIT_H
@@ -47,8 +47,8 @@ class JSArrayBuffer final : public JSObject {
       size_type size);
 
   /// ES7 24.1.1.4
-  /// NOTE: since SharedArrayBuffer does not exist, this does not use the
-  /// SpeciesConstructor, it always allocates a normal ArrayBuffer.
+  /// NOTE: this does not use the SpeciesConstructor, it always allocates a
+  /// normal ArrayBuffer, even if \p src is a SharedArrayBuffer.
   static CallResult<Handle<JSArrayBuffer>> clone(
       Runtime &runtime,
       Handle<JSArrayBuffer> src,
@@ -87,6 +87,26 @@ class JSArrayBuffer final : public JSObject {
       size_type size,
       const std::shared_ptr<void> &context);
 
+  /// Creates a zeroed data block of size \p size that can be shared with other
+  /// runtimes, and makes \p self a SharedArrayBuffer over it. The block is
+  /// reference counted and freed when the last SharedArrayBuffer using it, in
+  /// any runtime, is finalized.
+  /// \return ExecutionStatus::RETURNED iff the allocation was successful.
+  static ExecutionStatus createSharedDataBlock(
+      Runtime &runtime,
+      Handle<JSArrayBuffer> self,
+      size_type size);
+
+  /// Makes \p self a SharedArrayBuffer over the block \p data of size \p size,
+  /// which is kept alive by \p context. Used to share a block created by
+  /// createSharedDataBlock with another runtime.
+  static void setSharedDataBlock(
+      Runtime &runtime,
+      Handle<JSArrayBuffer> self,
+      uint8_t *data,
+      size_type size,
+      const std::shared_ptr<void> &context);
+
   /// \return A shared pointer whose deleter cleans up the external data block,
   /// specified when the external data was first set. In practice, users should
   /// always set a valid pointer to clean up the data, so the context ptr should
@@ -123,6 +143,12 @@ class JSArrayBuffer final : public JSObject {
     return external_;
   }
 
+  /// Whether this JSArrayBuffer is a SharedArrayBuffer. Shared buffers always
+  /// use an external data block and can never be detached.
+  bool shared() const {
+    return shared_;
+  }
+
   /// Detaches this buffer from its data block, effectively freeing the storage
   /// and setting this ArrayBuffer to have zero size.  The \p gc argument allows
   /// the GC to be informed of this external memory deletion.
@@ -168,11 +194,13 @@ class JSArrayBuffer final : public JSObject {
   /// Untrack the internal buffer from GC snapshots
   void untrackInternalBuffer(GC &gc);
 
-  /// data_ size_, and external_ are only valid when attached_ is true.
-  /// if detached_, data_ is nullptr, size_ is 0, and external_ is false.
+  /// data_ size_, external_ and shared_ are only valid when attached_ is true.
+  /// if detached_, data_ is nullptr, size_ is 0, and external_ and shared_ are
+  /// false.
   uint8_t *data_;
   size_type size_;
   bool external_;
+  bool shared_;
   bool attached_;
 
  public:
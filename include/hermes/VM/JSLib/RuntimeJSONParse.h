@@ -10,6 +10,8 @@
 
 #include "hermes/VM/Runtime.h"
 
+#include "llvh/ADT/ArrayRef.h"
+
 namespace hermes {
 
 class UTF16Stream;
@@ -25,6 +27,14 @@ CallResult<HermesValue> runtimeJSONParse(
 /// Alternative interface to runtimeJSONParse for strings outside the JS heap.
 CallResult<HermesValue> runtimeJSONParseRef(Runtime &runtime, UTF16Stream &&s);
 
+/// Parse JSON from the UTF-8 buffer \p utf8, which is owned by the caller and
+/// lives outside the JS heap. If the buffer is entirely ASCII, it is lexed in
+/// place without being copied or transcoded; otherwise it is decoded to UTF-16
+/// incrementally as it is consumed.
+CallResult<HermesValue> runtimeJSONParseUTF8(
+    Runtime &runtime,
+    llvh::ArrayRef<uint8_t> utf8);
+
 } // namespace vm
 } // namespace hermes
 
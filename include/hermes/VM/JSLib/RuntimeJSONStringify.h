@@ -10,6 +10,9 @@
 
 #include "hermes/VM/Runtime.h"
 
+#include "llvh/ADT/STLExtras.h"
+#include "llvh/ADT/StringRef.h"
+
 namespace hermes {
 namespace vm {
 
@@ -21,6 +24,24 @@ CallResult<HermesValue> runtimeJSONStringify(
     Handle<> replacer,
     Handle<> space);
 
+/// Receives chunks of UTF-8 output from runtimeJSONStringifyToSink.
+using JSONStringifySink = llvh::function_ref<void(llvh::StringRef chunk)>;
+
+/// Like runtimeJSONStringify, but passes the output to \p sink as UTF-8 in
+/// chunks of about \p chunkSize bytes, instead of creating a string. Only
+/// about one chunk is buffered at a time, although a single string or
+/// property name is never split across chunks.
+/// \return false if \p value has no JSON representation (e.g. undefined), in
+///   which case \p sink is not called. If an exception is thrown, some of the
+///   output may already have been passed to \p sink.
+CallResult<bool> runtimeJSONStringifyToSink(
+    Runtime &runtime,
+    Handle<> value,
+    Handle<> replacer,
+    Handle<> space,
+    JSONStringifySink sink,
+    size_t chunkSize);
+
 } // namespace vm
 } // namespace hermes
 
@@ -12,6 +12,9 @@
 
 #include "hermes/VM/CallResult.h"
 
+#include "llvh/ADT/ArrayRef.h"
+#include "llvh/ADT/STLExtras.h"
+
 /// Defines custom sorting routines used in cases that we can't use std::sort.
 /// std::sort doesn't always use std::swap, performing operations that bypass
 /// the user-defined swap routines. When calling [[Put]] and [[Delete]], we
@@ -38,9 +41,20 @@ class SortModel {
   virtual ~SortModel() = 0;
 };
 
-/// QuickSort to sort elements in the range [begin, end). Returns immediately
-/// with ExecutionStatus::EXCEPTION if any compare or swap operations fail.
-ExecutionStatus quickSort(SortModel *sm, uint32_t begin, uint32_t end);
+/// Stable sort of the elements in the range [begin, end), using an adaptive
+/// merge sort that detects ascending and descending runs (TimSort). Already
+/// sorted input takes end - begin - 1 comparisons. The elements stay in place
+/// while they are compared; they are moved into their final positions at the
+/// end, with fewer than end - begin swaps. Returns immediately with
+/// ExecutionStatus::EXCEPTION if any compare or swap operations fail; a
+/// failing compare leaves the elements in their original order.
+ExecutionStatus timSort(SortModel *sm, uint32_t begin, uint32_t end);
+
+/// Stable sort of \p perm by \p less, using the same algorithm as timSort().
+/// \p less is given elements of \p perm, and must not fail.
+void timSort(
+    llvh::MutableArrayRef<uint32_t> perm,
+    llvh::function_ref<bool(uint32_t, uint32_t)> less);
 
 } // namespace vm
 } // namespace hermes
@@ -8,11 +8,14 @@
 #ifndef HERMES_VM_JSREGEXP_H
 #define HERMES_VM_JSREGEXP_H
 
+#include "hermes/Regex/Executor.h"
 #include "hermes/Regex/Regex.h"
 #include "hermes/Regex/RegexTypes.h"
 #include "hermes/VM/JSObject.h"
+#include "hermes/VM/RegExpCache.h"
 #include "hermes/VM/RegExpMatch.h"
 #include "hermes/VM/SmallXString.h"
+#include "hermes/VM/sh_native_regexp.h"
 
 #include <memory>
 #include "llvh/ADT/SmallString.h"
@@ -50,19 +53,20 @@ class JSRegExp final : public JSObject {
       Runtime &runtime,
       Handle<HiddenClass> arrayClass);
 
-  /// Initializes RegExp with existing bytecode. Populates fields for the
-  /// pattern and flags, but performs no validation on them. It is assumed that
-  /// the bytecode is correct and corresponds to the given pattern/flags.
+  /// Initializes RegExp with existing bytecode, which is shared rather than
+  /// copied. Populates fields for the pattern and flags, but performs no
+  /// validation on them. It is assumed that the bytecode is correct and
+  /// corresponds to the given pattern/flags.
   static void initialize(
       Handle<JSRegExp> selfHandle,
       Runtime &runtime,
       Handle<StringPrimitive> pattern,
       Handle<StringPrimitive> flags,
-      llvh::ArrayRef<uint8_t> bytecode);
+      SharedRegExpBytecode bytecode);
 
   /// Initialize a RegExp based on another RegExp \p otherHandle. If \p flags
   /// matches the internal flags of the other RegExp, this lets us avoid
-  /// recompiling by just copying the bytecode.
+  /// recompiling by just sharing the bytecode.
   static ExecutionStatus initialize(
       Handle<JSRegExp> selfHandle,
       Runtime &runtime,
@@ -98,11 +102,26 @@ class JSRegExp final : public JSObject {
     return self->syntaxFlags_;
   }
 
+  /// \return the bytecode this RegExp searches with, which may be shared with
+  /// other RegExps.
+  static llvh::ArrayRef<uint8_t> getBytecode(JSRegExp *self) {
+    return {self->bytecode_.get(), self->bytecodeSize_};
+  }
+
   /// Set the flag bits for this RegExp to \p flags
   static void setSyntaxFlags(JSRegExp *self, regex::SyntaxFlags flags) {
     self->syntaxFlags_ = flags;
   }
 
+  /// Use the matchers generated by the native backend in \p nativeRegExp to
+  /// search, instead of interpreting the bytecode. The matchers must have been
+  /// generated from the bytecode this RegExp was initialized with.
+  static void setNativeRegExp(
+      JSRegExp *self,
+      const SHNativeRegExp *nativeRegExp) {
+    self->nativeRegExp_ = nativeRegExp;
+  }
+
   Handle<JSObject> getGroupNameMappings(Runtime &runtime);
 
   void setGroupNameMappings(Runtime &runtime, JSObject *groupObj);
@@ -136,14 +155,14 @@ class JSRegExp final : public JSObject {
  private:
   ~JSRegExp();
 
-  /// Store a copy of the \p bytecode array.
-  void initializeBytecode(llvh::ArrayRef<uint8_t> bytecode);
+  /// Use \p bytecode to search, sharing it with its other users.
+  void initializeBytecode(SharedRegExpBytecode bytecode);
 
   static ExecutionStatus initializeGroupNameMappingObj(
       Runtime &runtime,
       Handle<JSRegExp> selfHandle,
-      std::deque<llvh::SmallVector<char16_t, 5>> &orderedNamedGroups,
-      regex::ParsedGroupNamesMapping &parsedMappings);
+      const std::deque<llvh::SmallVector<char16_t, 5>> &orderedNamedGroups,
+      const regex::ParsedGroupNamesMapping &parsedMappings);
 
   /// The order of properties here is important to avoid wasting space. When
   /// compressed pointers are enabled, JSObject has an odd number of 4 byte
@@ -151,7 +170,19 @@ class JSRegExp final : public JSObject {
   /// that the native pointer is always 8 byte aligned without extra padding.
   GCPointer<StringPrimitive> pattern_;
 
-  uint8_t *bytecode_{};
+  /// The compiled regex, which may be shared with other RegExps, the
+  /// RegExpCache, or the module containing the regex literal.
+  std::shared_ptr<const uint8_t> bytecode_{};
+
+  /// Matchers generated from bytecode_ by the native backend, if any, which
+  /// are statically allocated in the compiled unit, or compiled by the JIT,
+  /// which owns them for the lifetime of the Runtime.
+  const SHNativeRegExp *nativeRegExp_{nullptr};
+
+  /// The analysis of bytecode_ used by interpreted searches, built by the
+  /// first one.
+  std::unique_ptr<regex::SearchAnalysis> searchAnalysis_{};
+
   uint32_t bytecodeSize_{0};
 
   regex::SyntaxFlags syntaxFlags_ = {};
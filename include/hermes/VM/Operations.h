@@ -211,6 +211,10 @@ abstractEqualityTest_RJS(Runtime &runtime, Handle<> xHandle, Handle<> yHandle);
 /// ES5.1 11.9.6
 bool strictEqualityTest(HermesValue x, HermesValue y);
 
+/// ES5.1 11.9.6, flattening strings that are ropes before comparing them.
+/// Prefer this to the version without a runtime wherever one is available.
+bool strictEqualityTest(Runtime &runtime, HermesValue x, HermesValue y);
+
 /// Convert a string to a uniqued property name.
 inline CallResult<Handle<SymbolID>> stringToSymbolID(
     Runtime &runtime,
@@ -32,23 +32,32 @@ struct HashMapEntry {
 /// order.
 ///
 /// The map contains two conceptual parts:
-/// 1) An ArrayStorageSmall representing a standard hash table with open
-/// addressing, to store numbers that could be used to index into the data table
-/// discussed in #2.
+/// 1) A standard hash table with open addressing, whose buckets store numbers
+/// that could be used to index into the data table discussed in #2, along with
+/// the hash of the entry's key.
 /// 2) A data table, which is an ArrayStorageSmall that stores the entry's key
 /// and value in-place. This eliminates the need to create a new GCCell for each
 /// entry of the hash table.
 ///
+/// Keeping the hash in the bucket means that probing only reads the data table
+/// for buckets whose hash matches, and that rehashing never needs to hash a key
+/// again, which matters for strings and for maps with millions of entries.
+///
 /// The data table is used in insertion order. When a new entry is added to the
 /// hash table, the entry is appended to the data table. The key and value of
 /// the entry are stored in-place at those slots. And then the hash table stores
 /// a number that allows us to index into the data table to look at the values
 /// later. When deleting an entry, the key and value elements in the data table
-/// are set to empty values to signify that they've been deleted.
+/// are set to empty values to signify that they've been deleted, and its bucket
+/// is removed by shifting the rest of its probe sequence back, so that the hash
+/// table never contains tombstones.
 ///
 /// When the number of alive elements and deleted elements exceeds thresholds,
 /// we will perform a rehash. When rehashing, a new data table is allocated and
-/// only the elements that aren't deleted are copied to the new data table.
+/// only the elements that aren't deleted are copied to the new data table. If
+/// at least half of the data table is deleted entries, the capacity is
+/// sufficient, and the data table is instead compacted in place, renumbering
+/// the buckets without moving them.
 ///
 /// Iterators can simply keep an index to the data table because all the values
 /// are appended in insertion order. When performing clear and rehash
@@ -225,7 +234,7 @@ class OrderedHashMapBase {
   /// This function should be invoked by child class' finalizer to do any final
   /// tasks on the GC before destructor gets called.
   void cleanUp(GCCell *self, GC &gc) {
-    uint32_t capacityInBytes = hashTable_.size() * sizeof(uint32_t);
+    uint32_t capacityInBytes = hashTable_.size() * sizeof(Bucket);
     gc.debitExternalMemory(self, capacityInBytes);
   }
 
@@ -274,9 +283,18 @@ class OrderedHashMapBase {
   }
 
  private:
+  /// A bucket of the hash table.
+  struct Bucket {
+    /// The index of the entry's key in the data table, or
+    /// kHashTableElementUnused.
+    uint32_t dataTableKeyIndex;
+    /// The hash of the entry's key. Undefined for unused buckets.
+    uint32_t hash;
+  };
+
   /// The hashtable, with size always equal to capacity_. The number of
-  /// reachable entries from hashTable_ should be equal to size_.
-  std::vector<uint32_t> hashTable_{};
+  /// used buckets in hashTable_ should be equal to size_.
+  std::vector<Bucket> hashTable_{};
 
   /// The data table is where the actual data for each hash table entry is
   /// stored. It's an array where each entry can use up multiple elements. For
@@ -313,11 +331,12 @@ class OrderedHashMapBase {
 
   /// For representing when the hash table element is unused.
   static constexpr uint32_t kHashTableElementUnused = kMaxCapacity + 1;
-  /// For epresenting when the hash table element is deleted.
-  static constexpr uint32_t kHashTableElementDeleted = kMaxCapacity + 2;
   static_assert(
-      kHashTableElementDeleted > kMaxCapacity,
-      "kHashTableElementDeleted overflows.");
+      kHashTableElementUnused > kMaxCapacity,
+      "kHashTableElementUnused overflows.");
+
+  /// An unused bucket.
+  static constexpr Bucket kUnusedBucket{kHashTableElementUnused, 0};
 
   /// Capacity of the hash table.
   uint32_t capacity_{kInitialCapacity};
@@ -348,28 +367,30 @@ class OrderedHashMapBase {
     return rehashThreshold(hashTableCapacity) * BucketType::kElementsPerEntry;
   }
 
-  /// Hash a HermesValue to an index to our hash table.
-  static uint32_t
-  hashToBucket(uint32_t capacity, Runtime &runtime, HermesValue key) {
-    auto hash = runtime.gcStableHashHermesValue(key);
+  /// Hash a HermesValue. The hash is stable across GCs, so it can be stored
+  /// in the hash table.
+  static uint32_t hashKey(Runtime &runtime, HermesValue key) {
+    return runtime.gcStableHashHermesValue(key);
+  }
+
+  /// \return the index of the first bucket to probe for \p hash.
+  static uint32_t hashToBucket(uint32_t capacity, uint32_t hash) {
     assert((capacity & (capacity - 1)) == 0 && "capacity_ must be power of 2");
     return hash & (capacity - 1);
   }
 
-  /// Lookup an entry with key as \p key in a given \p bucket (hash).
+  /// Lookup an entry with key as \p key, whose hash is \p hash.
   /// \return If found, returns the pair of the corresponding data table index
   /// and the bucket index for it. If not found, then data table key index won't
   /// be available, and the bucket index would be the bucket available for the
   /// \p key.
   std::pair<OptValue<uint32_t>, uint32_t>
-  lookupInBucket(Runtime &runtime, uint32_t bucket, HermesValue key) const;
+  lookupInBucket(Runtime &runtime, uint32_t hash, HermesValue key) const;
 
   /// Perform a rehash operation by removing all deleted entries and re-insert
-  /// them into new allocated hash table and data table. The old hash table and
-  /// data table are discarded. The new capacity will be calculated by
-  /// checkedNextCapacity(). Note that this function will always run rehash even
-  /// if the new capacity is same as before. In such case, all the deleted
-  /// bucket will be removed and become empty bucket.
+  /// them into new allocated hash table and data table, using the hashes
+  /// stored in the buckets. The old hash table and data table are discarded.
+  /// The new capacity will be calculated by checkedNextCapacity().
   /// \param beforeAdd if true, we use current size + 1 to calculate the new
   /// capacity. This is used when calling from doInsert() because we're about to
   /// add one more entry. Otherwise, we use current size to calculate the new
@@ -378,6 +399,12 @@ class OrderedHashMapBase {
   static ExecutionStatus
   rehash(Handle<Derived> self, Runtime &runtime, bool beforeAdd = false);
 
+  /// Remove all deleted entries from the data table in place, keeping the
+  /// capacity, and adjust any active iterators. The buckets stay where they
+  /// are and only their data table indices are updated, so nothing is hashed
+  /// or probed. Unlike rehash(), this does not allocate on the GC heap.
+  void compact(Runtime &runtime);
+
   /// This function updates all active iterator indices to adjust the value
   /// after a rehash. A rehash will remove any deleted entries of the
   /// OrderedHashMap, so indices need to be adjusted to account for those
@@ -417,7 +444,8 @@ class OrderedHashMapBase {
     return capacity * kGrowOrShrinkFactor;
   }
 
-  /// Mark the bucket as deleted.
+  /// Delete the entry in \p bucket, whose key is at \p dataTableKeyIndex in
+  /// the data table.
   static void deleteBucket(
       Handle<Derived> self,
       Runtime &runtime,
@@ -437,17 +465,37 @@ class OrderedHashMapBase {
     }
 
     assert(bucket < self->capacity_ && "Hash table index >= capacity.");
-    self->hashTable_[bucket] = kHashTableElementDeleted;
+    // Rather than leaving a tombstone, move later buckets of the probe
+    // sequence back into the hole whenever their home bucket allows it, so
+    // that every used bucket stays reachable from its home bucket.
+    std::vector<Bucket> &table = self->hashTable_;
+    const uint32_t mask = self->capacity_ - 1;
+    uint32_t hole = bucket;
+    for (uint32_t next = (hole + 1) & mask;
+         table[next].dataTableKeyIndex != kHashTableElementUnused;
+         next = (next + 1) & mask) {
+      uint32_t home = hashToBucket(self->capacity_, table[next].hash);
+      // The bucket can move to the hole if the hole is between its home and
+      // its current position.
+      if (((next - home) & mask) >= ((next - hole) & mask)) {
+        table[hole] = table[next];
+        hole = next;
+      }
+    }
+    table[hole] = kUnusedBucket;
   }
 
   /// Helper function for inserting key or key/value pair into the container.
   /// This is used by the public insert() functions and only for adding keys
   /// that don't already exist. This will update the hash table as well as
   /// appending key (and value if applicable) to the data table.
+  /// \p bucket is the bucket found for the key by lookupInBucket(), and
+  /// \p hash is the hash of the key.
   static ExecutionStatus doInsert(
       Handle<Derived> self,
       Runtime &runtime,
       uint32_t bucket,
+      uint32_t hash,
       Handle<> key,
       Handle<> value);
 
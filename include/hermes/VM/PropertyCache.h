@@ -12,12 +12,22 @@
 #include "hermes/VM/WeakRoot.h"
 #include "hermes/VM/sh_mirror.h"
 
+#ifdef HERMESVM_PROPERTY_CACHE_STATS
+#include "llvh/ADT/DenseMap.h"
+#endif
+
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace hermes {
 namespace vm {
 using SlotIndex = uint32_t;
 
 class JSObject;
 class HiddenClass;
+class Runtime;
+class WeakRootAcceptor;
 
 /// A cache entry for property writes.
 /// If clazz is populated, then it's the class for the property write when
@@ -35,6 +45,10 @@ struct WritePropertyCacheEntry {
   /// High 24 bits: addCache index. 0 is reserved and entry is never stored to.
   uint32_t _slotAndAddCacheIndex{0};
 
+  /// One-based index of the PolymorphicPropertyCache site tracking the
+  /// additional classes seen by this entry, or 0 if the entry is monomorphic.
+  uint32_t polyIndex{0};
+
   /// Can store 8-bit slot.
   static constexpr SlotIndex kMaxSlot = 0xff;
 
@@ -107,6 +121,10 @@ struct ReadPropertyCacheEntry {
   /// couldn't be cached.
   uint8_t numGoodChanges{0};
 
+  /// One-based index of the PolymorphicPropertyCache site tracking the
+  /// additional classes seen by this entry, or 0 if the entry is monomorphic.
+  uint32_t polyIndex{0};
+
   /// \return the cached property index.
   uint16_t getSlot() const {
     return _slot16 & kMaxSlot;
@@ -177,6 +195,246 @@ struct AddPropertyCacheEntry {
   }
 };
 
+/// Runtime-wide storage for property cache entries that have seen more than
+/// one HiddenClass.
+/// The inline fast paths (interpreter, native backend and JIT) only ever check
+/// the monomorphic class stored directly in the Read/WritePropertyCacheEntry.
+/// When that check fails, the shared slow paths consult this cache before
+/// doing a full property lookup. An entry which sees a second class is given a
+/// "site" with up to kNumWays additional classes. A site which overflows its
+/// ways becomes megamorphic and from then on uses a direct-mapped table shared
+/// by all megamorphic sites and keyed by (class, name).
+/// The monomorphic class of an entry is never replaced by a different class
+/// once the entry has a site, so the JIT can keep specializing on it.
+/// When built with HERMESVM_PROPERTY_CACHE_STATS, the cache also keeps
+/// counters for every Read/WritePropertyCacheEntry used by GetById and
+/// PutById, including the monomorphic hits reported by the fast paths through
+/// PROPERTY_CACHE_COUNT_MONO_HIT. The inline fast paths of the native backend
+/// and the JIT are disabled in that configuration so that every access can be
+/// counted.
+class PolymorphicPropertyCache {
+ public:
+  /// Number of classes a polymorphic site can hold in addition to the
+  /// monomorphic entry.
+  static constexpr unsigned kNumWays = 4;
+
+  /// Maximum number of sites that can be allocated. Entries that become
+  /// polymorphic after this limit is reached keep the old monomorphic
+  /// behaviour of replacing the cached class.
+  static constexpr uint32_t kMaxSites = 1 << 16;
+
+  /// Log2 of the number of entries in the megamorphic table.
+  static constexpr unsigned kLog2MegaSize = 10;
+
+  /// A single cached class, following the layout of ReadPropertyCacheEntry.
+  /// Write sites never set negMatchClazz.
+  struct Way {
+    WeakRoot<HiddenClass> clazz{nullptr};
+    WeakRoot<HiddenClass> negMatchClazz{nullptr};
+    SlotIndex slot{0};
+  };
+
+  /// The polymorphic state of a single property cache entry.
+  struct Site {
+    Way ways[kNumWays];
+    /// Whether the site has overflowed its ways. When set the ways are unused.
+    bool megamorphic{false};
+    /// Number of lookups satisfied by one of the ways.
+    uint32_t polyHits{0};
+    /// Number of lookups satisfied by the megamorphic table.
+    uint32_t megaHits{0};
+    /// Number of lookups which missed both the ways and the megamorphic table.
+    uint32_t misses{0};
+  };
+
+  /// Aggregated counters for all sites.
+  struct Stats {
+    /// Sites that have seen more than one class, including megamorphic ones.
+    uint32_t numPolymorphicSites{0};
+    uint32_t numMegamorphicSites{0};
+    uint64_t polyHits{0};
+    uint64_t megaHits{0};
+    uint64_t misses{0};
+  };
+
+#ifdef HERMESVM_PROPERTY_CACHE_STATS
+  /// Counters of a single property cache entry.
+  struct EntryStats {
+    /// The property accessed through the entry, in UTF-8.
+    std::string name;
+    /// Whether the entry caches writes rather than reads.
+    bool write;
+    /// Number of lookups satisfied by the class stored in the entry itself,
+    /// including proto hits.
+    uint64_t monoHits{0};
+    uint64_t polyHits{0};
+    uint64_t megaHits{0};
+    /// Number of lookups which missed all cached classes.
+    uint64_t misses{0};
+  };
+
+  /// Count a hit on the class stored in \p entry, which caches reads or
+  /// writes of \p name depending on \p write.
+  void
+  countMonoHit(Runtime &runtime, const void *entry, SymbolID name, bool write) {
+    ++getEntryStats(runtime, entry, name, write).monoHits;
+  }
+
+  /// \return the counters of all entries seen so far, in the order in which
+  /// they were first used. Entries are identified by address, so an entry
+  /// freed along with its RuntimeModule may share counters with a later one.
+  const std::vector<EntryStats> &getAllEntryStats() const {
+    return entryStats_;
+  }
+#endif
+
+  /// Look for the class of \p obj in the polymorphic state of \p entry.
+  /// \return the object holding the property \p name (either \p obj or its
+  /// parent) and set \p slot to its slot, or nullptr on a miss.
+  JSObject *tryRead(
+      Runtime &runtime,
+      ReadPropertyCacheEntry *entry,
+      JSObject *obj,
+      SymbolID name,
+      SlotIndex &slot);
+
+  /// Look for the class of \p obj in the polymorphic state of \p entry.
+  /// \return true and set \p slot to the slot of the writable own property
+  /// \p name on a hit.
+  bool tryWrite(
+      Runtime &runtime,
+      WritePropertyCacheEntry *entry,
+      JSObject *obj,
+      SymbolID name,
+      SlotIndex &slot);
+
+  /// Record in \p entry that the property \p name is at \p slot in objects
+  /// of class \p clazz, or, if \p negMatchClazz is non-null, in the parent of
+  /// objects of class \p negMatchClazz, whose class is \p clazz.
+  /// \pre slot <= ReadPropertyCacheEntry::kMaxSlot
+  void recordRead(
+      ReadPropertyCacheEntry *entry,
+      CompressedPointer clazz,
+      CompressedPointer negMatchClazz,
+      SlotIndex slot,
+      SymbolID name);
+
+  /// Record in \p entry that the writable own property \p name is at \p slot
+  /// in objects of class \p clazz.
+  /// \pre slot <= WritePropertyCacheEntry::kMaxSlot
+  void recordWrite(
+      WritePropertyCacheEntry *entry,
+      CompressedPointer clazz,
+      SlotIndex slot,
+      SymbolID name);
+
+  /// \return the site with the one-based index \p polyIndex, or nullptr if
+  /// \p polyIndex is 0.
+  const Site *getSite(uint32_t polyIndex) const {
+    return polyIndex ? &sites_[polyIndex - 1] : nullptr;
+  }
+
+  /// \return counters aggregated over all sites.
+  Stats getStats() const;
+
+  /// Clear the classes and symbols that are no longer alive.
+  void markWeakRoots(WeakRootAcceptor &acceptor);
+
+  /// \return the number of bytes of malloc memory used by the cache.
+  size_t getMemorySize() const;
+
+ private:
+  /// Implementation of tryRead() and tryWrite(), which count the result when
+  /// HERMESVM_PROPERTY_CACHE_STATS is enabled.
+  JSObject *tryReadImpl(
+      Runtime &runtime,
+      ReadPropertyCacheEntry *entry,
+      JSObject *obj,
+      SymbolID name,
+      SlotIndex &slot);
+  bool tryWriteImpl(
+      WritePropertyCacheEntry *entry,
+      JSObject *obj,
+      SymbolID name,
+      SlotIndex &slot);
+
+#ifdef HERMESVM_PROPERTY_CACHE_STATS
+  /// \return the counters of \p entry, creating them if this is the first
+  /// time \p entry is seen.
+  EntryStats &getEntryStats(
+      Runtime &runtime,
+      const void *entry,
+      SymbolID name,
+      bool write);
+
+  /// Count the result of a lookup in the polymorphic state of \p entry.
+  void countLookup(
+      Runtime &runtime,
+      const void *entry,
+      uint32_t polyIndex,
+      SymbolID name,
+      bool write,
+      bool hit);
+#endif
+
+  /// An entry of the megamorphic table.
+  struct MegaEntry {
+    WeakRoot<HiddenClass> clazz{nullptr};
+    WeakRootSymbolID name{};
+    uint16_t slot{0};
+    /// Whether the property may be written through this entry.
+    bool writable{false};
+  };
+
+  /// \return the megamorphic table entry for (\p clazz, \p name).
+  MegaEntry &megaEntry(CompressedPointer clazz, SymbolID name);
+
+  /// \return the site of \p polyIndex, allocating a new one if it is 0.
+  /// \return nullptr if no more sites can be allocated.
+  Site *getOrCreateSite(uint32_t &polyIndex);
+
+  /// Add (\p clazz, \p negMatchClazz, \p slot) to \p site, turning it
+  /// megamorphic if all ways are taken. \return true if the class was added to
+  /// a way.
+  bool addWay(
+      Site &site,
+      CompressedPointer clazz,
+      CompressedPointer negMatchClazz,
+      SlotIndex slot);
+
+  /// Insert an own property into the megamorphic table.
+  void
+  addMega(CompressedPointer clazz, SymbolID name, SlotIndex slot, bool write);
+
+  /// All allocated sites, indexed by polyIndex - 1.
+  std::vector<Site> sites_{};
+
+  /// The megamorphic table, allocated when the first site turns megamorphic.
+  std::unique_ptr<MegaEntry[]> megaTable_{};
+
+  /// Number of sites that have turned megamorphic.
+  uint32_t numMegamorphicSites_{0};
+
+#ifdef HERMESVM_PROPERTY_CACHE_STATS
+  /// Map from the address of a property cache entry to its index in
+  /// entryStats_.
+  llvh::DenseMap<const void *, uint32_t> entryStatsIndex_{};
+
+  /// Counters of all entries seen so far.
+  std::vector<EntryStats> entryStats_{};
+#endif
+};
+
+/// Count a hit on the monomorphic class of the property cache entry \p entry
+/// of a GetById or PutById of \p name, when HERMESVM_PROPERTY_CACHE_STATS is
+/// enabled.
+#ifdef HERMESVM_PROPERTY_CACHE_STATS
+#define PROPERTY_CACHE_COUNT_MONO_HIT(runtime, entry, name, write) \
+  (runtime).getPolyPropCache().countMonoHit(runtime, entry, name, write)
+#else
+#define PROPERTY_CACHE_COUNT_MONO_HIT(runtime, entry, name, write) ((void)0)
+#endif
+
 static_assert(
     sizeof(SHWritePropertyCacheEntry) == sizeof(WritePropertyCacheEntry));
 static_assert(
@@ -185,6 +443,9 @@ static_assert(
 static_assert(
     offsetof(SHWritePropertyCacheEntry, slotAndAddCacheIndex) ==
     offsetof(WritePropertyCacheEntry, _slotAndAddCacheIndex));
+static_assert(
+    offsetof(SHWritePropertyCacheEntry, polyIndex) ==
+    offsetof(WritePropertyCacheEntry, polyIndex));
 static_assert(
     sizeof(SHReadPropertyCacheEntry) == sizeof(ReadPropertyCacheEntry));
 static_assert(
@@ -196,6 +457,9 @@ static_assert(
 static_assert(
     offsetof(SHReadPropertyCacheEntry, numChanges) ==
     offsetof(ReadPropertyCacheEntry, numGoodChanges));
+static_assert(
+    offsetof(SHReadPropertyCacheEntry, polyIndex) ==
+    offsetof(ReadPropertyCacheEntry, polyIndex));
 static_assert(sizeof(SHPrivateNameCacheEntry) == sizeof(PrivateNameCacheEntry));
 static_assert(
     offsetof(SHPrivateNameCacheEntry, clazz) ==
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_REGEXPCACHE_H
+#define HERMES_VM_REGEXPCACHE_H
+
+#include "hermes/ADT/SimpleLRU.h"
+#include "hermes/Regex/RegexSupport.h"
+
+#include "llvh/ADT/ArrayRef.h"
+#include "llvh/ADT/SmallVector.h"
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+/// Compiled regex bytecode that JSRegExps refer to instead of copying it. The
+/// pointer keeps whatever owns the bytes alive, such as a cache entry or the
+/// bytecode provider of the module containing a regex literal.
+struct SharedRegExpBytecode {
+  std::shared_ptr<const uint8_t> data{};
+  uint32_t size{0};
+
+  /// Take ownership of the bytecode in \p bytecode.
+  static SharedRegExpBytecode fromVector(std::vector<uint8_t> &&bytecode) {
+    auto owner = std::make_shared<std::vector<uint8_t>>(std::move(bytecode));
+    const uint8_t *data = owner->data();
+    uint32_t size = owner->size();
+    return {std::shared_ptr<const uint8_t>(std::move(owner), data), size};
+  }
+
+  llvh::ArrayRef<uint8_t> get() const {
+    return {data.get(), size};
+  }
+};
+
+/// A per-runtime cache of compiled regular expressions, keyed on the pattern
+/// and flags passed to the RegExp constructor. Regex literals already carry
+/// precompiled bytecode, but patterns built at runtime would otherwise be
+/// parsed and compiled again by every `new RegExp(pattern, flags)`.
+/// The cache holds at most a fixed number of entries, evicting the least
+/// recently used one when full.
+class RegExpCache {
+ public:
+  /// The result of compiling a pattern, everything needed to initialize a
+  /// JSRegExp without running the regex parser.
+  struct Entry {
+    /// The compiled regex bytecode, shared with the JSRegExps using it.
+    SharedRegExpBytecode bytecode;
+
+    /// The named capture groups in the order they were defined.
+    std::deque<llvh::SmallVector<char16_t, 5>> orderedGroupNames;
+
+    /// Map from group name to group number. The keys point into
+    /// orderedGroupNames.
+    regex::ParsedGroupNamesMapping groupNamesMapping;
+  };
+
+  /// Counters describing how effective the cache has been.
+  struct Stats {
+    /// Number of lookups that found a compiled regex.
+    uint64_t hits{0};
+    /// Number of lookups that did not find a compiled regex.
+    uint64_t misses{0};
+    /// Number of entries removed to make room for new ones.
+    uint64_t evictions{0};
+  };
+
+  /// Default maximum number of entries.
+  static constexpr size_t kDefaultCapacity = 64;
+
+  /// Patterns longer than this are not cached, so that a few huge patterns
+  /// cannot pin an unbounded amount of memory.
+  static constexpr size_t kMaxPatternLength = 1024;
+
+  explicit RegExpCache(size_t capacity = kDefaultCapacity)
+      : capacity_(capacity) {}
+
+  /// \return the entry for \p pattern compiled with the flags \p flagsByte
+  ///   (the byte form of regex::SyntaxFlags), marking it as most recently
+  ///   used, or nullptr if it isn't cached. The returned pointer is valid
+  ///   until the next call to insert().
+  const Entry *lookup(llvh::ArrayRef<char16_t> pattern, uint8_t flagsByte);
+
+  /// Add \p entry as the compiled form of \p pattern with flags \p flagsByte,
+  /// evicting the least recently used entry if the cache is full.
+  /// \return the stored entry, whose pointer is valid until the next call to
+  ///   insert(), or nullptr if the pattern is not cacheable, in which case
+  ///   \p entry is left untouched.
+  const Entry *
+  insert(llvh::ArrayRef<char16_t> pattern, uint8_t flagsByte, Entry &&entry);
+
+  /// \return the number of cached entries.
+  size_t size() const {
+    return map_.size();
+  }
+
+  /// \return the hit, miss and eviction counts so far.
+  const Stats &getStats() const {
+    return stats_;
+  }
+
+  /// \return the number of bytes of malloc memory used by the cache.
+  size_t getMemorySize() const {
+    return memorySize_;
+  }
+
+ private:
+  /// A cached entry along with its position in the recency list.
+  struct Slot {
+    Entry entry;
+    /// Points at the key of this slot in map_, stored in lru_.
+    const std::u16string **lruPos{nullptr};
+  };
+
+  /// \return the key for \p pattern with flags \p flagsByte. The flags are
+  /// stored in the first character, followed by the pattern.
+  static std::u16string makeKey(
+      llvh::ArrayRef<char16_t> pattern,
+      uint8_t flagsByte);
+
+  /// \return an estimate of the malloc memory used by \p key and \p entry.
+  static size_t memorySizeOf(const std::u16string &key, const Entry &entry);
+
+  /// Maximum number of entries.
+  size_t capacity_;
+
+  /// The cached entries. Nodes of an unordered_map are never moved, so the
+  /// keys may be referenced from lru_.
+  std::unordered_map<std::u16string, Slot> map_{};
+
+  /// The keys in map_, ordered by recency of use.
+  SimpleLRU<const std::u16string *> lru_{};
+
+  /// Estimated malloc memory used by the keys and entries.
+  size_t memorySize_{0};
+
+  Stats stats_{};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_REGEXPCACHE_H
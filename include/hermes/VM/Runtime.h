@@ -35,6 +35,7 @@
 #include "hermes/VM/Profiler/SamplingProfilerDefs.h"
 #include "hermes/VM/PropertyCache.h"
 #include "hermes/VM/PropertyDescriptor.h"
+#include "hermes/VM/RegExpCache.h"
 #include "hermes/VM/RegExpMatch.h"
 #include "hermes/VM/RuntimeModule.h"
 #include "hermes/VM/StackFrame.h"
@@ -667,6 +668,17 @@ class Runtime : public RuntimeBase, public HandleRootOwner {
   /// Returns trailing data for all runtime modules.
   std::vector<llvh::ArrayRef<uint8_t>> getEpilogues();
 
+  /// \return the polymorphic property cache shared by all property cache
+  /// entries.
+  PolymorphicPropertyCache &getPolyPropCache() {
+    return polyPropCache_;
+  }
+
+  /// \return the cache of regexes compiled by the RegExp constructor.
+  RegExpCache &getRegExpCache() {
+    return regExpCache_;
+  }
+
   /// \return the parent cache epoch.
   uint32_t getParentCacheEpoch() const {
     return parentCacheEpoch_;
@@ -757,6 +769,14 @@ class Runtime : public RuntimeBase, public HandleRootOwner {
     triggerAsyncBreak(AsyncBreakReasonBits::Timeout);
   }
 
+  /// \return whether a timeout async break was requested, and clear the
+  /// request. Native functions that block for a long time, and so don't reach
+  /// the interpreter loop, use this to stop when the runtime times out. Must
+  /// be called on the thread that runs JS.
+  bool takeTimeoutAsyncBreakRequest() {
+    return testAndClearTimeoutAsyncBreakRequest();
+  }
+
 #ifdef HERMES_ENABLE_DEBUGGER
   /// Encapsulates useful information about a stack frame, needed by the
   /// debugger. It requres extra context and cannot be extracted from a
@@ -1038,6 +1058,15 @@ class Runtime : public RuntimeBase, public HandleRootOwner {
     return hasMicrotaskQueue_;
   }
 
+  bool hasRegExpLinearTime() const {
+    return hasRegExpLinearTime_;
+  }
+
+  /// \return whether this agent may block in Atomics.wait.
+  bool agentCanSuspend() const {
+    return agentCanSuspend_;
+  }
+
   bool builtinsAreFrozen() const {
     return builtinsFrozen_;
   }
@@ -1283,6 +1312,12 @@ class Runtime : public RuntimeBase, public HandleRootOwner {
   /// Set to true if we are using microtasks.
   const bool hasMicrotaskQueue_;
 
+  /// Set to true if regexps should be searched in linear time when possible.
+  const bool hasRegExpLinearTime_;
+
+  /// Set to true if Atomics.wait may block the thread running this runtime.
+  const bool agentCanSuspend_;
+
   /// Set to true if we should randomize stack placement etc.
   const bool shouldRandomizeMemoryLayout_;
 
@@ -1388,6 +1423,13 @@ class Runtime : public RuntimeBase, public HandleRootOwner {
   WritePropertyCacheEntry fixedWritePropCache_[(size_t)PropCacheID::_COUNT];
   ReadPropertyCacheEntry fixedReadPropCache_[(size_t)PropCacheID::_COUNT];
 
+  /// Additional classes for property cache entries that have seen more than
+  /// one HiddenClass.
+  PolymorphicPropertyCache polyPropCache_{};
+
+  /// Compiled bytecode for patterns passed to the RegExp constructor.
+  RegExpCache regExpCache_{};
+
   /// StringPrimitive representation of the first 256 characters.
   /// These are allocated as "long-lived" objects, so they don't need
   /// to be scanned as roots in young-gen collections.
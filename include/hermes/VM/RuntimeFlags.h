@@ -141,6 +141,14 @@ struct VMOnlyRuntimeFlags {
       llvh::cl::init(vm::RuntimeConfig::getDefaultMicrotaskQueue()),
       llvh::cl::cat(RuntimeCategory)};
 
+  llvh::cl::opt<bool> RegExpLinearTime{
+      "Xregexp-linear-time",
+      llvh::cl::desc(
+          "Search regexps without backreferences or lookarounds in linear "
+          "time"),
+      llvh::cl::init(vm::RuntimeConfig::getDefaultRegExpLinearTime()),
+      llvh::cl::cat(RuntimeCategory)};
+
   llvh::cl::opt<bool> StopAfterInit{
       "stop-after-module-init",
       llvh::cl::desc(
@@ -201,6 +209,34 @@ struct VMOnlyRuntimeFlags {
       llvh::cl::cat(GCCategory),
       llvh::cl::init(false)};
 
+  llvh::cl::opt<unsigned> GCYoungGenEvacuationThreads{
+      "gc-yg-evacuation-threads",
+      llvh::cl::desc(
+          "Number of threads, including the mutator, used to evacuate the "
+          "young generation"),
+      llvh::cl::cat(GCCategory),
+      llvh::cl::init(1)};
+
+  llvh::cl::opt<unsigned> GCOldGenMarkingThreads{
+      "gc-og-marking-threads",
+      llvh::cl::desc("Number of threads used to mark the old generation"),
+      llvh::cl::cat(GCCategory),
+      llvh::cl::init(1)};
+
+  llvh::cl::opt<unsigned> GCOldGenSweepingThreads{
+      "gc-og-sweeping-threads",
+      llvh::cl::desc("Number of threads used to sweep the old generation"),
+      llvh::cl::cat(GCCategory),
+      llvh::cl::init(1)};
+
+  llvh::cl::opt<bool> GCSweepOnAllocation{
+      "gc-sweep-on-allocation",
+      llvh::cl::desc(
+          "Finish sweeping the old generation before growing it when an "
+          "allocation finds no free space"),
+      llvh::cl::cat(GCCategory),
+      llvh::cl::init(false)};
+
   enum class JITMode {
     // JIT is ON with default thresholds.
     On,
@@ -241,6 +277,39 @@ struct VMOnlyRuntimeFlags {
       llvh::cl::desc("maximum size for JIT code (in bytes)"),
       llvh::cl::init(32u << 20)};
 
+  llvh::cl::opt<bool> JITBackground{
+      "Xjit-background",
+      llvh::cl::Hidden,
+      llvh::cl::cat(RuntimeCategory),
+      llvh::cl::desc("compile JIT functions on a background thread"),
+      llvh::cl::init(false)};
+
+  llvh::cl::opt<uint32_t> JITQueueLimit{
+      "Xjit-queue-limit",
+      llvh::cl::Hidden,
+      llvh::cl::cat(RuntimeCategory),
+      llvh::cl::desc(
+          "maximum number of functions queued for background JIT compilation"),
+      llvh::cl::init(16)};
+
+  llvh::cl::opt<uint32_t> JITOSRThreshold{
+      "Xjit-osr-threshold",
+      llvh::cl::Hidden,
+      llvh::cl::cat(RuntimeCategory),
+      llvh::cl::desc(
+          "number of loop iterations after which a running interpreted call "
+          "continues in JIT code (0 to disable)"),
+      llvh::cl::init(1u << 10)};
+
+  llvh::cl::opt<uint32_t> JITRegExpThreshold{
+      "Xjit-regexp-threshold",
+      llvh::cl::Hidden,
+      llvh::cl::cat(RuntimeCategory),
+      llvh::cl::desc(
+          "number of interpreted searches of a regexp after which it is JIT "
+          "compiled (0 to disable)"),
+      llvh::cl::init(32)};
+
   /// To get the value of this CLI option, use the method below.
   llvh::cl::opt<unsigned> DumpJITCode{
       "Xdump-jitcode",
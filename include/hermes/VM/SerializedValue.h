@@ -11,6 +11,7 @@
 #include "hermes/VM/NativeState.h"
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/Runtime.h"
+#include "hermes/VM/StringPrimitive.h"
 
 namespace hermes {
 namespace vm {
@@ -36,9 +37,17 @@ class SerializedValue {
   std::vector<uint8_t> content;
 
   /// Contains all strings needed for deserialization. Each string is encoded
-  /// with the format (string serialization ID, isAscii, length, data)
+  /// with the format (string serialization ID, isAscii, isShared, length,
+  /// data)
   std::vector<uint8_t> strings;
 
+  /// Strings with at least StringPrimitive::EXTERNAL_STRING_THRESHOLD
+  /// characters are not copied into strings. Their data is an index into
+  /// one of these vectors instead, and the deserialized strings refer to the
+  /// same immutable buffers.
+  std::vector<ExternalASCIIStringPrimitive::SharedStdString> sharedASCIIStrings;
+  std::vector<ExternalUTF16StringPrimitive::SharedStdString> sharedUTF16Strings;
+
   /// For JS ArrayBuffers with internal data blocks, store the pointer to the
   /// underlying data block that needs to be transferred.
   std::vector<uint8_t *> internalBuffers;
@@ -48,6 +57,11 @@ class SerializedValue {
   /// block.
   std::vector<std::pair<uint8_t *, std::shared_ptr<void>>> externalBuffers;
 
+  /// For JS SharedArrayBuffers, store a pair containing the data block pointer
+  /// and the context keeping it alive. The data block is not copied: every
+  /// SharedArrayBuffer deserialized from this value uses the same block.
+  std::vector<std::pair<uint8_t *, std::shared_ptr<void>>> sharedBuffers;
+
   /// Describes the type of JS value for some serialized content. The special
   /// Reference type is used to point at a JS value serialized at some other
   /// location.
@@ -67,6 +81,7 @@ class SerializedValue {
     ArrayBuffer,
     ArrayBufferInternal,
     ArrayBufferExternal,
+    SharedArrayBuffer,
     DataView,
 #define TYPED_ARRAY(name, string) name##Array,
 #include "hermes/VM/TypedArrays.def"
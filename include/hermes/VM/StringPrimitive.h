@@ -18,6 +18,7 @@
 
 #include "llvh/Support/TrailingObjects.h"
 
+#include <memory>
 #include <type_traits>
 
 namespace hermes {
@@ -69,6 +70,8 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   friend class StringView;
   template <typename T>
   friend class BufferedStringPrimitive;
+  template <typename T>
+  friend class RopeStringPrimitive;
 
   friend llvh::raw_ostream &operator<<(
       llvh::raw_ostream &OS,
@@ -159,6 +162,10 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   static constexpr uint32_t CONCAT_STRING_MIN_SIZE =
       std::max(256u, EXTERNAL_STRING_MIN_SIZE);
 
+  /// The maximum depth of a RopeStringPrimitive. Concatenations that would
+  /// create a deeper rope copy the characters instead.
+  static constexpr uint32_t MAX_ROPE_DEPTH = 1024;
+
   static bool classof(const GCCell *cell) {
     return kindInRange(
         cell->getKind(),
@@ -268,6 +275,18 @@ class StringPrimitive : public VariableSizeRuntimeCell {
     return sliceEquals(0, getStringLength(), other);
   }
 
+  /// \return true if the other string is identical to this one, flattening
+  /// either string if it's a rope whose characters need to be compared.
+  bool equals(Runtime &runtime, StringPrimitive *other) {
+    if (this == other)
+      return true;
+    if (getStringLength() != other->getStringLength())
+      return false;
+    flattenIfRope(runtime, this);
+    flattenIfRope(runtime, other);
+    return sliceEquals(0, getStringLength(), other);
+  }
+
   /// \return true if the other string view has identical content as self.
   bool equals(const StringView &other) const;
 
@@ -275,6 +294,15 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   /// \return -1 if `this` is smaller, 0 if equal, +1 if `this` is greater.
   int compare(const StringPrimitive *other) const;
 
+  /// Lexicographically compare the two strings, flattening either string if
+  /// it's a rope.
+  /// \return -1 if `this` is smaller, 0 if equal, +1 if `this` is greater.
+  int compare(Runtime &runtime, StringPrimitive *other) {
+    flattenIfRope(runtime, this);
+    flattenIfRope(runtime, other);
+    return compare(other);
+  }
+
   /// \return the JenkinsHash hash of this string.
   /// If it's not cached already, compute it and cache it.
   uint32_t getOrComputeHash() {
@@ -311,23 +339,21 @@ class StringPrimitive : public VariableSizeRuntimeCell {
       size_t length);
 
   /// Flatten the string if it's a rope, possibly causing allocation/GC.
-  static Handle<StringPrimitive> ensureFlat(
+  static inline Handle<StringPrimitive> ensureFlat(
       Runtime &runtime,
-      Handle<StringPrimitive> self) {
-    // In the future, ensureFlat may trigger GC as it might allocate for
-    // ropes. Move the heap here.
-    runtime.potentiallyMoveHeap();
-    return self;
-    // TODO: Deal with different subclasses (e.g. rope)
-  }
+      Handle<StringPrimitive> self);
 
-  /// \return true if the string is flat.
-  bool isFlat() const {
-    return true;
-  }
+  /// Flatten \p str if it's a rope, like ensureFlat(), for callers that hold
+  /// a raw pointer. This never causes a GC, so it may be used where
+  /// allocation is not allowed.
+  static inline void flattenIfRope(Runtime &runtime, StringPrimitive *str);
 
-  /// \return a StringView of this string. In the case of a rope, we will need
-  /// to resolve the rope, which might involve object allocations.
+  /// \return true if the characters of the string can be accessed without
+  /// flattening it first.
+  inline bool isFlat() const;
+
+  /// \return a StringView of this string. In the case of a rope, this will
+  /// flatten it first.
   static StringView createStringView(
       Runtime &runtime,
       Handle<StringPrimitive> self);
@@ -402,6 +428,10 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   /// it is safe to call this function which guarantees to not trigger gc.
   static StringView createStringViewMustBeFlat(Handle<StringPrimitive> self);
 
+  /// Slow path of ensureFlat() and flattenIfRope(): flatten the rope \p str
+  /// and release its children.
+  static void flattenRope(Runtime &runtime, StringPrimitive *str);
+
  protected:
   /// \return whether the StringPrimitive can be converted from non-uniqued to
   /// uniqued without reallocating.
@@ -621,18 +651,40 @@ class ExternalStringPrimitive final : public SymbolStringPrimitive {
   static const VTable vt;
 
   size_t calcExternalMemorySize() const {
-    return contents_.capacity() * sizeof(T);
+    return (isShared_ ? shared_->capacity() : contents_.capacity()) *
+        sizeof(T);
   }
 
  public:
+  /// An immutable buffer that may back ExternalStringPrimitives in several
+  /// runtimes at once.
+  using SharedStdString = std::shared_ptr<const CopyableStdString>;
+
   /// Construct an ExternalStringPrimitive from the given string \p contents,
   /// non-uniqued.
   template <class BasicString>
   ExternalStringPrimitive(BasicString &&contents);
 
+  /// Construct an ExternalStringPrimitive referring to the buffer \p shared,
+  /// non-uniqued.
+  explicit ExternalStringPrimitive(SharedStdString &&shared);
+
+  /// Create an ExternalStringPrimitive referring to the buffer \p shared
+  /// without copying it. Throw \c RangeError if the string is longer than \c
+  /// MAX_STRING_LENGTH characters or the external memory is not available.
+  static CallResult<HermesValue> createShared(
+      Runtime &runtime,
+      SharedStdString shared);
+
+  /// \return the buffer of this string, so it can be referred to by other
+  /// ExternalStringPrimitives. If this string owns its buffer, the ownership
+  /// is transferred to the returned buffer first, which is not observable
+  /// since strings are immutable.
+  SharedStdString share();
+
  private:
-  /// Destructor deallocates the contents_ string.
-  ~ExternalStringPrimitive() = default;
+  /// Destructor deallocates the contents_ string or releases shared_.
+  ~ExternalStringPrimitive();
 
   /// Transfer ownership of an std::string into a new StringPrim. Throw \c
   /// RangeError if the string is longer than \c MAX_STRING_LENGTH characters.
@@ -654,6 +706,8 @@ class ExternalStringPrimitive final : public SymbolStringPrimitive {
   static CallResult<HermesValue> create(Runtime &runtime, uint32_t length);
 
   const T *getRawPointer() const {
+    if (isShared_)
+      return shared_->data();
     // C++11 defines this to be valid even if the string is empty.
     return &contents_[0];
   }
@@ -663,6 +717,7 @@ class ExternalStringPrimitive final : public SymbolStringPrimitive {
   /// normally be done, but for those rare cases, this method gives access to
   /// the writable buffer.
   T *getRawPointerForWrite() {
+    assert(!isShared_ && "shared strings are immutable");
     // C++11 defines this to be valid even if the string is empty.
     return &contents_[0];
   }
@@ -679,9 +734,17 @@ class ExternalStringPrimitive final : public SymbolStringPrimitive {
   static void _snapshotAddNodesImpl(GCCell *cell, GC &gc, HeapSnapshot &snap);
 #endif
 
-  /// The backing storage of this string. Note that the string's length is fixed
-  /// and must always be equal to StringPrimitive::getStringLength().
-  CopyableStdString contents_{};
+  union {
+    /// The backing storage of this string, unless isShared_. Note that the
+    /// string's length is fixed and must always be equal to
+    /// StringPrimitive::getStringLength().
+    CopyableStdString contents_;
+    /// The backing storage of this string if isShared_. Like the string, the
+    /// std::shared_ptr is safe to move with memcpy().
+    SharedStdString shared_;
+  };
+  /// Whether the characters are in shared_ rather than contents_.
+  bool isShared_ = false;
 };
 
 /// An immutable JavaScript primitive consisting of a pointer to an
@@ -830,6 +893,162 @@ inline bool isBufferedStringPrimitive(const GCCell *cell) {
       cell->getKind() == CellKind::BufferedASCIIStringPrimitiveKind;
 }
 
+/// An immutable JavaScript primitive string representing the concatenation of
+/// two other strings, which it refers to instead of copying. Ropes are created
+/// by concatenations that a BufferedStringPrimitive can't perform by appending
+/// to its buffer, such as prepending, or appending to a string that is not at
+/// the end of its concatenation buffer (e.g. with interleaved builders). This
+/// way, building a large string out of many fragments takes linear time
+/// regardless of the order of the concatenations.
+///
+/// The characters are materialized in a malloc'ed buffer the first time they
+/// are accessed. Flattening goes through StringPrimitive::ensureFlat() or
+/// StringPrimitive::flattenIfRope(), which also account for the buffer as
+/// external memory and release the children, since that requires the GC. The
+/// runtime paths that read characters, such as hashing, comparison and
+/// indexing, call one of them first.
+/// Since flattening doesn't allocate in the JS heap, the const character
+/// accessors of StringPrimitive still flatten a rope they are given, so that
+/// code without access to the runtime, such as strict equality called from
+/// native code, can use a rope like a flat string. The buffer is then only
+/// accounted for, and the children released, the next time the rope goes
+/// through ensureFlat() or flattenIfRope().
+///
+/// The depth of ropes is limited to MAX_ROPE_DEPTH, which bounds the work
+/// stack used for flattening. A concatenation that would exceed it copies both
+/// strings into a new concatenation buffer instead.
+template <typename T>
+class RopeStringPrimitive final : public StringPrimitive {
+  friend class StringPrimitive;
+  friend PseudoHandle<StringPrimitive> internalConcatStringPrimitives(
+      Runtime &runtime,
+      Handle<StringPrimitive> leftHnd,
+      Handle<StringPrimitive> rightHnd);
+  friend void RopeASCIIStringPrimitiveBuildMeta(
+      const GCCell *cell,
+      Metadata::Builder &mb);
+  friend void RopeUTF16StringPrimitiveBuildMeta(
+      const GCCell *cell,
+      Metadata::Builder &mb);
+
+ public:
+  /// \return the cell kind for this string.
+  static constexpr CellKind getCellKind() {
+    return std::is_same<T, char16_t>::value
+        ? CellKind::RopeUTF16StringPrimitiveKind
+        : CellKind::RopeASCIIStringPrimitiveKind;
+  }
+
+  static bool classof(const GCCell *cell) {
+    return cell->getKind() == RopeStringPrimitive::getCellKind();
+  }
+
+ private:
+  static const VTable vt;
+
+ public:
+  /// Construct a rope of depth \p depth representing the concatenation of
+  /// \p left and \p right.
+  RopeStringPrimitive(
+      Runtime &runtime,
+      Handle<StringPrimitive> left,
+      Handle<StringPrimitive> right,
+      uint32_t depth)
+      : StringPrimitive(left->getStringLength() + right->getStringLength()),
+        depth_(depth) {
+    leftHV_.set(left.getHermesValue(), runtime.getHeap());
+    rightHV_.set(right.getHermesValue(), runtime.getHeap());
+    assert(depth <= MAX_ROPE_DEPTH && "rope is too deep");
+  }
+
+  /// \return the depth of the rope, or 0 if it has been flattened.
+  uint32_t getDepth() const {
+    return flat_ ? 0 : depth_;
+  }
+
+  /// If the rope has not been flattened, store its children in \p left and
+  /// \p right.
+  /// \return whether the rope has children, i.e. has not been flattened.
+  bool getChildren(const StringPrimitive *&left, const StringPrimitive *&right)
+      const {
+    if (flat_)
+      return false;
+    left = vmcast<StringPrimitive>(leftHV_);
+    right = vmcast<StringPrimitive>(rightHV_);
+    return true;
+  }
+
+ private:
+  /// Allocate a rope representing the concatenation of \p leftHnd and
+  /// \p rightHnd.
+  /// \pre The types must be compatible (an ASCII rope can't contain UTF16) and
+  /// the combined length must have been validated.
+  static PseudoHandle<StringPrimitive> create(
+      Runtime &runtime,
+      Handle<StringPrimitive> leftHnd,
+      Handle<StringPrimitive> rightHnd,
+      uint32_t depth);
+
+  /// \return a const pointer to the first character of the string, flattening
+  /// the rope first if needed. The runtime normally flattens ropes before
+  /// reading their characters, see the class comment.
+  const T *getRawPointer() const {
+    if (LLVM_UNLIKELY(!flat_))
+      flatten();
+    return flat_;
+  }
+
+  /// Copy the characters of the rope into a new buffer and store it in flat_.
+  void flatten() const;
+
+  /// Flatten the rope if needed, credit the buffer to the GC, and release the
+  /// children so they can be collected.
+  void flattenAndReleaseChildren(Runtime &runtime);
+
+  /// \return the size of the buffer holding the flattened characters.
+  size_t calcExternalMemorySize() const {
+    return flat_ ? getStringLength() * sizeof(T) : 0;
+  }
+
+  /// Finalizer to free the flattened characters.
+  static void _finalizeImpl(GCCell *cell, GC &gc);
+
+  /// \return the size of the external memory associated with \p cell, which is
+  /// assumed to be a RopeStringPrimitive.
+  static size_t _mallocSizeImpl(GCCell *cell);
+
+#ifdef HERMES_MEMORY_INSTRUMENTATION
+  static std::string _snapshotNameImpl(GCCell *cell, GC &gc);
+  static void _snapshotAddEdgesImpl(GCCell *cell, GC &gc, HeapSnapshot &snap);
+  static void _snapshotAddNodesImpl(GCCell *cell, GC &gc, HeapSnapshot &snap);
+#endif
+
+  /// The strings this rope is the concatenation of, until it is flattened and
+  /// goes through ensureFlat(), after which they are empty. Like in
+  /// BufferedStringPrimitive, we are using GCHermesValue instead of GCPointer
+  /// to avoid requiring a PointerBase.
+  GCHermesValue leftHV_;
+  GCHermesValue rightHV_;
+
+  /// One more than the greatest depth of the children, where strings other
+  /// than unflattened ropes have depth 0.
+  uint32_t depth_;
+
+  /// Whether the flattened buffer has been credited to the GC as external
+  /// memory.
+  bool externalMemoryCredited_ = false;
+
+  /// The flattened characters, or null if the rope hasn't been flattened yet.
+  /// It is owned by the rope and freed by its finalizer.
+  mutable T *flat_ = nullptr;
+};
+
+/// \return true if this is one of the RopeStringPrimitive classes.
+inline bool isRopeStringPrimitive(const GCCell *cell) {
+  return cell->getKind() == CellKind::RopeUTF16StringPrimitiveKind ||
+      cell->getKind() == CellKind::RopeASCIIStringPrimitiveKind;
+}
+
 /// This function is not part of the API and is not supposed to be called
 /// directly. It is used internally by StringPrimitive::concat. It is used
 /// to handle the case when the result string exceeds the minimal length for
@@ -839,8 +1058,10 @@ inline bool isBufferedStringPrimitive(const GCCell *cell) {
 /// new one.
 /// Some cases where it needs to allocate a new buffer include:
 /// - the left string is not a BufferedStringPrimitive
-/// - appending UTF16 to ASCII
-/// - appending to the middle of the concatenation chain.
+/// - appending UTF16 to ASCII.
+/// When appending to the middle of the concatenation chain, or prepending a
+/// string to a longer one, it creates a RopeStringPrimitive instead, unless
+/// the rope would be too deep.
 /// \pre The combined length must have been validated by the caller.
 PseudoHandle<StringPrimitive> internalConcatStringPrimitives(
     Runtime &runtime,
@@ -919,6 +1140,28 @@ const VTable BufferedStringPrimitive<T>::vt = VTable(
 using BufferedUTF16StringPrimitive = BufferedStringPrimitive<char16_t>;
 using BufferedASCIIStringPrimitive = BufferedStringPrimitive<char>;
 
+template <typename T>
+const VTable RopeStringPrimitive<T>::vt = VTable(
+    RopeStringPrimitive<T>::getCellKind(),
+    0,
+    /* allowLargeAlloc */ false,
+    RopeStringPrimitive<T>::_finalizeImpl,
+    RopeStringPrimitive<T>::_mallocSizeImpl,
+    nullptr
+#ifdef HERMES_MEMORY_INSTRUMENTATION
+    ,
+    VTable::HeapSnapshotMetadata{
+        HeapSnapshot::NodeType::String,
+        RopeStringPrimitive<T>::_snapshotNameImpl,
+        RopeStringPrimitive<T>::_snapshotAddEdgesImpl,
+        RopeStringPrimitive<T>::_snapshotAddNodesImpl,
+        nullptr}
+#endif
+);
+
+using RopeUTF16StringPrimitive = RopeStringPrimitive<char16_t>;
+using RopeASCIIStringPrimitive = RopeStringPrimitive<char>;
+
 //===----------------------------------------------------------------------===//
 // StringPrimitive inline methods.
 
@@ -1074,6 +1317,8 @@ inline const char *StringPrimitive::castToASCIIPointer() const {
     return vmcast<DynamicUniquedASCIIStringPrimitive>(this)->getRawPointer();
   } else if (vmisa<DynamicASCIIStringPrimitive>(this)) {
     return vmcast<DynamicASCIIStringPrimitive>(this)->getRawPointer();
+  } else if (vmisa<RopeASCIIStringPrimitive>(this)) {
+    return vmcast<RopeASCIIStringPrimitive>(this)->getRawPointer();
   } else {
     return vmcast<BufferedASCIIStringPrimitive>(this)->getRawPointer();
   }
@@ -1086,6 +1331,8 @@ inline const char16_t *StringPrimitive::castToUTF16Pointer() const {
     return vmcast<DynamicUniquedUTF16StringPrimitive>(this)->getRawPointer();
   } else if (vmisa<DynamicUTF16StringPrimitive>(this)) {
     return vmcast<DynamicUTF16StringPrimitive>(this)->getRawPointer();
+  } else if (vmisa<RopeUTF16StringPrimitive>(this)) {
+    return vmcast<RopeUTF16StringPrimitive>(this)->getRawPointer();
   } else {
     return vmcast<BufferedUTF16StringPrimitive>(this)->getRawPointer();
   }
@@ -1113,6 +1360,31 @@ inline char16_t *StringPrimitive::castToUTF16PointerForWrite() {
   }
 }
 
+/*static*/ inline Handle<StringPrimitive> StringPrimitive::ensureFlat(
+    Runtime &runtime,
+    Handle<StringPrimitive> self) {
+  // Flattening a rope doesn't allocate in the JS heap, but callers must not
+  // rely on that. Move the heap here.
+  runtime.potentiallyMoveHeap();
+  flattenIfRope(runtime, self.get());
+  return self;
+}
+
+/*static*/ inline void StringPrimitive::flattenIfRope(
+    Runtime &runtime,
+    StringPrimitive *str) {
+  if (LLVM_UNLIKELY(isRopeStringPrimitive(str)))
+    flattenRope(runtime, str);
+}
+
+inline bool StringPrimitive::isFlat() const {
+  if (auto *rope = dyn_vmcast<RopeASCIIStringPrimitive>(this))
+    return rope->getDepth() == 0;
+  if (auto *rope = dyn_vmcast<RopeUTF16StringPrimitive>(this))
+    return rope->getDepth() == 0;
+  return true;
+}
+
 inline SymbolID StringPrimitive::getUniqueID(Runtime &runtime) const {
   assert(this->isUniqued() && "StringPrimitive is not uniqued");
   return vmcast<SymbolStringPrimitive>(this)->getUniqueID(runtime);
@@ -1141,6 +1413,8 @@ inline bool StringPrimitive::isASCII() const {
           CellKind::DynamicASCIIStringPrimitiveKind,
           CellKind::BufferedUTF16StringPrimitiveKind,
           CellKind::BufferedASCIIStringPrimitiveKind,
+          CellKind::RopeUTF16StringPrimitiveKind,
+          CellKind::RopeASCIIStringPrimitiveKind,
           CellKind::DynamicUniquedUTF16StringPrimitiveKind,
           CellKind::DynamicUniquedASCIIStringPrimitiveKind,
           CellKind::ExternalUTF16StringPrimitiveKind,
@@ -1160,6 +1434,8 @@ inline bool StringPrimitive::isExternal() const {
           CellKind::DynamicASCIIStringPrimitiveKind,
           CellKind::BufferedUTF16StringPrimitiveKind,
           CellKind::BufferedASCIIStringPrimitiveKind,
+          CellKind::RopeUTF16StringPrimitiveKind,
+          CellKind::RopeASCIIStringPrimitiveKind,
           CellKind::DynamicUniquedUTF16StringPrimitiveKind,
           CellKind::DynamicUniquedASCIIStringPrimitiveKind,
           CellKind::ExternalUTF16StringPrimitiveKind,
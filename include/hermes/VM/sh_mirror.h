@@ -29,6 +29,7 @@ typedef struct SHUnit SHUnit;
 typedef struct SHWritePropertyCacheEntry {
   SHCompressedPointerRawType clazz;
   uint32_t slotAndAddCacheIndex;
+  uint32_t polyIndex;
 } SHWritePropertyCacheEntry;
 
 typedef struct SHReadPropertyCacheEntry {
@@ -36,6 +37,7 @@ typedef struct SHReadPropertyCacheEntry {
   SHCompressedPointerRawType negMatchClazz;
   uint16_t _slot16;
   uint8_t numChanges;
+  uint32_t polyIndex;
 } SHReadPropertyCacheEntry;
 
 typedef struct SHPrivateNameCacheEntry {
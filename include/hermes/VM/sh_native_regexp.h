@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_SH_NATIVE_REGEXP_H
+#define HERMES_SH_NATIVE_REGEXP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Native matchers are generated by the SH backend from the regex bytecode of
+/// regexp literals. They implement the same backtracking algorithm as the
+/// regex interpreter, so they produce the same results, but instruction
+/// dispatch is replaced by straight-line C code.
+///
+/// A matcher searches \p input, which has \p length characters, for a match
+/// starting at or after \p start. The \p flags are the MatchFlagType bits from
+/// RegexTypes.h. On success, \p captures is populated with 2 * (marked_count
+/// + 1) offsets: the start and end of the whole match, followed by the start
+/// and end of each capture group, with SH_REGEXP_NOT_MATCHED for groups that
+/// did not participate.
+/// \return 1 on a match, 0 if there is no match, or -1 if the matcher ran out
+/// of backtracking budget. In that case captures[0] is the start position the
+/// matcher was trying, and the caller must continue the search from there with
+/// the interpreter: no match starts at an earlier position.
+typedef int32_t (*SHNativeRegExpSearch8)(
+    const uint8_t *input,
+    uint32_t start,
+    uint32_t length,
+    uint32_t flags,
+    uint32_t *captures);
+typedef int32_t (*SHNativeRegExpSearch16)(
+    const uint16_t *input,
+    uint32_t start,
+    uint32_t length,
+    uint32_t flags,
+    uint32_t *captures);
+
+/// Matchers for one regexp, for ASCII and UTF-16 inputs.
+typedef struct SHNativeRegExp {
+  /// Number of capture groups, not counting the whole match.
+  uint32_t marked_count;
+  SHNativeRegExpSearch8 search8;
+  SHNativeRegExpSearch16 search16;
+} SHNativeRegExp;
+
+/// Mirrors of regex::constants::MatchFlagType.
+#define SH_REGEXP_NOT_END_OF_LINE (1u << 1)
+#define SH_REGEXP_INPUT_ALL_ASCII (1u << 2)
+#define SH_REGEXP_ONLY_AT_START (1u << 3)
+
+/// Mirror of regex::kNotMatched.
+#define SH_REGEXP_NOT_MATCHED UINT32_MAX
+
+/// Character classes, matching the regex traits.
+#define SH_REGEXP_IS_DIGIT(c) ((c) - (uint32_t)'0' <= 9u)
+#define SH_REGEXP_IS_WORD(c)                                   \
+  (SH_REGEXP_IS_DIGIT(c) || ((c) | 0x20u) - (uint32_t)'a' < 26u || \
+   (c) == (uint32_t)'_')
+#define SH_REGEXP_IS_LINE_TERMINATOR(c) \
+  ((c) == 0x0Au || (c) == 0x0Du || (c) == 0x2028u || (c) == 0x2029u)
+#define SH_REGEXP_IS_SPACE8(c) \
+  ((c) == 0x20u || ((c) >= 0x09u && (c) <= 0x0Du))
+#define SH_REGEXP_IS_SPACE16(c)                                      \
+  (SH_REGEXP_IS_SPACE8(c) || (c) == 0xA0u || (c) == 0x1680u ||       \
+   ((c) >= 0x2000u && (c) <= 0x200Au) || (c) == 0x2028u ||           \
+   (c) == 0x2029u || (c) == 0x202Fu || (c) == 0x205Fu || (c) == 0x3000u || \
+   (c) == 0xFEFFu)
+
+/// Kinds of backtracking entries, mirroring the interpreter's BacktrackOp.
+enum {
+  /// Restore a capture group: a = capture index, b = start, c = end.
+  SH_REGEXP_BT_SET_CAPTURE,
+  /// Restore a loop's state: a = loop index, b = iterations, c = entry pos.
+  SH_REGEXP_BT_SET_LOOP,
+  /// Resume at target a with position b.
+  SH_REGEXP_BT_SET_POSITION,
+  /// Resume a width 1 loop exit at target a, trying positions b..c.
+  SH_REGEXP_BT_GREEDY_WIDTH1,
+  SH_REGEXP_BT_NONGREEDY_WIDTH1,
+  /// Enter the body of the non-greedy loop at target a, restoring its
+  /// iterations to b and its entry position to c.
+  SH_REGEXP_BT_ENTER_LOOP,
+};
+
+typedef struct SHRegExpBacktrack {
+  uint32_t kind;
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+} SHRegExpBacktrack;
+
+/// Number of backtracking entries held on the C stack before allocating.
+#define SH_REGEXP_INLINE_BACKTRACKS 32
+
+/// Maximum depth of the backtracking stack, matching the regex interpreter.
+#define SH_REGEXP_MAX_BACKTRACK_DEPTH (1u << 24)
+/// Number of pushes after which a matcher gives up. It is much lower than the
+/// interpreter's limit, so that a pathological search doesn't spend long in
+/// the matcher before the interpreter takes over.
+#define SH_REGEXP_BACKTRACK_LIMIT (1u << 24)
+
+typedef struct SHRegExpStack {
+  SHRegExpBacktrack *entries;
+  uint32_t size;
+  uint32_t capacity;
+  /// Number of pushes allowed before giving up.
+  uint32_t pushes_left;
+  SHRegExpBacktrack inline_entries[SH_REGEXP_INLINE_BACKTRACKS];
+} SHRegExpStack;
+
+static inline void _sh_regexp_stack_init(SHRegExpStack *st) {
+  st->entries = st->inline_entries;
+  st->size = 0;
+  st->capacity = SH_REGEXP_INLINE_BACKTRACKS;
+  st->pushes_left = SH_REGEXP_BACKTRACK_LIMIT;
+}
+
+static inline void _sh_regexp_stack_free(SHRegExpStack *st) {
+  if (st->entries != st->inline_entries)
+    free(st->entries);
+}
+
+/// Double the capacity of \p st. \return false if it would exceed the maximum
+/// depth or the allocation failed.
+static inline bool _sh_regexp_stack_grow(SHRegExpStack *st) {
+  if (st->capacity >= SH_REGEXP_MAX_BACKTRACK_DEPTH)
+    return false;
+  uint32_t capacity = st->capacity * 2;
+  SHRegExpBacktrack *entries;
+  if (st->entries == st->inline_entries) {
+    entries = (SHRegExpBacktrack *)malloc(capacity * sizeof(*entries));
+    if (entries)
+      memcpy(entries, st->inline_entries, st->size * sizeof(*entries));
+  } else {
+    entries = (SHRegExpBacktrack *)realloc(
+        st->entries, capacity * sizeof(*entries));
+  }
+  if (!entries)
+    return false;
+  st->entries = entries;
+  st->capacity = capacity;
+  return true;
+}
+
+/// Push a backtracking entry. \return false if the backtracking budget is
+/// exhausted.
+static inline bool _sh_regexp_push(
+    SHRegExpStack *st,
+    uint32_t kind,
+    uint32_t a,
+    uint32_t b,
+    uint32_t c) {
+  if (st->pushes_left == 0 ||
+      (st->size == st->capacity && !_sh_regexp_stack_grow(st)))
+    return false;
+  --st->pushes_left;
+  SHRegExpBacktrack *bt = &st->entries[st->size++];
+  bt->kind = kind;
+  bt->a = a;
+  bt->b = b;
+  bt->c = c;
+  return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HERMES_SH_NATIVE_REGEXP_H
@@ -11,6 +11,7 @@
 #include "hermes/Support/sh_tryfast_fp_cvt.h"
 #include "hermes/VM/sh_legacy_value.h"
 #include "hermes/VM/sh_mirror.h"
+#include "hermes/VM/sh_native_regexp.h"
 #include "hermes/VM/sh_runtime.h"
 #include "hermes/VM/sh_small_hermes_value.h"
 #include "hermes/VM/sh_stack_frame.h"
@@ -757,6 +758,9 @@ static inline SHLegacyValue _sh_ljs_get_by_id_rjs_inline(
     SHSymbolID symID,
     SHReadPropertyCacheEntry *propCacheEntry) {
   assert(propCacheEntry && "propCacheEntry must not be null");
+#ifndef HERMESVM_PROPERTY_CACHE_STATS
+  // With property cache statistics, every access goes through the
+  // out-of-line implementation so that monomorphic hits are counted.
   if (SH_LIKELY(_sh_ljs_is_object(*source))) {
     // Fast path: check cache hit
     SHJSObject *sourceCell = (SHJSObject *)_sh_ljs_get_pointer(*source);
@@ -774,6 +778,7 @@ static inline SHLegacyValue _sh_ljs_get_by_id_rjs_inline(
       return _sh_prload_inline(shr, *source, slot);
     }
   }
+#endif
 
   // Cache miss - fall back to out-of-line implementation
   return _sh_ljs_get_by_id_rjs(shr, source, symID, propCacheEntry);
@@ -878,6 +883,15 @@ _sh_ljs_get_string(SHRuntime *shr, SHSymbolID symID);
 SHERMES_EXPORT SHLegacyValue
 _sh_ljs_create_regexp(SHRuntime *shr, SHSymbolID pattern, SHSymbolID flags);
 
+/// Like _sh_ljs_create_regexp, but the regexp searches with the matchers in
+/// \p native, which were generated by the compiler from the same pattern and
+/// flags.
+SHERMES_EXPORT SHLegacyValue _sh_ljs_create_native_regexp(
+    SHRuntime *shr,
+    SHSymbolID pattern,
+    SHSymbolID flags,
+    const SHNativeRegExp *native);
+
 /// \param value the string of the BigInt.
 /// \param size  the size of the string \c value.
 SHERMES_EXPORT SHLegacyValue
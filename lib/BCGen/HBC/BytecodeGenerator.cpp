@@ -18,6 +18,7 @@
 #include "hermes/BCGen/Lowering.h"
 #include "hermes/FrontEndDefs/Builtins.h"
 #include "hermes/IR/Analysis.h"
+#include "hermes/Support/ParallelFor.h"
 
 #include <variant>
 
@@ -37,6 +38,12 @@ const unsigned kFastRegisterAllocationThreshold = 250;
 // time memory usage.
 const uint64_t kRegisterAllocationMemoryLimit = 10L * 1024 * 1024;
 
+// When the backend runs on several threads, functions are register allocated
+// in batches of this many functions per thread, and each batch is emitted
+// before the next one is allocated. This bounds the number of live register
+// allocators.
+const unsigned kParallelFunctionsPerThread = 16;
+
 /// Used in delta optimizing mode.
 /// \return a UniquingStringLiteralAccumulator seeded with strings  from a
 /// bytecode provider \p bcProvider.
@@ -632,6 +639,41 @@ static void fixupEnvironmentIDs(Function *F) {
 #endif
 }
 
+/// Run register allocation and the post-allocation lowering passes on \p F.
+/// This only reads and modifies the IR of \p F, so it may run on different
+/// functions concurrently.
+static std::unique_ptr<HVMRegisterAllocator> allocateFunction(
+    Function *F,
+    const BytecodeGenerationOptions &options) {
+  // Under full debug info, ensure the environment IDs are all valid. Without
+  // debug info, there are not environment IDs set at all.
+  if (F->getContext().getDebugInfoSetting() == DebugInfoSetting::ALL) {
+    fixupEnvironmentIDs(F);
+  }
+
+  // Run register allocation.
+  auto RA = std::make_unique<HVMRegisterAllocator>(F);
+  if (!options.optimizationEnabled) {
+    RA->setFastPassThreshold(kFastRegisterAllocationThreshold);
+    RA->setMemoryLimit(kRegisterAllocationMemoryLimit);
+  }
+  auto PO = postOrderAnalysis(F);
+  /// The order of the blocks is reverse-post-order, which is a simply
+  /// topological sort.
+  llvh::SmallVector<BasicBlock *, 16> order(PO.rbegin(), PO.rend());
+  RA->allocate(order);
+
+  if (options.format == DumpRA)
+    RA->dump();
+
+  lowerAllocatedFunctionIR(F, *RA, options);
+
+  if (options.format == DumpLRA)
+    RA->dump();
+
+  return RA;
+}
+
 bool BytecodeModuleGenerator::generateAddedFunctions() {
   BytecodeOptions &bytecodeOptions = bm_.getBytecodeOptionsMut();
   bytecodeOptions.setCjsModulesStaticallyResolved(M_->getCJSModulesResolved());
@@ -640,80 +682,84 @@ bool BytecodeModuleGenerator::generateAddedFunctions() {
 
   const uint32_t strippedFunctionNameId =
       options_.stripFunctionNames ? bm_.getStringID(kStrippedFunctionName) : 0;
-  for (auto [F, functionID] : functionIDMap_) {
-    auto *cjsModule = M_->findCJSModule(F);
-    if (cjsModule) {
-      if (M_->getCJSModulesResolved()) {
-        addCJSModuleStatic(cjsModule->id, functionID);
-      } else {
-        addCJSModule(functionID, getStringID(cjsModule->filename.str()));
-      }
-    }
 
-    // Add entries to function source table for non-default source.
-    if (!F->isGlobalScope()) {
-      if (auto source = F->getSourceRepresentationStr()) {
-        auto it = unicodeFunctionSources_.find(*source);
-        // If the original source was mapped to a re-encoded one in
-        // unicodeFunctionSources, then use the re-encoded source to lookup the
-        // string ID. Otherwise it's ASCII and can be used directly.
-        if (it != unicodeFunctionSources_.end()) {
-          addFunctionSource(
-              functionID,
-              getStringID(
-                  llvh::StringRef{it->second.begin(), it->second.size()}));
+  // Register allocation and the lowering after it only touch the function
+  // being compiled, so they can run on several threads. Everything else
+  // reads or writes module-wide tables (strings, literal buffers, debug info)
+  // and runs on this thread in function ID order, so the output does not
+  // depend on the number of threads. Dumps made while allocating must not
+  // interleave, so they force a single thread.
+  unsigned numThreads = resolveThreadCount(options_.codegenThreads);
+  if (options_.format == DumpRA || options_.format == DumpLRA ||
+      M_->getContext().getCodeGenerationSettings().dumpIRBetweenPasses) {
+    numThreads = 1;
+  }
+  const size_t batchSize =
+      numThreads == 1 ? 1 : numThreads * kParallelFunctionsPerThread;
+
+  auto functions = functionIDMap_.begin();
+  const size_t numFunctions = functionIDMap_.size();
+  std::vector<std::unique_ptr<HVMRegisterAllocator>> allocators{};
+  for (size_t batchStart = 0; batchStart < numFunctions;
+       batchStart += batchSize) {
+    const size_t batchEnd = std::min(numFunctions, batchStart + batchSize);
+    allocators.clear();
+    allocators.resize(batchEnd - batchStart);
+    parallelFor(numThreads, allocators.size(), [&](size_t i) {
+      allocators[i] =
+          allocateFunction(functions[batchStart + i].first, options_);
+    });
+
+    for (size_t i = batchStart; i < batchEnd; ++i) {
+      auto [F, functionID] = functions[i];
+      auto *cjsModule = M_->findCJSModule(F);
+      if (cjsModule) {
+        if (M_->getCJSModulesResolved()) {
+          addCJSModuleStatic(cjsModule->id, functionID);
         } else {
-          addFunctionSource(functionID, getStringID(*source));
+          addCJSModule(functionID, getStringID(cjsModule->filename.str()));
         }
       }
-    }
 
-    // Under full debug info, ensure the environment IDs are all valid. Without
-    // debug info, there are not environment IDs set at all.
-    if (M_->getContext().getDebugInfoSetting() == DebugInfoSetting::ALL) {
-      fixupEnvironmentIDs(F);
-    }
+      // Add entries to function source table for non-default source.
+      if (!F->isGlobalScope()) {
+        if (auto source = F->getSourceRepresentationStr()) {
+          auto it = unicodeFunctionSources_.find(*source);
+          // If the original source was mapped to a re-encoded one in
+          // unicodeFunctionSources, then use the re-encoded source to lookup
+          // the string ID. Otherwise it's ASCII and can be used directly.
+          if (it != unicodeFunctionSources_.end()) {
+            addFunctionSource(
+                functionID,
+                getStringID(
+                    llvh::StringRef{it->second.begin(), it->second.size()}));
+          } else {
+            addFunctionSource(functionID, getStringID(*source));
+          }
+        }
+      }
 
-    // Run register allocation.
-    HVMRegisterAllocator RA(F);
-    if (!options_.optimizationEnabled) {
-      RA.setFastPassThreshold(kFastRegisterAllocationThreshold);
-      RA.setMemoryLimit(kRegisterAllocationMemoryLimit);
-    }
-    auto PO = postOrderAnalysis(F);
-    /// The order of the blocks is reverse-post-order, which is a simply
-    /// topological sort.
-    llvh::SmallVector<BasicBlock *, 16> order(PO.rbegin(), PO.rend());
-    RA.allocate(order);
-
-    if (options_.format == DumpRA)
-      RA.dump();
-
-    lowerAllocatedFunctionIR(F, RA, options_);
-
-    if (options_.format == DumpLRA)
-      RA.dump();
-
-    uint32_t functionNameId = options_.stripFunctionNames
-        ? strippedFunctionNameId
-        : bm_.getStringID(F->getOriginalOrInferredName().str());
-
-    // Use the register allocated IR to make a BytecodeFunctionGenerator and
-    // run ISel.
-    std::unique_ptr<BytecodeFunction> func =
-        BytecodeFunctionGenerator::generateBytecodeFunction(
-            F,
-            functionID,
-            functionNameId,
-            *this,
-            RA,
-            options_,
-            debugIdCache_,
-            debugInfoGenerator_);
-    if (!func)
-      return false;
+      uint32_t functionNameId = options_.stripFunctionNames
+          ? strippedFunctionNameId
+          : bm_.getStringID(F->getOriginalOrInferredName().str());
 
-    bm_.setFunction(functionID, std::move(func));
+      // Use the register allocated IR to make a BytecodeFunctionGenerator and
+      // run ISel.
+      std::unique_ptr<BytecodeFunction> func =
+          BytecodeFunctionGenerator::generateBytecodeFunction(
+              F,
+              functionID,
+              functionNameId,
+              *this,
+              *allocators[i - batchStart],
+              options_,
+              debugIdCache_,
+              debugInfoGenerator_);
+      if (!func)
+        return false;
+
+      bm_.setFunction(functionID, std::move(func));
+    }
   }
 
   std::move(debugInfoGenerator_).generate();
@@ -10,6 +10,7 @@
 #include "LineDirectiveEmitter.h"
 #include "LoweringPasses.h"
 #include "SHRegAlloc.h"
+#include "SHRegExpGen.h"
 #include "hermes/AST/NativeContext.h"
 #include "hermes/BCGen/FunctionInfo.h"
 #include "hermes/BCGen/HBC/Passes.h"
@@ -25,9 +26,12 @@
 #include "hermes/IR/IR.h"
 #include "hermes/IR/IRVerifier.h"
 #include "hermes/IR/Instrs.h"
+#include "hermes/Regex/RegexBytecode.h"
+#include "hermes/Regex/RegexSerialization.h"
 #include "hermes/Support/BigIntSupport.h"
 #include "hermes/Support/DenseMapInfoSpecializations.h"
 #include "hermes/Support/HashString.h"
+#include "hermes/Support/ParallelFor.h"
 #include "hermes/Support/UTF8.h"
 #include "hermes/VMLayouts/StackFrameLayout.h"
 #include "llvh/ADT/MapVector.h"
@@ -358,10 +362,15 @@ class SHNativeJSFunctionTable {
   llvh::DenseMap<Function *, unsigned> funcMap_{};
   /// A reference to the global string table. Used for function names.
   SHStringTable &stringTable_;
+  /// Prepended to every function label.
+  std::string labelPrefix_;
 
  public:
-  explicit SHNativeJSFunctionTable(Module *M, SHStringTable &stringTable)
-      : stringTable_(stringTable) {
+  explicit SHNativeJSFunctionTable(
+      Module *M,
+      SHStringTable &stringTable,
+      std::string labelPrefix)
+      : stringTable_(stringTable), labelPrefix_(std::move(labelPrefix)) {
     // Ensure that the top level function has an id of 0.
     auto topLevelFunc = M->getTopLevelFunction();
     funcMap_[topLevelFunc] = 0;
@@ -389,7 +398,7 @@ class SHNativeJSFunctionTable {
   /// the JS function name contains characters that aren't allowed in C
   /// identifiers, they will be replaced by '_'.
   void generateFunctionLabel(Function *F, llvh::raw_ostream &OS) const {
-    OS << '_' << getIndex(F) << '_';
+    OS << labelPrefix_ << '_' << getIndex(F) << '_';
 
     auto name = F->getInternalNameStr();
     for (auto c : name) {
@@ -404,14 +413,14 @@ class SHNativeJSFunctionTable {
   }
 
   /// Turn the table of function information into the corresponding SH C data
-  /// structures.
-  void generate(llvh::raw_ostream &OS) const {
+  /// structures, defined with storage class \p linkage.
+  void generate(llvh::raw_ostream &OS, llvh::StringRef linkage) const {
     // Sort the keys by function index.
     std::vector<const Function *> sortedKeys{funcMap_.size()};
     for (auto &entry : funcMap_)
       sortedKeys[entry.second] = entry.first;
 
-    OS << "\nstatic SHNativeFuncInfo s_function_info_table[] = {\n";
+    OS << "\n" << linkage << "SHNativeFuncInfo s_function_info_table[] = {\n";
     for (const Function *F : sortedKeys) {
       uint32_t nameIdx = stringTable_.add(F->getOriginalOrInferredName().str());
       uint32_t argCount = F->getExpectedParamCountIncludingThis() - 1;
@@ -426,6 +435,59 @@ class SHNativeJSFunctionTable {
   }
 };
 
+/// Native matchers generated for regexp literals, so that searching them does
+/// not need to interpret the regex bytecode.
+class SHNativeRegExpTable {
+ public:
+  /// \return the index of the matchers for the regexp literal with \p pattern
+  /// and \p flags, generating them if needed, or None if the regexp is not
+  /// supported by the generator.
+  llvh::Optional<uint32_t> add(llvh::StringRef pattern, llvh::StringRef flags) {
+    // Flags never contain '/', so this is unambiguous.
+    auto [it, inserted] =
+        indices_.try_emplace((flags + "/" + pattern).str(), kUnsupported);
+    if (inserted) {
+      auto regexp = CompiledRegExp::tryCompile(pattern, flags);
+      if (regexp && sh::canGenerateRegExpMatcher(regexp->getBytecode())) {
+        it->second = regexps_.size();
+        regexps_.push_back(std::move(*regexp));
+      }
+    }
+    if (it->second == kUnsupported)
+      return llvh::None;
+    return it->second;
+  }
+
+  /// Generate the matchers, and the table s_native_regexps referencing them,
+  /// defined with storage class \p linkage.
+  void generate(llvh::raw_ostream &OS, llvh::StringRef linkage) const {
+    for (size_t i = 0, e = regexps_.size(); i < e; ++i) {
+      sh::generateRegExpMatcher(
+          regexps_[i].getBytecode(), "regexp_" + std::to_string(i), OS);
+    }
+    OS << "\n" << linkage << "const SHNativeRegExp s_native_regexps[] = {\n";
+    for (size_t i = 0, e = regexps_.size(); i < e; ++i) {
+      auto *header = reinterpret_cast<const regex::RegexBytecodeHeader *>(
+          regexps_[i].getBytecode().data());
+      OS << "  { .marked_count = " << header->markedCount
+         << ", .search8 = regexp_" << i << "_search8, .search16 = regexp_" << i
+         << "_search16 },\n";
+    }
+    // The table is declared before its size is known, so it must not be
+    // empty.
+    OS << "  { 0 },\n};\n";
+  }
+
+ private:
+  static constexpr uint32_t kUnsupported = UINT32_MAX;
+
+  /// Map from flags and pattern to the index in regexps_, or kUnsupported.
+  llvh::StringMap<uint32_t> indices_{};
+
+  /// The regexps for which matchers are generated.
+  std::vector<CompiledRegExp> regexps_{};
+};
+
 struct ModuleGen {
   /// Table containing uniqued strings for the current module.
   SHStringTable stringTable{};
@@ -440,10 +502,27 @@ struct ModuleGen {
   /// Table of JS native functions
   SHNativeJSFunctionTable nativeFunctionTable;
 
-  explicit ModuleGen(Module *M, bool optimizationEnabled)
+  /// Native matchers for regexp literals.
+  SHNativeRegExpTable nativeRegExpTable;
+
+  /// If the C is split into shards, the prefix of the names that the shards
+  /// share, which keeps them unique across units. Empty otherwise.
+  const std::string sharedPrefix;
+
+  explicit ModuleGen(
+      Module *M,
+      bool optimizationEnabled,
+      std::string sharedPrefix)
       : literalBuffers{M, stringTable, optimizationEnabled},
         srcLocationTable{stringTable},
-        nativeFunctionTable{M, stringTable} {}
+        nativeFunctionTable{M, stringTable, sharedPrefix},
+        sharedPrefix(std::move(sharedPrefix)) {}
+
+  /// \return the storage class of the functions and tables that the shards
+  /// share.
+  llvh::StringRef sharedLinkage() const {
+    return sharedPrefix.empty() ? "static " : "SH_SHARED ";
+  }
 };
 
 /// \return true if the SHLegacyValue representations of values \p a and \p b
@@ -1797,25 +1876,23 @@ class InstrGen {
     uint32_t flagsStrID =
         moduleGen_.stringTable.add(inst.getFlags()->getValue().str());
 
-    // Compile the regexp. We expect this to succeed because the AST went
-    // through the SemanticValidator. This is a bit of a hack: what we would
-    // really like to do is have the Parser emit a CompiledRegExp that can be
-    // threaded through the AST and then through the IR to this instruction
-    // selection, but that is too awkward, so we compile again here.
-    // uint32_t reBytecodeID = UINT32_MAX;
-    // if (auto regexp = CompiledRegExp::tryCompile(
-    //         inst.getPattern()->getValue().str(),
-    //         inst.getFlags()->getValue().str())) {
-    //   reBytecodeID = moduleGen_.regexpTable.addRegExp(std::move(*regexp));
-    // }
-
+    // Compile the regexp again to generate a native matcher for it. This is
+    // expected to succeed because the AST went through the SemanticValidator.
+    // The RegExp object still compiles the pattern at runtime, since its
+    // bytecode is needed for the group names and to fall back to the
+    // interpreter.
     // TODO(T132343328): Compile the regexp bytecode ahead of time.
+    auto nativeIdx = moduleGen_.nativeRegExpTable.add(
+        inst.getPattern()->getValue().str(), inst.getFlags()->getValue().str());
     generateValue(inst);
     os_ << " = ";
-    os_ << "_sh_ljs_create_regexp(shr, ";
+    os_ << (nativeIdx ? "_sh_ljs_create_native_regexp(shr, "
+                      : "_sh_ljs_create_regexp(shr, ");
     os_ << llvh::format("get_symbols(shUnit)[%u]", patternStrID);
     os_ << ", ";
     os_ << llvh::format("get_symbols(shUnit)[%u]", flagsStrID);
+    if (nativeIdx)
+      os_ << ", &s_native_regexps[" << *nativeIdx << "]";
     os_ << ");\n";
   }
   void generateTryEndInst(TryEndInst &inst) {
@@ -2702,33 +2779,62 @@ void lowerAllocatedFunctionIR(
   PM.run(F);
 }
 
-/// Converts Function \p F into valid C code and outputs it through \p OS.
-void generateFunction(
+/// When the backend runs on several threads, functions are register allocated
+/// in batches of this many functions per thread, and each batch is converted
+/// to C before the next one is allocated. This bounds the number of live
+/// register allocators.
+constexpr unsigned kParallelFunctionsPerThread = 16;
+
+/// A register allocated function, ready to be converted to C.
+struct AllocatedFunction {
+  /// The basic blocks of the function, in reverse post-order.
+  llvh::SmallVector<BasicBlock *, 16> order;
+  /// The register allocation of the function.
+  std::unique_ptr<sh::SHRegisterAllocator> RA;
+};
+
+/// Register allocate Function \p F and lower it for C generation. This only
+/// reads and modifies the IR of \p F, so it may run on different functions
+/// concurrently.
+AllocatedFunction allocateFunction(
     Function &F,
-    hermes::sh::LineDirectiveEmitter &OS,
-    ModuleGen &moduleGen,
-    uint32_t &nextWriteCacheIdx,
-    uint32_t &nextReadCacheIdx,
-    uint32_t &nextPrivateNameCacheIdx,
-    BytecodeGenerationOptions options) {
+    const BytecodeGenerationOptions &options) {
   auto PO = hermes::postOrderAnalysis(&F);
 
-  llvh::SmallVector<BasicBlock *, 16> order(PO.rbegin(), PO.rend());
-
-  sh::SHRegisterAllocator RA(&F);
-  RA.allocate(order);
+  AllocatedFunction allocated{
+      llvh::SmallVector<BasicBlock *, 16>(PO.rbegin(), PO.rend()),
+      std::make_unique<sh::SHRegisterAllocator>(&F)};
+  auto &RA = *allocated.RA;
+  RA.allocate(allocated.order);
 
   if (options.format == DumpRA) {
-    RA.dump(order);
-    return;
+    RA.dump(allocated.order);
+    return allocated;
   }
 
   lowerAllocatedFunctionIR(&F, RA, options.optimizationEnabled);
 
-  if (options.format == DumpLRA) {
-    RA.dump(order);
+  if (options.format == DumpLRA)
+    RA.dump(allocated.order);
+  return allocated;
+}
+
+/// Converts Function \p F, which has been allocated into \p allocated, into
+/// valid C code and outputs it through \p OS.
+void generateFunction(
+    Function &F,
+    AllocatedFunction &allocated,
+    hermes::sh::LineDirectiveEmitter &OS,
+    ModuleGen &moduleGen,
+    uint32_t &nextWriteCacheIdx,
+    uint32_t &nextReadCacheIdx,
+    uint32_t &nextPrivateNameCacheIdx,
+    BytecodeGenerationOptions options) {
+  if (options.format == DumpRA || options.format == DumpLRA)
     return;
-  }
+
+  llvh::ArrayRef<BasicBlock *> order = allocated.order;
+  sh::SHRegisterAllocator &RA = *allocated.RA;
 
   assert(
       (options.format == DumpBytecode || options.format == EmitBundle) &&
@@ -2784,7 +2890,7 @@ void generateFunction(
   // Number of registers stored in the `locals` struct below.
   uint32_t localsSize = RA.getMaxRegisterUsage(sh::RegClass::LocalPtr);
 
-  OS << "static SHLegacyValue ";
+  OS << moduleGen.sharedLinkage() << "SHLegacyValue ";
   moduleGen.nativeFunctionTable.generateFunctionLabel(&F, OS);
   OS << "(SHRuntime *shr) {\n";
 
@@ -3055,6 +3161,42 @@ void generateExternC(
     OS << '\n';
 }
 
+/// \return the preprocessor condition selecting shard \p shard of the C.
+/// Without SHERMES_SHARD, every shard is selected.
+std::string shardCondition(unsigned shard) {
+  return "!defined(SHERMES_SHARD) || SHERMES_SHARD == " +
+      std::to_string(shard);
+}
+
+/// \return the shard of the C that each function of \p functions goes into,
+/// when it is split into \p numShards shards. Each shard gets a contiguous run
+/// of functions, so that calls between neighbouring functions stay within a
+/// translation unit, and the runs have about the same number of
+/// instructions.
+std::vector<unsigned> assignShards(
+    llvh::ArrayRef<Function *> functions,
+    unsigned numShards) {
+  std::vector<uint64_t> sizes{};
+  uint64_t total = 0;
+  for (Function *F : functions) {
+    uint64_t size = 0;
+    for (BasicBlock &BB : *F)
+      size += BB.size();
+    sizes.push_back(size);
+    total += size;
+  }
+
+  std::vector<unsigned> shards{};
+  uint64_t before = 0;
+  for (uint64_t size : sizes) {
+    shards.push_back(
+        total ? std::min<uint64_t>(numShards - 1, before * numShards / total)
+              : 0);
+    before += size;
+  }
+  return shards;
+}
+
 /// Converts Module \p M into valid C code and outputs it through \p OS.
 /// Returns the cache size necessary to store all the cache indexes used.
 void generateModule(
@@ -3083,7 +3225,18 @@ void generateModule(
   uint32_t nextWriteCacheIdx = 0;
   uint32_t nextReadCacheIdx = 0;
   uint32_t nextPrivateNameCacheIdx = 0;
-  ModuleGen moduleGen{M, options.optimizationEnabled};
+
+  // The C can only be split when it is generated.
+  const unsigned numShards =
+      options.format == DumpBytecode || options.format == EmitBundle
+      ? std::max(options.cShards, 1u)
+      : 1;
+  // Note that we prefix the shared names with sh_ and the unit name, like the
+  // unit creation function, to avoid conflicts with other units.
+  ModuleGen moduleGen{
+      M,
+      options.optimizationEnabled,
+      numShards > 1 ? ("sh_" + options.unitName).str() : ""};
 
   if (options.format == DumpBytecode || options.format == EmitBundle) {
     if (!isValidSHUnitName(options.unitName))
@@ -3098,7 +3251,8 @@ void generateModule(
     auto usedExterns = collectUsedExterns(M);
     generateExternCIncludes(M, OS, *usedExterns);
 
-    OS << R"(
+    if (numShards == 1) {
+      OS << R"(
 static uint32_t unit_index;
 static inline SHSymbolID* get_symbols(SHUnit *);
 static inline SHWritePropertyCacheEntry* get_write_prop_cache(SHUnit *);
@@ -3106,7 +3260,40 @@ static inline SHReadPropertyCacheEntry* get_read_prop_cache(SHUnit *);
 static inline SHPrivateNameCacheEntry* get_private_name_cache(SHUnit *);
 static const SHSrcLoc s_source_locations[];
 static SHNativeFuncInfo s_function_info_table[];
+static const SHNativeRegExp s_native_regexps[];
+)";
+    } else {
+      // Every shard starts with the declarations below, and then only keeps
+      // the functions of the shard selected by SHERMES_SHARD. Shard 0 also
+      // defines the tables and the unit. The names the shards share are
+      // hidden, and renamed to be unique to the unit. The layout of struct
+      // UnitData is only known at the end, so the caches are reached through
+      // the SHUnit.
+      const std::string &prefix = moduleGen.sharedPrefix;
+      OS << "\n// Compile each shard with -DSHERMES_SHARD=<n>, for n in [0, "
+         << numShards << ").\n"
+         << "#define SH_SHARED __attribute__((visibility(\"hidden\")))\n"
+         << "#define unit_index " << prefix << "_unit_index\n"
+         << "#define s_function_info_table " << prefix
+         << "_function_info_table\n"
+         << "#define s_native_regexps " << prefix << "_native_regexps\n"
+         << R"(extern SH_SHARED uint32_t unit_index;
+extern SH_SHARED SHNativeFuncInfo s_function_info_table[];
+extern SH_SHARED const SHNativeRegExp s_native_regexps[];
+static inline SHSymbolID *get_symbols(SHUnit *unit) {
+  return unit->symbols;
+}
+static inline SHWritePropertyCacheEntry *get_write_prop_cache(SHUnit *unit) {
+  return unit->write_prop_cache;
+}
+static inline SHReadPropertyCacheEntry *get_read_prop_cache(SHUnit *unit) {
+  return unit->read_prop_cache;
+}
+static inline SHPrivateNameCacheEntry *get_private_name_cache(SHUnit *unit) {
+  return unit->private_name_cache;
+}
 )";
+    }
 
     // Declare extern functions.
     generateExternC(M, OS, *usedExterns);
@@ -3115,7 +3302,7 @@ static SHNativeFuncInfo s_function_info_table[];
 
     // Forward declare every JS function.
     for (auto &F : *M) {
-      OS << "static SHLegacyValue ";
+      OS << moduleGen.sharedLinkage() << "SHLegacyValue ";
       moduleGen.nativeFunctionTable.generateFunctionLabel(&F, OS);
       OS << "(SHRuntime *shr);\n";
     }
@@ -3123,22 +3310,75 @@ static SHNativeFuncInfo s_function_info_table[];
 
   M->assignIndexToVariables();
 
-  for (auto &F : *M) {
-    generateFunction(
-        F,
-        OS,
-        moduleGen,
-        nextWriteCacheIdx,
-        nextReadCacheIdx,
-        nextPrivateNameCacheIdx,
-        options);
+  // Register allocation and the lowering after it only touch the function
+  // being compiled, so they can run on several threads. Emission uses the
+  // module-wide tables and cache indices, and runs on this thread in module
+  // order, so the output does not depend on the number of threads. Dumps made
+  // while allocating must not interleave, so they force a single thread.
+  unsigned numThreads = resolveThreadCount(options.codegenThreads);
+  if (options.format == DumpRA || options.format == DumpLRA ||
+      M->getContext().getCodeGenerationSettings().dumpIRBetweenPasses) {
+    numThreads = 1;
+  }
+  const size_t batchSize =
+      numThreads == 1 ? 1 : numThreads * kParallelFunctionsPerThread;
+
+  std::vector<Function *> functions{};
+  for (auto &F : *M)
+    functions.push_back(&F);
+
+  std::vector<unsigned> functionShards{};
+  if (numShards > 1)
+    functionShards = assignShards(functions, numShards);
+  // The shard whose #if block is open, if any.
+  llvh::Optional<unsigned> openShard{};
+  // Start the block of shard \p shard, unless it is already open.
+  auto beginShard = [&OS, &openShard](unsigned shard) {
+    if (openShard == shard)
+      return;
+    if (openShard)
+      OS << "#endif\n";
+    OS << "\n#if " << shardCondition(shard) << "\n";
+    openShard = shard;
+  };
+
+  std::vector<AllocatedFunction> allocated{};
+  for (size_t batchStart = 0; batchStart < functions.size();
+       batchStart += batchSize) {
+    const size_t batchEnd = std::min(functions.size(), batchStart + batchSize);
+    allocated.clear();
+    allocated.resize(batchEnd - batchStart);
+    parallelFor(numThreads, allocated.size(), [&](size_t i) {
+      allocated[i] = allocateFunction(*functions[batchStart + i], options);
+    });
+
+    for (size_t i = batchStart; i < batchEnd; ++i) {
+      if (numShards > 1)
+        beginShard(functionShards[i]);
+      generateFunction(
+          *functions[i],
+          allocated[i - batchStart],
+          OS,
+          moduleGen,
+          nextWriteCacheIdx,
+          nextReadCacheIdx,
+          nextPrivateNameCacheIdx,
+          options);
+    }
   }
 
   if (options.format == DumpBytecode || options.format == EmitBundle) {
+    // The tables and the unit are defined in shard 0.
+    if (numShards > 1) {
+      beginShard(0);
+      OS << "SH_SHARED uint32_t unit_index;\n";
+    }
+
     moduleGen.literalBuffers.generate(OS);
     moduleGen.srcLocationTable.generate(
         OS, M->getContext().getSourceErrorManager());
-    moduleGen.nativeFunctionTable.generate(OS);
+    moduleGen.nativeFunctionTable.generate(OS, moduleGen.sharedLinkage());
+    moduleGen.nativeRegExpTable.generate(OS, moduleGen.sharedLinkage());
     // String table should be generated last, because the generate calls to
     // other module components may add new entries to the string table.
     moduleGen.stringTable.generate(OS);
@@ -3179,11 +3419,16 @@ static SHNativeFuncInfo s_function_info_table[];
        << ".object_literal_class_cache = unit_data->object_literal_class_cache, "
        << ".source_locations = s_source_locations, "
        << ".source_locations_size = " << moduleGen.srcLocationTable.size()
-       << ", " << ".unit_main = _0_global, "
+       << ", " << ".unit_main = ";
+    moduleGen.nativeFunctionTable.generateFunctionLabel(
+        M->getTopLevelFunction(), OS);
+    OS << ", "
        << ".unit_main_info = &s_function_info_table[0], "
        << ".unit_name = \"sh_compiled\" }};\n"
-       << "  return (SHUnit *)unit_data;\n}\n"
-       << R"(
+       << "  return (SHUnit *)unit_data;\n}\n";
+    // When sharded, the accessors are defined at the start of every shard.
+    if (numShards == 1) {
+      OS << R"(
 SHSymbolID *get_symbols(SHUnit *unit) {
   return ((struct UnitData *)unit)->symbol_data;
 }
@@ -3198,6 +3443,7 @@ SHPrivateNameCacheEntry *get_private_name_cache(SHUnit *unit) {
   return ((struct UnitData *)unit)->private_name_cache_data;
 }
 )";
+    }
     if (options.emitMain) {
       OS << R"(
 typedef struct SHConsoleContext SHConsoleContext;
@@ -3235,6 +3481,8 @@ int main(int argc, char **argv) {
 }
 )";
     }
+    if (openShard)
+      OS << "#endif\n";
   }
 }
 } // namespace
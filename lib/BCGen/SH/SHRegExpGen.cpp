@@ -0,0 +1,746 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "SHRegExpGen.h"
+
+#include "hermes/Regex/RegexBytecode.h"
+#include "hermes/Regex/RegexTypes.h"
+
+#include "llvh/ADT/SetVector.h"
+#include "llvh/ADT/StringSet.h"
+#include "llvh/ADT/Twine.h"
+
+#include <cstring>
+
+namespace hermes::sh {
+
+using namespace hermes::regex;
+
+namespace {
+
+/// Regexps with more bytecode than this are left to the interpreter, to bound
+/// the size of the generated C.
+constexpr size_t kMaxBytecodeSize = 16 * 1024;
+
+/// \return the width of \p insn, including any data following it.
+uint32_t insnWidth(const Insn *insn) {
+  switch (insn->opcode) {
+    case Opcode::Bracket:
+    case Opcode::BracketICase:
+    case Opcode::U16Bracket:
+    case Opcode::U16BracketICase:
+      return static_cast<const BracketInsn *>(insn)->totalWidth();
+    case Opcode::MatchNChar8:
+      return static_cast<const MatchNChar8Insn *>(insn)->totalWidth();
+    case Opcode::MatchNCharICase8:
+      return static_cast<const MatchNCharICase8Insn *>(insn)->totalWidth();
+    default:
+      break;
+  }
+  switch (insn->opcode) {
+#define REOP(Code)   \
+  case Opcode::Code: \
+    return sizeof(Code##Insn);
+#include "hermes/Regex/RegexOpcodes.def"
+  }
+  llvm_unreachable("invalid regex opcode");
+}
+
+/// \return true if \p opcode can be the body of a generated width 1 loop.
+bool isSupportedWidth1(Opcode opcode) {
+  switch (opcode) {
+    case Opcode::MatchAny:
+    case Opcode::MatchAnyButNewline:
+    case Opcode::MatchChar8:
+    case Opcode::MatchChar16:
+    case Opcode::Bracket:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// Generates the search function for one input width. The function body is
+/// generated twice: the first pass only records which labels and backtracking
+/// entries are used, so that the second pass emits exactly those, and the
+/// generated C compiles without unused label warnings.
+class MatcherGen {
+ public:
+  MatcherGen(llvh::ArrayRef<uint8_t> bytecode, bool wide)
+      : header_(reinterpret_cast<const RegexBytecodeHeader *>(bytecode.data())),
+        insns_(bytecode.drop_front(sizeof(RegexBytecodeHeader))),
+        wide_(wide) {}
+
+  void generate(llvh::StringRef name, llvh::raw_ostream &OS) {
+    os_ = &llvh::nulls();
+    emitFunction(name);
+    recording_ = false;
+    os_ = &OS;
+    emitFunction(name);
+  }
+
+ private:
+  /// Kinds of backtracking entries, in the same order as the
+  /// SH_REGEXP_BT_ constants.
+  enum BacktrackKind {
+    SetCapture,
+    SetLoop,
+    SetPosition,
+    GreedyWidth1,
+    NongreedyWidth1,
+    EnterLoop,
+    NumKinds,
+  };
+
+  static constexpr const char *kindNames[NumKinds] = {
+      "SH_REGEXP_BT_SET_CAPTURE",
+      "SH_REGEXP_BT_SET_LOOP",
+      "SH_REGEXP_BT_SET_POSITION",
+      "SH_REGEXP_BT_GREEDY_WIDTH1",
+      "SH_REGEXP_BT_NONGREEDY_WIDTH1",
+      "SH_REGEXP_BT_ENTER_LOOP",
+  };
+
+  const Insn *insnAt(uint32_t offset) const {
+    return reinterpret_cast<const Insn *>(&insns_[offset]);
+  }
+
+  static std::string label(uint32_t offset, const char *suffix = "") {
+    return (llvh::Twine("L") + llvh::Twine(offset) + suffix).str();
+  }
+
+  llvh::raw_ostream &os() {
+    return *os_;
+  }
+
+  /// Define \p name if it is the target of any goto.
+  void emitLabel(llvh::StringRef name) {
+    if (usedLabels_.count(name))
+      os() << name << ":\n";
+  }
+
+  /// Emit a jump to \p name.
+  void emitGoto(llvh::StringRef name) {
+    if (recording_)
+      usedLabels_.insert(name);
+    os() << "goto " << name << ";\n";
+  }
+
+  /// Emit a push of a backtracking entry, indented by \p indent.
+  void emitPush(
+      BacktrackKind kind,
+      const llvh::Twine &a,
+      const llvh::Twine &b,
+      const llvh::Twine &c,
+      unsigned indent = 2) {
+    usedKinds_[kind] = true;
+    os().indent(indent) << "if (!_sh_regexp_push(&st, " << kindNames[kind]
+                        << ", " << a << ", " << b << ", " << c << "))\n";
+    os().indent(indent + 2);
+    emitGoto("bail");
+  }
+
+  /// \return a C expression that is true when the current position satisfies
+  /// \p constraints, mirroring Cursor::satisfiesConstraints.
+  static std::string satisfies(MatchConstraintSet constraints) {
+    std::string result;
+    if (constraints & MatchConstraintNonASCII)
+      result = "!(flags & SH_REGEXP_INPUT_ALL_ASCII)";
+    if (constraints & MatchConstraintAnchoredAtStart)
+      result += result.empty() ? "pos == 0" : " && pos == 0";
+    return result.empty() ? "1" : result;
+  }
+
+  /// \return a C expression that is true when the character `ch` matches the
+  /// width 1 instruction \p insn.
+  std::string width1Matches(const Insn *insn) const {
+    std::string result;
+    llvh::raw_string_ostream OS{result};
+    switch (insn->opcode) {
+      case Opcode::MatchAny:
+        return "1";
+      case Opcode::MatchAnyButNewline:
+        return "!SH_REGEXP_IS_LINE_TERMINATOR(ch)";
+      case Opcode::MatchChar8:
+        OS << "ch == "
+           << (unsigned)(uint8_t) static_cast<const MatchChar8Insn *>(insn)->c
+           << "u";
+        return OS.str();
+      case Opcode::MatchChar16: {
+        char16_t c = static_cast<const MatchChar16Insn *>(insn)->c;
+        if (!wide_ && c > 0xFF)
+          return "0";
+        OS << "ch == " << (unsigned)c << "u";
+        return OS.str();
+      }
+      case Opcode::Bracket:
+        return bracketMatches(static_cast<const BracketInsn *>(insn));
+      default:
+        llvm_unreachable("unsupported width 1 instruction");
+    }
+  }
+
+  /// \return a C expression that is true when `ch` matches \p insn, mirroring
+  /// bracketMatchesChar.
+  std::string bracketMatches(const BracketInsn *insn) const {
+    std::string result;
+    llvh::raw_string_ostream OS{result};
+    const char *sep = "";
+    auto classMacro = [this](CharacterClass::Type type) {
+      switch (type) {
+        case CharacterClass::Digits:
+          return "SH_REGEXP_IS_DIGIT(ch)";
+        case CharacterClass::Spaces:
+          return wide_ ? "SH_REGEXP_IS_SPACE16(ch)" : "SH_REGEXP_IS_SPACE8(ch)";
+        case CharacterClass::Words:
+          return "SH_REGEXP_IS_WORD(ch)";
+      }
+      llvm_unreachable("invalid character class");
+    };
+    for (auto type :
+         {CharacterClass::Digits,
+          CharacterClass::Spaces,
+          CharacterClass::Words}) {
+      if (insn->positiveCharClasses & type) {
+        OS << sep << classMacro(type);
+        sep = " || ";
+      }
+      if (insn->negativeCharClasses & type) {
+        OS << sep << "!" << classMacro(type);
+        sep = " || ";
+      }
+    }
+    auto *ranges = reinterpret_cast<const BracketRange32 *>(insn + 1);
+    for (uint32_t i = 0; i < insn->rangeCount; ++i) {
+      BracketRange32 range;
+      memcpy(&range, &ranges[i], sizeof(range));
+      // Characters of ASCII inputs are at most 0xFF.
+      if (!wide_ && range.start > 0xFF)
+        continue;
+      OS << sep;
+      sep = " || ";
+      if (range.start == range.end)
+        OS << "ch == " << range.start << "u";
+      else
+        OS << "ch - " << range.start << "u <= " << (range.end - range.start)
+           << "u";
+    }
+    if (!*sep)
+      OS << "0";
+    return (llvh::Twine(insn->negate ? "!(" : "(") + OS.str() + ")").str();
+  }
+
+  /// Emit a check that one character matches \p insn, advancing past it.
+  void emitWidth1(const Insn *insn) {
+    os() << "  if (pos == length)\n    ";
+    emitGoto("backtrack");
+    os() << "  ch = input[pos];\n"
+         << "  if (!(" << width1Matches(insn) << "))\n    ";
+    emitGoto("backtrack");
+    os() << "  ++pos;\n";
+  }
+
+  void emitFunction(llvh::StringRef name);
+  void emitInsn(uint32_t offset, uint32_t nextOffset);
+  void emitBacktrack();
+
+  const RegexBytecodeHeader *header_;
+  llvh::ArrayRef<uint8_t> insns_;
+  /// Whether the input is UTF-16 rather than ASCII.
+  bool wide_;
+
+  /// Set during the first pass.
+  bool recording_ = true;
+  llvh::raw_ostream *os_ = nullptr;
+
+  /// Labels that are jumped to.
+  llvh::StringSet<> usedLabels_{};
+  /// Kinds of backtracking entries that are pushed.
+  bool usedKinds_[NumKinds]{};
+  /// Offsets where matching resumes after popping a SetPosition or width 1
+  /// loop entry.
+  llvh::SetVector<uint32_t> resumeTargets_{};
+  /// Offsets of BeginLoop instructions of non-greedy loops, which are entered
+  /// on backtracking.
+  llvh::SetVector<uint32_t> enterLoops_{};
+};
+
+void MatcherGen::emitFunction(llvh::StringRef name) {
+  const char *charType = wide_ ? "uint16_t" : "uint8_t";
+  uint32_t numCaptures = 2 * (header_->markedCount + 1u);
+  MatchConstraintSet constraints = header_->constraints;
+
+  os() << "\nstatic int32_t " << name << (wide_ ? "_search16" : "_search8")
+       << "(const " << charType << " *input, uint32_t start, "
+       << "uint32_t length, uint32_t flags, uint32_t *caps) {\n";
+  // Check for match impossibility before doing anything else.
+  if (constraints & MatchConstraintNonASCII)
+    os() << "  if (flags & SH_REGEXP_INPUT_ALL_ASCII)\n    return 0;\n";
+  if (constraints & MatchConstraintAnchoredAtStart)
+    os() << "  if (start != 0)\n    return 0;\n";
+  os() << "  const bool onlyAtStart = "
+       << ((constraints & MatchConstraintAnchoredAtStart)
+               ? "true"
+               : "(flags & SH_REGEXP_ONLY_AT_START) != 0")
+       << ";\n";
+  // Width 1 loops are counted in loopCount, but don't need any state here.
+  if (header_->loopCount)
+    os() << "  uint32_t loops[" << 2u * header_->loopCount << "];\n"
+         << "  (void)loops;\n";
+  os() << "  uint32_t matchStart = start, pos, ch, target, iters;\n"
+       << "  int32_t result = 0;\n"
+       << "  SHRegExpStack st;\n"
+       << "  (void)input;\n"
+       << "  (void)flags;\n"
+       << "  (void)ch;\n"
+       << "  (void)target;\n"
+       << "  (void)iters;\n"
+       << "  _sh_regexp_stack_init(&st);\n";
+
+  emitLabel("next_start");
+  if (header_->markedCount)
+    os() << "  for (uint32_t i = 2; i < " << numCaptures << "; ++i)\n"
+         << "    caps[i] = SH_REGEXP_NOT_MATCHED;\n";
+  os() << "  pos = matchStart;\n"
+       << "  st.size = 0;\n";
+
+  for (uint32_t offset = 0; offset < insns_.size();) {
+    const Insn *insn = insnAt(offset);
+    uint32_t width = insnWidth(insn);
+    // The body of a width 1 loop is generated inline with the loop.
+    if (insn->opcode == Opcode::Width1Loop)
+      width += insnWidth(insnAt(offset + width));
+    emitInsn(offset, offset + width);
+    offset += width;
+  }
+
+  emitBacktrack();
+  os() << "done:\n"
+       << "  _sh_regexp_stack_free(&st);\n"
+       << "  return result;\n"
+       << "}\n";
+}
+
+void MatcherGen::emitInsn(uint32_t offset, uint32_t nextOffset) {
+  const Insn *base = insnAt(offset);
+  emitLabel(label(offset));
+  // Each instruction starts with a statement, so that it may be labelled.
+  os() << "  /* " << offset << " */;\n";
+  switch (base->opcode) {
+    case Opcode::Goal:
+      os() << "  caps[0] = matchStart;\n"
+           << "  caps[1] = pos;\n"
+           << "  result = 1;\n  ";
+      emitGoto("done");
+      return;
+
+    case Opcode::LeftAnchor:
+      os() << "  if (pos != 0)\n    ";
+      emitGoto("backtrack");
+      return;
+
+    case Opcode::LeftAnchorMultiline:
+      os() << "  if (pos != 0 && "
+           << "!SH_REGEXP_IS_LINE_TERMINATOR((uint32_t)input[pos - 1]))\n    ";
+      emitGoto("backtrack");
+      return;
+
+    case Opcode::RightAnchor:
+      os() << "  if (pos != length || (flags & SH_REGEXP_NOT_END_OF_LINE))\n"
+           << "    ";
+      emitGoto("backtrack");
+      return;
+
+    case Opcode::RightAnchorMultiline:
+      os() << "  if (pos == length ? (flags & SH_REGEXP_NOT_END_OF_LINE) != 0 "
+           << ": !SH_REGEXP_IS_LINE_TERMINATOR((uint32_t)input[pos]))\n    ";
+      emitGoto("backtrack");
+      return;
+
+    case Opcode::MatchAny:
+    case Opcode::MatchAnyButNewline:
+    case Opcode::MatchChar8:
+    case Opcode::MatchChar16:
+    case Opcode::Bracket:
+      emitWidth1(base);
+      return;
+
+    case Opcode::MatchNChar8: {
+      const auto *insn = static_cast<const MatchNChar8Insn *>(base);
+      auto *chars = reinterpret_cast<const uint8_t *>(insn + 1);
+      os() << "  if (length - pos < " << (unsigned)insn->charCount << "u";
+      for (unsigned i = 0; i < insn->charCount; ++i)
+        os() << " ||\n      input[pos + " << i << "] != " << (unsigned)chars[i]
+             << "u";
+      os() << ")\n    ";
+      emitGoto("backtrack");
+      os() << "  pos += " << (unsigned)insn->charCount << ";\n";
+      return;
+    }
+
+    case Opcode::Alternation: {
+      // Explore the primary branch first if both are viable, backtracking to
+      // the secondary one.
+      const auto *insn = static_cast<const AlternationInsn *>(base);
+      uint32_t secondary = insn->secondaryBranch;
+      resumeTargets_.insert(secondary);
+      os() << "  {\n"
+           << "    bool primary = " << satisfies(insn->primaryConstraints)
+           << ";\n"
+           << "    bool secondary = " << satisfies(insn->secondaryConstraints)
+           << ";\n"
+           << "    if (!primary) {\n"
+           << "      if (!secondary)\n        ";
+      emitGoto("backtrack");
+      os() << "      ";
+      emitGoto(label(secondary));
+      os() << "    }\n"
+           << "    if (secondary) {\n";
+      emitPush(SetPosition, llvh::Twine(secondary), "pos", "0", 6);
+      os() << "    }\n"
+           << "  }\n";
+      return;
+    }
+
+    case Opcode::Jump32:
+      os() << "  ";
+      emitGoto(label(static_cast<const Jump32Insn *>(base)->target));
+      return;
+
+    case Opcode::BeginMarkedSubexpression: {
+      const auto *insn =
+          static_cast<const BeginMarkedSubexpressionInsn *>(base);
+      uint32_t cap = 2u + 2u * insn->mexp;
+      emitPush(
+          SetCapture,
+          llvh::Twine(cap),
+          "SH_REGEXP_NOT_MATCHED",
+          "SH_REGEXP_NOT_MATCHED");
+      os() << "  caps[" << cap << "] = pos;\n";
+      return;
+    }
+
+    case Opcode::EndMarkedSubexpression: {
+      const auto *insn = static_cast<const EndMarkedSubexpressionInsn *>(base);
+      uint32_t cap = 2u + 2u * insn->mexp;
+      os() << "  caps[" << cap + 1 << "] = pos;\n";
+      return;
+    }
+
+    case Opcode::BackRef: {
+      // Backreferences to a group that has not matched always succeed.
+      uint32_t cap = 2u + 2u * static_cast<const BackRefInsn *>(base)->mexp;
+      os() << "  if (caps[" << cap << "] != SH_REGEXP_NOT_MATCHED && caps["
+           << cap + 1 << "] != SH_REGEXP_NOT_MATCHED) {\n"
+           << "    uint32_t len = caps[" << cap + 1 << "] - caps[" << cap
+           << "];\n"
+           << "    if (length - pos < len ||\n"
+           << "        memcmp(input + caps[" << cap
+           << "], input + pos, len * sizeof(*input)) != 0)\n      ";
+      emitGoto("backtrack");
+      os() << "    pos += len;\n"
+           << "  }\n";
+      return;
+    }
+
+    case Opcode::WordBoundary: {
+      const auto *insn = static_cast<const WordBoundaryInsn *>(base);
+      os() << "  if (((pos != 0 && "
+           << "SH_REGEXP_IS_WORD((uint32_t)input[pos - 1])) !=\n"
+           << "       (pos != length && "
+           << "SH_REGEXP_IS_WORD((uint32_t)input[pos]))) == "
+           << (insn->invert ? "true" : "false") << ")\n    ";
+      emitGoto("backtrack");
+      return;
+    }
+
+    case Opcode::BeginSimpleLoop: {
+      // Simple loops are always greedy, and always explore both exiting and
+      // continuing the loop.
+      const auto *insn = static_cast<const BeginSimpleLoopInsn *>(base);
+      uint32_t notTaken = insn->notTakenTarget;
+      resumeTargets_.insert(notTaken);
+      os() << "  if (!(" << satisfies(insn->loopeeConstraints) << "))\n    ";
+      emitGoto(label(notTaken));
+      emitLabel(label(offset, "_run"));
+      emitPush(SetPosition, llvh::Twine(notTaken), "pos", "0");
+      return;
+    }
+
+    case Opcode::EndSimpleLoop:
+      os() << "  ";
+      emitGoto(
+          label(static_cast<const EndSimpleLoopInsn *>(base)->target, "_run"));
+      return;
+
+    case Opcode::BeginLoop: {
+      const auto *insn = static_cast<const BeginLoopInsn *>(base);
+      uint32_t notTaken = insn->notTakenTarget;
+      std::string iterations =
+          "loops[" + std::to_string(2 * insn->loopId) + "]";
+      std::string entry =
+          "loops[" + std::to_string(2 * insn->loopId + 1) + "]";
+      os() << "  " << iterations << " = 0;\n"
+           << "  if (!(" << satisfies(insn->loopeeConstraints) << "))\n    ";
+      emitGoto(insn->min > 0 ? "backtrack" : label(notTaken));
+      emitLabel(label(offset, "_run"));
+      // Once the minimum number of iterations is reached, iterations that
+      // match the empty string are not considered.
+      os() << "  if (" << iterations << " > " << insn->min << "u && " << entry
+           << " == pos)\n    ";
+      emitGoto("backtrack");
+      if (insn->min > 0) {
+        os() << "  if (" << iterations << " < " << insn->min << "u)\n    ";
+        emitGoto(label(offset, "_enter"));
+      }
+      os() << "  if (" << iterations << " == " << insn->max << "u)\n    ";
+      emitGoto(label(notTaken));
+      if (insn->greedy) {
+        // Backtrack by exiting the loop.
+        resumeTargets_.insert(notTaken);
+        emitPush(SetPosition, llvh::Twine(notTaken), "pos", "0");
+      } else {
+        // Backtrack by entering the loop.
+        enterLoops_.insert(offset);
+        os() << "  " << entry << " = pos;\n";
+        emitPush(EnterLoop, llvh::Twine(offset), iterations, "pos");
+        os() << "  ";
+        emitGoto(label(notTaken));
+      }
+      // Enter the loop body, which follows, saving the loop state and
+      // resetting the contained capture groups.
+      emitLabel(label(offset, "_enter"));
+      emitPush(
+          SetLoop, llvh::Twine(2 * insn->loopId), iterations, entry);
+      os() << "  ++" << iterations << ";\n"
+           << "  " << entry << " = pos;\n";
+      for (uint32_t mexp = insn->mexpBegin; mexp != insn->mexpEnd; ++mexp) {
+        uint32_t cap = 2 + 2 * mexp;
+        std::string start = "caps[" + std::to_string(cap) + "]";
+        std::string end = "caps[" + std::to_string(cap + 1) + "]";
+        emitPush(SetCapture, llvh::Twine(cap), start, end);
+        os() << "  " << start << " = " << end << " = SH_REGEXP_NOT_MATCHED;\n";
+      }
+      return;
+    }
+
+    case Opcode::EndLoop:
+      os() << "  ";
+      emitGoto(label(static_cast<const EndLoopInsn *>(base)->target, "_run"));
+      return;
+
+    case Opcode::Width1Loop: {
+      // Match as many characters as possible up to the maximum, then record
+      // the range of possible exit positions for backtracking.
+      const auto *insn = static_cast<const Width1LoopInsn *>(base);
+      uint32_t notTaken = insn->notTakenTarget;
+      os() << "  {\n"
+           << "    uint32_t limit = length - pos, n = 0;\n";
+      if (insn->max != UINT32_MAX)
+        os() << "    if (limit > " << insn->max << "u)\n"
+             << "      limit = " << insn->max << "u;\n";
+      os() << "    for (; n < limit; ++n) {\n"
+           << "      ch = input[pos + n];\n"
+           << "      if (!(" << width1Matches(insnAt(offset + sizeof(*insn)))
+           << "))\n"
+           << "        break;\n"
+           << "    }\n";
+      if (insn->min > 0) {
+        os() << "    if (n < " << insn->min << "u)\n      ";
+        emitGoto("backtrack");
+      }
+      resumeTargets_.insert(notTaken);
+      os() << "    if (n > " << insn->min << "u) {\n";
+      emitPush(
+          insn->greedy ? GreedyWidth1 : NongreedyWidth1,
+          llvh::Twine(notTaken),
+          "pos + " + llvh::Twine(insn->min),
+          "pos + n",
+          6);
+      os() << "    }\n"
+           << "    pos += "
+           << (insn->greedy ? std::string("n") : std::to_string(insn->min))
+           << ";\n"
+           << "  }\n";
+      if (notTaken != nextOffset) {
+        os() << "  ";
+        emitGoto(label(notTaken));
+      }
+      return;
+    }
+
+    default:
+      llvm_unreachable("unsupported regex instruction");
+  }
+}
+
+void MatcherGen::emitBacktrack() {
+  // Pop backtracking entries until one resumes matching. If there are none
+  // left, try the next start position.
+  emitLabel("backtrack");
+  bool anyKinds = false;
+  for (bool used : usedKinds_)
+    anyKinds |= used;
+  if (anyKinds)
+    os() << "  while (st.size) {\n"
+         << "    SHRegExpBacktrack *bt = &st.entries[st.size - 1];\n"
+         << "    switch (bt->kind) {\n";
+  if (usedKinds_[SetCapture])
+    os() << "      case SH_REGEXP_BT_SET_CAPTURE:\n"
+         << "        caps[bt->a] = bt->b;\n"
+         << "        caps[bt->a + 1] = bt->c;\n"
+         << "        --st.size;\n"
+         << "        continue;\n";
+  if (usedKinds_[SetLoop])
+    os() << "      case SH_REGEXP_BT_SET_LOOP:\n"
+         << "        loops[bt->a] = bt->b;\n"
+         << "        loops[bt->a + 1] = bt->c;\n"
+         << "        --st.size;\n"
+         << "        continue;\n";
+  if (usedKinds_[SetPosition]) {
+    os() << "      case SH_REGEXP_BT_SET_POSITION:\n"
+         << "        target = bt->a;\n"
+         << "        pos = bt->b;\n"
+         << "        --st.size;\n"
+         << "        ";
+    emitGoto("resume");
+  }
+  // Width 1 loop entries stay on the stack until every exit position has been
+  // tried.
+  if (usedKinds_[GreedyWidth1]) {
+    os() << "      case SH_REGEXP_BT_GREEDY_WIDTH1:\n"
+         << "        if (bt->b == bt->c) {\n"
+         << "          --st.size;\n"
+         << "          continue;\n"
+         << "        }\n"
+         << "        target = bt->a;\n"
+         << "        pos = --bt->c;\n"
+         << "        ";
+    emitGoto("resume");
+  }
+  if (usedKinds_[NongreedyWidth1]) {
+    os() << "      case SH_REGEXP_BT_NONGREEDY_WIDTH1:\n"
+         << "        if (bt->b == bt->c) {\n"
+         << "          --st.size;\n"
+         << "          continue;\n"
+         << "        }\n"
+         << "        target = bt->a;\n"
+         << "        pos = ++bt->b;\n"
+         << "        ";
+    emitGoto("resume");
+  }
+  if (usedKinds_[EnterLoop]) {
+    os() << "      case SH_REGEXP_BT_ENTER_LOOP:\n"
+         << "        target = bt->a;\n"
+         << "        iters = bt->b;\n"
+         << "        pos = bt->c;\n"
+         << "        --st.size;\n"
+         << "        ";
+    emitGoto("enter_loop");
+  }
+  if (anyKinds)
+    os() << "    }\n"
+         << "  }\n";
+  os() << "  if (onlyAtStart || matchStart >= length)\n    ";
+  emitGoto("done");
+  os() << "  ++matchStart;\n  ";
+  emitGoto("next_start");
+
+  if (usedLabels_.count("resume")) {
+    os() << "resume:\n"
+         << "  switch (target) {\n";
+    for (uint32_t target : resumeTargets_) {
+      os() << "    case " << target << ":\n      ";
+      emitGoto(label(target));
+    }
+    os() << "  }\n  ";
+    emitGoto("done");
+  }
+  if (usedLabels_.count("enter_loop")) {
+    os() << "enter_loop:\n"
+         << "  switch (target) {\n";
+    for (uint32_t offset : enterLoops_) {
+      uint32_t loopId = static_cast<const BeginLoopInsn *>(insnAt(offset))
+                            ->loopId;
+      os() << "    case " << offset << ":\n"
+           << "      loops[" << 2 * loopId << "] = iters;\n"
+           << "      loops[" << 2 * loopId + 1 << "] = pos;\n      ";
+      emitGoto(label(offset, "_enter"));
+    }
+    os() << "  }\n  ";
+    emitGoto("done");
+  }
+  emitLabel("bail");
+  if (usedLabels_.count("bail"))
+    os() << "  caps[0] = matchStart;\n"
+         << "  result = -1;\n";
+}
+
+} // namespace
+
+bool canGenerateRegExpMatcher(llvh::ArrayRef<uint8_t> bytecode) {
+  if (bytecode.size() < sizeof(RegexBytecodeHeader) ||
+      bytecode.size() > kMaxBytecodeSize)
+    return false;
+  auto *header = reinterpret_cast<const RegexBytecodeHeader *>(bytecode.data());
+  SyntaxFlags flags = SyntaxFlags::fromByte(header->syntaxFlags);
+  if (flags.ignoreCase || flags.unicode)
+    return false;
+
+  llvh::ArrayRef<uint8_t> insns =
+      bytecode.drop_front(sizeof(RegexBytecodeHeader));
+  for (uint32_t offset = 0; offset < insns.size();) {
+    auto *insn = reinterpret_cast<const Insn *>(&insns[offset]);
+    switch (insn->opcode) {
+      case Opcode::Goal:
+      case Opcode::LeftAnchor:
+      case Opcode::LeftAnchorMultiline:
+      case Opcode::RightAnchor:
+      case Opcode::RightAnchorMultiline:
+      case Opcode::MatchAny:
+      case Opcode::MatchAnyButNewline:
+      case Opcode::MatchChar8:
+      case Opcode::MatchChar16:
+      case Opcode::MatchNChar8:
+      case Opcode::Alternation:
+      case Opcode::Jump32:
+      case Opcode::Bracket:
+      case Opcode::BeginMarkedSubexpression:
+      case Opcode::EndMarkedSubexpression:
+      case Opcode::BackRef:
+      case Opcode::WordBoundary:
+      case Opcode::BeginLoop:
+      case Opcode::EndLoop:
+      case Opcode::BeginSimpleLoop:
+      case Opcode::EndSimpleLoop:
+        break;
+      case Opcode::Width1Loop: {
+        uint32_t bodyOffset = offset + sizeof(Width1LoopInsn);
+        if (bodyOffset >= insns.size() ||
+            !isSupportedWidth1(
+                reinterpret_cast<const Insn *>(&insns[bodyOffset])->opcode))
+          return false;
+        break;
+      }
+      default:
+        return false;
+    }
+    offset += insnWidth(insn);
+  }
+  return true;
+}
+
+void generateRegExpMatcher(
+    llvh::ArrayRef<uint8_t> bytecode,
+    llvh::StringRef name,
+    llvh::raw_ostream &OS) {
+  assert(canGenerateRegExpMatcher(bytecode) && "unsupported regexp");
+  MatcherGen(bytecode, false).generate(name, OS);
+  MatcherGen(bytecode, true).generate(name, OS);
+}
+
+} // namespace hermes::sh
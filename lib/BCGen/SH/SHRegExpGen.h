@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_BCGEN_SH_SHREGEXPGEN_H
+#define HERMES_BCGEN_SH_SHREGEXPGEN_H
+
+#include "llvh/ADT/ArrayRef.h"
+#include "llvh/ADT/StringRef.h"
+#include "llvh/Support/raw_ostream.h"
+
+namespace hermes::sh {
+
+/// \return true if generateRegExpMatcher() can translate the regex
+/// \p bytecode. Case-insensitive and unicode regexps, lookarounds and
+/// case-insensitive backreferences are left to the regex interpreter.
+bool canGenerateRegExpMatcher(llvh::ArrayRef<uint8_t> bytecode);
+
+/// Translate the regex \p bytecode into C functions \p name_search8 and
+/// \p name_search16, matching ASCII and UTF-16 inputs respectively, and print
+/// them to \p OS. The functions have the signatures declared in
+/// sh_native_regexp.h and implement the same backtracking search as the regex
+/// interpreter. canGenerateRegExpMatcher(bytecode) must be true.
+void generateRegExpMatcher(
+    llvh::ArrayRef<uint8_t> bytecode,
+    llvh::StringRef name,
+    llvh::raw_ostream &OS);
+
+} // namespace hermes::sh
+
+#endif // HERMES_BCGEN_SH_SHREGEXPGEN_H
@@ -35,6 +35,7 @@
 #include "hermes/SourceMap/SourceMapParser.h"
 #include "hermes/SourceMap/SourceMapTranslator.h"
 #include "hermes/Support/Algorithms.h"
+#include "hermes/Support/CompileCache.h"
 #include "hermes/Support/MemoryBuffer.h"
 #include "hermes/Support/OSCompat.h"
 #include "hermes/Support/OptValue.h"
@@ -660,6 +661,26 @@ static opt<std::string> BaseBytecodeFile(
     llvh::cl::init(""),
     cat(CompilerCategory));
 
+static opt<unsigned> CodegenThreads(
+    "j",
+    desc(
+        "Number of threads for per-function register allocation and lowering "
+        "(0 means one per hardware thread)"),
+    value_desc("threads"),
+    init(1),
+    llvh::cl::Prefix,
+    cat(CompilerCategory));
+
+static opt<std::string> CompileCacheDir(
+    "compile-cache",
+    desc(
+        "Cache the output of the whole compilation in this directory, keyed "
+        "on the command line and the files it names, and reuse it instead of "
+        "compiling when they are unchanged. Only used with -emit-binary to a "
+        "single output without a source map."),
+    value_desc("dir"),
+    cat(CompilerCategory));
+
 static opt<unsigned> PadFunctionBodiesPercent(
     "pad-function-bodies-percent",
     desc(
@@ -1952,12 +1973,25 @@ CompileResult generateBytecodeForSerialization(
   return Success;
 }
 
+/// \return whether the output of compiling with \p context, started with the
+/// command line \p args, can be cached.
+bool isCompileCacheEnabled(
+    const Context &context,
+    llvh::ArrayRef<const char *> args) {
+  // The cache holds a single output file.
+  return !cl::CompileCacheDir.empty() && !args.empty() &&
+      cl::DumpTarget == EmitBundle && context.getSegments().size() < 2 &&
+      !cl::OutputSourceMap && cl::BaseBytecodeFile.empty();
+}
+
 /// Compiles the given files \p fileBufs with the context \p context,
-/// respecting the command line flags.
+/// respecting the command line flags. \p args is the command line, which is
+/// used to key the compile cache.
 /// \return a CompileResult containing the compilation status and artifacts.
 CompileResult processSourceFiles(
     std::shared_ptr<Context> context,
-    SegmentTable fileBufs) {
+    SegmentTable fileBufs,
+    llvh::ArrayRef<const char *> args) {
   assert(!fileBufs.empty() && "Need at least one file to compile");
   assert(context && "Need a context to compile using");
   assert(!cl::BytecodeMode && "Input files must not be bytecode");
@@ -1975,6 +2009,37 @@ CompileResult processSourceFiles(
   assert(
       rawFinalHash.size() == SHA1_NUM_BYTES && "Incorrect length of SHA1 hash");
   std::copy(rawFinalHash.begin(), rawFinalHash.end(), sourceHash.begin());
+
+  // The compile cache holds the output of whole builds. Its key covers the
+  // command line, the input files and the other files named on the command
+  // line, which is everything the output depends on, so a hit is reused as is
+  // without even parsing the inputs.
+  std::string cacheKey{};
+  if (isCompileCacheEnabled(*context, args)) {
+    CompileCache::KeyBuilder cacheKeyBuilder{};
+    cacheKeyBuilder.addCommandLine(args, {"out", "compile-cache", "j"});
+    for (const auto &entry : fileBufs) {
+      cacheKeyBuilder.add(entry.first);
+      for (const auto &fileAndMap : entry.second) {
+        cacheKeyBuilder.add(fileAndMap.file->getBufferIdentifier());
+        cacheKeyBuilder.add(fileAndMap.file->getBuffer());
+        if (fileAndMap.sourceMap)
+          cacheKeyBuilder.add(fileAndMap.sourceMap->getBuffer());
+      }
+    }
+    cacheKey = cacheKeyBuilder.finish();
+    if (auto cached = CompileCache{cl::CompileCacheDir}.lookup(cacheKey)) {
+      OutputStream fileOS{llvh::outs()};
+      if (!cl::BytecodeOutputFilename.empty() &&
+          !fileOS.open(cl::BytecodeOutputFilename, F_None)) {
+        return OutputFileError;
+      }
+      fileOS.os() << cached->getBuffer();
+      if (!fileOS.close())
+        return OutputFileError;
+      return Success;
+    }
+  }
 #ifndef NDEBUG
   if (cl::LexerOnly) {
     unsigned count = 0;
@@ -2159,6 +2224,7 @@ CompileResult processSourceFiles(
 
   genOptions.stripFunctionNames = cl::StripFunctionNames;
   genOptions.reorderRegisters = cl::ReorderRegisters;
+  genOptions.codegenThreads = cl::CodegenThreads;
 
   // If the dump target is None, return bytecode in an executable form.
   if (cl::DumpTarget == Execute) {
@@ -2185,8 +2251,11 @@ CompileResult processSourceFiles(
     if (!base.empty() && !fileOS.open(base, F_None)) {
       return OutputFileError;
     }
+    // When caching, generate into memory so the output can also be stored.
+    std::string output{};
+    llvh::raw_string_ostream outputOS{output};
     auto result = generateBytecodeForSerialization(
-        fileOS.os(),
+        cacheKey.empty() ? fileOS.os() : outputOS,
         M,
         semCtx,
         genOptions,
@@ -2197,6 +2266,12 @@ CompileResult processSourceFiles(
     if (result.status != Success) {
       return result;
     }
+    if (!cacheKey.empty()) {
+      outputOS.flush();
+      fileOS.os() << output;
+      // Failing to populate the cache does not fail the compilation.
+      CompileCache{cl::CompileCacheDir}.store(cacheKey, output);
+    }
     if (!fileOS.close())
       return OutputFileError;
   } else {
@@ -2311,7 +2386,8 @@ OutputFormatKind outputFormatFromCommandLineOptions() {
   return cl::DumpTarget;
 }
 
-CompileResult compileFromCommandLineOptions() {
+CompileResult compileFromCommandLineOptions(
+    llvh::ArrayRef<const char *> args) {
 #if !defined(NDEBUG) || defined(LLVM_ENABLE_STATS)
   if (cl::PrintStats)
     hermes::EnableStatistics();
@@ -2394,7 +2470,7 @@ CompileResult compileFromCommandLineOptions() {
   } else {
     std::shared_ptr<Context> context =
         createContext(std::move(resolutionTable), std::move(segments));
-    return processSourceFiles(context, std::move(fileBufs));
+    return processSourceFiles(context, std::move(fileBufs), args);
   }
 }
 } // namespace driver
@@ -1145,6 +1145,11 @@ bool executeHBCBytecodeImpl(
     runtime->getJITContext().dumpCounters(llvh::errs());
   }
 
+  if (shouldRecordGCStats && options.runtimeConfig.getJITBackground()) {
+    llvh::errs() << "JIT background compile stats:\n";
+    runtime->getJITContext().dumpBackgroundCompileStats(llvh::errs());
+  }
+
 #ifdef HERMESVM_PROFILER_BB
   if (options.basicBlockProfiling) {
     OutputStream profilingFileOS(llvh::errs());
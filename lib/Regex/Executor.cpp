@@ -7,13 +7,18 @@
 
 #include "hermes/Regex/Executor.h"
 #include "hermes/Regex/RegexTraits.h"
+#include "hermes/Support/FastArraySearch.h"
 #include "hermes/Support/OptValue.h"
 
+#include "llvh/ADT/Optional.h"
 #include "llvh/ADT/ScopeExit.h"
 #include "llvh/ADT/SmallVector.h"
 #include "llvh/Support/TrailingObjects.h"
 #include "llvh/Support/raw_ostream.h"
 
+#include <array>
+#include <bitset>
+
 // This file contains the machinery for executing a regexp compiled to bytecode.
 
 namespace hermes {
@@ -22,6 +27,11 @@ namespace regex {
 template <class Traits>
 struct State;
 
+template <class Traits>
+class LinearTimeMatcher;
+template <class Traits>
+class SearchPrefilter;
+
 /// Describes the exit status of a RegEx execution: it either returned
 /// normally or stack overflowed
 enum class ExecutionStatus : uint8_t { RETURNED, STACK_OVERFLOW };
@@ -407,6 +417,9 @@ struct Context {
   /// checking or call depth counter checking.
   StackOverflowGuard overflowGuard_;
 
+  /// If set, used to skip the input positions where a match cannot start.
+  const SearchPrefilter<Traits> *prefilter_ = nullptr;
+
   Context(
       llvh::ArrayRef<uint8_t> bytecodeStream,
       constants::MatchFlagType flags,
@@ -513,6 +526,18 @@ struct Context {
       const CodeUnit *start,
       size_t index,
       size_t lastIndex) const;
+
+  /// \return the index, relative to \p start, of the first position at or
+  /// after \p index where prefilter_ allows a match to start, or \p length
+  /// if there is none. Only the positions that advanceStringIndex visits when
+  /// starting from \p index are considered.
+  size_t skipToPossibleStart(
+      const CodeUnit *start,
+      size_t index,
+      size_t length) const;
+
+  /// The linear-time matcher shares the character matching helpers.
+  friend class LinearTimeMatcher<Traits>;
 };
 
 /// We store loop and captured range data contiguously in a single allocation at
@@ -1060,6 +1085,25 @@ inline size_t Context<Traits>::advanceStringIndex(
   return index + 2;
 }
 
+template <class Traits>
+size_t Context<Traits>::skipToPossibleStart(
+    const CodeUnit *start,
+    size_t index,
+    size_t length) const {
+  for (;;) {
+    size_t found = prefilter_->findStart(start + index, start + length) - start;
+    if (sizeof(CodeUnit) == 1 || LLVM_LIKELY(!syntaxFlags_.unicode) ||
+        found == length || LLVM_LIKELY(!isLowSurrogate(start[found])))
+      return found;
+    // A low surrogate is skipped if it ends a surrogate pair, which depends on
+    // where the pairs start. Walk up to it to find out.
+    while (index < found)
+      index = advanceStringIndex(start, index, length);
+    if (index == found)
+      return found;
+  }
+}
+
 template <class Traits>
 auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
     -> ExecutorResult<const CodeUnit *> {
@@ -1115,6 +1159,12 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
 
   for (size_t locIndex = 0; locIndex < locsToCheckCount;
        locIndex = advanceStringIndex(startLoc, locIndex, charsToRight)) {
+    if (prefilter_ && !onlyAtStart) {
+      // A match consumes at least one code unit, so none starts at the end.
+      locIndex = skipToPossibleStart(startLoc, locIndex, charsToRight);
+      if (locIndex == charsToRight)
+        break;
+    }
     const CodeUnit *potentialMatchLocation = startLoc + locIndex;
     c.setCurrentPointer(potentialMatchLocation);
     s->ip_ = startIp;
@@ -1623,12 +1673,1215 @@ auto Context<Traits>::match(State<Traits> *s, bool onlyAtStart)
   return nullptr;
 }
 
+/// \return the width in bytes of the instruction \p insn, including any
+/// trailing data.
+static uint32_t insnWidth(const Insn *insn) {
+  switch (insn->opcode) {
+    case Opcode::MatchNChar8:
+      return llvh::cast<MatchNChar8Insn>(insn)->totalWidth();
+    case Opcode::MatchNCharICase8:
+      return llvh::cast<MatchNCharICase8Insn>(insn)->totalWidth();
+    case Opcode::Bracket:
+    case Opcode::BracketICase:
+    case Opcode::U16Bracket:
+    case Opcode::U16BracketICase:
+      return static_cast<const BracketInsn *>(insn)->totalWidth();
+    default:
+      break;
+  }
+  switch (insn->opcode) {
+#define REOP(Code)    \
+  case Opcode::Code: \
+    return sizeof(Code##Insn);
+#include "hermes/Regex/RegexOpcodes.def"
+  }
+  llvm_unreachable("Invalid opcode");
+}
+
+/// SearchPrefilter finds the input positions where a match could start, using
+/// the set of code units that a match can begin with. These are searched for
+/// with FastArraySearch, so that the executor skips the positions where the
+/// match would fail right away instead of running the matcher at each one.
+/// If the regex starts with a literal string, the rest of it is checked too.
+/// The prefilter is built at the start of each search, from the instructions
+/// that can run before the first code unit is consumed.
+template <class Traits>
+class SearchPrefilter {
+  using CodeUnit = typename Traits::CodeUnit;
+
+  /// The unsigned type used to search for code units.
+  using SearchUnit =
+      std::conditional_t<sizeof(CodeUnit) == 1, uint8_t, uint16_t>;
+
+ public:
+  /// Inputs shorter than this are searched without a prefilter.
+  static constexpr uint32_t kMinInputLength = 16;
+
+  /// Build the prefilter for the regex compiled to \p bytecode.
+  /// \return None if no position can be ruled out, for example because the
+  ///   regex can match the empty string.
+  static llvh::Optional<SearchPrefilter> analyze(
+      llvh::ArrayRef<uint8_t> bytecode);
+
+  /// \return the first position in [from, end) at which a match could start,
+  ///   or \p end if there is none.
+  const CodeUnit *findStart(const CodeUnit *from, const CodeUnit *end) const;
+
+ private:
+  /// The maximum number of instructions that the analysis visits.
+  static constexpr unsigned kMaxInsnsVisited = 64;
+
+  /// Add the code units that a path starting at \p ip in \p bytecode can
+  /// consume first. \p budget is decremented for every instruction visited.
+  /// \return false if the path can reach Goal without consuming anything, or
+  ///   if the analysis gave up.
+  bool addFirstUnits(const uint8_t *bytecode, uint32_t ip, unsigned &budget);
+
+  /// Add the code unit \p cu.
+  void addUnit(char16_t cu);
+
+  /// Add the code units that can start a match of the bracket \p insn.
+  void addBracket(const BracketInsn *insn);
+
+  /// \return the first position in [from, end) holding one of the code units.
+  const CodeUnit *findUnit(const CodeUnit *from, const CodeUnit *end) const;
+
+  /// \return the code units below 256 that belong to the character class
+  /// \p type.
+  static const std::bitset<256> &classUnits(CharacterClass::Type type);
+
+  /// Whether the regex is unicode, which affects case folding.
+  bool unicode_;
+
+  /// If the set of code units is small, its members.
+  llvh::SmallVector<char16_t, kMaxSearchAnyTargets> units_{};
+
+  /// Whether units_ lists all the members.
+  bool unitsComplete_ = true;
+
+  /// The members below 256.
+  std::bitset<256> lowUnits_{};
+
+  /// Whether there are members >= 256.
+  bool highUnits_ = false;
+
+  /// Whether a path containing a branch was analyzed.
+  bool branched_ = false;
+
+  /// If units_ is complete, the members that can appear in the input, passed
+  /// to searchAny.
+  llvh::SmallVector<SearchUnit, kMaxSearchAnyTargets> targets_{};
+
+  /// The code units that must follow the first one, if the regex starts with
+  /// a literal string.
+  llvh::SmallVector<char, 16> literalRest_{};
+};
+
+template <class Traits>
+const std::bitset<256> &SearchPrefilter<Traits>::classUnits(
+    CharacterClass::Type type) {
+  static const CharacterClass::Type kTypes[] = {
+      CharacterClass::Digits, CharacterClass::Spaces, CharacterClass::Words};
+  static const auto kUnits = [] {
+    // The classes are the same for both traits up to 127, and ASCII input has
+    // nothing above that.
+    UTF16RegexTraits traits;
+    std::array<std::bitset<256>, 3> units;
+    for (size_t i = 0; i < 3; ++i) {
+      for (uint32_t c = 0; c < 256; ++c)
+        units[i][c] = traits.characterHasType(c, kTypes[i]);
+    }
+    return units;
+  }();
+  return kUnits[std::find(kTypes, kTypes + 3, type) - kTypes];
+}
+
+template <class Traits>
+void SearchPrefilter<Traits>::addUnit(char16_t cu) {
+  if (cu < 256)
+    lowUnits_.set(cu);
+  else
+    highUnits_ = true;
+  if (!unitsComplete_ ||
+      std::find(units_.begin(), units_.end(), cu) != units_.end())
+    return;
+  if (units_.size() < kMaxSearchAnyTargets)
+    units_.push_back(cu);
+  else
+    unitsComplete_ = false;
+}
+
+template <class Traits>
+void SearchPrefilter<Traits>::addBracket(const BracketInsn *insn) {
+  const auto *ranges = reinterpret_cast<const BracketRange32 *>(insn + 1);
+  std::bitset<256> units;
+  bool high = false;
+  for (uint32_t i = 0; i < insn->rangeCount; ++i) {
+    for (uint32_t c = ranges[i].start; c <= ranges[i].end && c < 256; ++c)
+      units.set(c);
+    high |= ranges[i].end >= 256;
+  }
+  for (auto charClass :
+       {CharacterClass::Digits,
+        CharacterClass::Spaces,
+        CharacterClass::Words}) {
+    if (insn->positiveCharClasses & charClass) {
+      units |= classUnits(charClass);
+      high |= charClass == CharacterClass::Spaces;
+    }
+    if (insn->negativeCharClasses & charClass) {
+      units |= ~classUnits(charClass);
+      high = true;
+    }
+  }
+  if (insn->negate) {
+    units.flip();
+    high = true;
+  }
+
+  // Keep small sets exact, so that they can be searched for with SIMD.
+  if (!high && units.count() <= kMaxSearchAnyTargets) {
+    for (uint32_t c = 0; c < 256; ++c) {
+      if (units[c])
+        addUnit(c);
+    }
+    return;
+  }
+  lowUnits_ |= units;
+  highUnits_ |= high;
+  unitsComplete_ = false;
+}
+
+template <class Traits>
+bool SearchPrefilter<Traits>::addFirstUnits(
+    const uint8_t *bytecode,
+    uint32_t ip,
+    unsigned &budget) {
+  for (;;) {
+    if (budget == 0)
+      return false;
+    --budget;
+    const Insn *base = reinterpret_cast<const Insn *>(&bytecode[ip]);
+    switch (base->opcode) {
+      // Assertions don't consume anything, and only narrow down the matches.
+      case Opcode::LeftAnchor:
+      case Opcode::LeftAnchorMultiline:
+      case Opcode::RightAnchor:
+      case Opcode::RightAnchorMultiline:
+      case Opcode::WordBoundary:
+      case Opcode::WordBoundaryICase:
+      case Opcode::BeginMarkedSubexpression:
+      case Opcode::EndMarkedSubexpression:
+        ip += insnWidth(base);
+        break;
+      case Opcode::Lookaround:
+        ip = llvh::cast<LookaroundInsn>(base)->continuation;
+        break;
+      case Opcode::Jump32:
+        ip = llvh::cast<Jump32Insn>(base)->target;
+        break;
+
+      case Opcode::Alternation:
+        branched_ = true;
+        if (!addFirstUnits(bytecode, ip + sizeof(AlternationInsn), budget))
+          return false;
+        ip = llvh::cast<AlternationInsn>(base)->secondaryBranch;
+        break;
+      case Opcode::BeginLoop: {
+        // The body may be skipped, or, if it matches the empty string, left
+        // through its EndLoop.
+        const auto *loop = llvh::cast<BeginLoopInsn>(base);
+        branched_ = true;
+        if (loop->min == 0 &&
+            !addFirstUnits(bytecode, loop->notTakenTarget, budget))
+          return false;
+        ip += sizeof(BeginLoopInsn);
+        break;
+      }
+      case Opcode::EndLoop:
+        ip = llvh::cast<BeginLoopInsn>(
+                 reinterpret_cast<const Insn *>(
+                     &bytecode[llvh::cast<EndLoopInsn>(base)->target]))
+                 ->notTakenTarget;
+        break;
+      case Opcode::BeginSimpleLoop:
+        branched_ = true;
+        if (!addFirstUnits(
+                bytecode,
+                llvh::cast<BeginSimpleLoopInsn>(base)->notTakenTarget,
+                budget))
+          return false;
+        ip += sizeof(BeginSimpleLoopInsn);
+        break;
+      case Opcode::EndSimpleLoop:
+        ip = llvh::cast<BeginSimpleLoopInsn>(
+                 reinterpret_cast<const Insn *>(
+                     &bytecode[llvh::cast<EndSimpleLoopInsn>(base)->target]))
+                 ->notTakenTarget;
+        break;
+      case Opcode::Width1Loop: {
+        const auto *loop = llvh::cast<Width1LoopInsn>(base);
+        branched_ = true;
+        if (loop->min == 0 &&
+            !addFirstUnits(bytecode, loop->notTakenTarget, budget))
+          return false;
+        ip += sizeof(Width1LoopInsn);
+        break;
+      }
+
+      case Opcode::MatchChar8:
+        addUnit(static_cast<uint8_t>(llvh::cast<MatchChar8Insn>(base)->c));
+        return true;
+      case Opcode::MatchChar16:
+        addUnit(llvh::cast<MatchChar16Insn>(base)->c);
+        return true;
+      case Opcode::U16MatchChar32: {
+        uint32_t c = llvh::cast<U16MatchChar32Insn>(base)->c;
+        addUnit(c < 0x10000 ? c : 0xD800 + ((c - 0x10000) >> 10));
+        return true;
+      }
+      case Opcode::MatchNChar8: {
+        const auto *insn = llvh::cast<MatchNChar8Insn>(base);
+        const char *chars = reinterpret_cast<const char *>(insn + 1);
+        addUnit(static_cast<uint8_t>(chars[0]));
+        if (!branched_)
+          literalRest_.assign(chars + 1, chars + insn->charCount);
+        return true;
+      }
+      case Opcode::MatchCharICase8:
+      case Opcode::MatchNCharICase8: {
+        char16_t c = base->opcode == Opcode::MatchCharICase8
+            ? static_cast<uint8_t>(llvh::cast<MatchCharICase8Insn>(base)->c)
+            : *reinterpret_cast<const uint8_t *>(
+                  llvh::cast<MatchNCharICase8Insn>(base) + 1);
+        addUnit(c);
+        if (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z')) {
+          addUnit(c ^ 0x20);
+          // These are the only non-ASCII characters that case fold to ASCII.
+          if (unicode_ && (c == 'k' || c == 'K'))
+            addUnit(0x212A);
+          if (unicode_ && (c == 's' || c == 'S'))
+            addUnit(0x017F);
+        }
+        return true;
+      }
+      case Opcode::Bracket:
+      case Opcode::U16Bracket:
+        // A code point outside the BMP starts with a high surrogate, which is
+        // included in the units >= 256.
+        addBracket(static_cast<const BracketInsn *>(base));
+        return true;
+
+      default:
+        // Goal, or an instruction that can match almost anything.
+        return false;
+    }
+  }
+}
+
+template <class Traits>
+auto SearchPrefilter<Traits>::analyze(llvh::ArrayRef<uint8_t> bytecode)
+    -> llvh::Optional<SearchPrefilter> {
+  auto header = reinterpret_cast<const RegexBytecodeHeader *>(bytecode.data());
+  SearchPrefilter prefilter;
+  prefilter.unicode_ = SyntaxFlags::fromByte(header->syntaxFlags).unicode;
+  unsigned budget = kMaxInsnsVisited;
+  if (!prefilter.addFirstUnits(
+          &bytecode[sizeof(RegexBytecodeHeader)], 0, budget))
+    return llvh::None;
+  if (prefilter.unitsComplete_) {
+    for (char16_t cu : prefilter.units_) {
+      // ASCII input only has code units below 128.
+      if (sizeof(CodeUnit) == 2 || cu < 128)
+        prefilter.targets_.push_back(cu);
+    }
+  } else if (prefilter.lowUnits_.all()) {
+    return llvh::None;
+  }
+  return prefilter;
+}
+
+template <class Traits>
+auto SearchPrefilter<Traits>::findUnit(
+    const CodeUnit *from,
+    const CodeUnit *end) const -> const CodeUnit * {
+  if (unitsComplete_) {
+    if (targets_.empty())
+      return end;
+    llvh::ArrayRef<SearchUnit> arr{
+        reinterpret_cast<const SearchUnit *>(from), size_t(end - from)};
+    int64_t found;
+    if constexpr (sizeof(CodeUnit) == 1)
+      found = searchAnyU8(arr, 0, arr.size(), targets_);
+    else
+      found = searchAnyU16(arr, 0, arr.size(), targets_);
+    return found < 0 ? end : from + found;
+  }
+  for (; from < end; ++from) {
+    SearchUnit cu = *from;
+    if (cu < 256 ? lowUnits_[cu] : highUnits_)
+      return from;
+  }
+  return end;
+}
+
+template <class Traits>
+auto SearchPrefilter<Traits>::findStart(
+    const CodeUnit *from,
+    const CodeUnit *end) const -> const CodeUnit * {
+  for (;;) {
+    const CodeUnit *found = findUnit(from, end);
+    if (found == end || literalRest_.empty())
+      return found;
+    // If the literal doesn't fit here, it doesn't fit at any later position.
+    if ((size_t)(end - found - 1) < literalRest_.size())
+      return end;
+    if (std::equal(literalRest_.begin(), literalRest_.end(), found + 1))
+      return found;
+    from = found + 1;
+  }
+}
+
+/// LinearTimeProgram is the analysis of a regex that the linear-time matcher
+/// needs. The matcher simulates all backtracking paths in lockstep, one input
+/// position at a time, and drops a path when another path with higher
+/// priority has already reached the same state at the same position. This
+/// gives the same result as backtracking only if the future of a path is
+/// determined by its state, which rules out backreferences and lookarounds.
+///
+/// The state of a path is its instruction, and for every loop enclosing that
+/// instruction: the iteration count (saturated for unbounded loops, since
+/// only comparisons against min are made), and whether the iteration was
+/// entered at the current position (for the empty iteration check). States
+/// are numbered densely, so that the matcher can track them in a flat array.
+class LinearTimeProgram {
+ public:
+  /// The maximum number of states, counting every character of instructions
+  /// that match several as a state of its own, since a path can wait at each
+  /// of them. This bounds the work done per input character.
+  static constexpr uint32_t kMaxStates = 1u << 16;
+
+  /// Sentinel for "no loop".
+  static constexpr uint32_t kNoLoop = UINT32_MAX;
+
+  /// Analyze the regex compiled to \p bytecode.
+  /// \return None if it cannot be matched in linear time.
+  static llvh::Optional<LinearTimeProgram> analyze(
+      llvh::ArrayRef<uint8_t> bytecode);
+
+  /// \return the number of states.
+  uint32_t numStates() const {
+    return numStates_;
+  }
+
+  /// \return the loops enclosing the instruction at \p ip which have an
+  /// iteration count, outermost first. The elements are the offsets of the
+  /// loop instructions.
+  /// \return the number of bytes of malloc memory used by the program.
+  size_t getMemorySize() const {
+    return insnIndex_.capacity() * sizeof(uint32_t) +
+        insns_.capacity() * sizeof(InsnInfo) +
+        loopNests_.capacity() * sizeof(uint32_t);
+  }
+
+  llvh::ArrayRef<uint32_t> enclosingLoops(uint32_t ip) const {
+    const InsnInfo &info = insns_[insnIndex_[ip]];
+    return llvh::makeArrayRef(loopNests_).slice(
+        info.nestBegin, info.nestEnd - info.nestBegin);
+  }
+
+  /// \return the index of the first state of the instruction at \p ip.
+  uint32_t stateBase(uint32_t ip) const {
+    return insns_[insnIndex_[ip]].stateBase;
+  }
+
+  /// \return the offset of the Width1Loop whose body is the instruction at
+  /// \p ip, or kNoLoop.
+  uint32_t width1LoopOfBody(uint32_t ip) const {
+    return insns_[insnIndex_[ip]].width1Loop;
+  }
+
+  /// \return the number of values the state of a path records for the loop
+  /// \p insn, or 0 if it records nothing.
+  static uint32_t loopRadix(const Insn *insn) {
+    auto countRadix = [](uint32_t min, uint32_t max) -> uint64_t {
+      return max == UINT32_MAX ? (uint64_t)min + 2 : (uint64_t)max + 1;
+    };
+    uint64_t radix = 0;
+    if (const auto *loop = llvh::dyn_cast<BeginLoopInsn>(insn))
+      radix = 2 * countRadix(loop->min, loop->max);
+    else if (const auto *loop = llvh::dyn_cast<Width1LoopInsn>(insn))
+      radix = countRadix(loop->min, loop->max);
+    return radix > kMaxStates ? kMaxStates + 1 : (uint32_t)radix;
+  }
+
+ private:
+  struct InsnInfo {
+    /// Index of the first state of this instruction.
+    uint32_t stateBase;
+    /// Range of loopNests_ holding the enclosing loops.
+    uint32_t nestBegin;
+    uint32_t nestEnd;
+    /// The Width1Loop this instruction is the body of, or kNoLoop.
+    uint32_t width1Loop;
+  };
+
+  /// Map from instruction offset to index in insns_.
+  std::vector<uint32_t> insnIndex_;
+
+  /// Information about each instruction, in bytecode order.
+  std::vector<InsnInfo> insns_;
+
+  /// The loops enclosing each instruction, concatenated.
+  std::vector<uint32_t> loopNests_;
+
+  /// Total number of states.
+  uint32_t numStates_ = 0;
+};
+
+llvh::Optional<LinearTimeProgram> LinearTimeProgram::analyze(
+    llvh::ArrayRef<uint8_t> bytecode) {
+  const uint8_t *insns = bytecode.data() + sizeof(RegexBytecodeHeader);
+  const uint32_t size = bytecode.size() - sizeof(RegexBytecodeHeader);
+
+  LinearTimeProgram program;
+  program.insnIndex_.resize(size);
+
+  // The loops whose body contains the current instruction, along with the
+  // end of their body. Loop bodies are contiguous and properly nested.
+  llvh::SmallVector<std::pair<uint32_t, uint32_t>, 4> openLoops;
+  uint32_t width1Body = kNoLoop, width1Loop = kNoLoop;
+  // The number of states including those within multi-character matches.
+  uint64_t waitStates = 0;
+  for (uint32_t ip = 0; ip < size;) {
+    const Insn *base = reinterpret_cast<const Insn *>(insns + ip);
+    while (!openLoops.empty() && openLoops.back().second <= ip)
+      openLoops.pop_back();
+
+    InsnInfo info;
+    info.stateBase = program.numStates_;
+    info.nestBegin = program.loopNests_.size();
+    info.width1Loop = ip == width1Body ? width1Loop : kNoLoop;
+    uint64_t states = 1;
+    for (const auto &open : openLoops) {
+      uint32_t radix =
+          loopRadix(reinterpret_cast<const Insn *>(insns + open.first));
+      if (radix == 0)
+        continue;
+      program.loopNests_.push_back(open.first);
+      states = std::min<uint64_t>(states * radix, kMaxStates + 1);
+    }
+    info.nestEnd = program.loopNests_.size();
+    program.numStates_ += states;
+    uint32_t charCount = 1;
+    if (const auto *insn = llvh::dyn_cast<MatchNChar8Insn>(base))
+      charCount = insn->charCount;
+    else if (const auto *insn = llvh::dyn_cast<MatchNCharICase8Insn>(base))
+      charCount = insn->charCount;
+    waitStates += states * charCount;
+    if (waitStates > kMaxStates)
+      return llvh::None;
+    program.insnIndex_[ip] = program.insns_.size();
+    program.insns_.push_back(info);
+
+    switch (base->opcode) {
+      case Opcode::BackRef:
+      case Opcode::BackRefICase:
+      case Opcode::Lookaround:
+        // The result of these depends on more than the state of a path.
+        return llvh::None;
+      case Opcode::BeginLoop:
+        openLoops.push_back(
+            {ip, llvh::cast<BeginLoopInsn>(base)->notTakenTarget});
+        break;
+      case Opcode::BeginSimpleLoop:
+        openLoops.push_back(
+            {ip, llvh::cast<BeginSimpleLoopInsn>(base)->notTakenTarget});
+        break;
+      case Opcode::Width1Loop:
+        openLoops.push_back(
+            {ip, llvh::cast<Width1LoopInsn>(base)->notTakenTarget});
+        width1Loop = ip;
+        width1Body = ip + sizeof(Width1LoopInsn);
+        break;
+      default:
+        break;
+    }
+    ip += insnWidth(base);
+  }
+  return program;
+}
+
+/// LinearTimeMatcher searches for a regex in time linear in the length of
+/// the input, by simulating all backtracking paths in lockstep as described
+/// in LinearTimeProgram. Paths are kept in priority order, which is the
+/// order in which the backtracking executor would explore them, so the
+/// first path to reach Goal determines the result exactly as it would there.
+template <class Traits>
+class LinearTimeMatcher {
+  using CodeUnit = typename Traits::CodeUnit;
+  using CodePoint = typename Traits::CodePoint;
+
+  /// A path waiting at an instruction that consumes input, or at Goal. If
+  /// pending is nonzero, the path has already matched an instruction that
+  /// consumes several code units, and skips pending more before resuming at
+  /// ip.
+  struct Thread {
+    uint32_t ip;
+    uint32_t pending;
+    uint32_t regs;
+  };
+
+  /// What to do when a Job is taken from the stack.
+  enum class JobKind : uint8_t {
+    /// Run from ip.
+    Visit,
+    /// Enter the body of the BeginLoop at ip, then run it.
+    EnterLoopBody,
+    /// Run the Width1Loop at ip after an iteration.
+    ResumeWidth1Loop,
+  };
+
+  /// A path to be run until it waits for input.
+  struct Job {
+    uint32_t ip;
+    uint32_t regs;
+    JobKind kind;
+  };
+
+  /// Returned by the loop helpers when the path fails.
+  static constexpr uint32_t kFail = UINT32_MAX;
+
+  Context<Traits> &ctx_;
+  const LinearTimeProgram &program_;
+
+  /// The instructions, following the header.
+  const uint8_t *const bytecode_;
+
+  /// Number of registers per path: the match start, the captured ranges and
+  /// the loop datas.
+  const uint32_t numRegs_;
+
+  /// Storage for the registers of all paths, and the free blocks in it.
+  std::vector<uint32_t> pool_{};
+  llvh::SmallVector<uint32_t, 16> freeRegs_{};
+
+  /// For each state, one more than the last position it was reached at.
+  std::vector<uint32_t> visited_;
+
+  /// Paths waiting at the current and the next position.
+  std::vector<Thread> current_{};
+  std::vector<Thread> next_{};
+
+  /// Pending lower-priority paths, explored last-in first-out.
+  llvh::SmallVector<Job, 16> jobs_{};
+
+  /// Scratch state for the helpers that take a State.
+  State<Traits> probe_;
+
+ public:
+  LinearTimeMatcher(Context<Traits> &ctx, const LinearTimeProgram &program)
+      : ctx_(ctx),
+        program_(program),
+        bytecode_(&ctx.bytecodeStream_[sizeof(RegexBytecodeHeader)]),
+        numRegs_(1 + 2 * ctx.markedCount_ + 2 * ctx.loopCount_),
+        visited_(program.numStates(), 0),
+        probe_(Cursor<Traits>{ctx.first_, ctx.first_, ctx.last_, true}, 0, 0) {
+  }
+
+  /// Search starting at the cursor of \p s, like Context::match().
+  /// \return a pointer to the start of the match, or nullptr if there is
+  /// none. On success, populates the captured ranges and cursor of \p s.
+  const CodeUnit *match(State<Traits> *s, bool onlyAtStart);
+
+ private:
+  const Insn *insnAt(uint32_t ip) const {
+    return reinterpret_cast<const Insn *>(bytecode_ + ip);
+  }
+
+  Cursor<Traits> cursorAt(uint32_t pos) const {
+    return Cursor<Traits>{ctx_.first_, ctx_.first_ + pos, ctx_.last_, true};
+  }
+
+  uint32_t &reg(uint32_t regs, uint32_t idx) {
+    return pool_[regs + idx];
+  }
+  uint32_t &captureStart(uint32_t regs, uint32_t mexp) {
+    return reg(regs, 1 + 2 * mexp);
+  }
+  uint32_t &captureEnd(uint32_t regs, uint32_t mexp) {
+    return reg(regs, 2 + 2 * mexp);
+  }
+  uint32_t &loopIterations(uint32_t regs, uint32_t loopId) {
+    return reg(regs, 1 + 2 * ctx_.markedCount_ + 2 * loopId);
+  }
+  uint32_t &loopEntryPosition(uint32_t regs, uint32_t loopId) {
+    return reg(regs, 2 + 2 * ctx_.markedCount_ + 2 * loopId);
+  }
+
+  /// \return a new register block, whose contents are unspecified.
+  uint32_t allocRegs() {
+    if (!freeRegs_.empty())
+      return freeRegs_.pop_back_val();
+    uint32_t regs = pool_.size();
+    pool_.resize(pool_.size() + numRegs_);
+    return regs;
+  }
+
+  /// \return a new register block holding a copy of \p regs.
+  uint32_t copyRegs(uint32_t regs) {
+    uint32_t copy = allocRegs();
+    std::copy_n(&pool_[regs], numRegs_, &pool_[copy]);
+    return copy;
+  }
+
+  void releaseRegs(uint32_t regs) {
+    freeRegs_.push_back(regs);
+  }
+
+  /// Record that the path with registers \p regs is at the instruction \p ip
+  /// at position \p pos. \return false if a path with higher priority has
+  /// already been in the same state at this position.
+  bool markVisited(uint32_t ip, uint32_t regs, uint32_t pos);
+
+  /// Run \p job and every lower-priority path it forks at position \p pos,
+  /// adding the paths that wait for input to \p list in priority order.
+  void addThreads(std::vector<Thread> &list, Job job, uint32_t pos);
+
+  /// Run the BeginLoop \p loop at \p ip for the path \p regs, after an
+  /// iteration or on entry. \return the next instruction, or kFail.
+  uint32_t
+  runLoop(const BeginLoopInsn *loop, uint32_t ip, uint32_t regs, uint32_t pos);
+
+  /// Prepare the path \p regs to run an iteration of \p loop.
+  void enterLoopBody(const BeginLoopInsn *loop, uint32_t regs, uint32_t pos);
+
+  /// Run the Width1Loop \p loop at \p ip for the path \p regs.
+  /// \return the next instruction.
+  uint32_t
+  runWidth1Loop(const Width1LoopInsn *loop, uint32_t ip, uint32_t regs);
+
+  /// Match the consuming instruction \p insn at position \p pos.
+  /// \return the number of code units matched, or 0 if it does not match.
+  uint32_t consume(const Insn *insn, uint32_t pos);
+};
+
+template <class Traits>
+bool LinearTimeMatcher<Traits>::markVisited(
+    uint32_t ip,
+    uint32_t regs,
+    uint32_t pos) {
+  uint32_t state = 0;
+  for (uint32_t loopIp : program_.enclosingLoops(ip)) {
+    const Insn *insn = insnAt(loopIp);
+    uint32_t radix = LinearTimeProgram::loopRadix(insn);
+    uint32_t value;
+    if (const auto *loop = llvh::dyn_cast<BeginLoopInsn>(insn)) {
+      uint32_t iterations = loopIterations(regs, loop->loopId);
+      if (loop->max == UINT32_MAX)
+        iterations = std::min(iterations, loop->min + 1);
+      value = 2 * iterations +
+          (loopEntryPosition(regs, loop->loopId) == pos ? 1 : 0);
+    } else {
+      const auto *w1 = llvh::cast<Width1LoopInsn>(insn);
+      value = loopIterations(regs, w1->loopId);
+      if (w1->max == UINT32_MAX)
+        value = std::min(value, w1->min + 1);
+    }
+    assert(value < radix && "Loop state out of range");
+    state = state * radix + value;
+  }
+  uint32_t &stamp = visited_[program_.stateBase(ip) + state];
+  if (stamp == pos + 1)
+    return false;
+  stamp = pos + 1;
+  return true;
+}
+
+template <class Traits>
+void LinearTimeMatcher<Traits>::enterLoopBody(
+    const BeginLoopInsn *loop,
+    uint32_t regs,
+    uint32_t pos) {
+  ++loopIterations(regs, loop->loopId);
+  loopEntryPosition(regs, loop->loopId) = pos;
+  for (uint32_t mexp = loop->mexpBegin; mexp != loop->mexpEnd; mexp++) {
+    captureStart(regs, mexp) = kNotMatched;
+    captureEnd(regs, mexp) = kNotMatched;
+  }
+}
+
+template <class Traits>
+uint32_t LinearTimeMatcher<Traits>::runLoop(
+    const BeginLoopInsn *loop,
+    uint32_t ip,
+    uint32_t regs,
+    uint32_t pos) {
+  // This mirrors runLoop in Context::match(), with the backtracking entries
+  // replaced by lower-priority jobs.
+  uint32_t iteration = loopIterations(regs, loop->loopId);
+  const uint32_t loopTakenIp = ip + sizeof(BeginLoopInsn);
+  if (iteration > loop->min && loopEntryPosition(regs, loop->loopId) == pos)
+    return kFail;
+  if (iteration < loop->min) {
+    enterLoopBody(loop, regs, pos);
+    return loopTakenIp;
+  }
+  if (iteration == loop->max)
+    return loop->notTakenTarget;
+  if (!loop->greedy) {
+    jobs_.push_back({ip, copyRegs(regs), JobKind::EnterLoopBody});
+    return loop->notTakenTarget;
+  }
+  jobs_.push_back({loop->notTakenTarget, copyRegs(regs), JobKind::Visit});
+  enterLoopBody(loop, regs, pos);
+  return loopTakenIp;
+}
+
+template <class Traits>
+uint32_t LinearTimeMatcher<Traits>::runWidth1Loop(
+    const Width1LoopInsn *loop,
+    uint32_t ip,
+    uint32_t regs) {
+  uint32_t iteration = loopIterations(regs, loop->loopId);
+  const uint32_t bodyIp = ip + sizeof(Width1LoopInsn);
+  if (iteration < loop->min)
+    return bodyIp;
+  if (iteration == loop->max)
+    return loop->notTakenTarget;
+  if (loop->greedy) {
+    jobs_.push_back({loop->notTakenTarget, copyRegs(regs), JobKind::Visit});
+    return bodyIp;
+  }
+  jobs_.push_back({bodyIp, copyRegs(regs), JobKind::Visit});
+  return loop->notTakenTarget;
+}
+
+template <class Traits>
+void LinearTimeMatcher<Traits>::addThreads(
+    std::vector<Thread> &list,
+    Job job,
+    uint32_t pos) {
+  const Cursor<Traits> c = cursorAt(pos);
+  probe_.cursor_ = c;
+  jobs_.push_back(job);
+  while (!jobs_.empty()) {
+    Job j = jobs_.pop_back_val();
+    uint32_t ip = j.ip;
+    const uint32_t regs = j.regs;
+    if (j.kind == JobKind::EnterLoopBody) {
+      enterLoopBody(llvh::cast<BeginLoopInsn>(insnAt(ip)), regs, pos);
+      ip += sizeof(BeginLoopInsn);
+    } else if (j.kind == JobKind::ResumeWidth1Loop) {
+      ip = runWidth1Loop(llvh::cast<Width1LoopInsn>(insnAt(ip)), ip, regs);
+    }
+
+    // Follow the path until it fails, or waits for input.
+    for (;;) {
+      if (!markVisited(ip, regs, pos)) {
+        releaseRegs(regs);
+        break;
+      }
+      const Insn *base = insnAt(ip);
+      bool matched = true, waiting = false;
+      switch (base->opcode) {
+        case Opcode::Goal:
+        case Opcode::MatchAny:
+        case Opcode::U16MatchAny:
+        case Opcode::MatchAnyButNewline:
+        case Opcode::U16MatchAnyButNewline:
+        case Opcode::MatchChar8:
+        case Opcode::MatchChar16:
+        case Opcode::U16MatchChar32:
+        case Opcode::MatchNChar8:
+        case Opcode::MatchNCharICase8:
+        case Opcode::MatchCharICase8:
+        case Opcode::MatchCharICase16:
+        case Opcode::U16MatchCharICase32:
+        case Opcode::Bracket:
+        case Opcode::BracketICase:
+        case Opcode::U16Bracket:
+        case Opcode::U16BracketICase:
+          list.push_back({ip, 0, regs});
+          waiting = true;
+          break;
+
+        case Opcode::LeftAnchor:
+          matched = matchesLeftAnchor(ctx_, probe_, false);
+          ip += sizeof(LeftAnchorInsn);
+          break;
+
+        case Opcode::LeftAnchorMultiline:
+          matched = matchesLeftAnchor(ctx_, probe_, true);
+          ip += sizeof(LeftAnchorMultilineInsn);
+          break;
+
+        case Opcode::RightAnchor:
+          matched = matchesRightAnchor(ctx_, probe_, false);
+          ip += sizeof(RightAnchorInsn);
+          break;
+
+        case Opcode::RightAnchorMultiline:
+          matched = matchesRightAnchor(ctx_, probe_, true);
+          ip += sizeof(RightAnchorMultilineInsn);
+          break;
+
+        case Opcode::Alternation: {
+          const AlternationInsn *alt = llvh::cast<AlternationInsn>(base);
+          bool primaryViable =
+              c.satisfiesConstraints(ctx_.flags_, alt->primaryConstraints);
+          bool secondaryViable =
+              c.satisfiesConstraints(ctx_.flags_, alt->secondaryConstraints);
+          if (primaryViable && secondaryViable) {
+            jobs_.push_back(
+                {alt->secondaryBranch, copyRegs(regs), JobKind::Visit});
+            ip += sizeof(AlternationInsn);
+          } else if (primaryViable) {
+            ip += sizeof(AlternationInsn);
+          } else if (secondaryViable) {
+            ip = alt->secondaryBranch;
+          } else {
+            matched = false;
+          }
+          break;
+        }
+
+        case Opcode::Jump32:
+          ip = llvh::cast<Jump32Insn>(base)->target;
+          break;
+
+        case Opcode::WordBoundary: {
+          const auto *insn = llvh::cast<WordBoundaryInsn>(base);
+          matched = matchesWordBoundary(c, insn->invert, [&](auto ch) {
+            return ctx_.traits_.characterHasType(ch, CharacterClass::Words);
+          });
+          ip += sizeof(WordBoundaryInsn);
+          break;
+        }
+
+        case Opcode::WordBoundaryICase: {
+          const auto *insn = llvh::cast<WordBoundaryICaseInsn>(base);
+          bool unicode = ctx_.syntaxFlags_.unicode;
+          matched = matchesWordBoundary(c, insn->invert, [&](auto ch) {
+            return ctx_.traits_.characterHasType(ch, CharacterClass::Words) ||
+                ctx_.traits_.characterHasType(
+                    Traits::canonicalize(ch, unicode), CharacterClass::Words);
+          });
+          ip += sizeof(WordBoundaryICaseInsn);
+          break;
+        }
+
+        case Opcode::BeginMarkedSubexpression:
+          captureStart(
+              regs, llvh::cast<BeginMarkedSubexpressionInsn>(base)->mexp) =
+              pos;
+          ip += sizeof(BeginMarkedSubexpressionInsn);
+          break;
+
+        case Opcode::EndMarkedSubexpression:
+          captureEnd(regs, llvh::cast<EndMarkedSubexpressionInsn>(base)->mexp) =
+              pos;
+          ip += sizeof(EndMarkedSubexpressionInsn);
+          break;
+
+        case Opcode::BeginLoop: {
+          const auto *loop = llvh::cast<BeginLoopInsn>(base);
+          loopIterations(regs, loop->loopId) = 0;
+          if (!c.satisfiesConstraints(ctx_.flags_, loop->loopeeConstraints)) {
+            matched = loop->min == 0;
+            ip = loop->notTakenTarget;
+          } else {
+            ip = runLoop(loop, ip, regs, pos);
+          }
+          break;
+        }
+
+        case Opcode::EndLoop: {
+          ip = llvh::cast<EndLoopInsn>(base)->target;
+          ip = runLoop(llvh::cast<BeginLoopInsn>(insnAt(ip)), ip, regs, pos);
+          break;
+        }
+
+        case Opcode::BeginSimpleLoop: {
+          const auto *loop = llvh::cast<BeginSimpleLoopInsn>(base);
+          if (!c.satisfiesConstraints(ctx_.flags_, loop->loopeeConstraints)) {
+            ip = loop->notTakenTarget;
+            break;
+          }
+          jobs_.push_back(
+              {loop->notTakenTarget, copyRegs(regs), JobKind::Visit});
+          ip += sizeof(BeginSimpleLoopInsn);
+          break;
+        }
+
+        case Opcode::EndSimpleLoop: {
+          ip = llvh::cast<EndSimpleLoopInsn>(base)->target;
+          const auto *loop = llvh::cast<BeginSimpleLoopInsn>(insnAt(ip));
+          jobs_.push_back(
+              {loop->notTakenTarget, copyRegs(regs), JobKind::Visit});
+          ip += sizeof(BeginSimpleLoopInsn);
+          break;
+        }
+
+        case Opcode::Width1Loop: {
+          const auto *loop = llvh::cast<Width1LoopInsn>(base);
+          loopIterations(regs, loop->loopId) = 0;
+          ip = runWidth1Loop(loop, ip, regs);
+          break;
+        }
+
+        case Opcode::BackRef:
+        case Opcode::BackRefICase:
+        case Opcode::Lookaround:
+          llvm_unreachable("Rejected by LinearTimeProgram");
+      }
+      if (waiting)
+        break;
+      if (!matched || ip == kFail) {
+        releaseRegs(regs);
+        break;
+      }
+    }
+  }
+}
+
+template <class Traits>
+uint32_t LinearTimeMatcher<Traits>::consume(const Insn *base, uint32_t pos) {
+  using W1 = Width1Opcode;
+  Cursor<Traits> c = cursorAt(pos);
+  if (c.atEnd())
+    return 0;
+  switch (base->opcode) {
+    case Opcode::MatchChar8:
+      return ctx_.template matchWidth1<W1::MatchChar8>(base, c.consume());
+    case Opcode::MatchChar16:
+      return ctx_.template matchWidth1<W1::MatchChar16>(base, c.consume());
+    case Opcode::MatchCharICase8:
+      return ctx_.template matchWidth1<W1::MatchCharICase8>(base, c.consume());
+    case Opcode::MatchCharICase16:
+      return ctx_.template matchWidth1<W1::MatchCharICase16>(
+          base, c.consume());
+    case Opcode::MatchAny:
+      return ctx_.template matchWidth1<W1::MatchAny>(base, c.consume());
+    case Opcode::MatchAnyButNewline:
+      return ctx_.template matchWidth1<W1::MatchAnyButNewline>(
+          base, c.consume());
+    case Opcode::Bracket:
+      return ctx_.template matchWidth1<W1::Bracket>(base, c.consume());
+    case Opcode::BracketICase:
+      return ctx_.template matchWidth1<W1::BracketICase>(base, c.consume());
+
+    case Opcode::U16MatchAny:
+      c.consumeUTF16();
+      break;
+
+    case Opcode::U16MatchAnyButNewline:
+      if (isLineTerminator(c.consumeUTF16()))
+        return 0;
+      break;
+
+    case Opcode::U16MatchChar32: {
+      const auto *insn = llvh::cast<U16MatchChar32Insn>(base);
+      if (c.consumeUTF16() != (CodePoint)insn->c)
+        return 0;
+      break;
+    }
+
+    case Opcode::U16MatchCharICase32: {
+      const auto *insn = llvh::cast<U16MatchCharICase32Insn>(base);
+      CodePoint cp = c.consumeUTF16();
+      if (cp != (CodePoint)insn->c &&
+          ctx_.traits_.canonicalize(cp, true) != (CodePoint)insn->c)
+        return 0;
+      break;
+    }
+
+    case Opcode::MatchNChar8: {
+      const auto *insn = llvh::cast<MatchNChar8Insn>(base);
+      probe_.cursor_ = c;
+      if (c.remaining() < insn->charCount || !matchesNChar8(insn, probe_))
+        return 0;
+      return insn->charCount;
+    }
+
+    case Opcode::MatchNCharICase8: {
+      const auto *insn = llvh::cast<MatchNCharICase8Insn>(base);
+      probe_.cursor_ = c;
+      if (c.remaining() < insn->charCount ||
+          !ctx_.matchesNCharICase8(insn, probe_))
+        return 0;
+      return insn->charCount;
+    }
+
+    case Opcode::U16Bracket:
+    case Opcode::U16BracketICase: {
+      const auto *insn = static_cast<const BracketInsn *>(base);
+      const BracketRange32 *ranges =
+          reinterpret_cast<const BracketRange32 *>(insn + 1);
+      if (!bracketMatchesChar<Traits>(
+              ctx_,
+              insn,
+              ranges,
+              c.consumeUTF16(),
+              base->opcode == Opcode::U16BracketICase))
+        return 0;
+      break;
+    }
+
+    default:
+      llvm_unreachable("Not a consuming instruction");
+  }
+  return c.offsetFromLeft() - pos;
+}
+
+template <class Traits>
+auto LinearTimeMatcher<Traits>::match(State<Traits> *s, bool onlyAtStart)
+    -> const CodeUnit * {
+  const CodeUnit *const startLoc = s->cursor_.currentPointer();
+  const uint32_t startPos = startLoc - ctx_.first_;
+  const size_t charsToRight = s->cursor_.offsetFromRight();
+  const size_t locsToCheckCount = onlyAtStart ? 1 : 1 + charsToRight;
+
+  // The registers of the best match found so far, and where it ends.
+  uint32_t matchRegs = kFail;
+  uint32_t matchEnd = 0;
+
+  size_t nextLocIndex = 0;
+  for (uint32_t pos = startPos;;) {
+    if (current_.empty() && matchRegs == kFail && ctx_.prefilter_ &&
+        !onlyAtStart && nextLocIndex < locsToCheckCount) {
+      // No path is running, so skip to where the next one could succeed.
+      nextLocIndex =
+          ctx_.skipToPossibleStart(startLoc, nextLocIndex, charsToRight);
+      if (nextLocIndex == charsToRight)
+        break;
+      pos = startPos + nextLocIndex;
+    }
+    // A path starting here has the lowest priority.
+    if (matchRegs == kFail && nextLocIndex < locsToCheckCount &&
+        pos == startPos + nextLocIndex) {
+      uint32_t regs = allocRegs();
+      reg(regs, 0) = pos;
+      for (uint32_t i = 0; i < ctx_.markedCount_; ++i)
+        captureStart(regs, i) = captureEnd(regs, i) = kNotMatched;
+      for (uint32_t i = 0; i < ctx_.loopCount_; ++i)
+        loopIterations(regs, i) = loopEntryPosition(regs, i) = 0;
+      addThreads(current_, {0, regs, JobKind::Visit}, pos);
+      nextLocIndex =
+          ctx_.advanceStringIndex(startLoc, nextLocIndex, charsToRight);
+    }
+
+    if (current_.empty()) {
+      // Skip ahead to the next start location, if there is one.
+      if (matchRegs != kFail || nextLocIndex >= locsToCheckCount)
+        break;
+      pos = startPos + nextLocIndex;
+      continue;
+    }
+
+    for (size_t i = 0, e = current_.size(); i < e; ++i) {
+      Thread t = current_[i];
+      if (t.pending) {
+        if (t.pending > 1)
+          next_.push_back({t.ip, t.pending - 1, t.regs});
+        else
+          addThreads(next_, {t.ip, t.regs, JobKind::Visit}, pos + 1);
+        continue;
+      }
+      const Insn *base = insnAt(t.ip);
+      if (base->opcode == Opcode::Goal) {
+        // This path beats all the remaining ones, and loses to the ones that
+        // are still running.
+        if (matchRegs != kFail)
+          releaseRegs(matchRegs);
+        matchRegs = t.regs;
+        matchEnd = pos;
+        for (++i; i < e; ++i)
+          releaseRegs(current_[i].regs);
+        break;
+      }
+      uint32_t width = consume(base, pos);
+      if (width == 0) {
+        releaseRegs(t.regs);
+        continue;
+      }
+      uint32_t width1Loop = program_.width1LoopOfBody(t.ip);
+      if (width1Loop != LinearTimeProgram::kNoLoop) {
+        const auto *loop = llvh::cast<Width1LoopInsn>(insnAt(width1Loop));
+        ++loopIterations(t.regs, loop->loopId);
+        addThreads(
+            next_, {width1Loop, t.regs, JobKind::ResumeWidth1Loop}, pos + 1);
+      } else if (width == 1) {
+        addThreads(
+            next_, {t.ip + insnWidth(base), t.regs, JobKind::Visit}, pos + 1);
+      } else {
+        next_.push_back({t.ip + insnWidth(base), width - 1, t.regs});
+      }
+    }
+    current_.clear();
+    std::swap(current_, next_);
+    ++pos;
+  }
+
+  if (matchRegs == kFail)
+    return nullptr;
+  for (uint32_t i = 0; i < ctx_.markedCount_; ++i) {
+    s->getCapturedRange(i) = {
+        captureStart(matchRegs, i), captureEnd(matchRegs, i)};
+  }
+  s->cursor_.setCurrentPointer(ctx_.first_ + matchEnd);
+  return ctx_.first_ + reg(matchRegs, 0);
+}
+
+struct SearchAnalysis::Impl {
+  /// The prefilters for ASCII and UTF-16 input, None if they cannot rule out
+  /// any position.
+  llvh::Optional<SearchPrefilter<ASCIIRegexTraits>> prefilter8;
+  llvh::Optional<SearchPrefilter<UTF16RegexTraits>> prefilter16;
+
+  /// The linear time program, None if it wasn't requested or the regex
+  /// doesn't allow it.
+  llvh::Optional<LinearTimeProgram> linearProgram;
+
+  /// \return the prefilter for input with the code units of \p Traits, or
+  ///   nullptr if there is none.
+  template <class Traits>
+  const SearchPrefilter<Traits> *getPrefilter() const {
+    if constexpr (std::is_same_v<Traits, ASCIIRegexTraits>)
+      return prefilter8 ? prefilter8.getPointer() : nullptr;
+    else
+      return prefilter16 ? prefilter16.getPointer() : nullptr;
+  }
+};
+
+SearchAnalysis::SearchAnalysis(
+    llvh::ArrayRef<uint8_t> bytecode,
+    bool linearTime)
+    : impl_(std::make_unique<Impl>()) {
+  assert(
+      bytecode.size() >= sizeof(RegexBytecodeHeader) && "Bytecode too small");
+  impl_->prefilter8 = SearchPrefilter<ASCIIRegexTraits>::analyze(bytecode);
+  impl_->prefilter16 = SearchPrefilter<UTF16RegexTraits>::analyze(bytecode);
+  if (linearTime)
+    impl_->linearProgram = LinearTimeProgram::analyze(bytecode);
+}
+
+SearchAnalysis::~SearchAnalysis() = default;
+
+size_t SearchAnalysis::getMemorySize() const {
+  size_t size = sizeof(Impl);
+  if (impl_->linearProgram)
+    size += impl_->linearProgram->getMemorySize();
+  return size;
+}
+
 /// Entry point for searching a string via regex compiled bytecode.
 /// Given the bytecode \p bytecode, search the range starting at \p first up to
 /// (not including) \p last with the flags \p matchFlags. If the search
-/// succeeds, poopulate MatchResults with the capture groups. \return true if
-/// some portion of the string matched the regex represented by the bytecode,
-/// false otherwise.
+/// succeeds, poopulate MatchResults with the capture groups. \p analysis is the
+/// analysis of the bytecode if the caller has one. \return true if some
+/// portion of the string matched the regex represented by the bytecode, false
+/// otherwise.
 template <typename CharT, class Traits>
 MatchRuntimeResult searchWithBytecodeImpl(
     llvh::ArrayRef<uint8_t> bytecode,
@@ -1637,6 +2890,7 @@ MatchRuntimeResult searchWithBytecodeImpl(
     uint32_t length,
     std::vector<CapturedRange> *m,
     constants::MatchFlagType matchFlags,
+    const SearchAnalysis *analysis,
     StackOverflowGuard guard) {
   assert(
       bytecode.size() >= sizeof(RegexBytecodeHeader) && "Bytecode too small");
@@ -1667,12 +2921,38 @@ MatchRuntimeResult searchWithBytecodeImpl(
   bool onlyAtStart = (header->constraints & MatchConstraintAnchoredAtStart) ||
       (matchFlags & constants::matchOnlyAtStart);
 
-  auto res = ctx.match(&state, onlyAtStart);
-  if (!res) {
-    assert(res.getStatus() == ExecutionStatus::STACK_OVERFLOW);
-    return MatchRuntimeResult::StackOverflow;
+  // Analyze the bytecode here if the caller didn't.
+  llvh::Optional<SearchAnalysis> localAnalysis;
+  if (!analysis) {
+    localAnalysis.emplace(
+        bytecode, (matchFlags & constants::matchLinearTime) != 0);
+    analysis = localAnalysis.getPointer();
   }
-  if (const CharT *matchStartLoc = res.getValue()) {
+  const SearchAnalysis::Impl &analyses = analysis->impl();
+
+  // Skip the positions where a match cannot start, if the input is long
+  // enough for the prefilter to pay off.
+  if (!onlyAtStart &&
+      length - start >= SearchPrefilter<Traits>::kMinInputLength)
+    ctx.prefilter_ = analyses.getPrefilter<Traits>();
+
+  const LinearTimeProgram *linearProgram = nullptr;
+  if ((matchFlags & constants::matchLinearTime) && analyses.linearProgram)
+    linearProgram = analyses.linearProgram.getPointer();
+
+  const CharT *matchStartLoc;
+  if (linearProgram) {
+    matchStartLoc = LinearTimeMatcher<Traits>{ctx, *linearProgram}.match(
+        &state, onlyAtStart);
+  } else {
+    auto res = ctx.match(&state, onlyAtStart);
+    if (!res) {
+      assert(res.getStatus() == ExecutionStatus::STACK_OVERFLOW);
+      return MatchRuntimeResult::StackOverflow;
+    }
+    matchStartLoc = res.getValue();
+  }
+  if (matchStartLoc) {
     // Match succeeded. Return captured ranges. The first range is the total
     // match, followed by any capture groups.
     if (m != nullptr) {
@@ -1689,6 +2969,12 @@ MatchRuntimeResult searchWithBytecodeImpl(
   return MatchRuntimeResult::NoMatch;
 }
 
+bool canSearchInLinearTime(llvh::ArrayRef<uint8_t> bytecode) {
+  assert(
+      bytecode.size() >= sizeof(RegexBytecodeHeader) && "Bytecode too small");
+  return LinearTimeProgram::analyze(bytecode).hasValue();
+}
+
 MatchRuntimeResult searchWithBytecode(
     llvh::ArrayRef<uint8_t> bytecode,
     const char16_t *first,
@@ -1696,9 +2982,10 @@ MatchRuntimeResult searchWithBytecode(
     uint32_t length,
     std::vector<CapturedRange> *m,
     constants::MatchFlagType matchFlags,
+    const SearchAnalysis *analysis,
     StackOverflowGuard guard) {
   return searchWithBytecodeImpl<char16_t, UTF16RegexTraits>(
-      bytecode, first, start, length, m, matchFlags, guard);
+      bytecode, first, start, length, m, matchFlags, analysis, guard);
 }
 
 MatchRuntimeResult searchWithBytecode(
@@ -1708,9 +2995,10 @@ MatchRuntimeResult searchWithBytecode(
     uint32_t length,
     std::vector<CapturedRange> *m,
     constants::MatchFlagType matchFlags,
+    const SearchAnalysis *analysis,
     StackOverflowGuard guard) {
   return searchWithBytecodeImpl<char, ASCIIRegexTraits>(
-      bytecode, first, start, length, m, matchFlags, guard);
+      bytecode, first, start, length, m, matchFlags, analysis, guard);
 }
 
 } // namespace regex
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/CompileCache.h"
+
+#include "hermes/Support/OutputStream.h"
+#include "hermes/Support/SHA1.h"
+
+#include "llvh/ADT/SmallString.h"
+#include "llvh/Support/FileSystem.h"
+#include "llvh/Support/Path.h"
+#include "llvh/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace hermes {
+
+/// Used to locate the running executable.
+static void anchor() {}
+
+void CompileCache::KeyBuilder::add(llvh::StringRef data) {
+  add((uint64_t)data.size());
+  hasher_.update(data);
+}
+
+void CompileCache::KeyBuilder::add(uint64_t value) {
+  uint8_t bytes[sizeof(value)];
+  for (unsigned i = 0; i < sizeof(value); ++i)
+    bytes[i] = (uint8_t)(value >> (8 * i));
+  hasher_.update(bytes);
+}
+
+void CompileCache::KeyBuilder::addCommandLine(
+    llvh::ArrayRef<const char *> args,
+    llvh::ArrayRef<llvh::StringRef> ignoredOptions) {
+  if (args.empty())
+    return;
+
+  // Identify the compiler by its binary rather than by its version, so that
+  // local builds of the same version do not share entries.
+  std::string exe = llvh::sys::fs::getMainExecutable(
+      args[0], reinterpret_cast<void *>(&anchor));
+  llvh::sys::fs::file_status status;
+  if (!exe.empty() && !llvh::sys::fs::status(exe, status)) {
+    add(status.getSize());
+    add((uint64_t)status.getLastModificationTime().time_since_epoch().count());
+  } else {
+    add(args[0]);
+  }
+
+  for (size_t i = 1, e = args.size(); i < e; ++i) {
+    llvh::StringRef arg = args[i];
+    if (arg.size() > 1 && arg[0] == '-') {
+      llvh::StringRef name = arg.ltrim('-').split('=').first;
+      bool hasValue = arg.find('=') != llvh::StringRef::npos;
+      bool ignored = false;
+      for (llvh::StringRef opt : ignoredOptions) {
+        if (name == opt) {
+          ignored = true;
+        } else if (
+            opt.size() == 1 && name.startswith(opt) &&
+            std::all_of(name.begin() + 1, name.end(), ::isdigit)) {
+          // A single-letter option with its numeric value attached, as in
+          // "-j8".
+          ignored = hasValue = true;
+        }
+      }
+      if (ignored) {
+        // Skip the value too if it is spelled as a separate argument.
+        if (!hasValue)
+          ++i;
+        continue;
+      }
+    }
+    add(arg);
+    addFileNamedBy(arg);
+  }
+}
+
+void CompileCache::KeyBuilder::addFileNamedBy(llvh::StringRef arg) {
+  // The path is the argument itself, the value of an "-option=value"
+  // argument, or the name of a response file.
+  llvh::StringRef path = arg;
+  if (arg.startswith("-"))
+    path = arg.split('=').second;
+  else if (arg.startswith("@"))
+    path = arg.drop_front();
+  if (path.empty() || !llvh::sys::fs::is_regular_file(path))
+    return;
+  auto bufOrErr = llvh::MemoryBuffer::getFile(
+      path,
+      /* FileSize */ -1,
+      /* RequiresNullTerminator */ false);
+  // A file that cannot be read cannot be an input either; the name alone
+  // keeps the key distinct.
+  if (bufOrErr)
+    add((*bufOrErr)->getBuffer());
+}
+
+std::string CompileCache::KeyBuilder::finish() {
+  llvh::StringRef digest = hasher_.final();
+  SHA1 hash{};
+  std::copy_n(
+      digest.bytes_begin(), std::min(digest.size(), hash.size()), hash.begin());
+  return hashAsString(hash);
+}
+
+std::string CompileCache::entryPath(llvh::StringRef key) const {
+  llvh::SmallString<128> path{dir_};
+  llvh::sys::path::append(path, key);
+  return path.str().str();
+}
+
+std::unique_ptr<llvh::MemoryBuffer> CompileCache::lookup(
+    llvh::StringRef key) const {
+  auto bufOrErr = llvh::MemoryBuffer::getFile(
+      entryPath(key),
+      /* FileSize */ -1,
+      /* RequiresNullTerminator */ false);
+  if (!bufOrErr)
+    return nullptr;
+  return std::move(*bufOrErr);
+}
+
+bool CompileCache::store(llvh::StringRef key, llvh::StringRef output) const {
+  if (std::error_code EC = llvh::sys::fs::create_directories(dir_)) {
+    llvh::errs() << "Failed to create compile cache directory " << dir_ << ": "
+                 << EC.message() << '\n';
+    return false;
+  }
+  OutputStream OS{};
+  if (!OS.open(entryPath(key), llvh::sys::fs::F_None))
+    return false;
+  OS.os() << output;
+  return OS.close();
+}
+
+} // namespace hermes
@@ -470,6 +470,136 @@ int64_t searchReverseU64(
   return searchU64Impl<true>(arr, start, end, target);
 }
 
+//===----------------------------------------------------------------------===//
+// Search for any of several targets
+//===----------------------------------------------------------------------===//
+
+/// Copy \p targets into \p padded, repeating the first target to fill the
+/// unused slots, so that the search loops can always compare against all of
+/// them.
+template <typename T>
+static void padTargets(
+    llvh::ArrayRef<T> targets,
+    T (&padded)[kMaxSearchAnyTargets]) {
+  assert(
+      !targets.empty() && targets.size() <= kMaxSearchAnyTargets &&
+      "invalid number of targets");
+  for (size_t i = 0; i < kMaxSearchAnyTargets; ++i)
+    padded[i] = i < targets.size() ? targets[i] : targets[0];
+}
+
+/// Scalar forward search over [start, end) of \p arr for any of \p targets.
+/// \return the index of the first match, or -1 if not found.
+template <typename T>
+static int64_t scalarSearchAny(
+    llvh::ArrayRef<T> arr,
+    size_t start,
+    size_t end,
+    const T (&targets)[kMaxSearchAnyTargets]) {
+  static_assert(kMaxSearchAnyTargets == 4, "comparisons below assume 4");
+  for (size_t i = start; i < end; ++i) {
+    T x = arr[i];
+    if (x == targets[0] || x == targets[1] || x == targets[2] ||
+        x == targets[3])
+      return static_cast<int64_t>(i);
+  }
+  return -1;
+}
+
+int64_t searchAnyU8(
+    llvh::ArrayRef<uint8_t> arr,
+    size_t start,
+    size_t end,
+    llvh::ArrayRef<uint8_t> targets) {
+  assert(start <= end && "start must be <= end");
+  assert(end <= arr.size() && "end exceeds array bounds");
+  uint8_t t[kMaxSearchAnyTargets];
+  padTargets(targets, t);
+  size_t i = start;
+
+#ifdef HERMES_SIMD_NEON
+  // Compare each chunk against every target and OR the results together.
+  uint8x16_t n0 = vdupq_n_u8(t[0]);
+  uint8x16_t n1 = vdupq_n_u8(t[1]);
+  uint8x16_t n2 = vdupq_n_u8(t[2]);
+  uint8x16_t n3 = vdupq_n_u8(t[3]);
+  for (; i + 16 <= end; i += 16) {
+    uint8x16_t data = vld1q_u8(arr.data() + i);
+    uint8x16_t match = vorrq_u8(
+        vorrq_u8(vceqq_u8(data, n0), vceqq_u8(data, n1)),
+        vorrq_u8(vceqq_u8(data, n2), vceqq_u8(data, n3)));
+    if (vmaxvq_u8(match))
+      // Fall back to scalar to find the exact byte within this chunk.
+      return scalarSearchAny(arr, i, i + 16, t);
+  }
+#elif defined(HERMES_SIMD_SSE2)
+  __m128i n0 = _mm_set1_epi8(static_cast<char>(t[0]));
+  __m128i n1 = _mm_set1_epi8(static_cast<char>(t[1]));
+  __m128i n2 = _mm_set1_epi8(static_cast<char>(t[2]));
+  __m128i n3 = _mm_set1_epi8(static_cast<char>(t[3]));
+  for (; i + 16 <= end; i += 16) {
+    __m128i data =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(arr.data() + i));
+    __m128i match = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(data, n0), _mm_cmpeq_epi8(data, n1)),
+        _mm_or_si128(_mm_cmpeq_epi8(data, n2), _mm_cmpeq_epi8(data, n3)));
+    // 1 mask bit per byte; countTrailingZeros gives exact byte offset.
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(match));
+    if (mask)
+      return static_cast<int64_t>(i + llvh::countTrailingZeros(mask));
+  }
+#endif
+
+  return scalarSearchAny(arr, i, end, t);
+}
+
+int64_t searchAnyU16(
+    llvh::ArrayRef<uint16_t> arr,
+    size_t start,
+    size_t end,
+    llvh::ArrayRef<uint16_t> targets) {
+  assert(start <= end && "start must be <= end");
+  assert(end <= arr.size() && "end exceeds array bounds");
+  uint16_t t[kMaxSearchAnyTargets];
+  padTargets(targets, t);
+  size_t i = start;
+
+#ifdef HERMES_SIMD_NEON
+  // Same approach as searchAnyU8 but with 16-bit lanes (8 per chunk).
+  uint16x8_t n0 = vdupq_n_u16(t[0]);
+  uint16x8_t n1 = vdupq_n_u16(t[1]);
+  uint16x8_t n2 = vdupq_n_u16(t[2]);
+  uint16x8_t n3 = vdupq_n_u16(t[3]);
+  for (; i + 8 <= end; i += 8) {
+    uint16x8_t data = vld1q_u16(arr.data() + i);
+    uint16x8_t match = vorrq_u16(
+        vorrq_u16(vceqq_u16(data, n0), vceqq_u16(data, n1)),
+        vorrq_u16(vceqq_u16(data, n2), vceqq_u16(data, n3)));
+    if (vmaxvq_u16(match))
+      return scalarSearchAny(arr, i, i + 8, t);
+  }
+#elif defined(HERMES_SIMD_SSE2)
+  __m128i n0 = _mm_set1_epi16(static_cast<short>(t[0]));
+  __m128i n1 = _mm_set1_epi16(static_cast<short>(t[1]));
+  __m128i n2 = _mm_set1_epi16(static_cast<short>(t[2]));
+  __m128i n3 = _mm_set1_epi16(static_cast<short>(t[3]));
+  for (; i + 8 <= end; i += 8) {
+    __m128i data =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(arr.data() + i));
+    __m128i match = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi16(data, n0), _mm_cmpeq_epi16(data, n1)),
+        _mm_or_si128(_mm_cmpeq_epi16(data, n2), _mm_cmpeq_epi16(data, n3)));
+    // Each 16-bit lane produces 2 mask bits; divide by 2 for the
+    // element index.
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(match));
+    if (mask)
+      return static_cast<int64_t>(i + llvh::countTrailingZeros(mask) / 2);
+  }
+#endif
+
+  return scalarSearchAny(arr, i, end, t);
+}
+
 //===----------------------------------------------------------------------===//
 // Special character scanning for JSON strings
 //===----------------------------------------------------------------------===//
@@ -588,4 +718,114 @@ const char16_t *scanJsonEscapeU16(const char16_t *start, const char16_t *end) {
   return scalarScanU16(p, end);
 }
 
+//===----------------------------------------------------------------------===//
+// Whitespace skipping for JSON
+//===----------------------------------------------------------------------===//
+
+/// \return true if \p ch is JSON whitespace.
+template <typename CharT>
+static inline bool isJsonWhitespace(CharT ch) {
+  return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t';
+}
+
+/// Scalar helper: scan for the first character that is not JSON whitespace.
+template <typename CharT>
+static const CharT *scalarScanNonWhitespace(const CharT *p, const CharT *end) {
+  while (p < end && isJsonWhitespace(*p))
+    ++p;
+  return p;
+}
+
+const char *scanJsonNonWhitespaceU8(const char *start, const char *end) {
+  assert(start <= end && "start must be <= end");
+  const char *p = start;
+  // Most whitespace runs in JSON are a single separator, so check the first
+  // character before paying for a vector load.
+  if (p == end || !isJsonWhitespace(*p))
+    return p;
+
+#ifdef HERMES_SIMD_NEON
+  uint8x16_t vSpace = vdupq_n_u8(' ');
+  uint8x16_t vNewline = vdupq_n_u8('\n');
+  uint8x16_t vReturn = vdupq_n_u8('\r');
+  uint8x16_t vTab = vdupq_n_u8('\t');
+  while (p + 16 <= end) {
+    uint8x16_t data = vld1q_u8(reinterpret_cast<const uint8_t *>(p));
+    uint8x16_t ws = vorrq_u8(
+        vorrq_u8(vceqq_u8(data, vSpace), vceqq_u8(data, vNewline)),
+        vorrq_u8(vceqq_u8(data, vReturn), vceqq_u8(data, vTab)));
+    // Any zero lane is a character that is not whitespace.
+    if (vminvq_u8(ws) == 0)
+      return scalarScanNonWhitespace(p, p + 16);
+    p += 16;
+  }
+#elif defined(HERMES_SIMD_SSE2)
+  __m128i vSpace = _mm_set1_epi8(' ');
+  __m128i vNewline = _mm_set1_epi8('\n');
+  __m128i vReturn = _mm_set1_epi8('\r');
+  __m128i vTab = _mm_set1_epi8('\t');
+  while (p + 16 <= end) {
+    __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    __m128i ws = _mm_or_si128(
+        _mm_or_si128(
+            _mm_cmpeq_epi8(data, vSpace), _mm_cmpeq_epi8(data, vNewline)),
+        _mm_or_si128(
+            _mm_cmpeq_epi8(data, vReturn), _mm_cmpeq_epi8(data, vTab)));
+    // 1 mask bit per byte, set for whitespace. Invert it to find the rest.
+    unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(ws)) & 0xFFFF;
+    if (mask)
+      return p + llvh::countTrailingZeros(mask);
+    p += 16;
+  }
+#endif
+
+  return scalarScanNonWhitespace(p, end);
+}
+
+const char16_t *scanJsonNonWhitespaceU16(
+    const char16_t *start,
+    const char16_t *end) {
+  assert(start <= end && "start must be <= end");
+  const char16_t *p = start;
+  if (p == end || !isJsonWhitespace(*p))
+    return p;
+
+#ifdef HERMES_SIMD_NEON
+  uint16x8_t vSpace = vdupq_n_u16(u' ');
+  uint16x8_t vNewline = vdupq_n_u16(u'\n');
+  uint16x8_t vReturn = vdupq_n_u16(u'\r');
+  uint16x8_t vTab = vdupq_n_u16(u'\t');
+  while (p + 8 <= end) {
+    uint16x8_t data = vld1q_u16(reinterpret_cast<const uint16_t *>(p));
+    uint16x8_t ws = vorrq_u16(
+        vorrq_u16(vceqq_u16(data, vSpace), vceqq_u16(data, vNewline)),
+        vorrq_u16(vceqq_u16(data, vReturn), vceqq_u16(data, vTab)));
+    if (vminvq_u16(ws) == 0)
+      return scalarScanNonWhitespace(p, p + 8);
+    p += 8;
+  }
+#elif defined(HERMES_SIMD_SSE2)
+  __m128i vSpace = _mm_set1_epi16(u' ');
+  __m128i vNewline = _mm_set1_epi16(u'\n');
+  __m128i vReturn = _mm_set1_epi16(u'\r');
+  __m128i vTab = _mm_set1_epi16(u'\t');
+  while (p + 8 <= end) {
+    __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    __m128i ws = _mm_or_si128(
+        _mm_or_si128(
+            _mm_cmpeq_epi16(data, vSpace), _mm_cmpeq_epi16(data, vNewline)),
+        _mm_or_si128(
+            _mm_cmpeq_epi16(data, vReturn), _mm_cmpeq_epi16(data, vTab)));
+    // Each 16-bit lane produces 2 mask bits; divide by 2 for the
+    // element index.
+    unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(ws)) & 0xFFFF;
+    if (mask)
+      return p + llvh::countTrailingZeros(mask) / 2;
+    p += 8;
+  }
+#endif
+
+  return scalarScanNonWhitespace(p, end);
+}
+
 } // namespace hermes
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/ParallelFor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace hermes {
+
+unsigned resolveThreadCount(unsigned requested) {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+  (void)requested;
+  return 1;
+#else
+  if (requested == 0)
+    requested = std::thread::hardware_concurrency();
+  return std::max(requested, 1u);
+#endif
+}
+
+void parallelFor(
+    unsigned numThreads,
+    size_t count,
+    llvh::function_ref<void(size_t)> fn) {
+  numThreads =
+      (unsigned)std::min<size_t>(resolveThreadCount(numThreads), count);
+  if (numThreads <= 1) {
+    for (size_t i = 0; i < count; ++i)
+      fn(i);
+    return;
+  }
+
+  // Indices are claimed one at a time, so that a few large items do not leave
+  // the other threads idle.
+  std::atomic<size_t> next{0};
+  auto worker = [&next, count, fn]() {
+    for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;)
+      fn(i);
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads - 1);
+  for (unsigned t = 1; t < numThreads; ++t)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread &thread : threads)
+    thread.join();
+}
+
+} // namespace hermes
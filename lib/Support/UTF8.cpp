@@ -6,6 +6,7 @@
  */
 
 #include "hermes/Support/UTF8.h"
+#include "hermes/Support/SIMD.h"
 
 namespace hermes {
 
@@ -283,6 +284,23 @@ bool isAllASCII(const uint8_t *start, const uint8_t *end) {
 #endif
 
 bool isAllASCII(const char16_t *start, const char16_t *end) {
+  // Check 8 characters at a time for any bits above 0x7F.
+#ifdef HERMES_SIMD_NEON
+  for (; end - start >= 8; start += 8) {
+    uint16x8_t data = vld1q_u16(reinterpret_cast<const uint16_t *>(start));
+    if (vmaxvq_u16(data) > 0x7F)
+      return false;
+  }
+#elif defined(HERMES_SIMD_SSE2)
+  const __m128i nonASCIIMask = _mm_set1_epi16(static_cast<short>(0xFF80));
+  const __m128i zero = _mm_setzero_si128();
+  for (; end - start >= 8; start += 8) {
+    __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(start));
+    __m128i isASCII = _mm_cmpeq_epi16(_mm_and_si128(data, nonASCIIMask), zero);
+    if (_mm_movemask_epi8(isASCII) != 0xFFFF)
+      return false;
+  }
+#endif
   for (; start != end; ++start) {
     if (*start > 0x7F)
       return false;
@@ -38,20 +38,20 @@ namespace vm {
 namespace {
 
 /// A helper to convert a SH-style function into a CallResult-style function.
+/// \param newFrame the frame of the called function. On exception, the stack
+///   is unwound to the frame before it.
 template <typename Res, typename FnPtr, typename ProfileFn>
-inline CallResult<Res>
-_callWrapper(FnPtr functionPtr, Runtime &runtime, const ProfileFn &profileFn) {
+inline CallResult<Res> _callWrapper(
+    FnPtr functionPtr,
+    Runtime &runtime,
+    StackFramePtr newFrame,
+    const ProfileFn &profileFn) {
   // ScopedNativeDepthTracker depthTracker{runtime};
   // if (LLVM_UNLIKELY(depthTracker.overflowed())) {
   //   return runtime.raiseStackOverflow(
   //       Runtime::StackOverflowKind::NativeStack);
   // }
 
-  StackFramePtr newFrame{runtime.getStackPointer()};
-
-  // Ensure the IP was correctly saved before we create the new frame.
-  runtime.validateSavedIPBeforeCall();
-
   // If we call into the JIT (either directly or transitively), it may modify
   // the saved IP. Make sure the IP is restored before we return to the caller.
   auto restoreIP = llvh::make_scope_exit(
@@ -82,6 +82,20 @@ _callWrapper(FnPtr functionPtr, Runtime &runtime, const ProfileFn &profileFn) {
   }
 }
 
+/// A helper to call a SH-style function, whose frame will be allocated at the
+/// current stack pointer.
+template <typename Res, typename FnPtr, typename ProfileFn>
+inline CallResult<Res>
+_callWrapper(FnPtr functionPtr, Runtime &runtime, const ProfileFn &profileFn) {
+  // Ensure the IP was correctly saved before we create the new frame.
+  runtime.validateSavedIPBeforeCall();
+  return _callWrapper<Res>(
+      functionPtr,
+      runtime,
+      StackFramePtr{runtime.getStackPointer()},
+      profileFn);
+}
+
 } // unnamed namespace
 
 //===----------------------------------------------------------------------===//
@@ -1434,6 +1448,14 @@ CallResult<HermesValue> JSFunction::_jittedCall(
   return _callWrapper<HermesValue>(functionPtr, runtime, [](uint64_t) {});
 }
 
+CallResult<HermesValue> JSFunction::_jittedOSRCall(
+    JITCompiledFunctionPtr entryPtr,
+    Runtime &runtime) {
+  // The entry point takes over the current frame and pops it when it returns.
+  return _callWrapper<HermesValue>(
+      entryPtr, runtime, runtime.getCurrentFrame(), [](uint64_t) {});
+}
+
 CallResult<PseudoHandle<>> JSFunction::_callImpl(
     Handle<Callable> selfHandle,
     Runtime &runtime) {
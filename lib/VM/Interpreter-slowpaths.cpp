@@ -45,6 +45,9 @@ HERMES_SLOW_STATISTIC(
 HERMES_SLOW_STATISTIC(
     NumGetByIdSlow,
     "NumGetByIdSlow: Number of property 'read by id' slow path");
+HERMES_SLOW_STATISTIC(
+    NumGetByIdPolyHits,
+    "NumGetByIdPolyHits: Number of property 'read by id' polymorphic hits");
 
 HERMES_SLOW_STATISTIC(
     NumGetByValStr,
@@ -59,6 +62,9 @@ HERMES_SLOW_STATISTIC(
 HERMES_SLOW_STATISTIC(
     NumPutByIdTransient,
     "NumPutByIdTransient: Number of property 'write by id' to non-objects");
+HERMES_SLOW_STATISTIC(
+    NumPutByIdPolyHits,
+    "NumPutByIdPolyHits: Number of property 'write by id' polymorphic hits");
 
 HERMES_SLOW_STATISTIC(NumPutByVal, "NumPutByVal: Number of PutByVal");
 
@@ -622,8 +628,17 @@ PseudoHandle<JSRegExp> Interpreter::createRegExp(
   RuntimeModule *runtimeModule = curCodeBlock->getRuntimeModule();
   lv.pattern = runtime.getStringPrimFromSymbolID(patternID);
   lv.flags = runtime.getStringPrimFromSymbolID(flagsID);
+  // Every RegExp created by this literal refers to the bytecode in the
+  // bytecode provider instead of copying it.
   auto bytecode = runtimeModule->getRegExpBytecodeFromRegExpID(regexpID);
-  JSRegExp::initialize(lv.re, runtime, lv.pattern, lv.flags, bytecode);
+  JSRegExp::initialize(
+      lv.re,
+      runtime,
+      lv.pattern,
+      lv.flags,
+      {std::shared_ptr<const uint8_t>(
+           runtimeModule->getBytecodeSharedPtr(), bytecode.data()),
+       (uint32_t)bytecode.size()});
 
   return createPseudoHandle(*lv.re);
 }
@@ -703,6 +718,7 @@ getByValTransientFast(Runtime &runtime, Handle<> base, Handle<> nameHandle) {
     // Otherwise we need to fall back to prototype lookup.
     if (arrayIndex &&
         arrayIndex.getValue() < base->getString()->getStringLength()) {
+      StringPrimitive::flattenIfRope(runtime, base->getString());
       return createPseudoHandle(
           runtime
               .getCharacterString(base->getString()->at(arrayIndex.getValue()))
@@ -1444,6 +1460,18 @@ ExecutionStatus doGetByIdSlowPath_RJS(
   auto *cacheEntry = curCodeBlock->getReadCacheEntry(cacheIdx);
   CompressedPointer clazzPtr{obj->getClassGCPtr()};
 
+  // The monomorphic entry missed, look for the class in the other classes
+  // this instruction has seen.
+  SlotIndex polySlot;
+  if (JSObject *propObj = runtime.getPolyPropCache().tryRead(
+          runtime, cacheEntry, obj, id, polySlot)) {
+    ++NumGetByIdPolyHits;
+    O1REG(GetById) =
+        JSObject::getNamedSlotValueUnsafe(propObj, runtime, polySlot)
+            .unboxToHV(runtime);
+    return ExecutionStatus::RETURNED;
+  }
+
   NamedPropertyDescriptor desc;
   OptValue<bool> fastPathResult =
       JSObject::tryGetOwnNamedDescriptorFast(obj, runtime, id, desc);
@@ -1464,8 +1492,8 @@ ExecutionStatus doGetByIdSlowPath_RJS(
       (void)NumGetByIdCacheEvicts;
 #endif
       // Cache the class, id and property slot.
-      cacheEntry->clazz = clazzPtr;
-      cacheEntry->setSlot(desc.slot);
+      runtime.getPolyPropCache().recordRead(
+          cacheEntry, clazzPtr, CompressedPointer(nullptr), desc.slot, id);
     }
 
     assert(
@@ -1773,6 +1801,16 @@ ExecutionStatus Interpreter::putByIdSlowPath_RJS(
   auto *cacheEntry = curCodeBlock->getWriteCacheEntry(cacheIdx);
   CompressedPointer clazzPtr{obj->getClassGCPtr()};
 
+  // The monomorphic entry missed, look for the class in the other classes
+  // this instruction has seen.
+  SlotIndex polySlot;
+  if (runtime.getPolyPropCache().tryWrite(
+          runtime, cacheEntry, obj, id, polySlot)) {
+    ++NumPutByIdPolyHits;
+    JSObject::setNamedSlotValueUnsafe(obj, runtime, polySlot, shv);
+    return ExecutionStatus::RETURNED;
+  }
+
   NamedPropertyDescriptor desc;
   OptValue<bool> hasOwnProp =
       JSObject::tryGetOwnNamedDescriptorFast(obj, runtime, id, desc);
@@ -1794,9 +1832,8 @@ ExecutionStatus Interpreter::putByIdSlowPath_RJS(
       (void)NumPutByIdCacheEvicts;
 #endif
       // Cache the class and property slot.
-      // Preserve the addCacheIndex if the slot hasn't changed.
-      cacheEntry->clazz = clazzPtr;
-      cacheEntry->setSlot(desc.slot);
+      runtime.getPolyPropCache().recordWrite(
+          cacheEntry, clazzPtr, desc.slot, id);
     }
 
     // This must be valid because an own property was already found.
@@ -743,6 +743,24 @@ tailCall:
 
 #endif // HERMESVM_INDIRECT_THREADING
 
+// Jump to \p dest and dispatch. With the JIT enabled, backward jumps go through
+// backwardJump, which counts loop iterations and may transfer the frame to
+// JIT-compiled code (on-stack replacement).
+#if HERMESVM_JIT
+#define JUMP_DISPATCH(dest)                                           \
+  if (const Inst *jumpDest = (dest); LLVM_UNLIKELY(jumpDest <= ip)) { \
+    ip = jumpDest;                                                    \
+    goto backwardJump;                                                \
+  } else {                                                            \
+    ip = jumpDest;                                                    \
+  }                                                                   \
+  DISPATCH
+#else
+#define JUMP_DISPATCH(dest) \
+  ip = (dest);              \
+  DISPATCH
+#endif
+
 // This macro is used when we detect that either the Implicit or Explicit
 // AsyncBreak flags have been set. It checks to see which one was requested and
 // propagate the corresponding RunReason. If both Implicit and Explicit have
@@ -961,11 +979,9 @@ tailCall:
       if (O2REG(name##suffix)                                             \
               .getNumber() oper O3REG(name##suffix)                       \
               .getNumber()) {                                             \
-        ip = trueDest;                                                    \
-        DISPATCH;                                                         \
+        JUMP_DISPATCH(trueDest);                                          \
       }                                                                   \
-      ip = falseDest;                                                     \
-      DISPATCH;                                                           \
+      JUMP_DISPATCH(falseDest);                                           \
     }                                                                     \
     CAPTURE_IP(                                                           \
         boolRes = operFuncName(                                           \
@@ -976,11 +992,9 @@ tailCall:
       goto exception;                                                     \
     gcScope.flushToSmallCount(KEEP_HANDLES);                              \
     if (boolRes.getValue()) {                                             \
-      ip = trueDest;                                                      \
-      DISPATCH;                                                           \
+      JUMP_DISPATCH(trueDest);                                            \
     }                                                                     \
-    ip = falseDest;                                                       \
-    DISPATCH;                                                             \
+    JUMP_DISPATCH(falseDest);                                             \
   }
 
 /// Like JCOND_IMPL, but for cases where the operands are known to be numbers.
@@ -989,11 +1003,9 @@ tailCall:
     if (O2REG(name##suffix)                                                 \
             .getNumber() oper O3REG(name##suffix)                           \
             .getNumber()) {                                                 \
-      ip = trueDest;                                                        \
-      DISPATCH;                                                             \
+      JUMP_DISPATCH(trueDest);                                              \
     }                                                                       \
-    ip = falseDest;                                                         \
-    DISPATCH;                                                               \
+    JUMP_DISPATCH(falseDest);                                               \
   }
 
 /// Implement a strict equality conditional jump
@@ -1001,14 +1013,13 @@ tailCall:
 /// \param suffix  Optional suffix to be added to the end (e.g. Long)
 /// \param trueDest  ip value if the conditional evaluates to true
 /// \param falseDest  ip value if the conditional evaluates to false
-#define JCOND_STRICT_EQ_IMPL(name, suffix, trueDest, falseDest)         \
-  CASE(name##suffix) {                                                  \
-    if (strictEqualityTest(O2REG(name##suffix), O3REG(name##suffix))) { \
-      ip = trueDest;                                                    \
-      DISPATCH;                                                         \
-    }                                                                   \
-    ip = falseDest;                                                     \
-    DISPATCH;                                                           \
+#define JCOND_STRICT_EQ_IMPL(name, suffix, trueDest, falseDest)   \
+  CASE(name##suffix) {                                            \
+    if (strictEqualityTest(                                       \
+            runtime, O2REG(name##suffix), O3REG(name##suffix))) { \
+      JUMP_DISPATCH(trueDest);                                    \
+    }                                                             \
+    JUMP_DISPATCH(falseDest);                                     \
   }
 
 /// Implement an equality conditional jump
@@ -1029,11 +1040,9 @@ tailCall:
     }                                                    \
     gcScope.flushToSmallCount(KEEP_HANDLES);             \
     if (*eqRes) {                                        \
-      ip = trueDest;                                     \
-      DISPATCH;                                          \
+      JUMP_DISPATCH(trueDest);                           \
     }                                                    \
-    ip = falseDest;                                      \
-    DISPATCH;                                            \
+    JUMP_DISPATCH(falseDest);                            \
   }
 
 /// Implement the long and short forms of a conditional jump, and its negation.
@@ -1894,6 +1903,7 @@ tailCall:
      * the property. */                                                       \
     if (LLVM_LIKELY(cacheEntry->clazz == clazzPtr)) {                         \
       ++NumGetByIdCacheHits;                                                  \
+      PROPERTY_CACHE_COUNT_MONO_HIT(runtime, cacheEntry, ID(idVal), false);   \
       O1REG(name) = JSObject::getNamedSlotValueUnsafe(                        \
                         obj, runtime, cacheEntry->getSlot())                  \
                         .unboxToHV(runtime);                                  \
@@ -1911,6 +1921,8 @@ tailCall:
         JSObject *parent = parentGCPtr.getNonNull(runtime);                   \
         if (LLVM_LIKELY(cacheEntry->clazz == parent->getClassGCPtr())) {      \
           ++NumGetByIdProtoHits;                                              \
+          PROPERTY_CACHE_COUNT_MONO_HIT(                                      \
+              runtime, cacheEntry, ID(idVal), false);                         \
           /* We've already checked that this isn't a Proxy. */                \
           O1REG(name) = JSObject::getNamedSlotValueUnsafe(                    \
                             parent, runtime, cacheEntry->getSlot())           \
@@ -2057,6 +2069,7 @@ tailCall:
         // return the property.
         if (LLVM_LIKELY(cacheEntry->clazz == clazzPtr)) {
           ++NumPutByIdCacheHits;
+          PROPERTY_CACHE_COUNT_MONO_HIT(runtime, cacheEntry, ID(idVal), true);
           JSObject::setNamedSlotValueUnsafe(
               obj, runtime, cacheEntry->getSlot(), shv);
           ip = nextIP;
@@ -2403,53 +2416,51 @@ tailCall:
       CASE_OUTOFLINE(CreatePrivateName);
 
       CASE(Jmp) {
-        ip = IPADD(ip->iJmp.op1);
-        DISPATCH;
+        JUMP_DISPATCH(IPADD(ip->iJmp.op1));
       }
       CASE(JmpLong) {
-        ip = IPADD(ip->iJmpLong.op1);
-        DISPATCH;
+        JUMP_DISPATCH(IPADD(ip->iJmpLong.op1));
       }
       CASE(JmpTrue) {
-        if (toBoolean(O2REG(JmpTrue)))
-          ip = IPADD(ip->iJmpTrue.op1);
-        else
-          ip = NEXTINST(JmpTrue);
+        if (toBoolean(O2REG(JmpTrue))) {
+          JUMP_DISPATCH(IPADD(ip->iJmpTrue.op1));
+        }
+        ip = NEXTINST(JmpTrue);
         DISPATCH;
       }
       CASE(JmpTrueLong) {
-        if (toBoolean(O2REG(JmpTrueLong)))
-          ip = IPADD(ip->iJmpTrueLong.op1);
-        else
-          ip = NEXTINST(JmpTrueLong);
+        if (toBoolean(O2REG(JmpTrueLong))) {
+          JUMP_DISPATCH(IPADD(ip->iJmpTrueLong.op1));
+        }
+        ip = NEXTINST(JmpTrueLong);
         DISPATCH;
       }
       CASE(JmpFalse) {
-        if (!toBoolean(O2REG(JmpFalse)))
-          ip = IPADD(ip->iJmpFalse.op1);
-        else
-          ip = NEXTINST(JmpFalse);
+        if (!toBoolean(O2REG(JmpFalse))) {
+          JUMP_DISPATCH(IPADD(ip->iJmpFalse.op1));
+        }
+        ip = NEXTINST(JmpFalse);
         DISPATCH;
       }
       CASE(JmpFalseLong) {
-        if (!toBoolean(O2REG(JmpFalseLong)))
-          ip = IPADD(ip->iJmpFalseLong.op1);
-        else
-          ip = NEXTINST(JmpFalseLong);
+        if (!toBoolean(O2REG(JmpFalseLong))) {
+          JUMP_DISPATCH(IPADD(ip->iJmpFalseLong.op1));
+        }
+        ip = NEXTINST(JmpFalseLong);
         DISPATCH;
       }
       CASE(JmpUndefined) {
-        if (O2REG(JmpUndefined).isUndefined())
-          ip = IPADD(ip->iJmpUndefined.op1);
-        else
-          ip = NEXTINST(JmpUndefined);
+        if (O2REG(JmpUndefined).isUndefined()) {
+          JUMP_DISPATCH(IPADD(ip->iJmpUndefined.op1));
+        }
+        ip = NEXTINST(JmpUndefined);
         DISPATCH;
       }
       CASE(JmpUndefinedLong) {
-        if (O2REG(JmpUndefinedLong).isUndefined())
-          ip = IPADD(ip->iJmpUndefinedLong.op1);
-        else
-          ip = NEXTINST(JmpUndefinedLong);
+        if (O2REG(JmpUndefinedLong).isUndefined()) {
+          JUMP_DISPATCH(IPADD(ip->iJmpUndefinedLong.op1));
+        }
+        ip = NEXTINST(JmpUndefinedLong);
         DISPATCH;
       }
       CASE(JmpBuiltinIs) {
@@ -2457,10 +2468,9 @@ tailCall:
             HermesValue::encodeObjectValue(
                 runtime.getBuiltinCallable(ip->iJmpBuiltinIs.op2))
                 .getRaw()) {
-          ip = IPADD(ip->iJmpBuiltinIs.op1);
-        } else {
-          ip = NEXTINST(JmpBuiltinIs);
+          JUMP_DISPATCH(IPADD(ip->iJmpBuiltinIs.op1));
         }
+        ip = NEXTINST(JmpBuiltinIs);
         DISPATCH;
       }
       CASE(JmpBuiltinIsLong) {
@@ -2468,10 +2478,9 @@ tailCall:
             HermesValue::encodeObjectValue(
                 runtime.getBuiltinCallable(ip->iJmpBuiltinIsLong.op2))
                 .getRaw()) {
-          ip = IPADD(ip->iJmpBuiltinIsLong.op1);
-        } else {
-          ip = NEXTINST(JmpBuiltinIsLong);
+          JUMP_DISPATCH(IPADD(ip->iJmpBuiltinIsLong.op1));
         }
+        ip = NEXTINST(JmpBuiltinIsLong);
         DISPATCH;
       }
       CASE(JmpBuiltinIsNot) {
@@ -2479,10 +2488,9 @@ tailCall:
             HermesValue::encodeObjectValue(
                 runtime.getBuiltinCallable(ip->iJmpBuiltinIsNot.op2))
                 .getRaw()) {
-          ip = IPADD(ip->iJmpBuiltinIsNot.op1);
-        } else {
-          ip = NEXTINST(JmpBuiltinIsNot);
+          JUMP_DISPATCH(IPADD(ip->iJmpBuiltinIsNot.op1));
         }
+        ip = NEXTINST(JmpBuiltinIsNot);
         DISPATCH;
       }
       CASE(JmpBuiltinIsNotLong) {
@@ -2490,10 +2498,9 @@ tailCall:
             HermesValue::encodeObjectValue(
                 runtime.getBuiltinCallable(ip->iJmpBuiltinIsNotLong.op2))
                 .getRaw()) {
-          ip = IPADD(ip->iJmpBuiltinIsNotLong.op1);
-        } else {
-          ip = NEXTINST(JmpBuiltinIsNotLong);
+          JUMP_DISPATCH(IPADD(ip->iJmpBuiltinIsNotLong.op1));
         }
+        ip = NEXTINST(JmpBuiltinIsNotLong);
         DISPATCH;
       }
       INCDECOP(Inc)
@@ -2931,13 +2938,13 @@ tailCall:
       }
       CASE(StrictEq) {
         O1REG(StrictEq) = HermesValue::encodeBoolValue(
-            strictEqualityTest(O2REG(StrictEq), O3REG(StrictEq)));
+            strictEqualityTest(runtime, O2REG(StrictEq), O3REG(StrictEq)));
         ip = NEXTINST(StrictEq);
         DISPATCH;
       }
       CASE(StrictNeq) {
         O1REG(StrictNeq) = HermesValue::encodeBoolValue(
-            !strictEqualityTest(O2REG(StrictNeq), O3REG(StrictNeq)));
+            !strictEqualityTest(runtime, O2REG(StrictNeq), O3REG(StrictNeq)));
         ip = NEXTINST(StrictNeq);
         DISPATCH;
       }
@@ -3263,10 +3270,9 @@ tailCall:
       CASE(JmpTypeOfIs) {
         TypeOfIsTypes types(ip->iJmpTypeOfIs.op3);
         if (matchTypeOfIs(O2REG(JmpTypeOfIs), types)) {
-          ip = IPADD(ip->iJmpTypeOfIs.op1);
-        } else {
-          ip = NEXTINST(JmpTypeOfIs);
+          JUMP_DISPATCH(IPADD(ip->iJmpTypeOfIs.op1));
         }
+        ip = NEXTINST(JmpTypeOfIs);
         DISPATCH;
       }
 
@@ -3415,6 +3421,61 @@ tailCall:
         "All opcodes should dispatch to the next and not fallthrough "
         "to here");
 
+#if HERMESVM_JIT
+  backwardJump:
+    // ip is the header of a loop. Once the loop is hot, continue executing the
+    // rest of the function in JIT-compiled code, which takes over this frame.
+    if (!SingleStep &&
+        LLVM_UNLIKELY(runtime.jitContext_.countLoopIteration(curCodeBlock))) {
+      CAPTURE_IP_ASSIGN(
+          JITCompiledFunctionPtr osrPtr,
+          runtime.jitContext_.getOSREntry(runtime, curCodeBlock, CUROFFSET));
+      if (osrPtr) {
+        PROFILER_EXIT_FUNCTION(curCodeBlock);
+
+#ifdef HERMES_MEMORY_INSTRUMENTATION
+        runtime.popCallStack();
+#endif
+
+        // The JIT-compiled code pops the frame when it returns, so save where
+        // we are returning to first.
+        const Inst *savedIP = FRAME.getSavedIP();
+        CodeBlock *savedCodeBlock = FRAME.getSavedCodeBlock();
+
+        CAPTURE_IP_ASSIGN(
+            auto osrRes, JSFunction::_jittedOSRCall(osrPtr, runtime));
+
+        ip = savedIP;
+        curCodeBlock = savedCodeBlock;
+        frameRegs = &runtime.getCurrentFrame().getFirstLocalRef();
+
+        // Are we returning to native code?
+        if (!curCodeBlock) {
+          SLOW_DEBUG(dbgs() << "OSR exit: returning to native code\n");
+          return osrRes;
+        }
+
+        INIT_STATE_FOR_CODEBLOCK(curCodeBlock);
+        if (LLVM_UNLIKELY(osrRes == ExecutionStatus::EXCEPTION))
+          goto exception;
+        O1REG(Call) = *osrRes;
+
+#ifdef HERMES_ENABLE_DEBUGGER
+        if (LLVM_UNLIKELY(curCodeBlock->getNumInstalledBreakpoints() > 0)) {
+          ip = IPADD(
+              inst::getInstSize(
+                  runtime.debugger_.getRealOpCode(curCodeBlock, CUROFFSET)));
+        } else {
+          ip = nextInstCall(ip);
+        }
+#else
+        ip = nextInstCall(ip);
+#endif
+      }
+    }
+    DISPATCH;
+#endif
+
   exception:
     UPDATE_OPCODE_TIME_SPENT;
     assert(
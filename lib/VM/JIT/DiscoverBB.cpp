@@ -24,7 +24,8 @@ using hermes::inst::OperandType;
 void discoverBasicBlocks(
     CodeBlock *codeBlock,
     std::vector<uint32_t> &basicBlocks,
-    llvh::DenseMap<uint32_t, unsigned> &labels) {
+    llvh::DenseMap<uint32_t, unsigned> &labels,
+    std::vector<uint32_t> *loopHeaders) {
   auto const begin = codeBlock->begin();
   auto const end = codeBlock->end();
 
@@ -109,6 +110,9 @@ void discoverBasicBlocks(
         // Add the branch destination as a label.
         addLabel(ip + offset);
         branch = true;
+        // A backward branch closes a loop.
+        if (loopHeaders && offset <= 0)
+          loopHeaders->push_back((uint32_t)(ip + offset - begin));
       }
     }
     ip += decoded.meta.size;
@@ -129,6 +133,13 @@ void discoverBasicBlocks(
     addLabel(begin + tryRegion.target);
   }
 
+  if (loopHeaders) {
+    std::sort(loopHeaders->begin(), loopHeaders->end());
+    loopHeaders->erase(
+        std::unique(loopHeaders->begin(), loopHeaders->end()),
+        loopHeaders->end());
+  }
+
   // Sort all labels into a sequence of basic blocks.
   basicBlocks.clear();
   basicBlocks.reserve(labelSet.size());
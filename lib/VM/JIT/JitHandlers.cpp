@@ -9,7 +9,7 @@
 #if HERMESVM_JIT
 #include "JitHandlers.h"
 
-#include "../../JSLib/JSLibInternal.h"
+#include "../JSLib/JSLibInternal.h"
 #include "hermes/VM/Callable.h"
 #include "hermes/VM/CodeBlock.h"
 #include "hermes/VM/Interpreter.h"
@@ -330,6 +330,8 @@ void _jit_put_by_id(
     // If we have a cache hit, reuse the cached offset and immediately
     // return the property.
     if (LLVM_LIKELY(cacheEntry->clazz == clazzPtr)) {
+      PROPERTY_CACHE_COUNT_MONO_HIT(
+          runtime, cacheEntry, SymbolID::unsafeCreate(symID), true);
       JSObject::setNamedSlotValueUnsafe(
           obj, runtime, cacheEntry->getSlot(), shv);
       return;
@@ -34,8 +34,12 @@ struct PerfJitHeader {
   uint32_t version = 1;
   /// Total size of header
   uint32_t totalSize;
-  /// ELF mach target. We only support AArch64 for now.
+  /// ELF mach target of the JIT backend.
+#if defined(__x86_64__)
+  uint32_t elfMach = EM_X86_64;
+#else
   uint32_t elfMach = EM_AARCH64;
+#endif
   /// Reserved for future use.
   uint32_t pad1 = 0;
   /// JIT process id.
@@ -208,6 +208,20 @@ JITCompiledFunctionPtr JITContext::compileImpl(
   return compiler.compileCodeBlock();
 }
 
+JITCompiledFunctionPtr JITContext::getOSREntry(
+    Runtime &runtime,
+    CodeBlock *codeBlock,
+    uint32_t offset) {
+  // Count the iterations again from 0, so a loop that can't be entered yet is
+  // retried after another OSR threshold of iterations.
+  codeBlock->clearLoopIterationCount();
+  if (!codeBlock->getJITCompiled()) {
+    if (codeBlock->getDontJIT() || !compileImpl(runtime, codeBlock))
+      return nullptr;
+  }
+  return codeBlock->getJITOSREntry(offset);
+}
+
 JITCompiledFunctionPtr JITContext::Compiler::compileCodeBlock() {
   if (_sh_setjmp(errorJmpBuf_) == 0) {
     auto res = compileCodeBlockImpl();
@@ -273,7 +287,8 @@ JITCompiledFunctionPtr JITContext::Compiler::compileCodeBlockImpl() {
                  << codeBlock_->getFunctionID() << ", '" << funcName_ << "'\n";
   }
 
-  discoverBasicBlocks(codeBlock_, basicBlocks_, ofsToBBIndex_);
+  std::vector<uint32_t> loopHeaders;
+  discoverBasicBlocks(codeBlock_, basicBlocks_, ofsToBBIndex_, &loopHeaders);
 
   if ((jc_.dumpJITCode_ & DumpJitCode::Code) && !funcName_.empty())
     llvh::outs() << "\n" << funcName_ << ":\n";
@@ -295,6 +310,13 @@ JITCompiledFunctionPtr JITContext::Compiler::compileCodeBlockImpl() {
     compileBB(bbIndex);
   }
 
+  // The interpreter can continue a running call in the compiled code at the
+  // start of any loop.
+  if (kOSRSupported) {
+    for (uint32_t ofs : loopHeaders)
+      em_.addOSREntry(ofs, bbLabels_[ofsToBBIndex_.at(ofs)]);
+  }
+
   auto excTable =
       codeBlock_->getRuntimeModule()->getBytecode()->getExceptionTable(
           codeBlock_->getFunctionID());
@@ -322,6 +344,8 @@ JITCompiledFunctionPtr JITContext::Compiler::compileCodeBlockImpl() {
   }
 
   codeBlock_->setJITCompiled(em_.addToRuntime(jc_.impl_->jr));
+  codeBlock_->setJITOSREntries(
+      em_.getOSREntries(codeBlock_->getJITCompiled()));
 
   if (jc_.perfJitDump_) {
     // Write the JIT dump for this function.
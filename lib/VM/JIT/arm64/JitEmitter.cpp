@@ -10,7 +10,7 @@
 #include "JitEmitter.h"
 #include "JitImpl.h"
 
-#include "JitHandlers.h"
+#include "../JitHandlers.h"
 
 #include "../RuntimeOffsets.h"
 #include "hermes/BCGen/SerializedLiteralParser.h"
@@ -1353,90 +1353,7 @@ void Emitter::frameSetup(
   gpSaveCount_ = gpSaveCount;
   vecSaveCount_ = vecSaveCount;
 
-  // Higher addresses are at the top.
-  // +-----------------------------+<---- old sp
-  // |             x30             |
-  // +-----------------------------+
-  // |             x29             |
-  // +-----------------------------+<---- new x29
-  // |             ...             |
-  // +-----------------------------+
-  // |             x21             |
-  // +-----------------------------+
-  // |             x20             |
-  // +-----------------------------+
-  // |             x19             |
-  // +-----------------------------+
-  // |  Saved SHLocals* (optional) |
-  // +-----------------------------+
-  // |      SHJmpBuf (optional)    |
-  // +-----------------------------+<--- new sp
-  a.sub(a64::sp, a64::sp, getStackSize());
-
-  unsigned stackOfs = getSavedRegsOffset();
-  for (unsigned i = 0; i < gpSaveCount; i += 2, stackOfs += 16) {
-    if (i + 1 < gpSaveCount)
-      a.stp(a64::GpX(19 + i), a64::GpX(20 + i), a64::Mem(a64::sp, stackOfs));
-    else
-      a.str(a64::GpX(19 + i), a64::Mem(a64::sp, stackOfs));
-  }
-  for (unsigned i = 0; i < vecSaveCount; i += 2, stackOfs += 16) {
-    if (i + 1 < vecSaveCount)
-      a.stp(
-          a64::VecD(kVecSaved.first + i),
-          a64::VecD(kVecSaved.first + 1 + i),
-          a64::Mem(a64::sp, stackOfs));
-    else
-      a.str(a64::VecD(kVecSaved.first + i), a64::Mem(a64::sp, stackOfs));
-  }
-  a.stp(a64::x29, a64::x30, a64::Mem(a64::sp, stackOfs));
-  a.add(a64::x29, a64::sp, stackOfs);
-
-  comment("// xRuntime");
-  a.mov(xRuntime, a64::x0);
-
-  // Save the SHLocals pointer because we don't allocate and push a new
-  // SHLocals in the JIT.
-  // Used in CatchInst to restore state.
-  if (catchTableLabel_.isValid()) {
-    comment("// saved SHLocals *");
-    a.ldr(a64::x0, a64::Mem(xRuntime, RuntimeOffsets::shLocals));
-    a.str(a64::x0, a64::Mem(a64::sp, getSavedSHLocalsOffset()));
-  }
-
-#ifndef HERMES_CHECK_NATIVE_STACK
-#error Only native stack checking is supported in the JIT
-#endif
-
-  comment("// _sh_check_native_stack_overflow");
-  asmjit::Label nativeOverflowLab = newSlowPathLabel();
-  asmjit::Label nativeOverflowContLab = newContLabel();
-  // Get the stack bounds from the runtime.
-  a.ldr(a64::x0, a64::Mem(xRuntime, RuntimeOffsets::nativeStackHigh));
-  a.ldr(a64::x1, a64::Mem(xRuntime, RuntimeOffsets::nativeStackSize));
-  // Subtract the frame pointer from nativeStackHigh and compare it against the
-  // size. If the difference is less than the stack size, then we are still
-  // within the current stack bounds.
-  a.sub(a64::x0, a64::x0, a64::x29);
-  a.cmp(a64::x0, a64::x1);
-  // If the frame pointer is within bounds, we are done. Otherwise, we need to
-  // check if the bounds have changed.
-  a.b_hi(nativeOverflowLab);
-  a.bind(nativeOverflowContLab);
-  slowPaths_.push_back(
-      {.slowPathLab = nativeOverflowLab,
-       .contLab = nativeOverflowContLab,
-       .emit = [](Emitter &em, SlowPath &sl) {
-         em.comment("// Slow path: _sh_check_native_stack_overflow");
-         em.a.bind(sl.slowPathLab);
-         em.a.mov(a64::x0, xRuntime);
-         // Do not save the IP because we have not yet set up the stack frame
-         // for this function. If this throws, the exception should appear in
-         // the caller.
-         EMIT_RUNTIME_CALL_WITHOUT_THUNK_AND_SAVED_IP(
-             em, void (*)(SHRuntime *), _sh_check_native_stack_overflow);
-         em.a.b(sl.contLab);
-       }});
+  emitNativePrologue();
 
   comment("// xFrame");
   a.ldr(xFrame, a64::Mem(xRuntime, RuntimeOffsets::stackPointer));
@@ -1579,26 +1496,7 @@ void Emitter::frameSetup(
              em, void (*)(SHRuntime *), _sh_throw_register_stack_overflow);
        }});
 
-  if (catchTableLabel_.isValid()) {
-    comment("// _sh_try");
-    uint32_t jmpBufOffset = getJmpBufOffset();
-    // buf->prev = shr->shCurJmpBuf;
-    a.ldr(a64::x0, a64::Mem(xRuntime, offsetof(SHRuntime, shCurJmpBuf)));
-    a.str(a64::x0, a64::Mem(a64::sp, jmpBufOffset + offsetof(SHJmpBuf, prev)));
-
-    // shr->shCurJmpBuf = buf;
-    a.add(a64::x0, a64::sp, jmpBufOffset);
-    a.str(a64::x0, a64::Mem(xRuntime, offsetof(SHRuntime, shCurJmpBuf)));
-
-    // _setjmp(buf->buf);
-    a.add(a64::x0, a64::sp, jmpBufOffset + offsetof(SHJmpBuf, buf));
-    // setjmp can't throw and it'll be called once, so don't use a thunk.
-    EMIT_RUNTIME_CALL_WITHOUT_THUNK_AND_SAVED_IP(
-        *this, int (*)(jmp_buf), _sh_setjmp);
-    // If this a catch, go to the catch table to jump to either a handler BB or
-    // rethrow.
-    a.cbnz(a64::x0, catchTableLabel_);
-  }
+  emitTry();
 
   if (dumpJitCode_ & DumpJitCode::EntryExit) {
     comment("// print entry");
@@ -1610,6 +1508,166 @@ void Emitter::frameSetup(
   }
 }
 
+void Emitter::emitNativePrologue() {
+  // Higher addresses are at the top.
+  // +-----------------------------+<---- old sp
+  // |             x30             |
+  // +-----------------------------+
+  // |             x29             |
+  // +-----------------------------+<---- new x29
+  // |             ...             |
+  // +-----------------------------+
+  // |             x21             |
+  // +-----------------------------+
+  // |             x20             |
+  // +-----------------------------+
+  // |             x19             |
+  // +-----------------------------+
+  // |  Saved SHLocals* (optional) |
+  // +-----------------------------+
+  // |      SHJmpBuf (optional)    |
+  // +-----------------------------+<--- new sp
+  a.sub(a64::sp, a64::sp, getStackSize());
+
+  unsigned stackOfs = getSavedRegsOffset();
+  for (unsigned i = 0; i < gpSaveCount_; i += 2, stackOfs += 16) {
+    if (i + 1 < gpSaveCount_)
+      a.stp(a64::GpX(19 + i), a64::GpX(20 + i), a64::Mem(a64::sp, stackOfs));
+    else
+      a.str(a64::GpX(19 + i), a64::Mem(a64::sp, stackOfs));
+  }
+  for (unsigned i = 0; i < vecSaveCount_; i += 2, stackOfs += 16) {
+    if (i + 1 < vecSaveCount_)
+      a.stp(
+          a64::VecD(kVecSaved.first + i),
+          a64::VecD(kVecSaved.first + 1 + i),
+          a64::Mem(a64::sp, stackOfs));
+    else
+      a.str(a64::VecD(kVecSaved.first + i), a64::Mem(a64::sp, stackOfs));
+  }
+  a.stp(a64::x29, a64::x30, a64::Mem(a64::sp, stackOfs));
+  a.add(a64::x29, a64::sp, stackOfs);
+
+  comment("// xRuntime");
+  a.mov(xRuntime, a64::x0);
+
+  // Save the SHLocals pointer because we don't allocate and push a new
+  // SHLocals in the JIT.
+  // Used in CatchInst to restore state.
+  if (catchTableLabel_.isValid()) {
+    comment("// saved SHLocals *");
+    a.ldr(a64::x0, a64::Mem(xRuntime, RuntimeOffsets::shLocals));
+    a.str(a64::x0, a64::Mem(a64::sp, getSavedSHLocalsOffset()));
+  }
+
+#ifndef HERMES_CHECK_NATIVE_STACK
+#error Only native stack checking is supported in the JIT
+#endif
+
+  comment("// _sh_check_native_stack_overflow");
+  asmjit::Label nativeOverflowLab = newSlowPathLabel();
+  asmjit::Label nativeOverflowContLab = newContLabel();
+  // Get the stack bounds from the runtime.
+  a.ldr(a64::x0, a64::Mem(xRuntime, RuntimeOffsets::nativeStackHigh));
+  a.ldr(a64::x1, a64::Mem(xRuntime, RuntimeOffsets::nativeStackSize));
+  // Subtract the frame pointer from nativeStackHigh and compare it against the
+  // size. If the difference is less than the stack size, then we are still
+  // within the current stack bounds.
+  a.sub(a64::x0, a64::x0, a64::x29);
+  a.cmp(a64::x0, a64::x1);
+  // If the frame pointer is within bounds, we are done. Otherwise, we need to
+  // check if the bounds have changed.
+  a.b_hi(nativeOverflowLab);
+  a.bind(nativeOverflowContLab);
+  slowPaths_.push_back(
+      {.slowPathLab = nativeOverflowLab,
+       .contLab = nativeOverflowContLab,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment("// Slow path: _sh_check_native_stack_overflow");
+         em.a.bind(sl.slowPathLab);
+         em.a.mov(a64::x0, xRuntime);
+         // Do not save the IP because we have not yet set up the stack frame
+         // for this function, or, at an OSR entry, because the interpreter
+         // has saved it. If this throws, the exception should appear in the
+         // caller.
+         EMIT_RUNTIME_CALL_WITHOUT_THUNK_AND_SAVED_IP(
+             em, void (*)(SHRuntime *), _sh_check_native_stack_overflow);
+         em.a.b(sl.contLab);
+       }});
+}
+
+void Emitter::emitTry() {
+  if (!catchTableLabel_.isValid())
+    return;
+
+  comment("// _sh_try");
+  uint32_t jmpBufOffset = getJmpBufOffset();
+  // buf->prev = shr->shCurJmpBuf;
+  a.ldr(a64::x0, a64::Mem(xRuntime, offsetof(SHRuntime, shCurJmpBuf)));
+  a.str(a64::x0, a64::Mem(a64::sp, jmpBufOffset + offsetof(SHJmpBuf, prev)));
+
+  // shr->shCurJmpBuf = buf;
+  a.add(a64::x0, a64::sp, jmpBufOffset);
+  a.str(a64::x0, a64::Mem(xRuntime, offsetof(SHRuntime, shCurJmpBuf)));
+
+  // _setjmp(buf->buf);
+  a.add(a64::x0, a64::sp, jmpBufOffset + offsetof(SHJmpBuf, buf));
+  // setjmp can't throw and it'll be called once, so don't use a thunk.
+  EMIT_RUNTIME_CALL_WITHOUT_THUNK_AND_SAVED_IP(
+      *this, int (*)(jmp_buf), _sh_setjmp);
+  // If this a catch, go to the catch table to jump to either a handler BB or
+  // rethrow.
+  a.cbnz(a64::x0, catchTableLabel_);
+}
+
+void Emitter::addOSREntry(uint32_t offset, const asmjit::Label &target) {
+  osrEntries_.push_back(
+      {.offset = offset,
+       .target = target,
+       .entry = newPrefLabel("OSR_", osrEntries_.size())});
+}
+
+void Emitter::emitOSREntries() {
+  for (const OSREntry &osr : osrEntries_) {
+    comment("// OSR entry at bytecode offset %u", osr.offset);
+    a.bind(osr.entry);
+    emitNativePrologue();
+
+    // Take over the frame of the interpreter, which is the current frame and
+    // already has its registers allocated and initialized.
+    comment("// xFrame");
+    a.ldr(xFrame, a64::Mem(xRuntime, RuntimeOffsets::currentFrame));
+    emitTry();
+
+    // The interpreter keeps every register in the frame, so load the ones
+    // that live in hardware registers in the compiled code.
+    for (unsigned i = 0, e = frameRegs_.size(); i < e; ++i) {
+      if (HWReg hwReg = frameRegs_[i].globalReg)
+        _loadFrame(hwReg, FR(i));
+    }
+    a.b(osr.target);
+  }
+}
+
+std::vector<JITOSREntry> Emitter::getOSREntries(JITCompiledFunctionPtr fn) {
+  std::vector<JITOSREntry> entries;
+  entries.reserve(osrEntries_.size());
+  for (const OSREntry &osr : osrEntries_) {
+    entries.push_back(
+        {.offset = osr.offset,
+         .entry = reinterpret_cast<JITCompiledFunctionPtr>(
+             reinterpret_cast<uintptr_t>(fn) +
+             code.labelOffsetFromBase(osr.entry))});
+  }
+  std::sort(
+      entries.begin(),
+      entries.end(),
+      [](const JITOSREntry &a, const JITOSREntry &b) {
+        return a.offset < b.offset;
+      });
+  return entries;
+}
+
 void Emitter::leave(llvh::ArrayRef<const asmjit::Label *> exceptionHandlers) {
   comment("// leaveFrame");
   a.bind(returnLabel_);
@@ -1666,6 +1724,7 @@ void Emitter::leave(llvh::ArrayRef<const asmjit::Label *> exceptionHandlers) {
 
   a.ret(a64::x30);
 
+  emitOSREntries();
   emitCatchTable(exceptionHandlers);
   emitSlowPaths();
   emitThunks();
@@ -4919,7 +4978,13 @@ class HERMES_ATTRIBUTE_INTERNAL_LINKAGE Emitter::GetByIdImpl {
     // Ensure the source register is in memory for the slow path.
     _.syncToFrame(frSource);
 
-    if (cacheIdx != hbc::PROPERTY_CACHING_DISABLED) {
+#ifdef HERMESVM_PROPERTY_CACHE_STATS
+    // Let the out-of-line implementation count monomorphic hits.
+    constexpr bool kEmitFastPath = false;
+#else
+    constexpr bool kEmitFastPath = true;
+#endif
+    if (kEmitFastPath && cacheIdx != hbc::PROPERTY_CACHING_DISABLED) {
       slowPathLab = a.newLabel();
       contLab = a.newLabel();
       emitFastPath();
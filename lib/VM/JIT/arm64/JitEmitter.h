@@ -405,6 +405,18 @@ class Emitter {
   unsigned gpSaveCount_ = 0;
   unsigned vecSaveCount_ = 0;
 
+  /// An on-stack replacement entry point requested by addOSREntry().
+  struct OSREntry {
+    /// Bytecode offset of the loop header.
+    uint32_t offset;
+    /// The label of the loop header basic block.
+    asmjit::Label target;
+    /// The label of the entry point.
+    asmjit::Label entry;
+  };
+  /// The entry points to emit in leave().
+  llvh::SmallVector<OSREntry, 2> osrEntries_{};
+
  public:
   asmjit::CodeHolder code{};
   a64::Assembler a{};
@@ -449,6 +461,15 @@ class Emitter {
   void leave(llvh::ArrayRef<const asmjit::Label *> exceptionHandlers);
   void newBasicBlock(const asmjit::Label &label);
 
+  /// Request an on-stack replacement entry point, which continues the frame
+  /// set up by the interpreter at \p target, the label of the basic block at
+  /// bytecode \p offset. The entry points are emitted by leave().
+  void addOSREntry(uint32_t offset, const asmjit::Label &target);
+
+  /// \return the on-stack replacement entry points of \p fn, which was
+  ///   returned by addToRuntime(), sorted by bytecode offset.
+  std::vector<JITOSREntry> getOSREntries(JITCompiledFunctionPtr fn);
+
   /// Abort execution.
   void unreachable();
 
@@ -1142,6 +1163,18 @@ class Emitter {
       unsigned gpSaveCount,
       unsigned vecSaveCount);
 
+  /// Emit the part of the prologue shared by the function entry and the
+  /// on-stack replacement entries: allocate the native stack frame, save the
+  /// callee-saved registers, initialize xRuntime and check for native stack
+  /// overflow.
+  void emitNativePrologue();
+
+  /// Emit _sh_try if the function has a catch table.
+  void emitTry();
+
+  /// Emit the entry points requested by addOSREntry().
+  void emitOSREntries();
+
   asmjit::Label newSlowPathLabel() {
     return newPrefLabel("SLOW_", slowPaths_.size());
   }
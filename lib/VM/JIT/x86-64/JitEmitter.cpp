@@ -0,0 +1,3597 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JIT/Config.h"
+#if HERMESVM_JIT
+#include "JitEmitter.h"
+#include "JitImpl.h"
+
+#include "../JitHandlers.h"
+
+#include "../RuntimeOffsets.h"
+#include "hermes/Support/ErrorHandling.h"
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/StaticHUtils.h"
+#include "hermes/VMLayouts/StackFrameLayout.h"
+
+#define DEBUG_TYPE "jit"
+
+// Disable warnings about missing designated initializers since they occur often
+// when we construct SlowPaths.
+#ifdef __clang__
+#if __has_warning("-Wmissing-designated-field-initializers")
+#pragma clang diagnostic ignored "-Wmissing-designated-field-initializers"
+#endif
+#endif
+
+#if defined(HERMESVM_COMPRESSED_POINTERS) && !defined(HERMESVM_CONTIGUOUS_HEAP)
+#error JIT does not support non-contiguous heap with compressed pointers
+#endif
+
+namespace hermes::vm::x86_64 {
+
+namespace {
+
+// Ensure that HermesValue tags are handled correctly by updating this every
+// time the HERMESVALUE_VERSION changes, and going through the JIT and updating
+// any relevant code.
+static_assert(
+    HERMESVALUE_VERSION == 2,
+    "HermesValue version mismatch, JIT may need to be updated");
+
+/// The smallest raw HermesValue that is an object. Objects have the highest
+/// tag, so any value above or equal to this is an object.
+constexpr uint64_t kObjectTagBits = (uint64_t)(int64_t)HVTag_Object
+    << kHV_NumDataBits;
+static_assert(
+    (int16_t)HVTag_Object == (int16_t)(-1) && "HV_TagObject must be -1");
+
+/// The smallest raw HermesValue that is not a double.
+constexpr uint64_t kFirstTagBits = (uint64_t)(int64_t)HVTag_First
+    << kHV_NumDataBits;
+
+/// The tag bits of a string.
+constexpr uint64_t kStrTagBits = (uint64_t)(int64_t)HVTag_Str
+    << kHV_NumDataBits;
+
+/// Extract the pointer from the HermesValue in \p gp.
+void emit_sh_ljs_get_pointer(x86::Assembler &a, const x86::Gp &gp) {
+  static_assert(
+      HERMESVALUE_VERSION == 2 && kHV_NumDataBits == 48,
+      "the pointer is the low 48 bits of the value");
+  a.shl(gp, 64 - kHV_NumDataBits);
+  a.shr(gp, 64 - kHV_NumDataBits);
+}
+
+/// Encode the pointer in \p gp as an object HermesValue, using \p tmp.
+void emit_sh_ljs_object(
+    x86::Assembler &a,
+    const x86::Gp &gp,
+    const x86::Gp &tmp) {
+  a.mov(tmp, kObjectTagBits);
+  a.or_(gp, tmp);
+}
+
+/// Set "below" if the HermesValue in \p gp is not an object, using \p tmp.
+void emit_sh_ljs_cmp_object(
+    x86::Assembler &a,
+    const x86::Gp &gp,
+    const x86::Gp &tmp) {
+  a.mov(tmp, kObjectTagBits);
+  a.cmp(gp, tmp);
+}
+
+class OurErrorHandler : public asmjit::ErrorHandler {
+  asmjit::Error &expectedError_;
+  std::function<void(std::string &&message)> const longjmpError_;
+
+ public:
+  /// \param expectedError if we get an error matching this value, we ignore it.
+  explicit OurErrorHandler(
+      asmjit::Error &expectedError,
+      const std::function<void(std::string &&message)> &longjmpError)
+      : expectedError_(expectedError), longjmpError_(longjmpError) {}
+
+  void handleError(
+      asmjit::Error err,
+      const char *message,
+      asmjit::BaseEmitter *origin) override {
+    if (err == expectedError_) {
+      LLVM_DEBUG(
+          llvh::outs() << "Expected AsmJit error: " << err << ": "
+                       << asmjit::DebugUtils::errorAsString(err) << ": "
+                       << message << "\n");
+      return;
+    }
+
+    std::string formattedMsg{};
+    {
+      // Ensure we run any destructors for the ostream before longjmp.
+      llvh::raw_string_ostream OS{formattedMsg};
+      OS << "AsmJit error: " << err << ": "
+         << asmjit::DebugUtils::errorAsString(err) << ": " << message;
+      OS.flush();
+    }
+
+    // IMPORTANT: From here on, we MUST ensure that no destructors need to run.
+    // One exception: formattedMsg will have its destructor skipped, but we're
+    // moving out of it so in practice the std::string won't have anything to
+    // free, avoiding leaks.
+    LLVM_DEBUG(llvh::dbgs() << formattedMsg << "\n");
+    longjmpError_(std::move(formattedMsg));
+  }
+};
+
+#ifndef ASMJIT_NO_LOGGING
+class OurLogger : public asmjit::Logger {
+ private:
+  x86::Assembler &a_;
+  PerfJitDump *perfJitDump_{nullptr};
+  bool dumpJitCode_{false};
+
+ public:
+  OurLogger(x86::Assembler &a, PerfJitDump *perfJitDump, bool dumpJitCode)
+      : a_(a), perfJitDump_(perfJitDump), dumpJitCode_(dumpJitCode) {}
+
+  ASMJIT_API asmjit::Error _log(const char *data, size_t size) noexcept
+      override {
+    auto str =
+        (size == SIZE_MAX ? llvh::StringRef(data)
+                          : llvh::StringRef(data, size));
+    if (str.empty())
+      return asmjit::kErrorOk;
+    if (dumpJitCode_)
+      llvh::outs() << str;
+    if (!perfJitDump_)
+      return asmjit::kErrorOk;
+
+    // Comments by default do not have indentation, except some pseudocode
+    // comments, which start with ';' after indentation.
+    auto trimmed = str.ltrim();
+    if (str.front() != ' ' || (!trimmed.empty() && trimmed.front() == ';')) {
+      perfJitDump_->addCodeComment(str, a_.offset());
+    }
+    return asmjit::kErrorOk;
+  }
+};
+#endif
+
+} // unnamed namespace
+
+/// Save the current IP and emit a call to a runtime function. This should be
+/// used in most cases when invoking slow paths and handlers for complex
+/// functionality.
+#define EMIT_RUNTIME_CALL(em, type, func)           \
+  do {                                              \
+    using _FnT = type;                              \
+    _FnT _fn = func;                                \
+    (void)_fn;                                      \
+    (em).callThunkWithSavedIP((void *)func, #func); \
+  } while (0)
+
+/// Call a runtime function without saving the IP. This is intended for special
+/// cases where we want to preserve the currently saved IP or if the IP is not
+/// needed.
+#define EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(em, type, func) \
+  do {                                                     \
+    using _FnT = type;                                     \
+    _FnT _fn = func;                                       \
+    (void)_fn;                                             \
+    (em).callWithoutThunk((void *)func, #func);            \
+  } while (0)
+
+Emitter::Emitter(
+    Runtime &runtime,
+    JITContext::Impl &jitImpl,
+    unsigned dumpJitCode,
+    bool emitAsserts,
+    bool emitCounters,
+    PerfJitDump *perfJitDump,
+    CodeBlock *codeBlock,
+    const std::function<void(std::string &&message)> &longjmpError)
+    : runtime_(runtime),
+      jitImpl_(jitImpl),
+      dumpJitCode_(dumpJitCode),
+      emitAsserts_(emitAsserts),
+      emitCounters_(emitCounters),
+      numFrameRegs_(codeBlock->getFrameSize()),
+      codeBlock_(codeBlock) {
+  errorHandler_ = std::unique_ptr<asmjit::ErrorHandler>(
+      new OurErrorHandler(expectedError_, longjmpError));
+
+  code.init(jitImpl.jr.environment(), jitImpl.jr.cpuFeatures());
+  code.setErrorHandler(errorHandler_.get());
+
+#ifndef ASMJIT_NO_LOGGING
+  if ((dumpJitCode_ & DumpJitCode::Code) || perfJitDump) {
+    logger_ = std::unique_ptr<asmjit::Logger>(
+        new OurLogger(a, perfJitDump, dumpJitCode_));
+    logger_->setIndentation(asmjit::FormatIndentationGroup::kCode, 4);
+    logger_->addFlags(asmjit::FormatFlags::kHexImms);
+    code.setLogger(logger_.get());
+  }
+#endif
+
+  code.attach(&a);
+
+  roDataLabel_ = a.newNamedLabel("RO_DATA");
+  returnLabel_ = a.newNamedLabel("leave");
+}
+
+void Emitter::comment(const char *fmt, ...) {
+  if (!hasLogger())
+    return;
+  va_list args;
+  va_start(args, fmt);
+  char buf[80];
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  a.comment(buf);
+}
+
+JITCompiledFunctionPtr Emitter::addToRuntime(asmjit::JitRuntime &jr) {
+  code.detach(&a);
+  JITCompiledFunctionPtr fn;
+  asmjit::Error err = jr.add(&fn, &code);
+  if (err) {
+    llvh::errs() << "AsmJit failed: " << asmjit::DebugUtils::errorAsString(err)
+                 << "\n";
+    hermes::hermes_fatal("AsmJit failed");
+  }
+  return fn;
+}
+
+void Emitter::newBasicBlock(const asmjit::Label &label) {
+  // All frame registers live in memory, so there is no state to reset.
+  a.bind(label);
+}
+
+int32_t Emitter::getDebugFunctionName() {
+  if (roOfsDebugFunctionName_ < 0) {
+    std::string str;
+    llvh::raw_string_ostream ss(str);
+    ss << codeBlock_->getFunctionID() << "(" << codeBlock_->getNameString()
+       << ")";
+    ss.flush();
+    int32_t size = str.size() + 1;
+    roOfsDebugFunctionName_ = reserveData(size, 1, asmjit::TypeId::kInt8, size);
+    memcpy(roData_.data() + roOfsDebugFunctionName_, str.data(), size);
+  }
+  return roOfsDebugFunctionName_;
+}
+
+uint32_t Emitter::getStackSize() const {
+  if (!catchTableLabel_.isValid())
+    return 0;
+  return llvh::alignTo(getSavedSHLocalsOffset() + sizeof(SHLocals *), 16);
+}
+
+void Emitter::enter() {
+  if (!codeBlock_->getRuntimeModule()
+           ->getBytecode()
+           ->getExceptionTable(codeBlock_->getFunctionID())
+           .empty())
+    catchTableLabel_ = a.newNamedLabel("CATCH_TABLE");
+
+  emitNativePrologue();
+
+  comment("// xFrame");
+  a.mov(xFrame, x86::qword_ptr(xRuntime, RuntimeOffsets::stackPointer));
+
+  // If the function has a prohibitInvoke flag, we need to check if it has been
+  // called correctly.
+  auto prohibitInvoke = codeBlock_->getHeaderFlags().getProhibitInvoke();
+  if (prohibitInvoke != ProhibitInvoke::None) {
+    // Compare new.target against undefined.
+    a.mov(x86::rax, frameSlotMem(StackFrameLayout::NewTarget));
+    loadBits64InGp(x86::rcx, _sh_ljs_undefined().raw);
+    a.cmp(x86::rax, x86::rcx);
+
+    void (*slowCall)(SHRuntime *);
+    const char *slowCallName;
+    asmjit::Label throwInvalidInvokeLab;
+    if (prohibitInvoke == ProhibitInvoke::Call) {
+      // If regular calls are prohibited, then we jump to throwInvalidInvoke if
+      // new.target is undefined.
+      throwInvalidInvokeLab = a.newNamedLabel("throwInvalidCall");
+      a.je(throwInvalidInvokeLab);
+
+      slowCall = _sh_throw_invalid_call;
+      slowCallName = "_sh_throw_invalid_call";
+    } else {
+      assert(
+          prohibitInvoke == ProhibitInvoke::Construct &&
+          "Unknown prohibitInvoke");
+      // If construct calls are prohibited, then we jump to throwInvalidInvoke
+      // if new.target is not undefined.
+      throwInvalidInvokeLab = a.newNamedLabel("throwInvalidConstruct");
+      a.jne(throwInvalidInvokeLab);
+
+      slowCall = _sh_throw_invalid_construct;
+      slowCallName = "_sh_throw_invalid_construct";
+    }
+
+    slowPaths_.push_back(
+        {.slowPathLab = throwInvalidInvokeLab,
+         .slowCall = (void *)slowCall,
+         .slowCallName = slowCallName,
+         .emit = [](Emitter &em, SlowPath &sl) {
+           em.comment("// Slow path: %s", sl.slowCallName);
+           em.a.bind(sl.slowPathLab);
+           em.a.mov(x86::rdi, xRuntime);
+           // Note that we don't save the IP, because this is being thrown in
+           // the caller's context.
+           em.callWithoutThunk(sl.slowCall, sl.slowCallName);
+           // Function does not return.
+         }});
+  }
+
+  // NOTE: Unlike _sh_enter, we do not push an SHLocals object.
+  comment("// _sh_enter");
+  asmjit::Label registerOverflowLab = newSlowPathLabel();
+
+  // Compute the remaining available stack space:
+  // runtime.registerStackEnd - runtime.stackPointer
+  a.mov(x86::rax, x86::qword_ptr(xRuntime, RuntimeOffsets::registerStackEnd));
+  a.sub(x86::rax, xFrame);
+  // Check if we need more registers than remain.
+  size_t totalRegsToAlloc = numFrameRegs_ + hbc::StackFrameLayout::FirstLocal;
+  size_t regAllocSize = totalRegsToAlloc * sizeof(SHLegacyValue);
+  if (regAllocSize > INT32_MAX)
+    hermes_fatal("JIT integer overflow");
+  a.cmp(x86::rax, (int32_t)regAllocSize);
+  a.jb(registerOverflowLab);
+
+  // Advance the register stack.
+  a.lea(x86::rax, x86::ptr(xFrame, (int32_t)regAllocSize));
+  a.mov(x86::qword_ptr(xRuntime, RuntimeOffsets::stackPointer), x86::rax);
+  a.mov(x86::qword_ptr(xRuntime, RuntimeOffsets::currentFrame), xFrame);
+
+  static_assert(
+      HERMESVALUE_VERSION == 2, "Raw zero value must be ignored by GC");
+  // Fill the registers with zero in groups of 4, then 2, then 1.
+  // If there are more than 32 registers, start with a loop.
+  a.pxor(x86::xmm0, x86::xmm0);
+  size_t regsToFill = totalRegsToAlloc;
+  int32_t fillOfs = 0;
+  if (regsToFill > 32) {
+    int32_t loopBytes =
+        llvh::alignDown(regsToFill, 4) * (int32_t)sizeof(SHLegacyValue);
+    a.mov(x86::rax, xFrame);
+    a.lea(x86::rcx, x86::ptr(xFrame, loopBytes));
+    asmjit::Label loop = a.newLabel();
+    a.bind(loop);
+    a.movups(x86::ptr(x86::rax), x86::xmm0);
+    a.movups(x86::ptr(x86::rax, 16), x86::xmm0);
+    a.add(x86::rax, 32);
+    a.cmp(x86::rax, x86::rcx);
+    a.jb(loop);
+
+    regsToFill %= 4;
+    fillOfs = loopBytes;
+  }
+  for (; regsToFill >= 2; regsToFill -= 2, fillOfs += 16)
+    a.movups(x86::ptr(xFrame, fillOfs), x86::xmm0);
+  if (regsToFill > 0) {
+    assert(regsToFill == 1 && "All regs must be filled");
+    a.movq(x86::qword_ptr(xFrame, fillOfs), x86::xmm0);
+  }
+
+  // Create the slow path for throwing a register stack overflow.
+  slowPaths_.push_back(
+      {.slowPathLab = registerOverflowLab,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment("// Slow path: _sh_throw_register_stack_overflow");
+         em.a.bind(sl.slowPathLab);
+         em.a.mov(x86::rdi, xRuntime);
+         // Do not save the IP because we have not yet set up the stack frame
+         // for this function. The exception should appear in the caller.
+         EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+             em, void (*)(SHRuntime *), _sh_throw_register_stack_overflow);
+       }});
+
+  emitTry();
+
+  if (dumpJitCode_ & DumpJitCode::EntryExit) {
+    comment("// print entry");
+    a.mov(x86::edi, 1);
+    a.lea(x86::rsi, x86::ptr(roDataLabel_, getDebugFunctionName()));
+    EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+        *this, void (*)(bool, const char *), _sh_print_function_entry_exit);
+  }
+}
+
+void Emitter::emitNativePrologue() {
+  // Higher addresses are at the top.
+  // +-----------------------------+
+  // |       return address        |
+  // +-----------------------------+
+  // |             rbp             |
+  // +-----------------------------+<---- new rbp
+  // |   rbx, r12, r13, r14        |
+  // +-----------------------------+
+  // |  Saved SHLocals* (optional) |
+  // +-----------------------------+
+  // |      SHJmpBuf (optional)    |
+  // +-----------------------------+<--- new rsp
+  // The return address and the five pushes leave rsp 16-byte aligned.
+  a.push(x86::rbp);
+  a.mov(x86::rbp, x86::rsp);
+  a.push(x86::rbx);
+  a.push(x86::r12);
+  a.push(x86::r13);
+  a.push(x86::r14);
+  if (uint32_t stackSize = getStackSize())
+    a.sub(x86::rsp, stackSize);
+
+  comment("// xRuntime");
+  a.mov(xRuntime, x86::rdi);
+  comment("// xBytecode");
+  a.mov(xBytecode, (uint64_t)codeBlock_->begin());
+
+  // Save the SHLocals pointer because we don't allocate and push a new
+  // SHLocals in the JIT.
+  // Used in CatchInst to restore state.
+  if (catchTableLabel_.isValid()) {
+    comment("// saved SHLocals *");
+    a.mov(x86::rax, x86::qword_ptr(xRuntime, RuntimeOffsets::shLocals));
+    a.mov(x86::qword_ptr(x86::rsp, getSavedSHLocalsOffset()), x86::rax);
+  }
+
+#ifndef HERMES_CHECK_NATIVE_STACK
+#error Only native stack checking is supported in the JIT
+#endif
+
+  comment("// _sh_check_native_stack_overflow");
+  asmjit::Label nativeOverflowLab = newSlowPathLabel();
+  asmjit::Label nativeOverflowContLab = newContLabel();
+  // Subtract the frame pointer from nativeStackHigh and compare it against the
+  // size. If the difference is less than the stack size, then we are still
+  // within the current stack bounds.
+  a.mov(x86::rax, x86::qword_ptr(xRuntime, RuntimeOffsets::nativeStackHigh));
+  a.sub(x86::rax, x86::rbp);
+  a.cmp(x86::rax, x86::qword_ptr(xRuntime, RuntimeOffsets::nativeStackSize));
+  // If the frame pointer is within bounds, we are done. Otherwise, we need to
+  // check if the bounds have changed.
+  a.ja(nativeOverflowLab);
+  a.bind(nativeOverflowContLab);
+  slowPaths_.push_back(
+      {.slowPathLab = nativeOverflowLab,
+       .contLab = nativeOverflowContLab,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment("// Slow path: _sh_check_native_stack_overflow");
+         em.a.bind(sl.slowPathLab);
+         em.a.mov(x86::rdi, xRuntime);
+         // Do not save the IP because we have not yet set up the stack frame
+         // for this function, or, at an OSR entry, because the interpreter
+         // has saved it. If this throws, the exception should appear in the
+         // caller.
+         EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+             em, void (*)(SHRuntime *), _sh_check_native_stack_overflow);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::emitTry() {
+  if (!catchTableLabel_.isValid())
+    return;
+
+  comment("// _sh_try");
+  int32_t jmpBufOffset = getJmpBufOffset();
+  // buf->prev = shr->shCurJmpBuf;
+  a.mov(x86::rax, x86::qword_ptr(xRuntime, offsetof(SHRuntime, shCurJmpBuf)));
+  a.mov(
+      x86::qword_ptr(x86::rsp, jmpBufOffset + offsetof(SHJmpBuf, prev)),
+      x86::rax);
+
+  // shr->shCurJmpBuf = buf;
+  a.lea(x86::rax, x86::ptr(x86::rsp, jmpBufOffset));
+  a.mov(x86::qword_ptr(xRuntime, offsetof(SHRuntime, shCurJmpBuf)), x86::rax);
+
+  // _setjmp(buf->buf);
+  a.lea(x86::rdi, x86::ptr(x86::rsp, jmpBufOffset + offsetof(SHJmpBuf, buf)));
+  // setjmp can't throw and it'll be called once, so don't save the IP.
+  EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(*this, int (*)(jmp_buf), _sh_setjmp);
+  // If this a catch, go to the catch table to jump to either a handler BB or
+  // rethrow.
+  a.test(x86::eax, x86::eax);
+  a.jnz(catchTableLabel_);
+}
+
+void Emitter::addOSREntry(uint32_t offset, const asmjit::Label &target) {
+  osrEntries_.push_back(
+      {.offset = offset,
+       .target = target,
+       .entry = newPrefLabel("OSR_", osrEntries_.size())});
+}
+
+void Emitter::emitOSREntries() {
+  for (const OSREntry &osr : osrEntries_) {
+    comment("// OSR entry at bytecode offset %u", osr.offset);
+    a.bind(osr.entry);
+    emitNativePrologue();
+
+    // Take over the frame of the interpreter, which is the current frame and
+    // already has its registers allocated and initialized. All frame registers
+    // live in the frame, so there is nothing else to load.
+    comment("// xFrame");
+    a.mov(xFrame, x86::qword_ptr(xRuntime, RuntimeOffsets::currentFrame));
+    emitTry();
+    a.jmp(osr.target);
+  }
+}
+
+std::vector<JITOSREntry> Emitter::getOSREntries(JITCompiledFunctionPtr fn) {
+  std::vector<JITOSREntry> entries;
+  entries.reserve(osrEntries_.size());
+  for (const OSREntry &osr : osrEntries_) {
+    entries.push_back(
+        {.offset = osr.offset,
+         .entry = reinterpret_cast<JITCompiledFunctionPtr>(
+             reinterpret_cast<uintptr_t>(fn) +
+             code.labelOffsetFromBase(osr.entry))});
+  }
+  std::sort(
+      entries.begin(),
+      entries.end(),
+      [](const JITOSREntry &a, const JITOSREntry &b) {
+        return a.offset < b.offset;
+      });
+  return entries;
+}
+
+void *Emitter::getLabelAddress(
+    JITCompiledFunctionPtr fn,
+    const asmjit::Label &label) {
+  return reinterpret_cast<void *>(
+      reinterpret_cast<uintptr_t>(fn) + code.labelOffsetFromBase(label));
+}
+
+void Emitter::leave(llvh::ArrayRef<const asmjit::Label *> exceptionHandlers) {
+  comment("// leaveFrame");
+  a.bind(returnLabel_);
+  if (dumpJitCode_ & DumpJitCode::EntryExit) {
+    comment("// print exit");
+    a.xor_(x86::edi, x86::edi);
+    a.lea(x86::rsi, x86::ptr(roDataLabel_, getDebugFunctionName()));
+    EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+        *this, void (*)(bool, const char *), _sh_print_function_entry_exit);
+  }
+
+  if (catchTableLabel_.isValid()) {
+    comment("// _sh_end_try");
+    // shr->shCurJmpBuf = buf->prev
+    int32_t jmpBufOffset = getJmpBufOffset();
+    a.mov(
+        x86::rax,
+        x86::qword_ptr(x86::rsp, jmpBufOffset + offsetof(SHJmpBuf, prev)));
+    a.mov(x86::qword_ptr(xRuntime, offsetof(SHRuntime, shCurJmpBuf)), x86::rax);
+  }
+
+  // _sh_leave(shr, &locals.head, frame);
+  // Restore the previous stack frame.
+  a.mov(x86::qword_ptr(xRuntime, RuntimeOffsets::stackPointer), xFrame);
+  a.mov(x86::rax, frameSlotMem(StackFrameLayout::PreviousFrame));
+  a.mov(x86::qword_ptr(xRuntime, RuntimeOffsets::currentFrame), x86::rax);
+
+  // The return value has been stashed in r13 by ret(). Move it to the return
+  // register.
+  a.mov(x86::rax, xRetVal);
+
+  a.lea(x86::rsp, x86::ptr(x86::rbp, -(int32_t)(kNumSavedGp * 8)));
+  a.pop(x86::r14);
+  a.pop(x86::r13);
+  a.pop(x86::r12);
+  a.pop(x86::rbx);
+  a.pop(x86::rbp);
+  a.ret();
+
+  emitOSREntries();
+  emitCatchTable(exceptionHandlers);
+  emitSlowPaths();
+  emitROData();
+}
+
+void Emitter::getBytecodeIP(const x86::Gp &dest) {
+  a.lea(dest, x86::ptr(xBytecode, codeBlock_->getOffsetOf(emittingIP)));
+}
+
+void Emitter::callWithoutThunk(void *fn, const char *name) {
+  comment("// call %s", name);
+  a.mov(x86::rax, (uint64_t)fn);
+  a.call(x86::rax);
+}
+
+void Emitter::callThunkWithSavedIP(void *fn, const char *name) {
+  // Save the current IP in the runtime.
+  getBytecodeIP(x86::rax);
+  a.mov(x86::qword_ptr(xRuntime, RuntimeOffsets::currentIP), x86::rax);
+
+  // Call the passed function.
+  callWithoutThunk(fn, name);
+
+  if (emitAsserts_) {
+    // Invalidate the current IP to make sure it is set before the next call.
+    a.mov(x86::rcx, (uint64_t)Runtime::kInvalidCurrentIP);
+    a.mov(x86::qword_ptr(xRuntime, RuntimeOffsets::currentIP), x86::rcx);
+  }
+}
+
+void Emitter::emitIncrementCounter(JitCounter counter) {
+  if (!emitCounters_)
+    return;
+  // r11 is never live across instructions, so it is free to use here.
+  a.mov(x86::r11, x86::qword_ptr(xRuntime, RuntimeOffsets::runtimeJitCounters));
+  a.inc(x86::qword_ptr(x86::r11, (unsigned)counter * sizeof(uint64_t)));
+}
+
+void Emitter::loadBits64InGp(const x86::Gp &dest, uint64_t bits) {
+  if (bits == 0)
+    a.xor_(dest.r32(), dest.r32());
+  else
+    a.mov(dest, bits);
+}
+
+void Emitter::loadFrameAddr(const x86::Gp &dst, FR frameReg) {
+  a.lea(dst, frMem(frameReg));
+}
+
+void Emitter::movGpFromFR(const x86::Gp &dst, FR src) {
+  a.mov(dst, frMem(src));
+}
+
+void Emitter::movFRFromGp(FR dst, const x86::Gp &src) {
+  a.mov(frMem(dst), src);
+}
+
+void Emitter::storeBoolFromEAX(FR frRes) {
+  a.shl(x86::rax, kHV_BoolBitIdx);
+  loadBits64InGp(x86::rcx, _sh_ljs_bool(false).raw);
+  a.or_(x86::rax, x86::rcx);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::cmpIsDouble(const x86::Gp &gp, const x86::Gp &tmp) {
+  a.mov(tmp, kFirstTagBits);
+  a.cmp(gp, tmp);
+}
+
+void Emitter::truncDoubleToInt32(
+    const x86::Xmm &xmm,
+    const x86::Xmm &xmmTmp,
+    const asmjit::Label &slowLab) {
+  // Truncate to 64 bits and check that converting back yields the same value.
+  // This rejects NaN (and so every non-number), infinities, fractions and
+  // anything out of range, while the low 32 bits of everything else are
+  // exactly ToInt32 of the value.
+  a.cvttsd2si(x86::rax, xmm);
+  a.cvtsi2sd(xmmTmp, x86::rax);
+  a.ucomisd(xmmTmp, xmm);
+  a.jne(slowLab);
+  a.jp(slowLab);
+}
+
+void Emitter::loadConstStringInGp(SymbolID id, const x86::Gp &gpOut) {
+  static_assert(
+      std::is_same_v<
+          RuntimeOffsets::IdentifierTableLookupVectorType,
+          TransparentConservativeVector<
+              RuntimeOffsets::IdentifierTableLookupEntryType>>,
+      "lookupVector_ must be transparent");
+  a.mov(
+      gpOut,
+      x86::qword_ptr(
+          xRuntime,
+          RuntimeOffsets::identifierTable +
+              RuntimeOffsets::identifierTableLookupVector +
+              TransparentConservativeVector<
+                  RuntimeOffsets::IdentifierTableLookupEntryType>::
+                  dataPointerOffset()));
+  // gpOut = gpOut[symID.index].strPrim_
+  size_t offset =
+      (id.unsafeGetIndex() * RuntimeOffsets::identifierTableLookupEntrySize) +
+      RuntimeOffsets::identifierTableLookupEntryStrPrim;
+  if (offset > INT32_MAX)
+    hermes_fatal("JIT integer overflow");
+  a.mov(gpOut, x86::qword_ptr(gpOut, (int32_t)offset));
+}
+
+void Emitter::loadCPNonNull(const x86::Gp &dest, const x86::Mem &mem) {
+#ifdef HERMESVM_COMPRESSED_POINTERS
+  x86::Mem mem32 = mem;
+  mem32.setSize(4);
+  a.mov(dest.r32(), mem32);
+  a.add(dest, xRuntime);
+#else
+  a.mov(dest, mem);
+#endif
+}
+
+void Emitter::loadReadCacheEntry(const x86::Gp &dest, uint8_t cacheIdx) {
+  if (cacheIdx == hbc::PROPERTY_CACHING_DISABLED) {
+    a.xor_(dest.r32(), dest.r32());
+  } else {
+    a.mov(
+        dest,
+        (uint64_t)codeBlock_->readPropertyCache() +
+            sizeof(SHReadPropertyCacheEntry) * cacheIdx);
+  }
+}
+
+void Emitter::loadWriteCacheEntry(const x86::Gp &dest, uint8_t cacheIdx) {
+  if (cacheIdx == hbc::PROPERTY_CACHING_DISABLED) {
+    a.xor_(dest.r32(), dest.r32());
+  } else {
+    a.mov(
+        dest,
+        (uint64_t)codeBlock_->writePropertyCache() +
+            sizeof(SHWritePropertyCacheEntry) * cacheIdx);
+  }
+}
+
+void Emitter::emitRJSCall(
+    FR frRes,
+    FR frInput1,
+    FR frInput2,
+    void *fn,
+    const char *fnName) {
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frInput1);
+  if (frInput2.isValid())
+    loadFrameAddr(x86::rdx, frInput2);
+  callThunkWithSavedIP(fn, fnName);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::unreachable() {
+  EMIT_RUNTIME_CALL(*this, void (*)(), _sh_unreachable);
+}
+
+void Emitter::profilePoint(uint16_t pointIndex) {
+  comment("// ProfilePoint %u", pointIndex);
+#ifdef HERMESVM_PROFILER_BB
+  a.mov(x86::rdi, xRuntime);
+  a.mov(x86::esi, pointIndex);
+  EMIT_RUNTIME_CALL(
+      *this,
+      void (*)(SHRuntime *, uint16_t),
+      _interpreter_register_bb_execution);
+#else
+  // No-op if profiling is not enabled.
+#endif
+}
+
+void Emitter::directEval(FR frRes, FR frText, bool strictCaller) {
+  comment("// DirectEval r%u, r%u", frRes.index(), frText.index());
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frText);
+  a.mov(x86::edx, (uint32_t)strictCaller);
+  EMIT_RUNTIME_CALL(
+      *this,
+      HermesValue (*)(Runtime &, PinnedHermesValue *, bool),
+      _jit_direct_eval);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::catchInst(FR frRes) {
+  comment("// Catch r%u", frRes.index());
+
+  // Catch simply returns the thrown value and clears it.
+  a.mov(x86::rax, x86::qword_ptr(xRuntime, RuntimeOffsets::thrownValue));
+  movFRFromGp(frRes, x86::rax);
+  loadBits64InGp(x86::rax, _sh_ljs_empty().raw);
+  a.mov(x86::qword_ptr(xRuntime, RuntimeOffsets::thrownValue), x86::rax);
+}
+
+void Emitter::ret(FR frValue) {
+  comment("// Ret r%u", frValue.index());
+  movGpFromFR(xRetVal, frValue);
+  a.jmp(returnLabel_);
+}
+
+void Emitter::mov(FR frRes, FR frInput, bool logComment) {
+  // Sometimes mov() is used by other instructions, so logging is optional.
+  if (logComment)
+    comment("// %s r%u, r%u", "mov", frRes.index(), frInput.index());
+  if (frRes == frInput)
+    return;
+  movGpFromFR(x86::rax, frInput);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::loadParam(FR frRes, uint32_t paramIndex) {
+  comment("// LoadParam r%u, %u", frRes.index(), paramIndex);
+
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  int64_t ofs = ((int64_t)StackFrameLayout::ThisArg - (int64_t)paramIndex) *
+      (int64_t)sizeof(SHLegacyValue);
+  if (ofs >= 0 || ofs < INT32_MIN)
+    hermes_fatal("JIT integer overflow");
+
+  a.cmp(x86::dword_ptr(xFrame, StackFrameLayout::ArgCount * 8), paramIndex);
+  a.jb(slowPathLab);
+  a.mov(x86::rax, x86::qword_ptr(xFrame, (int32_t)ofs));
+  a.bind(contLab);
+  movFRFromGp(frRes, x86::rax);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .frRes = frRes,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment("// Slow path: LoadParam r%u", sl.frRes.index());
+         em.a.bind(sl.slowPathLab);
+         em.loadBits64InGp(x86::rax, _sh_ljs_undefined().raw);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::loadConstDouble(FR frRes, double val, const char *name) {
+  comment("// LoadConst%s r%u, %f", name, frRes.index(), val);
+  loadBits64InGp(x86::rax, llvh::DoubleToBits(val));
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::loadConstBits64(
+    FR frRes,
+    uint64_t bits,
+    FRType type,
+    const char *name) {
+  comment(
+      "// LoadConst%s r%u, %llu",
+      name,
+      frRes.index(),
+      (unsigned long long)bits);
+  loadBits64InGp(x86::rax, bits);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::loadConstString(FR frRes, SymbolID symID) {
+  // The symbol was resolved on the mutator thread, so its StringPrimitive is
+  // known to be allocated in the IdentifierTable.
+  comment(
+      "// LoadConstString r%u, symbol %u",
+      frRes.index(),
+      symID.unsafeGetIndex());
+
+  loadConstStringInGp(symID, x86::rax);
+  a.mov(x86::rcx, kStrTagBits);
+  a.or_(x86::rax, x86::rcx);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::loadConstBigInt(
+    FR frRes,
+    RuntimeModule *runtimeModule,
+    uint32_t bigIntID) {
+  comment("// LoadConstBigInt r%u, bigIntID %u", frRes.index(), bigIntID);
+
+  a.mov(x86::rdi, xRuntime);
+  a.mov(x86::rsi, (uint64_t)runtimeModule);
+  a.mov(x86::edx, bigIntID);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, SHRuntimeModule *, uint32_t),
+      _sh_ljs_get_bytecode_bigint);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::toNumber(FR frRes, FR frInput) {
+  comment("// %s r%u, r%u", "toNumber", frRes.index(), frInput.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  movGpFromFR(x86::rax, frInput);
+  cmpIsDouble(x86::rax, x86::rcx);
+  a.jae(slowPathLab);
+  movFRFromGp(frRes, x86::rax);
+  a.bind(contLab);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .frRes = frRes,
+       .frInput1 = frInput,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: toNumber r%u, r%u",
+             sl.frRes.index(),
+             sl.frInput1.index());
+         em.a.bind(sl.slowPathLab);
+         em.a.mov(x86::rdi, xRuntime);
+         em.loadFrameAddr(x86::rsi, sl.frInput1);
+         EMIT_RUNTIME_CALL(
+             em,
+             double (*)(SHRuntime *, const SHLegacyValue *),
+             _sh_ljs_to_double_rjs);
+         em.a.movq(em.frMem(sl.frRes), x86::xmm0);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::toNumeric(FR frRes, FR frInput) {
+  comment("// %s r%u, r%u", "toNumeric", frRes.index(), frInput.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  movGpFromFR(x86::rax, frInput);
+  cmpIsDouble(x86::rax, x86::rcx);
+  a.jae(slowPathLab);
+  movFRFromGp(frRes, x86::rax);
+  a.bind(contLab);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .frRes = frRes,
+       .frInput1 = frInput,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: toNumeric r%u, r%u",
+             sl.frRes.index(),
+             sl.frInput1.index());
+         em.a.bind(sl.slowPathLab);
+         em.emitRJSCall(
+             sl.frRes,
+             sl.frInput1,
+             FR(),
+             (void *)_sh_ljs_to_numeric_rjs,
+             "_sh_ljs_to_numeric_rjs");
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::toInt32(FR frRes, FR frInput, bool isSigned) {
+  comment(
+      "// %s r%u, r%u",
+      isSigned ? "toInt32" : "toUint32",
+      frRes.index(),
+      frInput.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  a.movsd(x86::xmm0, frMem(frInput));
+  truncDoubleToInt32(x86::xmm0, x86::xmm1, slowPathLab);
+  if (isSigned) {
+    a.cvtsi2sd(x86::xmm0, x86::eax);
+  } else {
+    // Zero-extend the low 32 bits.
+    a.mov(x86::eax, x86::eax);
+    a.cvtsi2sd(x86::xmm0, x86::rax);
+  }
+  a.bind(contLab);
+  a.movq(frMem(frRes), x86::xmm0);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .frRes = frRes,
+       .frInput1 = frInput,
+       .slowCall = isSigned ? (void *)_sh_ljs_to_int32_rjs
+                            : (void *)_sh_ljs_to_uint32_rjs,
+       .slowCallName =
+           isSigned ? "_sh_ljs_to_int32_rjs" : "_sh_ljs_to_uint32_rjs",
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: %s r%u, r%u",
+             sl.slowCallName,
+             sl.frRes.index(),
+             sl.frInput1.index());
+         em.a.bind(sl.slowPathLab);
+         em.a.mov(x86::rdi, xRuntime);
+         em.loadFrameAddr(x86::rsi, sl.frInput1);
+         // The result is returned in xmm0.
+         em.callThunkWithSavedIP(sl.slowCall, sl.slowCallName);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::addEmptyString(FR frRes, FR frInput) {
+  comment("// addEmptyString r%u, r%u", frRes.index(), frInput.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  // Strings are returned unchanged.
+  movGpFromFR(x86::rax, frInput);
+  a.mov(x86::rcx, x86::rax);
+  a.sar(x86::rcx, kHV_NumDataBits);
+  a.cmp(x86::rcx, (int32_t)HVTag_Str);
+  a.jne(slowPathLab);
+  movFRFromGp(frRes, x86::rax);
+  a.bind(contLab);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .frRes = frRes,
+       .frInput1 = frInput,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: addEmptyString r%u, r%u",
+             sl.frRes.index(),
+             sl.frInput1.index());
+         em.a.bind(sl.slowPathLab);
+         em.emitRJSCall(
+             sl.frRes,
+             sl.frInput1,
+             FR(),
+             (void *)_sh_ljs_add_empty_string_rjs,
+             "_sh_ljs_add_empty_string_rjs");
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::mod(bool forceNumber, FR frRes, FR frLeft, FR frRight) {
+  comment(
+      "// %s r%u, r%u, r%u",
+      forceNumber ? "modN" : "mod",
+      frRes.index(),
+      frLeft.index(),
+      frRight.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  a.movsd(x86::xmm0, frMem(frLeft));
+  a.movsd(x86::xmm1, frMem(frRight));
+  if (!forceNumber) {
+    // Non-numbers are NaN-boxed, so they compare as unordered.
+    a.ucomisd(x86::xmm0, x86::xmm1);
+    a.jp(slowPathLab);
+  }
+  // _sh_mod_double can't throw or allocate, so don't save the IP.
+  EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+      *this, double (*)(double, double), _sh_mod_double);
+  a.movq(frMem(frRes), x86::xmm0);
+  a.bind(contLab);
+
+  if (forceNumber)
+    return;
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .frRes = frRes,
+       .frInput1 = frLeft,
+       .frInput2 = frRight,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: mod r%u, r%u, r%u",
+             sl.frRes.index(),
+             sl.frInput1.index(),
+             sl.frInput2.index());
+         em.a.bind(sl.slowPathLab);
+         em.emitRJSCall(
+             sl.frRes,
+             sl.frInput1,
+             sl.frInput2,
+             (void *)_sh_ljs_mod_rjs,
+             "_sh_ljs_mod_rjs");
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::arithUnop(
+    FR frRes,
+    FR frInput,
+    const char *name,
+    double addend,
+    void *slowCall,
+    const char *slowCallName) {
+  comment("// %s r%u, r%u", name, frRes.index(), frInput.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  a.movsd(x86::xmm0, frMem(frInput));
+  // Non-numbers are NaN-boxed, so they compare as unordered.
+  a.ucomisd(x86::xmm0, x86::xmm0);
+  a.jp(slowPathLab);
+  a.addsd(x86::xmm0, constMem(llvh::DoubleToBits(addend), name));
+  a.movq(frMem(frRes), x86::xmm0);
+  a.bind(contLab);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .name = name,
+       .frRes = frRes,
+       .frInput1 = frInput,
+       .slowCall = slowCall,
+       .slowCallName = slowCallName,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: %s r%u, r%u",
+             sl.name,
+             sl.frRes.index(),
+             sl.frInput1.index());
+         em.a.bind(sl.slowPathLab);
+         em.emitRJSCall(
+             sl.frRes, sl.frInput1, FR(), sl.slowCall, sl.slowCallName);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::negate(FR frRes, FR frInput) {
+  comment("// neg r%u, r%u", frRes.index(), frInput.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  movGpFromFR(x86::rax, frInput);
+  a.movq(x86::xmm0, x86::rax);
+  a.ucomisd(x86::xmm0, x86::xmm0);
+  a.jp(slowPathLab);
+  // Flip the sign bit.
+  a.btc(x86::rax, 63);
+  movFRFromGp(frRes, x86::rax);
+  a.bind(contLab);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .frRes = frRes,
+       .frInput1 = frInput,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: neg r%u, r%u",
+             sl.frRes.index(),
+             sl.frInput1.index());
+         em.a.bind(sl.slowPathLab);
+         em.emitRJSCall(
+             sl.frRes,
+             sl.frInput1,
+             FR(),
+             (void *)_sh_ljs_minus_rjs,
+             "_sh_ljs_minus_rjs");
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::arithBinOp(
+    bool forceNumber,
+    FR frRes,
+    FR frLeft,
+    FR frRight,
+    const char *name,
+    void (*fast)(x86::Assembler &a, const x86::Xmm &dl, const x86::Xmm &dr),
+    void *slowCall,
+    const char *slowCallName) {
+  comment(
+      "// %s r%u, r%u, r%u",
+      name,
+      frRes.index(),
+      frLeft.index(),
+      frRight.index());
+  asmjit::Label slowPathLab;
+  asmjit::Label contLab;
+
+  a.movsd(x86::xmm0, frMem(frLeft));
+  a.movsd(x86::xmm1, frMem(frRight));
+  if (!forceNumber) {
+    slowPathLab = newSlowPathLabel();
+    contLab = newContLabel();
+    // Non-numbers are NaN-boxed, so they compare as unordered.
+    a.ucomisd(x86::xmm0, x86::xmm1);
+    a.jp(slowPathLab);
+  }
+  fast(a, x86::xmm0, x86::xmm1);
+  a.movq(frMem(frRes), x86::xmm0);
+
+  if (forceNumber)
+    return;
+  a.bind(contLab);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .name = name,
+       .frRes = frRes,
+       .frInput1 = frLeft,
+       .frInput2 = frRight,
+       .slowCall = slowCall,
+       .slowCallName = slowCallName,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: %s r%u, r%u, r%u",
+             sl.name,
+             sl.frRes.index(),
+             sl.frInput1.index(),
+             sl.frInput2.index());
+         em.a.bind(sl.slowPathLab);
+         em.emitRJSCall(
+             sl.frRes, sl.frInput1, sl.frInput2, sl.slowCall, sl.slowCallName);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::bitBinOp(
+    FR frRes,
+    FR frLeft,
+    FR frRight,
+    bool unsignedRes,
+    const char *name,
+    SHLegacyValue (*slowCall)(
+        SHRuntime *shr,
+        const SHLegacyValue *a,
+        const SHLegacyValue *b),
+    const char *slowCallName,
+    void (*fast)(x86::Assembler &a)) {
+  comment(
+      "// %s r%u, r%u, r%u",
+      name,
+      frRes.index(),
+      frLeft.index(),
+      frRight.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  a.movsd(x86::xmm0, frMem(frLeft));
+  truncDoubleToInt32(x86::xmm0, x86::xmm2, slowPathLab);
+  a.mov(x86::edx, x86::eax);
+  a.movsd(x86::xmm1, frMem(frRight));
+  truncDoubleToInt32(x86::xmm1, x86::xmm2, slowPathLab);
+  a.mov(x86::ecx, x86::eax);
+  a.mov(x86::eax, x86::edx);
+  fast(a);
+  // 32-bit operations zero the upper half of rax, so the unsigned result can
+  // be converted as a 64-bit integer.
+  if (unsignedRes)
+    a.cvtsi2sd(x86::xmm0, x86::rax);
+  else
+    a.cvtsi2sd(x86::xmm0, x86::eax);
+  a.movq(frMem(frRes), x86::xmm0);
+  a.bind(contLab);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .name = name,
+       .frRes = frRes,
+       .frInput1 = frLeft,
+       .frInput2 = frRight,
+       .slowCall = (void *)slowCall,
+       .slowCallName = slowCallName,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: %s r%u, r%u, r%u",
+             sl.name,
+             sl.frRes.index(),
+             sl.frInput1.index(),
+             sl.frInput2.index());
+         em.a.bind(sl.slowPathLab);
+         em.emitRJSCall(
+             sl.frRes, sl.frInput1, sl.frInput2, sl.slowCall, sl.slowCallName);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::booleanNot(FR frRes, FR frInput) {
+  comment("// not r%u, r%u", frRes.index(), frInput.index());
+  movGpFromFR(x86::rdi, frInput);
+  // ToBoolean can't throw or allocate, so don't save the IP.
+  EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+      *this, bool (*)(SHLegacyValue), _sh_ljs_to_boolean);
+  a.movzx(x86::eax, x86::al);
+  a.xor_(x86::eax, 1);
+  storeBoolFromEAX(frRes);
+}
+
+void Emitter::bitNot(FR frRes, FR frInput) {
+  comment("// bitNot r%u, r%u", frRes.index(), frInput.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  a.movsd(x86::xmm0, frMem(frInput));
+  truncDoubleToInt32(x86::xmm0, x86::xmm1, slowPathLab);
+  a.not_(x86::eax);
+  a.cvtsi2sd(x86::xmm0, x86::eax);
+  a.movq(frMem(frRes), x86::xmm0);
+  a.bind(contLab);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .frRes = frRes,
+       .frInput1 = frInput,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: bitNot r%u, r%u",
+             sl.frRes.index(),
+             sl.frInput1.index());
+         em.a.bind(sl.slowPathLab);
+         em.emitRJSCall(
+             sl.frRes,
+             sl.frInput1,
+             FR(),
+             (void *)_sh_ljs_bit_not_rjs,
+             "_sh_ljs_bit_not_rjs");
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::typeOf(FR frRes, FR frInput) {
+  comment("// typeOf r%u, r%u", frRes.index(), frInput.index());
+  emitRJSCall(frRes, frInput, FR(), (void *)_sh_ljs_typeof, "_sh_ljs_typeof");
+}
+
+void Emitter::typeOfIs(FR frRes, FR frInput, TypeOfIsTypes types) {
+  comment(
+      "// typeOfIs r%u, r%u, %u",
+      frRes.index(),
+      frInput.index(),
+      types.getRaw());
+  movGpFromFR(x86::rdi, frInput);
+  a.mov(x86::esi, types.getRaw());
+  // Checking the type can't throw or allocate, so don't save the IP.
+  EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+      *this, bool (*)(SHLegacyValue, uint16_t), _sh_ljs_typeof_is);
+  a.movzx(x86::eax, x86::al);
+  storeBoolFromEAX(frRes);
+}
+
+void Emitter::jmpTypeOfIs(
+    const asmjit::Label &target,
+    FR frInput,
+    TypeOfIsTypes types) {
+  comment(
+      "// jTypeOfIs L%u, r%u, %u",
+      target.id(),
+      frInput.index(),
+      types.getRaw());
+  movGpFromFR(x86::rdi, frInput);
+  a.mov(x86::esi, types.getRaw());
+  EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+      *this, bool (*)(SHLegacyValue, uint16_t), _sh_ljs_typeof_is);
+  a.test(x86::al, x86::al);
+  a.jnz(target);
+}
+
+void Emitter::compareImpl(
+    FR frRes,
+    FR frLeft,
+    FR frRight,
+    const char *name,
+    x86::CondCode condCode,
+    void *slowCall,
+    const char *slowCallName,
+    bool invSlow) {
+  comment(
+      "// %s r%u, r%u, r%u",
+      name,
+      frRes.index(),
+      frLeft.index(),
+      frRight.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  a.movsd(x86::xmm0, frMem(frLeft));
+  // Non-numbers are NaN-boxed, so they compare as unordered.
+  a.ucomisd(x86::xmm0, frMem(frRight));
+  a.jp(slowPathLab);
+  a.set(condCode, x86::al);
+  a.movzx(x86::eax, x86::al);
+  a.bind(contLab);
+  storeBoolFromEAX(frRes);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .name = name,
+       .frRes = frRes,
+       .frInput1 = frLeft,
+       .frInput2 = frRight,
+       .invert = invSlow,
+       .slowCall = slowCall,
+       .slowCallName = slowCallName,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: %s r%u, r%u, r%u",
+             sl.name,
+             sl.frRes.index(),
+             sl.frInput1.index(),
+             sl.frInput2.index());
+         em.a.bind(sl.slowPathLab);
+         em.a.mov(x86::rdi, xRuntime);
+         em.loadFrameAddr(x86::rsi, sl.frInput1);
+         em.loadFrameAddr(x86::rdx, sl.frInput2);
+         em.callThunkWithSavedIP(sl.slowCall, sl.slowCallName);
+         em.a.movzx(x86::eax, x86::al);
+         if (sl.invert)
+           em.a.xor_(x86::eax, 1);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::strictEqualImpl(bool invert, FR frRes, FR frLeft, FR frRight) {
+  comment(
+      "// %s r%u, r%u, r%u",
+      invert ? "strictNeq" : "strictEq",
+      frRes.index(),
+      frLeft.index(),
+      frRight.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  a.movsd(x86::xmm0, frMem(frLeft));
+  a.ucomisd(x86::xmm0, frMem(frRight));
+  a.jp(slowPathLab);
+  a.set(invert ? x86::CondCode::kNE : x86::CondCode::kE, x86::al);
+  a.movzx(x86::eax, x86::al);
+  a.bind(contLab);
+  storeBoolFromEAX(frRes);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .frRes = frRes,
+       .frInput1 = frLeft,
+       .frInput2 = frRight,
+       .invert = invert,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: strictEq r%u, r%u, r%u",
+             sl.frRes.index(),
+             sl.frInput1.index(),
+             sl.frInput2.index());
+         em.a.bind(sl.slowPathLab);
+         em.movGpFromFR(x86::rdi, sl.frInput1);
+         em.movGpFromFR(x86::rsi, sl.frInput2);
+         EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+             em,
+             bool (*)(SHLegacyValue, SHLegacyValue),
+             _sh_ljs_strict_equal);
+         em.a.movzx(x86::eax, x86::al);
+         if (sl.invert)
+           em.a.xor_(x86::eax, 1);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::jmpTrueFalse(
+    bool onTrue,
+    const asmjit::Label &target,
+    FR frInput) {
+  comment(
+      "// %s L%u, r%u",
+      onTrue ? "jmpTrue" : "jmpFalse",
+      target.id(),
+      frInput.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  // Booleans are handled inline.
+  movGpFromFR(x86::rdi, frInput);
+  loadBits64InGp(x86::rax, _sh_ljs_bool(onTrue).raw);
+  a.cmp(x86::rdi, x86::rax);
+  a.je(target);
+  loadBits64InGp(x86::rax, _sh_ljs_bool(!onTrue).raw);
+  a.cmp(x86::rdi, x86::rax);
+  a.jne(slowPathLab);
+  a.bind(contLab);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .target = target,
+       .frInput1 = frInput,
+       .invert = !onTrue,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment("// Slow path: jmpTrueFalse r%u", sl.frInput1.index());
+         em.a.bind(sl.slowPathLab);
+         // rdi still contains the value.
+         EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+             em, bool (*)(SHLegacyValue), _sh_ljs_to_boolean);
+         em.a.test(x86::al, x86::al);
+         if (sl.invert)
+           em.a.jz(sl.target);
+         else
+           em.a.jnz(sl.target);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::jmpUndefined(const asmjit::Label &target, FR frInput) {
+  comment("// JmpUndefined L%u, r%u", target.id(), frInput.index());
+  movGpFromFR(x86::rax, frInput);
+  loadBits64InGp(x86::rcx, _sh_ljs_undefined().raw);
+  a.cmp(x86::rax, x86::rcx);
+  a.je(target);
+}
+
+void Emitter::jmp(const asmjit::Label &target) {
+  comment("// Jmp L%u", target.id());
+  a.jmp(target);
+}
+
+void Emitter::jmpBuiltinIs(
+    bool invert,
+    const asmjit::Label &target,
+    uint8_t builtinIndex,
+    FR frInput) {
+  comment(
+      "// JmpBuiltinIs%s L%u, %u, r%u",
+      invert ? "Not" : "",
+      target.id(),
+      builtinIndex,
+      frInput.index());
+  loadBuiltinClosure(x86::rax, x86::rcx, builtinIndex);
+  a.cmp(x86::rax, frMem(frInput));
+  if (!invert)
+    a.je(target);
+  else
+    a.jne(target);
+}
+
+void Emitter::uintSwitchImm(
+    FR frInput,
+    const asmjit::Label &defaultLabel,
+    llvh::ArrayRef<const asmjit::Label *> labels,
+    uint32_t minVal,
+    uint32_t maxVal) {
+  comment(
+      "// uintSwitchImm r%u, min %u, max %u", frInput.index(), minVal, maxVal);
+
+  // Anything that is not an integral number, including every non-number
+  // value, goes to the default label. Otherwise rax contains the integer.
+  a.movsd(x86::xmm0, frMem(frInput));
+  truncDoubleToInt32(x86::xmm0, x86::xmm1, defaultLabel);
+
+  // Check that the value is in range with a single unsigned comparison of its
+  // offset from minVal.
+  a.mov(x86::ecx, minVal);
+  a.sub(x86::rax, x86::rcx);
+  a.mov(x86::ecx, maxVal - minVal);
+  a.cmp(x86::rax, x86::rcx);
+  a.ja(defaultLabel);
+
+  // Load the 32-bit offset of the target from the start of the jump table and
+  // jump to it.
+  asmjit::Label tableLab = a.newLabel();
+  a.lea(x86::rcx, x86::ptr(tableLab));
+  a.movsxd(x86::rax, x86::dword_ptr(x86::rcx, x86::rax, 2));
+  a.add(x86::rax, x86::rcx);
+  a.jmp(x86::rax);
+
+  // Emit the jump table after the indirect jump, which ends the basic block.
+  a.align(asmjit::AlignMode::kData, 4);
+  a.bind(tableLab);
+  for (const asmjit::Label *label : labels)
+    a.embedLabelDelta(*label, tableLab, /* size */ 4);
+}
+
+void Emitter::stringSwitchImm(
+    FR frInput,
+    RuntimeModule *runtimeModule,
+    uint32_t tableIndex,
+    const asmjit::Label &defaultLabel) {
+  comment("// stringSwitchImm r%u, table %u", frInput.index(), tableIndex);
+
+  a.mov(x86::rdi, (uint64_t)runtimeModule);
+  a.mov(x86::esi, tableIndex);
+  loadFrameAddr(x86::rdx, frInput);
+  EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+      *this,
+      void *(*)(RuntimeModule *, uint32_t, SHLegacyValue *),
+      _jit_string_switch_imm_table_lookup);
+
+  // A null address means the default case, otherwise jump to the address that
+  // was returned.
+  a.test(x86::rax, x86::rax);
+  a.jz(defaultLabel);
+  a.jmp(x86::rax);
+}
+
+void Emitter::jCond(
+    bool invert,
+    const asmjit::Label &target,
+    FR frLeft,
+    FR frRight,
+    const char *name,
+    x86::CondCode condCode,
+    void *slowCall,
+    const char *slowCallName) {
+  comment(
+      "// j_%s_%s L%u, r%u, r%u",
+      invert ? "not" : "",
+      name,
+      target.id(),
+      frLeft.index(),
+      frRight.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  a.movsd(x86::xmm0, frMem(frLeft));
+  // Non-numbers are NaN-boxed, so they compare as unordered. Once NaN is
+  // excluded, the inverse of a condition is simply the negated condition.
+  a.ucomisd(x86::xmm0, frMem(frRight));
+  a.jp(slowPathLab);
+  a.j(invert ? x86::negateCond(condCode) : condCode, target);
+  a.bind(contLab);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .target = target,
+       .name = name,
+       .frInput1 = frLeft,
+       .frInput2 = frRight,
+       .invert = invert,
+       .slowCall = slowCall,
+       .slowCallName = slowCallName,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: j_%s_%s r%u, r%u",
+             sl.invert ? "not" : "",
+             sl.name,
+             sl.frInput1.index(),
+             sl.frInput2.index());
+         em.a.bind(sl.slowPathLab);
+         em.a.mov(x86::rdi, xRuntime);
+         em.loadFrameAddr(x86::rsi, sl.frInput1);
+         em.loadFrameAddr(x86::rdx, sl.frInput2);
+         em.callThunkWithSavedIP(sl.slowCall, sl.slowCallName);
+         em.a.test(x86::al, x86::al);
+         if (sl.invert)
+           em.a.jz(sl.target);
+         else
+           em.a.jnz(sl.target);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::jStrictEqual(
+    bool invert,
+    const asmjit::Label &target,
+    FR frLeft,
+    FR frRight) {
+  comment(
+      "// %s L%u, r%u, r%u",
+      invert ? "jStrictNotEqual" : "jStrictEqual",
+      target.id(),
+      frLeft.index(),
+      frRight.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  a.movsd(x86::xmm0, frMem(frLeft));
+  a.ucomisd(x86::xmm0, frMem(frRight));
+  a.jp(slowPathLab);
+  if (invert)
+    a.jne(target);
+  else
+    a.je(target);
+  a.bind(contLab);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .target = target,
+       .frInput1 = frLeft,
+       .frInput2 = frRight,
+       .invert = invert,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: jStrictEqual r%u, r%u",
+             sl.frInput1.index(),
+             sl.frInput2.index());
+         em.a.bind(sl.slowPathLab);
+         em.movGpFromFR(x86::rdi, sl.frInput1);
+         em.movGpFromFR(x86::rsi, sl.frInput2);
+         EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+             em,
+             bool (*)(SHLegacyValue, SHLegacyValue),
+             _sh_ljs_strict_equal);
+         em.a.test(x86::al, x86::al);
+         if (sl.invert)
+           em.a.jz(sl.target);
+         else
+           em.a.jnz(sl.target);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::getByVal(FR frRes, FR frSource, FR frKey) {
+  comment(
+      "// getByVal r%u, r%u, r%u",
+      frRes.index(),
+      frSource.index(),
+      frKey.index());
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frSource);
+  loadFrameAddr(x86::rdx, frKey);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, SHLegacyValue *, SHLegacyValue *),
+      _sh_ljs_get_by_val_rjs);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::getByIndex(FR frRes, FR frSource, uint32_t key) {
+  comment("// getByIdx r%u, r%u, %u", frRes.index(), frSource.index(), key);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frSource);
+  a.mov(x86::edx, key);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, SHLegacyValue *, uint32_t),
+      _sh_ljs_get_by_index_rjs);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::getByValWithReceiver(
+    FR frRes,
+    FR frSource,
+    FR frKey,
+    FR frReceiver) {
+  comment(
+      "// GetByValWithReceiver r%u, r%u, r%u, r%u",
+      frRes.index(),
+      frSource.index(),
+      frKey.index(),
+      frReceiver.index());
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frSource);
+  loadFrameAddr(x86::rdx, frKey);
+  loadFrameAddr(x86::rcx, frReceiver);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(
+          SHRuntime *shr,
+          SHLegacyValue *source,
+          SHLegacyValue *key,
+          SHLegacyValue *receiver),
+      _sh_ljs_get_by_val_with_receiver_rjs);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::putByValWithReceiver(
+    FR frTarget,
+    FR frKey,
+    FR frValue,
+    FR frReceiver,
+    bool isStrict) {
+  comment(
+      "// PutByValWithReceiver r%u, r%u, r%u, r%u, %d",
+      frTarget.index(),
+      frKey.index(),
+      frValue.index(),
+      frReceiver.index(),
+      isStrict);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frTarget);
+  loadFrameAddr(x86::rdx, frKey);
+  loadFrameAddr(x86::rcx, frValue);
+  loadFrameAddr(x86::r8, frReceiver);
+  a.mov(x86::r9d, (uint32_t)isStrict);
+  EMIT_RUNTIME_CALL(
+      *this,
+      void (*)(
+          SHRuntime *shr,
+          SHLegacyValue *target,
+          SHLegacyValue *key,
+          SHLegacyValue *value,
+          SHLegacyValue *receiver,
+          bool isStrict),
+      _sh_ljs_put_by_val_with_receiver_rjs);
+}
+
+void Emitter::delByVal(FR frRes, FR frTarget, FR frKey, bool strict) {
+  comment(
+      "// DelByVal r%u, r%u, r%u, %d",
+      frRes.index(),
+      frTarget.index(),
+      frKey.index(),
+      strict);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frTarget);
+  loadFrameAddr(x86::rdx, frKey);
+  if (strict) {
+    EMIT_RUNTIME_CALL(
+        *this,
+        SHLegacyValue (*)(SHRuntime *, SHLegacyValue *, SHLegacyValue *),
+        _sh_ljs_del_by_val_strict);
+  } else {
+    EMIT_RUNTIME_CALL(
+        *this,
+        SHLegacyValue (*)(SHRuntime *, SHLegacyValue *, SHLegacyValue *),
+        _sh_ljs_del_by_val_loose);
+  }
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::putByValImpl(
+    FR frTarget,
+    FR frKey,
+    FR frValue,
+    const char *name,
+    void (*shImpl)(
+        SHRuntime *shr,
+        SHLegacyValue *target,
+        SHLegacyValue *key,
+        SHLegacyValue *value),
+    const char *shImplName) {
+  comment(
+      "// %s r%u, r%u, r%u",
+      name,
+      frTarget.index(),
+      frKey.index(),
+      frValue.index());
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frTarget);
+  loadFrameAddr(x86::rdx, frKey);
+  loadFrameAddr(x86::rcx, frValue);
+  callThunkWithSavedIP((void *)shImpl, shImplName);
+}
+
+void Emitter::getByIdImpl(
+    FR frRes,
+    SHSymbolID symID,
+    FR frSource,
+    uint8_t cacheIdx,
+    const char *name,
+    SHLegacyValue (*shImpl)(
+        SHRuntime *shr,
+        const SHLegacyValue *source,
+        SHSymbolID symID,
+        SHReadPropertyCacheEntry *propCacheEntry),
+    const char *shImplName) {
+  comment(
+      "// %s r%u, r%u, cache %u, symID %u",
+      name,
+      frRes.index(),
+      frSource.index(),
+      cacheIdx,
+      symID);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frSource);
+  a.mov(x86::edx, symID);
+  loadReadCacheEntry(x86::rcx, cacheIdx);
+  callThunkWithSavedIP((void *)shImpl, shImplName);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::getByIdWithReceiver(
+    FR frRes,
+    SHSymbolID symID,
+    FR frSource,
+    FR frReceiver,
+    uint8_t cacheIdx) {
+  comment(
+      "// GetByIdWithReceiver r%u, r%u, r%u, cache %u, symID %u",
+      frRes.index(),
+      frSource.index(),
+      frReceiver.index(),
+      cacheIdx,
+      symID);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frSource);
+  loadFrameAddr(x86::rdx, frReceiver);
+  a.mov(x86::ecx, symID);
+  loadReadCacheEntry(x86::r8, cacheIdx);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(
+          SHRuntime *shr,
+          const SHLegacyValue *source,
+          const SHLegacyValue *receiver,
+          SHSymbolID symID,
+          SHReadPropertyCacheEntry *propCacheEntry),
+      _sh_ljs_get_by_id_with_receiver_rjs);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::putByIdImpl(
+    FR frTarget,
+    SHSymbolID symID,
+    FR frValue,
+    uint8_t cacheIdx,
+    bool strictMode,
+    bool tryProp) {
+  comment(
+      "// %sPutById%s r%u, r%u, cache %u, symID %u",
+      tryProp ? "Try" : "",
+      strictMode ? "Strict" : "Loose",
+      frTarget.index(),
+      frValue.index(),
+      cacheIdx,
+      symID);
+
+  a.mov(x86::rdi, xRuntime);
+  a.mov(x86::rsi, (uint64_t)codeBlock_);
+  loadFrameAddr(x86::rdx, frTarget);
+  loadFrameAddr(x86::rcx, frValue);
+  a.mov(x86::r8d, cacheIdx);
+  a.mov(x86::r9d, symID);
+  // The last two arguments are passed on the stack, which must stay 16-byte
+  // aligned at the call.
+  a.sub(x86::rsp, 16);
+  a.mov(x86::qword_ptr(x86::rsp, 0), (int32_t)strictMode);
+  a.mov(x86::qword_ptr(x86::rsp, 8), (int32_t)tryProp);
+  EMIT_RUNTIME_CALL(
+      *this,
+      void (*)(
+          SHRuntime *shr,
+          SHCodeBlock *codeBlock,
+          SHLegacyValue *base,
+          SHLegacyValue *value,
+          uint8_t cacheIdx,
+          SHSymbolID symID,
+          bool strictMode,
+          bool tryProp),
+      _jit_put_by_id);
+  a.add(x86::rsp, 16);
+}
+
+asmjit::Label Emitter::newPrefLabel(const char *pref, size_t index) {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%s%lu", pref, index);
+  return a.newNamedLabel(buf);
+}
+
+void Emitter::defineOwnById(
+    FR frTarget,
+    SHSymbolID symID,
+    FR frValue,
+    uint8_t cacheIdx) {
+  comment(
+      "// defineOwnById r%u, r%u, cache %u, symID %u",
+      frTarget.index(),
+      frValue.index(),
+      cacheIdx,
+      symID);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frTarget);
+  a.mov(x86::edx, symID);
+  loadFrameAddr(x86::rcx, frValue);
+  loadWriteCacheEntry(x86::r8, cacheIdx);
+  EMIT_RUNTIME_CALL(
+      *this,
+      void (*)(
+          SHRuntime *shr,
+          SHLegacyValue *target,
+          SHSymbolID key,
+          SHLegacyValue *value,
+          SHWritePropertyCacheEntry *cacheEntry),
+      _sh_ljs_define_own_by_id);
+}
+
+void Emitter::defineOwnByIndex(FR frTarget, FR frValue, uint32_t key) {
+  comment(
+      "// DefineOwnByIndex r%u, r%u, %u",
+      frTarget.index(),
+      frValue.index(),
+      key);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frTarget);
+  a.mov(x86::edx, key);
+  loadFrameAddr(x86::rcx, frValue);
+  EMIT_RUNTIME_CALL(
+      *this,
+      void (*)(SHRuntime *, SHLegacyValue *, uint32_t, SHLegacyValue *),
+      _sh_ljs_define_own_by_index);
+}
+
+void Emitter::defineOwnByVal(
+    FR frTarget,
+    FR frValue,
+    FR frKey,
+    bool enumerable) {
+  comment(
+      "// DefineOwnByVal r%u, r%u, r%u, %u",
+      frTarget.index(),
+      frValue.index(),
+      frKey.index(),
+      enumerable);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frTarget);
+  loadFrameAddr(x86::rdx, frKey);
+  loadFrameAddr(x86::rcx, frValue);
+  if (enumerable) {
+    EMIT_RUNTIME_CALL(
+        *this,
+        void (*)(
+            SHRuntime *, SHLegacyValue *, SHLegacyValue *, SHLegacyValue *),
+        _sh_ljs_define_own_by_val);
+  } else {
+    EMIT_RUNTIME_CALL(
+        *this,
+        void (*)(
+            SHRuntime *, SHLegacyValue *, SHLegacyValue *, SHLegacyValue *),
+        _sh_ljs_define_own_ne_by_val);
+  }
+}
+
+void Emitter::defineOwnInDenseArray(FR frArray, FR frProp, uint32_t idx) {
+  comment(
+      "// DefineOwnInDenseArray r%u, r%u, %u",
+      frArray.index(),
+      frProp.index(),
+      idx);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frArray);
+  loadFrameAddr(x86::rdx, frProp);
+  a.mov(x86::ecx, idx);
+  EMIT_RUNTIME_CALL(
+      *this,
+      void (*)(SHRuntime *, SHLegacyValue *, SHLegacyValue *, uint32_t),
+      _sh_ljs_define_own_in_dense_array);
+}
+
+void Emitter::defineOwnGetterSetterByVal(
+    FR frTarget,
+    FR frKey,
+    FR frGetter,
+    FR frSetter,
+    bool enumerable) {
+  comment(
+      "// DefineOwnGetterSetterByVal r%u, r%u, r%u, r%u, %d",
+      frTarget.index(),
+      frKey.index(),
+      frGetter.index(),
+      frSetter.index(),
+      enumerable);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frTarget);
+  loadFrameAddr(x86::rdx, frKey);
+  loadFrameAddr(x86::rcx, frGetter);
+  loadFrameAddr(x86::r8, frSetter);
+  a.mov(x86::r9d, (uint32_t)enumerable);
+  EMIT_RUNTIME_CALL(
+      *this,
+      void (*)(
+          SHRuntime *shr,
+          SHLegacyValue *target,
+          SHLegacyValue *key,
+          SHLegacyValue *getter,
+          SHLegacyValue *setter,
+          bool enumerable),
+      _sh_ljs_define_own_getter_setter_by_val);
+}
+
+void Emitter::getOwnBySlotIdx(FR frRes, FR frTarget, uint32_t slotIdx) {
+  comment(
+      "// GetOwnBySlotIdx r%u, r%u, %u",
+      frRes.index(),
+      frTarget.index(),
+      slotIdx);
+  // Decoding a small HermesValue depends on the heap configuration, so leave
+  // it to the runtime.
+  a.mov(x86::rdi, xRuntime);
+  movGpFromFR(x86::rsi, frTarget);
+  if (slotIdx < JSObject::DIRECT_PROPERTY_SLOTS) {
+    a.mov(x86::edx, slotIdx);
+    EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+        *this,
+        SHLegacyValue (*)(SHRuntime *, SHLegacyValue, uint32_t),
+        _sh_prload_direct);
+  } else {
+    // For indirect loads, 0 is the first indirect index.
+    a.mov(x86::edx, slotIdx - JSObject::DIRECT_PROPERTY_SLOTS);
+    EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+        *this,
+        SHLegacyValue (*)(SHRuntime *, SHLegacyValue, uint32_t),
+        _sh_prload_indirect);
+  }
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::putOwnBySlotIdx(FR frTarget, FR frValue, uint32_t slotIdx) {
+  comment(
+      "// PutOwnBySlotIdx r%u, r%u, %u",
+      frTarget.index(),
+      frValue.index(),
+      slotIdx);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frTarget);
+  // For indirect stores, 0 is the first indirect index.
+  a.mov(
+      x86::edx,
+      slotIdx < JSObject::DIRECT_PROPERTY_SLOTS
+          ? slotIdx
+          : slotIdx - JSObject::DIRECT_PROPERTY_SLOTS);
+  loadFrameAddr(x86::rcx, frValue);
+  if (slotIdx < JSObject::DIRECT_PROPERTY_SLOTS) {
+    EMIT_RUNTIME_CALL(
+        *this,
+        void (*)(SHRuntime *, SHLegacyValue *, uint32_t, SHLegacyValue *),
+        _sh_prstore_direct);
+  } else {
+    EMIT_RUNTIME_CALL(
+        *this,
+        void (*)(SHRuntime *, SHLegacyValue *, uint32_t, SHLegacyValue *),
+        _sh_prstore_indirect);
+  }
+}
+
+void Emitter::loadParentNoTraps(FR frRes, FR frObj) {
+  comment("// LoadParentNoTraps r%u, r%u", frRes.index(), frObj.index());
+  asmjit::Label nullLab = a.newLabel();
+  asmjit::Label contLab = newContLabel();
+
+  movGpFromFR(x86::rax, frObj);
+  emit_sh_ljs_get_pointer(a, x86::rax);
+  // The parent may be null, which must not be decoded.
+#ifdef HERMESVM_COMPRESSED_POINTERS
+  a.mov(x86::eax, x86::dword_ptr(x86::rax, offsetof(SHJSObject, parent)));
+  a.test(x86::eax, x86::eax);
+  a.jz(nullLab);
+  a.add(x86::rax, xRuntime);
+#else
+  a.mov(x86::rax, x86::qword_ptr(x86::rax, offsetof(SHJSObject, parent)));
+  a.test(x86::rax, x86::rax);
+  a.jz(nullLab);
+#endif
+  emit_sh_ljs_object(a, x86::rax, x86::rcx);
+  a.jmp(contLab);
+  a.bind(nullLab);
+  loadBits64InGp(x86::rax, _sh_ljs_null().raw);
+  a.bind(contLab);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::typedLoadParent(FR frRes, FR frObj) {
+  comment("// TypedLoadParent r%u, r%u", frRes.index(), frObj.index());
+  movGpFromFR(x86::rax, frObj);
+  emit_sh_ljs_get_pointer(a, x86::rax);
+  loadCPNonNull(
+      x86::rax, x86::qword_ptr(x86::rax, offsetof(SHJSObject, parent)));
+  emit_sh_ljs_object(a, x86::rax, x86::rcx);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::loadPrivateNameCacheEntry(
+    const x86::Gp &dest,
+    uint8_t cacheIdx) {
+  if (cacheIdx == hbc::PROPERTY_CACHING_DISABLED) {
+    a.xor_(dest.r32(), dest.r32());
+  } else {
+    a.mov(
+        dest,
+        (uint64_t)codeBlock_->privateNameCache() +
+            sizeof(SHPrivateNameCacheEntry) * cacheIdx);
+  }
+}
+
+void Emitter::addOwnPrivateBySym(FR frTarget, FR frKey, FR frValue) {
+  comment(
+      "// AddOwnPrivateBySym r%u, r%u, r%u",
+      frTarget.index(),
+      frKey.index(),
+      frValue.index());
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frTarget);
+  loadFrameAddr(x86::rdx, frKey);
+  loadFrameAddr(x86::rcx, frValue);
+  EMIT_RUNTIME_CALL(
+      *this,
+      void (*)(SHRuntime *, SHLegacyValue *, SHLegacyValue *, SHLegacyValue *),
+      _sh_ljs_add_own_private_by_sym);
+}
+
+void Emitter::getOwnPrivateBySym(
+    FR frRes,
+    FR frTarget,
+    FR frKey,
+    uint8_t cacheIdx) {
+  comment(
+      "// GetOwnPrivateBySym r%u, r%u, r%u, cache %u",
+      frRes.index(),
+      frTarget.index(),
+      frKey.index(),
+      cacheIdx);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frTarget);
+  loadFrameAddr(x86::rdx, frKey);
+  loadPrivateNameCacheEntry(x86::rcx, cacheIdx);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(
+          SHRuntime *,
+          const SHLegacyValue *,
+          const SHLegacyValue *,
+          SHPrivateNameCacheEntry *),
+      _sh_ljs_get_own_private_by_sym);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::putOwnPrivateBySym(
+    FR frTarget,
+    FR frKey,
+    FR frValue,
+    uint8_t cacheIdx) {
+  comment(
+      "// PutOwnPrivateBySym r%u, r%u, r%u, cache %u",
+      frTarget.index(),
+      frKey.index(),
+      frValue.index(),
+      cacheIdx);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frTarget);
+  loadFrameAddr(x86::rdx, frKey);
+  loadFrameAddr(x86::rcx, frValue);
+  loadPrivateNameCacheEntry(x86::r8, cacheIdx);
+  EMIT_RUNTIME_CALL(
+      *this,
+      void (*)(
+          SHRuntime *,
+          SHLegacyValue *,
+          SHLegacyValue *,
+          SHLegacyValue *,
+          SHPrivateNameCacheEntry *),
+      _sh_ljs_put_own_private_by_sym);
+}
+
+void Emitter::createPrivateName(FR frRes, SHSymbolID symID) {
+  comment("// CreatePrivateName r%u, %u", frRes.index(), symID);
+  a.mov(x86::rdi, xRuntime);
+  a.mov(x86::esi, symID);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, SHSymbolID),
+      _sh_ljs_create_private_name);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::privateIsIn(
+    FR frRes,
+    FR frPrivateName,
+    FR frTarget,
+    uint8_t cacheIdx) {
+  comment(
+      "// PrivateIsIn r%u, r%u, r%u, cache %u",
+      frRes.index(),
+      frPrivateName.index(),
+      frTarget.index(),
+      cacheIdx);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frPrivateName);
+  loadFrameAddr(x86::rdx, frTarget);
+  loadPrivateNameCacheEntry(x86::rcx, cacheIdx);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(
+          SHRuntime *,
+          SHLegacyValue *,
+          SHLegacyValue *,
+          SHPrivateNameCacheEntry *),
+      _sh_ljs_private_is_in_rjs);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::instanceOf(FR frRes, FR frLeft, FR frRight) {
+  comment(
+      "// instanceOf r%u, r%u, r%u",
+      frRes.index(),
+      frLeft.index(),
+      frRight.index());
+  emitRJSCall(
+      frRes,
+      frLeft,
+      frRight,
+      (void *)_sh_ljs_instance_of_rjs,
+      "_sh_ljs_instance_of_rjs");
+}
+
+void Emitter::isIn(FR frRes, FR frLeft, FR frRight) {
+  comment(
+      "// isIn r%u, r%u, r%u", frRes.index(), frLeft.index(), frRight.index());
+  emitRJSCall(
+      frRes, frLeft, frRight, (void *)_sh_ljs_is_in_rjs, "_sh_ljs_is_in_rjs");
+}
+
+void Emitter::getPNameList(FR frRes, FR frObj, FR frIdx, FR frSize) {
+  comment(
+      "// GetPNameList r%u, r%u, r%u, r%u",
+      frRes.index(),
+      frObj.index(),
+      frIdx.index(),
+      frSize.index());
+  // frObj is an in/out parameter, frIdx and frSize are out parameters.
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frObj);
+  loadFrameAddr(x86::rdx, frIdx);
+  loadFrameAddr(x86::rcx, frSize);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(
+          SHRuntime *, SHLegacyValue *, SHLegacyValue *, SHLegacyValue *),
+      _sh_ljs_get_pname_list_rjs);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::getNextPName(
+    FR frRes,
+    FR frProps,
+    FR frObj,
+    FR frIdx,
+    FR frSize) {
+  comment(
+      "// GetNextPName r%u, r%u, r%u, r%u, r%u",
+      frRes.index(),
+      frProps.index(),
+      frObj.index(),
+      frIdx.index(),
+      frSize.index());
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frProps);
+  loadFrameAddr(x86::rdx, frObj);
+  loadFrameAddr(x86::rcx, frIdx);
+  loadFrameAddr(x86::r8, frSize);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(
+          SHRuntime *,
+          SHLegacyValue *,
+          SHLegacyValue *,
+          SHLegacyValue *,
+          SHLegacyValue *),
+      _sh_ljs_get_next_pname_rjs);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::toPropertyKey(FR frRes, FR frVal) {
+  comment("// ToPropertyKey r%u, r%u", frRes.index(), frVal.index());
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frVal);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, const SHLegacyValue *),
+      _sh_ljs_to_property_key);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::addS(FR frRes, FR frLeft, FR frRight) {
+  comment(
+      "// AddS r%u, r%u, r%u", frRes.index(), frLeft.index(), frRight.index());
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frLeft);
+  loadFrameAddr(x86::rdx, frRight);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, SHLegacyValue *, SHLegacyValue *),
+      _sh_ljs_string_add);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::iteratorBegin(FR frRes, FR frSource) {
+  comment("// IteratorBegin r%u, r%u", frRes.index(), frSource.index());
+  // frSource is an in/out parameter.
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frSource);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, SHLegacyValue *),
+      _sh_ljs_iterator_begin_rjs);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::iteratorNext(FR frRes, FR frIteratorOrIdx, FR frSourceOrNext) {
+  comment(
+      "// IteratorNext r%u, r%u, r%u",
+      frRes.index(),
+      frIteratorOrIdx.index(),
+      frSourceOrNext.index());
+  // frIteratorOrIdx is an in/out parameter.
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frIteratorOrIdx);
+  loadFrameAddr(x86::rdx, frSourceOrNext);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, SHLegacyValue *, const SHLegacyValue *),
+      _sh_ljs_iterator_next_rjs);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::iteratorClose(FR frIteratorOrIdx, bool ignoreExceptions) {
+  comment(
+      "// IteratorClose r%u, %u", frIteratorOrIdx.index(), ignoreExceptions);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frIteratorOrIdx);
+  a.mov(x86::edx, (uint32_t)ignoreExceptions);
+  EMIT_RUNTIME_CALL(
+      *this,
+      void (*)(SHRuntime *, const SHLegacyValue *, bool),
+      _sh_ljs_iterator_close_rjs);
+}
+
+void Emitter::getArgumentsPropByValImpl(
+    FR frRes,
+    FR frIndex,
+    FR frLazyReg,
+    const char *name,
+    SHLegacyValue (*shImpl)(
+        SHRuntime *shr,
+        SHLegacyValue *frame,
+        SHLegacyValue *idx,
+        SHLegacyValue *lazyReg),
+    const char *shImplName) {
+  comment(
+      "// %s r%u, r%u, r%u",
+      name,
+      frRes.index(),
+      frIndex.index(),
+      frLazyReg.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  // If the arguments have been reified, go to the slow path.
+  movGpFromFR(x86::rax, frLazyReg);
+  emit_sh_ljs_cmp_object(a, x86::rax, x86::rcx);
+  a.jae(slowPathLab);
+
+  // If the index is not an integer, go to the slow path. Otherwise rax
+  // contains it.
+  a.movsd(x86::xmm0, frMem(frIndex));
+  truncDoubleToInt32(x86::xmm0, x86::xmm1, slowPathLab);
+
+  // If index >= arg count or index < 0, go to the slow path. The unsigned
+  // comparison handles the negative index case.
+  a.mov(x86::ecx, frameSlotMem(StackFrameLayout::ArgCount).cloneResized(4));
+  a.cmp(x86::rax, x86::rcx);
+  a.jae(slowPathLab);
+
+  // Load the argument from the stack: xFrame[FirstArg - index].
+  a.neg(x86::rax);
+  a.mov(
+      x86::rax,
+      x86::qword_ptr(
+          xFrame,
+          x86::rax,
+          3,
+          StackFrameLayout::FirstArg * (int32_t)sizeof(SHLegacyValue)));
+  a.bind(contLab);
+  movFRFromGp(frRes, x86::rax);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .name = name,
+       .frRes = frRes,
+       .frInput1 = frIndex,
+       .frInput2 = frLazyReg,
+       .slowCall = (void *)shImpl,
+       .slowCallName = shImplName,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment("// Slow path: %s r%u", sl.name, sl.frInput1.index());
+         em.a.bind(sl.slowPathLab);
+         em.a.mov(x86::rdi, xRuntime);
+         em.a.mov(x86::rsi, xFrame);
+         em.loadFrameAddr(x86::rdx, sl.frInput1);
+         em.loadFrameAddr(x86::rcx, sl.frInput2);
+         em.callThunkWithSavedIP(sl.slowCall, sl.slowCallName);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::getArgumentsLength(FR frRes, FR frLazyReg) {
+  comment("// GetArgumentsLength r%u, r%u", frRes.index(), frLazyReg.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  // If the arguments have been reified, go to the slow path.
+  movGpFromFR(x86::rax, frLazyReg);
+  emit_sh_ljs_cmp_object(a, x86::rax, x86::rcx);
+  a.jae(slowPathLab);
+
+  // Fast path: read the argument count from the frame.
+  static_assert(
+      HERMESVALUE_VERSION == 2,
+      "NativeUint32 is stored as the lower 32 bits of the raw HermesValue");
+  a.mov(x86::eax, frameSlotMem(StackFrameLayout::ArgCount).cloneResized(4));
+  // Encode the uint32_t as a double (making it a HermesValue).
+  a.cvtsi2sd(x86::xmm0, x86::rax);
+  a.movq(x86::rax, x86::xmm0);
+  a.bind(contLab);
+  movFRFromGp(frRes, x86::rax);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .frRes = frRes,
+       .frInput1 = frLazyReg,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: GetArgumentsLength r%u, r%u",
+             sl.frRes.index(),
+             sl.frInput1.index());
+         em.a.bind(sl.slowPathLab);
+         em.a.mov(x86::rdi, xRuntime);
+         em.a.mov(x86::rsi, xFrame);
+         em.loadFrameAddr(x86::rdx, sl.frInput1);
+         EMIT_RUNTIME_CALL(
+             em,
+             SHLegacyValue (*)(SHRuntime *, SHLegacyValue *, SHLegacyValue *),
+             _sh_ljs_get_arguments_length);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::reifyArgumentsImpl(FR frLazyReg, bool strict, const char *name) {
+  comment("// %s r%u", name, frLazyReg.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  // If the lazy register is not an object, the arguments must be reified.
+  movGpFromFR(x86::rax, frLazyReg);
+  emit_sh_ljs_cmp_object(a, x86::rax, x86::rcx);
+  a.jb(slowPathLab);
+  a.bind(contLab);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .name = name,
+       .frInput1 = frLazyReg,
+       .slowCall = strict ? (void *)_sh_ljs_reify_arguments_strict
+                          : (void *)_sh_ljs_reify_arguments_loose,
+       .slowCallName = strict ? "_sh_ljs_reify_arguments_strict"
+                              : "_sh_ljs_reify_arguments_loose",
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment("// Slow path: %s r%u", sl.name, sl.frInput1.index());
+         em.a.bind(sl.slowPathLab);
+         // The lazy register is updated in place in the frame.
+         em.a.mov(x86::rdi, xRuntime);
+         em.a.mov(x86::rsi, xFrame);
+         em.loadFrameAddr(x86::rdx, sl.frInput1);
+         em.callThunkWithSavedIP(sl.slowCall, sl.slowCallName);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::newObject(FR frRes) {
+  comment("// NewObject r%u", frRes.index());
+  a.mov(x86::rdi, xRuntime);
+  EMIT_RUNTIME_CALL(
+      *this, SHLegacyValue (*)(SHRuntime *), _sh_ljs_new_object);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::newObjectWithParent(FR frRes, FR frParent) {
+  comment("// NewObjectWithParent r%u, r%u", frRes.index(), frParent.index());
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frParent);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, const SHLegacyValue *),
+      _sh_ljs_new_object_with_parent);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::newObjectWithBuffer(
+    FR frRes,
+    uint32_t shapeTableIndex,
+    uint32_t valBufferOffset) {
+  comment(
+      "// NewObjectWithBuffer r%u, %u, %u",
+      frRes.index(),
+      shapeTableIndex,
+      valBufferOffset);
+  a.mov(x86::rdi, xRuntime);
+  a.mov(x86::rsi, (uint64_t)codeBlock_);
+  a.mov(x86::edx, shapeTableIndex);
+  a.mov(x86::ecx, valBufferOffset);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, SHCodeBlock *, uint32_t, uint32_t),
+      _interpreter_create_object_from_buffer);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::newObjectWithBufferAndParent(
+    FR frRes,
+    FR frParent,
+    uint32_t shapeTableIndex,
+    uint32_t valBufferOffset) {
+  comment(
+      "// NewObjectWithBufferAndParent r%u, r%u, %u, %u",
+      frRes.index(),
+      frParent.index(),
+      shapeTableIndex,
+      valBufferOffset);
+  a.mov(x86::rdi, xRuntime);
+  a.mov(x86::rsi, (uint64_t)codeBlock_);
+  loadFrameAddr(x86::rdx, frParent);
+  a.mov(x86::ecx, shapeTableIndex);
+  a.mov(x86::r8d, valBufferOffset);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(
+          SHRuntime *, SHCodeBlock *, SHLegacyValue *, uint32_t, uint32_t),
+      _interpreter_create_object_from_buffer_with_parent);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::newTypedObjectWithBuffer(
+    FR frRes,
+    FR frParent,
+    uint32_t shapeTableIndex,
+    uint32_t valBufferOffset,
+    uint8_t nonEnumerable) {
+  comment(
+      "// NewTypedObjectWithBuffer r%u, r%u, %u, %u, %u",
+      frRes.index(),
+      frParent.index(),
+      shapeTableIndex,
+      valBufferOffset,
+      nonEnumerable);
+  a.mov(x86::rdi, xRuntime);
+  a.mov(x86::rsi, (uint64_t)codeBlock_);
+  loadFrameAddr(x86::rdx, frParent);
+  a.mov(x86::ecx, shapeTableIndex);
+  a.mov(x86::r8d, valBufferOffset);
+  if (nonEnumerable) {
+    EMIT_RUNTIME_CALL(
+        *this,
+        SHLegacyValue (*)(
+            SHRuntime *, SHCodeBlock *, SHLegacyValue *, uint32_t, uint32_t),
+        _interpreter_create_typed_non_enum_object_from_buffer);
+  } else {
+    EMIT_RUNTIME_CALL(
+        *this,
+        SHLegacyValue (*)(
+            SHRuntime *, SHCodeBlock *, SHLegacyValue *, uint32_t, uint32_t),
+        _interpreter_create_typed_object_from_buffer);
+  }
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::newArray(FR frRes, uint32_t size) {
+  comment("// NewArray r%u, %u", frRes.index(), size);
+  a.mov(x86::rdi, xRuntime);
+  a.mov(x86::esi, size);
+  EMIT_RUNTIME_CALL(
+      *this, SHLegacyValue (*)(SHRuntime *, uint32_t), _sh_ljs_new_array);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::newArrayWithBuffer(
+    FR frRes,
+    uint32_t numElements,
+    uint32_t numLiterals,
+    uint32_t bufferIndex) {
+  comment(
+      "// NewArrayWithBuffer r%u, %u, %u, %u",
+      frRes.index(),
+      numElements,
+      numLiterals,
+      bufferIndex);
+  a.mov(x86::rdi, xRuntime);
+  a.mov(x86::rsi, (uint64_t)codeBlock_);
+  a.mov(x86::edx, numElements);
+  a.mov(x86::ecx, numLiterals);
+  a.mov(x86::r8d, bufferIndex);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(
+          SHRuntime *, SHCodeBlock *, unsigned, unsigned, unsigned),
+      _interpreter_create_array_from_buffer);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::newFastArray(FR frRes, FR frProto, uint32_t size) {
+  comment("// NewFastArray r%u, r%u, %u", frRes.index(), frProto.index(), size);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frProto);
+  a.mov(x86::edx, size);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, SHLegacyValue *, uint32_t),
+      _sh_new_fastarray_with_proto);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::fastArrayLength(FR frRes, FR frArr) {
+  comment("// FastArrayLength r%u, r%u", frRes.index(), frArr.index());
+#ifdef HERMESVM_BOXED_DOUBLES
+  // The length is only stored as an integer in the ArrayStorage, let the
+  // runtime convert it.
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frArr);
+  EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, SHLegacyValue *),
+      _sh_fastarray_length);
+#else
+  // Load the length property of the FastArray, which is a number.
+  movGpFromFR(x86::rax, frArr);
+  emit_sh_ljs_get_pointer(a, x86::rax);
+  a.mov(x86::rax, x86::qword_ptr(x86::rax, offsetof(SHFastArray, length)));
+#endif
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::fastArrayLoad(FR frRes, FR frArr, FR frIdx) {
+  comment(
+      "// FastArrayLoad r%u, r%u, r%u",
+      frRes.index(),
+      frArr.index(),
+      frIdx.index());
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frArr);
+  a.movsd(x86::xmm0, frMem(frIdx));
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, SHLegacyValue *, double idx),
+      _sh_fastarray_load);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::fastArrayStore(FR frArr, FR frIdx, FR frVal) {
+  comment(
+      "// FastArrayStore r%u, r%u, r%u",
+      frArr.index(),
+      frIdx.index(),
+      frVal.index());
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frVal);
+  loadFrameAddr(x86::rdx, frArr);
+  a.movsd(x86::xmm0, frMem(frIdx));
+  EMIT_RUNTIME_CALL(
+      *this,
+      void (*)(SHRuntime *, const SHLegacyValue *, SHLegacyValue *, double idx),
+      _sh_fastarray_store);
+}
+
+void Emitter::fastArrayPush(FR frArr, FR frVal) {
+  comment("// FastArrayPush r%u, r%u", frArr.index(), frVal.index());
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frVal);
+  loadFrameAddr(x86::rdx, frArr);
+  EMIT_RUNTIME_CALL(
+      *this,
+      void (*)(SHRuntime *, SHLegacyValue *, SHLegacyValue *),
+      _sh_fastarray_push);
+}
+
+void Emitter::fastArrayAppend(FR frArr, FR frOther) {
+  comment("// FastArrayAppend r%u, r%u", frArr.index(), frOther.index());
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frOther);
+  loadFrameAddr(x86::rdx, frArr);
+  EMIT_RUNTIME_CALL(
+      *this,
+      void (*)(SHRuntime *, SHLegacyValue *, SHLegacyValue *),
+      _sh_fastarray_append);
+}
+
+void Emitter::getGlobalObject(FR frRes) {
+  comment("// GetGlobalObject r%u", frRes.index());
+  a.mov(x86::rax, x86::qword_ptr(xRuntime, RuntimeOffsets::globalObject));
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::declareGlobalVar(SHSymbolID symID) {
+  comment("// DeclareGlobalVar %u", symID);
+  a.mov(x86::rdi, xRuntime);
+  a.mov(x86::esi, symID);
+  EMIT_RUNTIME_CALL(
+      *this, void (*)(SHRuntime *, SHSymbolID), _sh_ljs_declare_global_var);
+}
+
+void Emitter::createTopLevelEnvironment(FR frRes, uint32_t size) {
+  comment("// CreateTopLevelEnvironment r%u, %u", frRes.index(), size);
+  a.mov(x86::rdi, xRuntime);
+  a.xor_(x86::esi, x86::esi);
+  a.mov(x86::edx, size);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, const SHLegacyValue *, uint32_t),
+      _sh_ljs_create_environment);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::createFunctionEnvironment(FR frRes, uint32_t size) {
+  comment("// CreateFunctionEnvironment r%u, %u", frRes.index(), size);
+  a.mov(x86::rdi, xRuntime);
+  a.mov(x86::rsi, xFrame);
+  a.mov(x86::edx, size);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, SHLegacyValue *, uint32_t),
+      _sh_ljs_create_function_environment);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::createEnvironment(FR frRes, FR frParent, uint32_t size) {
+  comment(
+      "// CreateEnvironment r%u, r%u, %u",
+      frRes.index(),
+      frParent.index(),
+      size);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frParent);
+  a.mov(x86::edx, size);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, const SHLegacyValue *, uint32_t),
+      _sh_ljs_create_environment);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::getParentEnvironment(FR frRes, uint32_t level) {
+  comment("// GetParentEnvironment r%u, %u", frRes.index(), level);
+
+  // Get current closure.
+  a.mov(x86::rax, frameSlotMem(StackFrameLayout::CalleeClosureOrCB));
+  emit_sh_ljs_get_pointer(a, x86::rax);
+  // rax = closure->environment
+  loadCPNonNull(
+      x86::rax, x86::qword_ptr(x86::rax, offsetof(SHCallable, environment)));
+  for (; level; --level) {
+    // rax = env->parent.
+    loadCPNonNull(
+        x86::rax,
+        x86::qword_ptr(x86::rax, offsetof(SHEnvironment, parentEnvironment)));
+  }
+  emit_sh_ljs_object(a, x86::rax, x86::rcx);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::getEnvironment(FR frRes, FR frSource, uint32_t level) {
+  comment(
+      "// GetEnvironment r%u, r%u, %u", frRes.index(), frSource.index(), level);
+
+  movGpFromFR(x86::rax, frSource);
+  emit_sh_ljs_get_pointer(a, x86::rax);
+  for (; level; --level) {
+    // rax = env->parent.
+    loadCPNonNull(
+        x86::rax,
+        x86::qword_ptr(x86::rax, offsetof(SHEnvironment, parentEnvironment)));
+  }
+  emit_sh_ljs_object(a, x86::rax, x86::rcx);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::getClosureEnvironment(FR frRes, FR frClosure) {
+  comment(
+      "// GetClosureEnvironment r%u, r%u", frRes.index(), frClosure.index());
+  // We know the layout of the closure, so we can load directly.
+  movGpFromFR(x86::rax, frClosure);
+  emit_sh_ljs_get_pointer(a, x86::rax);
+  loadCPNonNull(
+      x86::rax, x86::qword_ptr(x86::rax, offsetof(SHCallable, environment)));
+  emit_sh_ljs_object(a, x86::rax, x86::rcx);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::loadFromEnvironment(FR frRes, FR frEnv, uint32_t slot) {
+  comment(
+      "// LoadFromEnvironment r%u, r%u, %u",
+      frRes.index(),
+      frEnv.index(),
+      slot);
+  size_t ofs = offsetof(SHEnvironment, slots) + sizeof(SHLegacyValue) * slot;
+  if (ofs > INT32_MAX)
+    hermes_fatal("JIT integer overflow");
+
+  movGpFromFR(x86::rax, frEnv);
+  emit_sh_ljs_get_pointer(a, x86::rax);
+  a.mov(x86::rax, x86::qword_ptr(x86::rax, (int32_t)ofs));
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::storeToEnvironment(bool np, FR frEnv, uint32_t slot, FR frValue) {
+  comment(
+      "// %s r%u, %u, r%u",
+      np ? "StoreNPToEnvironment" : "StoreToEnvironment",
+      frEnv.index(),
+      slot,
+      frValue.index());
+
+  // The write barrier is in the runtime, and the arguments are by value.
+  a.mov(x86::rdi, xRuntime);
+  movGpFromFR(x86::rsi, frEnv);
+  movGpFromFR(x86::rdx, frValue);
+  a.mov(x86::ecx, slot);
+  if (np) {
+    EMIT_RUNTIME_CALL(
+        *this,
+        void (*)(SHRuntime *, SHLegacyValue, SHLegacyValue, uint32_t),
+        _sh_ljs_store_np_to_env);
+  } else {
+    EMIT_RUNTIME_CALL(
+        *this,
+        void (*)(SHRuntime *, SHLegacyValue, SHLegacyValue, uint32_t),
+        _sh_ljs_store_to_env);
+  }
+}
+
+void Emitter::createClosure(
+    FR frRes,
+    FR frEnv,
+    RuntimeModule *runtimeModule,
+    uint32_t functionID) {
+  comment(
+      "// CreateClosure r%u, r%u, %u",
+      frRes.index(),
+      frEnv.index(),
+      functionID);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frEnv);
+  a.mov(x86::rdx, (uint64_t)runtimeModule);
+  a.mov(x86::ecx, functionID);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(
+          SHRuntime *, const SHLegacyValue *, SHRuntimeModule *, uint32_t),
+      _sh_ljs_create_bytecode_closure);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::createBaseClass(FR frRes, FR frPrototypeOut, FR frEnv) {
+  comment(
+      "// CreateBaseClass r%u, r%u, r%u",
+      frRes.index(),
+      frPrototypeOut.index(),
+      frEnv.index());
+  // The interpreter expects that the frameRegs it receives starts on the first
+  // local register. It writes both results to the frame.
+  a.mov(x86::rdi, xRuntime);
+  a.lea(x86::rsi, frMem(FR(0)));
+  EMIT_RUNTIME_CALL(
+      *this, void (*)(SHRuntime *, SHLegacyValue *), _interpreter_create_class);
+}
+
+void Emitter::createDerivedClass(
+    FR frRes,
+    FR frPrototypeOut,
+    FR frEnv,
+    FR frSuperClass) {
+  comment(
+      "// CreateDerivedClass r%u, r%u, r%u r%u",
+      frRes.index(),
+      frPrototypeOut.index(),
+      frEnv.index(),
+      frSuperClass.index());
+  // The interpreter expects that the frameRegs it receives starts on the first
+  // local register. It writes both results to the frame.
+  a.mov(x86::rdi, xRuntime);
+  a.lea(x86::rsi, frMem(FR(0)));
+  EMIT_RUNTIME_CALL(
+      *this, void (*)(SHRuntime *, SHLegacyValue *), _interpreter_create_class);
+}
+
+void Emitter::createGenerator(
+    FR frRes,
+    FR frEnv,
+    RuntimeModule *runtimeModule,
+    uint32_t functionID) {
+  comment(
+      "// CreateGenerator r%u, r%u, %u",
+      frRes.index(),
+      frEnv.index(),
+      functionID);
+  a.mov(x86::rdi, xRuntime);
+  a.mov(x86::rsi, xFrame);
+  loadFrameAddr(x86::rdx, frEnv);
+  a.mov(x86::rcx, (uint64_t)runtimeModule);
+  a.mov(x86::r8d, functionID);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(
+          SHRuntime *,
+          SHLegacyValue *,
+          const SHLegacyValue *,
+          SHRuntimeModule *,
+          uint32_t),
+      _interpreter_create_generator);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::createRegExp(
+    FR frRes,
+    SHSymbolID patternID,
+    SHSymbolID flagsID,
+    uint32_t regexpID) {
+  comment("// CreateRegExp r%u, %u, %u", frRes.index(), patternID, flagsID);
+  a.mov(x86::rdi, xRuntime);
+  a.mov(x86::rsi, (uint64_t)codeBlock_);
+  a.mov(x86::edx, patternID);
+  a.mov(x86::ecx, flagsID);
+  a.mov(x86::r8d, regexpID);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(
+          SHRuntime *, SHCodeBlock *, uint32_t, uint32_t, uint32_t),
+      _interpreter_create_regexp);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::createThis(
+    FR frRes,
+    FR frCallee,
+    FR frNewTarget,
+    uint8_t cacheIdx) {
+  comment(
+      "// CreateThis r%u, r%u, r%u, cache %u",
+      frRes.index(),
+      frCallee.index(),
+      frNewTarget.index(),
+      cacheIdx);
+  a.mov(x86::rdi, xRuntime);
+  loadFrameAddr(x86::rsi, frCallee);
+  loadFrameAddr(x86::rdx, frNewTarget);
+  loadReadCacheEntry(x86::rcx, cacheIdx);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(
+          SHRuntime *,
+          SHLegacyValue *,
+          SHLegacyValue *,
+          SHReadPropertyCacheEntry *),
+      _sh_ljs_create_this);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::selectObject(FR frRes, FR frThis, FR frConstructed) {
+  comment(
+      "// SelectObject r%u, r%u, r%u",
+      frRes.index(),
+      frThis.index(),
+      frConstructed.index());
+  // If Constructed is an object, use it, otherwise use This.
+  movGpFromFR(x86::rax, frConstructed);
+  movGpFromFR(x86::rdx, frThis);
+  emit_sh_ljs_cmp_object(a, x86::rax, x86::rcx);
+  a.cmovb(x86::rax, x86::rdx);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::loadThisNS(FR frRes) {
+  comment("// LoadThisNS r%u", frRes.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  // Load the ThisArg from the stack. If it is an object, we are done.
+  a.mov(x86::rax, frameSlotMem(StackFrameLayout::ThisArg));
+  emit_sh_ljs_cmp_object(a, x86::rax, x86::rcx);
+  a.jb(slowPathLab);
+  a.bind(contLab);
+  movFRFromGp(frRes, x86::rax);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .frRes = frRes,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment("// Slow path: LoadThisNS r%u", sl.frRes.index());
+         em.a.bind(sl.slowPathLab);
+         em.a.mov(x86::rdi, xRuntime);
+         em.a.mov(x86::rsi, x86::rax);
+         EMIT_RUNTIME_CALL(
+             em,
+             SHLegacyValue (*)(SHRuntime *, SHLegacyValue),
+             _sh_ljs_coerce_this_ns);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::coerceThisNS(FR frRes, FR frThis) {
+  comment("// CoerceThisNS r%u, r%u", frRes.index(), frThis.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+  asmjit::Label contLab = newContLabel();
+
+  // If the operand is an object, we are done, otherwise, go to the slow path.
+  movGpFromFR(x86::rax, frThis);
+  emit_sh_ljs_cmp_object(a, x86::rax, x86::rcx);
+  a.jb(slowPathLab);
+  a.bind(contLab);
+  movFRFromGp(frRes, x86::rax);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .frRes = frRes,
+       .frInput1 = frThis,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: CoerceThis r%u, r%u",
+             sl.frRes.index(),
+             sl.frInput1.index());
+         em.a.bind(sl.slowPathLab);
+         em.a.mov(x86::rdi, xRuntime);
+         em.a.mov(x86::rsi, x86::rax);
+         EMIT_RUNTIME_CALL(
+             em,
+             SHLegacyValue (*)(SHRuntime *, SHLegacyValue),
+             _sh_ljs_coerce_this_ns);
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::debugger() {
+  comment("// Debugger");
+  if (dumpJitCode_ & DumpJitCode::BRK)
+    a.int3();
+}
+
+void Emitter::getNewTarget(FR frRes) {
+  comment("// GetNewTarget r%u", frRes.index());
+  a.mov(x86::rax, frameSlotMem(StackFrameLayout::NewTarget));
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::throwInst(FR frInput) {
+  comment("// Throw r%u", frInput.index());
+  a.mov(x86::rdi, xRuntime);
+  movGpFromFR(x86::rsi, frInput);
+  EMIT_RUNTIME_CALL(*this, void (*)(SHRuntime *, SHLegacyValue), _sh_throw);
+}
+
+void Emitter::throwIfEmptyUndefinedImpl(FR frRes, FR frInput, bool empty) {
+  comment(
+      "// %s r%u, r%u",
+      empty ? "ThrowIfEmpty" : "ThrowIfUndefined",
+      frRes.index(),
+      frInput.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+
+  // Compare the extended tag.
+  static_assert(
+      (int16_t)HVETag_Empty == (int16_t)(-14) && "HVETag_Empty must be -14");
+  static_assert(
+      (int16_t)HVETag_Undefined == (int16_t)(-12) &&
+      "HVETag_Undefined must be -12");
+  movGpFromFR(x86::rax, frInput);
+  a.mov(x86::rcx, x86::rax);
+  a.sar(x86::rcx, kHV_NumDataBits - 1);
+  a.cmp(x86::rcx, empty ? (int32_t)HVETag_Empty : (int32_t)HVETag_Undefined);
+  a.je(slowPathLab);
+  movFRFromGp(frRes, x86::rax);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .name = empty ? "ThrowIfEmpty" : "ThrowIfUndefined",
+       .frRes = frRes,
+       .frInput1 = frInput,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: %s r%u, r%u",
+             sl.name,
+             sl.frRes.index(),
+             sl.frInput1.index());
+         em.a.bind(sl.slowPathLab);
+         em.a.mov(x86::rdi, xRuntime);
+         EMIT_RUNTIME_CALL(em, void (*)(SHRuntime *), _sh_throw_empty);
+         // Call does not return.
+       }});
+}
+
+void Emitter::throwIfThisInitialized(FR frInput) {
+  comment("// ThrowIfThisInitialized r%u", frInput.index());
+  asmjit::Label slowPathLab = newSlowPathLabel();
+
+  movGpFromFR(x86::rax, frInput);
+  loadBits64InGp(x86::rcx, _sh_ljs_empty().raw);
+  a.cmp(x86::rax, x86::rcx);
+  a.jne(slowPathLab);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .frInput1 = frInput,
+       .emittingIP = emittingIP,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: ThrowIfThisInitialized r%u", sl.frInput1.index());
+         em.a.bind(sl.slowPathLab);
+         em.a.mov(x86::rdi, xRuntime);
+         EMIT_RUNTIME_CALL(
+             em, void (*)(SHRuntime *), _sh_throw_this_already_initialized);
+         // Call does not return.
+       }});
+}
+
+void Emitter::callImpl(FR frRes, FR frCallee) {
+  uint32_t nRegs = numFrameRegs_;
+
+  emitIncrementCounter(JitCounter::NumCall);
+  FR calleeFrameArg{nRegs + hbc::StackFrameLayout::CalleeClosureOrCB};
+
+  // Store the callee to the right location in the frame, if it isn't already
+  // there.
+  if (frCallee != calleeFrameArg) {
+    movGpFromFR(x86::rax, frCallee);
+    movFRFromGp(calleeFrameArg, x86::rax);
+  }
+
+  static_assert(
+      HERMESVALUE_VERSION == 2,
+      "Native pointers must be encoded without modification");
+  movFRFromGp(FR{nRegs + hbc::StackFrameLayout::PreviousFrame}, xFrame);
+
+  // Save the current IP in both the SavedIP slot and the runtime.
+  getBytecodeIP(x86::rax);
+  movFRFromGp(FR{nRegs + hbc::StackFrameLayout::SavedIP}, x86::rax);
+  a.mov(x86::qword_ptr(xRuntime, RuntimeOffsets::currentIP), x86::rax);
+
+  a.mov(frMem(FR{nRegs + hbc::StackFrameLayout::SavedCodeBlock}), 0);
+  a.mov(frMem(FR{nRegs + hbc::StackFrameLayout::SHLocals}), 0);
+
+  // If we have not already created a slow path for non-object calls, do so now.
+  if (!nonObjCallLabel_.isValid()) {
+    nonObjCallLabel_ = newSlowPathLabel();
+    slowPaths_.push_back(
+        {.slowPathLab = nonObjCallLabel_,
+         .emit = [](Emitter &em, SlowPath &sl) {
+           em.comment("// Throw on non-object call");
+           em.a.bind(sl.slowPathLab);
+           em.a.mov(x86::rdi, xRuntime);
+           // The IP is already saved by the call setup, no need to save it
+           // again.
+           EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+               em, void (*)(SHRuntime *), _jit_throw_non_object_call);
+           // The call does not return.
+         }});
+  }
+
+  auto slowPathLab = newSlowPathLabel();
+  auto contLab = newContLabel();
+
+  // Check if the callee is a JSFunction we have already JITted. We keep the
+  // callee in rsi so that we don't have to move it in the slow path.
+  movGpFromFR(x86::rsi, calleeFrameArg);
+  emit_sh_ljs_cmp_object(a, x86::rsi, x86::rax);
+  a.jb(nonObjCallLabel_);
+  emit_sh_ljs_get_pointer(a, x86::rsi);
+  a.movzx(
+      x86::eax,
+      x86::byte_ptr(
+          x86::rsi,
+          offsetof(SHGCCell, kindAndSize) + RuntimeOffsets::kindAndSizeKind));
+
+  // Check if it is a JSFunction.
+  a.lea(
+      x86::ecx,
+      x86::ptr(x86::rax, -(int32_t)CellKind::CodeBlockFunctionKind_first));
+  a.cmp(
+      x86::ecx,
+      (uint32_t)CellKind::CodeBlockFunctionKind_last -
+          (uint32_t)CellKind::CodeBlockFunctionKind_first);
+  a.ja(slowPathLab);
+
+  // Check if the JSFunction has already been JIT compiled.
+  a.mov(
+      x86::rdx, x86::qword_ptr(x86::rsi, RuntimeOffsets::jsFunctionCodeBlock));
+  a.mov(x86::rdx, x86::qword_ptr(x86::rdx, RuntimeOffsets::codeBlockJitPtr));
+  a.test(x86::rdx, x86::rdx);
+  a.jz(slowPathLab);
+
+  // We have a JIT compiled function, call it.
+  a.bind(contLab);
+  // Both the fast and slow paths have placed the callee in rsi and the
+  // function to call in rdx.
+  a.mov(x86::rdi, xRuntime);
+  a.call(x86::rdx);
+  movFRFromGp(frRes, x86::rax);
+
+  slowPaths_.push_back(
+      {.slowPathLab = slowPathLab,
+       .contLab = contLab,
+       .frRes = frRes,
+       .frInput1 = frCallee,
+       .emit = [](Emitter &em, SlowPath &sl) {
+         em.comment(
+             "// Slow path: CallImpl r%u, r%u",
+             sl.frRes.index(),
+             sl.frInput1.index());
+         em.a.bind(sl.slowPathLab);
+         em.emitIncrementCounter(JitCounter::NumCallSlow);
+         // Load the jitCall function. eax still contains the callee CellKind
+         // from the fast path.
+         em.a.mov(x86::rdx, (uint64_t)&VTable::jitCallArray);
+         em.a.mov(x86::rdx, x86::qword_ptr(x86::rdx, x86::rax, 3));
+         em.a.jmp(sl.contLab);
+       }});
+}
+
+void Emitter::call(FR frRes, FR frCallee, uint32_t argc) {
+  comment("// Call r%u, r%u, %u", frRes.index(), frCallee.index(), argc);
+  uint32_t nRegs = numFrameRegs_;
+
+  // Store undefined as the new target.
+  loadBits64InGp(x86::rax, _sh_ljs_undefined().raw);
+  movFRFromGp(FR{nRegs + hbc::StackFrameLayout::NewTarget}, x86::rax);
+
+  static_assert(HERMESVALUE_VERSION == 2, "Native u32 must not need encoding");
+  // The bytecode arg count includes "this", but the frame one does not, so
+  // subtract 1.
+  a.mov(x86::eax, argc - 1);
+  movFRFromGp(FR{nRegs + hbc::StackFrameLayout::ArgCount}, x86::rax);
+
+  callImpl(frRes, frCallee);
+}
+
+void Emitter::callN(FR frRes, FR frCallee, llvh::ArrayRef<FR> args) {
+  comment(
+      "// Call%zu r%u, r%u, ...args",
+      args.size(),
+      frRes.index(),
+      frCallee.index());
+  uint32_t nRegs = numFrameRegs_;
+
+  for (uint32_t i = 0; i < args.size(); ++i) {
+    auto argLoc = FR{nRegs + hbc::StackFrameLayout::ThisArg - i};
+    if (args[i] != argLoc) {
+      movGpFromFR(x86::rax, args[i]);
+      movFRFromGp(argLoc, x86::rax);
+    }
+  }
+
+  // Store undefined as the new target.
+  loadBits64InGp(x86::rax, _sh_ljs_undefined().raw);
+  movFRFromGp(FR{nRegs + hbc::StackFrameLayout::NewTarget}, x86::rax);
+
+  static_assert(HERMESVALUE_VERSION == 2, "Native u32 must not need encoding");
+  // The bytecode arg count includes "this", but the frame one does not, so
+  // subtract 1.
+  a.mov(x86::eax, (uint32_t)args.size() - 1);
+  movFRFromGp(FR{nRegs + hbc::StackFrameLayout::ArgCount}, x86::rax);
+
+  callImpl(frRes, frCallee);
+}
+
+void Emitter::callBuiltin(FR frRes, uint32_t builtinIndex, uint32_t argc) {
+  comment(
+      "// CallBuiltin r%u, %s, %u",
+      frRes.index(),
+      getBuiltinMethodName(builtinIndex),
+      argc);
+  a.mov(x86::rdi, xRuntime);
+  a.mov(x86::rsi, xFrame);
+  // The bytecode arg count includes "this", but the SH one does not, so
+  // subtract 1.
+  a.mov(x86::edx, argc - 1);
+  a.mov(x86::ecx, builtinIndex);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(SHRuntime *, SHLegacyValue *, uint32_t, uint32_t),
+      _jit_call_builtin);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::callWithNewTarget(
+    FR frRes,
+    FR frCallee,
+    FR frNewTarget,
+    uint32_t argc) {
+  comment(
+      "// CallWithNewTarget r%u, r%u, r%u, %u",
+      frRes.index(),
+      frCallee.index(),
+      frNewTarget.index(),
+      argc);
+  uint32_t nRegs = numFrameRegs_;
+
+  // Store the new target to the right location in the frame.
+  FR ntFrameArg{nRegs + hbc::StackFrameLayout::NewTarget};
+  if (ntFrameArg != frNewTarget) {
+    movGpFromFR(x86::rax, frNewTarget);
+    movFRFromGp(ntFrameArg, x86::rax);
+  }
+
+  static_assert(HERMESVALUE_VERSION == 2, "Native u32 must not need encoding");
+  // The bytecode arg count includes "this", but the frame one does not, so
+  // subtract 1.
+  a.mov(x86::eax, argc - 1);
+  movFRFromGp(FR{nRegs + hbc::StackFrameLayout::ArgCount}, x86::rax);
+
+  callImpl(frRes, frCallee);
+}
+
+void Emitter::callWithNewTargetLong(
+    FR frRes,
+    FR frCallee,
+    FR frNewTarget,
+    FR frArgc) {
+  comment(
+      "// CallWithNewTargetLong r%u, r%u, r%u, r%u",
+      frRes.index(),
+      frCallee.index(),
+      frNewTarget.index(),
+      frArgc.index());
+  uint32_t nRegs = numFrameRegs_;
+
+  // Store the new target to the right location in the frame.
+  FR ntFrameArg{nRegs + hbc::StackFrameLayout::NewTarget};
+  if (ntFrameArg != frNewTarget) {
+    movGpFromFR(x86::rax, frNewTarget);
+    movFRFromGp(ntFrameArg, x86::rax);
+  }
+
+  static_assert(HERMESVALUE_VERSION == 2, "Native u32 must not need encoding");
+  // The arg count is a number register. The bytecode arg count includes
+  // "this", but the frame one does not, so subtract 1.
+  a.movsd(x86::xmm0, frMem(frArgc));
+  a.cvttsd2si(x86::rax, x86::xmm0);
+  a.sub(x86::rax, 1);
+  movFRFromGp(FR{nRegs + hbc::StackFrameLayout::ArgCount}, x86::rax);
+
+  callImpl(frRes, frCallee);
+}
+
+void Emitter::callRequire(FR frRes, FR frRequireFunc, uint32_t modIndex) {
+  comment(
+      "// CallRequire r%u, r%u, %u",
+      frRes.index(),
+      frRequireFunc.index(),
+      modIndex);
+  a.mov(x86::rdi, xRuntime);
+  a.mov(
+      x86::rsi,
+      (uint64_t)codeBlock_->getRuntimeModule() +
+          RuntimeOffsets::runtimeModuleModuleCache);
+  loadFrameAddr(x86::rdx, frRequireFunc);
+  a.mov(x86::ecx, modIndex);
+  EMIT_RUNTIME_CALL(
+      *this,
+      SHLegacyValue (*)(
+          SHRuntime *, SHArrayStorage **, SHLegacyValue *, uint32_t),
+      _sh_ljs_callRequire);
+  movFRFromGp(frRes, x86::rax);
+}
+
+void Emitter::loadBuiltinClosure(
+    const x86::Gp &dest,
+    const x86::Gp &tmp,
+    uint32_t builtinIndex) {
+  static_assert(
+      std::is_same_v<
+          TransparentOwningPtr<Callable *, llvh::FreeDeleter>,
+          RuntimeOffsets::BuiltinsType>,
+      "builtins_ is a list of Callable *");
+  static_assert(
+      offsetof(TransparentOwningPtr<Callable *>, ptr) == 0,
+      "TransparentOwningPtr must be transparent");
+
+  a.mov(dest, x86::qword_ptr(xRuntime, RuntimeOffsets::builtins));
+  a.mov(dest, x86::qword_ptr(dest, builtinIndex * sizeof(Callable *)));
+  emit_sh_ljs_object(a, dest, tmp);
+}
+
+void Emitter::getBuiltinClosure(FR frRes, uint32_t builtinIndex) {
+  comment(
+      "// GetBuiltinClosure r%u, %s",
+      frRes.index(),
+      getBuiltinMethodName(builtinIndex));
+  loadBuiltinClosure(x86::rax, x86::rcx, builtinIndex);
+  movFRFromGp(frRes, x86::rax);
+}
+
+int32_t Emitter::reserveData(
+    int32_t dsize,
+    size_t align,
+    asmjit::TypeId typeId,
+    int32_t itemCount,
+    const char *comment) {
+  // Align the new data.
+  size_t oldSize = roData_.size();
+  size_t dataOfs = (roData_.size() + align - 1) & ~(align - 1);
+  if (dataOfs >= INT32_MAX)
+    hermes::hermes_fatal("JIT RO data overflow");
+  // Grow to include the data.
+  roData_.resize(dataOfs + dsize);
+
+  // If logging is enabled, generate data descriptors.
+  if (hasLogger()) {
+    // Optional padding descriptor.
+    if (dataOfs != oldSize) {
+      int32_t gap = (int32_t)(dataOfs - oldSize);
+      roDataDesc_.push_back(
+          {.size = gap, .typeId = asmjit::TypeId::kUInt8, .itemCount = gap});
+    }
+
+    roDataDesc_.push_back(
+        {.size = dsize,
+         .typeId = typeId,
+         .itemCount = itemCount,
+         .comment = comment});
+  }
+
+  return (int32_t)dataOfs;
+}
+
+int32_t Emitter::uint64Const(uint64_t bits, const char *comment) {
+  auto [it, inserted] = fp64ConstMap_.try_emplace(bits, 0);
+  if (inserted) {
+    int32_t dataOfs = reserveData(
+        sizeof(double), sizeof(double), asmjit::TypeId::kFloat64, 1, comment);
+    memcpy(roData_.data() + dataOfs, &bits, sizeof(double));
+    it->second = dataOfs;
+  }
+  return it->second;
+}
+
+void Emitter::emitCatchTable(
+    llvh::ArrayRef<const asmjit::Label *> exceptionHandlers) {
+  // No trys in the function, nothing to do here.
+  if (!catchTableLabel_.isValid())
+    return;
+
+  a.bind(catchTableLabel_);
+
+  asmjit::Label addressTableLab = a.newLabel();
+
+  // Find the catch target for the exception. longjmp has restored rsp and the
+  // callee-saved registers holding the runtime and the frame.
+  a.mov(x86::rdi, xRuntime);
+  a.mov(x86::rsi, (uint64_t)codeBlock_);
+  a.mov(x86::rdx, xFrame);
+  a.lea(x86::rcx, x86::ptr(x86::rsp, getJmpBufOffset()));
+  a.mov(x86::r8, x86::qword_ptr(x86::rsp, getSavedSHLocalsOffset()));
+  a.lea(x86::r9, x86::ptr(addressTableLab));
+  EMIT_RUNTIME_CALL_WITHOUT_SAVED_IP(
+      *this,
+      void *(*)(SHRuntime *,
+                SHCodeBlock *,
+                SHLegacyValue *,
+                SHJmpBuf *,
+                SHLocals *,
+                int32_t *),
+      _jit_find_catch_target);
+
+  // The address to branch to was returned here.
+  a.jmp(x86::rax);
+
+  // Table of offsets from addressTableLab to jump to.
+  a.align(asmjit::AlignMode::kData, 4);
+  a.bind(addressTableLab);
+  for (const asmjit::Label *handler : exceptionHandlers) {
+    a.embedLabelDelta(*handler, addressTableLab, /* size */ 4);
+  }
+}
+
+void Emitter::emitSlowPaths() {
+  while (!slowPaths_.empty()) {
+    SlowPath &sp = slowPaths_.front();
+    emittingIP = sp.emittingIP;
+    sp.emit(*this, sp);
+    slowPaths_.pop_front();
+  }
+  emittingIP = nullptr;
+}
+
+void Emitter::emitROData() {
+  a.align(asmjit::AlignMode::kData, 8);
+  a.bind(roDataLabel_);
+  if (!hasLogger()) {
+    a.embed(roData_.data(), roData_.size());
+  } else {
+    int32_t ofs = 0;
+    for (const auto &desc : roDataDesc_) {
+      if (desc.comment)
+        comment("// %s", desc.comment);
+      a.embedDataArray(desc.typeId, roData_.data() + ofs, desc.itemCount);
+      ofs += desc.size;
+    }
+  }
+}
+
+} // namespace hermes::vm::x86_64
+#endif // HERMESVM_JIT
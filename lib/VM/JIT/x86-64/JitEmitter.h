@@ -0,0 +1,893 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "asmjit/x86.h"
+
+#include "hermes/FrontEndDefs/Typeof.h"
+#include "hermes/VM/CodeBlock.h"
+#include "hermes/VM/JIT/JIT.h"
+#include "hermes/VM/JIT/PerfJitDump.h"
+#include "hermes/VM/JIT/x86-64/JIT.h"
+#include "hermes/VM/RuntimeModule.h"
+#include "hermes/VM/static_h.h"
+#include "hermes/VMLayouts/StackFrameLayout.h"
+
+#include "llvh/ADT/DenseMap.h"
+#include "llvh/ADT/SmallVector.h"
+
+#include <deque>
+
+namespace hermes::vm::x86_64 {
+
+namespace x86 = asmjit::x86;
+
+/// A HermesVM frame register
+class FR {
+  uint32_t index_;
+
+ public:
+  static constexpr uint32_t kInvalid = UINT32_MAX;
+
+  FR() : index_(kInvalid) {}
+  constexpr explicit FR(uint32_t index) : index_(index) {}
+
+  constexpr bool isValid() const {
+    return index_ != kInvalid;
+  }
+
+  constexpr uint32_t index() const {
+    return index_;
+  }
+  bool operator==(const FR &fr) const {
+    return fr.index_ == index_;
+  }
+  bool operator!=(const FR &fr) const {
+    return fr.index_ != index_;
+  }
+};
+
+enum class FRType : uint8_t {
+  Number = 1,
+  Bool = 2,
+  /// Any other non-pointer type.
+  OtherNonPtr = 4,
+  Pointer = 8,
+  UnknownNonPtr = Number | Bool | OtherNonPtr,
+  UnknownPtr = UnknownNonPtr | Pointer,
+};
+
+// rbx is runtime
+static constexpr auto xRuntime = x86::rbx;
+// r12 is frame
+static constexpr auto xFrame = x86::r12;
+// r13 holds the return value until the epilogue.
+static constexpr auto xRetVal = x86::r13;
+// r14 is the start of the bytecode, used to compute the saved IP.
+static constexpr auto xBytecode = x86::r14;
+
+/// Callee-saved registers pushed by the prologue after rbp, in order.
+static constexpr unsigned kNumSavedGp = 4;
+
+/// Baseline emitter for x86-64.
+///
+/// Unlike the arm64 emitter, it does not allocate frame registers to hardware
+/// registers: every frame register lives in the register stack, and each
+/// instruction loads its operands into fixed scratch registers, computes the
+/// fast path inline, and falls back to the same runtime functions for
+/// everything else. This keeps all frame registers up to date at every call,
+/// so calls, exceptions and the GC need no register bookkeeping.
+class Emitter {
+  Runtime &runtime_;
+  JITContext::Impl &jitImpl_;
+
+  /// Level of dumping JIT code. Bit 0 indicates code printing on or off.
+  unsigned const dumpJitCode_;
+  /// Whether to emit asserts in the JIT'ed code.
+  bool const emitAsserts_;
+  /// Whether to emit counters in the JIT'ed code.
+  bool const emitCounters_;
+
+#ifndef ASMJIT_NO_LOGGING
+  std::unique_ptr<asmjit::Logger> logger_{};
+#endif
+
+  std::unique_ptr<asmjit::ErrorHandler> errorHandler_;
+  asmjit::Error expectedError_ = asmjit::kErrorOk;
+
+  /// Number of frame registers in the function.
+  uint32_t const numFrameRegs_;
+
+  /// Keep enough information to generate a slow path at the end of the
+  /// function.
+  struct SlowPath {
+    /// Label of the slow path.
+    asmjit::Label slowPathLab;
+    /// Label to jump to after the slow path.
+    asmjit::Label contLab;
+    /// Target if this is a branch.
+    asmjit::Label target;
+
+    /// Name of the slow path.
+    const char *name;
+    /// Frame register indexes;
+    FR frRes, frInput1, frInput2;
+    /// Whether to invert a condition.
+    bool invert;
+    /// Some number or index that needs to be passed to the slow path.
+    unsigned sizeOrIdx;
+
+    /// Pointer to the slow path function that must be called.
+    void *slowCall;
+    /// The name of the slow path function.
+    const char *slowCallName;
+
+    /// Bytecode IP of the instruction that this is a slow path for.
+    const inst::Inst *emittingIP;
+
+    /// Callback to actually emit.
+    void (*emit)(Emitter &em, SlowPath &sl);
+  };
+  /// Queue of slow paths.
+  std::deque<SlowPath> slowPaths_{};
+
+  /// An on-stack replacement entry point requested by addOSREntry().
+  struct OSREntry {
+    /// Bytecode offset of the loop header.
+    uint32_t offset;
+    /// The label of the loop header basic block.
+    asmjit::Label target;
+    /// The label of the entry point.
+    asmjit::Label entry;
+  };
+  /// The entry points to emit in leave().
+  llvh::SmallVector<OSREntry, 2> osrEntries_{};
+
+  /// Descriptor for a single RO data entry.
+  struct DataDesc {
+    /// Size in bytes.
+    int32_t size;
+    asmjit::TypeId typeId;
+    int32_t itemCount;
+    /// Optional comment.
+    const char *comment;
+  };
+  /// Used for pretty printing when logging data.
+  std::vector<DataDesc> roDataDesc_{};
+  std::vector<uint8_t> roData_{};
+  asmjit::Label roDataLabel_{};
+
+  /// Map from the bit pattern of a double value to offset in constant pool.
+  llvh::DenseMap<uint64_t, int32_t> fp64ConstMap_{};
+
+  /// Label to branch to when returning from a function. Return value will be
+  /// in r13.
+  asmjit::Label returnLabel_{};
+
+  /// Label to branch to when catching an exception with setjmp.
+  /// Invalid if there's no try/catch in the function.
+  asmjit::Label catchTableLabel_{};
+
+  /// Label to branch to when attempting to call a non-object. The callee and
+  /// saved IP must already be in the right position on the stack. This is
+  /// initialized lazily by the first call, and shared across all calls.
+  asmjit::Label nonObjCallLabel_{};
+
+  /// The bytecode codeblock.
+  CodeBlock *const codeBlock_;
+
+  /// Optionally, the offset of the string name, used for debug printing.
+  int32_t roOfsDebugFunctionName_ = -1;
+
+ public:
+  asmjit::CodeHolder code{};
+  x86::Assembler a{};
+  /// The IP of the instruction being emitted.
+  const inst::Inst *emittingIP{nullptr};
+
+  /// Create an Emitter, but do not emit any actual code.
+  /// Use \c enter to set up the stack frame before emitting the actual code.
+  explicit Emitter(
+      Runtime &runtime,
+      JITContext::Impl &jitImpl,
+      unsigned dumpJitCode,
+      bool emitAsserts,
+      bool emitCounters,
+      PerfJitDump *perfJitDump,
+      CodeBlock *codeBlock,
+      const std::function<void(std::string &&message)> &longjmpError);
+
+  /// Add the jitted function to the JIT runtime and return a pointer to it.
+  JITCompiledFunctionPtr addToRuntime(asmjit::JitRuntime &jr);
+
+  /// Set up the stack frame. Must be called before emitting any real code.
+  void enter();
+
+  /// Log a comment.
+  /// Annotated with printf-style format.
+  void comment(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+  /// Emit the catch table, slow paths and RO data,
+  /// then reset the stack, end any try, and return.
+  /// \param exceptionHandlers the labels for the exception handler table.
+  void leave(llvh::ArrayRef<const asmjit::Label *> exceptionHandlers);
+  void newBasicBlock(const asmjit::Label &label);
+
+  /// Request an on-stack replacement entry point, which continues the frame
+  /// set up by the interpreter at \p target, the label of the basic block at
+  /// bytecode \p offset. The entry points are emitted by leave().
+  void addOSREntry(uint32_t offset, const asmjit::Label &target);
+
+  /// \return the on-stack replacement entry points of \p fn, which was
+  ///   returned by addToRuntime(), sorted by bytecode offset.
+  std::vector<JITOSREntry> getOSREntries(JITCompiledFunctionPtr fn);
+
+  /// Abort execution.
+  void unreachable();
+
+  /// Emit profiling information if profiling is enabled.
+  void profilePoint(uint16_t point);
+
+  void directEval(FR frRes, FR frText, bool strictCaller);
+
+  /// Call a JS function.
+  void call(FR frRes, FR frCallee, uint32_t argc);
+  void callN(FR frRes, FR frCallee, llvh::ArrayRef<FR> args);
+  void callBuiltin(FR frRes, uint32_t builtinIndex, uint32_t argc);
+  void callWithNewTarget(FR frRes, FR frCallee, FR frNewTarget, uint32_t argc);
+  void callWithNewTargetLong(FR frRes, FR frCallee, FR frNewTarget, FR frArgc);
+  void callRequire(FR frRes, FR frRequireFunc, uint32_t modIndex);
+  void getBuiltinClosure(FR frRes, uint32_t builtinIndex);
+
+  void catchInst(FR frRes);
+
+  /// Save the return value in r13.
+  void ret(FR frValue);
+  void mov(FR frRes, FR frInput, bool logComment = true);
+  void loadParam(FR frRes, uint32_t paramIndex);
+  void loadConstDouble(FR frRes, double val, const char *name);
+  void loadConstBits64(FR frRes, uint64_t val, FRType type, const char *name);
+  void loadConstString(FR frRes, SymbolID symID);
+  void
+  loadConstBigInt(FR frRes, RuntimeModule *runtimeModule, uint32_t bigIntID);
+  void toNumber(FR frRes, FR frInput);
+  void toNumeric(FR frRes, FR frInput);
+  void toInt32(FR frRes, FR frInput, bool isSigned);
+  void addEmptyString(FR frRes, FR frInput);
+
+  void mod(bool forceNumber, FR frRes, FR frLeft, FR frRight);
+
+#define DECL_BINOP(methodName, forceNum, commentStr, slowCall, x86body) \
+  void methodName(FR rRes, FR rLeft, FR rRight) {                       \
+    arithBinOp(                                                         \
+        forceNum,                                                       \
+        rRes,                                                           \
+        rLeft,                                                          \
+        rRight,                                                         \
+        commentStr,                                                     \
+        [](x86::Assembler & as, const x86::Xmm &dl, const x86::Xmm &dr) \
+            x86body,                                                    \
+        (void *)slowCall,                                               \
+        #slowCall);                                                     \
+  }
+
+  DECL_BINOP(mul, false, "mul", _sh_ljs_mul_rjs, { as.mulsd(dl, dr); })
+  DECL_BINOP(add, false, "add", _sh_ljs_add_rjs, { as.addsd(dl, dr); })
+  DECL_BINOP(sub, false, "sub", _sh_ljs_sub_rjs, { as.subsd(dl, dr); })
+  DECL_BINOP(div, false, "div", _sh_ljs_div_rjs, { as.divsd(dl, dr); })
+  DECL_BINOP(mulN, true, "mulN", _sh_ljs_mul_rjs, { as.mulsd(dl, dr); })
+  DECL_BINOP(addN, true, "addN", _sh_ljs_add_rjs, { as.addsd(dl, dr); })
+  DECL_BINOP(subN, true, "subN", _sh_ljs_sub_rjs, { as.subsd(dl, dr); })
+  DECL_BINOP(divN, true, "divN", _sh_ljs_div_rjs, { as.divsd(dl, dr); })
+#undef DECL_BINOP
+
+  /// The fast path of bitwise operators gets the left operand in eax and the
+  /// right operand in ecx, so shifts can use cl directly.
+#define DECL_BIT_BINOP(methodName, unsignedRes, commentStr, slowCall, x86body) \
+  void methodName(FR rRes, FR rLeft, FR rRight) {                              \
+    bitBinOp(                                                                  \
+        rRes,                                                                  \
+        rLeft,                                                                 \
+        rRight,                                                                \
+        unsignedRes,                                                           \
+        commentStr,                                                            \
+        slowCall,                                                              \
+        #slowCall,                                                             \
+        [](x86::Assembler & a) x86body);                                       \
+  }
+
+  DECL_BIT_BINOP(bitAnd, false, "bit_and", _sh_ljs_bit_and_rjs, {
+    a.and_(x86::eax, x86::ecx);
+  })
+  DECL_BIT_BINOP(bitOr, false, "bit_or", _sh_ljs_bit_or_rjs, {
+    a.or_(x86::eax, x86::ecx);
+  })
+  DECL_BIT_BINOP(bitXor, false, "bit_xor", _sh_ljs_bit_xor_rjs, {
+    a.xor_(x86::eax, x86::ecx);
+  })
+  DECL_BIT_BINOP(lShift, false, "lshift", _sh_ljs_left_shift_rjs, {
+    a.shl(x86::eax, x86::cl);
+  })
+  DECL_BIT_BINOP(rShift, false, "rshift", _sh_ljs_right_shift_rjs, {
+    a.sar(x86::eax, x86::cl);
+  })
+  DECL_BIT_BINOP(urShift, true, "rshiftu", _sh_ljs_unsigned_right_shift_rjs, {
+    a.shr(x86::eax, x86::cl);
+  })
+
+#undef DECL_BIT_BINOP
+
+  void inc(FR rRes, FR rInput) {
+    arithUnop(
+        rRes, rInput, "inc", 1.0, (void *)_sh_ljs_inc_rjs, "_sh_ljs_inc_rjs");
+  }
+  void dec(FR rRes, FR rInput) {
+    arithUnop(
+        rRes, rInput, "dec", -1.0, (void *)_sh_ljs_dec_rjs, "_sh_ljs_dec_rjs");
+  }
+  void negate(FR rRes, FR rInput);
+
+  void jmpTrueFalse(bool onTrue, const asmjit::Label &target, FR frInput);
+  void jmpUndefined(const asmjit::Label &target, FR frInput);
+  void jmp(const asmjit::Label &target);
+
+  void booleanNot(FR frRes, FR frInput);
+  void bitNot(FR frRes, FR frInput);
+  void typeOf(FR frRes, FR frInput);
+  void typeOfIs(FR frRes, FR frInput, TypeOfIsTypes types);
+  void
+  jmpTypeOfIs(const asmjit::Label &target, FR frInput, TypeOfIsTypes types);
+  void jmpBuiltinIs(
+      bool invert,
+      const asmjit::Label &target,
+      uint8_t builtinIndex,
+      FR frInput);
+
+  void uintSwitchImm(
+      FR frInput,
+      const asmjit::Label &defaultLabel,
+      llvh::ArrayRef<const asmjit::Label *> labels,
+      uint32_t minVal,
+      uint32_t maxVal);
+
+  /// Information for a case of a StringSwitchImm instruction.
+  struct StringSwitchCase {
+    // The string id of the case label.
+    uint32_t caseLabelStringId;
+    // A JIT label for the start of JITted code for the the basic block
+    // corresponding to the case.
+    const asmjit::Label *target;
+
+    StringSwitchCase(uint32_t caseLabelStringId, const asmjit::Label *target)
+        : caseLabelStringId(caseLabelStringId), target(target) {}
+  };
+
+  /// Emit a string switch. The lookup table is identified at runtime by
+  /// (\p runtimeModule, \p tableIndex), and its entries must be pointed at the
+  /// case labels once the code has been added to the runtime.
+  void stringSwitchImm(
+      FR frInput,
+      RuntimeModule *runtimeModule,
+      uint32_t tableIndex,
+      const asmjit::Label &defaultLabel);
+
+  /// \return the address of \p label in \p fn, which was returned by
+  ///   addToRuntime().
+  void *getLabelAddress(JITCompiledFunctionPtr fn, const asmjit::Label &label);
+
+  /// The condition codes are those of "ucomisd left, right" when neither
+  /// operand is NaN.
+#define DECL_COMPARE(methodName, commentStr, slowCall, condCode, invSlow) \
+  void methodName(FR rRes, FR rLeft, FR rRight) {                         \
+    compareImpl(                                                          \
+        rRes,                                                             \
+        rLeft,                                                            \
+        rRight,                                                           \
+        commentStr,                                                       \
+        x86::CondCode::condCode,                                          \
+        (void *)slowCall,                                                 \
+        #slowCall,                                                        \
+        invSlow);                                                         \
+  }
+  DECL_COMPARE(greater, "greater", _sh_ljs_greater_rjs, kA, false)
+  DECL_COMPARE(
+      greaterEqual,
+      "greater_equal",
+      _sh_ljs_greater_equal_rjs,
+      kAE,
+      false)
+  DECL_COMPARE(less, "less", _sh_ljs_less_rjs, kB, false)
+  DECL_COMPARE(lessEqual, "less_equal", _sh_ljs_less_equal_rjs, kBE, false)
+  DECL_COMPARE(equal, "Eq", _sh_ljs_equal_rjs, kE, false)
+  DECL_COMPARE(notEqual, "Neq", _sh_ljs_equal_rjs, kNE, true)
+#undef DECL_COMPARE
+
+  void strictEqual(FR frRes, FR frLeft, FR frRight) {
+    strictEqualImpl(false, frRes, frLeft, frRight);
+  }
+  void strictNotEqual(FR frRes, FR frLeft, FR frRight) {
+    strictEqualImpl(true, frRes, frLeft, frRight);
+  }
+
+#define DECL_JCOND(methodName, commentStr, slowCall, condCode)         \
+  void methodName(                                                     \
+      bool invert, const asmjit::Label &target, FR rLeft, FR rRight) { \
+    jCond(                                                             \
+        invert,                                                        \
+        target,                                                        \
+        rLeft,                                                         \
+        rRight,                                                        \
+        commentStr,                                                    \
+        x86::CondCode::condCode,                                       \
+        (void *)slowCall,                                              \
+        #slowCall);                                                    \
+  }
+  DECL_JCOND(jGreater, "greater", _sh_ljs_greater_rjs, kA)
+  DECL_JCOND(
+      jGreaterEqual,
+      "greater_equal",
+      _sh_ljs_greater_equal_rjs,
+      kAE)
+  DECL_JCOND(jLess, "less", _sh_ljs_less_rjs, kB)
+  DECL_JCOND(jLessEqual, "less_equal", _sh_ljs_less_equal_rjs, kBE)
+  DECL_JCOND(jLessN, "less_n", _sh_ljs_less_rjs, kB)
+  DECL_JCOND(jLessEqualN, "less_equal_n", _sh_ljs_less_equal_rjs, kBE)
+  DECL_JCOND(jEqual, "eq", _sh_ljs_equal_rjs, kE)
+#undef DECL_JCOND
+
+  void
+  jStrictEqual(bool invert, const asmjit::Label &target, FR frLeft, FR frRight);
+
+  void getByVal(FR frRes, FR frSource, FR frKey);
+  void getByIndex(FR frRes, FR frSource, uint32_t key);
+  void getByValWithReceiver(FR frRes, FR frSource, FR frKey, FR frReceiver);
+  void putByValWithReceiver(
+      FR frTarget,
+      FR frKey,
+      FR frValue,
+      FR frReceiver,
+      bool isStrict);
+  void delByVal(FR frRes, FR frTarget, FR frKey, bool strict);
+
+#define DECL_PUT_BY_VAL(methodName, commentStr, shFn)                \
+  void methodName(FR frTarget, FR frKey, FR frValue) {               \
+    putByValImpl(frTarget, frKey, frValue, commentStr, shFn, #shFn); \
+  }
+
+  DECL_PUT_BY_VAL(putByValLoose, "putByValLoose", _sh_ljs_put_by_val_loose_rjs);
+  DECL_PUT_BY_VAL(
+      putByValStrict,
+      "putByValStrict",
+      _sh_ljs_put_by_val_strict_rjs);
+
+#define DECL_GET_BY_ID(methodName, commentStr, shFn)                           \
+  void methodName(FR frRes, SHSymbolID symID, FR frSource, uint8_t cacheIdx) { \
+    getByIdImpl(frRes, symID, frSource, cacheIdx, commentStr, shFn, #shFn);    \
+  }
+
+  DECL_GET_BY_ID(getById, "getById", _sh_ljs_get_by_id_rjs)
+  DECL_GET_BY_ID(tryGetById, "tryGetById", _sh_ljs_try_get_by_id_rjs)
+
+  void getByIdWithReceiver(
+      FR frRes,
+      SHSymbolID symID,
+      FR frSource,
+      FR frReceiver,
+      uint8_t cacheIdx);
+
+#define DECL_PUT_BY_ID(methodName, strictMode, tryProp)                   \
+  void methodName(                                                        \
+      FR frTarget, SHSymbolID symID, FR frValue, uint8_t cacheIdx) {      \
+    putByIdImpl(frTarget, symID, frValue, cacheIdx, strictMode, tryProp); \
+  }
+
+  DECL_PUT_BY_ID(putByIdLoose, false, false);
+  DECL_PUT_BY_ID(putByIdStrict, true, false);
+  DECL_PUT_BY_ID(tryPutByIdLoose, false, true);
+  DECL_PUT_BY_ID(tryPutByIdStrict, true, true);
+
+  void
+  defineOwnById(FR frTarget, SHSymbolID symID, FR frValue, uint8_t cacheIdx);
+  void defineOwnByIndex(FR frTarget, FR frValue, uint32_t key);
+  void defineOwnByVal(FR frTarget, FR frValue, FR frKey, bool enumerable);
+  void defineOwnInDenseArray(FR frArray, FR frProp, uint32_t idx);
+  void defineOwnGetterSetterByVal(
+      FR frTarget,
+      FR frKey,
+      FR frGetter,
+      FR frSetter,
+      bool enumerable);
+  void getOwnBySlotIdx(FR frRes, FR frTarget, uint32_t slotIdx);
+  void putOwnBySlotIdx(FR frTarget, FR frValue, uint32_t slotIdx);
+  void loadParentNoTraps(FR frRes, FR frObj);
+  void typedLoadParent(FR frRes, FR frObj);
+
+  void addOwnPrivateBySym(FR frTarget, FR frKey, FR frValue);
+  void getOwnPrivateBySym(FR frRes, FR frTarget, FR frKey, uint8_t cacheIdx);
+  void putOwnPrivateBySym(FR frTarget, FR frKey, FR frValue, uint8_t cacheIdx);
+  void createPrivateName(FR frRes, SHSymbolID symID);
+  void privateIsIn(FR frRes, FR frPrivateName, FR frTarget, uint8_t cacheIdx);
+
+  void instanceOf(FR frRes, FR frLeft, FR frRight);
+  void isIn(FR frRes, FR frLeft, FR frRight);
+
+  void getPNameList(FR frRes, FR frObj, FR frIdx, FR frSize);
+  void getNextPName(FR frRes, FR frProps, FR frObj, FR frIdx, FR frSize);
+  void toPropertyKey(FR frRes, FR frVal);
+  void addS(FR frRes, FR frLeft, FR frRight);
+
+  void iteratorBegin(FR frRes, FR frSource);
+  void iteratorNext(FR frRes, FR frIteratorOrIdx, FR frSourceOrNext);
+  void iteratorClose(FR frIteratorOrIdx, bool ignoreExceptions);
+
+  void getArgumentsPropByValLoose(FR frRes, FR frIndex, FR frLazyReg) {
+    getArgumentsPropByValImpl(
+        frRes,
+        frIndex,
+        frLazyReg,
+        "GetArgumentsPropByValLoose",
+        _sh_ljs_get_arguments_prop_by_val_loose,
+        "_sh_ljs_get_arguments_prop_by_val_loose");
+  }
+  void getArgumentsPropByValStrict(FR frRes, FR frIndex, FR frLazyReg) {
+    getArgumentsPropByValImpl(
+        frRes,
+        frIndex,
+        frLazyReg,
+        "GetArgumentsPropByValStrict",
+        _sh_ljs_get_arguments_prop_by_val_strict,
+        "_sh_ljs_get_arguments_prop_by_val_strict");
+  }
+  void getArgumentsLength(FR frRes, FR frLazyReg);
+  void reifyArgumentsLoose(FR frLazyReg) {
+    reifyArgumentsImpl(frLazyReg, false, "ReifyArgumentsLoose");
+  }
+  void reifyArgumentsStrict(FR frLazyReg) {
+    reifyArgumentsImpl(frLazyReg, true, "ReifyArgumentsStrict");
+  }
+
+  asmjit::Label newPrefLabel(const char *pref, size_t index);
+
+  void newObject(FR frRes);
+  void newObjectWithParent(FR frRes, FR frParent);
+  void newObjectWithBuffer(
+      FR frRes,
+      uint32_t shapeTableIndex,
+      uint32_t valBufferOffset);
+  void newObjectWithBufferAndParent(
+      FR frRes,
+      FR frParent,
+      uint32_t shapeTableIndex,
+      uint32_t valBufferOffset);
+  void newTypedObjectWithBuffer(
+      FR frRes,
+      FR frParent,
+      uint32_t shapeTableIndex,
+      uint32_t valBufferOffset,
+      uint8_t nonEnumerable);
+  void newArray(FR frRes, uint32_t size);
+  void newArrayWithBuffer(
+      FR frRes,
+      uint32_t numElements,
+      uint32_t numLiterals,
+      uint32_t bufferIndex);
+  void newFastArray(FR frRes, FR frProto, uint32_t size);
+  void fastArrayLength(FR frRes, FR frArr);
+  void fastArrayLoad(FR frRes, FR frArr, FR frIdx);
+  void fastArrayStore(FR frArr, FR frIdx, FR frVal);
+  void fastArrayPush(FR frArr, FR frVal);
+  void fastArrayAppend(FR frArr, FR frOther);
+
+  void getGlobalObject(FR frRes);
+  void declareGlobalVar(SHSymbolID symID);
+  void createTopLevelEnvironment(FR frRes, uint32_t size);
+  void createFunctionEnvironment(FR frRes, uint32_t size);
+  void createEnvironment(FR frRes, FR frParent, uint32_t size);
+  void getParentEnvironment(FR frRes, uint32_t level);
+  void getEnvironment(FR frRes, FR frSource, uint32_t level);
+  void getClosureEnvironment(FR frRes, FR frClosure);
+  void loadFromEnvironment(FR frRes, FR frEnv, uint32_t slot);
+  void storeToEnvironment(bool np, FR frEnv, uint32_t slot, FR frValue);
+  void createClosure(
+      FR frRes,
+      FR frEnv,
+      RuntimeModule *runtimeModule,
+      uint32_t functionID);
+  void createBaseClass(FR frRes, FR frPrototypeOut, FR frEnv);
+  void
+  createDerivedClass(FR frRes, FR frPrototypeOut, FR frEnv, FR frSuperClass);
+  void createGenerator(
+      FR frRes,
+      FR frEnv,
+      RuntimeModule *runtimeModule,
+      uint32_t functionID);
+  void createRegExp(
+      FR frRes,
+      SHSymbolID patternID,
+      SHSymbolID flagsID,
+      uint32_t regexpID);
+
+  void createThis(FR frRes, FR frCallee, FR frNewTarget, uint8_t cacheIdx);
+  void selectObject(FR frRes, FR frThis, FR frConstructed);
+
+  void loadThisNS(FR frRes);
+  void coerceThisNS(FR frRes, FR frThis);
+  void getNewTarget(FR frRes);
+
+  void debugger();
+  void throwInst(FR frInput);
+  void throwIfEmpty(FR frRes, FR frInput) {
+    throwIfEmptyUndefinedImpl(frRes, frInput, true);
+  }
+  void throwIfUndefined(FR frRes, FR frInput) {
+    throwIfEmptyUndefinedImpl(frRes, frInput, false);
+  }
+  void throwIfThisInitialized(FR frInput);
+
+ private:
+  /// Create an x86::Mem to a specifc frame register.
+  static constexpr inline x86::Mem frMem(FR fr) {
+    auto ofs = (fr.index() + hbc::StackFrameLayout::FirstLocal) *
+        sizeof(SHLegacyValue);
+    return x86::qword_ptr(xFrame, (int32_t)ofs);
+  }
+
+  /// Create an x86::Mem to a slot of the frame header, relative to xFrame.
+  static constexpr inline x86::Mem frameSlotMem(int32_t slot) {
+    return x86::qword_ptr(xFrame, slot * (int32_t)sizeof(SHLegacyValue));
+  }
+
+  /// Return true if we are logging, false otherwise.
+  bool hasLogger() {
+#ifndef ASMJIT_NO_LOGGING
+    return logger_ != nullptr;
+#else
+    return false;
+#endif
+  }
+
+  /// Whether the function has a try/catch.
+  bool isInTry() const {
+    return catchTableLabel_.isValid();
+  }
+
+  /// Load an arbitrary bit pattern into a Gp.
+  void loadBits64InGp(const x86::Gp &dest, uint64_t bits);
+
+  /// Load the address of frame register \p frameReg into \p dst.
+  void loadFrameAddr(const x86::Gp &dst, FR frameReg);
+  /// Load frame register \p src into \p dst.
+  void movGpFromFR(const x86::Gp &dst, FR src);
+  /// Store \p src into frame register \p dst.
+  void movFRFromGp(FR dst, const x86::Gp &src);
+
+  /// Encode the 0 or 1 in eax as a HermesValue bool and store it in \p frRes.
+  /// Clobbers rcx.
+  void storeBoolFromEAX(FR frRes);
+
+  /// Set the flags to "below" if the HermesValue in \p gp is a double.
+  /// Clobbers \p tmp.
+  void cmpIsDouble(const x86::Gp &gp, const x86::Gp &tmp);
+
+  /// Convert the double in \p xmm to an int32 in eax, jumping to \p slowLab
+  /// unless it is an integer that fits in 64 bits. Clobbers \p xmmTmp.
+  void truncDoubleToInt32(
+      const x86::Xmm &xmm,
+      const x86::Xmm &xmmTmp,
+      const asmjit::Label &slowLab);
+
+  /// Load the StringPrimitive for \p id as a pointer into \p gpOut.
+  /// The StringPrimitive must already be known to be allocated in the
+  /// IdentifierTable at JIT time.
+  void loadConstStringInGp(SymbolID id, const x86::Gp &gpOut);
+
+  /// Load the decoded compressed pointer at \p mem into \p dest.
+  void loadCPNonNull(const x86::Gp &dest, const x86::Mem &mem);
+
+  /// Load the address of the read property cache entry \p cacheIdx into \p
+  /// dest, or null if caching is disabled.
+  void loadReadCacheEntry(const x86::Gp &dest, uint8_t cacheIdx);
+  /// Load the address of the write property cache entry \p cacheIdx into \p
+  /// dest, or null if caching is disabled.
+  void loadWriteCacheEntry(const x86::Gp &dest, uint8_t cacheIdx);
+
+  /// Emit the bytecode address of the instruction being emitted into \p dest.
+  void getBytecodeIP(const x86::Gp &dest);
+
+  /// Call \p fn, clobbering rax.
+  void callWithoutThunk(void *fn, const char *name);
+  /// Save the current bytecode IP in the runtime and call \p fn.
+  void callThunkWithSavedIP(void *fn, const char *name);
+
+  void emitIncrementCounter(JitCounter counter);
+
+  /// Call a function whose outgoing frame has been set up, except for the
+  /// callee and the fields that don't depend on the call kind.
+  void callImpl(FR frRes, FR frCallee);
+
+  /// Emit the common part of a call to a runtime function that takes
+  /// (shr, &frInput1[, &frInput2]) and returns an SHLegacyValue, which is
+  /// stored in \p frRes. The caller binds any slow path label before calling
+  /// this.
+  void emitRJSCall(
+      FR frRes,
+      FR frInput1,
+      FR frInput2,
+      void *fn,
+      const char *fnName);
+
+  void getByIdImpl(
+      FR frRes,
+      SHSymbolID symID,
+      FR frSource,
+      uint8_t cacheIdx,
+      const char *name,
+      SHLegacyValue (*shImpl)(
+          SHRuntime *shr,
+          const SHLegacyValue *source,
+          SHSymbolID symID,
+          SHReadPropertyCacheEntry *propCacheEntry),
+      const char *shImplName);
+
+  void putByIdImpl(
+      FR frTarget,
+      SHSymbolID symID,
+      FR frValue,
+      uint8_t cacheIdx,
+      bool strictMode,
+      bool tryProp);
+
+  void putByValImpl(
+      FR frTarget,
+      FR frKey,
+      FR frValue,
+      const char *name,
+      void (*shImpl)(
+          SHRuntime *shr,
+          SHLegacyValue *target,
+          SHLegacyValue *key,
+          SHLegacyValue *value),
+      const char *shImplName);
+
+  void arithUnop(
+      FR frRes,
+      FR frInput,
+      const char *name,
+      double addend,
+      void *slowCall,
+      const char *slowCallName);
+
+  void arithBinOp(
+      bool forceNumber,
+      FR frRes,
+      FR frLeft,
+      FR frRight,
+      const char *name,
+      void (*fast)(
+          x86::Assembler &a,
+          const x86::Xmm &dl,
+          const x86::Xmm &dr),
+      void *slowCall,
+      const char *slowCallName);
+
+  void bitBinOp(
+      FR frRes,
+      FR frLeft,
+      FR frRight,
+      bool unsignedRes,
+      const char *name,
+      SHLegacyValue (*slowCall)(
+          SHRuntime *shr,
+          const SHLegacyValue *a,
+          const SHLegacyValue *b),
+      const char *slowCallName,
+      void (*fast)(x86::Assembler &a));
+
+  void compareImpl(
+      FR frRes,
+      FR frLeft,
+      FR frRight,
+      const char *name,
+      x86::CondCode condCode,
+      void *slowCall,
+      const char *slowCallName,
+      bool invSlow);
+
+  void strictEqualImpl(bool invert, FR frRes, FR frLeft, FR frRight);
+
+  void jCond(
+      bool invert,
+      const asmjit::Label &target,
+      FR frLeft,
+      FR frRight,
+      const char *name,
+      x86::CondCode condCode,
+      void *slowCall,
+      const char *slowCallName);
+
+  void throwIfEmptyUndefinedImpl(FR frRes, FR frInput, bool empty);
+
+  void getArgumentsPropByValImpl(
+      FR frRes,
+      FR frIndex,
+      FR frLazyReg,
+      const char *name,
+      SHLegacyValue (*shImpl)(
+          SHRuntime *shr,
+          SHLegacyValue *frame,
+          SHLegacyValue *idx,
+          SHLegacyValue *lazyReg),
+      const char *shImplName);
+  void reifyArgumentsImpl(FR frLazyReg, bool strict, const char *name);
+
+  /// Load the closure of builtin \p builtinIndex as an object HermesValue into
+  /// \p dest. Clobbers \p tmp.
+  void loadBuiltinClosure(
+      const x86::Gp &dest,
+      const x86::Gp &tmp,
+      uint32_t builtinIndex);
+
+  /// Load the address of the private name cache entry \p cacheIdx into \p
+  /// dest, or null if caching is disabled.
+  void loadPrivateNameCacheEntry(const x86::Gp &dest, uint8_t cacheIdx);
+
+  /// Return the offset in RO DATA of the debug name of the function.
+  int32_t getDebugFunctionName();
+
+  /// Size of the stack area below the saved registers, keeping sp 16-byte
+  /// aligned.
+  uint32_t getStackSize() const;
+  /// Offset of the SHJmpBuf from sp.
+  static constexpr uint32_t getJmpBufOffset() {
+    return 0;
+  }
+  /// Offset of the saved SHLocals * from sp.
+  static constexpr uint32_t getSavedSHLocalsOffset() {
+    return (sizeof(SHJmpBuf) + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+  }
+
+  int32_t reserveData(
+      int32_t dsize,
+      size_t align,
+      asmjit::TypeId typeId,
+      int32_t itemCount,
+      const char *comment = nullptr);
+
+  /// Register a 64-bit constant in RO DATA and return its offset.
+  int32_t uint64Const(uint64_t bits, const char *comment);
+
+  /// Create an x86::Mem to a 64-bit constant in RO DATA.
+  x86::Mem constMem(uint64_t bits, const char *comment) {
+    return x86::qword_ptr(roDataLabel_, uint64Const(bits, comment));
+  }
+
+  asmjit::Label newSlowPathLabel() {
+    return a.newLabel();
+  }
+  asmjit::Label newContLabel() {
+    return a.newLabel();
+  }
+
+  /// Emit the part of the prologue shared by the function entry and the
+  /// on-stack replacement entries: push the callee-saved registers, allocate
+  /// the native stack frame, initialize xRuntime and xBytecode and check for
+  /// native stack overflow.
+  void emitNativePrologue();
+
+  /// Emit _sh_try if the function has a catch table.
+  void emitTry();
+
+  /// Emit the entry points requested by addOSREntry().
+  void emitOSREntries();
+
+  void emitCatchTable(llvh::ArrayRef<const asmjit::Label *> exceptionHandlers);
+  void emitSlowPaths();
+  void emitROData();
+}; // class Emitter
+
+} // namespace hermes::vm::x86_64
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "RegExpJIT.h"
+
+#include "hermes/Support/SerialExecutor.h"
+#include "hermes/VM/SymbolID.h"
+
+#include "llvh/ADT/DenseMap.h"
+#include "llvh/ADT/StringMap.h"
+
+#include "asmjit/x86.h"
+
+#include <mutex>
+
+namespace hermes::vm {
+class Domain;
+}
+
+namespace hermes::vm::x86_64 {
+
+/// Map from the string IDs used by a CodeBlock to their SymbolIDs.
+using SymbolMap = llvh::DenseMap<uint32_t, SymbolID>;
+
+/// The outcome of compiling a single CodeBlock.
+struct JITContext::CompileResult {
+  /// The native code, nullptr if compilation failed.
+  JITCompiledFunctionPtr fn = nullptr;
+  /// The CodeBlock cannot be compiled and should not be tried again.
+  bool dontJIT = false;
+  /// The memory limit has been reached and the JIT should be disabled.
+  bool disableJIT = false;
+  /// The on-stack replacement entry points of fn, sorted by bytecode offset.
+  std::vector<JITOSREntry> osrEntries{};
+
+  /// The native target of a case of a StringSwitchImm in fn.
+  struct StringSwitchTarget {
+    /// The index of the switch table in the RuntimeModule.
+    uint32_t tableIndex;
+    /// The string ID of the case label.
+    uint32_t caseLabelStringID;
+    /// The address of the code of the case.
+    void *target;
+  };
+  /// The targets to record in the string switch tables when fn is installed,
+  /// since looking up the case strings may allocate.
+  std::vector<StringSwitchTarget> stringSwitchTargets{};
+};
+
+class JITContext::Impl {
+ public:
+  asmjit::JitRuntime jr{};
+
+  /// A CodeBlock handed to the background compiler.
+  struct CompileJob {
+    CodeBlock *codeBlock;
+    /// The symbols of the string operands, resolved on the mutator thread,
+    /// since resolving them may allocate.
+    SymbolMap symbols{};
+    std::chrono::steady_clock::time_point queuedAt{};
+    std::chrono::steady_clock::time_point startedAt{};
+    std::chrono::steady_clock::time_point finishedAt{};
+    CompileResult result{};
+  };
+
+  /// The background compiler thread, only created when background compilation
+  /// is enabled. It is the only user of jr while it exists.
+  std::unique_ptr<SerialExecutor> executor{};
+
+  /// Protects the fields below that are shared with the background thread.
+  std::mutex mutex{};
+  /// Compilations that have finished and wait to be installed by the mutator.
+  std::vector<std::unique_ptr<CompileJob>> finished{};
+  /// Set to skip the compilations that are still queued.
+  bool cancelled = false;
+
+  /// Mutator only: compiles and owns the native regexp matchers.
+  RegExpJIT regExpJIT{};
+
+  /// The state of a regex bytecode seen by getNativeRegExp().
+  struct RegExpProfile {
+    /// Number of interpreted searches so far.
+    uint32_t searches = 0;
+    /// Whether the bytecode can't be compiled, so it is no longer counted.
+    bool dontCompile = false;
+    /// The compiled matchers, once the bytecode is hot.
+    const SHNativeRegExp *native = nullptr;
+  };
+
+  /// Mutator only: the profiles of the searched regexps, keyed by their
+  /// bytecode.
+  llvh::StringMap<RegExpProfile> regExpProfiles{};
+
+  /// Mutator only: the queued CodeBlocks that have not been installed yet,
+  /// with the Domain owning their RuntimeModule. The Domains are marked as
+  /// roots, so the CodeBlocks stay alive while they are being compiled.
+  std::vector<std::pair<CodeBlock *, Domain *>> inFlight{};
+};
+
+}; // namespace hermes::vm::x86_64
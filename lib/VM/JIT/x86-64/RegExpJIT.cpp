@@ -0,0 +1,1122 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JIT/Config.h"
+#if HERMESVM_JIT
+#include "RegExpJIT.h"
+
+#include "hermes/Regex/RegexBytecode.h"
+#include "hermes/Regex/RegexTypes.h"
+
+#include "llvh/ADT/DenseMap.h"
+#include "llvh/ADT/SetVector.h"
+#include "llvh/Support/Debug.h"
+#include "llvh/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#define DEBUG_TYPE "jit"
+
+namespace hermes::vm::x86_64 {
+
+namespace x86 = asmjit::x86;
+using namespace hermes::regex;
+
+namespace {
+
+/// Regexps with more bytecode than this are left to the interpreter, to bound
+/// the size of the generated code.
+constexpr size_t kMaxBytecodeSize = 16 * 1024;
+
+/// Regexps with more loops than this are left to the interpreter, since the
+/// loop state lives in the native stack frame.
+constexpr uint32_t kMaxLoops = 256;
+
+/// \return the width of \p insn, including any data following it.
+uint32_t insnWidth(const Insn *insn) {
+  switch (insn->opcode) {
+    case Opcode::Bracket:
+    case Opcode::BracketICase:
+    case Opcode::U16Bracket:
+    case Opcode::U16BracketICase:
+      return static_cast<const BracketInsn *>(insn)->totalWidth();
+    case Opcode::MatchNChar8:
+      return static_cast<const MatchNChar8Insn *>(insn)->totalWidth();
+    case Opcode::MatchNCharICase8:
+      return static_cast<const MatchNCharICase8Insn *>(insn)->totalWidth();
+    default:
+      break;
+  }
+  switch (insn->opcode) {
+#define REOP(Code)   \
+  case Opcode::Code: \
+    return sizeof(Code##Insn);
+#include "hermes/Regex/RegexOpcodes.def"
+  }
+  llvm_unreachable("invalid regex opcode");
+}
+
+/// \return true if \p opcode can be the body of a compiled width 1 loop.
+bool isSupportedWidth1(Opcode opcode) {
+  switch (opcode) {
+    case Opcode::MatchAny:
+    case Opcode::MatchAnyButNewline:
+    case Opcode::MatchChar8:
+    case Opcode::MatchChar16:
+    case Opcode::Bracket:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// Make room for one more backtracking entry in \p st, called by the
+/// generated code when the stack is full.
+/// \return false if the stack can't grow any more.
+bool growStack(SHRegExpStack *st) {
+  return _sh_regexp_stack_grow(st);
+}
+
+/// Release the heap allocated entries of \p st, if any.
+void freeStack(SHRegExpStack *st) {
+  _sh_regexp_stack_free(st);
+}
+
+/// Records the first error reported by asmjit, so that a failed compilation
+/// falls back to the interpreter.
+class RecordingErrorHandler : public asmjit::ErrorHandler {
+ public:
+  asmjit::Error error = asmjit::kErrorOk;
+
+  void handleError(
+      asmjit::Error err,
+      const char *message,
+      asmjit::BaseEmitter *origin) override {
+    LLVM_DEBUG(
+        llvh::dbgs() << "RegExp AsmJit error: " << err << ": " << message
+                     << "\n");
+    if (error == asmjit::kErrorOk)
+      error = err;
+  }
+};
+
+/// Generates the search function for one input width, following the same
+/// structure as the C emitted by the SH backend.
+///
+/// The generated function keeps its state in callee-saved registers:
+///   rbx: input, ebp: matchStart, r12d: pos, r13d: length, r14: captures.
+/// The backtracking stack, the flags, the loop state and a few temporaries
+/// live in the stack frame. Everything else is scratch, and is assumed to be
+/// clobbered by the helper calls made when pushing.
+class MatcherGen {
+ public:
+  MatcherGen(
+      x86::Assembler &a,
+      llvh::ArrayRef<uint8_t> bytecode,
+      bool wide)
+      : a(a),
+        header_(reinterpret_cast<const RegexBytecodeHeader *>(bytecode.data())),
+        insns_(bytecode.drop_front(sizeof(RegexBytecodeHeader))),
+        wide_(wide) {}
+
+  /// Emit the function, starting at \p entry.
+  void generate(const asmjit::Label &entry);
+
+ private:
+  /// Kinds of backtracking entries, in the same order as the SH_REGEXP_BT_
+  /// constants.
+  enum BacktrackKind {
+    SetCapture = SH_REGEXP_BT_SET_CAPTURE,
+    SetLoop = SH_REGEXP_BT_SET_LOOP,
+    SetPosition = SH_REGEXP_BT_SET_POSITION,
+    GreedyWidth1 = SH_REGEXP_BT_GREEDY_WIDTH1,
+    NongreedyWidth1 = SH_REGEXP_BT_NONGREEDY_WIDTH1,
+    EnterLoop = SH_REGEXP_BT_ENTER_LOOP,
+    NumKinds,
+  };
+
+  static constexpr x86::Gp xInput = x86::rbx;
+  static constexpr x86::Gp wMatchStart = x86::ebp;
+  static constexpr x86::Gp wPos = x86::r12d;
+  static constexpr x86::Gp xPos = x86::r12;
+  static constexpr x86::Gp wLength = x86::r13d;
+  static constexpr x86::Gp xCaps = x86::r14;
+
+  /// Offsets of the locals from rsp.
+  static constexpr int32_t kStackOfs = 0;
+  static constexpr int32_t kFlagsOfs = sizeof(SHRegExpStack);
+  static constexpr int32_t kOnlyAtStartOfs = kFlagsOfs + 4;
+  static constexpr int32_t kResultOfs = kOnlyAtStartOfs + 4;
+  static constexpr int32_t kTmp0Ofs = kResultOfs + 4;
+  static constexpr int32_t kTmp1Ofs = kTmp0Ofs + 4;
+  static constexpr int32_t kLoopsOfs = kTmp1Ofs + 4;
+
+  static x86::Mem stackField(size_t ofs, uint32_t size = 4) {
+    return x86::ptr(x86::rsp, kStackOfs + (int32_t)ofs, size);
+  }
+  static x86::Mem local(int32_t ofs) {
+    return x86::dword_ptr(x86::rsp, ofs);
+  }
+  static x86::Mem loopSlot(uint32_t index) {
+    return x86::dword_ptr(x86::rsp, kLoopsOfs + 4 * (int32_t)index);
+  }
+  static x86::Mem capSlot(uint32_t index) {
+    return x86::dword_ptr(xCaps, 4 * (int32_t)index);
+  }
+
+  /// \return the character of the input at index \p index + \p disp.
+  x86::Mem inputAt(const x86::Gp &index, int32_t disp = 0) const {
+    return wide_ ? x86::word_ptr(xInput, index, 1, 2 * disp)
+                 : x86::byte_ptr(xInput, index, 0, disp);
+  }
+
+  const Insn *insnAt(uint32_t offset) const {
+    return reinterpret_cast<const Insn *>(&insns_[offset]);
+  }
+
+  /// \return the label of the instruction at \p offset.
+  asmjit::Label label(uint32_t offset) {
+    auto [it, inserted] = labels_.try_emplace(offset);
+    if (inserted)
+      it->second = a.newLabel();
+    return it->second;
+  }
+
+  /// \return the label of the loop test of the loop starting at \p offset.
+  asmjit::Label runLabel(uint32_t offset) {
+    auto [it, inserted] = runLabels_.try_emplace(offset);
+    if (inserted)
+      it->second = a.newLabel();
+    return it->second;
+  }
+
+  /// \return the label entering the body of the loop starting at \p offset.
+  asmjit::Label enterLabel(uint32_t offset) {
+    auto [it, inserted] = enterLabels_.try_emplace(offset);
+    if (inserted)
+      it->second = a.newLabel();
+    return it->second;
+  }
+
+  /// Add \p offset to \p set if needed. \return its index in \p set, which
+  /// is the value stored in backtracking entries resuming at \p offset.
+  static uint32_t indexOf(llvh::SetVector<uint32_t> &set, uint32_t offset) {
+    set.insert(offset);
+    return std::find(set.begin(), set.end(), offset) - set.begin();
+  }
+
+  /// An operand of a backtracking entry: an immediate, a 32-bit register, or
+  /// a 32-bit memory location that is still valid after a call.
+  using Value = asmjit::Operand;
+
+  /// Load \p value into \p dest.
+  void movValue(const x86::Gp &dest, const Value &value) {
+    if (value.isImm())
+      a.mov(dest, value.as<asmjit::Imm>());
+    else if (value.isReg())
+      a.mov(dest, value.as<x86::Gp>());
+    else
+      a.mov(dest, value.as<x86::Mem>());
+  }
+
+  void emitPush(BacktrackKind kind, Value va, Value vb, Value vc);
+
+  void emitJumpIfUnsatisfied(
+      MatchConstraintSet constraints,
+      const asmjit::Label &target);
+  void emitJumpIfLineTerminator(const x86::Gp &ch, const asmjit::Label &hit);
+  void emitJumpIfWord(const x86::Gp &ch, const asmjit::Label &hit);
+  void emitJumpIfClass(
+      CharacterClass::Type type,
+      const x86::Gp &ch,
+      const asmjit::Label &hit);
+  void emitCharTest(
+      const Insn *insn,
+      const x86::Gp &ch,
+      const asmjit::Label &fail);
+  void emitWidth1(const Insn *insn);
+
+  void emitInsn(uint32_t offset, uint32_t nextOffset);
+  void emitBacktrack();
+
+  x86::Assembler &a;
+  const RegexBytecodeHeader *header_;
+  llvh::ArrayRef<uint8_t> insns_;
+  /// Whether the input is UTF-16 rather than ASCII.
+  bool wide_;
+
+  asmjit::Label backtrackLabel_{};
+  asmjit::Label bailLabel_{};
+  asmjit::Label doneLabel_{};
+  asmjit::Label resumeLabel_{};
+  asmjit::Label enterLoopLabel_{};
+
+  llvh::DenseMap<uint32_t, asmjit::Label> labels_{};
+  llvh::DenseMap<uint32_t, asmjit::Label> runLabels_{};
+  llvh::DenseMap<uint32_t, asmjit::Label> enterLabels_{};
+
+  /// Kinds of backtracking entries that are pushed.
+  bool usedKinds_[NumKinds]{};
+  /// Offsets where matching resumes after popping a SetPosition or width 1
+  /// loop entry, indexed by the value stored in the entry.
+  llvh::SetVector<uint32_t> resumeTargets_{};
+  /// Offsets of BeginLoop instructions of non-greedy loops, which are entered
+  /// on backtracking, indexed by the value stored in the entry.
+  llvh::SetVector<uint32_t> enterLoops_{};
+};
+
+void MatcherGen::emitPush(BacktrackKind kind, Value va, Value vb, Value vc) {
+  usedKinds_[kind] = true;
+  asmjit::Label room = a.newLabel();
+  a.mov(x86::ecx, stackField(offsetof(SHRegExpStack, size)));
+  a.cmp(x86::ecx, stackField(offsetof(SHRegExpStack, capacity)));
+  a.jne(room);
+  a.lea(x86::rdi, stackField(0));
+  a.mov(x86::rax, (uint64_t)growStack);
+  a.call(x86::rax);
+  a.test(x86::al, x86::al);
+  a.jz(bailLabel_);
+  a.mov(x86::ecx, stackField(offsetof(SHRegExpStack, size)));
+  a.bind(room);
+  // Give up once the budget is exhausted: subtracting from 0 borrows.
+  a.sub(stackField(offsetof(SHRegExpStack, pushes_left)), 1);
+  a.jb(bailLabel_);
+  a.lea(x86::edx, x86::ptr(x86::rcx, 1));
+  a.mov(stackField(offsetof(SHRegExpStack, size)), x86::edx);
+  a.shl(x86::rcx, 4);
+  a.add(x86::rcx, stackField(offsetof(SHRegExpStack, entries), 8));
+  static_assert(sizeof(SHRegExpBacktrack) == 16, "entries are 16 bytes");
+  a.mov(x86::dword_ptr(x86::rcx, offsetof(SHRegExpBacktrack, kind)), kind);
+  movValue(x86::edx, va);
+  a.mov(x86::dword_ptr(x86::rcx, offsetof(SHRegExpBacktrack, a)), x86::edx);
+  movValue(x86::edx, vb);
+  a.mov(x86::dword_ptr(x86::rcx, offsetof(SHRegExpBacktrack, b)), x86::edx);
+  movValue(x86::edx, vc);
+  a.mov(x86::dword_ptr(x86::rcx, offsetof(SHRegExpBacktrack, c)), x86::edx);
+}
+
+/// Jump to \p target unless the current position satisfies \p constraints,
+/// mirroring Cursor::satisfiesConstraints.
+void MatcherGen::emitJumpIfUnsatisfied(
+    MatchConstraintSet constraints,
+    const asmjit::Label &target) {
+  if (constraints & MatchConstraintNonASCII) {
+    a.test(local(kFlagsOfs), SH_REGEXP_INPUT_ALL_ASCII);
+    a.jnz(target);
+  }
+  if (constraints & MatchConstraintAnchoredAtStart) {
+    a.test(wPos, wPos);
+    a.jnz(target);
+  }
+}
+
+void MatcherGen::emitJumpIfLineTerminator(
+    const x86::Gp &ch,
+    const asmjit::Label &hit) {
+  a.cmp(ch, 0x0A);
+  a.je(hit);
+  a.cmp(ch, 0x0D);
+  a.je(hit);
+  if (wide_) {
+    a.lea(x86::ecx, x86::ptr(ch.r64(), -0x2028));
+    a.cmp(x86::ecx, 1);
+    a.jbe(hit);
+  }
+}
+
+void MatcherGen::emitJumpIfWord(const x86::Gp &ch, const asmjit::Label &hit) {
+  a.lea(x86::ecx, x86::ptr(ch.r64(), -'0'));
+  a.cmp(x86::ecx, 9);
+  a.jbe(hit);
+  a.mov(x86::ecx, ch);
+  a.or_(x86::ecx, 0x20);
+  a.sub(x86::ecx, 'a');
+  a.cmp(x86::ecx, 25);
+  a.jbe(hit);
+  a.cmp(ch, '_');
+  a.je(hit);
+}
+
+void MatcherGen::emitJumpIfClass(
+    CharacterClass::Type type,
+    const x86::Gp &ch,
+    const asmjit::Label &hit) {
+  switch (type) {
+    case CharacterClass::Digits:
+      a.lea(x86::ecx, x86::ptr(ch.r64(), -'0'));
+      a.cmp(x86::ecx, 9);
+      a.jbe(hit);
+      return;
+    case CharacterClass::Words:
+      emitJumpIfWord(ch, hit);
+      return;
+    case CharacterClass::Spaces:
+      a.cmp(ch, 0x20);
+      a.je(hit);
+      a.lea(x86::ecx, x86::ptr(ch.r64(), -0x09));
+      a.cmp(x86::ecx, 0x0D - 0x09);
+      a.jbe(hit);
+      if (wide_) {
+        for (uint32_t c : {0xA0u, 0x1680u, 0x202Fu, 0x205Fu, 0x3000u, 0xFEFFu}) {
+          a.cmp(ch, c);
+          a.je(hit);
+        }
+        a.lea(x86::ecx, x86::ptr(ch.r64(), -0x2000));
+        a.cmp(x86::ecx, 0x200A - 0x2000);
+        a.jbe(hit);
+        a.lea(x86::ecx, x86::ptr(ch.r64(), -0x2028));
+        a.cmp(x86::ecx, 1);
+        a.jbe(hit);
+      }
+      return;
+  }
+  llvm_unreachable("invalid character class");
+}
+
+/// Emit a test of the character \p ch against the width 1 instruction
+/// \p insn, jumping to \p fail if it doesn't match. Clobbers ecx.
+void MatcherGen::emitCharTest(
+    const Insn *insn,
+    const x86::Gp &ch,
+    const asmjit::Label &fail) {
+  switch (insn->opcode) {
+    case Opcode::MatchAny:
+      return;
+    case Opcode::MatchAnyButNewline:
+      emitJumpIfLineTerminator(ch, fail);
+      return;
+    case Opcode::MatchChar8:
+      a.cmp(ch, (uint8_t) static_cast<const MatchChar8Insn *>(insn)->c);
+      a.jne(fail);
+      return;
+    case Opcode::MatchChar16: {
+      char16_t c = static_cast<const MatchChar16Insn *>(insn)->c;
+      if (!wide_ && c > 0xFF) {
+        a.jmp(fail);
+        return;
+      }
+      a.cmp(ch, c);
+      a.jne(fail);
+      return;
+    }
+    case Opcode::Bracket:
+      break;
+    default:
+      llvm_unreachable("unsupported width 1 instruction");
+  }
+
+  // Mirror bracketMatchesChar: a character matches if it is in any of the
+  // classes or ranges, and the result is inverted for negated brackets.
+  const auto *bracket = static_cast<const BracketInsn *>(insn);
+  asmjit::Label inSet = a.newLabel();
+  for (auto type :
+       {CharacterClass::Digits,
+        CharacterClass::Spaces,
+        CharacterClass::Words}) {
+    if (bracket->positiveCharClasses & type)
+      emitJumpIfClass(type, ch, inSet);
+    if (bracket->negativeCharClasses & type) {
+      asmjit::Label inClass = a.newLabel();
+      emitJumpIfClass(type, ch, inClass);
+      a.jmp(inSet);
+      a.bind(inClass);
+    }
+  }
+  auto *ranges = reinterpret_cast<const BracketRange32 *>(bracket + 1);
+  for (uint32_t i = 0; i < bracket->rangeCount; ++i) {
+    BracketRange32 range;
+    memcpy(&range, &ranges[i], sizeof(range));
+    // Characters of ASCII inputs are at most 0xFF.
+    if (!wide_ && range.start > 0xFF)
+      continue;
+    if (range.start == range.end) {
+      a.cmp(ch, range.start);
+      a.je(inSet);
+    } else {
+      a.lea(x86::ecx, x86::ptr(ch.r64(), -(int32_t)range.start));
+      a.cmp(x86::ecx, range.end - range.start);
+      a.jbe(inSet);
+    }
+  }
+  if (bracket->negate) {
+    asmjit::Label matched = a.newLabel();
+    a.jmp(matched);
+    a.bind(inSet);
+    a.jmp(fail);
+    a.bind(matched);
+  } else {
+    a.jmp(fail);
+    a.bind(inSet);
+  }
+}
+
+/// Emit a check that one character matches \p insn, advancing past it.
+void MatcherGen::emitWidth1(const Insn *insn) {
+  a.cmp(wPos, wLength);
+  a.je(backtrackLabel_);
+  a.movzx(x86::eax, inputAt(xPos));
+  emitCharTest(insn, x86::eax, backtrackLabel_);
+  a.inc(wPos);
+}
+
+void MatcherGen::generate(const asmjit::Label &entry) {
+  backtrackLabel_ = a.newLabel();
+  bailLabel_ = a.newLabel();
+  doneLabel_ = a.newLabel();
+  resumeLabel_ = a.newLabel();
+  enterLoopLabel_ = a.newLabel();
+
+  uint32_t numCaptures = 2 * (header_->markedCount + 1u);
+  MatchConstraintSet constraints = header_->constraints;
+
+  a.align(asmjit::AlignMode::kCode, 16);
+  a.bind(entry);
+  // Check for match impossibility before doing anything else.
+  asmjit::Label noMatch = a.newLabel();
+  if (constraints & MatchConstraintNonASCII) {
+    a.test(x86::ecx, SH_REGEXP_INPUT_ALL_ASCII);
+    a.jnz(noMatch);
+  }
+  if (constraints & MatchConstraintAnchoredAtStart) {
+    a.test(x86::esi, x86::esi);
+    a.jnz(noMatch);
+  }
+
+  // The five pushes and the return address keep rsp aligned to 16 bytes for
+  // the calls, as long as the frame size is a multiple of 16.
+  int32_t frameSize = (kLoopsOfs + 8 * header_->loopCount + 15) & ~15;
+  for (const auto &reg : {x86::rbp, x86::rbx, x86::r12, x86::r13, x86::r14})
+    a.push(reg);
+  a.sub(x86::rsp, frameSize);
+
+  a.mov(xInput, x86::rdi);
+  a.mov(wMatchStart, x86::esi);
+  a.mov(wLength, x86::edx);
+  a.mov(xCaps, x86::r8);
+  a.mov(local(kFlagsOfs), x86::ecx);
+  if (constraints & MatchConstraintAnchoredAtStart) {
+    a.mov(local(kOnlyAtStartOfs), 1);
+  } else {
+    a.and_(x86::ecx, SH_REGEXP_ONLY_AT_START);
+    a.mov(local(kOnlyAtStartOfs), x86::ecx);
+  }
+  a.mov(local(kResultOfs), 0);
+  a.lea(x86::rax, stackField(offsetof(SHRegExpStack, inline_entries)));
+  a.mov(stackField(offsetof(SHRegExpStack, entries), 8), x86::rax);
+  a.mov(stackField(offsetof(SHRegExpStack, size)), 0);
+  a.mov(
+      stackField(offsetof(SHRegExpStack, capacity)),
+      SH_REGEXP_INLINE_BACKTRACKS);
+  a.mov(
+      stackField(offsetof(SHRegExpStack, pushes_left)),
+      SH_REGEXP_BACKTRACK_LIMIT);
+
+  asmjit::Label nextStart = a.newLabel();
+  a.bind(nextStart);
+  if (numCaptures > 2) {
+    asmjit::Label clear = a.newLabel();
+    a.mov(x86::eax, 2);
+    a.bind(clear);
+    a.mov(x86::dword_ptr(xCaps, x86::rax, 2), SH_REGEXP_NOT_MATCHED);
+    a.inc(x86::eax);
+    a.cmp(x86::eax, numCaptures);
+    a.jne(clear);
+  }
+  a.mov(wPos, wMatchStart);
+  a.mov(stackField(offsetof(SHRegExpStack, size)), 0);
+
+  for (uint32_t offset = 0; offset < insns_.size();) {
+    const Insn *insn = insnAt(offset);
+    uint32_t width = insnWidth(insn);
+    // The body of a width 1 loop is generated inline with the loop.
+    if (insn->opcode == Opcode::Width1Loop)
+      width += insnWidth(insnAt(offset + width));
+    emitInsn(offset, offset + width);
+    offset += width;
+  }
+
+  emitBacktrack();
+  a.cmp(local(kOnlyAtStartOfs), 0);
+  a.jne(doneLabel_);
+  a.cmp(wMatchStart, wLength);
+  a.jae(doneLabel_);
+  a.inc(wMatchStart);
+  a.jmp(nextStart);
+
+  a.bind(bailLabel_);
+  a.mov(capSlot(0), wMatchStart);
+  a.mov(local(kResultOfs), -1);
+
+  a.bind(doneLabel_);
+  a.lea(x86::rdi, stackField(0));
+  a.mov(x86::rax, (uint64_t)freeStack);
+  a.call(x86::rax);
+  a.mov(x86::eax, local(kResultOfs));
+  a.add(x86::rsp, frameSize);
+  for (const auto &reg : {x86::r14, x86::r13, x86::r12, x86::rbx, x86::rbp})
+    a.pop(reg);
+  a.ret();
+
+  a.bind(noMatch);
+  a.xor_(x86::eax, x86::eax);
+  a.ret();
+
+  // Jump tables from the indices stored in backtracking entries to the code
+  // that resumes matching.
+  if (!resumeTargets_.empty()) {
+    asmjit::Label table = a.newLabel();
+    a.bind(resumeLabel_);
+    a.lea(x86::rdx, x86::ptr(table));
+    a.movsxd(x86::rax, x86::dword_ptr(x86::rdx, x86::rcx, 2));
+    a.add(x86::rax, x86::rdx);
+    a.jmp(x86::rax);
+    a.align(asmjit::AlignMode::kData, 4);
+    a.bind(table);
+    for (uint32_t target : resumeTargets_)
+      a.embedLabelDelta(label(target), table, /* size */ 4);
+  }
+  if (!enterLoops_.empty()) {
+    // Each non-greedy loop restores its own state before entering the body.
+    llvh::SmallVector<asmjit::Label, 4> stubs;
+    for (uint32_t offset : enterLoops_) {
+      uint32_t loopId =
+          static_cast<const BeginLoopInsn *>(insnAt(offset))->loopId;
+      stubs.push_back(a.newLabel());
+      a.bind(stubs.back());
+      a.mov(loopSlot(2 * loopId), x86::edi);
+      a.mov(loopSlot(2 * loopId + 1), wPos);
+      a.jmp(enterLabel(offset));
+    }
+    asmjit::Label table = a.newLabel();
+    a.bind(enterLoopLabel_);
+    a.lea(x86::rdx, x86::ptr(table));
+    a.movsxd(x86::rax, x86::dword_ptr(x86::rdx, x86::rcx, 2));
+    a.add(x86::rax, x86::rdx);
+    a.jmp(x86::rax);
+    a.align(asmjit::AlignMode::kData, 4);
+    a.bind(table);
+    for (const auto &stub : stubs)
+      a.embedLabelDelta(stub, table, /* size */ 4);
+  }
+}
+
+void MatcherGen::emitInsn(uint32_t offset, uint32_t nextOffset) {
+  const Insn *base = insnAt(offset);
+  a.bind(label(offset));
+  switch (base->opcode) {
+    case Opcode::Goal:
+      a.mov(capSlot(0), wMatchStart);
+      a.mov(capSlot(1), wPos);
+      a.mov(local(kResultOfs), 1);
+      a.jmp(doneLabel_);
+      return;
+
+    case Opcode::LeftAnchor:
+      a.test(wPos, wPos);
+      a.jnz(backtrackLabel_);
+      return;
+
+    case Opcode::LeftAnchorMultiline: {
+      asmjit::Label ok = a.newLabel();
+      a.test(wPos, wPos);
+      a.jz(ok);
+      a.movzx(x86::eax, inputAt(xPos, -1));
+      emitJumpIfLineTerminator(x86::eax, ok);
+      a.jmp(backtrackLabel_);
+      a.bind(ok);
+      return;
+    }
+
+    case Opcode::RightAnchor:
+      a.cmp(wPos, wLength);
+      a.jne(backtrackLabel_);
+      a.test(local(kFlagsOfs), SH_REGEXP_NOT_END_OF_LINE);
+      a.jnz(backtrackLabel_);
+      return;
+
+    case Opcode::RightAnchorMultiline: {
+      asmjit::Label ok = a.newLabel(), notEnd = a.newLabel();
+      a.cmp(wPos, wLength);
+      a.jne(notEnd);
+      a.test(local(kFlagsOfs), SH_REGEXP_NOT_END_OF_LINE);
+      a.jnz(backtrackLabel_);
+      a.jmp(ok);
+      a.bind(notEnd);
+      a.movzx(x86::eax, inputAt(xPos));
+      emitJumpIfLineTerminator(x86::eax, ok);
+      a.jmp(backtrackLabel_);
+      a.bind(ok);
+      return;
+    }
+
+    case Opcode::MatchAny:
+    case Opcode::MatchAnyButNewline:
+    case Opcode::MatchChar8:
+    case Opcode::MatchChar16:
+    case Opcode::Bracket:
+      emitWidth1(base);
+      return;
+
+    case Opcode::MatchNChar8: {
+      const auto *insn = static_cast<const MatchNChar8Insn *>(base);
+      auto *chars = reinterpret_cast<const uint8_t *>(insn + 1);
+      a.mov(x86::eax, wLength);
+      a.sub(x86::eax, wPos);
+      a.cmp(x86::eax, insn->charCount);
+      a.jb(backtrackLabel_);
+      for (unsigned i = 0; i < insn->charCount; ++i) {
+        a.movzx(x86::eax, inputAt(xPos, i));
+        a.cmp(x86::eax, chars[i]);
+        a.jne(backtrackLabel_);
+      }
+      a.add(wPos, insn->charCount);
+      return;
+    }
+
+    case Opcode::Alternation: {
+      // Explore the primary branch first if both are viable, backtracking to
+      // the secondary one.
+      const auto *insn = static_cast<const AlternationInsn *>(base);
+      uint32_t secondary = insn->secondaryBranch;
+      asmjit::Label noPrimary = a.newLabel(), next = a.newLabel();
+      emitJumpIfUnsatisfied(insn->primaryConstraints, noPrimary);
+      emitJumpIfUnsatisfied(insn->secondaryConstraints, next);
+      emitPush(
+          SetPosition, asmjit::imm(indexOf(resumeTargets_, secondary)), wPos,
+          asmjit::imm(0));
+      a.jmp(next);
+      a.bind(noPrimary);
+      emitJumpIfUnsatisfied(insn->secondaryConstraints, backtrackLabel_);
+      a.jmp(label(secondary));
+      a.bind(next);
+      return;
+    }
+
+    case Opcode::Jump32:
+      a.jmp(label(static_cast<const Jump32Insn *>(base)->target));
+      return;
+
+    case Opcode::BeginMarkedSubexpression: {
+      const auto *insn =
+          static_cast<const BeginMarkedSubexpressionInsn *>(base);
+      uint32_t cap = 2u + 2u * insn->mexp;
+      emitPush(
+          SetCapture,
+          asmjit::imm(cap),
+          asmjit::imm(SH_REGEXP_NOT_MATCHED),
+          asmjit::imm(SH_REGEXP_NOT_MATCHED));
+      a.mov(capSlot(cap), wPos);
+      return;
+    }
+
+    case Opcode::EndMarkedSubexpression: {
+      const auto *insn = static_cast<const EndMarkedSubexpressionInsn *>(base);
+      a.mov(capSlot(2u + 2u * insn->mexp + 1), wPos);
+      return;
+    }
+
+    case Opcode::BackRef: {
+      // Backreferences to a group that has not matched always succeed.
+      uint32_t cap = 2u + 2u * static_cast<const BackRefInsn *>(base)->mexp;
+      asmjit::Label skip = a.newLabel(), loop = a.newLabel(),
+                    equal = a.newLabel();
+      a.mov(x86::eax, capSlot(cap));
+      a.cmp(x86::eax, SH_REGEXP_NOT_MATCHED);
+      a.je(skip);
+      a.mov(x86::ecx, capSlot(cap + 1));
+      a.cmp(x86::ecx, SH_REGEXP_NOT_MATCHED);
+      a.je(skip);
+      a.sub(x86::ecx, x86::eax);
+      a.mov(x86::edx, wLength);
+      a.sub(x86::edx, wPos);
+      a.cmp(x86::edx, x86::ecx);
+      a.jb(backtrackLabel_);
+      // Compare the ecx characters at eax and pos.
+      a.xor_(x86::edx, x86::edx);
+      a.bind(loop);
+      a.cmp(x86::edx, x86::ecx);
+      a.je(equal);
+      a.lea(x86::esi, x86::ptr(x86::rax, x86::rdx));
+      a.movzx(x86::edi, inputAt(x86::rsi));
+      a.lea(x86::esi, x86::ptr(xPos, x86::rdx));
+      a.movzx(x86::esi, inputAt(x86::rsi));
+      a.cmp(x86::edi, x86::esi);
+      a.jne(backtrackLabel_);
+      a.inc(x86::edx);
+      a.jmp(loop);
+      a.bind(equal);
+      a.add(wPos, x86::ecx);
+      a.bind(skip);
+      return;
+    }
+
+    case Opcode::WordBoundary: {
+      const auto *insn = static_cast<const WordBoundaryInsn *>(base);
+      asmjit::Label before = a.newLabel(), beforeDone = a.newLabel(),
+                    after = a.newLabel(), afterDone = a.newLabel();
+      a.xor_(x86::r8d, x86::r8d);
+      a.test(wPos, wPos);
+      a.jz(beforeDone);
+      a.movzx(x86::eax, inputAt(xPos, -1));
+      emitJumpIfWord(x86::eax, before);
+      a.jmp(beforeDone);
+      a.bind(before);
+      a.mov(x86::r8d, 1);
+      a.bind(beforeDone);
+      a.xor_(x86::r9d, x86::r9d);
+      a.cmp(wPos, wLength);
+      a.je(afterDone);
+      a.movzx(x86::eax, inputAt(xPos));
+      emitJumpIfWord(x86::eax, after);
+      a.jmp(afterDone);
+      a.bind(after);
+      a.mov(x86::r9d, 1);
+      a.bind(afterDone);
+      a.cmp(x86::r8d, x86::r9d);
+      if (insn->invert)
+        a.jne(backtrackLabel_);
+      else
+        a.je(backtrackLabel_);
+      return;
+    }
+
+    case Opcode::BeginSimpleLoop: {
+      // Simple loops are always greedy, and always explore both exiting and
+      // continuing the loop.
+      const auto *insn = static_cast<const BeginSimpleLoopInsn *>(base);
+      uint32_t notTaken = insn->notTakenTarget;
+      emitJumpIfUnsatisfied(insn->loopeeConstraints, label(notTaken));
+      a.bind(runLabel(offset));
+      emitPush(
+          SetPosition, asmjit::imm(indexOf(resumeTargets_, notTaken)), wPos,
+          asmjit::imm(0));
+      return;
+    }
+
+    case Opcode::EndSimpleLoop:
+      a.jmp(runLabel(static_cast<const EndSimpleLoopInsn *>(base)->target));
+      return;
+
+    case Opcode::BeginLoop: {
+      const auto *insn = static_cast<const BeginLoopInsn *>(base);
+      uint32_t notTaken = insn->notTakenTarget;
+      x86::Mem iterations = loopSlot(2 * insn->loopId);
+      x86::Mem entry = loopSlot(2 * insn->loopId + 1);
+      a.mov(iterations, 0);
+      emitJumpIfUnsatisfied(
+          insn->loopeeConstraints,
+          insn->min > 0 ? backtrackLabel_ : label(notTaken));
+      a.bind(runLabel(offset));
+      // Once the minimum number of iterations is reached, iterations that
+      // match the empty string are not considered.
+      asmjit::Label notEmpty = a.newLabel();
+      a.cmp(iterations, (int32_t)insn->min);
+      a.jbe(notEmpty);
+      a.cmp(entry, wPos);
+      a.je(backtrackLabel_);
+      a.bind(notEmpty);
+      if (insn->min > 0) {
+        a.cmp(iterations, (int32_t)insn->min);
+        a.jb(enterLabel(offset));
+      }
+      a.cmp(iterations, (int32_t)insn->max);
+      a.je(label(notTaken));
+      if (insn->greedy) {
+        // Backtrack by exiting the loop.
+        emitPush(
+            SetPosition, asmjit::imm(indexOf(resumeTargets_, notTaken)), wPos,
+            asmjit::imm(0));
+      } else {
+        // Backtrack by entering the loop.
+        a.mov(entry, wPos);
+        emitPush(
+            EnterLoop,
+            asmjit::imm(indexOf(enterLoops_, offset)),
+            iterations,
+            wPos);
+        a.jmp(label(notTaken));
+      }
+      // Enter the loop body, which follows, saving the loop state and
+      // resetting the contained capture groups.
+      a.bind(enterLabel(offset));
+      emitPush(
+          SetLoop, asmjit::imm(2 * insn->loopId), iterations, entry);
+      a.inc(iterations);
+      a.mov(entry, wPos);
+      for (uint32_t mexp = insn->mexpBegin; mexp != insn->mexpEnd; ++mexp) {
+        uint32_t cap = 2 + 2 * mexp;
+        emitPush(SetCapture, asmjit::imm(cap), capSlot(cap), capSlot(cap + 1));
+        a.mov(capSlot(cap), SH_REGEXP_NOT_MATCHED);
+        a.mov(capSlot(cap + 1), SH_REGEXP_NOT_MATCHED);
+      }
+      return;
+    }
+
+    case Opcode::EndLoop:
+      a.jmp(runLabel(static_cast<const EndLoopInsn *>(base)->target));
+      return;
+
+    case Opcode::Width1Loop: {
+      // Match as many characters as possible up to the maximum, then record
+      // the range of possible exit positions for backtracking. The limit is
+      // kept in r9d and the count in r10d.
+      const auto *insn = static_cast<const Width1LoopInsn *>(base);
+      uint32_t notTaken = insn->notTakenTarget;
+      asmjit::Label loop = a.newLabel(), end = a.newLabel(),
+                    noPush = a.newLabel();
+      a.mov(x86::r9d, wLength);
+      a.sub(x86::r9d, wPos);
+      if (insn->max != UINT32_MAX) {
+        asmjit::Label limited = a.newLabel();
+        a.cmp(x86::r9d, (int32_t)insn->max);
+        a.jbe(limited);
+        a.mov(x86::r9d, insn->max);
+        a.bind(limited);
+      }
+      a.xor_(x86::r10d, x86::r10d);
+      a.bind(loop);
+      a.cmp(x86::r10d, x86::r9d);
+      a.je(end);
+      a.lea(x86::esi, x86::ptr(xPos, x86::r10));
+      a.movzx(x86::eax, inputAt(x86::rsi));
+      emitCharTest(insnAt(offset + sizeof(*insn)), x86::eax, end);
+      a.inc(x86::r10d);
+      a.jmp(loop);
+      a.bind(end);
+      if (insn->min > 0) {
+        a.cmp(x86::r10d, (int32_t)insn->min);
+        a.jb(backtrackLabel_);
+      }
+      // The positions survive the call that may be made by the push.
+      a.lea(x86::eax, x86::ptr(xPos, (int32_t)insn->min));
+      a.mov(local(kTmp0Ofs), x86::eax);
+      a.lea(x86::eax, x86::ptr(xPos, x86::r10));
+      a.mov(local(kTmp1Ofs), x86::eax);
+      a.cmp(x86::r10d, (int32_t)insn->min);
+      a.jbe(noPush);
+      emitPush(
+          insn->greedy ? GreedyWidth1 : NongreedyWidth1,
+          asmjit::imm(indexOf(resumeTargets_, notTaken)),
+          local(kTmp0Ofs),
+          local(kTmp1Ofs));
+      a.bind(noPush);
+      a.mov(wPos, local(insn->greedy ? kTmp1Ofs : kTmp0Ofs));
+      if (notTaken != nextOffset)
+        a.jmp(label(notTaken));
+      return;
+    }
+
+    default:
+      llvm_unreachable("unsupported regex instruction");
+  }
+}
+
+void MatcherGen::emitBacktrack() {
+  // Pop backtracking entries until one resumes matching. If there are none
+  // left, fall through to try the next start position. The entry is in rax.
+  a.bind(backtrackLabel_);
+  bool anyKinds = false;
+  for (bool used : usedKinds_)
+    anyKinds |= used;
+  if (!anyKinds)
+    return;
+
+  asmjit::Label empty = a.newLabel(), pop = a.newLabel();
+  llvh::SmallVector<std::pair<BacktrackKind, asmjit::Label>, NumKinds>
+      handlers;
+  for (unsigned kind = 0; kind < NumKinds; ++kind) {
+    if (usedKinds_[kind])
+      handlers.push_back({(BacktrackKind)kind, a.newLabel()});
+  }
+
+  a.mov(x86::ecx, stackField(offsetof(SHRegExpStack, size)));
+  a.test(x86::ecx, x86::ecx);
+  a.jz(empty);
+  a.dec(x86::ecx);
+  a.shl(x86::rcx, 4);
+  a.mov(x86::rax, stackField(offsetof(SHRegExpStack, entries), 8));
+  a.add(x86::rax, x86::rcx);
+  a.mov(x86::edx, x86::dword_ptr(x86::rax, offsetof(SHRegExpBacktrack, kind)));
+  a.mov(x86::ecx, x86::dword_ptr(x86::rax, offsetof(SHRegExpBacktrack, a)));
+  for (const auto &[kind, handler] : handlers) {
+    a.cmp(x86::edx, kind);
+    a.je(handler);
+  }
+  // Unreachable: every pushed kind has a handler.
+  a.ud2();
+
+  auto field = [](size_t ofs) { return x86::dword_ptr(x86::rax, ofs); };
+  const auto b = field(offsetof(SHRegExpBacktrack, b));
+  const auto c = field(offsetof(SHRegExpBacktrack, c));
+  for (const auto &[kind, handler] : handlers) {
+    a.bind(handler);
+    switch (kind) {
+      case SetCapture:
+        a.mov(x86::edx, b);
+        a.mov(x86::dword_ptr(xCaps, x86::rcx, 2), x86::edx);
+        a.mov(x86::edx, c);
+        a.mov(x86::dword_ptr(xCaps, x86::rcx, 2, 4), x86::edx);
+        a.dec(stackField(offsetof(SHRegExpStack, size)));
+        a.jmp(backtrackLabel_);
+        break;
+      case SetLoop:
+        a.mov(x86::edx, b);
+        a.mov(x86::dword_ptr(x86::rsp, x86::rcx, 2, kLoopsOfs), x86::edx);
+        a.mov(x86::edx, c);
+        a.mov(x86::dword_ptr(x86::rsp, x86::rcx, 2, kLoopsOfs + 4), x86::edx);
+        a.dec(stackField(offsetof(SHRegExpStack, size)));
+        a.jmp(backtrackLabel_);
+        break;
+      case SetPosition:
+        a.mov(wPos, b);
+        a.dec(stackField(offsetof(SHRegExpStack, size)));
+        a.jmp(resumeLabel_);
+        break;
+      // Width 1 loop entries stay on the stack until every exit position has
+      // been tried.
+      case GreedyWidth1:
+        a.mov(x86::edx, c);
+        a.cmp(x86::edx, b);
+        a.je(pop);
+        a.dec(x86::edx);
+        a.mov(c, x86::edx);
+        a.mov(wPos, x86::edx);
+        a.jmp(resumeLabel_);
+        break;
+      case NongreedyWidth1:
+        a.mov(x86::edx, b);
+        a.cmp(x86::edx, c);
+        a.je(pop);
+        a.inc(x86::edx);
+        a.mov(b, x86::edx);
+        a.mov(wPos, x86::edx);
+        a.jmp(resumeLabel_);
+        break;
+      case EnterLoop:
+        a.mov(x86::edi, b);
+        a.mov(wPos, c);
+        a.dec(stackField(offsetof(SHRegExpStack, size)));
+        a.jmp(enterLoopLabel_);
+        break;
+      case NumKinds:
+        llvm_unreachable("invalid backtrack kind");
+    }
+  }
+  a.bind(pop);
+  a.dec(stackField(offsetof(SHRegExpStack, size)));
+  a.jmp(backtrackLabel_);
+  a.bind(empty);
+}
+
+} // namespace
+
+bool RegExpJIT::canCompile(llvh::ArrayRef<uint8_t> bytecode) {
+  if (bytecode.size() < sizeof(RegexBytecodeHeader) ||
+      bytecode.size() > kMaxBytecodeSize)
+    return false;
+  auto *header = reinterpret_cast<const RegexBytecodeHeader *>(bytecode.data());
+  SyntaxFlags flags = SyntaxFlags::fromByte(header->syntaxFlags);
+  if (flags.ignoreCase || flags.unicode || header->loopCount > kMaxLoops)
+    return false;
+
+  llvh::ArrayRef<uint8_t> insns =
+      bytecode.drop_front(sizeof(RegexBytecodeHeader));
+  for (uint32_t offset = 0; offset < insns.size();) {
+    auto *insn = reinterpret_cast<const Insn *>(&insns[offset]);
+    switch (insn->opcode) {
+      case Opcode::Goal:
+      case Opcode::LeftAnchor:
+      case Opcode::LeftAnchorMultiline:
+      case Opcode::RightAnchor:
+      case Opcode::RightAnchorMultiline:
+      case Opcode::MatchAny:
+      case Opcode::MatchAnyButNewline:
+      case Opcode::MatchChar8:
+      case Opcode::MatchChar16:
+      case Opcode::MatchNChar8:
+      case Opcode::Alternation:
+      case Opcode::Jump32:
+      case Opcode::Bracket:
+      case Opcode::BeginMarkedSubexpression:
+      case Opcode::EndMarkedSubexpression:
+      case Opcode::BackRef:
+      case Opcode::WordBoundary:
+      case Opcode::BeginLoop:
+      case Opcode::EndLoop:
+      case Opcode::BeginSimpleLoop:
+      case Opcode::EndSimpleLoop:
+        break;
+      case Opcode::Width1Loop: {
+        uint32_t bodyOffset = offset + sizeof(Width1LoopInsn);
+        if (bodyOffset >= insns.size() ||
+            !isSupportedWidth1(
+                reinterpret_cast<const Insn *>(&insns[bodyOffset])->opcode))
+          return false;
+        break;
+      }
+      default:
+        return false;
+    }
+    offset += insnWidth(insn);
+  }
+  return true;
+}
+
+const SHNativeRegExp *RegExpJIT::compile(
+    llvh::ArrayRef<uint8_t> bytecode,
+    size_t memoryLimit,
+    bool dumpCode) {
+  assert(canCompile(bytecode) && "unsupported regexp");
+  RecordingErrorHandler errorHandler;
+  asmjit::CodeHolder code;
+  code.init(jr_.environment(), jr_.cpuFeatures());
+  code.setErrorHandler(&errorHandler);
+#ifndef ASMJIT_NO_LOGGING
+  asmjit::StringLogger logger;
+  if (dumpCode) {
+    logger.setIndentation(asmjit::FormatIndentationGroup::kCode, 4);
+    code.setLogger(&logger);
+  }
+#endif
+  x86::Assembler a(&code);
+
+  asmjit::Label search8 = a.newLabel(), search16 = a.newLabel();
+  MatcherGen(a, bytecode, false).generate(search8);
+  MatcherGen(a, bytecode, true).generate(search16);
+  code.detach(&a);
+
+  if (errorHandler.error != asmjit::kErrorOk)
+    return nullptr;
+  if (jr_.allocator()->statistics().usedSize() + code.codeSize() >
+      memoryLimit)
+    return nullptr;
+
+  void *fn;
+  if (jr_.add(&fn, &code) != asmjit::kErrorOk)
+    return nullptr;
+
+#ifndef ASMJIT_NO_LOGGING
+  if (dumpCode)
+    llvh::outs() << logger.data();
+#endif
+
+  auto *header = reinterpret_cast<const RegexBytecodeHeader *>(bytecode.data());
+  auto address = [&code, fn](const asmjit::Label &label) {
+    return reinterpret_cast<uintptr_t>(fn) + code.labelOffsetFromBase(label);
+  };
+  return &regExps_.emplace_back(SHNativeRegExp{
+      .marked_count = header->markedCount,
+      .search8 = reinterpret_cast<SHNativeRegExpSearch8>(address(search8)),
+      .search16 = reinterpret_cast<SHNativeRegExpSearch16>(address(search16)),
+  });
+}
+
+} // namespace hermes::vm::x86_64
+
+#endif // HERMESVM_JIT
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "hermes/VM/sh_native_regexp.h"
+
+#include "llvh/ADT/ArrayRef.h"
+
+#include "asmjit/x86.h"
+
+#include <deque>
+
+namespace hermes::vm::x86_64 {
+
+/// Compiles regex bytecode to native matchers at runtime. The generated code
+/// implements the same backtracking search as the matchers the SH backend
+/// emits as C for regexp literals, and gives up in the same way when it runs
+/// out of backtracking budget, so the regex interpreter can take over.
+///
+/// The matchers are owned by the RegExpJIT and live as long as it does. They
+/// are only compiled and used on the mutator thread, so they are kept apart
+/// from the code of the background function compiler.
+class RegExpJIT {
+ public:
+  /// \return true if compile() can translate the regex \p bytecode.
+  /// Case-insensitive and unicode regexps, lookarounds and case-insensitive
+  /// backreferences are left to the regex interpreter.
+  static bool canCompile(llvh::ArrayRef<uint8_t> bytecode);
+
+  /// Compile the regex \p bytecode, for which canCompile() must be true, to a
+  /// pair of matchers for ASCII and UTF-16 inputs. Print the generated code
+  /// if \p dumpCode is set.
+  /// \return the matchers, or nullptr if the code would exceed
+  /// \p memoryLimit bytes in total.
+  const SHNativeRegExp *compile(
+      llvh::ArrayRef<uint8_t> bytecode,
+      size_t memoryLimit,
+      bool dumpCode);
+
+ private:
+  asmjit::JitRuntime jr_{};
+
+  /// The compiled matchers, which must not move while they may be referenced
+  /// by a JSRegExp.
+  std::deque<SHNativeRegExp> regExps_{};
+};
+
+} // namespace hermes::vm::x86_64
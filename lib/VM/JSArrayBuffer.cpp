@@ -128,12 +128,14 @@ JSArrayBuffer::JSArrayBuffer(
     Runtime &runtime,
     Handle<JSObject> parent,
     Handle<HiddenClass> clazz)
-    : JSObject(runtime, *parent, *clazz), attached_(false) {}
+    : JSObject(runtime, *parent, *clazz), shared_(false), attached_(false) {}
 
 void JSArrayBuffer::_finalizeImpl(GCCell *cell, GC &gc) {
   auto *self = vmcast<JSArrayBuffer>(cell);
   if (self->attached() && !self->external_)
     self->freeInternalBuffer(gc);
+  else if (self->attached() && self->shared_)
+    gc.debitExternalMemory(self, self->size_);
   self->~JSArrayBuffer();
 }
 
@@ -203,6 +205,8 @@ void JSArrayBuffer::detach(Runtime &runtime, Handle<JSArrayBuffer> self) {
   if (!self->external_)
     self->freeInternalBuffer(runtime.getHeap());
   else {
+    if (self->shared_)
+      runtime.getHeap().debitExternalMemory(*self, self->size_);
     setExternalFinalizer(runtime, self, HandleRootOwner::getUndefinedValue());
   }
   // Note that whether a buffer is attached is independent of whether
@@ -210,6 +214,7 @@ void JSArrayBuffer::detach(Runtime &runtime, Handle<JSArrayBuffer> self) {
   self->data_ = nullptr;
   self->size_ = 0;
   self->external_ = false;
+  self->shared_ = false;
   self->attached_ = false;
 }
 
@@ -217,6 +222,7 @@ void JSArrayBuffer::ejectBufferUnsafe(
     Runtime &runtime,
     Handle<JSArrayBuffer> self) {
   assert(self->attached() && "Buffer must be attached");
+  assert(!self->shared() && "SharedArrayBuffers cannot be detached");
   // Untrack the memory if the attached data block is internal.
   if (!self->external_) {
     self->untrackInternalBuffer(runtime.getHeap());
@@ -309,6 +315,43 @@ void JSArrayBuffer::setExternalDataBlock(
   self->data_ = data;
 }
 
+ExecutionStatus JSArrayBuffer::createSharedDataBlock(
+    Runtime &runtime,
+    Handle<JSArrayBuffer> self,
+    size_type size) {
+  uint8_t *data = nullptr;
+  if (size > 0) {
+    // The block is not owned by this runtime's heap, but it is still limited to
+    // what a single runtime would be allowed to allocate.
+    if (LLVM_UNLIKELY(!runtime.getHeap().canAllocExternalMemory(size))) {
+      return runtime.raiseRangeError(
+          "Cannot allocate a data block for the SharedArrayBuffer");
+    }
+    data = static_cast<uint8_t *>(calloc(sizeof(uint8_t), size));
+    if (!data) {
+      return runtime.raiseRangeError(
+          "Cannot allocate a data block for the SharedArrayBuffer");
+    }
+  }
+  setSharedDataBlock(
+      runtime, self, data, size, std::shared_ptr<void>(data, free));
+  return ExecutionStatus::RETURNED;
+}
+
+void JSArrayBuffer::setSharedDataBlock(
+    Runtime &runtime,
+    Handle<JSArrayBuffer> self,
+    uint8_t *data,
+    size_type size,
+    const std::shared_ptr<void> &context) {
+  setExternalDataBlock(runtime, self, data, size, context);
+  self->shared_ = true;
+  // Every runtime that refers to the block accounts for all of it, so that
+  // creating or receiving shared buffers can trigger a collection in any of
+  // them.
+  runtime.getHeap().creditExternalMemory(*self, size);
+}
+
 PseudoHandle<NativeState> JSArrayBuffer::getExternalFinalizerNativeState(
     Runtime &runtime,
     Handle<JSArrayBuffer> self) {
@@ -12,6 +12,7 @@
 #include "JSLibInternal.h"
 
 #include "hermes/ADT/SafeInt.h"
+#include "hermes/Support/Conversions.h"
 #include "hermes/Support/FastArraySearch.h"
 #include "hermes/VM/HandleRootOwner-inline.h"
 #include "hermes/VM/JSLib.h"
@@ -1453,7 +1454,7 @@ namespace {
 /// handles every time we want to compare different elements.
 /// Usage example:
 ///   StandardSortModel sm{runtime, obj, compareFn};
-///   quickSort(sm, 0, length);
+///   timSort(sm, 0, length);
 /// Note that this is generic and does nothing different if passed a JSArray.
 class StandardSortModel : public SortModel {
  private:
@@ -1711,7 +1712,8 @@ class StandardSortModel : public SortModel {
       }
       lv_.bValue = bValueRes->getHermesValue();
 
-      return lv_.aValue->getString()->compare(lv_.bValue->getString());
+      return lv_.aValue->getString()->compare(
+          runtime_, lv_.bValue->getString());
     }
   }
 };
@@ -1824,7 +1826,8 @@ class DirectSortModel : public SortModel {
       }
       lv_.bValue = bValueRes->getHermesValue();
 
-      return lv_.aValue->getString()->compare(lv_.bValue->getString());
+      return lv_.aValue->getString()->compare(
+          runtime_, lv_.bValue->getString());
     }
   }
 };
@@ -1922,7 +1925,7 @@ CallResult<HermesValue> sortSparse(
   {
     StandardSortModel sm(runtime, lv.array, compareFn);
     if (LLVM_UNLIKELY(
-            quickSort(&sm, 0u, numProps) == ExecutionStatus::EXCEPTION))
+            timSort(&sm, 0u, numProps) == ExecutionStatus::EXCEPTION))
       return ExecutionStatus::EXCEPTION;
   }
 
@@ -1950,6 +1953,114 @@ CallResult<HermesValue> sortSparse(
 
   return O.getHermesValue();
 }
+
+/// The element types for which sortPrimitiveArray() has a fast path.
+enum class PrimitiveElements {
+  /// Every element is a number that is an int32 (and not -0).
+  Int32,
+  /// Every element is a number.
+  Number,
+  /// Every element is a string.
+  String,
+  /// Anything else, including holes.
+  Other,
+};
+
+/// \return which kind of primitives the first \p len elements of \p storage
+/// are.
+PrimitiveElements classifyElements(
+    Runtime &runtime,
+    const JSArray::StorageType *storage,
+    uint32_t len) {
+  SmallHermesValue first = storage->at(0);
+  if (first.isString()) {
+    for (uint32_t i = 1; i < len; ++i) {
+      if (!storage->at(i).isString())
+        return PrimitiveElements::Other;
+    }
+    return PrimitiveElements::String;
+  }
+  auto kind = PrimitiveElements::Int32;
+  for (uint32_t i = 0; i < len; ++i) {
+    SmallHermesValue elem = storage->at(i);
+    if (!elem.isNumber())
+      return PrimitiveElements::Other;
+    if (kind == PrimitiveElements::Number)
+      continue;
+    double num = elem.getNumber(runtime);
+    int32_t intNum;
+    if (!sh_tryfast_f64_to_i32(num, intNum) || (!intNum && std::signbit(num)))
+      kind = PrimitiveElements::Number;
+  }
+  return kind;
+}
+
+/// Sort \p arr in place without a comparator, if it is a dense array of
+/// numbers or of strings. Converting those to strings has no side effects,
+/// so the sort does not need to call back into JS or allocate.
+/// \return true if the array was sorted, false if it does not qualify.
+bool sortPrimitiveArray(Runtime &runtime, JSArray *arr, uint32_t len) {
+  if (len < 2 || !arrayFastPathCheck(runtime, arr, nullptr, len))
+    return false;
+
+  NoAllocScope noAlloc{runtime};
+  auto *storage = arr->getIndexedStorageUnsafe(runtime);
+  auto kind = classifyElements(runtime, storage, len);
+  if (kind == PrimitiveElements::Other)
+    return false;
+  // perm[i] is the index of the element that goes to i.
+  std::vector<uint32_t> perm(len);
+  for (uint32_t i = 0; i < len; ++i)
+    perm[i] = i;
+
+  if (kind != PrimitiveElements::String) {
+    // Numbers are ordered by their string representations, which only
+    // contain ASCII characters, so comparing their bytes gives the same
+    // order as comparing UTF-16 strings.
+    std::string chars;
+    std::vector<std::pair<uint32_t, uint32_t>> keys(len);
+    char buf[NUMBER_TO_STRING_BUF_SIZE];
+    for (uint32_t i = 0; i < len; ++i) {
+      double num = storage->at(i).getNumber(runtime);
+      size_t keyLen;
+      if (kind == PrimitiveElements::Int32) {
+        int32_t intNum = (int32_t)num;
+        uint32_t digits = intNum < 0 ? 0u - (uint32_t)intNum : (uint32_t)intNum;
+        char *p = buf + sizeof(buf);
+        do {
+          *--p = '0' + digits % 10;
+          digits /= 10;
+        } while (digits);
+        if (intNum < 0)
+          *--p = '-';
+        keyLen = buf + sizeof(buf) - p;
+        std::memmove(buf, p, keyLen);
+      } else {
+        keyLen = numberToString(num, buf, sizeof(buf));
+      }
+      keys[i] = {(uint32_t)chars.size(), (uint32_t)keyLen};
+      chars.append(buf, keyLen);
+    }
+    auto key = [&chars, &keys](uint32_t i) {
+      return llvh::StringRef(chars.data() + keys[i].first, keys[i].second);
+    };
+    timSort(perm, [&key](uint32_t a, uint32_t b) { return key(a) < key(b); });
+  } else {
+    timSort(perm, [storage, &runtime](uint32_t a, uint32_t b) {
+      return storage->at(a).getString(runtime)->compare(
+                 runtime, storage->at(b).getString(runtime)) < 0;
+    });
+  }
+
+  // Write the elements back in their sorted order.
+  std::vector<SmallHermesValue> sorted;
+  sorted.reserve(len);
+  for (uint32_t i = 0; i < len; ++i)
+    sorted.push_back(storage->at(perm[i]));
+  for (uint32_t i = 0; i < len; ++i)
+    storage->set(i, sorted[i], runtime.getHeap());
+  return true;
+}
 } // anonymous namespace
 
 /// ES5.1 15.4.4.11.
@@ -1985,7 +2096,7 @@ CallResult<HermesValue> arrayPrototypeSort(void *, Runtime &runtime) {
   }
   uint64_t len = *intRes;
 
-  // No sort implementation can handle lengths exceeding UINT32_MAX: quickSort
+  // No sort implementation can handle lengths exceeding UINT32_MAX: timSort
   // takes uint32_t, and even iterating over that many indices is impractical.
   if (LLVM_UNLIKELY(len > UINT32_MAX))
     return runtime.raiseRangeError("Array sort length exceeds uint32_t");
@@ -1997,6 +2108,13 @@ CallResult<HermesValue> arrayPrototypeSort(void *, Runtime &runtime) {
       !lv.O->hasFastIndexProperties())
     return sortSparse(runtime, lv.O, compareFn, len);
 
+  // The fastest path: the default order on a dense array of primitives.
+  if (!compareFn) {
+    if (auto *arr = dyn_vmcast<JSArray>(lv.O.get());
+        arr && sortPrimitiveArray(runtime, arr, static_cast<uint32_t>(len)))
+      return lv.O.getHermesValue();
+  }
+
   // This is the "fast" path. We are sorting an array with indexed storage.
   StandardSortModel sm(runtime, lv.O, compareFn);
 
@@ -2005,7 +2123,7 @@ CallResult<HermesValue> arrayPrototypeSort(void *, Runtime &runtime) {
   // function is special, since it needs to use the internal Object functions.
   assert(len <= UINT32_MAX && "sort length exceeds uint32_t");
   if (LLVM_UNLIKELY(
-          quickSort(&sm, 0u, static_cast<uint32_t>(len)) ==
+          timSort(&sm, 0u, static_cast<uint32_t>(len)) ==
           ExecutionStatus::EXCEPTION))
     return ExecutionStatus::EXCEPTION;
 
@@ -3529,7 +3647,7 @@ indexOfHelper(Runtime &runtime, NativeArgs args, const bool reverse) {
       auto searchStr = searchElementVal.getString(runtime);
 
 #define COMPARE_EXPR(element) \
-  element.isString() && searchStr->equals(element.getString(runtime))
+  element.isString() && searchStr->equals(runtime, element.getString(runtime))
       SEARCH_ARRAY
 #undef COMPARE_EXPR
     } else if (searchElementVal.isBigInt()) {
@@ -3578,7 +3696,7 @@ indexOfHelper(Runtime &runtime, NativeArgs args, const bool reverse) {
       return ExecutionStatus::EXCEPTION;
     }
     if (!(*propRes)->isEmpty() &&
-        strictEqualityTest(searchElement.get(), propRes->get())) {
+        strictEqualityTest(runtime, searchElement.get(), propRes->get())) {
       return lv.k.get();
     }
     // Update the index based on the direction of the search.
@@ -4612,7 +4730,8 @@ CallResult<HermesValue> arrayPrototypeIncludes(void *, Runtime &runtime) {
       auto searchStr = searchElementVal.getString(runtime);
       for (uint64_t i = k; i < len; ++i) {
         auto element = arrStorage->at(i);
-        if (element.isString() && searchStr->equals(element.getString(runtime)))
+        if (element.isString() &&
+            searchStr->equals(runtime, element.getString(runtime)))
           return HermesValue::encodeBoolValue(true);
       }
     } else if (searchElementVal.isBigInt()) {
@@ -4877,8 +4996,10 @@ CallResult<HermesValue> arrayPrototypeToSorted(void *, Runtime &runtime) {
   // 5. Let SortCompare be an Abstract Closure calling
   // CompareArrayElements(x, y, comparator).
   // 7-8. Copy sortedList into A (already done above, sort in place).
+  if (!compareFn && sortPrimitiveArray(runtime, lv.A.get(), len32))
+    return lv.A.getHermesValue();
   DirectSortModel sm(runtime, lv.A, compareFn);
-  if (LLVM_UNLIKELY(quickSort(&sm, 0u, len32) == ExecutionStatus::EXCEPTION))
+  if (LLVM_UNLIKELY(timSort(&sm, 0u, len32) == ExecutionStatus::EXCEPTION))
     return ExecutionStatus::EXCEPTION;
 
   // 9. Return A.
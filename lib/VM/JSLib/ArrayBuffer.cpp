@@ -162,7 +162,7 @@ CallResult<HermesValue> arrayBufferPrototypeByteLength(
     Runtime &runtime) {
   NativeArgs args = runtime.getCurrentFrame().getNativeArgs();
   auto self = args.dyncastThis<JSArrayBuffer>();
-  if (!self) {
+  if (!self || self->shared()) {
     return runtime.raiseTypeError(
         "byteLength called on a non ArrayBuffer object");
   }
@@ -172,7 +172,7 @@ CallResult<HermesValue> arrayBufferPrototypeByteLength(
 CallResult<HermesValue> arrayBufferPrototypeDetached(void *, Runtime &runtime) {
   NativeArgs args = runtime.getCurrentFrame().getNativeArgs();
   auto self = args.dyncastThis<JSArrayBuffer>();
-  if (!self) {
+  if (!self || self->shared()) {
     return runtime.raiseTypeError(
         "detached called on a non ArrayBuffer object");
   }
@@ -187,9 +187,10 @@ CallResult<HermesValue> arrayBufferPrototypeSlice(void *, Runtime &runtime) {
   auto self = args.dyncastThis<JSArrayBuffer>();
   // 2. If Type(O) is not Object, throw a TypeError exception.
   // 3. If O does not have an [[ArrayBufferData]] internal slot, throw a
-  // TypeError exception. 4. If IsDetachedBuffer(O) is true, throw a TypeError
+  // TypeError exception. If IsSharedArrayBuffer(O) is true, throw a TypeError
+  // exception. 4. If IsDetachedBuffer(O) is true, throw a TypeError
   // exception.
-  if (!self) {
+  if (!self || self->shared()) {
     return runtime.raiseTypeError(
         "Called ArrayBuffer.prototype.slice on a non-ArrayBuffer");
   }
@@ -0,0 +1,658 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+//===----------------------------------------------------------------------===//
+/// \file
+/// ES2024 25.4 The Atomics Object
+///
+/// The operations are implemented with std::atomic over the elements of the
+/// TypedArray's data block. Data blocks are only shared between threads when
+/// they belong to a SharedArrayBuffer, but the operations are also allowed on
+/// ordinary ArrayBuffers, where they behave like plain accesses.
+//===----------------------------------------------------------------------===//
+#include "JSLibInternal.h"
+
+#include "hermes/VM/BigIntPrimitive.h"
+#include "hermes/VM/JSArrayBuffer.h"
+#include "hermes/VM/JSTypedArray.h"
+#include "hermes/VM/Operations.h"
+
+#include "llvh/ADT/Optional.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+
+namespace hermes {
+namespace vm {
+
+namespace {
+
+/// The operation performed by atomicsReadModifyWrite, passed as the context
+/// of the native function.
+enum class AtomicRMWOp { Add, And, Exchange, Or, Sub, Xor };
+
+/// \return element \p index of the data block \p data, viewed as an atomic.
+template <typename T>
+std::atomic<T> &atomicElement(uint8_t *data, uint32_t index) {
+  static_assert(
+      sizeof(std::atomic<T>) == sizeof(T) &&
+          std::atomic<T>::is_always_lock_free,
+      "TypedArray elements must be accessible as lock-free atomics");
+  return reinterpret_cast<std::atomic<T> *>(data)[index];
+}
+
+/// Call \p fn with a null pointer of the element type of the integer TypedArray
+/// kind \p kind. \return the result of \p fn.
+template <typename Fn>
+CallResult<HermesValue> dispatchIntegerKind(CellKind kind, Fn fn) {
+  switch (kind) {
+    case CellKind::Int8ArrayKind:
+      return fn(static_cast<int8_t *>(nullptr));
+    case CellKind::Uint8ArrayKind:
+      return fn(static_cast<uint8_t *>(nullptr));
+    case CellKind::Int16ArrayKind:
+      return fn(static_cast<int16_t *>(nullptr));
+    case CellKind::Uint16ArrayKind:
+      return fn(static_cast<uint16_t *>(nullptr));
+    case CellKind::Int32ArrayKind:
+      return fn(static_cast<int32_t *>(nullptr));
+    case CellKind::Uint32ArrayKind:
+      return fn(static_cast<uint32_t *>(nullptr));
+    case CellKind::BigInt64ArrayKind:
+      return fn(static_cast<int64_t *>(nullptr));
+    case CellKind::BigUint64ArrayKind:
+      return fn(static_cast<uint64_t *>(nullptr));
+    default:
+      llvm_unreachable("Not an integer TypedArray kind");
+  }
+}
+
+bool isBigIntKind(CellKind kind) {
+  return kind == CellKind::BigInt64ArrayKind ||
+      kind == CellKind::BigUint64ArrayKind;
+}
+
+/// Convert the numeric \p value (a Number or a BigInt, as produced by
+/// toAtomicValue) to the element type T, wrapping around like a TypedArray
+/// store.
+template <typename T>
+T fromAtomicValue(HermesValue value) {
+  return static_cast<T>(truncateToInt32(value.getNumber()));
+}
+template <>
+int64_t fromAtomicValue<int64_t>(HermesValue value) {
+  return JSTypedArray<int64_t, CellKind::BigInt64ArrayKind>::toDestType(value);
+}
+template <>
+uint64_t fromAtomicValue<uint64_t>(HermesValue value) {
+  return JSTypedArray<uint64_t, CellKind::BigUint64ArrayKind>::toDestType(
+      value);
+}
+
+/// Encode the element \p elem read from a TypedArray as a JS value.
+template <typename T>
+CallResult<HermesValue> encodeAtomicValue(Runtime &runtime, T elem) {
+  return HermesValue::encodeTrustedNumberValue(elem);
+}
+template <>
+CallResult<HermesValue> encodeAtomicValue<int64_t>(
+    Runtime &runtime,
+    int64_t elem) {
+  return BigIntPrimitive::fromSigned(runtime, elem);
+}
+template <>
+CallResult<HermesValue> encodeAtomicValue<uint64_t>(
+    Runtime &runtime,
+    uint64_t elem) {
+  return BigIntPrimitive::fromUnsigned(runtime, elem);
+}
+
+/// ES2024 25.4.3.1 ValidateIntegerTypedArray
+/// Check that \p self is an attached TypedArray with integer elements. If
+/// \p waitable is true, only Int32Array and BigInt64Array are accepted.
+ExecutionStatus validateIntegerTypedArray(
+    Runtime &runtime,
+    Handle<JSTypedArrayBase> self,
+    bool waitable) {
+  if (!self) {
+    return runtime.raiseTypeError("Atomics operation requires a TypedArray");
+  }
+  if (!self->attached(runtime)) {
+    return runtime.raiseTypeError("Atomics operation on a detached buffer");
+  }
+  CellKind kind = self->getKind();
+  if (waitable) {
+    if (kind != CellKind::Int32ArrayKind &&
+        kind != CellKind::BigInt64ArrayKind) {
+      return runtime.raiseTypeError(
+          "Atomics.wait/notify requires an Int32Array or a BigInt64Array");
+    }
+  } else if (
+      kind == CellKind::Uint8ClampedArrayKind ||
+      kind == CellKind::Float16ArrayKind ||
+      kind == CellKind::Float32ArrayKind ||
+      kind == CellKind::Float64ArrayKind) {
+    return runtime.raiseTypeError(
+        "Atomics operation requires an integer TypedArray");
+  }
+  return ExecutionStatus::RETURNED;
+}
+
+/// ES2024 25.4.3.2 ValidateAtomicAccess
+/// \return the element index designated by \p requestIndex in \p self.
+CallResult<uint32_t> validateAtomicAccess(
+    Runtime &runtime,
+    Handle<JSTypedArrayBase> self,
+    Handle<> requestIndex) {
+  auto res = toIndex(runtime, requestIndex);
+  if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  double accessIndex = res->getNumber();
+  if (accessIndex >= self->getLength()) {
+    return runtime.raiseRangeError("Atomics access index out of range");
+  }
+  return static_cast<uint32_t>(accessIndex);
+}
+
+/// ES2024 25.4.3.17 ValidateAtomicAccessOnIntegerTypedArray
+CallResult<uint32_t> validateAtomicAccessOnIntegerTypedArray(
+    Runtime &runtime,
+    Handle<JSTypedArrayBase> self,
+    Handle<> requestIndex,
+    bool waitable = false) {
+  if (LLVM_UNLIKELY(
+          validateIntegerTypedArray(runtime, self, waitable) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return validateAtomicAccess(runtime, self, requestIndex);
+}
+
+/// Convert \p value to the type stored by TypedArrays of kind \p kind: a
+/// BigInt for BigInt arrays, otherwise an integral Number.
+CallResult<HermesValue>
+toAtomicValue(Runtime &runtime, CellKind kind, Handle<> value) {
+  if (!isBigIntKind(kind))
+    return toIntegerOrInfinity(runtime, value);
+  auto res = toBigInt_RJS(runtime, value);
+  if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (LLVM_UNLIKELY(!res->isBigInt())) {
+    return runtime.raiseTypeErrorForValue(
+        "can't convert ", value, " to bigint");
+  }
+  return *res;
+}
+
+/// ES2024 25.4.3.3 RevalidateAtomicAccess
+/// Converting the operands may have run user code which detached the buffer.
+ExecutionStatus revalidateAtomicAccess(
+    Runtime &runtime,
+    Handle<JSTypedArrayBase> self) {
+  if (LLVM_UNLIKELY(!self->attached(runtime))) {
+    return runtime.raiseTypeError("Atomics operation on a detached buffer");
+  }
+  return ExecutionStatus::RETURNED;
+}
+
+/// The agents blocked in Atomics.wait(). The list is shared by every runtime
+/// in the process, since the memory they wait on may be shared between them.
+class WaiterList {
+ public:
+  /// The outcome of wait().
+  enum class WaitResult { Ok, TimedOut, Interrupted };
+
+  static WaiterList &get() {
+    // Intentionally leaked: threads may still be waiting at exit.
+    static WaiterList *list = new WaiterList();
+    return *list;
+  }
+
+  /// If \p check returns true with the list locked, block until notify() is
+  /// called on \p address or \p timeout expires. While blocked, \p poll is
+  /// called with the list unlocked every \p pollInterval; if it returns false,
+  /// stop waiting and return Interrupted. \return None if \p check returned
+  /// false.
+  template <typename Check, typename Poll>
+  llvh::Optional<WaitResult> wait(
+      const void *address,
+      Check check,
+      std::chrono::duration<double, std::milli> timeout,
+      std::chrono::milliseconds pollInterval,
+      Poll poll) {
+    using Clock = std::chrono::steady_clock;
+    std::unique_lock<std::mutex> lk{mutex_};
+    if (!check())
+      return llvh::None;
+    Waiter waiter{address};
+    auto it = waiters_.insert(waiters_.end(), &waiter);
+    auto deadline = Clock::time_point::max();
+    if (timeout != timeout.max())
+      deadline =
+          Clock::now() + std::chrono::duration_cast<Clock::duration>(timeout);
+    while (!waiter.notified) {
+      auto now = Clock::now();
+      if (now >= deadline)
+        break;
+      auto wakeup =
+          deadline - now > pollInterval ? now + pollInterval : deadline;
+      if (waiter.cv.wait_until(lk, wakeup) == std::cv_status::no_timeout ||
+          waiter.notified || wakeup == deadline)
+        continue;
+      // The waiter stays in the list while it is unlocked, so a notify()
+      // meanwhile is observed by the loop condition.
+      lk.unlock();
+      bool keepWaiting = poll();
+      lk.lock();
+      if (!keepWaiting && !waiter.notified) {
+        waiters_.erase(it);
+        return WaitResult::Interrupted;
+      }
+    }
+    if (waiter.notified)
+      return WaitResult::Ok;
+    waiters_.erase(it);
+    return WaitResult::TimedOut;
+  }
+
+  /// Wake up at most \p count agents waiting on \p address, in FIFO order.
+  /// \return the number of agents woken up.
+  uint32_t notify(const void *address, double count) {
+    std::lock_guard<std::mutex> lk{mutex_};
+    uint32_t n = 0;
+    for (auto it = waiters_.begin(); it != waiters_.end() && n < count;) {
+      Waiter *waiter = *it;
+      if (waiter->address != address) {
+        ++it;
+        continue;
+      }
+      waiter->notified = true;
+      waiter->cv.notify_one();
+      it = waiters_.erase(it);
+      ++n;
+    }
+    return n;
+  }
+
+ private:
+  struct Waiter {
+    const void *address;
+    std::condition_variable cv{};
+    bool notified = false;
+  };
+
+  std::mutex mutex_{};
+  std::list<Waiter *> waiters_{};
+};
+
+} // namespace
+
+void createAtomicsObject(Runtime &runtime, MutableHandle<JSObject> result) {
+  struct : public Locals {
+    PinnedValue<JSObject> atomics;
+  } lv;
+  LocalsRAII lraii(runtime, &lv);
+  lv.atomics = JSObject::create(runtime);
+
+  auto defineAtomicsMethod = [&](Predefined::Str symID,
+                                 NativeFunctionPtr func,
+                                 uint8_t count,
+                                 void *context = nullptr) {
+    (void)defineMethod(
+        runtime,
+        lv.atomics,
+        Predefined::getSymbolID(symID),
+        context,
+        func,
+        count);
+  };
+  auto defineRMWMethod = [&](Predefined::Str symID, AtomicRMWOp op) {
+    defineAtomicsMethod(symID, atomicsReadModifyWrite, 3, (void *)op);
+  };
+
+  defineRMWMethod(Predefined::add, AtomicRMWOp::Add);
+  defineRMWMethod(Predefined::andStr, AtomicRMWOp::And);
+  defineAtomicsMethod(Predefined::compareExchange, atomicsCompareExchange, 4);
+  defineRMWMethod(Predefined::exchange, AtomicRMWOp::Exchange);
+  defineAtomicsMethod(Predefined::isLockFree, atomicsIsLockFree, 1);
+  defineAtomicsMethod(Predefined::load, atomicsLoad, 2);
+  defineAtomicsMethod(Predefined::notify, atomicsNotify, 3);
+  defineRMWMethod(Predefined::orStr, AtomicRMWOp::Or);
+  defineAtomicsMethod(Predefined::store, atomicsStore, 3);
+  defineRMWMethod(Predefined::sub, AtomicRMWOp::Sub);
+  defineAtomicsMethod(Predefined::wait, atomicsWait, 4);
+  defineRMWMethod(Predefined::xorStr, AtomicRMWOp::Xor);
+
+  DefinePropertyFlags dpf = DefinePropertyFlags::getDefaultNewPropertyFlags();
+  dpf.writable = 0;
+  dpf.enumerable = 0;
+  dpf.configurable = 1;
+  defineProperty(
+      runtime,
+      lv.atomics,
+      Predefined::getSymbolID(Predefined::SymbolToStringTag),
+      runtime.getPredefinedStringHandle(Predefined::Atomics),
+      dpf);
+
+  result.castAndSetHermesValue<JSObject>(lv.atomics.getHermesValue());
+}
+
+/// ES2024 25.4.3.17 AtomicReadModifyWrite, used for Atomics.add, and,
+/// exchange, or, sub and xor.
+CallResult<HermesValue> atomicsReadModifyWrite(void *ctx, Runtime &runtime) {
+  NativeArgs args = runtime.getCurrentFrame().getNativeArgs();
+  auto op = static_cast<AtomicRMWOp>((uintptr_t)ctx);
+  auto self = args.dyncastArg<JSTypedArrayBase>(0);
+  // 1. Let byteIndexInBuffer be ? ValidateAtomicAccessOnIntegerTypedArray(
+  // typedArray, index).
+  auto indexRes = validateAtomicAccessOnIntegerTypedArray(
+      runtime, self, args.getArgHandle(1));
+  if (LLVM_UNLIKELY(indexRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  uint32_t index = *indexRes;
+  // 2-3. Let v be ? ToBigInt(value) or ? ToIntegerOrInfinity(value).
+  auto valueRes = toAtomicValue(runtime, self->getKind(), args.getArgHandle(2));
+  if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // 4. Perform ? RevalidateAtomicAccess(typedArray, byteIndexInBuffer).
+  if (LLVM_UNLIKELY(
+          revalidateAtomicAccess(runtime, self) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // 5-8. Return GetModifySetValueInBuffer(buffer, byteIndexInBuffer, type, v,
+  // op).
+  HermesValue value = *valueRes;
+  return dispatchIntegerKind(self->getKind(), [&](auto *tag) {
+    using T = std::remove_pointer_t<decltype(tag)>;
+    std::atomic<T> &elem = atomicElement<T>(self->data(runtime), index);
+    T v = fromAtomicValue<T>(value);
+    T old;
+    switch (op) {
+      case AtomicRMWOp::Add:
+        old = elem.fetch_add(v);
+        break;
+      case AtomicRMWOp::And:
+        old = elem.fetch_and(v);
+        break;
+      case AtomicRMWOp::Exchange:
+        old = elem.exchange(v);
+        break;
+      case AtomicRMWOp::Or:
+        old = elem.fetch_or(v);
+        break;
+      case AtomicRMWOp::Sub:
+        old = elem.fetch_sub(v);
+        break;
+      case AtomicRMWOp::Xor:
+        old = elem.fetch_xor(v);
+        break;
+    }
+    return encodeAtomicValue<T>(runtime, old);
+  });
+}
+
+/// ES2024 25.4.5 Atomics.compareExchange(typedArray, index, expectedValue,
+/// replacementValue)
+CallResult<HermesValue> atomicsCompareExchange(void *, Runtime &runtime) {
+  NativeArgs args = runtime.getCurrentFrame().getNativeArgs();
+  auto self = args.dyncastArg<JSTypedArrayBase>(0);
+  // 1. Let byteIndexInBuffer be ? ValidateAtomicAccessOnIntegerTypedArray(
+  // typedArray, index).
+  auto indexRes = validateAtomicAccessOnIntegerTypedArray(
+      runtime, self, args.getArgHandle(1));
+  if (LLVM_UNLIKELY(indexRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  uint32_t index = *indexRes;
+  // 4-5. Convert expectedValue and replacementValue.
+  struct : public Locals {
+    PinnedValue<> expected;
+  } lv;
+  LocalsRAII lraii(runtime, &lv);
+  auto expectedRes =
+      toAtomicValue(runtime, self->getKind(), args.getArgHandle(2));
+  if (LLVM_UNLIKELY(expectedRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  lv.expected = *expectedRes;
+  auto replacementRes =
+      toAtomicValue(runtime, self->getKind(), args.getArgHandle(3));
+  if (LLVM_UNLIKELY(replacementRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // 7. Perform ? RevalidateAtomicAccess(typedArray, byteIndexInBuffer).
+  if (LLVM_UNLIKELY(
+          revalidateAtomicAccess(runtime, self) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // 8-15. Atomically replace the element if it equals expectedValue, and
+  // return the value it had.
+  HermesValue replacement = *replacementRes;
+  return dispatchIntegerKind(self->getKind(), [&](auto *tag) {
+    using T = std::remove_pointer_t<decltype(tag)>;
+    std::atomic<T> &elem = atomicElement<T>(self->data(runtime), index);
+    T expected = fromAtomicValue<T>(*lv.expected);
+    // On failure, compare_exchange_strong stores the current value in
+    // expected, so it holds the old value either way.
+    elem.compare_exchange_strong(expected, fromAtomicValue<T>(replacement));
+    return encodeAtomicValue<T>(runtime, expected);
+  });
+}
+
+/// ES2024 25.4.7 Atomics.isLockFree(size)
+CallResult<HermesValue> atomicsIsLockFree(void *, Runtime &runtime) {
+  NativeArgs args = runtime.getCurrentFrame().getNativeArgs();
+  // 1. Let n be ? ToIntegerOrInfinity(size).
+  auto res = toIntegerOrInfinity(runtime, args.getArgHandle(0));
+  if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // 2-6. All the element sizes are lock-free, see atomicElement().
+  double n = res->getNumber();
+  return HermesValue::encodeBoolValue(n == 1 || n == 2 || n == 4 || n == 8);
+}
+
+/// ES2024 25.4.8 Atomics.load(typedArray, index)
+CallResult<HermesValue> atomicsLoad(void *, Runtime &runtime) {
+  NativeArgs args = runtime.getCurrentFrame().getNativeArgs();
+  auto self = args.dyncastArg<JSTypedArrayBase>(0);
+  // 1. Let byteIndexInBuffer be ? ValidateAtomicAccessOnIntegerTypedArray(
+  // typedArray, index).
+  auto indexRes = validateAtomicAccessOnIntegerTypedArray(
+      runtime, self, args.getArgHandle(1));
+  if (LLVM_UNLIKELY(indexRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // 2. Perform ? RevalidateAtomicAccess(typedArray, byteIndexInBuffer).
+  // 3-5. Return GetValueFromBuffer(buffer, byteIndexInBuffer, elementType,
+  // true, seq-cst).
+  uint32_t index = *indexRes;
+  return dispatchIntegerKind(self->getKind(), [&](auto *tag) {
+    using T = std::remove_pointer_t<decltype(tag)>;
+    return encodeAtomicValue<T>(
+        runtime, atomicElement<T>(self->data(runtime), index).load());
+  });
+}
+
+/// ES2024 25.4.11 Atomics.store(typedArray, index, value)
+CallResult<HermesValue> atomicsStore(void *, Runtime &runtime) {
+  NativeArgs args = runtime.getCurrentFrame().getNativeArgs();
+  auto self = args.dyncastArg<JSTypedArrayBase>(0);
+  // 1. Let byteIndexInBuffer be ? ValidateAtomicAccessOnIntegerTypedArray(
+  // typedArray, index).
+  auto indexRes = validateAtomicAccessOnIntegerTypedArray(
+      runtime, self, args.getArgHandle(1));
+  if (LLVM_UNLIKELY(indexRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  uint32_t index = *indexRes;
+  // 2-3. Let v be ? ToBigInt(value) or ? ToIntegerOrInfinity(value).
+  auto valueRes = toAtomicValue(runtime, self->getKind(), args.getArgHandle(2));
+  if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // 4. Perform ? RevalidateAtomicAccess(typedArray, byteIndexInBuffer).
+  if (LLVM_UNLIKELY(
+          revalidateAtomicAccess(runtime, self) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // 5-7. Perform SetValueInBuffer(buffer, byteIndexInBuffer, elementType, v,
+  // true, seq-cst).
+  HermesValue value = *valueRes;
+  (void)dispatchIntegerKind(self->getKind(), [&](auto *tag) {
+    using T = std::remove_pointer_t<decltype(tag)>;
+    std::atomic<T> &elem = atomicElement<T>(self->data(runtime), index);
+    elem.store(fromAtomicValue<T>(value));
+    return CallResult<HermesValue>{value};
+  });
+  // 8. Return v.
+  return value;
+}
+
+/// ES2024 25.4.13 Atomics.wait(typedArray, index, value, timeout)
+/// Blocks the calling thread, which is expected to be a Worker: the runtime
+/// has no way to tell whether the embedder allows the thread to block.
+CallResult<HermesValue> atomicsWait(void *, Runtime &runtime) {
+  NativeArgs args = runtime.getCurrentFrame().getNativeArgs();
+  auto self = args.dyncastArg<JSTypedArrayBase>(0);
+  // DoWait 1-4. Let taRecord be ? ValidateIntegerTypedArray(typedArray, true).
+  // If IsSharedArrayBuffer(buffer) is false, throw a TypeError exception.
+  if (LLVM_UNLIKELY(
+          validateIntegerTypedArray(runtime, self, true) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (!self->getBuffer(runtime)->shared()) {
+    return runtime.raiseTypeError(
+        "Atomics.wait requires a TypedArray over a SharedArrayBuffer");
+  }
+  // 5. Let i be ? ValidateAtomicAccess(taRecord, index).
+  auto indexRes = validateAtomicAccess(runtime, self, args.getArgHandle(1));
+  if (LLVM_UNLIKELY(indexRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  uint32_t index = *indexRes;
+  // 7-8. Let v be ? ToBigInt64(value) or ? ToInt32(value).
+  auto valueRes = toAtomicValue(runtime, self->getKind(), args.getArgHandle(2));
+  if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  HermesValue value = *valueRes;
+  // 9-10. Let q be ? ToNumber(timeout). If q is NaN or +inf, let t be +inf;
+  // else if q is -inf, let t be 0; else let t be max(q, 0).
+  double t = std::numeric_limits<double>::infinity();
+  if (!args.getArg(3).isUndefined()) {
+    auto timeoutRes = toNumber_RJS(runtime, args.getArgHandle(3));
+    if (LLVM_UNLIKELY(timeoutRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    double q = timeoutRes->getNumber();
+    if (!std::isnan(q))
+      t = std::max(q, 0.0);
+  }
+  // 11. If AgentCanSuspend() is false, throw a TypeError exception.
+  if (!runtime.agentCanSuspend()) {
+    return runtime.raiseTypeError("Atomics.wait cannot block in this agent");
+  }
+  // Timeouts longer than a few years are treated as infinite, so that the
+  // deadline can be represented by the clock.
+  constexpr double kMaxTimeoutMs = 1e11;
+  // SharedArrayBuffers cannot be detached, so the conversions above cannot
+  // have invalidated the data pointer.
+  using Millis = std::chrono::duration<double, std::milli>;
+  Millis timeout = t > kMaxTimeoutMs ? Millis::max() : Millis{t};
+  // While blocked, let the GC make progress, and stop waiting if the runtime
+  // timed out. Debugger breaks are handled once the wait returns.
+  constexpr std::chrono::milliseconds kPollInterval{10};
+  auto poll = [&runtime]() {
+    runtime.getHeap().yieldToGC();
+    return !runtime.takeTimeoutAsyncBreakRequest();
+  };
+  // 16-32. With the waiter list locked, compare the element with v and
+  // suspend until notified or timed out.
+  llvh::Optional<WaiterList::WaitResult> result;
+  if (self->getKind() == CellKind::Int32ArrayKind) {
+    auto &elem = atomicElement<int32_t>(self->data(runtime), index);
+    int32_t v = fromAtomicValue<int32_t>(value);
+    result = WaiterList::get().wait(
+        &elem,
+        [&elem, v]() { return elem.load() == v; },
+        timeout,
+        kPollInterval,
+        poll);
+  } else {
+    auto &elem = atomicElement<int64_t>(self->data(runtime), index);
+    int64_t v = fromAtomicValue<int64_t>(value);
+    result = WaiterList::get().wait(
+        &elem,
+        [&elem, v]() { return elem.load() == v; },
+        timeout,
+        kPollInterval,
+        poll);
+  }
+  if (!result) {
+    return HermesValue::encodeStringValue(
+        runtime.getPredefinedString(Predefined::notEqual));
+  }
+  if (*result == WaiterList::WaitResult::Interrupted)
+    return runtime.raiseTimeoutError();
+  return HermesValue::encodeStringValue(runtime.getPredefinedString(
+      *result == WaiterList::WaitResult::Ok ? Predefined::ok
+                                            : Predefined::timedOut));
+}
+
+/// ES2024 25.4.15 Atomics.notify(typedArray, index, count)
+CallResult<HermesValue> atomicsNotify(void *, Runtime &runtime) {
+  NativeArgs args = runtime.getCurrentFrame().getNativeArgs();
+  auto self = args.dyncastArg<JSTypedArrayBase>(0);
+  // 1. Let taRecord be ? ValidateIntegerTypedArray(typedArray, true).
+  // 2. Let byteIndexInBuffer be ? ValidateAtomicAccess(taRecord, index).
+  auto indexRes = validateAtomicAccessOnIntegerTypedArray(
+      runtime, self, args.getArgHandle(1), true);
+  if (LLVM_UNLIKELY(indexRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  uint32_t index = *indexRes;
+  // 3-4. If count is undefined, let c be +inf. Otherwise, let c be max(?
+  // ToIntegerOrInfinity(count), 0).
+  double c = std::numeric_limits<double>::infinity();
+  if (!args.getArg(2).isUndefined()) {
+    auto countRes = toIntegerOrInfinity(runtime, args.getArgHandle(2));
+    if (LLVM_UNLIKELY(countRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    c = std::max(countRes->getNumber(), 0.0);
+  }
+  // 5. Perform ? RevalidateAtomicAccess(typedArray, byteIndexInBuffer).
+  if (LLVM_UNLIKELY(
+          revalidateAtomicAccess(runtime, self) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // 6-7. If IsSharedArrayBuffer(buffer) is false, return +0.
+  if (!self->getBuffer(runtime)->shared())
+    return HermesValue::encodeTrustedNumberValue(0);
+  // 8-14. Wake up to c waiters on the element, return the number woken up.
+  const void *address =
+      self->data(runtime) + (size_t)index * self->getByteWidth();
+  return HermesValue::encodeTrustedNumberValue(
+      WaiterList::get().notify(address, c));
+}
+
+} // namespace vm
+} // namespace hermes
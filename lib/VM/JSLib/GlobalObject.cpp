@@ -477,6 +477,11 @@ void initGlobalObject(Runtime &runtime, const JSLibFlags &jsLibFlags) {
   runtime.arrayBufferPrototype =
       JSObject::create(runtime, runtime.objectPrototype);
 
+  // "Forward declaration" of SharedArrayBuffer.prototype. Its properties will
+  // be populated later.
+  runtime.sharedArrayBufferPrototype =
+      JSObject::create(runtime, runtime.objectPrototype);
+
   // "Forward declaration" of DataView.prototype. Its properties will be
   // populated later.
   runtime.dataViewPrototype =
@@ -600,6 +605,11 @@ void initGlobalObject(Runtime &runtime, const JSLibFlags &jsLibFlags) {
   runtime.arrayBufferConstructor.castAndSetHermesValue<NativeConstructor>(
       createArrayBufferConstructor(runtime));
 
+  // SharedArrayBuffer constructor.
+  runtime.sharedArrayBufferConstructor
+      .castAndSetHermesValue<NativeConstructor>(
+          createSharedArrayBufferConstructor(runtime));
+
   // DataView constructor.
   runtime.dataViewConstructor.castAndSetHermesValue<NativeConstructor>(
       createDataViewConstructor(runtime));
@@ -686,6 +696,16 @@ void initGlobalObject(Runtime &runtime, const JSLibFlags &jsLibFlags) {
           normalDPF,
           lv.tempHandle));
 
+  // Define the global Atomics object
+  createAtomicsObject(runtime, lv.tempHandle);
+  runtime.ignoreAllocationFailure(
+      JSObject::defineOwnProperty(
+          runtime.getGlobal(),
+          runtime,
+          Predefined::getSymbolID(Predefined::Atomics),
+          normalDPF,
+          lv.tempHandle));
+
   // Define the global JSON object
   createJSONObject(runtime, lv.tempHandle);
   runtime.ignoreAllocationFailure(
@@ -10,6 +10,7 @@
 #include "hermes/BCGen/HBC/BytecodeFileFormat.h"
 #include "hermes/Support/Base64vlq.h"
 #include "hermes/Support/OSCompat.h"
+#include "hermes/Support/UTF8.h"
 #include "hermes/VM/Callable.h"
 #include "hermes/VM/JSArray.h"
 #include "hermes/VM/JSArrayBuffer.h"
@@ -45,6 +46,9 @@ CallResult<HermesValue> hermesInternalDetachArrayBuffer(
         "Cannot use detachArrayBuffer on something which "
         "is not an ArrayBuffer foo");
   }
+  if (buffer->shared()) {
+    return runtime.raiseTypeError("SharedArrayBuffers cannot be detached");
+  }
   JSArrayBuffer::detach(runtime, buffer);
   // "void" return
   return HermesValue::encodeUndefinedValue();
@@ -111,6 +115,10 @@ CallResult<HermesValue> hermesInternalGetInstrumentedStats(
   struct : public Locals {
     PinnedValue<JSObject> resultHandle;
     PinnedValue<JSObject> specificStatsHandle;
+#ifdef HERMESVM_PROPERTY_CACHE_STATS
+    PinnedValue<JSObject> propCacheSitesHandle;
+    PinnedValue<JSObject> propCacheSiteHandle;
+#endif
     PinnedValue<> valHandle;
   } lv;
   LocalsRAII lraii(runtime, &lv);
@@ -174,6 +182,76 @@ CallResult<HermesValue> hermesInternalGetInstrumentedStats(
   ADD_PROP(
       lv.resultHandle, "js_peakLiveAfterGC", info.generalStats.usedAfter.max());
 
+  auto propCacheStats = runtime.getPolyPropCache().getStats();
+  ADD_PROP(
+      lv.resultHandle,
+      "js_propCachePolymorphicSites",
+      propCacheStats.numPolymorphicSites);
+  ADD_PROP(
+      lv.resultHandle,
+      "js_propCacheMegamorphicSites",
+      propCacheStats.numMegamorphicSites);
+  ADD_PROP(lv.resultHandle, "js_propCachePolyHits", propCacheStats.polyHits);
+  ADD_PROP(lv.resultHandle, "js_propCacheMegaHits", propCacheStats.megaHits);
+  ADD_PROP(lv.resultHandle, "js_propCacheMisses", propCacheStats.misses);
+
+#ifdef HERMESVM_PROPERTY_CACHE_STATS
+  // Counters of every GetById/PutById cache entry, keyed by the kind of
+  // access, the property name and the order in which entries were first used,
+  // e.g. "get x #3".
+  lv.propCacheSitesHandle = JSObject::create(runtime);
+  if (LLVM_UNLIKELY(
+          addToResultHandle(
+              lv.resultHandle,
+              "js_propCacheSites",
+              lv.propCacheSitesHandle) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  uint64_t propCacheMonoHits = 0;
+  const auto &propCacheEntryStats =
+      runtime.getPolyPropCache().getAllEntryStats();
+  for (size_t i = 0, e = propCacheEntryStats.size(); i < e; ++i) {
+    const auto &entryStats = propCacheEntryStats[i];
+    propCacheMonoHits += entryStats.monoHits;
+    GCScopeMarkerRAII marker{gcScope};
+    // Property names may not be ASCII, so the key can't go through
+    // addToResultHandle.
+    std::string key = (entryStats.write ? "put " : "get ") + entryStats.name +
+        " #" + std::to_string(i);
+    std::u16string key16;
+    convertUTF8WithSurrogatesToUTF16(
+        std::back_inserter(key16), key.data(), key.data() + key.size());
+    auto keySym = runtime.getIdentifierTable().getSymbolHandle(
+        runtime, UTF16Ref{key16.data(), key16.size()});
+    if (LLVM_UNLIKELY(keySym == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    lv.propCacheSiteHandle = JSObject::create(runtime);
+    if (LLVM_UNLIKELY(
+            JSObject::defineNewOwnProperty(
+                lv.propCacheSitesHandle,
+                runtime,
+                **keySym,
+                PropertyFlags::defaultNewNamedPropertyFlags(),
+                lv.propCacheSiteHandle) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    ADD_PROP(lv.propCacheSiteHandle, "monoHits", entryStats.monoHits);
+    ADD_PROP(lv.propCacheSiteHandle, "polyHits", entryStats.polyHits);
+    ADD_PROP(lv.propCacheSiteHandle, "megaHits", entryStats.megaHits);
+    ADD_PROP(lv.propCacheSiteHandle, "misses", entryStats.misses);
+  }
+  ADD_PROP(lv.resultHandle, "js_propCacheMonoHits", propCacheMonoHits);
+#endif
+
+  const auto &regExpCacheStats = runtime.getRegExpCache().getStats();
+  ADD_PROP(lv.resultHandle, "js_regExpCacheHits", regExpCacheStats.hits);
+  ADD_PROP(lv.resultHandle, "js_regExpCacheMisses", regExpCacheStats.misses);
+  ADD_PROP(
+      lv.resultHandle,
+      "js_regExpCacheEvictions",
+      regExpCacheStats.evictions);
+
 #if HERMESVM_GCKIND == _HERMESVM_GCVALUE_HADES
   lv.specificStatsHandle = JSObject::create(runtime);
   auto res = addToResultHandle(
@@ -199,6 +277,14 @@ CallResult<HermesValue> hermesInternalGetInstrumentedStats(
       lv.specificStatsHandle,
       "js_numLargeObjectBytes",
       info.allocatedLargeObjectBytes);
+  ADD_PROP(
+      lv.specificStatsHandle,
+      "js_numOGAllocations",
+      info.numOldGenAllocations);
+  ADD_PROP(
+      lv.specificStatsHandle,
+      "js_numOGAllocChunkRefills",
+      info.numOldGenAllocChunkRefills);
 #endif
 #undef ADD_PROP
 
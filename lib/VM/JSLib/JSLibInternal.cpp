@@ -272,6 +272,7 @@ static bool isReturnThis(Handle<StringPrimitive> str, Runtime &runtime) {
   // Regex match for variants.
   auto input = StringPrimitive::createStringView(runtime, str);
   static auto bytecode = getReturnThisRegexBytecode();
+  static const regex::SearchAnalysis analysis{bytecode, false};
   auto result = regex::MatchRuntimeResult::NoMatch;
   if (input.isASCII()) {
     const char *begin = input.castToCharPtr();
@@ -282,6 +283,7 @@ static bool isReturnThis(Handle<StringPrimitive> str, Runtime &runtime) {
         input.length(),
         nullptr,
         regex::constants::matchDefault | regex::constants::matchInputAllAscii,
+        &analysis,
         runtime.getOverflowGuardForRegex());
   } else {
     const char16_t *begin = input.castToChar16Ptr();
@@ -292,6 +294,7 @@ static bool isReturnThis(Handle<StringPrimitive> str, Runtime &runtime) {
         input.length(),
         nullptr,
         regex::constants::matchDefault,
+        &analysis,
         runtime.getOverflowGuardForRegex());
   }
   return result == regex::MatchRuntimeResult::Match;
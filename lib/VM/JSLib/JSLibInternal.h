@@ -240,6 +240,10 @@ Handle<JSObject> createDebuggerInternalObject(Runtime &runtime);
 
 #endif // HERMES_ENABLE_DEBUGGER
 
+/// Create and initialize the global Atomics object, populating its function
+/// properties.
+void createAtomicsObject(Runtime &runtime, MutableHandle<JSObject> result);
+
 /// Create and initialize the global JSON object, populating its value
 /// and function properties.
 void createJSONObject(Runtime &runtime, MutableHandle<JSObject> result);
@@ -324,6 +328,8 @@ HermesValue createArrayConstructor(Runtime &runtime);
 
 HermesValue createArrayBufferConstructor(Runtime &runtime);
 
+HermesValue createSharedArrayBufferConstructor(Runtime &runtime);
+
 HermesValue createDataViewConstructor(Runtime &runtime);
 
 HermesValue createTypedArrayBaseConstructor(Runtime &runtime);
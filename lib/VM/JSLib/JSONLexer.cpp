@@ -67,6 +67,27 @@ static const constexpr JSONTokenKind TOKEN_TABLE[256] = {
 #undef TABLE_ELEMENT
 };
 
+/// \return the first character in [start, end) that ends a run of plain string
+/// contents: '"', '\\' or a control character.
+static inline const char *scanStringRun(const char *start, const char *end) {
+  return scanJsonEscapeU8(start, end);
+}
+static inline const char16_t *scanStringRun(
+    const char16_t *start,
+    const char16_t *end) {
+  return scanJsonEscapeU16(start, end);
+}
+
+/// \return the first character in [start, end) that is not whitespace.
+static inline const char *skipWhitespace(const char *start, const char *end) {
+  return scanJsonNonWhitespaceU8(start, end);
+}
+static inline const char16_t *skipWhitespace(
+    const char16_t *start,
+    const char16_t *end) {
+  return scanJsonNonWhitespaceU16(start, end);
+}
+
 template <EncodingKind Kind>
 ExecutionStatus JSONLexer<Kind>::advance() {
   auto res = advanceHelper<StrAsValue>();
@@ -110,6 +131,10 @@ ExecutionStatus JSONLexer<Kind>::advanceHelper() {
     curKind = TOKEN_TABLE[(uint8_t)curVal];
     if (curKind == JSONTokenKind::Whitespace) {
       ++iter_.cur;
+      // Skip the rest of the run (e.g. indentation) in bulk.
+      if constexpr (Traits::UsesRawPtr) {
+        iter_.cur = skipWhitespace(iter_.cur, iter_.end);
+      }
     } else {
       break;
     }
@@ -268,12 +293,7 @@ ExecutionStatus JSONLexer<Kind>::scanString() {
 
     // SIMD fast scan: skip over runs of normal characters in bulk.
     if constexpr (Traits::UsesRawPtr) {
-      const CharT *scanEnd;
-      if constexpr (sizeof(CharT) == 1)
-        scanEnd = scanJsonEscapeU8(iter_.cur, iter_.end);
-      else
-        scanEnd = scanJsonEscapeU16(iter_.cur, iter_.end);
-
+      const CharT *scanEnd = scanStringRun(iter_.cur, iter_.end);
       if (scanEnd > iter_.cur) {
         if constexpr (ForKey::value) {
           for (const CharT *p = iter_.cur; p < scanEnd; ++p)
@@ -340,6 +360,22 @@ ExecutionStatus JSONLexer<Kind>::scanString() {
     if (LLVM_UNLIKELY(!hasChar())) {
       return error("Unexpected end of input");
     }
+
+    // SIMD fast scan: copy runs of normal characters between escapes in bulk.
+    if constexpr (Traits::UsesRawPtr) {
+      const CharT *scanEnd = scanStringRun(iter_.cur, iter_.end);
+      if (scanEnd > iter_.cur) {
+        escapedStr.append(iter_.cur, scanEnd);
+        if constexpr (ForKey::value) {
+          for (const CharT *p = iter_.cur; p < scanEnd; ++p)
+            hash = hermes::updateJenkinsHash(hash, *p);
+        }
+        iter_.cur = scanEnd;
+        if (!hasChar())
+          return error("Unexpected end of input");
+      }
+    }
+
     CharT curVal = *iter_.cur;
     if (curVal == '"') {
       // Reached the end of string.
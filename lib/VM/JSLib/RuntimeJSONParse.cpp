@@ -10,6 +10,7 @@
 #include "Object.h"
 
 #include "hermes/Support/UTF16Stream.h"
+#include "hermes/Support/UTF8.h"
 #include "hermes/VM/ArrayLike.h"
 #include "hermes/VM/ArrayStorage.h"
 #include "hermes/VM/Callable.h"
@@ -728,5 +729,20 @@ CallResult<HermesValue> runtimeJSONParseRef(
   return parser.parse();
 }
 
+CallResult<HermesValue> runtimeJSONParseUTF8(
+    Runtime &runtime,
+    llvh::ArrayRef<uint8_t> utf8) {
+  // Most JSON payloads are pure ASCII, which is also valid UTF-8, so the
+  // buffer can be handed to the ASCII lexer as is. This is a single fast scan
+  // and avoids running every byte through the UTF-8 decoder.
+  if (isAllASCII(utf8.begin(), utf8.end())) {
+    ASCIIRef ref{reinterpret_cast<const char *>(utf8.data()), utf8.size()};
+    RuntimeJSONParser<EncodingKind::ASCII> parser{
+        runtime, ref, Runtime::makeNullHandle<Callable>()};
+    return parser.parse();
+  }
+  return runtimeJSONParseRef(runtime, UTF16Stream(utf8));
+}
+
 } // namespace vm
 } // namespace hermes
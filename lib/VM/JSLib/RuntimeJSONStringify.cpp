@@ -11,6 +11,7 @@
 
 #include "hermes/Support/BuildTable256.h"
 #include "hermes/Support/FastArraySearch.h"
+#include "hermes/Support/UTF8.h"
 #include "hermes/VM/ArrayLike.h"
 #include "hermes/VM/ArrayStorage.h"
 #include "hermes/VM/Callable.h"
@@ -87,6 +88,22 @@ class JSONStringifyer {
   /// The output buffer. The serialization process will append into it.
   llvh::SmallVector<char16_t, 32> output_{};
 
+  /// If set, output_ is passed to this sink whenever it grows past
+  /// chunkSize_, instead of being accumulated into a single string.
+  const JSONStringifySink *sink_{nullptr};
+
+  /// The number of UTF-8 bytes to accumulate in output_ before flushing it to
+  /// sink_.
+  size_t chunkSize_{0};
+
+  /// The size in UTF-8 of output_[0, utf8Counted_), maintained by
+  /// utf8OutputSize() so that each character is only measured once.
+  size_t utf8Size_{0};
+  size_t utf8Counted_{0};
+
+  /// Scratch space for converting output_ to UTF-8 for sink_.
+  std::string utf8Output_{};
+
  public:
   explicit JSONStringifyer(Runtime &runtime)
       : runtime_(runtime), lraii_(runtime, &lv_) {
@@ -109,6 +126,14 @@ class JSONStringifyer {
   /// Stringify \p value.
   CallResult<HermesValue> stringify(Handle<> value);
 
+  /// Stringify \p value, passing the output to \p sink in chunks of about
+  /// \p chunkSize characters.
+  /// \return whether the result is not undefined.
+  CallResult<bool> stringifyToSink(
+      Handle<> value,
+      const JSONStringifySink &sink,
+      size_t chunkSize);
+
  private:
   /// Check the type of replacer, initialize
   /// ReplacerFunction (lv_.replacerFunction) and PropertyList
@@ -196,6 +221,28 @@ class JSONStringifyer {
 
   /// Append the string indicated as \p str to output_.
   void appendToOutput(const StringPrimitive *str);
+
+  /// Serialize \p value into output_, implementing steps 9 to 11 in ES5.1
+  /// 15.12.3.
+  /// \return whether the result is not undefined.
+  CallResult<bool> serialize(Handle<> value);
+
+  /// If output_ is streamed to a sink and has reached the chunk size, flush
+  /// it. Must only be called when nothing in output_ can be rolled back, i.e.
+  /// right after an array element or object property has been committed.
+  void maybeFlush() {
+    // Each UTF-16 unit takes at most 3 bytes in UTF-8, so only measure output_
+    // once it might have reached the chunk size.
+    if (LLVM_UNLIKELY(sink_ != nullptr) && output_.size() * 3 >= chunkSize_ &&
+        utf8OutputSize() >= chunkSize_)
+      flush();
+  }
+
+  /// \return the size of output_ once converted to UTF-8.
+  size_t utf8OutputSize();
+
+  /// Pass the contents of output_ to sink_ and clear it.
+  void flush();
 };
 } // namespace
 
@@ -269,7 +316,7 @@ ExecutionStatus JSONStringifyer::initializeReplacer(Handle<> replacer) {
     for (uint32_t i = 0; i < len; ++i) {
       if (lv_.propertyList->at(runtime_, i)
               .getString(runtime_)
-              ->equals(lv_.tmpHandle->getString())) {
+              ->equals(runtime_, lv_.tmpHandle->getString())) {
         exists = true;
         break;
       }
@@ -779,6 +826,7 @@ ExecutionStatus JSONStringifyer::operationJA() {
         // operationStr returns undefined, we need to replace with null.
         appendToOutput(Predefined::getSymbolID(Predefined::null));
       }
+      maybeFlush();
     }
   }
 
@@ -803,6 +851,7 @@ ExecutionStatus JSONStringifyer::operationJA() {
       // operationStr returns undefined, we need to replace with null.
       appendToOutput(Predefined::getSymbolID(Predefined::null));
     }
+    maybeFlush();
   }
   depthCount_ = stepBack;
 
@@ -1036,6 +1085,9 @@ ExecutionStatus JSONStringifyer::operationJOProcessProperties(
       output_.resize(savedLocation);
     } else {
       hasElement = true;
+      // Once an element is committed, neither savedLocation nor beginningLoc
+      // will be rolled back to, so the output can be flushed.
+      maybeFlush();
     }
   }
 
@@ -1092,7 +1144,61 @@ void JSONStringifyer::appendToOutput(const StringPrimitive *str) {
   str->appendUTF16String(output_);
 }
 
+size_t JSONStringifyer::utf8OutputSize() {
+  // Output may have been rolled back since the last call.
+  if (utf8Counted_ > output_.size())
+    utf8Counted_ = utf8Size_ = 0;
+  for (size_t e = output_.size(); utf8Counted_ != e; ++utf8Counted_) {
+    char16_t c = output_[utf8Counted_];
+    // Lone surrogates are escaped by serialization, so surrogates only appear
+    // in pairs, which take 4 bytes together.
+    if (c < 0x80)
+      utf8Size_ += 1;
+    else if (c < 0x800 || isHighSurrogate(c) || isLowSurrogate(c))
+      utf8Size_ += 2;
+    else
+      utf8Size_ += 3;
+  }
+  return utf8Size_;
+}
+
+void JSONStringifyer::flush() {
+  assert(sink_ && "Flushing without a sink");
+  convertUTF16ToUTF8WithReplacements(utf8Output_, output_);
+  (*sink_)(utf8Output_);
+  output_.clear();
+  utf8Counted_ = utf8Size_ = 0;
+}
+
 CallResult<HermesValue> JSONStringifyer::stringify(Handle<> value) {
+  auto status = serialize(value);
+  if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (status.getValue()) {
+    return StringPrimitive::create(runtime_, output_);
+  } else {
+    return HermesValue::encodeUndefinedValue();
+  }
+}
+
+CallResult<bool> JSONStringifyer::stringifyToSink(
+    Handle<> value,
+    const JSONStringifySink &sink,
+    size_t chunkSize) {
+  sink_ = &sink;
+  chunkSize_ = chunkSize;
+  auto status = serialize(value);
+  if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (status.getValue() && !output_.empty()) {
+    flush();
+  }
+  return status;
+}
+
+CallResult<bool> JSONStringifyer::serialize(Handle<> value) {
   // All previous steps have been covered by the constructor.
   // Clear the output buffer.
   output_.clear();
@@ -1111,17 +1217,9 @@ CallResult<HermesValue> JSONStringifyer::stringify(Handle<> value) {
   (void)status;
 
   // Step 11 in ES5.1 15.12.3.
-  status = operationStr(
+  return operationStr(
       HermesValue::encodeStringValue(
           runtime_.getPredefinedString(Predefined::emptyString)));
-  if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  if (status.getValue()) {
-    return StringPrimitive::create(runtime_, output_);
-  } else {
-    return HermesValue::encodeUndefinedValue();
-  }
 }
 
 CallResult<HermesValue> runtimeJSONStringify(
@@ -1138,5 +1236,21 @@ CallResult<HermesValue> runtimeJSONStringify(
   return stringifyer.stringify(value);
 }
 
+CallResult<bool> runtimeJSONStringifyToSink(
+    Runtime &runtime,
+    Handle<> value,
+    Handle<> replacer,
+    Handle<> space,
+    JSONStringifySink sink,
+    size_t chunkSize) {
+  GCScope gcScope{runtime, "runtimeJSONStringifyToSink"};
+
+  JSONStringifyer stringifyer{runtime};
+  if (stringifyer.init(replacer, space) == ExecutionStatus::EXCEPTION) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return stringifyer.stringifyToSink(value, sink, chunkSize);
+}
+
 } // namespace vm
 } // namespace hermes
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+//===----------------------------------------------------------------------===//
+/// \file
+/// ES2024 25.2 SharedArrayBuffer
+///
+/// SharedArrayBuffers are JSArrayBuffers whose data block is reference counted
+/// outside of the GC heap, so that it can be shared by all runtimes in the
+/// process that the buffer is structured-cloned into (e.g. Workers).
+//===----------------------------------------------------------------------===//
+#include "JSLibInternal.h"
+
+#include "hermes/VM/JSArrayBuffer.h"
+#include "hermes/VM/Operations.h"
+#include "hermes/VM/StringPrimitive.h"
+
+namespace hermes {
+namespace vm {
+
+using std::max;
+using std::min;
+
+/// @name Implementation
+/// @{
+
+HermesValue createSharedArrayBufferConstructor(Runtime &runtime) {
+  auto sharedArrayBufferPrototype =
+      Handle<JSObject>::vmcast(&runtime.sharedArrayBufferPrototype);
+
+  struct : public Locals {
+    PinnedValue<NativeConstructor> cons;
+  } lv;
+  LocalsRAII lraii(runtime, &lv);
+
+  defineSystemConstructor(
+      runtime,
+      Predefined::getSymbolID(Predefined::SharedArrayBuffer),
+      sharedArrayBufferConstructor,
+      sharedArrayBufferPrototype,
+      1,
+      lv.cons);
+
+  // SharedArrayBuffer.prototype.xxx() methods.
+  defineAccessor(
+      runtime,
+      sharedArrayBufferPrototype,
+      Predefined::getSymbolID(Predefined::byteLength),
+      nullptr,
+      sharedArrayBufferPrototypeByteLength,
+      nullptr,
+      false,
+      true);
+  defineMethod(
+      runtime,
+      sharedArrayBufferPrototype,
+      Predefined::getSymbolID(Predefined::slice),
+      nullptr,
+      sharedArrayBufferPrototypeSlice,
+      2);
+
+  auto dpf = DefinePropertyFlags::getDefaultNewPropertyFlags();
+  dpf.writable = 0;
+  dpf.enumerable = 0;
+  defineProperty(
+      runtime,
+      sharedArrayBufferPrototype,
+      Predefined::getSymbolID(Predefined::SymbolToStringTag),
+      runtime.getPredefinedStringHandle(Predefined::SharedArrayBuffer),
+      dpf);
+
+  return lv.cons.getHermesValue();
+}
+
+CallResult<HermesValue> sharedArrayBufferConstructor(void *, Runtime &runtime) {
+  NativeArgs args = runtime.getCurrentFrame().getNativeArgs();
+  // 1. If NewTarget is undefined, throw a TypeError exception.
+  if (!args.isConstructorCall()) {
+    return runtime.raiseTypeError(
+        "SharedArrayBuffer() called in function context instead of "
+        "constructor");
+  }
+  struct : public Locals {
+    PinnedValue<JSObject> selfParent;
+    PinnedValue<JSArrayBuffer> self;
+  } lv;
+  LocalsRAII lraii(runtime, &lv);
+  if (LLVM_LIKELY(
+          args.getNewTarget().getRaw() ==
+          runtime.sharedArrayBufferConstructor.getHermesValue().getRaw())) {
+    lv.selfParent = runtime.sharedArrayBufferPrototype;
+  } else {
+    CallResult<PseudoHandle<JSObject>> thisParentRes =
+        NativeConstructor::parentForNewThis_RJS(
+            runtime,
+            Handle<Callable>::vmcast(&args.getNewTarget()),
+            runtime.sharedArrayBufferPrototype);
+    if (LLVM_UNLIKELY(thisParentRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    lv.selfParent = std::move(*thisParentRes);
+  }
+  lv.self = JSArrayBuffer::create(runtime, lv.selfParent);
+
+  // 2. Let byteLength be ? ToIndex(length).
+  auto res = toIndex(runtime, args.getArgHandle(0));
+  if (res == ExecutionStatus::EXCEPTION) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  uint64_t byteLength = res->getNumberAs<uint64_t>();
+
+  // 3. Let requestedMaxByteLength be ? GetArrayBufferMaxByteLengthOption(
+  // options).
+  // Growable SharedArrayBuffers are not supported, options are ignored.
+  // 4. Return ? AllocateSharedArrayBuffer(NewTarget, byteLength,
+  // requestedMaxByteLength).
+  if (byteLength > std::numeric_limits<JSArrayBuffer::size_type>::max()) {
+    return runtime.raiseRangeError("Too large of a byteLength requested");
+  }
+  if (JSArrayBuffer::createSharedDataBlock(runtime, lv.self, byteLength) ==
+      ExecutionStatus::EXCEPTION) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return lv.self.getHermesValue();
+}
+
+CallResult<HermesValue> sharedArrayBufferPrototypeByteLength(
+    void *,
+    Runtime &runtime) {
+  NativeArgs args = runtime.getCurrentFrame().getNativeArgs();
+  auto self = args.dyncastThis<JSArrayBuffer>();
+  if (!self || !self->shared()) {
+    return runtime.raiseTypeError(
+        "byteLength called on a non SharedArrayBuffer object");
+  }
+  return HermesValue::encodeTrustedNumberValue(self->size());
+}
+
+CallResult<HermesValue> sharedArrayBufferPrototypeSlice(
+    void *,
+    Runtime &runtime) {
+  NativeArgs args = runtime.getCurrentFrame().getNativeArgs();
+  auto start = args.getArgHandle(0);
+  auto end = args.getArgHandle(1);
+  // 1. Let O be the this value.
+  // 2. Perform ? RequireInternalSlot(O, [[ArrayBufferData]]).
+  // 3. If IsSharedArrayBuffer(O) is false, throw a TypeError exception.
+  auto self = args.dyncastThis<JSArrayBuffer>();
+  if (!self || !self->shared()) {
+    return runtime.raiseTypeError(
+        "Called SharedArrayBuffer.prototype.slice on a non-SharedArrayBuffer");
+  }
+
+  struct : public Locals {
+    PinnedValue<JSArrayBuffer> newBuf;
+  } lv;
+  LocalsRAII lraii(runtime, &lv);
+
+  // 4. Let len be ArrayBufferByteLength(O, seq-cst).
+  double len = self->size();
+  // 5. Let relativeStart be ? ToIntegerOrInfinity(start).
+  auto intRes = toIntegerOrInfinity(runtime, start);
+  if (intRes == ExecutionStatus::EXCEPTION) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  double relativeStart = intRes->getNumber();
+  // 6-8. Clamp relativeStart to [0, len].
+  double first = relativeStart < 0 ? max(len + relativeStart, 0.0)
+                                   : min(relativeStart, len);
+  // 9. If end is undefined, let relativeEnd be len; else let relativeEnd be ?
+  // ToIntegerOrInfinity(end).
+  double relativeEnd;
+  if (end->isUndefined()) {
+    relativeEnd = len;
+  } else {
+    intRes = toIntegerOrInfinity(runtime, end);
+    if (intRes == ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    relativeEnd = intRes->getNumber();
+  }
+  // 10-12. Clamp relativeEnd to [0, len].
+  double finale =
+      relativeEnd < 0 ? max(len + relativeEnd, 0.0) : min(relativeEnd, len);
+  // 13. Let newLen be max(final - first, 0).
+  double newLen = max(finale - first, 0.0);
+  JSArrayBuffer::size_type first_int = first;
+  JSArrayBuffer::size_type newLen_int = newLen;
+  // 14. Let ctor be ? SpeciesConstructor(O, %SharedArrayBuffer%).
+  // 15. Let new be ? Construct(ctor, « newLen »).
+  // Like ArrayBuffer.prototype.slice, species constructors are not supported.
+  lv.newBuf.castAndSetHermesValue<JSArrayBuffer>(
+      JSArrayBuffer::create(
+          runtime,
+          Handle<JSObject>::vmcast(&runtime.sharedArrayBufferPrototype))
+          .getHermesValue());
+  if (JSArrayBuffer::createSharedDataBlock(runtime, lv.newBuf, newLen_int) ==
+      ExecutionStatus::EXCEPTION) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // 16-21. Checks on new that cannot fail without species constructors.
+  // 22-24. Copy the bytes. Other agents may be writing to the source block
+  // concurrently, which gives unordered results but is not a data race on the
+  // destination.
+  JSArrayBuffer::copyDataBlockBytes(
+      runtime, *lv.newBuf, 0, *self, first_int, newLen_int);
+  // 25. Return new.
+  return lv.newBuf.getHermesValue();
+}
+/// @}
+} // namespace vm
+} // namespace hermes
@@ -9,7 +9,7 @@
 
 #include "hermes/Support/Compiler.h"
 
-#include "llvh/Support/MathExtras.h"
+#include "llvh/ADT/SmallVector.h"
 
 #include <algorithm>
 #include <vector>
@@ -21,324 +21,442 @@ SortModel::~SortModel() = default;
 
 namespace {
 
-/// Helper function to make sort algorithm stable
-/// If [i] < [j], return true
-/// If [j] < [i], return false
-/// If [i] == [j], compare their original index
-CallResult<bool> _less(
-    SortModel *sm,
-    const std::vector<uint32_t> &index,
-    uint32_t i,
-    uint32_t j) {
-  auto res = sm->compare(i, j);
-  if (res == ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
+/// Runs shorter than this are extended with binary insertion sort.
+constexpr uint32_t MIN_MERGE = 32;
+
+/// Initial number of consecutive wins of one run that switches a merge to
+/// galloping mode.
+constexpr uint32_t MIN_GALLOP = 7;
+
+/// \return the minimum run length for an array of \p n elements: n itself
+/// if it is small, otherwise a number in [MIN_MERGE / 2, MIN_MERGE] such
+/// that n / minRun is close to, but not above, a power of two.
+uint32_t minRunLength(uint32_t n) {
+  uint32_t r = 0;
+  while (n >= MIN_MERGE) {
+    r |= n & 1;
+    n >>= 1;
   }
-  assert(i < index.size() && "OOB should be impossible");
-  assert(j < index.size() && "OOB should be impossible");
-  return (*res != 0) ? (*res < 0) : (index[i] < index[j]);
+  return n + r;
 }
 
-/// Helper function to swap both items and their indices
-ExecutionStatus
-_swap(SortModel *sm, std::vector<uint32_t> &index, uint32_t i, uint32_t j) {
-  if (sm->swap(i, j) == ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  assert(i < index.size() && "OOB should be impossible");
-  assert(j < index.size() && "OOB should be impossible");
-  std::swap(index[i], index[j]);
-  return ExecutionStatus::RETURNED;
-}
-
-/**
- * @param base the beginning of the logical array
- */
-LLVM_NODISCARD ExecutionStatus heapFixDown(
-    SortModel *sm,
-    std::vector<uint32_t> &index,
-    uint32_t base,
-    uint32_t begin,
-    uint32_t end) {
-  CallResult<bool> res{false};
-  if (LLVM_UNLIKELY(end - begin <= 1)) {
-    return ExecutionStatus::RETURNED;
-  }
-
-  uint32_t lastGood = base + (end - base - 2) / 2;
-  uint32_t i = begin;
-
-  while (i <= lastGood) {
-    uint32_t j = (i - base) * 2 + 1 + base;
-    // Find the greater of the two children
-    if (j + 1 < end) {
-      res = _less(sm, index, j, j + 1);
-      if (res == ExecutionStatus::EXCEPTION) {
+/// TimSort over a permutation of element indices. Comparisons are done with
+/// \p Less, a callable taking two elements of the permutation and returning
+/// CallResult<bool>, which is true if the first one must come before the
+/// second. Since only the permutation is reordered, the elements themselves
+/// never move during the sort. The algorithm follows the one described in
+/// Python's listsort.txt, with the run stack invariants fixed as in the
+/// "OpenJDK's java.utils.Collection.sort() is broken" paper.
+///
+/// Every step only moves entries of the permutation within their bounds, so
+/// an inconsistent comparison can produce an arbitrary order but always
+/// terminates and yields a permutation.
+template <typename Less>
+class TimSorter {
+ public:
+  TimSorter(llvh::MutableArrayRef<uint32_t> perm, Less less)
+      : a_(perm), less_(less) {}
+
+  ExecutionStatus sort() {
+    uint32_t n = a_.size();
+    if (n < 2)
+      return ExecutionStatus::RETURNED;
+
+    uint32_t minRun = minRunLength(n);
+    for (uint32_t lo = 0; lo < n;) {
+      auto runRes = countRunAndMakeAscending(lo, n);
+      if (LLVM_UNLIKELY(runRes == ExecutionStatus::EXCEPTION))
         return ExecutionStatus::EXCEPTION;
+      uint32_t runLen = *runRes;
+
+      // Extend short runs to min(minRun, remaining).
+      if (runLen < minRun) {
+        uint32_t force = std::min(minRun, n - lo);
+        if (LLVM_UNLIKELY(
+                binaryInsertionSort(lo, lo + force, lo + runLen) ==
+                ExecutionStatus::EXCEPTION))
+          return ExecutionStatus::EXCEPTION;
+        runLen = force;
       }
-      if (*res) {
-        ++j;
-      }
-    }
-    // If the child is greater than us, exchange places
-    res = _less(sm, index, i, j);
-    if (res == ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
-    if (!*res) {
-      break;
-    }
 
-    if (_swap(sm, index, i, j) == ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
+      runs_.push_back({lo, runLen});
+      if (LLVM_UNLIKELY(mergeCollapse() == ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+      lo += runLen;
     }
-    i = j;
-  }
 
-  return ExecutionStatus::RETURNED;
-}
-
-ExecutionStatus heapSort(
-    SortModel *sm,
-    std::vector<uint32_t> &index,
-    uint32_t begin,
-    uint32_t end) {
-  if (LLVM_UNLIKELY(end - begin <= 1)) {
+    // Merge the remaining runs.
+    while (runs_.size() > 1) {
+      size_t i = runs_.size() - 2;
+      if (i > 0 && runs_[i - 1].len < runs_[i + 1].len)
+        --i;
+      if (LLVM_UNLIKELY(mergeAt(i) == ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+    }
+    assert(runs_.size() == 1 && runs_[0].len == n && "incomplete sort");
     return ExecutionStatus::RETURNED;
   }
 
-  // "heapify"
-  uint32_t start = (end - begin - 2) / 2 + begin;
-  do {
-    if (heapFixDown(sm, index, begin, start, end) ==
-        ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
-  } while (start-- != begin);
-
-  while (end - begin > 1) {
-    --end;
-    if (_swap(sm, index, begin, end) == ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
-    if (heapFixDown(sm, index, begin, begin, end) ==
-        ExecutionStatus::EXCEPTION) {
+ private:
+  /// A sorted run of the permutation.
+  struct Run {
+    uint32_t base;
+    uint32_t len;
+  };
+
+  /// The permutation being sorted.
+  llvh::MutableArrayRef<uint32_t> a_;
+  /// The comparison.
+  Less less_;
+  /// The pending runs, which are adjacent and in order.
+  llvh::SmallVector<Run, 40> runs_{};
+  /// Temporary copy of the left run during a merge.
+  std::vector<uint32_t> tmp_{};
+  /// Number of consecutive wins needed to enter galloping mode. It adapts to
+  /// whether galloping pays off on the data.
+  uint32_t minGallop_ = MIN_GALLOP;
+
+  /// Find the length of the run starting at \p lo, ending before \p hi. If
+  /// the run is strictly descending, reverse it, so that it stays stable.
+  CallResult<uint32_t> countRunAndMakeAscending(uint32_t lo, uint32_t hi) {
+    uint32_t runHi = lo + 1;
+    if (runHi == hi)
+      return 1;
+
+    auto res = less_(a_[runHi], a_[lo]);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
       return ExecutionStatus::EXCEPTION;
+    ++runHi;
+    if (*res) {
+      while (runHi < hi) {
+        res = less_(a_[runHi], a_[runHi - 1]);
+        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+          return ExecutionStatus::EXCEPTION;
+        if (!*res)
+          break;
+        ++runHi;
+      }
+      std::reverse(a_.begin() + lo, a_.begin() + runHi);
+    } else {
+      while (runHi < hi) {
+        res = less_(a_[runHi], a_[runHi - 1]);
+        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+          return ExecutionStatus::EXCEPTION;
+        if (*res)
+          break;
+        ++runHi;
+      }
     }
+    return runHi - lo;
   }
 
-  return ExecutionStatus::RETURNED;
-}
-
-ExecutionStatus insertionSort(
-    SortModel *sm,
-    std::vector<uint32_t> &index,
-    uint32_t begin,
-    uint32_t end) {
-  CallResult<bool> res{false};
-  if (begin == end) {
+  /// Sort [lo, hi), where [lo, start) is already sorted, by inserting each
+  /// following element at the position found by binary search.
+  ExecutionStatus
+  binaryInsertionSort(uint32_t lo, uint32_t hi, uint32_t start) {
+    for (; start < hi; ++start) {
+      uint32_t pivot = a_[start];
+      uint32_t left = lo;
+      uint32_t right = start;
+      // Insert after equal elements, for stability.
+      while (left < right) {
+        uint32_t mid = left + (right - left) / 2;
+        auto res = less_(pivot, a_[mid]);
+        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+          return ExecutionStatus::EXCEPTION;
+        if (*res)
+          right = mid;
+        else
+          left = mid + 1;
+      }
+      std::copy_backward(
+          a_.begin() + left, a_.begin() + start, a_.begin() + start + 1);
+      a_[left] = pivot;
+    }
     return ExecutionStatus::RETURNED;
   }
 
-  for (uint32_t i = begin + 1; i != end; ++i) {
-    for (uint32_t j = i; j != begin; --j) {
-      res = _less(sm, index, j, j - 1);
-      if (res == ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      if (!*res) {
+  /// Merge runs until the stack satisfies the invariants
+  /// len[i - 2] > len[i - 1] + len[i] and len[i - 1] > len[i], which bound
+  /// its depth by log(n).
+  ExecutionStatus mergeCollapse() {
+    while (runs_.size() > 1) {
+      size_t n = runs_.size() - 2;
+      if ((n > 0 && runs_[n - 1].len <= runs_[n].len + runs_[n + 1].len) ||
+          (n > 1 && runs_[n - 2].len <= runs_[n - 1].len + runs_[n].len)) {
+        if (runs_[n - 1].len < runs_[n + 1].len)
+          --n;
+      } else if (runs_[n].len > runs_[n + 1].len) {
         break;
       }
-      if (_swap(sm, index, j, j - 1) == ExecutionStatus::EXCEPTION) {
+      if (LLVM_UNLIKELY(mergeAt(n) == ExecutionStatus::EXCEPTION))
         return ExecutionStatus::EXCEPTION;
-      }
     }
+    return ExecutionStatus::RETURNED;
   }
-  return ExecutionStatus::RETURNED;
-}
-
-// Must be at lest 3, for "median of three" to work
-const uint32_t INSERTION_THRESHOLD = 6;
-
-/// Performs the partition for quickSort between elements [l,r].
-/// Pre-condition: [l] <= [l+1] <= [r] and [l+1] is the pivot.
-/// This routine is guaranteed to complete even with an inconsistent comparison
-/// routine because it always makes forward progress and doesn't rely on
-/// sentinels.
-/// \return the new index of the pivot.
-CallResult<uint32_t> quickSortPartition(
-    SortModel *sm,
-    std::vector<uint32_t> &index,
-    uint32_t l,
-    uint32_t r) {
-  CallResult<bool> res{false};
-  // Now [l] <= [l+1] <= [r]
-  // [l+1] is our pivot.
-  uint32_t pivot = l + 1;
-
-  uint32_t i = pivot + 1, j = r;
-  for (;;) {
-    for (; i <= j; ++i) {
-      res = _less(sm, index, i, pivot);
-      if (res == ExecutionStatus::EXCEPTION)
-        return ExecutionStatus::EXCEPTION;
-      if (!*res)
-        break;
-    }
-    assert(i <= r + 1 && "i is out of range");
-
-    for (; i <= j; --j) {
-      res = _less(sm, index, pivot, j);
-      if (res == ExecutionStatus::EXCEPTION)
-        return ExecutionStatus::EXCEPTION;
-      if (!*res)
-        break;
-    }
-    assert(j > l && "j is out of range");
 
-    if (i >= j)
-      break;
-    if (_swap(sm, index, i, j) == ExecutionStatus::EXCEPTION)
+  /// Merge the runs at positions \p i and i + 1 of the stack.
+  ExecutionStatus mergeAt(size_t i) {
+    uint32_t base1 = runs_[i].base;
+    uint32_t len1 = runs_[i].len;
+    uint32_t base2 = runs_[i + 1].base;
+    uint32_t len2 = runs_[i + 1].len;
+    assert(base1 + len1 == base2 && "runs must be adjacent");
+
+    runs_[i].len = len1 + len2;
+    runs_.erase(runs_.begin() + i + 1);
+
+    // Elements of the left run that go before the first element of the right
+    // run are already in place.
+    auto res = gallopRight(a_[base2], &a_[base1], len1, 0);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
       return ExecutionStatus::EXCEPTION;
-    ++i;
-    --j;
-  }
-
-  // [j] <= [pivot], we can put the pivot in its final position
-  if (j != pivot) {
-    if (_swap(sm, index, pivot, j) == ExecutionStatus::EXCEPTION)
+    base1 += *res;
+    len1 -= *res;
+    if (len1 == 0)
+      return ExecutionStatus::RETURNED;
+
+    // So are the elements of the right run that go after the last element of
+    // the left run.
+    res = gallopLeft(a_[base1 + len1 - 1], &a_[base2], len2, len2 - 1);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
       return ExecutionStatus::EXCEPTION;
-  }
-
-  return j;
-}
+    len2 = *res;
+    if (len2 == 0)
+      return ExecutionStatus::RETURNED;
 
-ExecutionStatus doQuickSort(
-    SortModel *sm,
-    std::vector<uint32_t> &index,
-    int limit,
-    uint32_t l,
-    uint32_t r) {
-  CallResult<bool> res{false};
-quicksort_top:
-  if (limit <= 0) {
-    // Bail to heap sort
-    return heapSort(sm, index, l, r + 1);
+    return mergeLo(base1, len1, base2, len2);
   }
 
-  // Median-of-three
-  // Place the middle element at [l+1]
-  if (_swap(sm, index, l + 1, l + ((r - l) >> 1)) ==
-      ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  // Sort, [l], [l+1], [r]
-  res = _less(sm, index, r, l + 1);
-  if (res == ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  if (*res) {
-    if (_swap(sm, index, r, l + 1) == ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
-  }
-  res = _less(sm, index, l + 1, l);
-  if (res == ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  if (*res) {
-    if (_swap(sm, index, l + 1, l) == ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
-  }
-  res = _less(sm, index, r, l + 1);
-  if (res == ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  if (*res) {
-    if (_swap(sm, index, r, l + 1) == ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
-    }
+  /// Locate the position at which to insert \p key in the sorted range \p
+  /// range of length \p len, before any equal elements. The search starts
+  /// from \p hint, and gallops away from it in exponentially growing steps.
+  /// \return k such that range[k - 1] < key <= range[k].
+  CallResult<uint32_t> gallopLeft(
+      uint32_t key,
+      const uint32_t *range,
+      uint32_t len,
+      uint32_t hint) {
+    return gallop</* right */ false>(key, range, len, hint);
   }
 
-  // Now [l] <= [l+1] <= [r]
-  // [l+1] is our pivot and [r] is a sentinel
-  CallResult<uint32_t> partitionResult{quickSortPartition(sm, index, l, r)};
-  if (partitionResult == ExecutionStatus::EXCEPTION) {
-    return ExecutionStatus::EXCEPTION;
+  /// Like gallopLeft(), but insert after any equal elements.
+  /// \return k such that range[k - 1] <= key < range[k].
+  CallResult<uint32_t> gallopRight(
+      uint32_t key,
+      const uint32_t *range,
+      uint32_t len,
+      uint32_t hint) {
+    return gallop</* right */ true>(key, range, len, hint);
   }
-  uint32_t j = *partitionResult;
-
-  // To limit the stack size, recurse for the smaller partition and do
-  // tail-recursion for the bigger one
-  uint32_t lSize = j - l;
-  uint32_t rSize = r - j;
-  if (lSize <= rSize) {
-    if (lSize > INSERTION_THRESHOLD) {
-      if (doQuickSort(sm, index, limit - 1, l, j - 1) ==
-          ExecutionStatus::EXCEPTION) {
+
+  /// Implementation of gallopLeft() and gallopRight(), selected by \p right.
+  template <bool right>
+  CallResult<uint32_t>
+  gallop(uint32_t key, const uint32_t *range, uint32_t len, uint32_t hint) {
+    assert(len > 0 && hint < len && "hint out of range");
+    // \return whether key goes after \p elem.
+    auto after = [this, key](uint32_t elem) -> CallResult<bool> {
+      auto res = right ? less_(key, elem) : less_(elem, key);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
         return ExecutionStatus::EXCEPTION;
+      return right ? !*res : *res;
+    };
+
+    // Find lastOfs < ofs such that key goes after range[lastOfs] and not
+    // after range[ofs], where -1 and len stand for the ends of the range.
+    int64_t lastOfs;
+    int64_t ofs;
+    auto res = after(range[hint]);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    if (*res) {
+      // Gallop towards the end: range[hint + lastOfs] < key <= ...
+      int64_t maxOfs = (int64_t)len - hint;
+      lastOfs = 0;
+      ofs = 1;
+      while (ofs < maxOfs) {
+        res = after(range[hint + ofs]);
+        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+          return ExecutionStatus::EXCEPTION;
+        if (!*res)
+          break;
+        lastOfs = ofs;
+        ofs = ofs * 2 + 1;
       }
+      ofs = std::min(ofs, maxOfs);
+      lastOfs += hint;
+      ofs += hint;
     } else {
-      if (insertionSort(sm, index, l, j) == ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
+      // Gallop towards the beginning.
+      int64_t maxOfs = (int64_t)hint + 1;
+      int64_t backOfs = 1;
+      int64_t lastBackOfs = 0;
+      while (backOfs < maxOfs) {
+        res = after(range[hint - backOfs]);
+        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+          return ExecutionStatus::EXCEPTION;
+        if (*res)
+          break;
+        lastBackOfs = backOfs;
+        backOfs = backOfs * 2 + 1;
       }
+      backOfs = std::min(backOfs, maxOfs);
+      lastOfs = (int64_t)hint - backOfs;
+      ofs = (int64_t)hint - lastBackOfs;
     }
-
-    if (rSize > INSERTION_THRESHOLD) {
-      l = j + 1;
-      --limit;
-      goto quicksort_top;
-    } else {
-      if (insertionSort(sm, index, j + 1, r + 1) ==
-          ExecutionStatus::EXCEPTION) {
+    assert(-1 <= lastOfs && lastOfs < ofs && ofs <= len && "bad gallop");
+
+    // Binary search in (lastOfs, ofs].
+    ++lastOfs;
+    while (lastOfs < ofs) {
+      int64_t mid = lastOfs + (ofs - lastOfs) / 2;
+      res = after(range[mid]);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
         return ExecutionStatus::EXCEPTION;
-      }
+      if (*res)
+        lastOfs = mid + 1;
+      else
+        ofs = mid;
     }
+    return (uint32_t)ofs;
+  }
 
-  } else {
-    if (rSize > INSERTION_THRESHOLD) {
-      if (doQuickSort(sm, index, limit - 1, j + 1, r) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    } else {
-      if (insertionSort(sm, index, j + 1, r + 1) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
+  /// Merge the adjacent sorted ranges [base1, base1 + len1) and
+  /// [base2, base2 + len2), by copying the first one out of the way and
+  /// filling the merged result from base1.
+  ExecutionStatus
+  mergeLo(uint32_t base1, uint32_t len1, uint32_t base2, uint32_t len2) {
+    tmp_.assign(a_.begin() + base1, a_.begin() + base1 + len1);
+    // Cursors into the copy of the left run, the right run and the output.
+    uint32_t c1 = 0;
+    const uint32_t end1 = len1;
+    uint32_t c2 = base2;
+    const uint32_t end2 = base2 + len2;
+    uint32_t dest = base1;
+
+    while (c1 < end1 && c2 < end2) {
+      // Merge one element at a time, until one run wins consistently.
+      uint32_t count1 = 0;
+      uint32_t count2 = 0;
+      do {
+        auto res = less_(a_[c2], tmp_[c1]);
+        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+          return ExecutionStatus::EXCEPTION;
+        if (*res) {
+          a_[dest++] = a_[c2++];
+          ++count2;
+          count1 = 0;
+        } else {
+          a_[dest++] = tmp_[c1++];
+          ++count1;
+          count2 = 0;
+        }
+      } while (c1 < end1 && c2 < end2 && (count1 | count2) < minGallop_);
+
+      // Gallop while it keeps finding long stretches.
+      while (c1 < end1 && c2 < end2) {
+        auto res = gallopRight(a_[c2], &tmp_[c1], end1 - c1, 0);
+        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+          return ExecutionStatus::EXCEPTION;
+        count1 = *res;
+        std::copy(&tmp_[c1], &tmp_[c1] + count1, &a_[dest]);
+        c1 += count1;
+        dest += count1;
+        if (c1 == end1)
+          break;
+        a_[dest++] = a_[c2++];
+        if (c2 == end2)
+          break;
+
+        res = gallopLeft(tmp_[c1], &a_[c2], end2 - c2, 0);
+        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+          return ExecutionStatus::EXCEPTION;
+        count2 = *res;
+        // dest <= c2, so the ranges may overlap but copying forward is safe.
+        std::copy(&a_[c2], &a_[c2] + count2, &a_[dest]);
+        c2 += count2;
+        dest += count2;
+        if (c2 == end2)
+          break;
+        a_[dest++] = tmp_[c1++];
+
+        if (minGallop_ > 1)
+          --minGallop_;
+        if (count1 < MIN_GALLOP && count2 < MIN_GALLOP) {
+          // Galloping does not pay off: make it harder to get back to it.
+          minGallop_ += 2;
+          break;
+        }
       }
     }
 
-    if (lSize > INSERTION_THRESHOLD) {
-      r = j - 1;
-      --limit;
-      goto quicksort_top;
-    } else {
-      if (insertionSort(sm, index, l, j) == ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    }
+    // The rest of the right run is already in place.
+    assert(
+        dest + (end1 - c1) == (c2 < end2 ? c2 : end2) &&
+        "merge lost elements");
+    std::copy(tmp_.begin() + c1, tmp_.begin() + end1, a_.begin() + dest);
+    return ExecutionStatus::RETURNED;
   }
+};
 
-  return ExecutionStatus::RETURNED;
+template <typename Less>
+TimSorter<Less> makeTimSorter(llvh::MutableArrayRef<uint32_t> perm, Less less) {
+  return TimSorter<Less>(perm, less);
 }
 
 } // namespace
 
-ExecutionStatus quickSort(SortModel *sm, uint32_t begin, uint32_t end) {
+ExecutionStatus timSort(SortModel *sm, uint32_t begin, uint32_t end) {
   if (begin >= end)
     return ExecutionStatus::RETURNED;
   uint32_t len = end - begin;
-  std::vector<uint32_t> index(len); // Array of original indices of items
+  // perm[i] is the index of the element that goes to begin + i.
+  std::vector<uint32_t> perm(len);
+  for (uint32_t i = 0; i < len; ++i)
+    perm[i] = begin + i;
+
+  // The sorter asks whether a later element is less than an earlier one.
+  // Compare them the other way around, so that the comparison sees them in
+  // their current order, and inconsistent comparisons leave them in place.
+  auto sorter = makeTimSorter(
+      perm, [sm](uint32_t a, uint32_t b) -> CallResult<bool> {
+        auto res = sm->compare(b, a);
+        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+          return ExecutionStatus::EXCEPTION;
+        return *res > 0;
+      });
+  if (LLVM_UNLIKELY(sorter.sort() == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+
+  // Move the elements into place by following the cycles of the
+  // permutation. Each visited entry is reset to its own index.
   for (uint32_t i = 0; i < len; ++i) {
-    index[i] = i;
+    uint32_t j = i;
+    for (;;) {
+      uint32_t next = perm[j] - begin;
+      perm[j] = begin + j;
+      if (next == i)
+        break;
+      if (LLVM_UNLIKELY(
+              sm->swap(begin + j, begin + next) == ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+      j = next;
+    }
   }
+  return ExecutionStatus::RETURNED;
+}
 
-  if (len > INSERTION_THRESHOLD) {
-    return doQuickSort(sm, index, llvh::Log2_32(len) * 2, begin, end - 1);
-  } else {
-    return insertionSort(sm, index, begin, end);
-  }
+void timSort(
+    llvh::MutableArrayRef<uint32_t> perm,
+    llvh::function_ref<bool(uint32_t, uint32_t)> less) {
+  auto sorter =
+      makeTimSorter(perm, [less](uint32_t a, uint32_t b) -> CallResult<bool> {
+        return less(a, b);
+      });
+  auto status = sorter.sort();
+  (void)status;
+  assert(status == ExecutionStatus::RETURNED && "infallible sort failed");
 }
 
 } // namespace vm
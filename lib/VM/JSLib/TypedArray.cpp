@@ -20,6 +20,8 @@
 #include "hermes/VM/StringBuilder.h"
 #include "hermes/VM/StringView.h"
 
+#include <cstring>
+#include <memory>
 #include <type_traits>
 
 namespace hermes {
@@ -625,54 +627,175 @@ class TypedArraySortModel : public SortModel {
 
 namespace {
 
+/// Unsigned integer type with the same size as \p T.
 template <typename T>
-int compareFloat(T va, T vb) {
-  // NaN sorts after everything.
-  bool aNaN = std::isnan(va);
-  bool bNaN = std::isnan(vb);
-  if (LLVM_UNLIKELY(aNaN)) {
-    if (LLVM_UNLIKELY(bNaN))
-      return 0;
-    return 1;
-  } else if (LLVM_UNLIKELY(bNaN)) {
-    return -1;
-  }
-  // -0 < +0.
-  if (LLVM_UNLIKELY(va == 0 && vb == 0))
-    return std::signbit(vb) - std::signbit(va);
-  return (va > vb) - (va < vb);
+using SortKeyType = std::conditional_t<
+    sizeof(T) == 1,
+    uint8_t,
+    std::conditional_t<
+        sizeof(T) == 2,
+        uint16_t,
+        std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+
+/// Maps the bits of elements of type \p T in a typed array of kind \p C to
+/// unsigned keys whose order is the default sort order of the elements, and
+/// back. For floating point types, -0 sorts before +0 and all NaNs are mapped
+/// to the largest key, so they sort last; they map back to a single NaN.
+template <typename T, CellKind C>
+struct SortKeyTraits {
+  using Key = SortKeyType<T>;
+  static constexpr bool isFloat =
+      C == CellKind::Float16ArrayKind || std::is_floating_point_v<T>;
+  static constexpr Key signBit = Key(1) << (sizeof(Key) * 8 - 1);
+  /// Bits of the positive infinity. Larger magnitudes are NaNs.
+  static constexpr Key infBits = C == CellKind::Float16ArrayKind ? 0x7c00
+      : sizeof(T) == 4 ? 0x7f800000
+                       : 0x7ff0000000000000;
+
+  static Key toKey(Key bits) {
+    if constexpr (isFloat) {
+      if (LLVM_UNLIKELY((Key)(bits & ~signBit) > infBits))
+        return (Key)~Key(0);
+      // Negative numbers are ordered backwards by their bits.
+      return bits & signBit ? (Key)~bits : (Key)(bits | signBit);
+    } else if constexpr (std::is_signed_v<T>) {
+      return bits ^ signBit;
+    } else {
+      return bits;
+    }
+  }
+
+  static Key fromKey(Key key) {
+    if constexpr (isFloat) {
+      return key & signBit ? (Key)(key & ~signBit) : (Key)~key;
+    } else if constexpr (std::is_signed_v<T>) {
+      return key ^ signBit;
+    } else {
+      return key;
+    }
+  }
+};
+
+/// Ranges at most this long are sorted by insertion sort instead of another
+/// radix pass.
+constexpr size_t kRadixSortSmallRange = 32;
+
+template <typename Key>
+void insertionSortKeys(Key *begin, Key *end) {
+  for (Key *i = begin + 1; i < end; ++i) {
+    Key key = *i;
+    Key *j = i;
+    for (; j != begin && key < j[-1]; --j)
+      *j = j[-1];
+    *j = key;
+  }
 }
 
-/// ::qsort comparator for typed array elements.
-template <typename T, CellKind C>
-int qsortComparator(const void *a, const void *b) {
-  if constexpr (C == CellKind::Float16ArrayKind) {
-    return compareFloat(
-        float16ToDouble(*static_cast<const uint16_t *>(a)),
-        float16ToDouble(*static_cast<const uint16_t *>(b)));
-  } else if constexpr (std::is_floating_point_v<T>) {
-    return compareFloat(*static_cast<const T *>(a), *static_cast<const T *>(b));
-  } else {
-    T va = *static_cast<const T *>(a);
-    T vb = *static_cast<const T *>(b);
-    return (va > vb) - (va < vb);
+/// Sort the keys in [begin, end) in place by their bytes, starting at the
+/// byte selected by \p shift and moving towards the least significant one
+/// (MSD radix sort, permuting each pass in place like American flag sort).
+/// The depth of the recursion is bounded by sizeof(Key).
+template <typename Key>
+void radixSortKeys(Key *begin, Key *end, unsigned shift) {
+  const auto len = (JSTypedArrayBase::size_type)(end - begin);
+  if (len <= kRadixSortSmallRange) {
+    insertionSortKeys(begin, end);
+    return;
   }
+
+  auto digit = [shift](Key key) -> unsigned {
+    return (unsigned)(key >> shift) & 0xff;
+  };
+  JSTypedArrayBase::size_type counts[256] = {};
+  for (Key *p = begin; p != end; ++p)
+    ++counts[digit(*p)];
+
+  // Permute every element into its bucket, unless they all share the digit.
+  if (counts[digit(*begin)] != len) {
+    JSTypedArrayBase::size_type heads[256];
+    JSTypedArrayBase::size_type offset = 0;
+    for (unsigned d = 0; d < 256; ++d) {
+      heads[d] = offset;
+      offset += counts[d];
+    }
+    for (unsigned d = 0, bucketEnd = 0; d < 256; ++d) {
+      bucketEnd += counts[d];
+      // Move the element at the head of bucket d to its own bucket, until
+      // one that belongs to bucket d is found.
+      while (heads[d] < bucketEnd) {
+        Key key = begin[heads[d]];
+        for (unsigned kd = digit(key); kd != d; kd = digit(key))
+          std::swap(key, begin[heads[kd]++]);
+        begin[heads[d]++] = key;
+      }
+    }
+  }
+
+  if (shift == 0)
+    return;
+  Key *bucket = begin;
+  for (unsigned d = 0; d < 256; ++d) {
+    if (counts[d] > 1)
+      radixSortKeys(bucket, bucket + counts[d], shift - 8);
+    bucket += counts[d];
+  }
+}
+
+/// Sort \p len elements of type \p T in the storage of a typed array of
+/// kind \p C, in the default order, without a comparator. \p shared indicates
+/// that the storage belongs to a SharedArrayBuffer.
+template <typename T, CellKind C>
+void typedArraySortDirectImpl(
+    uint8_t *data,
+    JSTypedArrayBase::size_type len,
+    bool shared) {
+  using Traits = SortKeyTraits<T, C>;
+  using Key = typename Traits::Key;
+  Key *keys = reinterpret_cast<Key *>(data);
+  // Other agents may read a shared buffer while it is being sorted, and must
+  // never observe the keys. Sort a copy instead, and only store the sorted
+  // elements back.
+  std::unique_ptr<Key[]> scratch;
+  if (shared) {
+    scratch.reset(new Key[len]);
+    std::memcpy(scratch.get(), data, len * sizeof(Key));
+    keys = scratch.get();
+  }
+  Key *end = keys + len;
+
+  // Convert the elements to keys in place, noting whether they are already
+  // sorted.
+  bool sorted = true;
+  Key prev = 0;
+  for (Key *p = keys; p != end; ++p) {
+    Key key = Traits::toKey(*p);
+    sorted &= prev <= key;
+    prev = *p = key;
+  }
+  if (shared && sorted)
+    return;
+  if (!sorted)
+    radixSortKeys(keys, end, (sizeof(Key) - 1) * 8);
+  for (Key *p = keys; p != end; ++p)
+    *p = Traits::fromKey(*p);
+  if (shared)
+    std::memcpy(data, keys, len * sizeof(Key));
 }
 
-/// Sort typed array elements directly using ::qsort.
+/// Sort typed array elements directly, using the implementation specialized
+/// for the element type. \p shared indicates that \p data belongs to a
+/// SharedArrayBuffer.
 void typedArraySortDirect(
     uint8_t *data,
     CellKind kind,
-    JSTypedArrayBase::size_type len) {
+    JSTypedArrayBase::size_type len,
+    bool shared) {
   assert(data && "data must be non-null");
   switch (kind) {
-#define TYPED_ARRAY(name, type)                            \
-  case CellKind::name##ArrayKind:                          \
-    ::qsort(                                               \
-        data,                                              \
-        len,                                               \
-        sizeof(type),                                      \
-        qsortComparator<type, CellKind::name##ArrayKind>); \
+#define TYPED_ARRAY(name, type)                                \
+  case CellKind::name##ArrayKind:                              \
+    typedArraySortDirectImpl<type, CellKind::name##ArrayKind>( \
+        data, len, shared);                                    \
     break;
 #include "hermes/VM/TypedArrays.def"
     default:
@@ -2017,7 +2140,7 @@ CallResult<HermesValue> typedArrayPrototypeSort(void *, Runtime &runtime) {
         lv.arrStorage->pushWithinCapacity(runtime, *lv.value);
       }
       TypedArraySortModel sm(runtime, lv.arrStorage, compareFn);
-      if (LLVM_UNLIKELY(quickSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
+      if (LLVM_UNLIKELY(timSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
         return ExecutionStatus::EXCEPTION;
 
       if (self->attached(runtime)) {
@@ -2043,7 +2166,7 @@ CallResult<HermesValue> typedArrayPrototypeSort(void *, Runtime &runtime) {
           runtime, lv.newTypedArray, 0, self, 0, len);
       assert(status == ExecutionStatus::RETURNED);
       TypedArraySortModel sm(runtime, lv.newTypedArray, compareFn);
-      if (LLVM_UNLIKELY(quickSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
+      if (LLVM_UNLIKELY(timSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
         return ExecutionStatus::EXCEPTION;
       if (self->attached(runtime)) {
         status = JSTypedArrayBase::setToCopyOfTypedArray(
@@ -2052,7 +2175,11 @@ CallResult<HermesValue> typedArrayPrototypeSort(void *, Runtime &runtime) {
       }
     }
   } else if (len > 0) {
-    typedArraySortDirect(self->data(runtime), self->getKind(), len);
+    typedArraySortDirect(
+        self->data(runtime),
+        self->getKind(),
+        len,
+        self->getBuffer(runtime)->shared());
   }
   return self.getHermesValue();
 }
@@ -13,6 +13,7 @@
 #include "hermes/Support/UTF8.h"
 #include "hermes/VM/BuildMetadata.h"
 #include "hermes/VM/Operations.h"
+#include "hermes/VM/RegExpCache.h"
 #include "hermes/VM/RegExpMatch.h"
 #include "hermes/VM/Runtime-inline.h"
 #include "hermes/VM/StringView.h"
@@ -98,7 +99,7 @@ void JSRegExp::initialize(
     Runtime &runtime,
     Handle<StringPrimitive> pattern,
     Handle<StringPrimitive> flags,
-    llvh::ArrayRef<uint8_t> bytecode) {
+    SharedRegExpBytecode bytecode) {
   assert(
       pattern && flags &&
       "Null pattern and/or flags passed to JSRegExp::initialize");
@@ -119,7 +120,8 @@ void JSRegExp::initialize(
       res != ExecutionStatus::EXCEPTION && *res &&
       "defineOwnProperty() failed");
 
-  selfHandle->initializeBytecode(bytecode);
+  selfHandle->initializeBytecode(std::move(bytecode));
+  selfHandle->nativeRegExp_ = nullptr;
 }
 
 ExecutionStatus JSRegExp::initialize(
@@ -151,6 +153,7 @@ ExecutionStatus JSRegExp::initialize(
         lv.pattern,
         flags,
         {otherHandle->bytecode_, otherHandle->bytecodeSize_});
+    selfHandle->nativeRegExp_ = otherHandle->nativeRegExp_;
     return ExecutionStatus::RETURNED;
   }
   return initialize(selfHandle, runtime, lv.pattern, flags);
@@ -171,34 +174,52 @@ ExecutionStatus JSRegExp::initialize(
   llvh::SmallVector<char16_t, 16> patternText16;
   pattern->appendUTF16String(patternText16);
 
-  // Build the regex.
-  regex::Regex<regex::UTF16RegexTraits> regex(patternText16, flagsText16);
-
-  if (!regex.valid()) {
-    return runtime.raiseSyntaxError(
-        TwineChar16("Invalid RegExp: ") +
-        regex::constants::messageForError(regex.getError()));
+  // Patterns built at runtime are often constructed repeatedly with the same
+  // text, so look for an already compiled copy. Invalid flags are reported by
+  // the regex parser below.
+  RegExpCache &cache = runtime.getRegExpCache();
+  auto sflags = regex::SyntaxFlags::fromString(flagsText16);
+  const RegExpCache::Entry *entry = nullptr;
+  if (LLVM_LIKELY(sflags))
+    entry = cache.lookup(patternText16, sflags->toByte());
+
+  RegExpCache::Entry compiled;
+  if (!entry) {
+    // Build the regex.
+    regex::Regex<regex::UTF16RegexTraits> regex(patternText16, flagsText16);
+
+    if (!regex.valid()) {
+      return runtime.raiseSyntaxError(
+          TwineChar16("Invalid RegExp: ") +
+          regex::constants::messageForError(regex.getError()));
+    }
+    // The regex is valid. Compile it, and keep the name mappings along with
+    // the bytecode.
+    compiled.bytecode = SharedRegExpBytecode::fromVector(regex.compile());
+    compiled.orderedGroupNames = regex.acquireOrderedGroupNames();
+    compiled.groupNamesMapping = regex.acquireGroupNamesMapping();
+    entry = cache.insert(patternText16, sflags->toByte(), std::move(compiled));
+    if (!entry)
+      entry = &compiled;
   }
-  // The regex is valid. Compile and store its bytecode.
-  auto bytecode = regex.compile();
-  // Also store the name mappings.
+
   if (LLVM_UNLIKELY(
           initializeGroupNameMappingObj(
               runtime,
               selfHandle,
-              regex.getOrderedNamedGroups(),
-              regex.getGroupNamesMapping()) == ExecutionStatus::EXCEPTION)) {
+              entry->orderedGroupNames,
+              entry->groupNamesMapping) == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  initialize(selfHandle, runtime, pattern, flags, bytecode);
+  initialize(selfHandle, runtime, pattern, flags, entry->bytecode);
   return ExecutionStatus::RETURNED;
 }
 
 ExecutionStatus JSRegExp::initializeGroupNameMappingObj(
     Runtime &runtime,
     Handle<JSRegExp> selfHandle,
-    std::deque<llvh::SmallVector<char16_t, 5>> &orderedNamedGroups,
-    regex::ParsedGroupNamesMapping &parsedMappings) {
+    const std::deque<llvh::SmallVector<char16_t, 5>> &orderedNamedGroups,
+    const regex::ParsedGroupNamesMapping &parsedMappings) {
   struct : public Locals {
     PinnedValue<JSObject> obj;
     PinnedValue<HermesValue> numberValue;
@@ -220,7 +241,7 @@ ExecutionStatus JSRegExp::initializeGroupNameMappingObj(
     if (LLVM_UNLIKELY(symbolRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
-    auto idx = parsedMappings[identifier];
+    auto idx = parsedMappings.lookup(identifier);
     numberHandle.set(HermesValue::encodeTrustedNumberValue(idx));
     auto res = JSObject::defineNewOwnProperty(
         lv.obj,
@@ -248,17 +269,13 @@ void JSRegExp::setGroupNameMappings(Runtime &runtime, JSObject *groupObj) {
   groupNameMappings_.set(runtime, groupObj, runtime.getHeap());
 }
 
-void JSRegExp::initializeBytecode(llvh::ArrayRef<uint8_t> bytecode) {
-  size_t sz = bytecode.size();
-  assert(
-      sz <= std::numeric_limits<uint32_t>::max() &&
-      "Bytecode size cannot exceed 32 bits");
+void JSRegExp::initializeBytecode(SharedRegExpBytecode bytecode) {
   auto header =
-      reinterpret_cast<const regex::RegexBytecodeHeader *>(bytecode.data());
+      reinterpret_cast<const regex::RegexBytecodeHeader *>(bytecode.data.get());
   syntaxFlags_ = regex::SyntaxFlags::fromByte(header->syntaxFlags);
-  bytecodeSize_ = sz;
-  bytecode_ = (uint8_t *)checkedMalloc(sz);
-  memcpy(bytecode_, bytecode.data(), sz);
+  bytecodeSize_ = bytecode.size;
+  bytecode_ = std::move(bytecode.data);
+  searchAnalysis_.reset();
 }
 
 PseudoHandle<StringPrimitive> JSRegExp::getPattern(
@@ -271,6 +288,7 @@ template <typename CharT, typename Traits>
 CallResult<RegExpMatch> performSearch(
     Runtime &runtime,
     llvh::ArrayRef<uint8_t> bytecode,
+    const regex::SearchAnalysis &analysis,
     const CharT *start,
     uint32_t stringLength,
     uint32_t searchStartOffset,
@@ -283,6 +301,7 @@ CallResult<RegExpMatch> performSearch(
       stringLength,
       &nativeMatchRanges,
       matchFlags,
+      &analysis,
       runtime.getOverflowGuardForRegex());
   if (matchResult == regex::MatchRuntimeResult::StackOverflow) {
     return runtime.raiseRangeError("Maximum regex stack depth reached");
@@ -308,6 +327,62 @@ CallResult<RegExpMatch> performSearch(
   return match;
 }
 
+// Native matchers receive the match flags and report unmatched groups as the
+// regex interpreter does.
+static_assert(
+    SH_REGEXP_NOT_END_OF_LINE == regex::constants::matchNotEndOfLine,
+    "SH_REGEXP_NOT_END_OF_LINE must match MatchFlagType");
+static_assert(
+    SH_REGEXP_INPUT_ALL_ASCII == regex::constants::matchInputAllAscii,
+    "SH_REGEXP_INPUT_ALL_ASCII must match MatchFlagType");
+static_assert(
+    SH_REGEXP_ONLY_AT_START == regex::constants::matchOnlyAtStart,
+    "SH_REGEXP_ONLY_AT_START must match MatchFlagType");
+static_assert(
+    SH_REGEXP_NOT_MATCHED == regex::kNotMatched,
+    "SH_REGEXP_NOT_MATCHED must match kNotMatched");
+static_assert(
+    SH_REGEXP_BACKTRACK_LIMIT < regex::kBacktrackLimit,
+    "Native matchers must give up before the interpreter would");
+
+/// Search using the matcher \p search generated by the native backend, for
+/// a regexp with \p markedCount capture groups. The arguments are as for
+/// performSearch(). \return None if the matcher ran out of backtracking
+/// budget, in which case the search must be continued with the interpreter
+/// from \p resumeOffset.
+template <typename CharT, typename SearchFn>
+llvh::Optional<RegExpMatch> performNativeSearch(
+    SearchFn search,
+    uint32_t markedCount,
+    const CharT *start,
+    uint32_t stringLength,
+    uint32_t searchStartOffset,
+    regex::constants::MatchFlagType matchFlags,
+    uint32_t &resumeOffset) {
+  llvh::SmallVector<uint32_t, 16> captures(2 * (markedCount + 1));
+  int32_t res = search(
+      start, searchStartOffset, stringLength, matchFlags, captures.data());
+  if (LLVM_UNLIKELY(res < 0)) {
+    // No match starts before the position the matcher gave up on.
+    resumeOffset = captures[0];
+    return llvh::None;
+  }
+  if (res == 0)
+    return RegExpMatch{}; // not found.
+  RegExpMatch match;
+  match.reserve(markedCount + 1);
+  for (uint32_t i = 0; i <= markedCount; ++i) {
+    uint32_t begin = captures[2 * i], end = captures[2 * i + 1];
+    if (begin == SH_REGEXP_NOT_MATCHED) {
+      assert(i > 0 && "match_result[0] should always match");
+      match.push_back(llvh::None);
+    } else {
+      match.push_back(RegExpMatchRange{begin, end - begin});
+    }
+  }
+  return match;
+}
+
 CallResult<RegExpMatch> JSRegExp::search(
     Handle<JSRegExp> selfHandle,
     Runtime &runtime,
@@ -330,23 +405,74 @@ CallResult<RegExpMatch> JSRegExp::search(
     matchFlags |= regex::constants::matchOnlyAtStart;
   }
 
+  llvh::ArrayRef<uint8_t> bytecode{
+      selfHandle->bytecode_.get(), selfHandle->bytecodeSize_};
+
+  // Native matchers backtrack like the interpreter, so they are not used when
+  // linear time searches are requested. Regexps without matchers from the
+  // native backend are compiled by the JIT once they are hot.
+  const SHNativeRegExp *native = nullptr;
+  if (runtime.hasRegExpLinearTime()) {
+    matchFlags |= regex::constants::matchLinearTime;
+  } else {
+    native = selfHandle->nativeRegExp_;
+    if (!native) {
+      native = runtime.getJITContext().getNativeRegExp(bytecode);
+      selfHandle->nativeRegExp_ = native;
+    }
+  }
+
   CallResult<RegExpMatch> matchResult = RegExpMatch{};
+  llvh::Optional<RegExpMatch> nativeResult;
+  // Where the interpreter starts searching, if the native matcher gives up.
+  uint32_t resumeOffset = searchStartOffset;
   if (input.isASCII()) {
     matchFlags |= regex::constants::matchInputAllAscii;
+    if (native) {
+      nativeResult = performNativeSearch(
+          native->search8,
+          native->marked_count,
+          reinterpret_cast<const uint8_t *>(input.castToCharPtr()),
+          input.length(),
+          searchStartOffset,
+          matchFlags,
+          resumeOffset);
+    }
+  } else if (native) {
+    nativeResult = performNativeSearch(
+        native->search16,
+        native->marked_count,
+        reinterpret_cast<const uint16_t *>(input.castToChar16Ptr()),
+        input.length(),
+        searchStartOffset,
+        matchFlags,
+        resumeOffset);
+  }
+
+  if (!nativeResult && !selfHandle->searchAnalysis_) {
+    selfHandle->searchAnalysis_ = std::make_unique<regex::SearchAnalysis>(
+        bytecode, runtime.hasRegExpLinearTime());
+  }
+
+  if (nativeResult) {
+    matchResult = std::move(*nativeResult);
+  } else if (input.isASCII()) {
     matchResult = performSearch<char, regex::ASCIIRegexTraits>(
         runtime,
-        llvh::makeArrayRef(selfHandle->bytecode_, selfHandle->bytecodeSize_),
+        bytecode,
+        *selfHandle->searchAnalysis_,
         input.castToCharPtr(),
         input.length(),
-        searchStartOffset,
+        resumeOffset,
         matchFlags);
   } else {
     matchResult = performSearch<char16_t, regex::UTF16RegexTraits>(
         runtime,
-        llvh::makeArrayRef(selfHandle->bytecode_, selfHandle->bytecodeSize_),
+        bytecode,
+        *selfHandle->searchAnalysis_,
         input.castToChar16Ptr(),
         input.length(),
-        searchStartOffset,
+        resumeOffset,
         matchFlags);
   }
 
@@ -361,21 +487,20 @@ CallResult<RegExpMatch> JSRegExp::search(
   return matchResult;
 }
 
-JSRegExp::~JSRegExp() {
-  free(bytecode_);
-}
+JSRegExp::~JSRegExp() = default;
 
 void JSRegExp::_finalizeImpl(GCCell *cell, GC &gc) {
   JSRegExp *self = vmcast<JSRegExp>(cell);
-  if (self->bytecode_) {
-    gc.getIDTracker().untrackNative(self->bytecode_);
+  if (self->searchAnalysis_) {
+    gc.getIDTracker().untrackNative(self->searchAnalysis_.get());
   }
   self->~JSRegExp();
 }
 
 size_t JSRegExp::_mallocSizeImpl(GCCell *cell) {
+  // The bytecode is shared, and accounted for by its owner.
   auto *self = vmcast<JSRegExp>(cell);
-  return self->bytecodeSize_;
+  return self->searchAnalysis_ ? self->searchAnalysis_->getMemorySize() : 0;
 }
 
 #ifdef HERMES_MEMORY_INSTRUMENTATION
@@ -388,25 +513,25 @@ void JSRegExp::_snapshotAddEdgesImpl(GCCell *cell, GC &gc, HeapSnapshot &snap) {
   auto *const self = vmcast<JSRegExp>(cell);
   // Call the super type to add any other custom edges.
   JSObject::_snapshotAddEdgesImpl(self, gc, snap);
-  if (self->bytecode_) {
+  if (self->searchAnalysis_) {
     snap.addNamedEdge(
         HeapSnapshot::EdgeType::Internal,
-        "bytecode",
-        gc.getNativeID(self->bytecode_));
+        "searchAnalysis",
+        gc.getNativeID(self->searchAnalysis_.get()));
   }
 }
 
 void JSRegExp::_snapshotAddNodesImpl(GCCell *cell, GC &gc, HeapSnapshot &snap) {
   auto *const self = vmcast<JSRegExp>(cell);
-  if (self->bytecode_) {
-    // Add a native node for regex bytecode, to account for native size
-    // directly owned by the regex.
+  if (self->searchAnalysis_) {
+    // Add a native node for the search analysis, to account for native size
+    // directly owned by the regex. The bytecode is shared, so it is not.
     snap.beginNode();
     snap.endNode(
         HeapSnapshot::NodeType::Native,
-        "RegExpBytecode",
-        gc.getNativeID(self->bytecode_),
-        self->bytecodeSize_,
+        "RegExpSearchAnalysis",
+        gc.getNativeID(self->searchAnalysis_.get()),
+        self->searchAnalysis_->getMemorySize(),
         0);
   }
 }
@@ -932,7 +932,8 @@ static CallResult<bool> compareBigIntAndNumber(
                                                                       \
     /* If both are strings, we must do a string comparison.*/         \
     if (left->isString() && right->isString()) {                      \
-      return left->getString()->compare(right->getString()) oper 0;   \
+      return left->getString()->compare(                              \
+                 runtime, right->getString()) oper 0;                 \
     }                                                                 \
                                                                       \
     if (left->isBigInt() && right->isString()) {                      \
@@ -1113,7 +1114,7 @@ abstractEqualityTest_RJS(Runtime &runtime, Handle<> xHandle, Handle<> yHandle) {
         return x->getNumber() == y->getNumber();
       }
       CASE_M_M(Str, Str) {
-        return x->getString()->equals(y->getString());
+        return x->getString()->equals(runtime, y->getString());
       }
       CASE_M_M(BigInt, BigInt) {
         return x->getBigInt()->compare(y->getBigInt()) == 0;
@@ -1282,6 +1283,12 @@ bool strictEqualityTest(HermesValue x, HermesValue y) {
   return x.isBigInt() && x.getBigInt()->compare(y.getBigInt()) == 0;
 }
 
+bool strictEqualityTest(Runtime &runtime, HermesValue x, HermesValue y) {
+  if (x.isString() && y.isString())
+    return x.getString()->equals(runtime, y.getString());
+  return strictEqualityTest(x, y);
+}
+
 CallResult<HermesValue>
 addOp_RJS(Runtime &runtime, Handle<> xHandle, Handle<> yHandle) {
   // Fast path: both operands are already strings, concat directly.
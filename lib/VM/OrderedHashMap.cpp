@@ -136,9 +136,9 @@ template <typename BucketType, typename Derived>
 ExecutionStatus OrderedHashMapBase<BucketType, Derived>::initializeStorage(
     Handle<Derived> self,
     Runtime &runtime) {
-  self->hashTable_.resize(kInitialCapacity, kHashTableElementUnused);
+  self->hashTable_.resize(kInitialCapacity, kUnusedBucket);
   runtime.getHeap().creditExternalMemory(
-      *self, kInitialCapacity * sizeof(uint32_t));
+      *self, kInitialCapacity * sizeof(Bucket));
 
   // Create data table with corresponding capacity, but start off with 0 size.
   // Entries will be appended as the hash table receives elements.
@@ -162,9 +162,10 @@ template <typename BucketType, typename Derived>
 std::pair<OptValue<uint32_t>, uint32_t>
 OrderedHashMapBase<BucketType, Derived>::lookupInBucket(
     Runtime &runtime,
-    uint32_t bucket,
+    uint32_t hash,
     HermesValue key) const {
   assert(hashTable_.size() == capacity_ && "Inconsistent capacity");
+  uint32_t bucket = hashToBucket(capacity_, hash);
   [[maybe_unused]] const uint32_t firstBucket = bucket;
 
   NoAllocScope noAlloc{runtime};
@@ -174,15 +175,15 @@ OrderedHashMapBase<BucketType, Derived>::lookupInBucket(
   StorageType *dataTable = dataTable_.getNonNull(runtime);
   const uint32_t mask = capacity_ - 1;
 
-  // Each bucket must be either kHashTableElementUnused,
-  // kHashTableElementDeleted, or an index to the data table.
-  uint32_t dataTableKeyIndex;
+  // Each bucket must be either unused or refer to an entry in the data table.
+  // Only compare the keys of entries whose hash matches.
   assert(bucket < capacity_ && "Hash table index >= capacity.");
-  while ((dataTableKeyIndex = hashTable_[bucket]) != kHashTableElementUnused) {
-    if (dataTableKeyIndex != kHashTableElementDeleted) {
-      auto keySHV = dataTable->at(dataTableKeyIndex);
+  while (hashTable_[bucket].dataTableKeyIndex != kHashTableElementUnused) {
+    const Bucket &entry = hashTable_[bucket];
+    if (entry.hash == hash) {
+      auto keySHV = dataTable->at(entry.dataTableKeyIndex);
       if (isSameValueZero(keySHV.unboxToHV(runtime), key)) {
-        return {dataTableKeyIndex, bucket};
+        return {entry.dataTableKeyIndex, bucket};
       }
     }
 
@@ -193,6 +194,65 @@ OrderedHashMapBase<BucketType, Derived>::lookupInBucket(
   return {llvh::None, bucket};
 }
 
+template <typename BucketType, typename Derived>
+void OrderedHashMapBase<BucketType, Derived>::compact(Runtime &runtime) {
+  NoAllocScope noAlloc{runtime};
+  StorageType *dataTable = dataTable_.getNonNull(runtime);
+
+  // For each of the deleted entry, we store the entry index to help iterators
+  // adjust their entry index in the next step.
+  // Suppose you have the following data table (kElementsPerEntry = 1), and 'x'
+  // marks the deleted entries.
+  // entry index: 0 1 2 3 4 5 6 7 8
+  //            : 0 x 2 x 4 x 6 x 8
+  // We'll record the deleted indices as: [1 3 5 7]
+  std::vector<uint32_t> deletedEntryIndices;
+  deletedEntryIndices.reserve(deletedCount_);
+  // The new data table index of the key of each entry that isn't deleted.
+  const uint32_t totalEntries = size_ + deletedCount_;
+  std::vector<uint32_t> newKeyIndices(totalEntries);
+
+  // Move the entries that aren't deleted down over the deleted ones.
+  uint32_t newDataTableKeyIndex = 0;
+  uint32_t oldDataTableKeyIndex = 0;
+  for (uint32_t i = 0; i < totalEntries; ++i) {
+    auto keySHV = dataTable->at(oldDataTableKeyIndex);
+    if (!keySHV.isEmpty()) {
+      if (newDataTableKeyIndex != oldDataTableKeyIndex) {
+        dataTable->set(newDataTableKeyIndex, keySHV, runtime.getHeap());
+        if constexpr (std::is_same_v<BucketType, HashMapEntry>) {
+          dataTable->set(
+              newDataTableKeyIndex + 1,
+              dataTable->at(oldDataTableKeyIndex + 1),
+              runtime.getHeap());
+        }
+      }
+      newKeyIndices[i] = newDataTableKeyIndex;
+      newDataTableKeyIndex += BucketType::kElementsPerEntry;
+    } else {
+      // Entry is deleted.
+      deletedEntryIndices.push_back(i);
+    }
+    oldDataTableKeyIndex += BucketType::kElementsPerEntry;
+  }
+  StorageType::resizeWithinCapacity(
+      dataTable, runtime.getHeap(), newDataTableKeyIndex);
+
+  // The buckets don't depend on where their entries are, so only their
+  // indices need to be updated.
+  for (Bucket &bucket : hashTable_) {
+    if (bucket.dataTableKeyIndex != kHashTableElementUnused) {
+      uint32_t entry = bucket.dataTableKeyIndex / BucketType::kElementsPerEntry;
+      bucket.dataTableKeyIndex = newKeyIndices[entry];
+    }
+  }
+
+  // Adjust any active iterators to handle the fact that we removed deleted
+  // entries from the data table.
+  updateIteratorIndicesForRehash(deletedEntryIndices);
+  deletedCount_ = 0;
+}
+
 template <typename BucketType, typename Derived>
 ExecutionStatus OrderedHashMapBase<BucketType, Derived>::rehash(
     Handle<Derived> self,
@@ -212,91 +272,52 @@ ExecutionStatus OrderedHashMapBase<BucketType, Derived>::rehash(
     return ExecutionStatus::EXCEPTION;
   }
 
-  // Create a new hash table.
-  std::vector<uint32_t> newHashTable;
-  newHashTable.resize(*newCapacity, kHashTableElementUnused);
+  // Remove the deleted entries first, so that the new data table can be
+  // filled by copying the old one. The table is consistent afterwards, even if
+  // the allocation below fails.
+  if (self->deletedCount_)
+    self->compact(runtime);
 
   // Create a new data table.
+  const uint32_t dataTableSize = self->size_ * BucketType::kElementsPerEntry;
   auto dataTableRes = StorageType::create(
-      runtime,
-      dataTableAllocationSize(*newCapacity),
-      self->size_ * BucketType::kElementsPerEntry);
+      runtime, dataTableAllocationSize(*newCapacity), dataTableSize);
   if (LLVM_UNLIKELY(dataTableRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
   lv.newDataTable.template castAndSetHermesValue<StorageType>(*dataTableRes);
 
-  // Publish the new capacity so the re-add loop below hashes into the new
-  // table. This happens only after the fallible allocation above succeeds; an
-  // early return on OOM must leave capacity_ consistent with the still-current
-  // hashTable_.
-  self->capacity_ = *newCapacity;
-
-  // Now re-add all entries to the hash table.
-  uint32_t totalEntries = self->size_ + self->deletedCount_;
-  uint32_t newDataTableKeyIndex = 0;
-  uint32_t oldDataTableKeyIndex = 0;
-
-  // For each of the deleted entry, we store the entry index to help iterators
-  // adjust their entry index in the next step.
-  // Suppose you have the following data table (kElementsPerEntry = 1), and 'x'
-  // marks the deleted entries.
-  // entry index: 0 1 2 3 4 5 6 7 8
-  //            : 0 x 2 x 4 x 6 x 8
-  // We'll record the deleted indices as: [1 3 5 7]
-  std::vector<uint32_t> deletedEntryIndices;
-  deletedEntryIndices.reserve(self->deletedCount_);
-
+  NoAllocScope noAlloc{runtime};
   NoHandleScope noHandle{runtime};
 
-  const uint32_t mask = self->capacity_ - 1;
-  for (uint32_t i = 0; i < totalEntries; ++i) {
-    auto keySHV =
-        self->dataTable_.getNonNull(runtime)->at(oldDataTableKeyIndex);
-    if (!keySHV.isEmpty()) {
-      uint32_t bucket =
-          hashToBucket(self->capacity_, runtime, keySHV.unboxToHV(runtime));
-      [[maybe_unused]] const uint32_t firstBucket = bucket;
-      assert(bucket < *newCapacity && "Hash table index >= new capacity.");
-      while (newHashTable[bucket] != kHashTableElementUnused) {
-        // Find another bucket if it is already used.
-        bucket = (bucket + 1) & mask;
-        assert(firstBucket != bucket && "Hash table is full!");
-        assert(bucket < *newCapacity && "Hash table index >= new capacity.");
-      }
-      // Set the new entry to the bucket.
-      lv.newDataTable->set(newDataTableKeyIndex, keySHV, runtime.getHeap());
-      if constexpr (std::is_same_v<BucketType, HashMapEntry>) {
-        auto valueSHV =
-            self->dataTable_.getNonNull(runtime)->at(oldDataTableKeyIndex + 1);
-        lv.newDataTable->set(
-            newDataTableKeyIndex + 1, valueSHV, runtime.getHeap());
-      }
-      assert(bucket < *newCapacity && "Hash table index >= new capacity.");
-      newHashTable[bucket] = newDataTableKeyIndex;
-
-      newDataTableKeyIndex += BucketType::kElementsPerEntry;
-    } else {
-      // Entry is deleted.
-      deletedEntryIndices.push_back(i);
+  OrderedHashMapBase<BucketType, Derived> *rawSelf = *self;
+  StorageType *oldDataTable = rawSelf->dataTable_.getNonNull(runtime);
+  for (uint32_t i = 0; i < dataTableSize; ++i)
+    lv.newDataTable->set(i, oldDataTable->at(i), runtime.getHeap());
+
+  // Now re-add all buckets to a new hash table, using their stored hashes.
+  std::vector<Bucket> newHashTable;
+  newHashTable.resize(*newCapacity, kUnusedBucket);
+  const uint32_t mask = *newCapacity - 1;
+  for (const Bucket &entry : rawSelf->hashTable_) {
+    if (entry.dataTableKeyIndex == kHashTableElementUnused)
+      continue;
+    uint32_t bucket = hashToBucket(*newCapacity, entry.hash);
+    [[maybe_unused]] const uint32_t firstBucket = bucket;
+    while (newHashTable[bucket].dataTableKeyIndex != kHashTableElementUnused) {
+      // Find another bucket if it is already used.
+      bucket = (bucket + 1) & mask;
+      assert(firstBucket != bucket && "Hash table is full!");
     }
-    oldDataTableKeyIndex += BucketType::kElementsPerEntry;
+    newHashTable[bucket] = entry;
   }
 
-  NoAllocScope noAlloc{runtime};
-
-  OrderedHashMapBase<BucketType, Derived> *rawSelf = *self;
-
-  // Adjust any active iterators to handle the fact that we removed deleted
-  // entries in the new data table.
-  rawSelf->updateIteratorIndicesForRehash(deletedEntryIndices);
-
-  rawSelf->deletedCount_ = 0;
-  // The external memory credit tracks hashTable_.size() * sizeof(uint32_t).
+  rawSelf->capacity_ = *newCapacity;
+  // The external memory credit tracks hashTable_.size() * sizeof(Bucket).
   // The new table may be larger or smaller than the old one, so settle the
   // difference in whichever direction it went.
-  const uint32_t oldSizeInBytes = rawSelf->hashTable_.size() * sizeof(uint32_t);
-  const uint32_t newSizeInBytes = newHashTable.size() * sizeof(uint32_t);
+  const uint32_t oldSizeInBytes = rawSelf->hashTable_.size() * sizeof(Bucket);
+  const uint32_t newSizeInBytes = newHashTable.size() * sizeof(Bucket);
   rawSelf->hashTable_ = std::move(newHashTable);
   if (newSizeInBytes >= oldSizeInBytes) {
     runtime.getHeap().creditExternalMemory(
@@ -378,8 +399,7 @@ bool OrderedHashMapBase<BucketType, Derived>::has(
     HermesValue key) const {
   NoAllocScope noAlloc{runtime};
   assertInitialized();
-  auto bucket = hashToBucket(capacity_, runtime, key);
-  return lookupInBucket(runtime, bucket, key).first.hasValue();
+  return lookupInBucket(runtime, hashKey(runtime, key), key).first.hasValue();
 }
 
 template <typename BucketType, typename Derived>
@@ -388,9 +408,8 @@ SmallHermesValue OrderedHashMapBase<BucketType, Derived>::get(
     HermesValue key) const {
   NoAllocScope noAlloc{runtime};
   assertInitialized();
-  auto bucket = hashToBucket(capacity_, runtime, key);
   OptValue<uint32_t> dataTableKeyIndex =
-      lookupInBucket(runtime, bucket, key).first;
+      lookupInBucket(runtime, hashKey(runtime, key), key).first;
   if (!dataTableKeyIndex.hasValue()) {
     return SmallHermesValue::encodeUndefinedValue();
   }
@@ -405,16 +424,15 @@ ExecutionStatus OrderedHashMapBase<BucketType, Derived>::insert(
     Handle<> key,
     Handle<> value) {
   self->assertInitialized();
-  uint32_t bucket = hashToBucket(self->capacity_, runtime, *key);
+  const uint32_t hash = hashKey(runtime, *key);
+  uint32_t bucket;
 
   // Find the bucket for this key. If the entry already exists, update the value
   // and return.
   {
     OptValue<uint32_t> dataTableKeyIndex;
-    uint32_t newBucket;
-    std::tie(dataTableKeyIndex, newBucket) =
-        self->lookupInBucket(runtime, bucket, key.getHermesValue());
-    bucket = newBucket;
+    std::tie(dataTableKeyIndex, bucket) =
+        self->lookupInBucket(runtime, hash, key.getHermesValue());
     if (dataTableKeyIndex.hasValue()) {
       // Element for the key already exists, update value and return.
       auto valueSHV =
@@ -425,7 +443,7 @@ ExecutionStatus OrderedHashMapBase<BucketType, Derived>::insert(
     }
   }
 
-  return doInsert(self, runtime, bucket, key, value);
+  return doInsert(self, runtime, bucket, hash, key, value);
 }
 
 template <typename BucketType, typename Derived>
@@ -436,12 +454,13 @@ CallResult<HermesValue> OrderedHashMapBase<BucketType, Derived>::getOrInsert(
     Handle<> key,
     Handle<> value) {
   self->assertInitialized();
-  uint32_t bucket = hashToBucket(self->capacity_, runtime, *key);
+  const uint32_t hash = hashKey(runtime, *key);
+  uint32_t bucket;
   {
     NoAllocScope noAlloc{runtime};
     OptValue<uint32_t> dataTableKeyIndex;
     std::tie(dataTableKeyIndex, bucket) =
-        self->lookupInBucket(runtime, bucket, key.getHermesValue());
+        self->lookupInBucket(runtime, hash, key.getHermesValue());
     if (dataTableKeyIndex.hasValue()) {
       // Element for the key already exists; return its value without
       // overwriting.
@@ -453,7 +472,7 @@ CallResult<HermesValue> OrderedHashMapBase<BucketType, Derived>::getOrInsert(
 
   // Key is absent; insert at the bucket we just resolved and return the value.
   if (LLVM_UNLIKELY(
-          doInsert(self, runtime, bucket, key, value) ==
+          doInsert(self, runtime, bucket, hash, key, value) ==
           ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
@@ -469,12 +488,13 @@ OrderedHashMapBase<BucketType, Derived>::getOrInsertComputed(
     Handle<> key,
     Handle<Callable> callback) {
   self->assertInitialized();
-  uint32_t bucket = hashToBucket(self->capacity_, runtime, *key);
+  const uint32_t hash = hashKey(runtime, *key);
+  uint32_t bucket;
   {
     NoAllocScope noAlloc{runtime};
     OptValue<uint32_t> dataTableKeyIndex;
     std::tie(dataTableKeyIndex, bucket) =
-        self->lookupInBucket(runtime, bucket, key.getHermesValue());
+        self->lookupInBucket(runtime, hash, key.getHermesValue());
     if (dataTableKeyIndex.hasValue()) {
       // Element for the key already exists; return its value without
       // overwriting.
@@ -510,7 +530,7 @@ OrderedHashMapBase<BucketType, Derived>::getOrInsertComputed(
   // Fast path: the bucket above is still valid and can be used for insertion.
   if (LLVM_LIKELY(!self->cachedBucketInvalidated_)) {
     if (LLVM_UNLIKELY(
-            doInsert(self, runtime, bucket, key, lv.value) ==
+            doInsert(self, runtime, bucket, hash, key, lv.value) ==
             ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
@@ -531,20 +551,21 @@ ExecutionStatus OrderedHashMapBase<BucketType, Derived>::insert(
     Runtime &runtime,
     Handle<> key) {
   self->assertInitialized();
-  uint32_t bucket = hashToBucket(self->capacity_, runtime, *key);
+  const uint32_t hash = hashKey(runtime, *key);
+  uint32_t bucket;
 
   // Find the bucket for this key. If the entry already exists, then return.
   {
     OptValue<uint32_t> dataTableKeyIndex;
     std::tie(dataTableKeyIndex, bucket) =
-        self->lookupInBucket(runtime, bucket, key.getHermesValue());
+        self->lookupInBucket(runtime, hash, key.getHermesValue());
     if (dataTableKeyIndex.hasValue()) {
       return ExecutionStatus::RETURNED;
     }
   }
 
   return doInsert(
-      self, runtime, bucket, key, HandleRootOwner::getUndefinedValue());
+      self, runtime, bucket, hash, key, HandleRootOwner::getUndefinedValue());
 }
 
 template <typename BucketType, typename Derived>
@@ -552,6 +573,7 @@ ExecutionStatus OrderedHashMapBase<BucketType, Derived>::doInsert(
     Handle<Derived> self,
     Runtime &runtime,
     uint32_t bucket,
+    uint32_t hash,
     Handle<> key,
     Handle<> value) {
   // Appending an entry can invalidate a cached bucket index.
@@ -563,25 +585,33 @@ ExecutionStatus OrderedHashMapBase<BucketType, Derived>::doInsert(
 
   // Run rehash if necessary before inserting.
   if (shouldRehash(self->capacity_, self->size_, self->deletedCount_)) {
-    if (LLVM_UNLIKELY(
-            rehash(self, runtime, true) == ExecutionStatus::EXCEPTION)) {
-      return ExecutionStatus::EXCEPTION;
-    }
+    if (self->deletedCount_ >= self->size_ &&
+        !shouldShrink(self->capacity_, self->size_ + 1)) {
+      // At least half of the data table is deleted entries, so removing them
+      // makes enough room without changing the capacity. The buckets don't
+      // move, so \p bucket remains valid.
+      self->compact(runtime);
+    } else {
+      if (LLVM_UNLIKELY(
+              rehash(self, runtime, true) == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
 
-    // Find a new empty bucket after rehash.
-    bucket = hashToBucket(self->capacity_, runtime, *key);
-    OptValue<uint32_t> dataTableKeyIndex;
-    std::tie(dataTableKeyIndex, bucket) =
-        self->lookupInBucket(runtime, bucket, key.getHermesValue());
-    assert(
-        !dataTableKeyIndex.hasValue() &&
-        "After rehash, we must be able to find an empty bucket");
+      // Find a new empty bucket after rehash.
+      OptValue<uint32_t> dataTableKeyIndex;
+      std::tie(dataTableKeyIndex, bucket) =
+          self->lookupInBucket(runtime, hash, key.getHermesValue());
+      assert(
+          !dataTableKeyIndex.hasValue() &&
+          "After rehash, we must be able to find an empty bucket");
+    }
   }
 
   // Store the data table index in \p hashTable_ so we can go from hash table to
   // the actual data
   assert(bucket < self->capacity_ && "Hash table index >= capacity.");
-  self->hashTable_[bucket] = self->dataTable_.getNonNull(runtime)->size();
+  self->hashTable_[bucket] = {
+      self->dataTable_.getNonNull(runtime)->size(), hash};
 
   lv.dataTable = self->dataTable_.getNonNull(runtime);
   assert(
@@ -605,16 +635,16 @@ bool OrderedHashMapBase<BucketType, Derived>::erase(
     Runtime &runtime,
     Handle<> key) {
   self->assertInitialized();
-  uint32_t bucket = hashToBucket(self->capacity_, runtime, *key);
+  uint32_t bucket;
   OptValue<uint32_t> dataTableKeyIndex;
-  std::tie(dataTableKeyIndex, bucket) =
-      self->lookupInBucket(runtime, bucket, key.getHermesValue());
+  std::tie(dataTableKeyIndex, bucket) = self->lookupInBucket(
+      runtime, hashKey(runtime, *key), key.getHermesValue());
   if (!dataTableKeyIndex.hasValue()) {
     // Element does not exist.
     return false;
   }
 
-  // Mark the bucket as deleted. We remove this in rehash.
+  // Delete the bucket. The entry in the data table is removed in rehash.
   deleteBucket(self, runtime, bucket, *dataTableKeyIndex);
   self->deletedCount_++;
   self->size_--;
@@ -711,14 +741,14 @@ ExecutionStatus OrderedHashMapBase<BucketType, Derived>::clear(
   self->cachedBucketInvalidated_ = true;
 
   // Clear the hash table. The external memory credit tracks
-  // hashTable_.size() * sizeof(uint32_t), so debit the difference between the
+  // hashTable_.size() * sizeof(Bucket), so debit the difference between the
   // discarded table and the reinitialized one.
-  const uint32_t oldSizeInBytes = self->hashTable_.size() * sizeof(uint32_t);
-  self->hashTable_ = std::vector<uint32_t>();
+  const uint32_t oldSizeInBytes = self->hashTable_.size() * sizeof(Bucket);
+  self->hashTable_ = std::vector<Bucket>();
   // Resize the hash table to the initial size.
-  self->hashTable_.resize(kInitialCapacity, kHashTableElementUnused);
+  self->hashTable_.resize(kInitialCapacity, kUnusedBucket);
   self->capacity_ = kInitialCapacity;
-  constexpr uint32_t newSizeInBytes = kInitialCapacity * sizeof(uint32_t);
+  constexpr uint32_t newSizeInBytes = kInitialCapacity * sizeof(Bucket);
   assert(
       oldSizeInBytes >= newSizeInBytes &&
       "Capacity never shrinks below kInitialCapacity");
@@ -124,6 +124,7 @@ HermesValue JSString::_getOwnIndexedImpl(
   NoAllocScope noAllocs{runtime};
 
   if (LLVM_LIKELY(index < str->getStringLength())) {
+    StringPrimitive::flattenIfRope(runtime, str);
     auto chr = str->at(index);
     noAllocs.release();
     return runtime.getCharacterString(chr).getHermesValue();
@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/PropertyCache.h"
+
+#include "hermes/VM/JSObject.h"
+#include "hermes/VM/Runtime.h"
+
+namespace hermes {
+namespace vm {
+
+JSObject *PolymorphicPropertyCache::tryRead(
+    Runtime &runtime,
+    ReadPropertyCacheEntry *entry,
+    JSObject *obj,
+    SymbolID name,
+    SlotIndex &slot) {
+  JSObject *propObj = tryReadImpl(runtime, entry, obj, name, slot);
+#ifdef HERMESVM_PROPERTY_CACHE_STATS
+  countLookup(
+      runtime, entry, entry->polyIndex, name, false, propObj != nullptr);
+#endif
+  return propObj;
+}
+
+bool PolymorphicPropertyCache::tryWrite(
+    Runtime &runtime,
+    WritePropertyCacheEntry *entry,
+    JSObject *obj,
+    SymbolID name,
+    SlotIndex &slot) {
+  bool hit = tryWriteImpl(entry, obj, name, slot);
+#ifdef HERMESVM_PROPERTY_CACHE_STATS
+  countLookup(runtime, entry, entry->polyIndex, name, true, hit);
+#else
+  (void)runtime;
+#endif
+  return hit;
+}
+
+inline JSObject *PolymorphicPropertyCache::tryReadImpl(
+    Runtime &runtime,
+    ReadPropertyCacheEntry *entry,
+    JSObject *obj,
+    SymbolID name,
+    SlotIndex &slot) {
+  if (LLVM_LIKELY(!entry->polyIndex))
+    return nullptr;
+  Site &site = sites_[entry->polyIndex - 1];
+  CompressedPointer clazzPtr{obj->getClassGCPtr()};
+
+  if (!site.megamorphic) {
+    for (const Way &way : site.ways) {
+      if (way.clazz == clazzPtr) {
+        ++site.polyHits;
+        slot = way.slot;
+        return obj;
+      }
+      if (way.negMatchClazz == clazzPtr) {
+        // Proxy, HostObject and lazy objects have special hidden classes, so
+        // they should never match the cached class.
+        assert(!obj->getFlags().proxyObject);
+        assert(!obj->getFlags().hostObject);
+        assert(!obj->getFlags().lazyObject);
+        const GCPointer<JSObject> &parentGCPtr = obj->getParentGCPtr();
+        if (!parentGCPtr)
+          break;
+        JSObject *parent = parentGCPtr.getNonNull(runtime);
+        if (way.clazz != parent->getClassGCPtr())
+          break;
+        ++site.polyHits;
+        slot = way.slot;
+        return parent;
+      }
+    }
+    ++site.misses;
+    return nullptr;
+  }
+
+  const MegaEntry &mega = megaEntry(clazzPtr, name);
+  if (mega.clazz == clazzPtr && mega.name == name) {
+    ++site.megaHits;
+    slot = mega.slot;
+    return obj;
+  }
+  ++site.misses;
+  return nullptr;
+}
+
+inline bool PolymorphicPropertyCache::tryWriteImpl(
+    WritePropertyCacheEntry *entry,
+    JSObject *obj,
+    SymbolID name,
+    SlotIndex &slot) {
+  if (LLVM_LIKELY(!entry->polyIndex))
+    return false;
+  Site &site = sites_[entry->polyIndex - 1];
+  CompressedPointer clazzPtr{obj->getClassGCPtr()};
+
+  if (!site.megamorphic) {
+    for (const Way &way : site.ways) {
+      if (way.clazz == clazzPtr) {
+        ++site.polyHits;
+        slot = way.slot;
+        return true;
+      }
+    }
+    ++site.misses;
+    return false;
+  }
+
+  const MegaEntry &mega = megaEntry(clazzPtr, name);
+  if (mega.clazz == clazzPtr && mega.name == name && mega.writable) {
+    ++site.megaHits;
+    slot = mega.slot;
+    return true;
+  }
+  ++site.misses;
+  return false;
+}
+
+void PolymorphicPropertyCache::recordRead(
+    ReadPropertyCacheEntry *entry,
+    CompressedPointer clazz,
+    CompressedPointer negMatchClazz,
+    SlotIndex slot,
+    SymbolID name) {
+  // Objects are matched against the cached negMatchClazz if there is one, and
+  // against the cached clazz otherwise.
+  CompressedPointer key = negMatchClazz ? negMatchClazz : clazz;
+  CompressedPointer monoKey = entry->negMatchClazz
+      ? entry->negMatchClazz.getNoBarrierUnsafe()
+      : entry->clazz.getNoBarrierUnsafe();
+  Site *site = !entry->clazz || monoKey == key
+      ? nullptr
+      : getOrCreateSite(entry->polyIndex);
+  if (!site) {
+    entry->clazz = clazz;
+    entry->negMatchClazz = negMatchClazz;
+    entry->setSlot(slot);
+    return;
+  }
+  if (addWay(*site, clazz, negMatchClazz, slot))
+    return;
+  // The megamorphic table is keyed by the class holding the property, so it
+  // can only cache own properties.
+  if (!negMatchClazz)
+    addMega(clazz, name, slot, false);
+}
+
+void PolymorphicPropertyCache::recordWrite(
+    WritePropertyCacheEntry *entry,
+    CompressedPointer clazz,
+    SlotIndex slot,
+    SymbolID name) {
+  Site *site = !entry->clazz || entry->clazz == clazz
+      ? nullptr
+      : getOrCreateSite(entry->polyIndex);
+  if (!site) {
+    // Preserve the addCacheIndex if the slot hasn't changed.
+    entry->clazz = clazz;
+    entry->setSlot(slot);
+    return;
+  }
+  if (addWay(*site, clazz, CompressedPointer(nullptr), slot))
+    return;
+  addMega(clazz, name, slot, true);
+}
+
+PolymorphicPropertyCache::Stats PolymorphicPropertyCache::getStats() const {
+  Stats stats;
+  stats.numPolymorphicSites = sites_.size();
+  stats.numMegamorphicSites = numMegamorphicSites_;
+  for (const Site &site : sites_) {
+    stats.polyHits += site.polyHits;
+    stats.megaHits += site.megaHits;
+    stats.misses += site.misses;
+  }
+  return stats;
+}
+
+void PolymorphicPropertyCache::markWeakRoots(WeakRootAcceptor &acceptor) {
+  for (Site &site : sites_) {
+    if (site.megamorphic)
+      continue;
+    for (Way &way : site.ways) {
+      acceptor.acceptWeak(way.clazz);
+      acceptor.acceptWeak(way.negMatchClazz);
+    }
+  }
+  if (!megaTable_)
+    return;
+  for (size_t i = 0, e = size_t(1) << kLog2MegaSize; i < e; ++i) {
+    acceptor.acceptWeak(megaTable_[i].clazz);
+    acceptor.acceptWeakSym(megaTable_[i].name);
+  }
+}
+
+size_t PolymorphicPropertyCache::getMemorySize() const {
+  size_t size = sites_.capacity() * sizeof(Site) +
+      (megaTable_ ? sizeof(MegaEntry) << kLog2MegaSize : 0);
+#ifdef HERMESVM_PROPERTY_CACHE_STATS
+  size += entryStatsIndex_.getMemorySize() +
+      entryStats_.capacity() * sizeof(EntryStats);
+#endif
+  return size;
+}
+
+#ifdef HERMESVM_PROPERTY_CACHE_STATS
+PolymorphicPropertyCache::EntryStats &PolymorphicPropertyCache::getEntryStats(
+    Runtime &runtime,
+    const void *entry,
+    SymbolID name,
+    bool write) {
+  auto [it, inserted] = entryStatsIndex_.try_emplace(entry, entryStats_.size());
+  if (inserted) {
+    entryStats_.push_back(
+        {runtime.getIdentifierTable().convertSymbolToUTF8(name), write});
+  }
+  return entryStats_[it->second];
+}
+
+void PolymorphicPropertyCache::countLookup(
+    Runtime &runtime,
+    const void *entry,
+    uint32_t polyIndex,
+    SymbolID name,
+    bool write,
+    bool hit) {
+  EntryStats &stats = getEntryStats(runtime, entry, name, write);
+  if (!hit)
+    ++stats.misses;
+  else if (getSite(polyIndex)->megamorphic)
+    ++stats.megaHits;
+  else
+    ++stats.polyHits;
+}
+#endif
+
+PolymorphicPropertyCache::MegaEntry &PolymorphicPropertyCache::megaEntry(
+    CompressedPointer clazz,
+    SymbolID name) {
+  assert(megaTable_ && "megamorphic table has not been allocated");
+  // HiddenClasses are at least 8-byte aligned, so drop the low bits of the
+  // pointer and mix in the symbol with a multiplicative hash.
+  uint32_t hash = static_cast<uint32_t>(clazz.getRaw() >> 3) ^
+      (name.unsafeGetRaw() * 0x9E3779B1u);
+  return megaTable_[hash & ((1u << kLog2MegaSize) - 1)];
+}
+
+PolymorphicPropertyCache::Site *PolymorphicPropertyCache::getOrCreateSite(
+    uint32_t &polyIndex) {
+  if (polyIndex)
+    return &sites_[polyIndex - 1];
+  if (sites_.size() >= kMaxSites)
+    return nullptr;
+  sites_.emplace_back();
+  polyIndex = sites_.size();
+  return &sites_.back();
+}
+
+bool PolymorphicPropertyCache::addWay(
+    Site &site,
+    CompressedPointer clazz,
+    CompressedPointer negMatchClazz,
+    SlotIndex slot) {
+  if (site.megamorphic)
+    return false;
+  CompressedPointer key = negMatchClazz ? negMatchClazz : clazz;
+  Way *freeWay = nullptr;
+  for (Way &way : site.ways) {
+    CompressedPointer wayKey = way.negMatchClazz
+        ? way.negMatchClazz.getNoBarrierUnsafe()
+        : way.clazz.getNoBarrierUnsafe();
+    if (wayKey == key) {
+      freeWay = &way;
+      break;
+    }
+    // Ways whose class has been collected can be reused.
+    if (!way.clazz && !freeWay)
+      freeWay = &way;
+  }
+  if (freeWay) {
+    freeWay->clazz = clazz;
+    freeWay->negMatchClazz = negMatchClazz;
+    freeWay->slot = slot;
+    return true;
+  }
+
+  // All ways are taken by live classes: switch to the megamorphic table.
+  for (Way &way : site.ways) {
+    way.clazz = CompressedPointer(nullptr);
+    way.negMatchClazz = CompressedPointer(nullptr);
+  }
+  site.megamorphic = true;
+  ++numMegamorphicSites_;
+  if (!megaTable_)
+    megaTable_.reset(new MegaEntry[size_t(1) << kLog2MegaSize]);
+  return false;
+}
+
+void PolymorphicPropertyCache::addMega(
+    CompressedPointer clazz,
+    SymbolID name,
+    SlotIndex slot,
+    bool write) {
+  MegaEntry &mega = megaEntry(clazz, name);
+  if (mega.clazz == clazz && mega.name == name && mega.slot == slot) {
+    // Reads don't know whether the property is writable, so keep what a
+    // previous write recorded.
+    mega.writable |= write;
+    return;
+  }
+  mega.clazz = clazz;
+  mega.name = name;
+  mega.slot = slot;
+  mega.writable = write;
+}
+
+} // namespace vm
+} // namespace hermes
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/RegExpCache.h"
+
+namespace hermes {
+namespace vm {
+
+std::u16string RegExpCache::makeKey(
+    llvh::ArrayRef<char16_t> pattern,
+    uint8_t flagsByte) {
+  std::u16string key;
+  key.reserve(pattern.size() + 1);
+  key.push_back(flagsByte);
+  key.append(pattern.begin(), pattern.end());
+  return key;
+}
+
+size_t RegExpCache::memorySizeOf(
+    const std::u16string &key,
+    const Entry &entry) {
+  size_t size = sizeof(Slot) + key.capacity() * sizeof(char16_t) +
+      entry.bytecode.size + entry.groupNamesMapping.getMemorySize();
+  for (const auto &name : entry.orderedGroupNames)
+    size += sizeof(name) + name.capacity_in_bytes();
+  return size;
+}
+
+const RegExpCache::Entry *RegExpCache::lookup(
+    llvh::ArrayRef<char16_t> pattern,
+    uint8_t flagsByte) {
+  if (pattern.size() > kMaxPatternLength) {
+    ++stats_.misses;
+    return nullptr;
+  }
+  auto it = map_.find(makeKey(pattern, flagsByte));
+  if (it == map_.end()) {
+    ++stats_.misses;
+    return nullptr;
+  }
+  ++stats_.hits;
+  lru_.use(it->second.lruPos);
+  return &it->second.entry;
+}
+
+const RegExpCache::Entry *RegExpCache::insert(
+    llvh::ArrayRef<char16_t> pattern,
+    uint8_t flagsByte,
+    Entry &&entry) {
+  if (capacity_ == 0 || pattern.size() > kMaxPatternLength)
+    return nullptr;
+
+  // Make room by evicting the least recently used entry.
+  if (map_.size() >= capacity_) {
+    const std::u16string **lruPos = lru_.leastRecent();
+    auto it = map_.find(**lruPos);
+    assert(it != map_.end() && "LRU key must be in the map");
+    memorySize_ -= memorySizeOf(it->first, it->second.entry);
+    lru_.remove(lruPos);
+    map_.erase(it);
+    ++stats_.evictions;
+  }
+
+  auto [it, inserted] =
+      map_.try_emplace(makeKey(pattern, flagsByte), Slot{std::move(entry)});
+  assert(inserted && "pattern is already cached");
+  (void)inserted;
+  it->second.lruPos = lru_.add(&it->first);
+  memorySize_ += memorySizeOf(it->first, it->second.entry);
+  return &it->second.entry;
+}
+
+} // namespace vm
+} // namespace hermes
@@ -302,6 +302,8 @@ Runtime::Runtime(
       hasES6BlockScoping_(runtimeConfig.getES6BlockScoping()),
       hasIntl_(runtimeConfig.getIntl()),
       hasMicrotaskQueue_(runtimeConfig.getMicrotaskQueue()),
+      hasRegExpLinearTime_(runtimeConfig.getRegExpLinearTime()),
+      agentCanSuspend_(runtimeConfig.getAgentCanSuspend()),
       shouldRandomizeMemoryLayout_(runtimeConfig.getRandomizeMemoryLayout()),
       bytecodeWarmupPercent_(runtimeConfig.getBytecodeWarmupPercent()),
       trackIO_(runtimeConfig.getTrackIO()),
@@ -485,7 +487,11 @@ Runtime::Runtime(
   jitContext_.setEnabled(runtimeConfig.getEnableJIT());
   jitContext_.setForceJIT(runtimeConfig.getForceJIT());
   jitContext_.setDefaultExecThreshold(runtimeConfig.getJITThreshold());
+  jitContext_.setOSRThreshold(runtimeConfig.getJITOSRThreshold());
+  jitContext_.setRegExpThreshold(runtimeConfig.getJITRegExpThreshold());
   jitContext_.setMemoryLimit(runtimeConfig.getJITMemoryLimit());
+  jitContext_.setMaxQueuedCompiles(runtimeConfig.getJITQueueLimit());
+  jitContext_.setBackgroundCompile(runtimeConfig.getJITBackground());
   codeCoverageProfiler_->restore();
 
   // Populate JS builtins returned from internal bytecode to the builtins table.
@@ -510,6 +516,9 @@ Runtime::~Runtime() {
     cb();
   shutdownCallbacks_.clear();
 
+  // Queued JIT compilations refer to CodeBlocks that are about to be freed.
+  jitContext_.stopBackgroundCompiles();
+
   getHeap().finalizeAll();
 
   // Heap is now quiesced; run deleters for embedder objects that had to
@@ -797,6 +806,7 @@ void Runtime::markWeakRoots(WeakRootAcceptor &acceptor, bool markLongLived) {
           "negMatchClazz is always zero for non-JS code property cache");
       acceptor.acceptWeak(entry.clazz);
     }
+    polyPropCache_.markWeakRoots(acceptor);
   }
   for (auto &registry : finalizationRegistries_) {
     acceptor.acceptWeak(registry);
@@ -1060,9 +1070,10 @@ size_t Runtime::mallocSize() const {
       shSize += sh_unit_additional_memory_size(unit);
 
   // Register stack uses mmap and RuntimeModules are tracked by their owning
-  // Domains. So this only considers IdentifierTable size.
+  // Domains. So this only considers IdentifierTable and cache sizes.
   return shSize + sizeof(IdentifierTable) +
-      identifierTable_.additionalMemorySize();
+      identifierTable_.additionalMemorySize() +
+      polyPropCache_.getMemorySize() + regExpCache_.getMemorySize();
 }
 
 #if HERMESVM_SANITIZE_HANDLES != 0
@@ -2130,7 +2141,9 @@ uint64_t Runtime::gcStableHashHermesValue(HermesValue value) {
     }
     case HermesValue::Tag::Str: {
       // For strings, we hash the string content.
-      return vmcast<StringPrimitive>(value)->getOrComputeHash();
+      auto *str = vmcast<StringPrimitive>(value);
+      StringPrimitive::flattenIfRope(*this, str);
+      return str->getOrComputeHash();
     }
     default:
       assert(!value.isPointer() && "Unhandled pointer type");
@@ -2156,6 +2169,7 @@ uint64_t Runtime::gcStableHashJSObject(JSObject *object) {
 
 bool Runtime::symbolEqualsToStringPrim(SymbolID id, StringPrimitive *strPrim) {
   auto view = identifierTable_.getStringView(*this, id);
+  StringPrimitive::flattenIfRope(*this, strPrim);
   return strPrim->equals(view);
 }
 
@@ -28,6 +28,11 @@ vm::RuntimeConfig buildRuntimeConfig(const RuntimeFlags &flags) {
               .withShouldReleaseUnused(vm::kReleaseUnusedOld)
               .withAllocInYoung(flags.GCAllocYoung)
               .withRevertToYGAtTTI(flags.GCRevertToYGAtTTI)
+              .withYoungGenEvacuationThreads(
+                  flags.GCYoungGenEvacuationThreads)
+              .withOldGenMarkingThreads(flags.GCOldGenMarkingThreads)
+              .withOldGenSweepingThreads(flags.GCOldGenSweepingThreads)
+              .withSweepOnAllocation(flags.GCSweepOnAllocation)
               .build())
       .withMaxNumRegisters(flags.MaxNumRegisters)
       .withEnableEval(flags.EnableEval)
@@ -38,6 +43,7 @@ vm::RuntimeConfig buildRuntimeConfig(const RuntimeFlags &flags) {
       .withES6Proxy(flags.ES6Proxy)
       .withIntl(flags.Intl)
       .withMicrotaskQueue(flags.MicrotaskQueue)
+      .withRegExpLinearTime(flags.RegExpLinearTime)
       .withEnableSampleProfiling(
           flags.SampleProfiling != ExecuteOptions::SampleProfilingMode::None)
       .withRandomizeMemoryLayout(flags.RandomizeMemoryLayout)
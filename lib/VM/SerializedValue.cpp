@@ -32,6 +32,8 @@ namespace {
 LLVM_PACKED_START
 struct StringMetadataElement {
   bool isAscii;
+  /// The string data is the index of a shared buffer.
+  bool isShared;
   uint32_t len;
 };
 LLVM_PACKED_END
@@ -201,15 +203,30 @@ CallResult<PseudoHandle<BigIntPrimitive>> deserializeBigInt(
   return createPseudoHandle(vmcast<BigIntPrimitive>(*bigIntPrimRes));
 }
 
+/// \return a buffer with the characters of the external length string \p
+/// strPrim that can be shared with other runtimes. An ExternalStringPrimitive
+/// hands over its own buffer, so its characters are not copied.
+template <typename T>
+typename ExternalStringPrimitive<T>::SharedStdString shareString(
+    StringPrimitive *strPrim) {
+  if (auto *extStr = dyn_vmcast<ExternalStringPrimitive<T>>(strPrim))
+    return extStr->share();
+  auto data = strPrim->getStringRef<T>();
+  return std::make_shared<const CopyableBasicString<T>>(
+      std::basic_string<T>(data.begin(), data.end()));
+}
+
 /// Determines the ID for \p strPrim and append it to the content buffer of \p
 /// serialized. If \p stringPrim has not been serialized already, then append
 /// its encoding in the strings buffer of \p serialized, assign it a string ID,
 /// and add corresponding entry in the offset buffer of \p serialized.
 /// Otherwise, look up the string ID in \p memoryMap.
 /// The string in the string buffer will be serialized with the format (isAscii,
-/// length, string data). If isAscii is true, then the string data should be
-/// interpreted as a sequence of char. Else, it should be interpreted as a
-/// sequence of char16_t.
+/// isShared, length, string data). If isAscii is true, then the string data
+/// should be interpreted as a sequence of char. Else, it should be interpreted
+/// as a sequence of char16_t. If isShared is true, the string data is instead
+/// the index of the buffer holding the characters in the sharedASCIIStrings or
+/// sharedUTF16Strings vector of \p serialized.
 void serializeString(
     Runtime &runtime,
     SerializedValue &serialized,
@@ -217,6 +234,7 @@ void serializeString(
     SerializationValueDenseMap &memoryMap) {
   NoAllocScope noAllocScope(runtime);
 
+  StringPrimitive::flattenIfRope(runtime, strPrim);
   uint32_t hash = strPrim->getOrComputeHash();
   // Check if the string has already been serialized. If so, append the string
   // ID and return
@@ -236,15 +254,29 @@ void serializeString(
   // Also store the ID in the memory map for future look ups.
   memoryMap[valuePtr] = strId;
 
-  // Encode the content of the string in the format (isAscii, length, data)
+  // Encode the content of the string in the format (isAscii, isShared, length,
+  // data)
   bool isAscii = strPrim->isASCII();
   StringMetadataElement stringMetaData;
   stringMetaData.isAscii = isAscii;
+  stringMetaData.isShared =
+      strPrim->getStringLength() >= StringPrimitive::EXTERNAL_STRING_THRESHOLD;
   stringMetaData.len = strPrim->getStringLength();
   appendValueToBuffer<StringMetadataElement>(
       serialized.strings, stringMetaData);
 
-  if (isAscii) {
+  if (stringMetaData.isShared) {
+    // Large strings are not copied into the buffer, but referenced.
+    if (isAscii) {
+      appendValueToBuffer<uint32_t>(
+          serialized.strings, serialized.sharedASCIIStrings.size());
+      serialized.sharedASCIIStrings.push_back(shareString<char>(strPrim));
+    } else {
+      appendValueToBuffer<uint32_t>(
+          serialized.strings, serialized.sharedUTF16Strings.size());
+      serialized.sharedUTF16Strings.push_back(shareString<char16_t>(strPrim));
+    }
+  } else if (isAscii) {
     auto data = strPrim->getStringRef<char>();
     serialized.strings.insert(
         serialized.strings.end(), data.begin(), data.end());
@@ -291,7 +323,20 @@ CallResult<PseudoHandle<StringPrimitive>> deserializeString(
   currStringOffset += sizeof(StringMetadataElement);
 
   StringPrimitive *str;
-  if (metadata->isAscii) {
+  if (metadata->isShared) {
+    // Wrap the shared buffer without copying the characters.
+    const uint8_t *indexPtr = &strings[currStringOffset];
+    uint32_t index = deserializeUInt32(indexPtr);
+    auto result = metadata->isAscii
+        ? ExternalASCIIStringPrimitive::createShared(
+              runtime, serialized.sharedASCIIStrings[index])
+        : ExternalUTF16StringPrimitive::createShared(
+              runtime, serialized.sharedUTF16Strings[index]);
+    if (LLVM_UNLIKELY(result == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    str = result->getString();
+  } else if (metadata->isAscii) {
     auto dataBytes =
         llvh::makeArrayRef<uint8_t>(&strings[currStringOffset], metadata->len);
 
@@ -1150,6 +1195,59 @@ CallResult<PseudoHandle<JSArrayBuffer>> deserializeArrayBuffer(
   return createPseudoHandle(*lv.self);
 }
 
+/// Serialize the JS SharedArrayBuffer \p arrayBuffer at the end of \p
+/// serialized with the format (size, index in shared buffer list). The data
+/// block is shared, not copied.
+/// Implements 13.1 of StructuredSerializeInternal
+void serializeSharedArrayBuffer(
+    Runtime &runtime,
+    SerializedValue &serialized,
+    Handle<JSArrayBuffer> arrayBuffer) {
+  assert(arrayBuffer->shared() && "Expected a SharedArrayBuffer");
+  // 1. If IsSharedArrayBuffer(value) is true, then:
+  //   1-4. All the runtimes in the process are in the same agent cluster, and
+  //   the data block can be shared with any of them.
+  //   5. Set serialized to { [[Type]]: "SharedArrayBuffer",
+  //   [[ArrayBufferData]]: value.[[ArrayBufferData]],
+  //   [[ArrayBufferByteLength]]: value.[[ArrayBufferByteLength]],
+  //   [[AgentCluster]]: agentCluster }.
+  appendValueToBuffer<uint32_t>(serialized.content, arrayBuffer->size());
+  appendValueToBuffer<uint32_t>(
+      serialized.content, serialized.sharedBuffers.size());
+  serialized.sharedBuffers.emplace_back(
+      arrayBuffer->getDataBlock(),
+      JSArrayBuffer::getExternalDataContext(runtime, arrayBuffer));
+}
+
+/// Deserializes the data pointed by \p content into a JS SharedArrayBuffer
+/// over the shared data block it refers to. Update the pointer to point past
+/// the SharedArrayBuffer Record.
+/// Implements step 12 of StructuredDeserialize
+PseudoHandle<JSArrayBuffer> deserializeSharedArrayBuffer(
+    Runtime &runtime,
+    const SerializedValue &serialized,
+    const uint8_t *&content) {
+  // 12. Otherwise, if serialized.[[Type]] is "SharedArrayBuffer", then:
+  //   1. If targetRealm's corresponding agent cluster is not
+  //   serialized.[[AgentCluster]], then throw a "DataCloneError" DOMException.
+  //   2. Otherwise, set value to a new SharedArrayBuffer object in
+  //   targetRealm whose [[ArrayBufferData]] internal slot value is
+  //   serialized.[[ArrayBufferData]] and whose [[ArrayBufferByteLength]]
+  //   internal slot value is serialized.[[ArrayBufferByteLength]].
+  uint32_t size = deserializeUInt32(content);
+  uint32_t idx = deserializeUInt32(content);
+
+  struct : Locals {
+    PinnedValue<JSArrayBuffer> self;
+  } lv;
+  LocalsRAII lraii{runtime, &lv};
+
+  lv.self = JSArrayBuffer::create(runtime, runtime.sharedArrayBufferPrototype);
+  const auto &[data, context] = serialized.sharedBuffers[idx];
+  JSArrayBuffer::setSharedDataBlock(runtime, lv.self, data, size, context);
+  return createPseudoHandle(*lv.self);
+}
+
 /// Serialize the JS ArrayBuffer \p arrayBuffer for transfer at the end of \p
 /// serialized with the format (size, index in internal buffer list) for
 /// internal buffers. For external buffer, use the format (size, data pointer,
@@ -1523,16 +1621,24 @@ ExecutionStatus serializeImpl(
     serializeRegExp(runtime, serialized, regExp, memoryMap);
   } else if (auto *arrayBuffer = dyn_vmcast<JSArrayBuffer>(*value)) {
     // 13. Otherwise, if value has an [[ArrayBufferData]] internal slot, then:
-    //    1. SharedArrayBuffer case is unsupported
+    //    1. If IsSharedArrayBuffer(value) is true, then:
+    //       Handled in the helper below.
     //    2. Otherwise:
     // Note for 13.2, we do not support Resizeable ArrayBuffers so we can
     // serialize it as ArrayBuffer directly
-    content[typeTagOffset] =
-        getUInt8FromSerializedType(SerializedValue::Type::ArrayBuffer);
-    auto res = serializeArrayBuffer(runtime, serialized, arrayBuffer);
-    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
-      return ExecutionStatus::EXCEPTION;
-    };
+    if (arrayBuffer->shared()) {
+      content[typeTagOffset] =
+          getUInt8FromSerializedType(SerializedValue::Type::SharedArrayBuffer);
+      serializeSharedArrayBuffer(
+          runtime, serialized, Handle<JSArrayBuffer>::vmcast(value));
+    } else {
+      content[typeTagOffset] =
+          getUInt8FromSerializedType(SerializedValue::Type::ArrayBuffer);
+      auto res = serializeArrayBuffer(runtime, serialized, arrayBuffer);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      };
+    }
   } else if (auto dataView = Handle<JSDataView>::dyn_vmcast(value)) {
     // 14. Otherwise, if value has a [[ViewedArrayBuffer]] internal slot, then:
     //    1-4: Handled in helper below
@@ -1802,8 +1908,11 @@ CallResult<HermesValue> deserializeImpl(
       return ExecutionStatus::EXCEPTION;
     }
     lv.self = res->getHermesValue();
+  } else if (typeTag == SerializedValue::Type::SharedArrayBuffer) {
+    // 12. SharedArrayBuffer case. Handled in helper below.
+    lv.self = deserializeSharedArrayBuffer(runtime, serialized, curr);
   } else if (typeTag == SerializedValue::Type::ArrayBuffer) {
-    // 12-13. SharedArrayBuffer case: Unsupported
+    // 13. Growable SharedArrayBuffer case: Unsupported
     // 14.Otherwise, if serialized.[[Type]] is "ArrayBuffer", then set value to
     // a new ArrayBuffer object in targetRealm whose [[ArrayBufferData]]
     // internal slot value is serialized.[[ArrayBufferData]], and whose
@@ -1976,8 +2085,10 @@ CallResult<PseudoHandle<ArrayStorage>> prepareTransferListForSerialization(
     auto *transferableArrayBuffer = dyn_vmcast<JSArrayBuffer>(transferableHv);
     // 1.If transferable has neither an [[ArrayBufferData]] internal slot nor a
     //   [[Detached]] internal slot, then throw a "DataCloneError" DOMException.
-    // 2. SharedArrayBuffer case: Unsupported
-    if (!transferableArrayBuffer) {
+    // 2. If transferable has an [[ArrayBufferData]] internal slot and
+    //   IsSharedArrayBuffer(transferable) is true, then throw a
+    //   "DataCloneError" DOMException.
+    if (!transferableArrayBuffer || transferableArrayBuffer->shared()) {
       // Release the NoAllocScope to create the exception.
       noAlloc.release();
       return runtime.raiseError(
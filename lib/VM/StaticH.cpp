@@ -785,6 +785,7 @@ static inline void putById_RJS(
     // return the property.
     if (LLVM_LIKELY(cacheEntry && cacheEntry->clazz == clazzPtr)) {
       //++NumPutByIdCacheHits;
+      PROPERTY_CACHE_COUNT_MONO_HIT(runtime, cacheEntry, symID, true);
       JSObject::setNamedSlotValueUnsafe(
           obj, runtime, cacheEntry->getSlot(), shv);
       return;
@@ -809,6 +810,15 @@ static inline void putById_RJS(
       return;
     }
 
+    // Look for the class in the other classes this entry has seen.
+    SlotIndex polySlot;
+    if (LLVM_LIKELY(cacheEntry) &&
+        runtime.getPolyPropCache().tryWrite(
+            runtime, cacheEntry, obj, symID, polySlot)) {
+      JSObject::setNamedSlotValueUnsafe(obj, runtime, polySlot, shv);
+      return;
+    }
+
     NamedPropertyDescriptor desc;
     OptValue<bool> hasOwnProp =
         JSObject::tryGetOwnNamedDescriptorFast(obj, runtime, symID, desc);
@@ -830,8 +840,8 @@ static inline void putById_RJS(
         //(void)NumPutByIdCacheEvicts;
 #endif
         // Cache the class and property slot.
-        cacheEntry->clazz = clazzPtr;
-        cacheEntry->setSlot(desc.slot);
+        runtime.getPolyPropCache().recordWrite(
+            cacheEntry, clazzPtr, desc.slot, symID);
       }
 
       // This must be valid because an own property was already found.
@@ -1149,6 +1159,7 @@ static inline HermesValue getByIdWithReceiver_RJS(
       // return the property.
       if (LLVM_LIKELY(cacheEntry->clazz == clazzPtr)) {
         //++NumGetByIdCacheHits;
+        PROPERTY_CACHE_COUNT_MONO_HIT(runtime, cacheEntry, symID, false);
         return JSObject::getNamedSlotValueUnsafe(
                    obj, runtime, cacheEntry->getSlot())
             .unboxToHV(runtime);
@@ -1165,12 +1176,21 @@ static inline HermesValue getByIdWithReceiver_RJS(
         if (LLVM_LIKELY(parentGCPtr)) {
           JSObject *parent = parentGCPtr.getNonNull(runtime);
           if (LLVM_LIKELY(cacheEntry->clazz == parent->getClassGCPtr())) {
+            PROPERTY_CACHE_COUNT_MONO_HIT(runtime, cacheEntry, symID, false);
             return JSObject::getNamedSlotValueUnsafe(
                        parent, runtime, cacheEntry->getSlot())
                 .unboxToHV(runtime);
           }
         }
       }
+
+      // Look for the class in the other classes this entry has seen.
+      SlotIndex polySlot;
+      if (JSObject *propObj = runtime.getPolyPropCache().tryRead(
+              runtime, cacheEntry, obj, symID, polySlot)) {
+        return JSObject::getNamedSlotValueUnsafe(propObj, runtime, polySlot)
+            .unboxToHV(runtime);
+      }
     }
 
     NamedPropertyDescriptor desc;
@@ -1193,8 +1213,8 @@ static inline HermesValue getByIdWithReceiver_RJS(
         //(void)NumGetByIdCacheEvicts;
 #endif
         // Cache the class, id and property slot.
-        cacheEntry->clazz = clazzPtr;
-        cacheEntry->setSlot(desc.slot);
+        runtime.getPolyPropCache().recordRead(
+            cacheEntry, clazzPtr, CompressedPointer(nullptr), desc.slot, symID);
       }
 
       assert(
@@ -1760,12 +1780,16 @@ extern "C" SHLegacyValue _sh_ljs_create_private_name(
   return *cr;
 }
 
-LLVM_ATTRIBUTE_NOINLINE
-extern "C" SHLegacyValue
-_sh_ljs_create_regexp(SHRuntime *shr, SHSymbolID pattern, SHSymbolID flags) {
+/// Create a RegExp from \p pattern and \p flags, searching with the native
+/// matchers \p native if not null.
+static SHLegacyValue createRegExp(
+    SHRuntime *shr,
+    SHSymbolID pattern,
+    SHSymbolID flags,
+    const SHNativeRegExp *native) {
   Runtime &runtime = getRuntime(shr);
   CallResult<HermesValue> cr =
-      [&runtime, pattern, flags]() -> CallResult<HermesValue> {
+      [&runtime, pattern, flags, native]() -> CallResult<HermesValue> {
     GCScopeMarkerRAII marker{runtime};
     Handle<JSRegExp> re = runtime.makeHandle(JSRegExp::create(runtime));
     auto patternHandle = runtime.makeHandle(
@@ -1776,6 +1800,7 @@ _sh_ljs_create_regexp(SHRuntime *shr, SHSymbolID pattern, SHSymbolID flags) {
             JSRegExp::initialize(re, runtime, patternHandle, flagsHandle) ==
             ExecutionStatus::EXCEPTION))
       return ExecutionStatus::EXCEPTION;
+    JSRegExp::setNativeRegExp(re.get(), native);
     return re.getHermesValue();
   }();
   if (LLVM_UNLIKELY(cr == ExecutionStatus::EXCEPTION))
@@ -1784,6 +1809,21 @@ _sh_ljs_create_regexp(SHRuntime *shr, SHSymbolID pattern, SHSymbolID flags) {
   return *cr;
 }
 
+LLVM_ATTRIBUTE_NOINLINE
+extern "C" SHLegacyValue
+_sh_ljs_create_regexp(SHRuntime *shr, SHSymbolID pattern, SHSymbolID flags) {
+  return createRegExp(shr, pattern, flags, nullptr);
+}
+
+LLVM_ATTRIBUTE_NOINLINE
+extern "C" SHLegacyValue _sh_ljs_create_native_regexp(
+    SHRuntime *shr,
+    SHSymbolID pattern,
+    SHSymbolID flags,
+    const SHNativeRegExp *native) {
+  return createRegExp(shr, pattern, flags, native);
+}
+
 LLVM_ATTRIBUTE_NOINLINE
 extern "C" SHLegacyValue
 _sh_ljs_create_bigint(SHRuntime *shr, const uint8_t *value, uint32_t size) {
@@ -2622,9 +2662,10 @@ _sh_string_concat(SHRuntime *shr, uint32_t argCount, ...) {
 
   // Otherwise, we concatenate all the strings ourselves.
 
-  // Whether the first string is Buffered, and we should use
-  // StringPrimitive::concat instead of StringBuilder.
-  bool firstIsBuffered = false;
+  // Whether we should use StringPrimitive::concat instead of StringBuilder:
+  // the first string is Buffered, so the rest can be appended to its buffer,
+  // or one of the strings is a rope, which StringBuilder would have to copy.
+  bool useConcat = false;
   // Information used for StringBuilder, if it's used instead of
   // StringPrimitive::concat.
   SafeUInt32 resultSize{0};
@@ -2637,8 +2678,9 @@ _sh_string_concat(SHRuntime *shr, uint32_t argCount, ...) {
   for (size_t i = 0; i < argCount; ++i) {
     auto argHandle = Handle<StringPrimitive>::vmcast(
         toPHV(va_arg(args, const SHLegacyValue *)));
-    if (i == 0 && isBufferedStringPrimitive(*argHandle)) {
-      firstIsBuffered = true;
+    if ((i == 0 && isBufferedStringPrimitive(*argHandle)) ||
+        isRopeStringPrimitive(*argHandle)) {
+      useConcat = true;
       // Don't need the other information any more.
       break;
     }
@@ -2653,9 +2695,10 @@ _sh_string_concat(SHRuntime *shr, uint32_t argCount, ...) {
   va_start(args, argCount);
   CallResult<HermesValue> result = [&]() -> CallResult<HermesValue> {
     GCScopeMarkerRAII marker{runtime};
-    if (firstIsBuffered) {
-      // The first argument is a BufferedStringPrimitive, so we can use it and
-      // concatenate the rest using StringPrimitive::concat.
+    if (useConcat) {
+      // Concatenate the arguments one by one using StringPrimitive::concat,
+      // which appends to the buffer of a BufferedStringPrimitive or creates
+      // ropes as needed.
       // Begin with the first argument in a MutableHandle.
       MutableHandle<StringPrimitive> outputStrHandle{
           runtime,
@@ -2664,8 +2707,8 @@ _sh_string_concat(SHRuntime *shr, uint32_t argCount, ...) {
       for (size_t i = 1; i < argCount; ++i) {
         auto argHandle = Handle<StringPrimitive>::vmcast(
             toPHV(va_arg(args, const SHLegacyValue *)));
-        // Use concat repeatedly to use a BufferedStringPrimitive for faster
-        // concatenation.
+        // Use concat repeatedly to use a BufferedStringPrimitive or a rope for
+        // faster concatenation.
         auto res = StringPrimitive::concat(runtime, outputStrHandle, argHandle);
         if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
           return ExecutionStatus::EXCEPTION;
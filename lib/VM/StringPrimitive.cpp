@@ -321,6 +321,7 @@ CallResult<HermesValue> StringPrimitive::slice(
       start + length <= str->getStringLength() && "Invalid length for slice");
 
   SafeUInt32 safeLen(length);
+  ensureFlat(runtime, str);
 
   // Special case for 1-character strings, some of which are cached in the
   // runtime.
@@ -383,6 +384,13 @@ StringView StringPrimitive::createStringViewMustBeFlat(
   return StringView(self);
 }
 
+void StringPrimitive::flattenRope(Runtime &runtime, StringPrimitive *str) {
+  if (auto *rope = dyn_vmcast<RopeASCIIStringPrimitive>(str))
+    rope->flattenAndReleaseChildren(runtime);
+  else
+    vmcast<RopeUTF16StringPrimitive>(str)->flattenAndReleaseChildren(runtime);
+}
+
 #ifdef HERMES_MEMORY_INSTRUMENTATION
 std::string StringPrimitive::_snapshotNameImpl(GCCell *cell, GC &gc) {
   auto *const self = vmcast<StringPrimitive>(cell);
@@ -492,6 +500,61 @@ CallResult<HermesValue> ExternalStringPrimitive<T>::create(
   return res;
 }
 
+template <typename T>
+ExternalStringPrimitive<T>::ExternalStringPrimitive(SharedStdString &&shared)
+    : SymbolStringPrimitive(shared->size()),
+      shared_(std::move(shared)),
+      isShared_(true) {
+  assert(
+      getStringLength() >= EXTERNAL_STRING_MIN_SIZE &&
+      "ExternalStringPrimitive length must be at least EXTERNAL_STRING_MIN_SIZE");
+}
+
+template <typename T>
+ExternalStringPrimitive<T>::~ExternalStringPrimitive() {
+  if (isShared_)
+    shared_.~SharedStdString();
+  else
+    contents_.~CopyableStdString();
+}
+
+template <typename T>
+CallResult<HermesValue> ExternalStringPrimitive<T>::createShared(
+    Runtime &runtime,
+    SharedStdString shared) {
+  if (LLVM_UNLIKELY(shared->size() > MAX_STRING_LENGTH))
+    return runtime.raiseRangeError("String length exceeds limit");
+  if (LLVM_UNLIKELY(!runtime.getHeap().canAllocExternalMemory(
+          shared->capacity() * sizeof(T)))) {
+    return runtime.raiseRangeError(
+        "Cannot allocate an external string primitive.");
+  }
+  auto *extStr =
+      runtime.makeAVariable<ExternalStringPrimitive<T>, HasFinalizer::Yes>(
+          sizeof(ExternalStringPrimitive<T>), std::move(shared));
+  // Every runtime referring to the buffer is charged for all of it, since any
+  // of them may end up keeping it alive.
+  runtime.getHeap().creditExternalMemory(
+      extStr, extStr->calcExternalMemorySize());
+  return HermesValue::encodeStringValue(extStr);
+}
+
+template <typename T>
+typename ExternalStringPrimitive<T>::SharedStdString
+ExternalStringPrimitive<T>::share() {
+  if (!isShared_) {
+    // Moving the string keeps its heap buffer, so the characters are not
+    // copied and existing pointers to them remain valid. The external memory
+    // size doesn't change either.
+    auto shared =
+        std::make_shared<const CopyableStdString>(std::move(contents_));
+    contents_.~CopyableStdString();
+    new (&shared_) SharedStdString(std::move(shared));
+    isShared_ = true;
+  }
+  return shared_;
+}
+
 template <typename T>
 CallResult<HermesValue> ExternalStringPrimitive<T>::createLongLived(
     Runtime &runtime,
@@ -534,7 +597,7 @@ void ExternalStringPrimitive<T>::_finalizeImpl(GCCell *cell, GC &gc) {
   ExternalStringPrimitive<T> *self = vmcast<ExternalStringPrimitive<T>>(cell);
   // Remove the external string from the snapshot tracking system if it's being
   // tracked.
-  gc.getIDTracker().untrackNative(self->contents_.data());
+  gc.getIDTracker().untrackNative(self->getRawPointer());
   gc.debitExternalMemory(self, self->calcExternalMemorySize());
   self->~ExternalStringPrimitive<T>();
 }
@@ -555,7 +618,7 @@ void ExternalStringPrimitive<T>::_snapshotAddEdgesImpl(
   snap.addNamedEdge(
       HeapSnapshot::EdgeType::Internal,
       "externalString",
-      gc.getNativeID(self->contents_.data()));
+      gc.getNativeID(self->getRawPointer()));
 }
 
 template <typename T>
@@ -568,8 +631,8 @@ void ExternalStringPrimitive<T>::_snapshotAddNodesImpl(
   snap.endNode(
       HeapSnapshot::NodeType::Native,
       "ExternalStringPrimitive",
-      gc.getNativeID(self->contents_.data()),
-      self->contents_.size(),
+      gc.getNativeID(self->getRawPointer()),
+      self->getStringLength(),
       0);
 }
 #endif
@@ -629,24 +692,71 @@ static void assertValidLength(StringPrimitive *a, StringPrimitive *b) {
 static inline void assertValidLength(StringPrimitive *a, StringPrimitive *b) {}
 #endif
 
+/// If \p str is a rope that has not been flattened, store its children in
+/// \p left and \p right.
+/// \return whether \p str is a rope that has not been flattened.
+static bool getRopeChildren(
+    const StringPrimitive *str,
+    const StringPrimitive *&left,
+    const StringPrimitive *&right) {
+  if (auto *rope = dyn_vmcast<RopeASCIIStringPrimitive>(str))
+    return rope->getChildren(left, right);
+  if (auto *rope = dyn_vmcast<RopeUTF16StringPrimitive>(str))
+    return rope->getChildren(left, right);
+  return false;
+}
+
+/// \return the depth of \p str as a rope, which is 0 unless it is a rope that
+/// has not been flattened.
+static uint32_t getRopeDepth(const StringPrimitive *str) {
+  if (auto *rope = dyn_vmcast<RopeASCIIStringPrimitive>(str))
+    return rope->getDepth();
+  if (auto *rope = dyn_vmcast<RopeUTF16StringPrimitive>(str))
+    return rope->getDepth();
+  return 0;
+}
+
+/// Call \p visit on each of the strings making up \p str, in order. That is
+/// \p str itself, unless it is a rope that has not been flattened, in which
+/// case its leaves are visited instead of flattening it. Ropes are traversed
+/// with an explicit stack, since they may be deep.
+template <typename F>
+static void forEachStringPiece(const StringPrimitive *str, F visit) {
+  llvh::SmallVector<const StringPrimitive *, 16> stack{str};
+  do {
+    const StringPrimitive *cur = stack.pop_back_val();
+    const StringPrimitive *left, *right;
+    if (getRopeChildren(cur, left, right)) {
+      stack.push_back(right);
+      stack.push_back(left);
+    } else {
+      visit(cur);
+    }
+  } while (!stack.empty());
+}
+
 template <>
 void BufferedStringPrimitive<char>::appendToCopyableString(
     CopyableBasicString<char> &res,
     const StringPrimitive *str) {
-  auto it = str->castToASCIIPointer();
-  res.append(it, it + str->getStringLength());
+  forEachStringPiece(str, [&res](const StringPrimitive *piece) {
+    auto it = piece->castToASCIIPointer();
+    res.append(it, it + piece->getStringLength());
+  });
 }
 template <>
 void BufferedStringPrimitive<char16_t>::appendToCopyableString(
     CopyableBasicString<char16_t> &res,
     const StringPrimitive *str) {
-  if (str->isASCII()) {
-    auto it = (const uint8_t *)str->castToASCIIPointer();
-    res.append(it, it + str->getStringLength());
-  } else {
-    auto it = str->castToUTF16Pointer();
-    res.append(it, it + str->getStringLength());
-  }
+  forEachStringPiece(str, [&res](const StringPrimitive *piece) {
+    if (piece->isASCII()) {
+      auto it = (const uint8_t *)piece->castToASCIIPointer();
+      res.append(it, it + piece->getStringLength());
+    } else {
+      auto it = piece->castToUTF16Pointer();
+      res.append(it, it + piece->getStringLength());
+    }
+  });
 }
 
 template <typename T>
@@ -687,6 +797,7 @@ PseudoHandle<StringPrimitive> BufferedStringPrimitive<T>::append(
   auto *self = selfHnd.get();
   auto *right = rightHnd.get();
   ExternalStringPrimitive<T> *storage = self->getConcatBuffer();
+  assert(!storage->isShared_ && "concatenation buffers are never shared");
 
   assertValidLength(self, right);
   assert(
@@ -712,6 +823,32 @@ PseudoHandle<StringPrimitive> BufferedStringPrimitive<T>::append(
       runtime, storage->contents_.size(), storageHandle);
 }
 
+/// Decide whether concatenating \p left and \p right, when it can't be done
+/// by appending to the concatenation buffer of \p left, should create a rope
+/// of depth \p depth instead of copying both strings into a new buffer.
+/// Copying is preferable when the new buffer is likely to be appended to next,
+/// as in a loop that appends to a string. The remaining cases are better
+/// served by a rope, which doesn't copy either string:
+/// - one of the strings is already a rope;
+/// - \p left is in the middle of a concatenation chain, so its buffer is
+///   already being appended to by another chain;
+/// - \p right is longer than \p left, e.g. when prepending.
+/// \param leftIsBufferTail whether \p left is a BufferedStringPrimitive at the
+///   end of its concatenation buffer.
+static bool shouldCreateRope(
+    const StringPrimitive *left,
+    const StringPrimitive *right,
+    bool leftIsBufferTail,
+    uint32_t depth) {
+  if (depth > StringPrimitive::MAX_ROPE_DEPTH)
+    return false;
+  if (depth > 1)
+    return true;
+  if (isBufferedStringPrimitive(left))
+    return !leftIsBufferTail;
+  return right->getStringLength() > left->getStringLength();
+}
+
 PseudoHandle<StringPrimitive> internalConcatStringPrimitives(
     Runtime &runtime,
     Handle<StringPrimitive> leftHnd,
@@ -721,28 +858,37 @@ PseudoHandle<StringPrimitive> internalConcatStringPrimitives(
 
   assertValidLength(left, right);
 
-  if (left->isASCII() && right->isASCII()) {
-    if (auto *bufLeft = dyn_vmcast<BufferedASCIIStringPrimitive>(left)) {
-      if (bufLeft->getStringLength() ==
-          bufLeft->getConcatBuffer()->contents_.size())
-        return BufferedASCIIStringPrimitive::append(
-            Handle<BufferedASCIIStringPrimitive>::vmcast(leftHnd),
-            runtime,
-            rightHnd);
-    }
-    return BufferedASCIIStringPrimitive::create(runtime, leftHnd, rightHnd);
-  } else {
-    if (auto *bufLeft = dyn_vmcast<BufferedUTF16StringPrimitive>(left)) {
-      if (bufLeft->getStringLength() ==
-          bufLeft->getConcatBuffer()->contents_.size()) {
-        return BufferedUTF16StringPrimitive::append(
-            Handle<BufferedUTF16StringPrimitive>::vmcast(leftHnd),
-            runtime,
-            rightHnd);
-      }
-    }
-    return BufferedUTF16StringPrimitive::create(runtime, leftHnd, rightHnd);
+  bool isASCII = left->isASCII() && right->isASCII();
+  bool leftIsBufferTail = false;
+  if (auto *bufLeft = dyn_vmcast<BufferedASCIIStringPrimitive>(left)) {
+    leftIsBufferTail = bufLeft->getStringLength() ==
+        bufLeft->getConcatBuffer()->contents_.size();
+    if (leftIsBufferTail && isASCII)
+      return BufferedASCIIStringPrimitive::append(
+          Handle<BufferedASCIIStringPrimitive>::vmcast(leftHnd),
+          runtime,
+          rightHnd);
+  } else if (auto *bufLeft = dyn_vmcast<BufferedUTF16StringPrimitive>(left)) {
+    leftIsBufferTail = bufLeft->getStringLength() ==
+        bufLeft->getConcatBuffer()->contents_.size();
+    if (leftIsBufferTail)
+      return BufferedUTF16StringPrimitive::append(
+          Handle<BufferedUTF16StringPrimitive>::vmcast(leftHnd),
+          runtime,
+          rightHnd);
   }
+
+  uint32_t depth = std::max(getRopeDepth(left), getRopeDepth(right)) + 1;
+  if (shouldCreateRope(left, right, leftIsBufferTail, depth)) {
+    if (isASCII)
+      return RopeASCIIStringPrimitive::create(
+          runtime, leftHnd, rightHnd, depth);
+    return RopeUTF16StringPrimitive::create(runtime, leftHnd, rightHnd, depth);
+  }
+
+  if (isASCII)
+    return BufferedASCIIStringPrimitive::create(runtime, leftHnd, rightHnd);
+  return BufferedUTF16StringPrimitive::create(runtime, leftHnd, rightHnd);
 }
 
 #ifdef HERMES_MEMORY_INSTRUMENTATION
@@ -761,5 +907,168 @@ void BufferedStringPrimitive<T>::_snapshotAddNodesImpl(
 
 template class BufferedStringPrimitive<char16_t>;
 template class BufferedStringPrimitive<char>;
+
+//===----------------------------------------------------------------------===//
+// RopeStringPrimitive<T>
+
+void RopeASCIIStringPrimitiveBuildMeta(
+    const GCCell *cell,
+    Metadata::Builder &mb) {
+  const auto *self = static_cast<const RopeASCIIStringPrimitive *>(cell);
+  mb.setVTable(&RopeASCIIStringPrimitive::vt);
+  mb.addField("left", &self->leftHV_);
+  mb.addField("right", &self->rightHV_);
+}
+void RopeUTF16StringPrimitiveBuildMeta(
+    const GCCell *cell,
+    Metadata::Builder &mb) {
+  const auto *self = static_cast<const RopeUTF16StringPrimitive *>(cell);
+  mb.setVTable(&RopeUTF16StringPrimitive::vt);
+  mb.addField("left", &self->leftHV_);
+  mb.addField("right", &self->rightHV_);
+}
+
+template <typename T>
+PseudoHandle<StringPrimitive> RopeStringPrimitive<T>::create(
+    Runtime &runtime,
+    Handle<StringPrimitive> leftHnd,
+    Handle<StringPrimitive> rightHnd,
+    uint32_t depth) {
+  assertValidLength(leftHnd.get(), rightHnd.get());
+  assert(
+      (std::is_same<T, char16_t>::value ||
+       (leftHnd->isASCII() && rightHnd->isASCII())) &&
+      "ASCII rope cannot contain UTF16");
+  // We have to use a variable sized alloc here even though the size is already
+  // known, because RopeStringPrimitive is derived from VariableSizeRuntimeCell.
+  auto *cell =
+      runtime.makeAVariable<RopeStringPrimitive<T>, HasFinalizer::Yes>(
+          sizeof(RopeStringPrimitive<T>), runtime, leftHnd, rightHnd, depth);
+  return createPseudoHandle<StringPrimitive>(cell);
+}
+
+template <typename T>
+void RopeStringPrimitive<T>::flatten() const {
+  assert(!flat_ && "rope is already flat");
+  T *buf = static_cast<T *>(checkedMalloc2(getStringLength(), sizeof(T)));
+  T *dst = buf;
+  forEachStringPiece(this, [&dst](const StringPrimitive *piece) {
+    uint32_t len = piece->getStringLength();
+    if (piece->isASCII()) {
+      const char *src = piece->castToASCIIPointer();
+      dst = std::copy(src, src + len, dst);
+    } else {
+      assert(
+          (std::is_same<T, char16_t>::value) &&
+          "ASCII rope cannot contain UTF16");
+      const char16_t *src = piece->castToUTF16Pointer();
+      dst = std::copy(src, src + len, dst);
+    }
+  });
+  assert(dst == buf + getStringLength() && "rope length mismatch");
+  flat_ = buf;
+}
+
+template <typename T>
+void RopeStringPrimitive<T>::flattenAndReleaseChildren(Runtime &runtime) {
+  if (!flat_)
+    flatten();
+  GC &gc = runtime.getHeap();
+  // If the external memory isn't available, the buffer is used anyway, since
+  // it already exists. It will still be reported by _mallocSizeImpl.
+  if (!externalMemoryCredited_ &&
+      gc.canAllocExternalMemory(calcExternalMemorySize())) {
+    gc.creditExternalMemory(this, calcExternalMemorySize());
+    externalMemoryCredited_ = true;
+  }
+  if (!leftHV_.isEmpty()) {
+    leftHV_.setNonPtr(HermesValue::encodeEmptyValue(), gc);
+    rightHV_.setNonPtr(HermesValue::encodeEmptyValue(), gc);
+  }
+}
+
+template <typename T>
+void RopeStringPrimitive<T>::_finalizeImpl(GCCell *cell, GC &gc) {
+  auto *self = vmcast<RopeStringPrimitive<T>>(cell);
+  if (self->flat_) {
+    gc.getIDTracker().untrackNative(self->flat_);
+    if (self->externalMemoryCredited_)
+      gc.debitExternalMemory(self, self->calcExternalMemorySize());
+    free(self->flat_);
+  }
+  self->~RopeStringPrimitive<T>();
+}
+
+template <typename T>
+size_t RopeStringPrimitive<T>::_mallocSizeImpl(GCCell *cell) {
+  return vmcast<RopeStringPrimitive<T>>(cell)->calcExternalMemorySize();
+}
+
+#ifdef HERMES_MEMORY_INSTRUMENTATION
+template <typename T>
+std::string RopeStringPrimitive<T>::_snapshotNameImpl(GCCell *cell, GC &gc) {
+  auto *const self = vmcast<RopeStringPrimitive<T>>(cell);
+  if (self->flat_)
+    return StringPrimitive::_snapshotNameImpl(cell, gc);
+  // Don't flatten the rope just to name it. Collect a prefix of the pieces up
+  // to the same limit as StringPrimitive::_snapshotNameImpl.
+  llvh::SmallVector<char16_t, 64> prefix;
+  forEachStringPiece(self, [&prefix](const StringPrimitive *piece) {
+    if (prefix.size() > EXTERNAL_STRING_THRESHOLD)
+      return;
+    uint32_t len = std::min<uint32_t>(
+        piece->getStringLength(),
+        EXTERNAL_STRING_THRESHOLD + 1 - prefix.size());
+    if (piece->isASCII()) {
+      const char *src = piece->castToASCIIPointer();
+      prefix.append(src, src + len);
+    } else {
+      const char16_t *src = piece->castToUTF16Pointer();
+      prefix.append(src, src + len);
+    }
+  });
+  std::string out;
+  if (!convertUTF16ToUTF8WithReplacements(
+          out, prefix, EXTERNAL_STRING_THRESHOLD) ||
+      prefix.size() > EXTERNAL_STRING_THRESHOLD) {
+    out += "...(truncated by snapshot)...";
+  }
+  return out;
+}
+
+template <typename T>
+void RopeStringPrimitive<T>::_snapshotAddEdgesImpl(
+    GCCell *cell,
+    GC &gc,
+    HeapSnapshot &snap) {
+  auto *const self = vmcast<RopeStringPrimitive<T>>(cell);
+  if (!self->flat_)
+    return;
+  snap.addNamedEdge(
+      HeapSnapshot::EdgeType::Internal,
+      "flatString",
+      gc.getNativeID(self->flat_));
+}
+
+template <typename T>
+void RopeStringPrimitive<T>::_snapshotAddNodesImpl(
+    GCCell *cell,
+    GC &gc,
+    HeapSnapshot &snap) {
+  auto *const self = vmcast<RopeStringPrimitive<T>>(cell);
+  if (!self->flat_)
+    return;
+  snap.beginNode();
+  snap.endNode(
+      HeapSnapshot::NodeType::Native,
+      "RopeStringPrimitive",
+      gc.getNativeID(self->flat_),
+      self->calcExternalMemorySize(),
+      0);
+}
+#endif
+
+template class RopeStringPrimitive<char16_t>;
+template class RopeStringPrimitive<char>;
 } // namespace vm
 } // namespace hermes
@@ -32,6 +32,9 @@ HERMES_SLOW_STATISTIC(
 HERMES_SLOW_STATISTIC(
     NumOldGenAllocSlow,
     "NumOldGenAllocSlow: Number of old gen allocation slow paths");
+HERMES_SLOW_STATISTIC(
+    NumOldGenAllocChunkRefill,
+    "NumOldGenAllocChunkRefill: Number of old gen allocation chunk refills");
 
 // In ASAN builds, poison the memory outside of the FreelistCell so that
 // accesses are flagged as illegal while it is in the freelist.
@@ -653,6 +656,448 @@ class HadesGC::EvacAcceptor final : public RootAcceptor,
   }
 };
 
+/// A set of threads that run a single task in parallel, used for the parts of
+/// a collection that the mutator waits on. The thread calling run() always
+/// participates as worker 0, so a pool of N workers owns N - 1 threads.
+class HadesGC::WorkerPool {
+ public:
+  explicit WorkerPool(unsigned numWorkers) {
+    assert(numWorkers > 1 && "A pool needs at least one helper thread");
+    for (unsigned i = 1; i < numWorkers; ++i)
+      threads_.emplace_back([this, i] { worker(i); });
+  }
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      shutdown_ = true;
+      cv_.notify_all();
+    }
+    for (std::thread &t : threads_)
+      t.join();
+  }
+
+  /// \return the number of workers, including the calling thread.
+  unsigned numWorkers() const {
+    return threads_.size() + 1;
+  }
+
+  /// Call \p fn(i) on each worker i, and return once all calls have returned.
+  void run(const std::function<void(unsigned)> &fn) {
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      assert(!task_ && "Cannot run tasks concurrently");
+      task_ = &fn;
+      pending_ = threads_.size();
+      ++generation_;
+      cv_.notify_all();
+    }
+    fn(0);
+    std::unique_lock<std::mutex> lk(mtx_);
+    doneCV_.wait(lk, [this]() { return pending_ == 0; });
+    task_ = nullptr;
+  }
+
+ private:
+  /// Wait for tasks and run them as worker \p idx.
+  void worker(unsigned idx) {
+    oscompat::set_thread_name("hades-worker");
+    uint64_t lastGeneration = 0;
+    std::unique_lock<std::mutex> lk(mtx_);
+    while (true) {
+      cv_.wait(lk, [this, lastGeneration]() {
+        return generation_ != lastGeneration || shutdown_;
+      });
+      if (shutdown_)
+        return;
+      lastGeneration = generation_;
+      const auto *fn = task_;
+      lk.unlock();
+      (*fn)(idx);
+      lk.lock();
+      if (--pending_ == 0)
+        doneCV_.notify_one();
+    }
+  }
+
+  std::mutex mtx_;
+  /// Signalled when a task is submitted, or the pool is shutting down.
+  std::condition_variable cv_;
+  /// Signalled when the last helper thread finishes the current task.
+  std::condition_variable doneCV_;
+  const std::function<void(unsigned)> *task_{nullptr};
+  /// Incremented for each task, so that helpers run each task exactly once.
+  uint64_t generation_{0};
+  /// The number of helper threads still running the current task.
+  size_t pending_{0};
+  bool shutdown_{false};
+  std::vector<std::thread> threads_;
+};
+
+namespace {
+
+/// Work shared between the workers of a parallel phase of a collection. Each
+/// worker keeps a private stack of \p T, and moves batches of surplus items
+/// here for idle workers to take.
+template <typename T>
+class WorkStealingQueue {
+ public:
+  using Item = T;
+  using Batch = std::vector<T>;
+
+  /// The number of items moved between workers at a time.
+  static constexpr size_t kBatchSize = 64;
+
+  explicit WorkStealingQueue(unsigned numWorkers) : numWorkers_{numWorkers} {}
+
+  /// Make \p batch available to other workers.
+  void publish(Batch &&batch) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    batches_.push_back(std::move(batch));
+    cv_.notify_one();
+  }
+
+  /// Wait until a batch is available and move it into \p batch.
+  /// \return false once all workers are waiting and there is no work left, or
+  ///   the queue was aborted.
+  bool steal(Batch &batch) {
+    std::unique_lock<std::mutex> lk(mtx_);
+    ++numIdle_;
+    while (!aborted_.load(std::memory_order_relaxed)) {
+      if (!batches_.empty()) {
+        batch = std::move(batches_.back());
+        batches_.pop_back();
+        --numIdle_;
+        return true;
+      }
+      if (numIdle_ == numWorkers_) {
+        cv_.notify_all();
+        return false;
+      }
+      cv_.wait(lk);
+    }
+    return false;
+  }
+
+  /// Move a batch into \p batch without waiting. Only for use once all
+  /// workers have stopped.
+  bool take(Batch &batch) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (batches_.empty())
+      return false;
+    batch = std::move(batches_.back());
+    batches_.pop_back();
+    return true;
+  }
+
+  /// Tell all workers to stop as soon as possible, leaving their remaining
+  /// work in their stacks.
+  void abort() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    aborted_.store(true, std::memory_order_relaxed);
+    cv_.notify_all();
+  }
+  bool aborted() const {
+    return aborted_.load(std::memory_order_relaxed);
+  }
+
+  /// Prepare for another round of work after the workers have stopped.
+  void reset() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    numIdle_ = 0;
+    aborted_.store(false, std::memory_order_relaxed);
+  }
+
+ private:
+  const unsigned numWorkers_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::vector<Batch> batches_;
+  unsigned numIdle_{0};
+  std::atomic<bool> aborted_{false};
+};
+
+/// Either a cell that was copied out of the YG and whose pointers still need
+/// updating (begin and end are null), or an OG cell whose pointers in the
+/// dirty range [begin, end) need updating.
+struct EvacWorkItem {
+  GCCell *cell;
+  const char *begin;
+  const char *end;
+};
+
+/// Cells that have been marked, but whose pointers have not been visited yet.
+using MarkWorkQueue = WorkStealingQueue<GCCell *>;
+
+} // namespace
+
+/// The work shared between the workers of a parallel YG evacuation.
+class HadesGC::EvacWorkQueue final : public WorkStealingQueue<EvacWorkItem> {
+ public:
+  using WorkStealingQueue::WorkStealingQueue;
+
+  /// Protects the OG freelist while buffers are refilled.
+  std::mutex oldGenMutex;
+};
+
+/// Evacuates YG cells into the OG alongside other instances of itself on other
+/// threads. Cells are copied into a private EvacBuffer and forwarded with a
+/// compare-and-swap on their header, so that a cell reachable from several
+/// workers is copied exactly once. Unlike EvacAcceptor, this never evacuates a
+/// compactee, and does not track object IDs.
+class HadesGC::ParallelEvacAcceptor final : public RootAcceptor {
+ public:
+  ParallelEvacAcceptor(HadesGC &gc, EvacWorkQueue &queue)
+      : gc{gc}, pointerBase_{gc.getPointerBase()}, queue_{queue} {}
+
+  ~ParallelEvacAcceptor() override {
+    assert(buf_.empty() && "The buffer must have been retired");
+  }
+
+  /// Allow this worker to grow the OG, and to wait for an OG collection if
+  /// that fails. Only valid while no other worker is running.
+  void setRunningAlone(bool runningAlone) {
+    runningAlone_ = runningAlone;
+  }
+
+  OldGen::EvacBuffer &buffer() {
+    return buf_;
+  }
+
+  /// \return true if the OG could not grow while running alone, so that this
+  ///   worker now allocates with OldGen::alloc.
+  bool isBlocking() const {
+    return blocking_;
+  }
+
+  uint64_t evacuatedBytes() const {
+    return evacuatedBytes_;
+  }
+
+  /// Add the part of \p cell within [begin, end) to this worker's stack.
+  void pushDirtyRange(GCCell *cell, const char *begin, const char *end) {
+    stack_.push_back({cell, begin, end});
+  }
+
+  /// Process the work on this worker's stack, stealing more once it is empty,
+  /// until no work is left anywhere or the queue is aborted.
+  void drain() {
+    EvacWorkQueue::Batch batch;
+    do {
+      stack_.insert(stack_.end(), batch.begin(), batch.end());
+      while (!stack_.empty()) {
+        if (queue_.aborted())
+          return;
+        if (stack_.size() >= 2 * EvacWorkQueue::kBatchSize)
+          shareWork();
+        const EvacWorkQueue::Item item = stack_.back();
+        stack_.pop_back();
+        outOfMemory_ = false;
+        process(item);
+        if (LLVM_UNLIKELY(outOfMemory_)) {
+          // Some pointers in this item could not be forwarded. Processing an
+          // item is idempotent, so put it back to be redone once there is
+          // room in the OG.
+          stack_.push_back(item);
+          queue_.abort();
+          return;
+        }
+      }
+    } while (queue_.steal(batch));
+  }
+
+  /// Process all the work left on the stacks of \p others and in the queue.
+  /// \pre No other worker is running, and setRunningAlone(true) was called.
+  void drainAlone(
+      llvh::ArrayRef<std::unique_ptr<ParallelEvacAcceptor>> others) {
+    assert(runningAlone_ && "Other workers may still be running");
+    for (const auto &other : others) {
+      if (other.get() == this)
+        continue;
+      stack_.insert(stack_.end(), other->stack_.begin(), other->stack_.end());
+      other->stack_.clear();
+    }
+    EvacWorkQueue::Batch batch;
+    do {
+      stack_.insert(stack_.end(), batch.begin(), batch.end());
+      while (!stack_.empty()) {
+        const EvacWorkQueue::Item item = stack_.back();
+        stack_.pop_back();
+        process(item);
+        assert(!outOfMemory_ && "Cannot run out of memory when running alone");
+      }
+    } while (queue_.take(batch));
+  }
+
+  void accept(GCCell *&ptr) override {
+    if (gc.inYoungGen(ptr))
+      ptr = forwardCell(ptr);
+  }
+
+  void accept(GCPointerBase &ptr) {
+    CompressedPointer cptr = ptr;
+    if (gc.inYoungGen(cptr))
+      ptr.setInGC(CompressedPointer::encodeNonNull(
+          forwardCell(cptr.getNonNull(pointerBase_)), pointerBase_));
+  }
+
+  void accept(PinnedHermesValue &hv) override {
+    assert((!hv.isPointer() || hv.getPointer()) && "Value is not nullable.");
+    acceptNullable(hv);
+  }
+
+  void acceptNullable(PinnedHermesValue &hv) override {
+    if (hv.isPointer()) {
+      auto *ptr = static_cast<GCCell *>(hv.getPointer());
+      if (gc.inYoungGen(ptr))
+        hv.setInGC(hv.updatePointer(forwardCell(ptr)), gc);
+    }
+  }
+
+  void accept(PinnedSmallHermesValue &shv) override {
+    if (shv.isPointer()) {
+      GCCell *ptr = shv.getPointer(pointerBase_);
+      if (gc.inYoungGen(ptr))
+        shv.setInGC(shv.updatePointer(forwardCell(ptr), pointerBase_), gc);
+    }
+  }
+
+  void accept(GCHermesValueBase &hv) {
+    if (hv.isPointer()) {
+      auto *ptr = static_cast<GCCell *>(hv.getPointer());
+      if (gc.inYoungGen(ptr))
+        hv.setInGC(hv.updatePointer(forwardCell(ptr)), gc);
+    }
+  }
+
+  void accept(GCSmallHermesValueBase &hv) {
+    if (hv.isPointer()) {
+      CompressedPointer cptr = hv.getPointer();
+      if (gc.inYoungGen(cptr)) {
+        GCCell *forwarded = forwardCell(cptr.getNonNull(pointerBase_));
+        hv.setInGC(hv.updatePointer(forwarded, pointerBase_), gc);
+      }
+    }
+  }
+
+  // Nothing to do for symbols, since they are not collected during a YG
+  // collection.
+  void accept(const RootSymbolID &sym) override {}
+  void accept(const GCSymbolID &sym) {}
+
+ private:
+  HadesGC &gc;
+  PointerBase &pointerBase_;
+  EvacWorkQueue &queue_;
+
+  /// The space this worker copies cells into.
+  OldGen::EvacBuffer buf_;
+
+  /// Work that only this worker can see.
+  EvacWorkQueue::Batch stack_;
+
+  uint64_t evacuatedBytes_{0};
+
+  /// See setRunningAlone().
+  bool runningAlone_{false};
+
+  /// Set once running alone and the OG could not grow. All further cells are
+  /// allocated with OldGen::alloc, which marks them and accounts for them.
+  bool blocking_{false};
+
+  /// Set when a cell could not be copied because the OG is out of space.
+  bool outOfMemory_{false};
+
+  /// Update the pointers in \p item.
+  void process(const EvacWorkQueue::Item &item) {
+    if (item.begin)
+      gc.markCellWithinRange(*this, item.cell, item.begin, item.end);
+    else
+      gc.markCell(*this, item.cell);
+  }
+
+  /// Move the oldest items on the stack to the shared queue.
+  void shareWork() {
+    auto mid = stack_.begin() + EvacWorkQueue::kBatchSize;
+    queue_.publish(EvacWorkQueue::Batch(stack_.begin(), mid));
+    stack_.erase(stack_.begin(), mid);
+  }
+
+  /// \return memory for a cell of size \p sz in the OG, or null if the OG is
+  ///   out of space and this worker is not running alone.
+  GCCell *allocate(uint32_t sz) {
+    if (LLVM_LIKELY(!blocking_)) {
+      if (GCCell *cell = buf_.alloc(sz))
+        return cell;
+      if (refill(sz)) {
+        GCCell *cell = buf_.alloc(sz);
+        assert(cell && "A refilled buffer must fit the cell");
+        return cell;
+      }
+      if (!runningAlone_)
+        return nullptr;
+      // The OG cannot grow, so fall back to the regular allocation path, which
+      // can wait for the OG collection to free up memory.
+      gc.oldGen_.retireEvacBuffer(buf_);
+      blocking_ = true;
+    }
+    return gc.oldGen_.alloc(sz);
+  }
+
+  /// Get a new buffer that can fit \p sz bytes. \return false on failure.
+  bool refill(uint32_t sz) {
+    if (!runningAlone_) {
+      std::lock_guard<std::mutex> lk(queue_.oldGenMutex);
+      return gc.oldGen_.refillEvacBuffer(buf_, sz);
+    }
+    if (gc.oldGen_.refillEvacBuffer(buf_, sz))
+      return true;
+    llvh::ErrorOr<FixedSizeHeapSegment> seg = gc.createSegment();
+    if (!seg)
+      return false;
+    gc.oldGen_.addSegment(std::move(seg.get()));
+    return gc.oldGen_.refillEvacBuffer(buf_, sz);
+  }
+
+  /// \return the new location of \p cell, copying it out of the YG first if
+  ///   no other worker has done so. If the OG is out of space, set
+  ///   outOfMemory_ and return \p cell.
+  GCCell *forwardCell(GCCell *const cell) {
+    KindAndSize kindAndSize;
+    AssignableCompressedPointer forwardedCell;
+    if (cell->loadHeaderAtomic(kindAndSize, forwardedCell))
+      return forwardedCell.getNonNull(pointerBase_);
+    const uint32_t cellSize = kindAndSize.getSize();
+    GCCell *const newCell = allocate(cellSize);
+    if (LLVM_UNLIKELY(!newCell)) {
+      outOfMemory_ = true;
+      return cell;
+    }
+    // Copy everything but the header, which other workers may be trying to
+    // replace with their own forwarding pointer.
+    std::memcpy(
+        reinterpret_cast<char *>(newCell) + sizeof(KindAndSize),
+        reinterpret_cast<const char *>(cell) + sizeof(KindAndSize),
+        cellSize - sizeof(KindAndSize));
+    newCell->setKindAndSize(kindAndSize);
+    assert(newCell->isValid() && "Cell was copied incorrectly");
+    if (!cell->trySetMarkedForwardingPointer(
+            kindAndSize,
+            CompressedPointer::encodeNonNull(newCell, pointerBase_),
+            forwardedCell)) {
+      // Another worker copied the cell first, so discard this copy.
+      assert(!blocking_ && "Lost a race while running alone");
+      buf_.undoAlloc(newCell, cellSize);
+      return forwardedCell.getNonNull(pointerBase_);
+    }
+    // Cells allocated with OldGen::alloc are already marked.
+    if (LLVM_LIKELY(!blocking_))
+      AlignedHeapSegment::setCellMarkBitAtomic(newCell);
+    evacuatedBytes_ += cellSize;
+    stack_.push_back({newCell, nullptr, nullptr});
+    return newCell;
+  }
+};
+
 void HadesGC::barrierEnqueue(GCCell *cell) {
   if (LLVM_UNLIKELY(
           markState_->barrierChunkIndex_ ==
@@ -736,12 +1181,38 @@ class HERMES_ATTRIBUTE_INTERNAL_LINKAGE HadesGC::MarkAcceptor final
     : public RootAcceptor {
   HadesGC &gc;
   PointerBase &pointerBase_;
+  /// Cells that have been marked by this acceptor, but whose pointers have not
+  /// been visited yet.
+  std::vector<GCCell *> &worklist_;
+  /// The symbols found by this acceptor.
+  llvh::BitVector &markedSymbols_;
+  /// If non-null, other acceptors are marking on other threads at the same
+  /// time, and share their work through this queue.
+  MarkWorkQueue *const queue_;
   /// Current GCCell being visited. For heap locations that could be from a
   /// large object, we need this pointer to get the correct card table.
   const GCCell *currentCell_{nullptr};
 
  public:
-  MarkAcceptor(HadesGC &gc) : gc{gc}, pointerBase_{gc.getPointerBase()} {}
+  MarkAcceptor(HadesGC &gc)
+      : MarkAcceptor(
+            gc,
+            gc.markState_->localWorklist,
+            gc.markState_->markedSymbols,
+            nullptr) {}
+
+  /// Create an acceptor for one of the workers of a parallel marking round.
+  /// \p worklist and \p markedSymbols must not be used by any other worker.
+  MarkAcceptor(
+      HadesGC &gc,
+      std::vector<GCCell *> &worklist,
+      llvh::BitVector &markedSymbols,
+      MarkWorkQueue *queue)
+      : gc{gc},
+        pointerBase_{gc.getPointerBase()},
+        worklist_{worklist},
+        markedSymbols_{markedSymbols},
+        queue_{queue} {}
 
   void acceptHeap(GCCell *cell, const void *heapLoc) {
     assert(cell && "Cannot pass null pointer to acceptHeap");
@@ -831,12 +1302,12 @@ class HERMES_ATTRIBUTE_INTERNAL_LINKAGE HadesGC::MarkAcceptor final
 
   void acceptSym(SymbolID sym) {
     const uint32_t idx = sym.unsafeGetIndex();
-    if (sym.isInvalid() || idx >= gc.markState_->markedSymbols.size()) {
+    if (sym.isInvalid() || idx >= markedSymbols_.size()) {
       // Ignore symbols that aren't valid or are pointing outside of the range
       // when the collection began.
       return;
     }
-    gc.markState_->markedSymbols[idx] = true;
+    markedSymbols_[idx] = true;
   }
 
   void accept(const RootSymbolID &sym) override {
@@ -847,14 +1318,62 @@ class HERMES_ATTRIBUTE_INTERNAL_LINKAGE HadesGC::MarkAcceptor final
   }
 
   void push(GCCell *cell) {
-    assert(
-        !AlignedHeapSegment::getCellMarkBit(cell) &&
-        "A marked object should never be pushed onto a worklist");
     assert(
         !gc.inYoungGen(cell) &&
         "Shouldn't ever push a YG object onto the worklist");
-    AlignedHeapSegment::setCellMarkBit(cell);
-    gc.markState_->localWorklist.push(cell);
+    if (queue_) {
+      // Another worker may have marked the cell since the caller checked its
+      // mark bit, in which case that worker is responsible for it.
+      if (!AlignedHeapSegment::setCellMarkBitAtomic(cell))
+        return;
+    } else {
+      assert(
+          !AlignedHeapSegment::getCellMarkBit(cell) &&
+          "A marked object should never be pushed onto a worklist");
+      AlignedHeapSegment::setCellMarkBit(cell);
+    }
+    worklist_.push_back(cell);
+  }
+
+  /// Visit the cells on the worklist and everything reachable from them,
+  /// taking work from and giving work to the other workers through queue_.
+  /// Stop once no work is left, or once any worker has marked \p markLimit
+  /// bytes. \return the number of bytes marked by this worker.
+  size_t drainShared(size_t markLimit) {
+    assert(queue_ && "Only parallel workers share their work");
+    size_t numMarkedBytes = 0;
+    MarkWorkQueue::Batch batch;
+    do {
+      worklist_.insert(worklist_.end(), batch.begin(), batch.end());
+      while (!worklist_.empty()) {
+        if (queue_->aborted())
+          return numMarkedBytes;
+        if (numMarkedBytes >= markLimit) {
+          queue_->abort();
+          return numMarkedBytes;
+        }
+        if (worklist_.size() >= 2 * MarkWorkQueue::kBatchSize) {
+          // Give away the oldest cells, since they are the least likely to be
+          // close to what this worker visits next.
+          auto mid = worklist_.begin() + MarkWorkQueue::kBatchSize;
+          queue_->publish(MarkWorkQueue::Batch(worklist_.begin(), mid));
+          worklist_.erase(worklist_.begin(), mid);
+        }
+        GCCell *const cell = worklist_.back();
+        worklist_.pop_back();
+        assert(cell->isValid() && "Invalid cell in marking");
+        assert(
+            AlignedHeapSegment::getCellMarkBit(cell) &&
+            "Discovered unmarked object");
+        assert(
+            !gc.inYoungGen(cell) &&
+            "Shouldn't ever traverse a YG object in this loop");
+        numMarkedBytes += cell->getAllocatedSizeSlow();
+        setCurrentCell(cell);
+        gc.markCell(*this, cell);
+      }
+    } while (queue_->steal(batch));
+    return numMarkedBytes;
   }
 
   /// Set the current cell being visited.
@@ -926,10 +1445,14 @@ bool HadesGC::incrementalMark(size_t markLimit) {
     }
   }
 
+  if (ogMarkingWorkers_ && markLimit &&
+      markState_->localWorklist.size() >= MarkWorkQueue::kBatchSize)
+    return incrementalMarkParallel(markLimit);
+
   size_t numMarkedBytes = 0;
   while (!markState_->localWorklist.empty() && numMarkedBytes < markLimit) {
-    GCCell *const cell = markState_->localWorklist.top();
-    markState_->localWorklist.pop();
+    GCCell *const cell = markState_->localWorklist.back();
+    markState_->localWorklist.pop_back();
     assert(cell->isValid() && "Invalid cell in marking");
     assert(
         AlignedHeapSegment::getCellMarkBit(cell) &&
@@ -948,6 +1471,46 @@ bool HadesGC::incrementalMark(size_t markLimit) {
   return !markState_->localWorklist.empty();
 }
 
+bool HadesGC::incrementalMarkParallel(size_t markLimit) {
+  WorkerPool &workers = *ogMarkingWorkers_;
+  const unsigned numWorkers = workers.numWorkers();
+  MarkState &markState = *markState_;
+  // Each worker other than the calling thread records the symbols it finds
+  // separately, and they are merged once marking completes.
+  if (markState.workerMarkedSymbols.empty())
+    markState.workerMarkedSymbols.resize(
+        numWorkers - 1, llvh::BitVector(markState.markedSymbols.size()));
+
+  // The calling thread starts with the whole worklist, and gives batches of it
+  // away to the other workers as they ask for work.
+  std::vector<std::vector<GCCell *>> worklists(numWorkers);
+  worklists[0] = std::move(markState.localWorklist);
+  std::vector<size_t> markedBytes(numWorkers);
+  MarkWorkQueue queue{numWorkers};
+  workers.run([&](unsigned i) {
+    MarkAcceptor acceptor{
+        *this,
+        worklists[i],
+        i ? markState.workerMarkedSymbols[i - 1] : markState.markedSymbols,
+        &queue};
+    markedBytes[i] = acceptor.drainShared(markLimit);
+  });
+
+  // Collect the work that is left over if some worker reached the limit.
+  std::vector<GCCell *> &worklist = markState.localWorklist;
+  worklist = std::move(worklists[0]);
+  for (unsigned i = 1; i < numWorkers; ++i)
+    worklist.insert(worklist.end(), worklists[i].begin(), worklists[i].end());
+  MarkWorkQueue::Batch batch;
+  while (queue.take(batch))
+    worklist.insert(worklist.end(), batch.begin(), batch.end());
+
+  for (size_t bytes : markedBytes)
+    markState.markedBytes += bytes;
+  ++numParallelMarkRounds_;
+  return !worklist.empty();
+}
+
 /// Mark weak roots separately from the MarkAcceptor since this is done while
 /// the world is stopped.
 /// Don't use the default weak root acceptor because fine-grained control of
@@ -1076,7 +1639,104 @@ bool HadesGC::OldGen::sweepNext(bool backgroundThread) {
   // allocations into the old gen, which might boost the credited memory.
   const uint64_t externalBytesBefore = externalBytes();
 
-  auto &segBuckets = segmentBuckets_[sweepIterator_.segNumber];
+  const size_t segIdx = sweepIterator_.segNumber;
+  prepareSegmentForSweep(segIdx);
+  // Cannot concurrently trim storage. Technically just checking
+  // backgroundThread would suffice, but the kConcurrentGC lets us compile
+  // away this check in incremental mode.
+  const bool trim = !(kConcurrentGC && backgroundThread);
+  uint64_t trimmedBytes = 0;
+  const int32_t segmentSweptBytes = sweepSegment(
+      segIdx, trim, trimmedBytes, [this, isTracking](GCCell *cell, uint32_t sz) {
+        // Cell is dead, run its finalizer first if it has one.
+        cell->getVT()->finalizeIfExists(cell, gc_);
+        if (isTracking && !vmisa<FillerCell>(cell)) {
+          gc_.untrackObject(cell, sz);
+        }
+      });
+  finishSegmentSweep(segIdx, segmentSweptBytes);
+#ifndef NDEBUG
+  sweepIterator_.trimmedBytes += trimmedBytes;
+#endif
+  sweepIterator_.sweptExternalBytes += externalBytesBefore - externalBytes();
+
+  // There are more iterations to go.
+  if (sweepIterator_.segNumber)
+    return true;
+
+  endSweep();
+  return false;
+}
+
+bool HadesGC::OldGen::sweepNextParallel(
+    WorkerPool &workers,
+    bool backgroundThread) {
+  if (!sweepIterator_.segNumber) {
+    endSweep();
+    return false;
+  }
+  assert(gc_.gcMutex_ && "gcMutex_ must be held while sweeping.");
+  assert(!gc_.isTrackingIDs() && "Untracking objects must be done serially");
+
+  // Each worker sweeps one of the next segments.
+  const size_t numSegs =
+      std::min<size_t>(workers.numWorkers(), sweepIterator_.segNumber);
+  const size_t firstSeg = sweepIterator_.segNumber - numSegs;
+  sweepIterator_.segNumber = firstSeg;
+  const uint64_t externalBytesBefore = externalBytes();
+  for (size_t i = firstSeg; i < firstSeg + numSegs; ++i)
+    prepareSegmentForSweep(i);
+
+  // Finalizers may only run on the thread holding gcMutex_, so find the dead
+  // cells that have one first, and run them here before the workers reuse the
+  // memory of those cells.
+  std::vector<std::vector<GCCell *>> toFinalize(numSegs);
+  workers.run([this, firstSeg, numSegs, &toFinalize](unsigned i) {
+    if (i >= numSegs)
+      return;
+    auto &seg = segments_[firstSeg + i];
+    for (GCCell *cell = reinterpret_cast<GCCell *>(seg.start()),
+                *end = reinterpret_cast<GCCell *>(seg.level());
+         cell < end;
+         cell = cell->nextCell()) {
+      if (!AlignedHeapSegment::getCellMarkBit(cell) &&
+          cell->getVT()->finalize_)
+        toFinalize[i].push_back(cell);
+    }
+  });
+  for (const auto &cells : toFinalize)
+    for (GCCell *cell : cells)
+      cell->getVT()->finalize(cell, gc_);
+
+  // As in sweepNext(), cells can only be trimmed while the mutator is not
+  // running.
+  const bool trim = !(kConcurrentGC && backgroundThread);
+  std::vector<int32_t> sweptBytes(numSegs);
+  std::vector<uint64_t> trimmedBytes(numSegs);
+  workers.run(
+      [this, firstSeg, numSegs, trim, &sweptBytes, &trimmedBytes](unsigned i) {
+        if (i < numSegs)
+          sweptBytes[i] = sweepSegment(
+              firstSeg + i, trim, trimmedBytes[i], [](GCCell *, uint32_t) {});
+      });
+  for (size_t i = 0; i < numSegs; ++i) {
+    finishSegmentSweep(firstSeg + i, sweptBytes[i]);
+#ifndef NDEBUG
+    sweepIterator_.trimmedBytes += trimmedBytes[i];
+#endif
+  }
+  sweepIterator_.sweptExternalBytes += externalBytesBefore - externalBytes();
+  ++gc_.numParallelSweepRounds_;
+
+  if (sweepIterator_.segNumber)
+    return true;
+
+  endSweep();
+  return false;
+}
+
+void HadesGC::OldGen::prepareSegmentForSweep(size_t segIdx) {
+  auto &segBuckets = segmentBuckets_[segIdx];
 
   // Clear the head pointers and remove this segment from the segment level
   // freelists, so that we can construct a new freelist. The
@@ -1093,23 +1753,28 @@ bool HadesGC::OldGen::sweepNext(bool backgroundThread) {
   }
 
   // If allocChunk is in this segment, it may get coalesced, so delete it first.
-  if (segments_[sweepIterator_.segNumber].contains(allocChunk_))
+  if (segments_[segIdx].contains(allocChunk_))
     allocChunk_ = nullptr;
+}
 
+template <typename DeadCellCallback>
+int32_t HadesGC::OldGen::sweepSegment(
+    size_t segIdx,
+    bool trim,
+    uint64_t &trimmedBytes,
+    const DeadCellCallback &onDeadCell) {
+  auto &segBuckets = segmentBuckets_[segIdx];
   char *freeRangeStart = nullptr, *freeRangeEnd = nullptr;
   size_t mergedCells = 0;
   int32_t segmentSweptBytes = 0;
-  auto &seg = segments_[sweepIterator_.segNumber];
+  auto &seg = segments_[segIdx];
   for (GCCell *cell = reinterpret_cast<GCCell *>(seg.start()),
               *end = reinterpret_cast<GCCell *>(seg.level());
        cell < end;
        cell = cell->nextCell()) {
     assert(cell->isValid() && "Invalid cell in sweeping");
     if (AlignedHeapSegment::getCellMarkBit(cell)) {
-      // Cannot concurrently trim storage. Technically just checking
-      // backgroundThread would suffice, but the kConcurrentGC lets us compile
-      // away this check in incremental mode.
-      if (kConcurrentGC && backgroundThread)
+      if (!trim)
         continue;
       const uint32_t cellSize = cell->getAllocatedSize();
       const uint32_t trimmedSize =
@@ -1134,9 +1799,7 @@ bool HadesGC::OldGen::sweepNext(bool backgroundThread) {
             !AlignedHeapSegment::getCellMarkBit(newCell) &&
             "Trimmed space cannot be marked");
         FixedSizeHeapSegment::setCellHead(newCell, trimmableBytes);
-#ifndef NDEBUG
-        sweepIterator_.trimmedBytes += trimmableBytes;
-#endif
+        trimmedBytes += trimmableBytes;
       }
       continue;
     }
@@ -1164,18 +1827,20 @@ bool HadesGC::OldGen::sweepNext(bool backgroundThread) {
       continue;
 
     segmentSweptBytes += sz;
-    // Cell is dead, run its finalizer first if it has one.
-    cell->getVT()->finalizeIfExists(cell, gc_);
-    if (isTracking && !vmisa<FillerCell>(cell)) {
-      gc_.untrackObject(cell, sz);
-    }
+    onDeadCell(cell, sz);
   }
 
   // Flush any free range that was left over.
   if (freeRangeStart)
     addCellToFreelistFromSweep(
         freeRangeStart, freeRangeEnd, segBuckets, mergedCells > 1);
+  return segmentSweptBytes;
+}
 
+void HadesGC::OldGen::finishSegmentSweep(
+    size_t segIdx,
+    int32_t segmentSweptBytes) {
+  auto &segBuckets = segmentBuckets_[segIdx];
   // Update the segment level freelists for any buckets that this segment has
   // free cells for.
   for (size_t bucket = 0; bucket < kNumFreelistBuckets; ++bucket) {
@@ -1193,14 +1858,6 @@ bool HadesGC::OldGen::sweepNext(bool backgroundThread) {
   // Correct the allocated byte count.
   decrementAllocatedBytes(segmentSweptBytes);
   sweepIterator_.sweptBytes += segmentSweptBytes;
-  sweepIterator_.sweptExternalBytes += externalBytesBefore - externalBytes();
-
-  // There are more iterations to go.
-  if (sweepIterator_.segNumber)
-    return true;
-
-  endSweep();
-  return false;
 }
 
 void HadesGC::OldGen::endSweep() {
@@ -1279,8 +1936,23 @@ HadesGC::HadesGC(
       oldGen_{*this},
       backgroundExecutor_{
           kConcurrentGC ? std::make_unique<Executor>() : nullptr},
+      ygEvacuationWorkers_{
+          kConcurrentGC && gcConfig.getYoungGenEvacuationThreads() > 1
+              ? std::make_unique<WorkerPool>(
+                    gcConfig.getYoungGenEvacuationThreads())
+              : nullptr},
+      ogMarkingWorkers_{
+          kConcurrentGC && gcConfig.getOldGenMarkingThreads() > 1
+              ? std::make_unique<WorkerPool>(gcConfig.getOldGenMarkingThreads())
+              : nullptr},
+      ogSweepingWorkers_{
+          kConcurrentGC && gcConfig.getOldGenSweepingThreads() > 1
+              ? std::make_unique<WorkerPool>(
+                    gcConfig.getOldGenSweepingThreads())
+              : nullptr},
       promoteYGToOG_{!gcConfig.getAllocInYoung()},
       revertToYGAtTTI_{gcConfig.getRevertToYGAtTTI()},
+      sweepOnAllocation_{gcConfig.getSweepOnAllocation()},
       overwriteDeadYGObjects_{gcConfig.getOverwriteDeadYGObjects()},
       occupancyTarget_(gcConfig.getOccupancyTarget()),
       ygAverageSurvivalBytes_{/*weight*/ 0.5,
@@ -1322,6 +1994,10 @@ void HadesGC::getHeapInfo(HeapInfo &info) {
   info.externalBytes = oldGen_.externalBytes() + getYoungGenExternalBytes();
   info.numLargeAllocations = oldGen_.numLargeAllocations();
   info.allocatedLargeObjectBytes = oldGen_.allocatedLargeObjectBytes();
+  info.numOldGenAllocations = oldGen_.numAllocations();
+  info.numOldGenAllocChunkRefills = oldGen_.numAllocChunkRefills();
+  info.numParallelYoungCollections = numParallelYoungCollections_;
+  info.youngGenEvacuatedBytesPerWorker = ygEvacuatedBytesPerWorker_;
   info.youngGenStats = ygCumulativeStats_;
   info.fullStats = ogCumulativeStats_;
 }
@@ -1449,8 +2125,24 @@ void HadesGC::printStats(JSONEmitter &json) {
   json.emitKeyValue(
       "Current heap bytes of large allocation",
       oldGen_.allocatedLargeObjectBytes());
+  json.emitKeyValue("Num old gen allocations", oldGen_.numAllocations());
+  json.emitKeyValue(
+      "Num old gen alloc chunk refills", oldGen_.numAllocChunkRefills());
   json.emitKeyValue("Num young gen collections", numYoungCollections_);
   json.emitKeyValue("Num old gen collections", numOldCollections_);
+  if (ygEvacuationWorkers_) {
+    json.emitKeyValue(
+        "Num parallel young gen collections", numParallelYoungCollections_);
+    json.emitKey("Young gen bytes evacuated per worker");
+    json.openArray();
+    for (uint64_t bytes : ygEvacuatedBytesPerWorker_)
+      json.emitValue(bytes);
+    json.closeArray();
+  }
+  if (ogMarkingWorkers_)
+    json.emitKeyValue("Num parallel marking rounds", numParallelMarkRounds_);
+  if (ogSweepingWorkers_)
+    json.emitKeyValue("Num parallel sweeping rounds", numParallelSweepRounds_);
   json.closeDict();
   json.closeDict();
 }
@@ -1481,6 +2173,18 @@ void HadesGC::collect(std::string cause, bool /*canEffectiveOOM*/) {
   youngGenCollection(std::move(cause), /*forceOldGenCollection*/ false);
 }
 
+void HadesGC::yieldToGC() {
+  std::lock_guard<Mutex> lk{gcMutex_};
+  // A concurrent collection only needs the mutator to complete marking, while
+  // an incremental one only makes progress when the mutator does work. Either
+  // way a YG collection is needed, since it yields to the OG with an empty YG.
+  if (concurrentPhase_ == Phase::None ||
+      (kConcurrentGC && concurrentPhase_ != Phase::CompleteMarking))
+    return;
+  youngGenCollection(
+      kNaturalCauseForAnalytics, /*forceOldGenCollection*/ false);
+}
+
 void HadesGC::waitForCollectionToFinish(std::string cause) {
   assert(
       gcMutex_ &&
@@ -1694,8 +2398,13 @@ void HadesGC::incrementalCollect(bool backgroundThread) {
     case Phase::Sweep:
       if (!kConcurrentGC && ygCollectionStats_)
         ygCollectionStats_->addCollectionType("sweeping");
-      // Calling oldGen_.sweepNext() will sweep the next segment.
-      if (!oldGen_.sweepNext(backgroundThread)) {
+      // Calling oldGen_.sweepNext() will sweep the next segment. The workers
+      // only exist when the GC is concurrent, where the mutator only sweeps
+      // while it is blocked on the sweep, so it uses them too.
+      if (!(ogSweepingWorkers_ && !isTrackingIDs()
+                ? oldGen_.sweepNextParallel(
+                      *ogSweepingWorkers_, backgroundThread)
+                : oldGen_.sweepNext(backgroundThread))) {
         // Finish any collection bookkeeping.
         ogCollectionStats_->setEndTime();
         ogCollectionStats_->setAfterSize(segmentFootprint());
@@ -1902,6 +2611,9 @@ void HadesGC::completeMarking() {
   // Reset weak roots to null after full reachability has been
   // determined.
   markState_->markedSymbols |= markState_->writeBarrierMarkedSymbols;
+  for (const llvh::BitVector &workerMarkedSymbols :
+       markState_->workerMarkedSymbols)
+    markState_->markedSymbols |= workerMarkedSymbols;
 
   // Now free symbols. Note that:
   // 1. We must do this before marking weak symbols, because the mark bits
@@ -2400,8 +3112,14 @@ void *HadesGC::allocLongLived(uint32_t sz) {
   return oldGen_.allocLarge<mayFail>(sz);
 }
 
+/// The preferred size of the allocChunk_. Large enough that a run of long-lived
+/// allocations, like the ones made while loading a bytecode module, rarely has
+/// to go back to the freelist.
+static constexpr uint32_t kAllocChunkSize = 16 * 1024;
+
 GCCell *HadesGC::OldGen::alloc(uint32_t sz) {
   ++NumOldGenAlloc;
+  ++numAllocations_;
   // First try to allocate out of the allocChunk_.
   if (LLVM_LIKELY(
           allocChunk_ &&
@@ -2422,10 +3140,20 @@ GCCell *HadesGC::OldGen::allocSlow(uint32_t sz) {
   assert(
       sz <= maxNormalAllocationSize() && "Allocating too large of an object");
   assert(gc_.gcMutex_ && "gcMutex_ must be held before calling oldGenAlloc");
-  if (GCCell *cell = search(sz)) {
+  if (GCCell *cell = allocFromFreelist(sz)) {
     return cell;
   }
 
+  // If the OG is still being swept, sweeping the remaining segments now may
+  // free up enough memory without growing the heap.
+  if (gc_.sweepOnAllocation_) {
+    while (gc_.concurrentPhase_ == Phase::Sweep) {
+      gc_.incrementalCollect(false);
+      if (GCCell *cell = allocFromFreelist(sz))
+        return cell;
+    }
+  }
+
   /// Allocate from this newly created segment.
   auto allocFromNewSegment = [this, sz](FixedSizeHeapSegment seg) {
     // Complete this allocation using a bump alloc.
@@ -2474,6 +3202,63 @@ GCCell *HadesGC::OldGen::allocSlow(uint32_t sz) {
   gc_.oom(seg.getError());
 }
 
+GCCell *HadesGC::OldGen::allocFromFreelist(uint32_t sz) {
+  if (sz >= kMinSizeForLargeBlock)
+    return search(sz);
+  // A free cell of exactly the right size doesn't split anything. Otherwise,
+  // take a fresh chunk that the following small allocations can bump allocate
+  // from, and only fall back to a tight fit when no such block is left.
+  if (GCCell *cell = allocExactFit(sz))
+    return cell;
+  if (GCCell *cell = refillAllocChunk(sz))
+    return cell;
+  return search(sz);
+}
+
+GCCell *HadesGC::OldGen::allocExactFit(uint32_t sz) {
+  const uint32_t bucket = getFreelistBucket(sz);
+  assert(
+      bucket < kNumSmallFreelistBuckets &&
+      "Only small buckets hold cells of a single size");
+  if (!freelistBucketBitArray_.at(bucket))
+    return nullptr;
+  FreelistCell *cell = removeCellFromFreelist(bucket, buckets_[bucket].next);
+  assert(
+      cell->getAllocatedSize() == sz &&
+      "Found an incorrectly sized block in this bucket");
+  return finishAlloc(cell, sz);
+}
+
+GCCell *HadesGC::OldGen::refillAllocChunk(uint32_t sz) {
+  const uint32_t chunkSize =
+      std::max(sz + minAllocationSize(), kAllocChunkSize);
+  auto [cell, baseBucket] = removeFirstFit(chunkSize);
+  if (!cell)
+    return nullptr;
+  ++NumOldGenAllocChunkRefill;
+  ++numAllocChunkRefills_;
+
+  // Only keep what the chunk needs, and return the rest to the freelist so
+  // that later refills and evacuation buffers can be carved out of it.
+  if (cell->getAllocatedSize() >= chunkSize + minAllocationSize()) {
+    GCCell *chunkCell = cell->carve(chunkSize);
+    addCellToFreelist(
+        cell, baseBucket + getFreelistBucket(cell->getAllocatedSize()));
+    cell = constructCell<FreelistCell>(chunkCell, chunkSize);
+  }
+  if (allocChunk_) {
+    addCellToFreelist(
+        allocChunk_,
+        allocChunkBaseBucket_ +
+            getFreelistBucket(allocChunk_->getAllocatedSize()));
+  }
+  allocChunk_ = cell;
+  allocChunkBaseBucket_ = baseBucket;
+  auto *newCell = allocChunk_->carve(sz);
+  ASAN_POISON_FREE_CELL(allocChunk_);
+  return finishAlloc(newCell, sz);
+}
+
 uint32_t HadesGC::OldGen::getFreelistBucket(uint32_t size) {
   // If the size corresponds to the "small" portion of the freelist, then the
   // bucket is just (size) / (heap alignment)
@@ -2572,6 +3357,115 @@ GCCell *HadesGC::OldGen::search(uint32_t sz) {
   return nullptr;
 }
 
+/// The preferred size of each EvacBuffer. Large enough that workers rarely
+/// contend on refills, small enough that the space left over in each buffer at
+/// the end of a collection is negligible.
+static constexpr uint32_t kEvacBufferSize = 32 * 1024;
+
+GCCell *HadesGC::OldGen::EvacBuffer::alloc(uint32_t sz) {
+  if (!cell_)
+    return nullptr;
+  const uint32_t avail = cell_->getAllocatedSize();
+  GCCell *newCell;
+  if (avail >= sz + minAllocationSize()) {
+    newCell = cell_->carve(sz);
+  } else if (avail == sz) {
+    // Exact match, hand out the whole buffer. Its cell head is already set.
+    newCell = cell_;
+    cell_ = nullptr;
+  } else {
+    return nullptr;
+  }
+  allocatedBytes_ += sz;
+  return newCell;
+}
+
+void HadesGC::OldGen::EvacBuffer::undoAlloc(GCCell *cell, uint32_t sz) {
+  assert(allocatedBytes_ >= sz && "Undoing more than was allocated");
+  allocatedBytes_ -= sz;
+  if (!cell_) {
+    // The allocation took the whole buffer, turn it back into a free cell.
+    cell_ = constructCell<FreelistCell>(cell, sz);
+    return;
+  }
+  assert(
+      reinterpret_cast<char *>(cell_->nextCell()) ==
+          reinterpret_cast<char *>(cell) &&
+      "Can only undo the most recent allocation");
+  const uint32_t newSize = cell_->getAllocatedSize() + sz;
+  cell_ = constructCell<FreelistCell>(cell_, newSize);
+  // carve() pointed the cell heads of any cards in the given back region at
+  // the carved cell, point them back at the buffer.
+  FixedSizeHeapSegment::setCellHead(cell_, newSize);
+}
+
+std::pair<HadesGC::OldGen::FreelistCell *, HadesGC::OldGen::SegmentBucket *>
+HadesGC::OldGen::removeFirstFit(uint32_t sz) {
+  for (size_t bucket =
+           freelistBucketBitArray_.findNextSetBitFrom(getFreelistBucket(sz));
+       bucket < kNumFreelistBuckets;
+       bucket = freelistBucketBitArray_.findNextSetBitFrom(bucket + 1)) {
+    for (auto *segBucket = buckets_[bucket].next; segBucket;
+         segBucket = segBucket->next) {
+      AssignableCompressedPointer *prevLoc = &segBucket->head;
+      while (*prevLoc) {
+        auto *cell =
+            vmcast<FreelistCell>(prevLoc->getNonNull(gc_.getPointerBase()));
+        if (cell->getAllocatedSize() >= sz) {
+          removeCellFromFreelist(prevLoc, bucket, segBucket);
+          // Since the buckets for each segment are stored contiguously in
+          // memory, we can compute the base bucket relative to the current one.
+          return {cell, segBucket - bucket};
+        }
+        prevLoc = &cell->next_;
+      }
+    }
+  }
+  return {nullptr, nullptr};
+}
+
+bool HadesGC::OldGen::refillEvacBuffer(EvacBuffer &buf, uint32_t sz) {
+  retireEvacBuffer(buf);
+  const uint32_t bufSize = std::max(sz, kEvacBufferSize);
+  // Prefer a block big enough to hold many cells, but settle for anything that
+  // fits this one.
+  auto [cell, baseBucket] = removeFirstFit(bufSize);
+  if (!cell && allocChunk_ && allocChunk_->getAllocatedSize() >= sz) {
+    cell = allocChunk_;
+    baseBucket = allocChunkBaseBucket_;
+    allocChunk_ = nullptr;
+    __asan_unpoison_memory_region(
+        cell + 1, cell->getAllocatedSize() - sizeof(FreelistCell));
+  }
+  if (!cell)
+    std::tie(cell, baseBucket) = removeFirstFit(sz);
+  if (!cell)
+    return false;
+
+  // Only keep what the buffer needs, and return the rest to the freelist so
+  // that other buffers can be carved out of it.
+  if (cell->getAllocatedSize() >= bufSize + minAllocationSize()) {
+    GCCell *bufCell = cell->carve(bufSize);
+    addCellToFreelist(
+        cell, baseBucket + getFreelistBucket(cell->getAllocatedSize()));
+    cell = constructCell<FreelistCell>(bufCell, bufSize);
+  }
+  buf.cell_ = cell;
+  buf.baseBucket_ = baseBucket;
+  return true;
+}
+
+void HadesGC::OldGen::retireEvacBuffer(EvacBuffer &buf) {
+  incrementAllocatedBytes(buf.allocatedBytes_);
+  buf.allocatedBytes_ = 0;
+  if (!buf.cell_)
+    return;
+  addCellToFreelist(
+      buf.cell_,
+      buf.baseBucket_ + getFreelistBucket(buf.cell_->getAllocatedSize()));
+  buf.cell_ = nullptr;
+}
+
 template <bool CompactionEnabled>
 uint64_t HadesGC::youngGenEvacuateImpl(bool doCompaction) {
   assert((!doCompaction || CompactionEnabled) && "Compaction is disabled");
@@ -2624,6 +3518,105 @@ uint64_t HadesGC::youngGenEvacuateImpl(bool doCompaction) {
   return acceptor.evacuatedBytes();
 }
 
+uint64_t HadesGC::youngGenEvacuateParallel() {
+  assert(
+      !compactee_.segment && !isTrackingIDs() &&
+      "Parallel evacuation does not support compaction or ID tracking");
+  WorkerPool &workers = *ygEvacuationWorkers_;
+  const unsigned numWorkers = workers.numWorkers();
+  EvacWorkQueue queue{numWorkers};
+  std::vector<std::unique_ptr<ParallelEvacAcceptor>> acceptors;
+  for (unsigned i = 0; i < numWorkers; ++i)
+    acceptors.push_back(std::make_unique<ParallelEvacAcceptor>(*this, queue));
+  ParallelEvacAcceptor &mainAcceptor = *acceptors[0];
+
+  // Find old-to-young pointers, as they are considered roots for YG
+  // collection. Unlike scanDirtyCards, nothing is evacuated yet, so the OG is
+  // not modified while the workers are walking it. Free cells never hold
+  // pointers, and skipping them means it is safe to allocate over them below.
+  std::vector<JumboHeapSegment *> jumboSegments;
+  for (JumboHeapSegment &seg : oldGen_.getJumboSegments())
+    jumboSegments.push_back(&seg);
+  const size_t numSegments = oldGen_.numSegments();
+  std::atomic<size_t> nextSegment{0};
+  workers.run([&](unsigned idx) {
+    ParallelEvacAcceptor &acceptor = *acceptors[idx];
+    auto pushCell = [&acceptor](GCCell *cell) {
+      if (!vmisa<OldGen::FreelistCell>(cell))
+        acceptor.pushDirtyRange(cell, nullptr, nullptr);
+    };
+    auto pushCellWithinRange =
+        [&acceptor](GCCell *cell, const char *begin, const char *end) {
+          if (!vmisa<OldGen::FreelistCell>(cell))
+            acceptor.pushDirtyRange(cell, begin, end);
+        };
+    for (size_t i; (i = nextSegment.fetch_add(1, std::memory_order_relaxed)) <
+         numSegments + jumboSegments.size();) {
+      if (i < numSegments) {
+        FixedSizeHeapSegment &seg = oldGen_.getSegments()[i];
+        visitDirtyCardsForSegment(seg, pushCell, pushCellWithinRange);
+        seg.clearAllCards();
+      } else {
+        JumboHeapSegment &seg = *jumboSegments[i - numSegments];
+        visitDirtyCardsForSegment(seg, pushCellWithinRange);
+        seg.clearAllCards();
+      }
+    }
+  });
+
+  // The runtime can only enumerate its roots on one thread, so mark them
+  // here. This is also the only point at which the OG can grow, since
+  // creating a segment is not safe on the worker threads.
+  mainAcceptor.setRunningAlone(true);
+  {
+    DroppingAcceptor nameAcceptor{mainAcceptor};
+    markRoots(nameAcceptor, /*markLongLived*/ false);
+  }
+  // See the equivalent step in youngGenEvacuateImpl.
+  weakMapEntrySlots_.forEach([&mainAcceptor](WeakMapEntrySlot &slot) {
+    mainAcceptor.accept(slot.mappedValue);
+  });
+
+  // Copy everything reachable from the work found above. Whenever a worker
+  // runs out of space in the OG, all of them stop, and the OG is grown here
+  // before resuming. If it cannot grow, finish the work on this thread, since
+  // that may require waiting for the OG collection to complete.
+  bool finishAlone = mainAcceptor.isBlocking();
+  while (!finishAlone) {
+    mainAcceptor.setRunningAlone(false);
+    workers.run([&acceptors](unsigned idx) { acceptors[idx]->drain(); });
+    for (auto &acceptor : acceptors)
+      oldGen_.retireEvacBuffer(acceptor->buffer());
+    if (!queue.aborted())
+      break;
+    queue.reset();
+    llvh::ErrorOr<FixedSizeHeapSegment> seg = createSegment();
+    if (seg)
+      oldGen_.addSegment(std::move(seg.get()));
+    else
+      finishAlone = true;
+  }
+  if (finishAlone) {
+    mainAcceptor.setRunningAlone(true);
+    mainAcceptor.drainAlone(acceptors);
+    oldGen_.retireEvacBuffer(mainAcceptor.buffer());
+  }
+
+  // Weak roots only need the forwarding pointers installed above, so the
+  // serial acceptor can update them.
+  EvacAcceptor<false> weakAcceptor{*this, false};
+  markWeakRoots(weakAcceptor, /*markLongLived*/ false);
+
+  uint64_t evacuatedBytes = 0;
+  ygEvacuatedBytesPerWorker_.resize(numWorkers);
+  for (unsigned i = 0; i < numWorkers; ++i) {
+    evacuatedBytes += acceptors[i]->evacuatedBytes();
+    ygEvacuatedBytesPerWorker_[i] += acceptors[i]->evacuatedBytes();
+  }
+  ++numParallelYoungCollections_;
+  return evacuatedBytes;
+}
+
 void HadesGC::youngGenCollection(
     std::string cause,
     bool forceOldGenCollection) {
@@ -2676,6 +3669,9 @@ void HadesGC::youngGenCollection(
       // The remaining bytes after the collection is just the number of bytes
       // that were evacuated.
       heapBytes.after = youngGenEvacuateImpl<true>(doCompaction);
+    } else if (ygEvacuationWorkers_ && !isTrackingIDs()) {
+      heapBytes.after = youngGenEvacuateParallel();
+      ygCollectionStats_->addCollectionType("parallel");
     } else {
       heapBytes.after = youngGenEvacuateImpl<false>(false);
     }
@@ -2913,10 +3909,11 @@ void HadesGC::updateYoungGenSizeFactor() {
     ygSizeFactor_ = std::max(ygSizeFactor_ * 0.9, 0.25);
 }
 
-template <bool CompactionEnabled>
-void HadesGC::scanDirtyCardsForSegment(
-    EvacAcceptor<CompactionEnabled> &acceptor,
-    FixedSizeHeapSegment &seg) {
+template <typename VisitCell, typename VisitCellWithinRange>
+void HadesGC::visitDirtyCardsForSegment(
+    FixedSizeHeapSegment &seg,
+    VisitCell visitCell,
+    VisitCellWithinRange visitCellWithinRange) {
   // Use level instead of end in case the OG segment is still in bump alloc
   // mode.
   const char *const origSegLevel = seg.level();
@@ -2969,10 +3966,8 @@ void HadesGC::scanDirtyCardsForSegment(
     // expensive.
 
     // Mark the first object with respect to the dirty card boundaries.
-    if (visitUnmarked || AlignedHeapSegment::getCellMarkBit(obj)) {
-      acceptor.setCurrentCell(obj);
-      markCellWithinRange(acceptor, obj, begin, end);
-    }
+    if (visitUnmarked || AlignedHeapSegment::getCellMarkBit(obj))
+      visitCellWithinRange(obj, begin, end);
 
     obj = obj->nextCell();
     // If there are additional objects in this card, scan them.
@@ -2983,10 +3978,8 @@ void HadesGC::scanDirtyCardsForSegment(
       // object where next is within the card.
       for (GCCell *next = obj->nextCell(); next < boundary;
            next = next->nextCell()) {
-        if (visitUnmarked || AlignedHeapSegment::getCellMarkBit(obj)) {
-          acceptor.setCurrentCell(obj);
-          markCell(acceptor, obj);
-        }
+        if (visitUnmarked || AlignedHeapSegment::getCellMarkBit(obj))
+          visitCell(obj);
         obj = next;
       }
 
@@ -2995,20 +3988,18 @@ void HadesGC::scanDirtyCardsForSegment(
       assert(
           obj < boundary && obj->nextCell() >= boundary &&
           "Last object in card must touch or cross cross the card boundary");
-      if (visitUnmarked || AlignedHeapSegment::getCellMarkBit(obj)) {
-        acceptor.setCurrentCell(obj);
-        markCellWithinRange(acceptor, obj, begin, end);
-      }
+      if (visitUnmarked || AlignedHeapSegment::getCellMarkBit(obj))
+        visitCellWithinRange(obj, begin, end);
     }
 
     from = iEnd;
   }
 }
 
-template <bool CompactionEnabled>
-void HadesGC::scanDirtyCardsForSegment(
-    EvacAcceptor<CompactionEnabled> &acceptor,
-    JumboHeapSegment &seg) {
+template <typename VisitCellWithinRange>
+void HadesGC::visitDirtyCardsForSegment(
+    JumboHeapSegment &seg,
+    VisitCellWithinRange visitCellWithinRange) {
   auto *cell = reinterpret_cast<GCCell *>(seg.start());
 
   // If it's Sweep phase and the object is dead, don't scan it. For more
@@ -3022,7 +4013,6 @@ void HadesGC::scanDirtyCardsForSegment(
   size_t from = seg.addressToCardIndex(seg.start());
   const size_t to = seg.addressToCardIndex(segEnd - 1) + 1;
 
-  acceptor.setCurrentCell(cell);
   while (const auto oiBegin = seg.findNextDirtyCard(from, to)) {
     const auto iBegin = *oiBegin;
 
@@ -3039,12 +4029,40 @@ void HadesGC::scanDirtyCardsForSegment(
     const char *const begin = seg.cardIndexToAddress(iBegin);
     const char *const end = seg.cardIndexToAddress(iEnd);
 
-    markCellWithinRange(acceptor, cell, begin, end);
+    visitCellWithinRange(cell, begin, end);
 
     from = iEnd;
   }
 }
 
+template <bool CompactionEnabled>
+void HadesGC::scanDirtyCardsForSegment(
+    EvacAcceptor<CompactionEnabled> &acceptor,
+    FixedSizeHeapSegment &seg) {
+  visitDirtyCardsForSegment(
+      seg,
+      [this, &acceptor](GCCell *cell) {
+        acceptor.setCurrentCell(cell);
+        markCell(acceptor, cell);
+      },
+      [this, &acceptor](GCCell *cell, const char *begin, const char *end) {
+        acceptor.setCurrentCell(cell);
+        markCellWithinRange(acceptor, cell, begin, end);
+      });
+}
+
+template <bool CompactionEnabled>
+void HadesGC::scanDirtyCardsForSegment(
+    EvacAcceptor<CompactionEnabled> &acceptor,
+    JumboHeapSegment &seg) {
+  visitDirtyCardsForSegment(
+      seg,
+      [this, &acceptor](GCCell *cell, const char *begin, const char *end) {
+        acceptor.setCurrentCell(cell);
+        markCellWithinRange(acceptor, cell, begin, end);
+      });
+}
+
 template <bool CompactionEnabled>
 void HadesGC::scanDirtyCards(
     EvacAcceptor<CompactionEnabled> &acceptor,
@@ -3137,6 +4155,19 @@ unsigned HadesGC::OldGen::numLargeAllocations() const {
   return numLargeAllocations_;
 }
 
+uint64_t HadesGC::OldGen::numAllocations() const {
+  assert(
+      gc_.gcMutex_ && "gcMutex must be held when accessing numAllocations_");
+  return numAllocations_;
+}
+
+uint64_t HadesGC::OldGen::numAllocChunkRefills() const {
+  assert(
+      gc_.gcMutex_ &&
+      "gcMutex must be held when accessing numAllocChunkRefills_");
+  return numAllocChunkRefills_;
+}
+
 void HadesGC::OldGen::incrementAllocatedBytes(size_t incr) {
   allocatedBytes_ += incr;
   assert(allocatedBytes_ <= size() && "Invalid increment");
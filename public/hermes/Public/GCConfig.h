@@ -185,6 +185,24 @@ enum class GCEventKind {
   /* Whether to use mprotect on GC metadata between GCs. */              \
   F(constexpr, bool, ProtectMetadata, false)                             \
                                                                          \
+  /* Number of threads, including the mutator, used to evacuate the */   \
+  /* young gen. A value of 1 or less evacuates on the mutator only. */   \
+  F(constexpr, unsigned, YoungGenEvacuationThreads, 1)                   \
+                                                                         \
+  /* Number of threads, including the thread driving the collection, */  \
+  /* used to mark the old gen. A value of 1 or less marks on a single */ \
+  /* thread. */                                                          \
+  F(constexpr, unsigned, OldGenMarkingThreads, 1)                        \
+                                                                         \
+  /* Number of threads used to sweep the old gen. A value of 1 or */    \
+  /* less sweeps one segment at a time. */                               \
+  F(constexpr, unsigned, OldGenSweepingThreads, 1)                       \
+                                                                         \
+  /* Whether an old gen allocation that finds no free space while the */ \
+  /* old gen is being swept should finish sweeping before growing the */ \
+  /* heap. */                                                            \
+  F(constexpr, bool, SweepOnAllocation, false)                           \
+                                                                         \
   /* Callout for an analytics event. */                                  \
   F(HERMES_NON_CONSTEXPR,                                                \
     std::function<void(const GCAnalyticsEvent &)>,                       \
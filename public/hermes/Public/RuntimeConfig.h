@@ -77,6 +77,12 @@ class PinnedHermesValue;
   /* Support for using microtasks. */                                  \
   F(constexpr, bool, MicrotaskQueue, true)                             \
                                                                        \
+  /* Search regexps in linear time when they allow it. */              \
+  F(constexpr, bool, RegExpLinearTime, false)                          \
+                                                                       \
+  /* Whether Atomics.wait may block the thread (e.g. in workers). */   \
+  F(constexpr, bool, AgentCanSuspend, false)                           \
+                                                                       \
   /* Runtime set up for synth trace. */                                \
   F(constexpr, SynthTraceMode, SynthTraceMode, SynthTraceMode::None)   \
                                                                        \
@@ -129,6 +135,18 @@ class PinnedHermesValue;
   /* JIT memory limit, after which no more code will be JIT'ed. */     \
   F(constexpr, uint32_t, JITMemoryLimit, 32u << 20)                    \
                                                                        \
+  /* Compile JIT functions on a background thread. */                  \
+  F(constexpr, bool, JITBackground, false)                             \
+                                                                       \
+  /* Maximum number of functions queued for background JIT. */         \
+  F(constexpr, uint32_t, JITQueueLimit, 16)                            \
+                                                                       \
+  /* Loop iterations before a call switches to JIT code (0: never). */ \
+  F(constexpr, uint32_t, JITOSRThreshold, 1u << 10)                    \
+                                                                       \
+  /* Searches of a regexp before it is JIT compiled (0: never). */     \
+  F(constexpr, uint32_t, JITRegExpThreshold, 32)                       \
+                                                                       \
   /* Increase compliance with test262 (stricter checks at runtime). */ \
   F(constexpr, bool, Test262, false)                                   \
   /* RUNTIME_FIELDS END */
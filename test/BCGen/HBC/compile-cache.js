@@ -0,0 +1,39 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: rm -rf %t.cache
+// RUN: %hermesc -O -emit-binary -compile-cache=%t.cache -out %t.1.hbc %s
+// RUN: test $(ls %t.cache | wc -l) -eq 1
+// RUN: %hermesc -O -j2 -emit-binary -compile-cache=%t.cache -out %t.2.hbc %s
+// RUN: test $(ls %t.cache | wc -l) -eq 1
+// RUN: cmp %t.1.hbc %t.2.hbc
+// RUN: %hermesc -O0 -emit-binary -compile-cache=%t.cache -out %t.3.hbc %s
+// RUN: test $(ls %t.cache | wc -l) -eq 2
+// RUN: %hermes %t.2.hbc | %FileCheck --match-full-lines %s
+
+// Editing a global definitions file named on the command line adds an entry.
+// RUN: echo 'var a;' > %t.globals.js
+// RUN: %hermesc -O -emit-binary -compile-cache=%t.cache -include-globals=%t.globals.js -out %t.4.hbc %s
+// RUN: test $(ls %t.cache | wc -l) -eq 3
+// RUN: echo 'var b;' > %t.globals.js
+// RUN: %hermesc -O -emit-binary -compile-cache=%t.cache -include-globals=%t.globals.js -out %t.5.hbc %s
+// RUN: test $(ls %t.cache | wc -l) -eq 4
+
+// A hit is written out as stored, without compiling the input again.
+// RUN: for f in %t.cache/*; do echo 'from the cache' > $f; done
+// RUN: %hermesc -O -emit-binary -compile-cache=%t.cache -out %t.6.hbc %s
+// RUN: %FileCheck --check-prefix=CACHED --input-file=%t.6.hbc %s
+// CACHED: from the cache
+
+// The output file name and thread count do not affect the cache key, other
+// options and the files they name do.
+
+function fib(n) {
+  return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+print(fib(10));
+// CHECK: 55
@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -dump-bytecode %s > %t.1.txt
+// RUN: %hermesc -O -j4 -dump-bytecode %s > %t.4.txt
+// RUN: diff %t.1.txt %t.4.txt
+// RUN: %hermesc -O0 -g -dump-bytecode %s > %t.1.txt
+// RUN: %hermesc -O0 -g -j3 -dump-bytecode %s > %t.3.txt
+// RUN: diff %t.1.txt %t.3.txt
+
+// Compiling on several threads must produce the same bytecode as compiling on
+// one thread.
+
+function makeCounter(start) {
+  var count = start;
+  return {
+    next: function () { return ++count; },
+    reset: function () { count = start; },
+  };
+}
+
+function sum(arr) {
+  var total = 0;
+  for (var i = 0; i < arr.length; ++i) total += arr[i];
+  return total;
+}
+
+function classify(x) {
+  switch (x) {
+    case 1: return 'one';
+    case 2: return 'two';
+    case 'three': return 3;
+    default: return /re+gex/g.test(String(x)) ? 'match' : 'other';
+  }
+}
+
+function* range(n) {
+  for (var i = 0; i < n; ++i) yield i;
+}
+
+async function later(v) {
+  return (await v) + 1n;
+}
+
+class Point {
+  #x;
+  constructor(x, y) { this.#x = x; this.y = y; }
+  get x() { return this.#x; }
+  static origin() { return new Point(0, 0); }
+}
+
+var c = makeCounter(10);
+print(c.next(), sum([1, 2, 3]), classify(4), [...range(3)], Point.origin().x);
+later(41n);
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %shermes -exec %s | %FileCheck --match-full-lines %s
+
+print("Atomics");
+// CHECK-LABEL: Atomics
+print(Object.prototype.toString.call(Atomics));
+// CHECK-NEXT: [object Atomics]
+
+var ia = new Int32Array(new SharedArrayBuffer(16));
+print(Atomics.store(ia, 0, 5.7), Atomics.load(ia, 0));
+// CHECK-NEXT: 5 5
+print(Atomics.add(ia, 0, 3), Atomics.load(ia, 0));
+// CHECK-NEXT: 5 8
+print(Atomics.sub(ia, 0, 10), Atomics.load(ia, 0));
+// CHECK-NEXT: 8 -2
+print(Atomics.and(ia, 0, 6), Atomics.load(ia, 0));
+// CHECK-NEXT: -2 6
+print(Atomics.or(ia, 0, 9), Atomics.load(ia, 0));
+// CHECK-NEXT: 6 15
+print(Atomics.xor(ia, 0, 5), Atomics.load(ia, 0));
+// CHECK-NEXT: 15 10
+print(Atomics.exchange(ia, 0, 42), Atomics.load(ia, 0));
+// CHECK-NEXT: 10 42
+print(Atomics.compareExchange(ia, 0, 1, 2), Atomics.load(ia, 0));
+// CHECK-NEXT: 42 42
+print(Atomics.compareExchange(ia, 0, 42, 2), Atomics.load(ia, 0));
+// CHECK-NEXT: 42 2
+
+// Values wrap around like TypedArray stores.
+var u8 = new Uint8Array(new SharedArrayBuffer(4));
+print(Atomics.add(u8, 1, 300), Atomics.sub(u8, 1, 50), u8[1]);
+// CHECK-NEXT: 0 44 250
+
+// BigInt arrays take and return BigInts.
+var big = new BigInt64Array(new SharedArrayBuffer(16));
+print(Atomics.store(big, 1, -3n), Atomics.add(big, 1, 1n), big[1]);
+// CHECK-NEXT: -3 -3 -2
+try {
+  Atomics.add(big, 0, 1);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+
+// Atomics also work on non-shared buffers.
+var plain = new Uint16Array(4);
+print(Atomics.add(plain, 3, 7), plain[3]);
+// CHECK-NEXT: 0 7
+
+print(
+  Atomics.isLockFree(1),
+  Atomics.isLockFree(2),
+  Atomics.isLockFree(4),
+  Atomics.isLockFree(8),
+  Atomics.isLockFree(3)
+);
+// CHECK-NEXT: true true true true false
+
+// Invalid arrays and indices.
+function printError(f) {
+  try {
+    f();
+  } catch (e) {
+    print(e.name);
+  }
+}
+printError(() => Atomics.load(new Float64Array(4), 0));
+// CHECK-NEXT: TypeError
+printError(() => Atomics.load(new Uint8ClampedArray(4), 0));
+// CHECK-NEXT: TypeError
+printError(() => Atomics.load([1, 2], 0));
+// CHECK-NEXT: TypeError
+printError(() => Atomics.load(ia, 4));
+// CHECK-NEXT: RangeError
+printError(() => Atomics.wait(new Int32Array(4), 0, 0, 0));
+// CHECK-NEXT: TypeError
+printError(() => Atomics.wait(new Int16Array(new SharedArrayBuffer(4)), 0, 0));
+// CHECK-NEXT: TypeError
+
+// The main runtime cannot block, even if the value doesn't match.
+printError(() => Atomics.wait(ia, 1, 1, 0));
+// CHECK-NEXT: TypeError
+printError(() => Atomics.wait(big, 0, 0n, 0));
+// CHECK-NEXT: TypeError
+
+// notify() without waiters.
+print(Atomics.notify(ia, 1), Atomics.notify(new Int32Array(4), 0, 1));
+// CHECK-NEXT: 0 0
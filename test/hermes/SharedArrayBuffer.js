@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -Xhermes-internal-test-methods %s | %FileCheck --match-full-lines %s
+// RUN: %shermes -exec %s -Wx,-Xhermes-internal-test-methods | %FileCheck --match-full-lines %s
+
+print("SharedArrayBuffer");
+// CHECK-LABEL: SharedArrayBuffer
+
+var sab = new SharedArrayBuffer(16);
+print(sab, sab.byteLength);
+// CHECK-NEXT: [object SharedArrayBuffer] 16
+print(Object.getPrototypeOf(sab) === SharedArrayBuffer.prototype);
+// CHECK-NEXT: true
+print(sab instanceof ArrayBuffer);
+// CHECK-NEXT: false
+
+// The block is zeroed, and views over it see each other's writes.
+var i32 = new Int32Array(sab);
+var u8 = new Uint8Array(sab);
+print(i32.length, i32[3]);
+// CHECK-NEXT: 4 0
+i32[0] = 0x01020304;
+print(u8[0] + u8[1] + u8[2] + u8[3]);
+// CHECK-NEXT: 10
+print(i32.buffer === sab, ArrayBuffer.isView(i32));
+// CHECK-NEXT: true true
+
+// slice() copies into a new SharedArrayBuffer.
+var sliced = sab.slice(0, 8);
+print(sliced, sliced.byteLength);
+// CHECK-NEXT: [object SharedArrayBuffer] 8
+new Int32Array(sliced)[0] = 7;
+print(new Int32Array(sliced)[0], i32[0] === 0x01020304);
+// CHECK-NEXT: 7 true
+print(new SharedArrayBuffer(0).byteLength);
+// CHECK-NEXT: 0
+
+// ArrayBuffer and SharedArrayBuffer methods do not accept each other.
+try {
+  ArrayBuffer.prototype.slice.call(sab, 0);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+try {
+  Object.getOwnPropertyDescriptor(SharedArrayBuffer.prototype, "byteLength")
+    .get.call(new ArrayBuffer(4));
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+try {
+  SharedArrayBuffer(4);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+
+// SharedArrayBuffers can never be detached.
+try {
+  HermesInternal.detachArrayBuffer(sab);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+print(sab.byteLength);
+// CHECK-NEXT: 16
+
+// Typed arrays over shared buffers are sorted like any other.
+var sortedShared = new Float64Array(new SharedArrayBuffer(8 * 6));
+sortedShared.set([3, -0, NaN, -Infinity, 0, 1.5]);
+sortedShared.sort();
+print(Array.from(sortedShared, (x) => (Object.is(x, -0) ? '-0' : x)).join());
+// CHECK-NEXT: -Infinity,-0,0,1.5,3,NaN
+var sharedInts = new Int16Array(new SharedArrayBuffer(2 * 100));
+for (var i = 0; i < 100; ++i) sharedInts[i] = ((i * 37) % 100) - 50;
+sharedInts.sort();
+print(sharedInts[0], sharedInts[1], sharedInts[50], sharedInts[99]);
+// CHECK-NEXT: -50 -49 0 49
+sharedInts.sort();
+print(sharedInts[0], sharedInts[99]);
+// CHECK-NEXT: -50 49
@@ -1234,6 +1234,60 @@ cons.forEach(function(ta) {
   assert.equal(b[5], NaN);
 })();
 
+// The default order must match sorting with an explicit comparator, for
+// arrays long enough to be sorted by buckets.
+(function defaultSortMatchesComparator() {
+  function compareNumbers(a, b) {
+    if (a !== a)
+      return b !== b ? 0 : 1;
+    if (b !== b)
+      return -1;
+    if (a === 0 && b === 0)
+      return (1 / a > 0) - (1 / b > 0);
+    return a < b ? -1 : a > b ? 1 : 0;
+  }
+  var seed = 1;
+  function random() {
+    seed = (seed * 1103515245 + 12345) % 2147483648;
+    return seed;
+  }
+  var specials = [NaN, -0, 0, Infinity, -Infinity, 1.5, -1.5];
+  [Int8Array, Uint8Array, Uint8ClampedArray, Int16Array, Uint16Array,
+   Int32Array, Uint32Array, Float32Array, Float64Array].forEach(function(cons) {
+    [0, 1, 31, 33, 300, 5000].forEach(function(len) {
+      var a = new cons(len);
+      var bytes = new Uint8Array(a.buffer);
+      for (var i = 0; i < bytes.length; ++i)
+        bytes[i] = random() >> 8;
+      for (var i = 0; i < len; i += 7)
+        a[i] = specials[random() % specials.length];
+      var expected = Array.from(a).sort(compareNumbers);
+      a.sort();
+      for (var i = 0; i < len; ++i) {
+        assert.equal(Object.is(a[i], expected[i]) || (a[i] !== a[i] &&
+            expected[i] !== expected[i]), true, cons.name + ' ' + len);
+      }
+      // Sorting sorted and reversed input.
+      a.sort();
+      assert.arrayEqual(a, expected);
+      a.reverse().sort();
+      assert.arrayEqual(a, expected);
+    });
+  });
+
+  [BigInt64Array, BigUint64Array].forEach(function(cons) {
+    var a = new cons(1000);
+    var words = new Uint32Array(a.buffer);
+    for (var i = 0; i < words.length; ++i)
+      words[i] = random() * 2;
+    var expected = Array.from(a).sort(function(x, y) {
+      return x < y ? -1 : x > y ? 1 : 0;
+    });
+    a.sort();
+    assert.arrayEqual(a, expected);
+  });
+})();
+
 /// @}
 
 /// @name TypedArray.prototype.set
@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes %s | %FileCheck --match-full-lines %s
+
+"use strict";
+
+// Searches and sorts in arrays whose elements change between ints, doubles,
+// other values and holes.
+
+print('numbers');
+// CHECK-LABEL: numbers
+var a = [];
+a.push(1, 2.5, 3);
+print(a.indexOf("1"), a.indexOf(2.5), a.lastIndexOf(3), a.lastIndexOf(null));
+// CHECK-NEXT: -1 1 2 -1
+print(a.includes(undefined), a.includes(1), a.includes("3"));
+// CHECK-NEXT: false true false
+
+print('generalized');
+// CHECK-LABEL: generalized
+a.push("x");
+print(a.indexOf("x"), a.includes("x"), a.lastIndexOf("x"));
+// CHECK-NEXT: 3 true 3
+a.pop();
+a[1] = undefined;
+print(a.indexOf(undefined), a.includes(undefined));
+// CHECK-NEXT: 1 true
+
+print('holes');
+// CHECK-LABEL: holes
+var b = [];
+b.push(0, 1, 2);
+b.pop();
+b[3] = 3;
+print(b.includes(undefined), b.indexOf(undefined), b.indexOf(3));
+// CHECK-NEXT: true -1 3
+b.reverse();
+print(b.includes(undefined), b.indexOf(0), b.indexOf("0"));
+// CHECK-NEXT: true 3 -1
+
+print('sort');
+// CHECK-LABEL: sort
+var c = [];
+c.push(10, 9, -1, 100, 2);
+c.sort();
+print(c);
+// CHECK-NEXT: -1,10,100,2,9
+c.push(0.5, -0);
+c.sort();
+print(c, 1 / c[1]);
+// CHECK-NEXT: -1,0,0.5,10,100,2,9 -Infinity
+c.push("a", "-2");
+c.sort();
+print(c);
+// CHECK-NEXT: -1,-2,0,0.5,10,100,2,9,a
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes %s | %FileCheck --match-full-lines %s
+
+"use strict";
+
+// The default order compares the string representations of the elements.
+
+print('numbers');
+// CHECK-LABEL: numbers
+var ints = [];
+ints.push(10, 9, -1, 100, 0, -20, 2147483647, -2147483648, 1, 10);
+print(ints.sort().join());
+// CHECK-NEXT: -1,-20,-2147483648,0,1,10,10,100,2147483647,9
+var nums = [];
+nums.push(0.5, -0, 1e21, NaN, Infinity, -Infinity, 3, 2.25, 0, 1e-7);
+print(nums.sort().map(String).join());
+// CHECK-NEXT: -Infinity,0,0,0.5,1e+21,1e-7,2.25,3,Infinity,NaN
+print(1 / nums[1], 1 / nums[2]);
+// CHECK-NEXT: -Infinity Infinity
+print([3, 1, 2].toSorted().join(), [3, 1, 2].toSorted((a, b) => b - a).join());
+// CHECK-NEXT: 1,2,3 3,2,1
+
+print('strings');
+// CHECK-LABEL: strings
+var strs = ['b', 'a', '￿', '😀', 'ab', '', 'B', 'a'];
+print(JSON.stringify(strs.sort()));
+// CHECK-NEXT: ["","B","a","a","ab","b","😀","￿"]
+
+print('mixed');
+// CHECK-LABEL: mixed
+var mixed = [3, 'b', undefined, 1, , 'a', 20];
+mixed.sort();
+print(mixed.length, 4 in mixed, 5 in mixed, 6 in mixed, mixed.join());
+// CHECK-NEXT: 7 true true false 1,20,3,a,b,,
+
+print('stable');
+// CHECK-LABEL: stable
+var records = [];
+for (var i = 0; i < 100; ++i)
+  records.push({key: (i * 7) % 5, id: i});
+records.sort((a, b) => a.key - b.key);
+var ok = true;
+for (var i = 1; i < records.length; ++i) {
+  var p = records[i - 1], c = records[i];
+  if (p.key > c.key || (p.key === c.key && p.id > c.id))
+    ok = false;
+}
+print(ok);
+// CHECK-NEXT: true
+
+print('runs');
+// CHECK-LABEL: runs
+var calls = 0;
+var sorted = [];
+for (var i = 0; i < 1000; ++i)
+  sorted.push(i);
+sorted.sort((a, b) => (++calls, a - b));
+print(calls);
+// CHECK-NEXT: 999
+calls = 0;
+sorted.reverse().sort((a, b) => (++calls, a - b));
+print(calls, sorted[0], sorted[999]);
+// CHECK-NEXT: 999 0 999
@@ -108,3 +108,9 @@ print(f16neg[0] === 1);
 f16neg[0] = 1.00146484375;
 print(f16neg[0] === 1.001953125);
 // CHECK-NEXT: true
+
+// Sorting without a comparator orders -0 before +0 and NaN last.
+var f16sort = new Float16Array([NaN, 2, -0, 65504, 0, -Infinity, 0.5, -2]);
+f16sort.sort();
+print(Array.from(f16sort).map(x => Object.is(x, -0) ? '-0' : x).join());
+// CHECK-NEXT: -Infinity,-2,-0,0,0.5,2,65504,NaN
@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %shermes -exec %s | %FileCheck --match-full-lines %s
+
+// Stringify outputs that are large enough to be buffered in several pieces,
+// with properties that are rolled back because their value has no JSON
+// representation, and with exceptions thrown halfway through the output.
+
+print('json-stringify-rollback');
+// CHECK-LABEL: json-stringify-rollback
+
+// A reference serializer for the plain values used below.
+function quote(s) {
+  return '"' + s.replace(/["\\]/g, '\\$&') + '"';
+}
+function ref(v, replacer, holder, key) {
+  if (v !== null && typeof v === 'object' && typeof v.toJSON === 'function')
+    v = v.toJSON(key);
+  if (replacer)
+    v = replacer.call(holder, key, v);
+  if (v === null) return 'null';
+  switch (typeof v) {
+    case 'boolean':
+    case 'number':
+      return String(v);
+    case 'string':
+      return quote(v);
+    case 'object':
+      break;
+    default:
+      return undefined;
+  }
+  var parts = [];
+  if (Array.isArray(v)) {
+    for (var i = 0; i < v.length; ++i) {
+      var s = ref(v[i], replacer, v, String(i));
+      parts.push(s === undefined ? 'null' : s);
+    }
+    return '[' + parts.join(',') + ']';
+  }
+  for (var k of Object.keys(v)) {
+    var s = ref(v[k], replacer, v, k);
+    if (s !== undefined) parts.push(quote(k) + ':' + s);
+  }
+  return '{' + parts.join(',') + '}';
+}
+
+function makeRecords(n) {
+  var records = [];
+  for (var i = 0; i < n; ++i) {
+    records.push({
+      id: i,
+      name: 'n' + i + '\u00e9\u{1f600}',
+      skip: undefined,
+      fn: function () {},
+      nested: {deep: [i, null, true, undefined], empty: {}},
+    });
+  }
+  return records;
+}
+
+var records = makeRecords(5000);
+var expected = ref(records, undefined, {'': records}, '');
+var out = JSON.stringify(records);
+print(out.length, out === expected);
+// CHECK-NEXT: 401671 true
+
+// Values that become undefined are rolled back all through the output.
+function dropOdd(key, value) {
+  return key === 'name' && this.id % 2 ? undefined : value;
+}
+out = JSON.stringify(records, dropOdd);
+print(out.length, out === ref(records, dropOdd, {'': records}, ''));
+// CHECK-NEXT: 357226 true
+
+// A toJSON that throws in the middle of the output.
+records[3000].toJSON = function () {
+  throw new Error('toJSON of ' + this.id);
+};
+try {
+  JSON.stringify(records);
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: toJSON of 3000
+delete records[3000].toJSON;
+
+// A replacer that throws in the middle of the output, after many properties
+// have been rolled back.
+try {
+  JSON.stringify(records, function (key, value) {
+    if (key === 'deep' && this === records[4000].nested)
+      throw new Error('replacer at ' + key);
+    return dropOdd.call(this, key, value);
+  });
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: replacer at deep
+
+// An exception deep inside nested arrays unwinds every level.
+var deep = ['bottom'];
+for (var i = 0; i < 500; ++i) deep = [i, deep, {x: undefined}];
+var bottom = deep;
+for (var i = 0; i < 500; ++i) bottom = bottom[1];
+bottom.toJSON = function () {
+  throw new Error('bottom');
+};
+try {
+  JSON.stringify(deep);
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: bottom
+delete bottom.toJSON;
+out = JSON.stringify(deep);
+print(out.length, out === ref(deep, undefined, {'': deep}, ''));
+// CHECK-NEXT: 4400 true
+
+// Later calls are not affected by the aborted ones.
+out = JSON.stringify(records);
+print(out === expected);
+// CHECK-NEXT: true
+out = JSON.stringify(records, null, 2);
+print(JSON.stringify(JSON.parse(out)) === expected);
+// CHECK-NEXT: true
@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// REQUIRES: property_cache_stats
+
+// Every GetById/PutById cache entry reports its monomorphic, polymorphic and
+// megamorphic hits and its misses.
+
+function site(prefix) {
+  var sites = HermesInternal.getInstrumentedStats().js_propCacheSites;
+  for (var key in sites) {
+    if (key.startsWith(prefix + ' #')) {
+      var s = sites[key];
+      return [s.monoHits, s.polyHits, s.megaHits, s.misses].join(' ');
+    }
+  }
+  return 'not found';
+}
+
+print('mono');
+// CHECK-LABEL: mono
+function getMono(o) {
+  return o.monoProp;
+}
+var mono = {monoProp: 1};
+for (var i = 0; i < 100; ++i)
+  getMono(mono);
+print(site('get monoProp'));
+// CHECK-NEXT: 99 0 0 1
+
+print('poly');
+// CHECK-LABEL: poly
+function getPoly(o) {
+  return o.polyProp;
+}
+var poly = [{polyProp: 1}, {polyProp: 1, a: 2}, {polyProp: 1, b: 2}];
+for (var i = 0; i < 90; ++i)
+  getPoly(poly[i % 3]);
+print(site('get polyProp'));
+// CHECK-NEXT: 29 58 0 3
+
+print('mega');
+// CHECK-LABEL: mega
+function getMega(o) {
+  return o.megaProp;
+}
+var mega = [];
+for (var i = 0; i < 8; ++i) {
+  var o = {megaProp: 1};
+  o['p' + i] = i;
+  mega.push(o);
+}
+for (var i = 0; i < 80; ++i)
+  getMega(mega[i % 8]);
+var megaCounts = site('get megaProp').split(' ');
+print(megaCounts[0] > 0, megaCounts[2] > 0);
+// CHECK-NEXT: true true
+
+print('put');
+// CHECK-LABEL: put
+function putMono(o, v) {
+  o.putProp = v;
+}
+var target = {putProp: 0};
+for (var i = 0; i < 100; ++i)
+  putMono(target, i);
+print(site('put putProp'));
+// CHECK-NEXT: 99 0 0 1
+
+print('total');
+// CHECK-LABEL: total
+var monoHits = HermesInternal.getInstrumentedStats().js_propCacheMonoHits;
+print(monoHits >= 99 + 29 + 99);
+// CHECK-NEXT: true
@@ -0,0 +1,26 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -Xregexp-linear-time %s | %FileCheck --match-full-lines %s
+
+// These patterns backtrack exponentially, but are searched in linear time.
+var input = 'a'.repeat(10000);
+print(/(a|a)*b/.test(input));
+// CHECK: false
+print(/^(a+)+$/.test(input + '!'));
+// CHECK-NEXT: false
+print(/(x+x+)+y/.exec('x'.repeat(5000)));
+// CHECK-NEXT: null
+var m = /^(\w+\s?)*$/.exec('lorem ipsum dolor sit amet');
+print(m[0], '|' + m[1] + '|');
+// CHECK-NEXT: lorem ipsum dolor sit amet |amet|
+
+// Patterns with backreferences and lookarounds still backtrack.
+print(/(a+)\1b/.exec('aaaab'));
+// CHECK-NEXT: aaaab,aa
+print('foo1 bar2'.replace(/\w+(?=\d)/g, '<$&>'));
+// CHECK-NEXT: <foo>1 <bar>2
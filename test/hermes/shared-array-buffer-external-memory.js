@@ -0,0 +1,41 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// The data block of a SharedArrayBuffer lives outside of the GC heap, but it
+// must still be accounted for as external memory, so that allocating many of
+// them triggers collections.
+
+function stats() {
+  return HermesInternal.getInstrumentedStats();
+}
+
+var SIZE = 16 << 20;
+
+print('credit');
+// CHECK-LABEL: credit
+var sab = new SharedArrayBuffer(SIZE);
+print(stats().js_externalBytes >= SIZE);
+// CHECK-NEXT: true
+print(sab.slice(0, SIZE / 2).byteLength);
+// CHECK-NEXT: 8388608
+
+print('collect');
+// CHECK-LABEL: collect
+var numGCs = stats().js_numGCs;
+for (var i = 0; i < 64; ++i)
+  new SharedArrayBuffer(SIZE);
+print(stats().js_numGCs > numGCs);
+// CHECK-NEXT: true
+
+print('debit');
+// CHECK-LABEL: debit
+sab = null;
+gc();
+print(stats().js_externalBytes < SIZE);
+// CHECK-NEXT: true
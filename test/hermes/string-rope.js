@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -gc-sanitize-handles=1 %s | %FileCheck --match-full-lines %s
+// Check concatenations that create ropes: prepending, interleaved builders and
+// trees of concatenations.
+
+print('rope');
+// CHECK-LABEL: rope
+
+// Prepend many fragments.
+var s = '';
+for (var i = 0; i < 3000; ++i) {
+  s = '<' + (i % 10) + '>' + s;
+}
+print(s.length, s.slice(0, 9), s.slice(-6), s.charAt(4), s.charCodeAt(1));
+// CHECK-NEXT: 9000 <9><8><7> <1><0> 8 57
+
+// Interleaved builders append to the middle of a concatenation chain.
+var base = 'x'.repeat(300);
+var a = base, b = base;
+for (var i = 0; i < 1000; ++i) {
+  a = a + 'a' + i;
+  b = b + 'b' + i;
+}
+print(a.length, b.length, a.slice(300, 306), b.slice(-4));
+// CHECK-NEXT: 4190 4190 a0a1a2 b999
+print(a.indexOf('a999'), b.lastIndexOf('b0'));
+// CHECK-NEXT: 4186 300
+
+// Wrapping a string on both sides, as in template rendering.
+var html = 'y'.repeat(256);
+for (var i = 0; i < 2000; ++i) {
+  html = `<div id="${i}">${html}</div>`;
+}
+print(html.length, html.slice(0, 16), html.slice(-12));
+// CHECK-NEXT: 41146 <div id="1999">< </div></div>
+
+// Trees of concatenations, mixing ASCII and UTF-16.
+var leafCount = 0;
+function tree(depth) {
+  if (depth === 0)
+    return (leafCount++ % 2 ? 'leaf-' : 'l\u00e9af-').repeat(20);
+  return tree(depth - 1) + '|' + tree(depth - 1);
+}
+var t = tree(8);
+print(t.length, t.charAt(1), t.charAt(2), t.indexOf('|'), t.split('|').length);
+// CHECK-NEXT: 25855 é a 100 256
+
+// Ropes compare, hash and convert like flat strings.
+var p1 = 'k'.repeat(200) + 'z'.repeat(200);
+var p2 = 'k'.repeat(100) + ('k'.repeat(100) + 'z'.repeat(200));
+var obj = {};
+obj[p1] = 1;
+print(p1 === p2, obj[p2], p1 < p2 + 'a', new Set([p1, p2]).size);
+// CHECK-NEXT: true 1 true 1
+print(JSON.stringify(['"' + 'q'.repeat(300)]).length);
+// CHECK-NEXT: 306
+print(
+  /k+z{200}$/.test(p2),
+  p2.replace(/z+/, '!').length,
+  Number('1' + '0'.repeat(300)) > 1e299,
+);
+// CHECK-NEXT: true 201 true
+
+// Ropes survive garbage collection, both before and after being flattened.
+var keep = [];
+for (var i = 0; i < 20; ++i) {
+  keep.push(String(i) + 'r'.repeat(300));
+  keep[i] = '>' + keep[i];
+}
+if (typeof gc === 'function') gc();
+var total = 0;
+for (var i = 0; i < keep.length; ++i) total += keep[i].length;
+print(total, keep[19].slice(0, 4));
+// CHECK-NEXT: 6050 >19r
+if (typeof gc === 'function') gc();
+print(keep[5].charAt(1), keep[19] === '>19' + 'r'.repeat(300));
+// CHECK-NEXT: 5 true
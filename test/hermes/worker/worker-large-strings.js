@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -gc-sanitize-handles=1 %s | %FileCheck %s --match-full-lines
+// RUN: %shermes -exec -Wx,-gc-sanitize-handles=1 %s | %FileCheck %s --match-full-lines
+
+// Test that strings long enough to be shared between runtimes by postMessage
+// arrive intact in the worker and back, whether or not they were external
+// strings to begin with.
+
+var N = 100000;
+var ascii = 'x'.repeat(N);
+var utf16 = '\u2603'.repeat(N);
+var strings = {
+  // External strings, whose buffers are shared as they are.
+  ascii: ascii,
+  utf16: utf16,
+  // Strings built by concatenation, which are copied once.
+  asciiAppend: ascii + 'y',
+  asciiPrepend: 'y' + ascii,
+  utf16Append: utf16 + 'z',
+  mixed: ascii + utf16,
+  // The same string again.
+  again: ascii,
+};
+
+var worker = new Worker(`
+  var N = 100000;
+  var expected = {
+    ascii: 'x'.repeat(N),
+    utf16: '\\u2603'.repeat(N),
+    asciiAppend: 'x'.repeat(N) + 'y',
+    asciiPrepend: 'y' + 'x'.repeat(N),
+    utf16Append: '\\u2603'.repeat(N) + 'z',
+    mixed: 'x'.repeat(N) + '\\u2603'.repeat(N),
+    again: 'x'.repeat(N),
+  };
+  onmessage = function(msg) {
+    var checks = [];
+    for (var key in expected) {
+      var s = msg[key];
+      checks.push(key + ': ' + s.length + ' ' + (s === expected[key]));
+    }
+    postMessage({checks: checks, strings: msg});
+  }
+`);
+
+worker.onmessage = function(msg) {
+  print('worker');
+  for (var check of msg.checks)
+    print(check);
+  print('main');
+  for (var key in strings) {
+    var s = msg.strings[key];
+    print(key + ': ' + s.length + ' ' + (s === strings[key]));
+  }
+  worker.terminate();
+};
+worker.postMessage(strings);
+// The strings that were sent are unaffected.
+print('sent: ' + ascii.length + ' ' + utf16.charCodeAt(N - 1).toString(16));
+
+// CHECK: sent: 100000 2603
+// CHECK-NEXT: worker
+// CHECK-NEXT: ascii: 100000 true
+// CHECK-NEXT: utf16: 100000 true
+// CHECK-NEXT: asciiAppend: 100001 true
+// CHECK-NEXT: asciiPrepend: 100001 true
+// CHECK-NEXT: utf16Append: 100001 true
+// CHECK-NEXT: mixed: 200000 true
+// CHECK-NEXT: again: 100000 true
+// CHECK-NEXT: main
+// CHECK-NEXT: ascii: 100000 true
+// CHECK-NEXT: utf16: 100000 true
+// CHECK-NEXT: asciiAppend: 100001 true
+// CHECK-NEXT: asciiPrepend: 100001 true
+// CHECK-NEXT: utf16Append: 100001 true
+// CHECK-NEXT: mixed: 200000 true
+// CHECK-NEXT: again: 100000 true
@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -gc-sanitize-handles=1 %s | %FileCheck %s --match-full-lines
+// RUN: %shermes -exec -Wx,-gc-sanitize-handles=1 %s | %FileCheck %s --match-full-lines
+
+// Test that a SharedArrayBuffer posted to a Worker shares its memory with the
+// main runtime, and that Atomics.wait/notify synchronize the two threads.
+// Only the worker may block in Atomics.wait.
+
+var ia = new Int32Array(new SharedArrayBuffer(16));
+ia[1] = 1;
+
+var worker = new Worker(`
+  onmessage = function(view) {
+    var big = new BigInt64Array(new SharedArrayBuffer(8));
+    postMessage("not equal: " + Atomics.wait(view, 1, 0, 0));
+    postMessage("timed out: " + Atomics.wait(view, 3, 0, 1));
+    postMessage("big timed out: " + Atomics.wait(big, 0, 0n, 1));
+    // Not a copy: the main runtime wrote ia[1] before posting.
+    Atomics.store(view, 2, Atomics.load(view, 1) + 41);
+    postMessage(view.buffer);
+    // Block until the main runtime has seen the update. It may notify before
+    // the wait starts, in which case view[0] is already 1.
+    var res = Atomics.wait(view, 0, 0, 10000);
+    postMessage("woken: " + (res === "ok" || res === "not-equal"));
+  }
+`);
+
+worker.onmessage = function(msg) {
+  if (typeof msg === "string") {
+    print(msg);
+    if (msg.startsWith("woken"))
+      worker.terminate();
+    return;
+  }
+  print("same memory:", new Int32Array(msg)[2] === ia[2]);
+  print("value:", Atomics.load(ia, 2));
+  Atomics.store(ia, 0, 1);
+  Atomics.notify(ia, 0);
+}
+worker.postMessage(ia);
+
+// CHECK: not equal: not-equal
+// CHECK-NEXT: timed out: timed-out
+// CHECK-NEXT: big timed out: timed-out
+// CHECK-NEXT: same memory: true
+// CHECK-NEXT: value: 42
+// CHECK-NEXT: woken: true
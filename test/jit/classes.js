@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -fno-inline -Xjit=force -Xjit-crash-on-error %s | %FileCheck --match-full-lines %s
+// REQUIRES: jit
+
+// Classes, private names and the other object operations that only appear in
+// newer code.
+
+print('classes');
+// CHECK-LABEL: classes
+
+class Base {
+  #secret;
+  static count = 0;
+  constructor(secret) {
+    this.#secret = secret;
+    ++Base.count;
+  }
+  get secret() {
+    return this.#secret;
+  }
+  #bump() {
+    return ++this.#secret;
+  }
+  bump() {
+    return this.#bump();
+  }
+  static hasSecret(o) {
+    return #secret in o;
+  }
+  describe() {
+    return 'base ' + this.#secret;
+  }
+}
+
+class Derived extends Base {
+  constructor(secret, extra) {
+    super(secret);
+    this.extra = extra;
+  }
+  describe() {
+    return super.describe() + ' derived ' + this.extra;
+  }
+  setViaSuper(v) {
+    super.extra = v;
+    return this.extra;
+  }
+}
+
+var d = new Derived(1, 'x');
+print(d.secret, d.bump(), d.secret);
+// CHECK-NEXT: 1 2 2
+print(d.describe());
+// CHECK-NEXT: base 2 derived x
+print(d.setViaSuper('y'));
+// CHECK-NEXT: y
+print(Base.hasSecret(d), Base.hasSecret({}));
+// CHECK-NEXT: true false
+print(Base.count);
+// CHECK-NEXT: 1
+
+// A derived constructor can't call super() twice.
+class Twice extends Base {
+  constructor() {
+    super(0);
+    try {
+      super(0);
+    } catch (e) {
+      print(e.name);
+    }
+  }
+}
+new Twice();
+// CHECK-NEXT: ReferenceError
+
+// Computed accessor names.
+var key = 'val';
+var acc = {
+  stored: 5,
+  get [key]() {
+    return this.stored;
+  },
+  set [key](v) {
+    this.stored = v * 2;
+  },
+};
+acc.val = 4;
+print(acc.val);
+// CHECK-NEXT: 8
+
+// Computed class keys go through ToPropertyKey.
+var n = 0;
+class Keys {
+  [++n]() {
+    return 'one';
+  }
+  [{toString() { return 'k' + ++n; }}]() {
+    return 'two';
+  }
+}
+print(new Keys()[1](), new Keys().k2());
+// CHECK-NEXT: one two
+
+// typeof comparisons.
+function kind(x) {
+  if (typeof x === 'number') return 'number';
+  if (typeof x === 'function') return 'function';
+  var isStr = typeof x === 'string';
+  return isStr ? 'string' : 'other';
+}
+print(kind(1), kind(kind), kind('s'), kind(null));
+// CHECK-NEXT: number function string other
+
+// for-in and delete by value.
+var obj = {a: 1, b: 2, c: 3};
+var del = 'b';
+delete obj[del];
+var keys = [];
+for (var k in obj) keys.push(k);
+print(keys.join());
+// CHECK-NEXT: a,c
+
+// Direct eval.
+var global = 40;
+function evaluate(code) {
+  return eval(code);
+}
+print(evaluate('global + 2'));
+// CHECK-NEXT: 42
+
+// Switch over a dense range of integers.
+function dense(x) {
+  switch (x) {
+    case 0: return 'zero';
+    case 1: return 'one';
+    case 2: return 'two';
+    case 3: return 'three';
+    case 4: return 'four';
+    case 5: return 'five';
+    default: return 'many';
+  }
+}
+print(dense(0), dense(3), dense(5), dense(6), dense(-1), dense(2.5));
+// CHECK-NEXT: zero three five many many many
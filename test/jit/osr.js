@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -fno-inline -Xjit=on -Xjit-osr-threshold=10 -Xjit-crash-on-error -Xdump-jitcode=2 %s | %FileCheck --match-full-lines %s
+// REQUIRES: jit, x86_64
+
+// Every function is called once, far below the call count threshold, so they
+// can only be compiled when a loop gets hot, and the interpreted call then
+// continues in the compiled code.
+
+// A single call with a hot loop.
+function hotLoop(n) {
+  var sum = 0;
+  for (var i = 0; i < n; ++i) sum += i;
+  return sum;
+}
+print('hotLoop', hotLoop(100));
+// CHECK: JIT successfully compiled FunctionID {{[0-9]+}}, 'hotLoop'
+// CHECK-NEXT: hotLoop 4950
+
+// The compiled code must handle exceptions thrown inside the loop it was
+// entered in.
+function loopInTry(n) {
+  var caught = 0;
+  var sum = 0;
+  for (var i = 0; i < n; ++i) {
+    try {
+      if (i % 20 === 19) throw i;
+      sum += i;
+    } catch (e) {
+      caught += e;
+    }
+  }
+  return sum + '/' + caught;
+}
+print('loopInTry', loopInTry(100));
+// CHECK: JIT successfully compiled FunctionID {{[0-9]+}}, 'loopInTry'
+// CHECK-NEXT: loopInTry 4655/295
+
+// The inner loop gets hot first, the outer loop continues in compiled code.
+function nested(n) {
+  var sum = 0;
+  for (var i = 0; i < n; ++i) {
+    for (var j = 0; j < n; ++j) sum += i * j;
+  }
+  return sum;
+}
+print('nested', nested(30));
+// CHECK: JIT successfully compiled FunctionID {{[0-9]+}}, 'nested'
+// CHECK-NEXT: nested 189225
+
+// An exception thrown by the compiled code after the switch must reach the
+// interpreted caller.
+function throwAfterLoop(n) {
+  var sum = 0;
+  for (var i = 0; i < n; ++i) sum += i;
+  throw new Error('sum ' + sum);
+}
+function callThrowAfterLoop() {
+  try {
+    throwAfterLoop(50);
+  } catch (e) {
+    return e.message;
+  }
+}
+print('throwAfterLoop', callThrowAfterLoop());
+// CHECK: JIT successfully compiled FunctionID {{[0-9]+}}, 'throwAfterLoop'
+// CHECK-NEXT: throwAfterLoop sum 1225
+
+// The values of the registers set by the interpreter before the switch,
+// including the parameters, must be visible to the compiled code.
+function frameValues(a, b) {
+  var str = 'str' + a;
+  var obj = {x: a};
+  var dbl = a / 4;
+  var undef;
+  var arr = [a, b];
+  var count = 0;
+  while (count < 50) {
+    ++count;
+    obj.x += 1;
+  }
+  return [a, b, str, obj.x, dbl, undef, arr.length, count].join(',');
+}
+print('frameValues', frameValues(3, 'b'));
+// CHECK: JIT successfully compiled FunctionID {{[0-9]+}}, 'frameValues'
+// CHECK-NEXT: frameValues 3,b,str3,53,0.75,,2,50
@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -Xjit -Xjit-regexp-threshold=3 -Xjit-crash-on-error -Xdump-jitcode=2 %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -Xjit -Xjit-regexp-threshold=1 -Xjit-crash-on-error %s | %FileCheck --match-full-lines --check-prefix=RESULT %s
+// REQUIRES: jit, x86_64
+
+// Regexps are compiled once their bytecode has been searched often enough,
+// even when the RegExp object is recreated for each search. The results must
+// not change once the compiled matchers take over.
+
+function run(name, source, flags, inputs) {
+  var results = [];
+  for (var i = 0; i < 4; ++i) {
+    results = [];
+    for (var input of inputs) {
+      var m = new RegExp(source, flags).exec(input);
+      results.push(m ? JSON.stringify(m) + '@' + m.index : 'null');
+    }
+  }
+  print(name, results.join(' '));
+}
+
+run('chars', 'abc', '', ['xxabcxx', 'abd', 'ab\u0100abc']);
+// CHECK: JIT successfully compiled RegExp with 0 capture groups
+// CHECK-NEXT: chars ["abc"]@2 null ["abc"]@3
+// RESULT: chars ["abc"]@2 null ["abc"]@3
+
+run('classes', '[a-c\\d]+\\s*[^x-z]', '', ['--b12 \t!', 'zz', 'a\u00a0\u2028q']);
+// CHECK: JIT successfully compiled RegExp with 0 capture groups
+// CHECK-NEXT: classes ["b12 \t!"]@2 null ["a{{.+}}q"]@0
+// RESULT: classes ["b12 \t!"]@2 null ["a{{.+}}q"]@0
+
+run('groups', '(\\w+)@(\\w+)\\.(com|org)?', '', ['mail me@host.org!', 'a@b.', 'x@']);
+// CHECK: JIT successfully compiled RegExp with 3 capture groups
+// CHECK-NEXT: groups ["me@host.org","me","host","org"]@5 ["a@b.","a","b",null]@0 null
+// RESULT: groups ["me@host.org","me","host","org"]@5 ["a@b.","a","b",null]@0 null
+
+run('anchors', '^\\d+$|^end', 'm', ['abc\n123\nx', 'x\nend', '12a']);
+// CHECK: JIT successfully compiled RegExp with 0 capture groups
+// CHECK-NEXT: anchors ["123"]@4 ["end"]@2 null
+// RESULT: anchors ["123"]@4 ["end"]@2 null
+
+run('boundary', '\\bfo+\\B.', '', ['afoo foox', 'fo', 'fooo!']);
+// CHECK: JIT successfully compiled RegExp with 0 capture groups
+// CHECK-NEXT: boundary ["foox"]@5 null ["fooo"]@0
+// RESULT: boundary ["foox"]@5 null ["fooo"]@0
+
+run('lazy', '<(.+?)>(.*?)</\\1>', '', ['<b>x<i>y</i></b>', '<a></b>', '<p>ok</p>']);
+// CHECK: JIT successfully compiled RegExp with 2 capture groups
+// CHECK-NEXT: lazy ["<b>x<i>y</i></b>","b","x<i>y</i>"]@0 null ["<p>ok</p>","p","ok"]@0
+// RESULT: lazy ["<b>x<i>y</i></b>","b","x<i>y</i>"]@0 null ["<p>ok</p>","p","ok"]@0
+
+run('loops', '(?:(a)|b){2,3}?c', '', ['ababc', 'bbc', 'ac']);
+// CHECK: JIT successfully compiled RegExp with 1 capture groups
+// CHECK-NEXT: loops ["babc",null]@1 ["bbc",null]@0 null
+// RESULT: loops ["babc",null]@1 ["bbc",null]@0 null
+
+run('empty', '(a*)*b', '', ['aaab', 'c', 'b']);
+// CHECK: JIT successfully compiled RegExp with 1 capture groups
+// CHECK-NEXT: empty ["aaab","aaa"]@0 null ["b",null]@0
+// RESULT: empty ["aaab","aaa"]@0 null ["b",null]@0
+
+// Case-insensitive regexps stay in the interpreter.
+run('icase', 'AbC', 'i', ['xabc']);
+// CHECK-NOT: JIT successfully compiled RegExp
+// CHECK: icase ["abc"]@1
+// RESULT: icase ["abc"]@1
+
+// The sticky and global flags restrict or move the start of the search.
+var re = /a\d/y;
+var sticky = [];
+for (var i = 0; i < 4; ++i) {
+  re.lastIndex = 0;
+  sticky.push(re.test('xa1'), re.test('a1'));
+}
+print('sticky', sticky.join());
+// CHECK: JIT successfully compiled RegExp with 0 capture groups
+// CHECK-NEXT: sticky false,true,false,true,false,true,false,true
+// RESULT: sticky false,true,false,true,false,true,false,true
+print('global', 'a1b22c333'.replace(/\d+/g, '#'), 'x-y-z'.split(/-/).join());
+// CHECK: global a#b#c# x,y,z
+// RESULT: global a#b#c# x,y,z
+
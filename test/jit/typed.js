@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -typed -fno-inline -Xjit=force -Xjit-crash-on-error %s | %FileCheck --match-full-lines %s
+// REQUIRES: jit
+
+// Instructions emitted only for typed code: fast arrays, typed objects and
+// classes with fixed slots.
+
+'use strict';
+
+(function () {
+
+print('typed');
+// CHECK-LABEL: typed
+
+function squares(n: number): number[] {
+  var arr: number[] = [];
+  for (var i = 0; i < n; ++i) arr.push(i * i);
+  return arr;
+}
+var sq: number[] = squares(5);
+print(sq.length, sq[4]);
+// CHECK-NEXT: 5 16
+
+function sum(arr: number[]): number {
+  var s = 0;
+  for (var i = 0; i < arr.length; ++i) s += arr[i];
+  return s;
+}
+print(sum(sq));
+// CHECK-NEXT: 30
+
+function store(arr: number[], i: number, v: number): void {
+  arr[i] = v;
+}
+store(sq, 0, 100);
+print(sq[0]);
+// CHECK-NEXT: 100
+try {
+  store(sq, 10, 1);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: RangeError
+try {
+  print(sq[10]);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: RangeError
+
+function concat(a: number[], b: number[]): number[] {
+  return [...a, ...b];
+}
+print(concat([1, 2], [3]).join());
+// CHECK-NEXT: 1,2,3
+
+class Point {
+  x: number;
+  y: number;
+  constructor(x: number, y: number) {
+    this.x = x;
+    this.y = y;
+  }
+  norm2(): number {
+    return this.x * this.x + this.y * this.y;
+  }
+}
+class Point3 extends Point {
+  z: number;
+  constructor(x: number, y: number, z: number) {
+    super(x, y);
+    this.z = z;
+  }
+  norm2(): number {
+    return super.norm2() + this.z * this.z;
+  }
+}
+var p: Point3 = new Point3(1, 2, 3);
+p.x = 2;
+print(p.norm2(), p.x, p.z);
+// CHECK-NEXT: 17 2 3
+
+type Pair = {first: number, second: string};
+function makePair(first: number, second: string): Pair {
+  return {first: first, second: second};
+}
+var pair: Pair = makePair(1, 'one');
+print(pair.first, pair.second);
+// CHECK-NEXT: 1 one
+
+function greet(name: string): string {
+  return 'hello ' + name;
+}
+print(greet('world'));
+// CHECK-NEXT: hello world
+
+})();
@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %shermes -c-shards=3 -exec %s | %FileCheck --match-full-lines %s
+// RUN: %shermes -j1 -c-shards=3 -exec %s | %FileCheck --match-full-lines %s
+// RUN: %shermes -c-shards=3 -emit-c -o %t.c %s
+// RUN: %FileCheck --check-prefix=CHKC --input-file=%t.c %s
+
+// The C is split into shards compiled separately, which call each other and
+// share the strings, property caches and function table of the unit.
+
+// CHKC: #define unit_index sh_this_unit_unit_index
+// CHKC: #if !defined(SHERMES_SHARD) || SHERMES_SHARD == 0
+// CHKC: #if !defined(SHERMES_SHARD) || SHERMES_SHARD == 1
+// CHKC: #if !defined(SHERMES_SHARD) || SHERMES_SHARD == 2
+// CHKC: #if !defined(SHERMES_SHARD) || SHERMES_SHARD == 0
+// CHKC: SH_SHARED uint32_t unit_index;
+// CHKC: SHUnit *CREATE_THIS_UNIT(void) {
+
+function point(x, y) {
+  return {x: x, y: y};
+}
+
+function add(p, q) {
+  return point(p.x + q.x, p.y + q.y);
+}
+
+function scale(p, k) {
+  return point(p.x * k, p.y * k);
+}
+
+function describe(p) {
+  return 'point(' + p.x + ', ' + p.y + ')';
+}
+
+function makeCounter() {
+  var count = 0;
+  return function () {
+    return ++count;
+  };
+}
+
+var counter = makeCounter();
+counter();
+print(describe(scale(add(point(1, 2), point(3, 4)), counter())));
+// CHECK: point(8, 12)
+print(/b+/.exec('abbbc')[0]);
+// CHECK: bbb
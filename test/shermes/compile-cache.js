@@ -0,0 +1,37 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: rm -rf %t.cache
+// RUN: %shermes -O -emit-c -compile-cache=%t.cache -o %t.1.c %s
+// RUN: test $(ls %t.cache | wc -l) -eq 1
+// RUN: %shermes -O -j2 -emit-c -compile-cache=%t.cache -o %t.2.c %s
+// RUN: test $(ls %t.cache | wc -l) -eq 1
+// RUN: cmp %t.1.c %t.2.c
+// RUN: %shermes -O0 -emit-c -compile-cache=%t.cache -o %t.3.c %s
+// RUN: test $(ls %t.cache | wc -l) -eq 2
+
+// Editing the input adds an entry.
+// RUN: cp %s %t.js
+// RUN: %shermes -O -emit-c -compile-cache=%t.cache -o %t.4.c %t.js
+// RUN: test $(ls %t.cache | wc -l) -eq 3
+// RUN: echo 'print(fib(11));' >> %t.js
+// RUN: %shermes -O -emit-c -compile-cache=%t.cache -o %t.5.c %t.js
+// RUN: test $(ls %t.cache | wc -l) -eq 4
+
+// A hit is served from the cache without generating the C again.
+// RUN: for f in %t.cache/*; do echo '/* from the cache */' > $f; done
+// RUN: %shermes -O -emit-c -compile-cache=%t.cache -o %t.6.c %s
+// RUN: %FileCheck --check-prefix=CACHED --input-file=%t.6.c %s
+// CACHED: /* from the cache */
+
+// The output file name and thread count do not affect the cache key, other
+// options and the input do.
+
+function fib(n) {
+  return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+print(fib(10));
@@ -0,0 +1,42 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %shermes -O -emit-c -o %t.1.c %s
+// RUN: %shermes -O -j4 -emit-c -o %t.4.c %s
+// RUN: diff %t.1.c %t.4.c
+
+// Compiling on several threads must produce the same C as compiling on one
+// thread.
+
+function makeCounter(start) {
+  var count = start;
+  return {
+    next: function () { return ++count; },
+    reset: function () { count = start; },
+  };
+}
+
+function sum(arr) {
+  var total = 0;
+  for (var i = 0; i < arr.length; ++i) total += arr[i];
+  return total;
+}
+
+function classify(x) {
+  switch (x) {
+    case 1: return 'one';
+    case 2: return 'two';
+    default: return x.name + x.value;
+  }
+}
+
+function* range(n) {
+  for (var i = 0; i < n; ++i) yield i;
+}
+
+var c = makeCounter(10);
+print(c.next(), sum([1, 2, 3]), classify({name: 'a', value: 1}), [...range(3)]);
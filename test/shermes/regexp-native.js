@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %shermes -exec %s | %FileCheck --match-full-lines %s
+
+// Regexp literals are searched with matchers generated by the compiler, which
+// must agree with the regex interpreter.
+
+function show(m) {
+  if (!m) return 'null';
+  return JSON.stringify(Array.from(m)) + '@' + m.index;
+}
+
+print('exec');
+// CHECK-LABEL: exec
+print(show(/(\w+)@(\w+)\.com/.exec('mail foo@bar.com now')));
+// CHECK-NEXT: ["foo@bar.com","foo","bar"]@5
+print(show(/(a)|(b)/.exec('xxb')));
+// CHECK-NEXT: ["b",null,"b"]@2
+print(show(/(?:a|ab)(?:c|bcd)(d*)/.exec('abcd')));
+// CHECK-NEXT: ["abcd",""]@0
+print(show(/(z)((a+)?(b+)?(c))*/.exec('zaacbbbcac')));
+// CHECK-NEXT: ["zaacbbbcac","z","ac","a",null,"c"]@0
+print(show(/(a*)*b/.exec('aaab')));
+// CHECK-NEXT: ["aaab","aaa"]@0
+print(show(/(.)\1/.exec('abccd')));
+// CHECK-NEXT: ["cc","c"]@2
+print(show(/a{2,3}?b/.exec('aaaab')));
+// CHECK-NEXT: ["aaab"]@1
+print(/(?<word>[a-z]+)-\d+/.exec('id: abc-123').groups.word);
+// CHECK-NEXT: abc
+print(show(/x$/.exec('xy')));
+// CHECK-NEXT: null
+
+print('flags');
+// CHECK-LABEL: flags
+print(show(/^b$/m.exec('a\nb\nc')));
+// CHECK-NEXT: ["b"]@2
+print(show(/a.c/s.exec('a\nc')));
+// CHECK-NEXT: ["a\nc"]@0
+print(show(/a.c/.exec('a\nc')));
+// CHECK-NEXT: null
+var sticky = /o+/y;
+sticky.lastIndex = 1;
+print(show(sticky.exec('foo boo')), sticky.lastIndex);
+// CHECK-NEXT: ["oo"]@1 3
+print(show(sticky.exec('foo boo')), sticky.lastIndex);
+// CHECK-NEXT: null 0
+print('a1b22c333'.replace(/\d+/g, '#'));
+// CHECK-NEXT: a#b#c#
+print(JSON.stringify('one two  three'.split(/\s+/)));
+// CHECK-NEXT: ["one","two","three"]
+print(/\bis\b/.test('this is it'), /\Bis\b/.test('this'));
+// CHECK-NEXT: true true
+
+print('utf16');
+// CHECK-LABEL: utf16
+print(show(/[é-ü]+/.exec('café über')));
+// CHECK-NEXT: ["é"]@3
+var m = /\s(\S+)/.exec('a\u00a0b\u2028c');
+print(m.index, m[1].length);
+// CHECK-NEXT: 1 1
+print(show(/^c/m.exec('ab\u2028c')));
+// CHECK-NEXT: ["c"]@3
+print(show(/(\w+) (\w+)/.exec('né ab cd')));
+// CHECK-NEXT: ["ab cd","ab","cd"]@3
+
+print('interpreted');
+// CHECK-LABEL: interpreted
+// Case-insensitive and unicode regexps are searched by the interpreter.
+print(show(/ABC/i.exec('xabc')));
+// CHECK-NEXT: ["abc"]@1
+print(show(/./u.exec('😀')));
+// CHECK-NEXT: ["😀"]@0
+// A RegExp constructed from a literal shares its matcher.
+print(show(new RegExp(/(b+)/, 'g').exec('abbc')));
+// CHECK-NEXT: ["bb","bb"]@1
+print(show(new RegExp(/(b+)/, 'i').exec('aBBc')));
+// CHECK-NEXT: ["BB","BB"]@1
+
+print('budget');
+// CHECK-LABEL: budget
+// The matcher gives up on catastrophic backtracking, and the interpreter
+// continues the search from the position it was trying.
+print(show(/(a+)+b/.exec('xx' + 'a'.repeat(23) + 'c aab')));
+// CHECK-NEXT: ["aab","aa"]@27
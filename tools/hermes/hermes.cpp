@@ -10,6 +10,7 @@
 #include "hermes/Support/OSCompat.h"
 #include "hermes/Support/PageAccessTracker.h"
 #include "hermes/TypedLib/TypedLib.h"
+#include "hermes/VM/JIT/JIT.h"
 #include "hermes/VM/RuntimeFlags.h"
 
 #include "llvh/ADT/SmallString.h"
@@ -78,6 +79,24 @@ static int executeHBCBytecodeFromCL(
     return EXIT_FAILURE;
   }
 #endif
+  if (!vm::JITContext::kBackgroundCompileSupported &&
+      (flags.JITBackground || flags.JITQueueLimit.getNumOccurrences())) {
+    llvh::errs() << "JIT background compilation is not supported in this "
+                    "build\n";
+    return EXIT_FAILURE;
+  }
+  if (!vm::JITContext::kOSRSupported &&
+      flags.JITOSRThreshold.getNumOccurrences()) {
+    llvh::errs() << "JIT on-stack replacement is not supported in this "
+                    "build\n";
+    return EXIT_FAILURE;
+  }
+  if (!vm::JITContext::kRegExpCompileSupported &&
+      flags.JITRegExpThreshold.getNumOccurrences()) {
+    llvh::errs() << "JIT compilation of regexps is not supported in this "
+                    "build\n";
+    return EXIT_FAILURE;
+  }
 
   ExecuteOptions options;
 
@@ -92,7 +111,14 @@ static int executeHBCBytecodeFromCL(
                                      .build())
                              .withShouldReleaseUnused(vm::kReleaseUnusedNone)
                              .withAllocInYoung(flags.GCAllocYoung)
-                             .withRevertToYGAtTTI(flags.GCRevertToYGAtTTI);
+                             .withRevertToYGAtTTI(flags.GCRevertToYGAtTTI)
+                             .withYoungGenEvacuationThreads(
+                                 flags.GCYoungGenEvacuationThreads)
+                             .withOldGenMarkingThreads(
+                                 flags.GCOldGenMarkingThreads)
+                             .withOldGenSweepingThreads(
+                                 flags.GCOldGenSweepingThreads)
+                             .withSweepOnAllocation(flags.GCSweepOnAllocation);
 
   std::vector<vm::GCAnalyticsEvent> gcAnalyticsEvents;
   if (flags.GCPrintStats || flags.GCBeforeStats ||
@@ -117,6 +143,10 @@ static int executeHBCBytecodeFromCL(
           .withForceJIT(flags.JIT == cli::VMOnlyRuntimeFlags::JITMode::Force)
           .withJITThreshold(flags.JITThreshold)
           .withJITMemoryLimit(flags.JITMemoryLimit)
+          .withJITBackground(flags.JITBackground)
+          .withJITQueueLimit(flags.JITQueueLimit)
+          .withJITOSRThreshold(flags.JITOSRThreshold)
+          .withJITRegExpThreshold(flags.JITRegExpThreshold)
           .withEnableEval(cl::compilerRuntimeFlags.EnableEval)
           .withEnableAsyncGenerators(
               cl::compilerRuntimeFlags.EnableAsyncGenerators)
@@ -128,6 +158,7 @@ static int executeHBCBytecodeFromCL(
           .withES6Proxy(flags.ES6Proxy)
           .withIntl(flags.Intl)
           .withMicrotaskQueue(flags.MicrotaskQueue)
+          .withRegExpLinearTime(flags.RegExpLinearTime)
           .withEnableSampleProfiling(
               flags.SampleProfiling !=
               ExecuteOptions::SampleProfilingMode::None)
@@ -228,6 +259,7 @@ static vm::RuntimeConfig getReplRuntimeConfig() {
       .withEnableAsyncGenerators(cl::compilerRuntimeFlags.EnableAsyncGenerators)
       .withIntl(flags.Intl)
       .withMicrotaskQueue(flags.MicrotaskQueue)
+      .withRegExpLinearTime(flags.RegExpLinearTime)
       .withEnableHermesInternal(flags.EnableHermesInternal)
       .withEnableHermesInternalTestMethods(
           flags.EnableHermesInternalTestMethods)
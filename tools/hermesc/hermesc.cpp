@@ -46,7 +46,8 @@ int main(int argc, char **argv) {
     return EXIT_FAILURE;
   }
 
-  driver::CompileResult res = driver::compileFromCommandLineOptions();
+  driver::CompileResult res =
+      driver::compileFromCommandLineOptions({argv, (size_t)argc});
   if (res.bytecodeProvider) {
     llvh::errs() << "Execution not supported with hermesc\n";
     assert(
@@ -11,6 +11,7 @@
 #include "config.h"
 
 #include "hermes/BCGen/SH/SH.h"
+#include "hermes/Support/ParallelFor.h"
 
 #include "llvh/ADT/ScopeExit.h"
 #include "llvh/Support/Path.h"
@@ -31,14 +32,19 @@ using namespace hermes;
 
 namespace {
 
-/// Invoke the backend with the specified options. If the backend generates
-/// an error (unlikely, but possible), print the number of errors and return
-/// false.
+/// Invoke the backend with the specified options, or use the C from the
+/// compile cache if \p params has it. If the backend generates an error
+/// (unlikely, but possible), print the number of errors and return false.
 bool invokeBackend(
     Context *context,
     Module &M,
-    const BytecodeGenerationOptions &genOptions,
+    const ShermesCompileParams &params,
     llvh::raw_ostream &os) {
+  if (params.cachedC) {
+    os << params.cachedC->getBuffer();
+    return true;
+  }
+
   assert(
       context->getSourceErrorManager().getErrorCount() == 0 &&
       "backend invocation with non-zero errors");
@@ -47,7 +53,10 @@ bool invokeBackend(
     return false;
   }
 
-  sh::generateSH(&M, os, genOptions);
+  // When caching, generate into memory so the C can also be stored.
+  std::string output{};
+  llvh::raw_string_ostream outputOS{output};
+  sh::generateSH(&M, params.cache ? outputOS : os, params.genOptions);
 
   // Bail out if there were any errors during code generation.
   if (auto N = context->getSourceErrorManager().getErrorCount()) {
@@ -55,6 +64,12 @@ bool invokeBackend(
     return false;
   }
 
+  if (params.cache) {
+    outputOS.flush();
+    os << output;
+    // Failing to populate the cache does not fail the compilation.
+    params.cache->store(params.cacheKey, output);
+  }
   return true;
 }
 
@@ -93,7 +108,7 @@ bool compileToDump(
           llvh::sys::fs::F_None)) {
     return false;
   }
-  if (!invokeBackend(context, M, params.genOptions, fileOS.os()))
+  if (!invokeBackend(context, M, params, fileOS.os()))
     return false;
   return fileOS.close();
 }
@@ -113,7 +128,7 @@ bool compileToC(
   OutputStream fileOS{};
   if (!fileOS.open(outputFilename, llvh::sys::fs::F_None))
     return false;
-  if (!invokeBackend(context, M, params.genOptions, fileOS.os()))
+  if (!invokeBackend(context, M, params, fileOS.os()))
     return false;
   return fileOS.close();
 }
@@ -190,12 +205,14 @@ static void splitArgs(llvh::StringRef str, std::vector<std::string> &args) {
   }
 }
 
-/// Invoke the C compiler.
+/// Invoke the C compiler on \p inputPaths, passing it \p extraArgs after the
+/// options selecting the output level.
 bool invokeCC(
     const ShermesCompileParams &params,
     OutputLevelKind outputLevel,
-    llvh::StringRef inputPath,
-    llvh::StringRef outputPath) {
+    llvh::ArrayRef<std::string> inputPaths,
+    llvh::StringRef outputPath,
+    llvh::ArrayRef<std::string> extraArgs = {}) {
   CCCfg cfg;
   populateCCCfg(cfg);
 
@@ -209,7 +226,7 @@ bool invokeCC(
   std::vector<std::string> args{};
 
   args.emplace_back(program);
-  args.emplace_back(inputPath);
+  args.insert(args.end(), inputPaths.begin(), inputPaths.end());
 
   // Select compilation to asm, obj, binary
   switch (outputLevel) {
@@ -232,6 +249,7 @@ bool invokeCC(
     default:
       hermes_fatal("unexpected output level");
   }
+  args.insert(args.end(), extraArgs.begin(), extraArgs.end());
 
   // If CFLAGS were specified, they override our optimization level and include
   // path.
@@ -348,9 +366,11 @@ bool invokeCC(
     refArgs.emplace_back(str);
 
   if (params.verbosity) {
+    // Print the command at once, since shards are compiled concurrently.
+    std::string command{};
     for (size_t i = 0; i != refArgs.size(); ++i)
-      llvh::errs() << (i ? " " : "") << refArgs[i];
-    llvh::errs() << "\n";
+      (command += i ? " " : "") += refArgs[i];
+    llvh::errs() << command + "\n";
   }
 
   std::string errMsg;
@@ -366,8 +386,65 @@ bool invokeCC(
   return false;
 }
 
+/// Compile the shards of the generated C in \p cPath to object files in
+/// parallel, then link them into \p outputPath.
+bool compileShardsAndLink(
+    const ShermesCompileParams &params,
+    OutputLevelKind outputLevel,
+    llvh::StringRef cPath,
+    llvh::StringRef outputPath) {
+  const unsigned numShards = params.genOptions.cShards;
+  bool keepTemp = params.keepTemp == ShermesCompileParams::KeepTemp::on;
+  std::vector<std::string> objPaths{};
+  auto removeOnExit = llvh::make_scope_exit([&objPaths, keepTemp]() {
+    if (!keepTemp) {
+      for (const std::string &path : objPaths) {
+        llvh::sys::DontRemoveFileOnSignal(path);
+        ::remove(path.c_str());
+      }
+    }
+  });
+  for (unsigned shard = 0; shard != numShards; ++shard) {
+    llvh::SmallString<32> objPath;
+    if (auto EC = llvh::sys::fs::createTemporaryFile(
+            llvh::sys::path::filename(cPath), "o", objPath)) {
+      llvh::errs() << "Error creating " << objPath << ": " << EC.message()
+                   << '\n';
+      return false;
+    }
+    if (!keepTemp)
+      llvh::sys::RemoveFileOnSignal(objPath);
+    objPaths.push_back(objPath.str().str());
+  }
+
+  // Every shard is compiled by its own C compiler process, with at most
+  // ccJobs of them running at once.
+  std::unique_ptr<bool[]> compiled{new bool[numShards]()};
+  const unsigned numJobs =
+      std::min(hermes::resolveThreadCount(params.ccJobs), numShards);
+  hermes::parallelFor(numJobs, numShards, [&](size_t shard) {
+    std::vector<std::string> extraArgs{
+        "-DSHERMES_SHARD=" + std::to_string(shard)};
+    if (outputLevel == OutputLevelKind::SharedObj)
+      extraArgs.emplace_back("-fPIC");
+    compiled[shard] = invokeCC(
+        params,
+        OutputLevelKind::Obj,
+        {cPath.str()},
+        objPaths[shard],
+        extraArgs);
+  });
+  for (unsigned shard = 0; shard != numShards; ++shard) {
+    if (!compiled[shard])
+      return false;
+  }
+
+  return invokeCC(params, outputLevel, objPaths, outputPath);
+}
+
 /// Generate C source, then invoke the C compiler to compile it either to .s,
-/// .o, or an executable binary.
+/// .o, or an executable binary. If the C is split into shards, and it is
+/// linked, the shards are compiled in parallel.
 bool compileFromC(
     hermes::Context *context,
     hermes::Module &M,
@@ -420,7 +497,7 @@ bool compileFromC(
   // Emit into the temporary file.
   {
     llvh::raw_fd_ostream os{tmpFD, true};
-    if (!invokeBackend(context, M, params.genOptions, os))
+    if (!invokeBackend(context, M, params, os))
       return false;
     os.close();
     if (auto EC = os.error()) {
@@ -430,7 +507,13 @@ bool compileFromC(
     }
   }
 
-  return invokeCC(params, outputLevel, tmpPath, outputFilename);
+  if (params.genOptions.cShards > 1 &&
+      (outputLevel == OutputLevelKind::Executable ||
+       outputLevel == OutputLevelKind::SharedObj)) {
+    return compileShardsAndLink(params, outputLevel, tmpPath, outputFilename);
+  }
+  // Otherwise all the shards are compiled together.
+  return invokeCC(params, outputLevel, {tmpPath.str().str()}, outputFilename);
 }
 
 /// Compile to an executable and run it.
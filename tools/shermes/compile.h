@@ -10,6 +10,7 @@
 
 #include "hermes/AST/Context.h"
 #include "hermes/IR/IR.h"
+#include "hermes/Support/CompileCache.h"
 #include "hermes/Utils/Options.h"
 
 enum class OutputLevelKind {
@@ -56,6 +57,15 @@ struct ShermesCompileParams {
   enum class KeepTemp { off, on };
   KeepTemp keepTemp = KeepTemp::off;
   int verbosity = 0;
+  /// Maximum number of C compiler processes run at once when compiling the
+  /// shards of the generated C. Zero means one per hardware thread.
+  unsigned ccJobs = 0;
+  /// If set, the generated C taken from the compile cache. The backend is not
+  /// invoked, and the module is not used.
+  const llvh::MemoryBuffer *cachedC = nullptr;
+  /// If set, the generated C is stored in this cache under cacheKey.
+  const hermes::CompileCache *cache = nullptr;
+  std::string cacheKey{};
 
   explicit ShermesCompileParams(
       hermes::BytecodeGenerationOptions const &genOptions)
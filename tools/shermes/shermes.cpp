@@ -112,6 +112,36 @@ cl::list<std::string> LibSearchPaths(
     cl::desc("Add to the library search path and rpath"),
     cl::Prefix);
 
+static cl::opt<std::string> CompileCacheDir(
+    "compile-cache",
+    cl::desc(
+        "Cache the generated C of the whole compilation in this directory, "
+        "keyed on the command line and the files it names, and reuse it "
+        "instead of compiling when they are unchanged"),
+    cl::value_desc("dir"),
+    cl::cat(CompilerCategory));
+
+static cl::opt<unsigned> CShards(
+    "c-shards",
+    cl::desc(
+        "Split the generated C into this many translation units, which are "
+        "compiled in parallel when linking"),
+    cl::value_desc("count"),
+    cl::init(1),
+    cl::cat(CompilerCategory));
+
+static cl::opt<unsigned> CodegenThreads(
+    "j",
+    cl::desc(
+        "Number of threads for per-function register allocation and lowering, "
+        "and of C compilers run at once for -c-shards (0 means one per "
+        "hardware thread; the C compilers default to one per hardware "
+        "thread)"),
+    cl::value_desc("threads"),
+    cl::init(1),
+    cl::Prefix,
+    cl::cat(CompilerCategory));
+
 cl::opt<OptLevel> OptimizationLevel(
     cl::desc("Choose optimization level:"),
     cl::init(OptLevel::OMax),
@@ -910,7 +940,8 @@ ESTree::NodePtr parseJS(
   return parsedAST;
 }
 
-bool compileFromCommandLineOptions() {
+/// \param args the full command line, used to key the compile cache.
+bool compileFromCommandLineOptions(llvh::ArrayRef<const char *> args) {
   if (cli::OutputLevel != OutputLevelKind::Run && !cli::ExecArgs.empty()) {
     llvh::errs() << "Error: unused exec arguments\n";
     return false;
@@ -964,81 +995,107 @@ bool compileFromCommandLineOptions() {
     fileBufs.push_back(std::move(fileBuf));
   }
 
-  // TODO: support input source map.
-  ESTree::NodePtr ast = parseJS(
-      context,
-      semCtx,
-      cli::Typed ? &flowContext : nullptr,
-      declFileList,
-      std::move(fileBufs),
-      cli::InputSourceMap);
-  if (!ast) {
-    auto N = context->getSourceErrorManager().getErrorCount();
-    llvh::errs() << "Emitted " << N << " errors. exiting.\n";
-    return false;
-  }
-  if (cli::OutputLevel.getNumOccurrences() &&
-      cli::OutputLevel < OutputLevelKind::CFG) {
-    return true;
-  }
-  generateIRFromESTree(&M, semCtx, flowContext, ast);
-
-  // Bail out if there were any errors. We can't ensure that the module is in
-  // a valid state.
-  if (auto N = context->getSourceErrorManager().getErrorCount()) {
-    llvh::errs() << "Emitted " << N << " errors. exiting.\n";
-    return false;
+  // The compile cache stores the generated C of the whole compilation, so it
+  // only applies when the C is produced. The key covers the command line and
+  // the files it names, so on a hit the inputs aren't even parsed.
+  llvh::Optional<CompileCache> cache{};
+  std::string cacheKey{};
+  std::unique_ptr<llvh::MemoryBuffer> cachedC{};
+  if (!cli::CompileCacheDir.empty() &&
+      cli::OutputLevel >= OutputLevelKind::C) {
+    cache.emplace(cli::CompileCacheDir);
+    CompileCache::KeyBuilder cacheKeyBuilder{};
+    cacheKeyBuilder.addCommandLine(args, {"o", "compile-cache", "j"});
+    for (const auto &fileBuf : fileBufs) {
+      cacheKeyBuilder.add(fileBuf->getBufferIdentifier());
+      cacheKeyBuilder.add(fileBuf->getBuffer());
+    }
+    if (!cli::InputSourceMap.empty()) {
+      if (auto mapBuf = llvh::MemoryBuffer::getFile(cli::InputSourceMap))
+        cacheKeyBuilder.add((*mapBuf)->getBuffer());
+    }
+    cacheKey = cacheKeyBuilder.finish();
+    cachedC = cache->lookup(cacheKey);
   }
 
-  // Verify the IR before we run optimizations on it.
-  if (cli::compilerRuntimeFlags.VerifyIR) {
-    if (!verifyModule(M, &llvh::errs())) {
-      llvh::errs() << "IRGen produced invalid IR\n";
+  // On a hit, the C comes from the cache and the inputs are not compiled.
+  if (!cachedC) {
+    // TODO: support input source map.
+    ESTree::NodePtr ast = parseJS(
+        context,
+        semCtx,
+        cli::Typed ? &flowContext : nullptr,
+        declFileList,
+        std::move(fileBufs),
+        cli::InputSourceMap);
+    if (!ast) {
+      auto N = context->getSourceErrorManager().getErrorCount();
+      llvh::errs() << "Emitted " << N << " errors. exiting.\n";
       return false;
     }
-  }
+    if (cli::OutputLevel.getNumOccurrences() &&
+        cli::OutputLevel < OutputLevelKind::CFG) {
+      return true;
+    }
+    generateIRFromESTree(&M, semCtx, flowContext, ast);
 
-  if (!cli::CustomOptimize.empty()) {
-    if (!runCustomOptimizationPasses(M, cli::CustomOptimize)) {
-      llvh::errs() << "Invalid custom optimizations selected.\n\n"
-                   << PassManager::getCustomPassText();
+    // Bail out if there were any errors. We can't ensure that the module is in
+    // a valid state.
+    if (auto N = context->getSourceErrorManager().getErrorCount()) {
+      llvh::errs() << "Emitted " << N << " errors. exiting.\n";
       return false;
     }
-  } else {
-    // Always run the native backend optimizations.
-    runNativeBackendOptimizationPasses(M);
-
-    switch (cli::OptimizationLevel) {
-      case OptLevel::O0:
-        runNoOptimizationPasses(M);
-        break;
-      case OptLevel::Og:
-        runDebugOptimizationPasses(M);
-        break;
-      case OptLevel::Os:
-      case OptLevel::OMax:
-        runFullOptimizationPasses(M);
-        break;
+
+    // Verify the IR before we run optimizations on it.
+    if (cli::compilerRuntimeFlags.VerifyIR) {
+      if (!verifyModule(M, &llvh::errs())) {
+        llvh::errs() << "IRGen produced invalid IR\n";
+        return false;
+      }
     }
-  }
 
-  // Bail out if there were any errors during optimization.
-  if (auto N = context->getSourceErrorManager().getErrorCount()) {
-    llvh::errs() << "Emitted " << N << " errors. exiting.\n";
-    return false;
-  }
+    if (!cli::CustomOptimize.empty()) {
+      if (!runCustomOptimizationPasses(M, cli::CustomOptimize)) {
+        llvh::errs() << "Invalid custom optimizations selected.\n\n"
+                     << PassManager::getCustomPassText();
+        return false;
+      }
+    } else {
+      // Always run the native backend optimizations.
+      runNativeBackendOptimizationPasses(M);
+
+      switch (cli::OptimizationLevel) {
+        case OptLevel::O0:
+          runNoOptimizationPasses(M);
+          break;
+        case OptLevel::Og:
+          runDebugOptimizationPasses(M);
+          break;
+        case OptLevel::Os:
+        case OptLevel::OMax:
+          runFullOptimizationPasses(M);
+          break;
+      }
+    }
 
-  if (cli::OutputLevel == OutputLevelKind::IR) {
-    M.dump();
-    return true;
-  }
+    // Bail out if there were any errors during optimization.
+    if (auto N = context->getSourceErrorManager().getErrorCount()) {
+      llvh::errs() << "Emitted " << N << " errors. exiting.\n";
+      return false;
+    }
+
+    if (cli::OutputLevel == OutputLevelKind::IR) {
+      M.dump();
+      return true;
+    }
 
 #ifndef NDEBUG
-  if (cli::OutputLevel == OutputLevelKind::CFG) {
-    M.viewGraph();
-    return true;
-  }
+    if (cli::OutputLevel == OutputLevelKind::CFG) {
+      M.viewGraph();
+      return true;
+    }
 #endif
+  }
 
   BytecodeGenerationOptions genOptions{toOutputFormatKind(cli::OutputLevel)};
   genOptions.optimizationEnabled = cli::OptimizationLevel > OptLevel::Og;
@@ -1056,6 +1113,8 @@ bool compileFromCommandLineOptions() {
   //    cl::OutputSourceMap || cl::DebugInfoLevel == cl::DebugLevel::g0;
 
   genOptions.stripFunctionNames = cli::StripFunctionNames;
+  genOptions.codegenThreads = cli::CodegenThreads;
+  genOptions.cShards = cli::CShards;
 
   // If we are not exporting a unit, produce the main function.
   genOptions.emitMain = cli::ExportedUnit.empty();
@@ -1084,9 +1143,18 @@ bool compileFromCommandLineOptions() {
   params.extraCCOptions = cli::ExtraCCOptions;
   params.libs = cli::Libs;
   params.libSearchPaths = cli::LibSearchPaths;
+  // Unless -j is given, compile as many shards at once as there are hardware
+  // threads.
+  params.ccJobs =
+      cli::CodegenThreads.getNumOccurrences() ? cli::CodegenThreads : 0;
   params.keepTemp = cli::KeepTemp ? ShermesCompileParams::KeepTemp::on
                                   : ShermesCompileParams::KeepTemp::off;
   params.verbosity = cli::Verbose.getNumOccurrences();
+  params.cachedC = cachedC.get();
+  if (cache && !cachedC) {
+    params.cache = cache.getPointer();
+    params.cacheKey = std::move(cacheKey);
+  }
 
   return shermesCompile(
       context.get(),
@@ -1121,7 +1189,7 @@ int main(int argc, char **argv) {
     return 0;
   }
 
-  if (!compileFromCommandLineOptions())
+  if (!compileFromCommandLineOptions({argv, (size_t)argc}))
     return 1;
   return 0;
 }
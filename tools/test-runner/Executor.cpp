@@ -203,7 +203,11 @@ TestRuntimeEnv createTestRuntime(
           .withEnableJIT(config.runtimeFlags->JIT != JITMode::Off)
           .withForceJIT(config.runtimeFlags->JIT == JITMode::Force)
           .withJITThreshold(config.runtimeFlags->JITThreshold)
-          .withJITMemoryLimit(config.runtimeFlags->JITMemoryLimit);
+          .withJITMemoryLimit(config.runtimeFlags->JITMemoryLimit)
+          .withJITBackground(config.runtimeFlags->JITBackground)
+          .withJITQueueLimit(config.runtimeFlags->JITQueueLimit)
+          .withJITOSRThreshold(config.runtimeFlags->JITOSRThreshold)
+          .withJITRegExpThreshold(config.runtimeFlags->JITRegExpThreshold);
   if (disableHandleSan) {
     auto gcConfig =
         baseConfig.getGCConfig()
@@ -443,6 +443,124 @@ TEST(HermesRootsTest, DontGrowWhenCloneObject) {
   EXPECT_EQ(rootsDelta, 0);
 }
 
+TEST(HermesJSONTest, StringifyToSink) {
+  auto eval = [](Runtime &rt, const char *code) {
+    return rt.global().getPropertyAsFunction(rt, "eval").call(rt, code);
+  };
+  std::shared_ptr<HermesRuntime> rt = makeHermesRuntime();
+  auto jsonRt = dynamicInterfaceCast<IHermesJSON>(rt);
+  ASSERT_TRUE(jsonRt);
+
+  Value val = eval(*rt, R"(
+    var arr = [];
+    for (var i = 0; i < 1000; ++i)
+      arr.push({i: i, s: 'caf\u00e9 \ud83d\ude00', skip: undefined, n: null});
+    ({arr: arr, f: function() {}, nested: {deep: [true, false]}});
+  )");
+  std::string expected = rt->global()
+                             .getPropertyAsObject(*rt, "JSON")
+                             .getPropertyAsFunction(*rt, "stringify")
+                             .call(*rt, val)
+                             .getString(*rt)
+                             .utf8(*rt);
+
+  // Small chunks should produce many calls, and the same output.
+  std::string out;
+  size_t numChunks = 0;
+  EXPECT_TRUE(jsonRt->stringifyJSON(
+      val,
+      [&](const char *data, size_t size) {
+        out.append(data, size);
+        ++numChunks;
+      },
+      0,
+      256));
+  EXPECT_EQ(expected, out);
+  EXPECT_GT(numChunks, 100u);
+
+  // The chunk size is measured in bytes of UTF-8, even when most characters
+  // take several bytes.
+  std::vector<size_t> chunkSizes;
+  out.clear();
+  EXPECT_TRUE(jsonRt->stringifyJSON(
+      eval(*rt, "Array(200).fill('\\u4e2d'.repeat(10))"),
+      [&](const char *data, size_t size) {
+        out.append(data, size);
+        chunkSizes.push_back(size);
+      },
+      0,
+      256));
+  EXPECT_EQ(2 + 200 * 32 + 199, out.size());
+  ASSERT_GT(chunkSizes.size(), 1u);
+  for (size_t i = 0; i + 1 < chunkSizes.size(); ++i) {
+    EXPECT_GE(chunkSizes[i], 256u);
+    EXPECT_LT(chunkSizes[i], 256u + 33);
+  }
+
+  // Indentation is applied like the space argument of JSON.stringify.
+  out.clear();
+  EXPECT_TRUE(jsonRt->stringifyJSON(
+      eval(*rt, "({a: [1]})"),
+      [&](const char *data, size_t size) { out.append(data, size); },
+      2));
+  EXPECT_EQ("{\n  \"a\": [\n    1\n  ]\n}", out);
+
+  // Values with no JSON representation never call the sink.
+  EXPECT_FALSE(jsonRt->stringifyJSON(
+      Value::undefined(), [&](const char *, size_t) { FAIL(); }));
+
+  // Exceptions propagate as JSErrors.
+  EXPECT_THROW(
+      jsonRt->stringifyJSON(
+          eval(*rt, "var o = {}; o.o = o; o"), [](const char *, size_t) {}),
+      JSError);
+}
+
+TEST(HermesJSONTest, ParseFromUTF8) {
+  std::shared_ptr<HermesRuntime> rt = makeHermesRuntime();
+  auto parse = [&](const std::string &json) {
+    return Value::createFromJsonUtf8(
+        *rt, reinterpret_cast<const uint8_t *>(json.data()), json.size());
+  };
+
+  // Pure ASCII input is parsed in place.
+  Object obj = parse(R"({"a": [1, 2.5, "x\u00e9"], "b": {"c": null}})")
+                   .getObject(*rt);
+  Array a = obj.getPropertyAsObject(*rt, "a").getArray(*rt);
+  EXPECT_EQ(3u, a.size(*rt));
+  EXPECT_EQ(2.5, a.getValueAtIndex(*rt, 1).getNumber());
+  EXPECT_EQ("x\xc3\xa9", a.getValueAtIndex(*rt, 2).getString(*rt).utf8(*rt));
+  EXPECT_TRUE(
+      obj.getPropertyAsObject(*rt, "b").getProperty(*rt, "c").isNull());
+
+  // Non-ASCII input, including a supplementary character.
+  Value str = parse("[\"caf\xc3\xa9 \xf0\x9f\x98\x80\"]")
+                  .getObject(*rt)
+                  .getArray(*rt)
+                  .getValueAtIndex(*rt, 0);
+  EXPECT_EQ("caf\xc3\xa9 \xf0\x9f\x98\x80", str.getString(*rt).utf8(*rt));
+
+  // Many records of the same shape, through both the ASCII and UTF-8 paths.
+  for (const char *nonASCII : {"", "\xc3\xa9"}) {
+    std::string json = "[";
+    for (int i = 0; i < 100; ++i)
+      json += std::string(i ? "," : "") + "{\"id\":" + std::to_string(i) +
+          ",\"name\":\"n" + nonASCII + "\"}";
+    json += "]";
+    Array arr = parse(json).getObject(*rt).getArray(*rt);
+    ASSERT_EQ(100u, arr.size(*rt));
+    EXPECT_EQ(
+        99,
+        arr.getValueAtIndex(*rt, 99)
+            .getObject(*rt)
+            .getProperty(*rt, "id")
+            .getNumber());
+  }
+
+  EXPECT_THROW(parse("{\"a\": }"), JSError);
+  EXPECT_THROW(parse("[\"\xc3\xa9\""), JSError);
+}
+
 TEST(HermesWatchTimeLimitTest, WatchTimeLimit) {
   // Some code that exercies the async break checks.
   const char *forABit = "var t = Date.now(); while (Date.now() < t + 100) {}";
@@ -2109,6 +2227,45 @@ TEST_P(HermesSerializationTest, SerializePrimitives) {
   EXPECT_THROW(serializationInterface->serialize(sym), JSError);
 }
 
+TEST_P(HermesSerializationTest, SerializeLargeStrings) {
+  // Strings of external length are shared with the deserializing runtimes
+  // instead of being copied, whether they are external (repeat), buffered
+  // (concatenation) or UTF-16.
+  auto code = R"(
+var ascii = 'x'.repeat(100000);
+var concat = ascii + 'y';
+var utf16 = '\u2603'.repeat(100000);
+[ascii, concat, utf16, ascii];
+)";
+  auto serialized = evalAndSerialize(code);
+
+  // Deserialize twice, into another runtime and into the original one.
+  for (Runtime *r : {rt2.get(), rt.get(), rt2.get()}) {
+    auto *si = r == rt.get() ? serializationInterface : serializationInterface2;
+    auto arr = si->deserialize(serialized).getObject(*r).getArray(*r);
+    ASSERT_EQ(arr.size(*r), 4);
+    EXPECT_EQ(
+        arr.getValueAtIndex(*r, 0).getString(*r).utf8(*r),
+        std::string(100000, 'x'));
+    EXPECT_EQ(
+        arr.getValueAtIndex(*r, 1).getString(*r).utf8(*r),
+        std::string(100000, 'x') + "y");
+    EXPECT_EQ(
+        arr.getValueAtIndex(*r, 2).getString(*r).utf16(*r),
+        std::u16string(100000, u'\u2603'));
+    EXPECT_TRUE(String::strictEquals(
+        *r,
+        arr.getValueAtIndex(*r, 0).getString(*r),
+        arr.getValueAtIndex(*r, 3).getString(*r)));
+  }
+
+  // The original strings are unaffected, also after the serialized value is
+  // gone.
+  serialized.reset();
+  auto res = eval("ascii.length + concat.length + utf16.charCodeAt(99999)");
+  EXPECT_EQ(res.getNumber(), 100000 + 100001 + 0x2603);
+}
+
 TEST_P(HermesSerializationTest, SerializeSimpleObjectTypes) {
   auto serialized = evalAndSerialize("new Boolean(true)");
   auto deserializedObj = deserializeAsObject(serialized);
@@ -2392,6 +2549,40 @@ buffer;
   EXPECT_THROW(serializationInterface->serialize(detachedBuffer), JSError);
 }
 
+TEST_P(HermesSerializationTest, SerializeSharedArrayBuffer) {
+  // The data block of a SharedArrayBuffer is shared, not copied, with every
+  // runtime the value is deserialized into.
+  auto code = R"(
+var ia = new Int32Array(new SharedArrayBuffer(8));
+ia[0] = 1;
+ia;
+)";
+  auto serialized = evalAndSerialize(code);
+  auto ia2 = serializationInterface2->deserialize(serialized);
+  rt2->global().setProperty(*rt2, "ia2", ia2);
+  auto old = rt2->evaluateJavaScript(
+      std::make_unique<StringBuffer>(
+          "String(ia2.buffer) + Atomics.add(ia2, 0, 41)"),
+      "");
+  EXPECT_EQ(old.getString(*rt2).utf8(*rt2), "[object SharedArrayBuffer]1");
+  EXPECT_EQ(eval("ia[0]").getNumber(), 42);
+
+  // The memory stays alive as long as any runtime uses it.
+  serialized.reset();
+  eval("ia = undefined; gc();");
+  auto res = rt2->evaluateJavaScript(
+      std::make_unique<StringBuffer>("ia2[1] = 5; ia2[0] + ia2[1]"), "");
+  EXPECT_EQ(res.getNumber(), 47);
+
+  // SharedArrayBuffers cannot be transferred.
+  auto transferArr =
+      eval("var sab = new SharedArrayBuffer(4); [sab]").asObject(*rt).asArray(
+          *rt);
+  auto val = eval("sab");
+  EXPECT_THROW(
+      serializationInterface->serializeWithTransfer(val, transferArr), JSError);
+}
+
 TEST_P(HermesSerializationTest, SerializeDataView) {
   auto code = R"(
 var buffer = new ArrayBuffer(32);
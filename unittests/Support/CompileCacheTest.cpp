@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/CompileCache.h"
+
+#include "llvh/ADT/SmallString.h"
+#include "llvh/Support/FileSystem.h"
+#include "llvh/Support/Path.h"
+#include "llvh/Support/raw_ostream.h"
+
+#include "gtest/gtest.h"
+
+using namespace hermes;
+
+namespace {
+
+std::string keyFor(llvh::ArrayRef<const char *> args) {
+  CompileCache::KeyBuilder builder;
+  builder.addCommandLine(args, {"out", "j"});
+  return builder.finish();
+}
+
+TEST(CompileCacheTest, KeyDependsOnPieces) {
+  CompileCache::KeyBuilder a, b, c;
+  a.add("ab");
+  a.add("c");
+  b.add("a");
+  b.add("bc");
+  c.add("ab");
+  c.add("c");
+  std::string keyA = a.finish();
+  EXPECT_EQ(40u, keyA.size());
+  EXPECT_NE(keyA, b.finish());
+  EXPECT_EQ(keyA, c.finish());
+}
+
+TEST(CompileCacheTest, KeySkipsIgnoredOptions) {
+  std::string key = keyFor({"hermesc", "-O", "-emit-binary", "in.js"});
+  EXPECT_EQ(
+      key,
+      keyFor({"hermesc", "-O", "-out", "a.hbc", "-emit-binary", "in.js"}));
+  EXPECT_EQ(
+      key, keyFor({"hermesc", "-O", "--out=b.hbc", "-emit-binary", "in.js"}));
+  EXPECT_EQ(key, keyFor({"hermesc", "-j8", "-O", "-emit-binary", "in.js"}));
+  EXPECT_EQ(key, keyFor({"hermesc", "-O", "-j", "2", "-emit-binary", "in.js"}));
+
+  EXPECT_NE(key, keyFor({"hermesc", "-O0", "-emit-binary", "in.js"}));
+  EXPECT_NE(key, keyFor({"hermesc", "-O", "-emit-binary", "other.js"}));
+  // Only exact names (and numeric values attached to single letters) match.
+  EXPECT_NE(key, keyFor({"hermesc", "-O", "-emit-binary", "-jx", "in.js"}));
+}
+
+TEST(CompileCacheTest, KeyCoversNamedFiles) {
+  llvh::SmallString<128> tmpDir;
+  ASSERT_FALSE(
+      llvh::sys::fs::createUniqueDirectory("compile-cache-test", tmpDir));
+  llvh::SmallString<128> globals{tmpDir};
+  llvh::sys::path::append(globals, "globals.js");
+  auto writeGlobals = [&globals](llvh::StringRef contents) {
+    std::error_code EC;
+    llvh::raw_fd_ostream OS{globals, EC, llvh::sys::fs::F_None};
+    ASSERT_FALSE(EC);
+    OS << contents;
+  };
+  std::string option = ("-include-globals=" + globals).str();
+
+  writeGlobals("var a;");
+  std::string keyOption = keyFor({"hermesc", option.c_str(), "in.js"});
+  std::string keyArg = keyFor({"hermesc", globals.c_str()});
+  EXPECT_EQ(keyOption, keyFor({"hermesc", option.c_str(), "in.js"}));
+  EXPECT_EQ(keyArg, keyFor({"hermesc", globals.c_str()}));
+
+  // Editing a file named by an option value or an argument changes the key.
+  writeGlobals("var b;");
+  EXPECT_NE(keyOption, keyFor({"hermesc", option.c_str(), "in.js"}));
+  EXPECT_NE(keyArg, keyFor({"hermesc", globals.c_str()}));
+
+  llvh::sys::fs::remove_directories(tmpDir);
+}
+
+TEST(CompileCacheTest, StoreAndLookup) {
+  llvh::SmallString<128> tmpDir;
+  ASSERT_FALSE(
+      llvh::sys::fs::createUniqueDirectory("compile-cache-test", tmpDir));
+  llvh::SmallString<128> cacheDir{tmpDir};
+  llvh::sys::path::append(cacheDir, "cache");
+
+  CompileCache cache{cacheDir.str().str()};
+  EXPECT_EQ(nullptr, cache.lookup("0123"));
+  ASSERT_TRUE(cache.store("0123", "compiled output"));
+  auto buf = cache.lookup("0123");
+  ASSERT_NE(nullptr, buf);
+  EXPECT_EQ("compiled output", buf->getBuffer());
+
+  // Storing again replaces the entry.
+  ASSERT_TRUE(cache.store("0123", "new output"));
+  EXPECT_EQ("new output", cache.lookup("0123")->getBuffer());
+
+  llvh::sys::fs::remove_directories(tmpDir);
+}
+
+} // namespace
@@ -679,6 +679,56 @@ TEST(SIMD, ReverseU64VariousOffsets) {
   EXPECT_EQ(searchReverseU64(arr, 0, 5, 42), -1);
 }
 
+//===----------------------------------------------------------------------===//
+// searchAnyU8 / searchAnyU16
+//===----------------------------------------------------------------------===//
+
+TEST(SIMD, ForwardAnyU8Empty) {
+  uint8_t arr[] = {1};
+  uint8_t targets[] = {1, 2};
+  EXPECT_EQ(searchAnyU8(arr, 0, 0, targets), -1);
+}
+
+TEST(SIMD, ForwardAnyU8AllPositions) {
+  // Find each target at every offset, in the vectorized part and in the tail.
+  uint8_t targets[] = {'f', 'o', 0xFF};
+  for (uint8_t target : targets) {
+    for (size_t i = 0; i < 40; ++i) {
+      std::vector<uint8_t> arr(40, 'x');
+      arr[i] = target;
+      EXPECT_EQ(searchAnyU8(arr, 0, arr.size(), targets), (int64_t)i)
+          << "i=" << i;
+      EXPECT_EQ(searchAnyU8(arr, i + 1, arr.size(), targets), -1) << "i=" << i;
+    }
+  }
+}
+
+TEST(SIMD, ForwardAnyU8FirstOfSeveral) {
+  std::vector<uint8_t> arr(64, 0);
+  arr[50] = 3;
+  arr[20] = 4;
+  arr[30] = 1;
+  uint8_t targets[] = {1, 2, 3, 4};
+  EXPECT_EQ(searchAnyU8(arr, 0, arr.size(), targets), 20);
+  EXPECT_EQ(searchAnyU8(arr, 21, arr.size(), targets), 30);
+  EXPECT_EQ(searchAnyU8(arr, 31, 50, targets), -1);
+}
+
+TEST(SIMD, ForwardAnyU16AllPositions) {
+  uint16_t targets[] = {u'f', 0xD83D, 0x0166};
+  for (uint16_t target : targets) {
+    for (size_t i = 0; i < 40; ++i) {
+      // 0x6600 and 0x0066 share a byte with the targets.
+      std::vector<uint16_t> arr(40, i % 2 ? 0x6600 : 0x0066 + 1);
+      arr[i] = target;
+      EXPECT_EQ(searchAnyU16(arr, 0, arr.size(), targets), (int64_t)i)
+          << "i=" << i;
+      EXPECT_EQ(searchAnyU16(arr, i + 1, arr.size(), targets), -1)
+          << "i=" << i;
+    }
+  }
+}
+
 //===----------------------------------------------------------------------===//
 // scanJsonEscapeU8
 //===----------------------------------------------------------------------===//
@@ -798,4 +848,69 @@ TEST(SIMD, ScanU16HighBit) {
   EXPECT_EQ(scanJsonEscapeU16(s.data(), s.data() + s.size()), s.data() + 20);
 }
 
+//===----------------------------------------------------------------------===//
+// scanJsonNonWhitespaceU8 / scanJsonNonWhitespaceU16
+//===----------------------------------------------------------------------===//
+
+TEST(SIMD, SkipWhitespaceU8Empty) {
+  const char *p = "";
+  EXPECT_EQ(scanJsonNonWhitespaceU8(p, p), p);
+}
+
+TEST(SIMD, SkipWhitespaceU8NoWhitespace) {
+  const char *p = "{}";
+  EXPECT_EQ(scanJsonNonWhitespaceU8(p, p + 2), p);
+}
+
+TEST(SIMD, SkipWhitespaceU8AllPositions) {
+  // Find the end of the run at every offset, in the vectorized part and in the
+  // tail.
+  for (size_t i = 0; i < 40; ++i) {
+    std::string s;
+    for (size_t j = 0; j < i; ++j)
+      s += " \t\n\r"[j % 4];
+    s += '"';
+    s += std::string(20, ' ');
+    EXPECT_EQ(
+        scanJsonNonWhitespaceU8(s.data(), s.data() + s.size()), s.data() + i)
+        << "i=" << i;
+  }
+}
+
+TEST(SIMD, SkipWhitespaceU8AllWhitespace) {
+  std::string s(100, ' ');
+  EXPECT_EQ(
+      scanJsonNonWhitespaceU8(s.data(), s.data() + s.size()),
+      s.data() + s.size());
+}
+
+TEST(SIMD, SkipWhitespaceU8OtherSpaces) {
+  // Vertical tab and form feed are not JSON whitespace.
+  std::string s(20, ' ');
+  s[17] = '\v';
+  s[18] = '\f';
+  EXPECT_EQ(
+      scanJsonNonWhitespaceU8(s.data(), s.data() + s.size()), s.data() + 17);
+}
+
+TEST(SIMD, SkipWhitespaceU16AllPositions) {
+  for (size_t i = 0; i < 40; ++i) {
+    std::u16string s;
+    for (size_t j = 0; j < i; ++j)
+      s += u" \t\n\r"[j % 4];
+    s += u'\u0120'; // Same low byte as ' '.
+    s += std::u16string(20, u' ');
+    EXPECT_EQ(
+        scanJsonNonWhitespaceU16(s.data(), s.data() + s.size()), s.data() + i)
+        << "i=" << i;
+  }
+}
+
+TEST(SIMD, SkipWhitespaceU16AllWhitespace) {
+  std::u16string s(100, u'\n');
+  EXPECT_EQ(
+      scanJsonNonWhitespaceU16(s.data(), s.data() + s.size()),
+      s.data() + s.size());
+}
+
 } // namespace
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/ParallelFor.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+TEST(ParallelForTest, ResolveThreadCount) {
+  EXPECT_EQ(3u, hermes::resolveThreadCount(3));
+  EXPECT_GE(hermes::resolveThreadCount(0), 1u);
+}
+
+TEST(ParallelForTest, SingleThreadRunsInOrder) {
+  std::vector<size_t> seen;
+  auto self = std::this_thread::get_id();
+  hermes::parallelFor(1, 10, [&](size_t i) {
+    EXPECT_EQ(self, std::this_thread::get_id());
+    seen.push_back(i);
+  });
+  ASSERT_EQ(10u, seen.size());
+  for (size_t i = 0; i < seen.size(); ++i)
+    EXPECT_EQ(i, seen[i]);
+}
+
+TEST(ParallelForTest, EveryIndexVisitedOnce) {
+  constexpr size_t kCount = 1000;
+  std::vector<std::atomic<unsigned>> visits(kCount);
+  for (unsigned numThreads : {2u, 4u, 0u}) {
+    for (auto &v : visits)
+      v = 0;
+    hermes::parallelFor(numThreads, kCount, [&](size_t i) { ++visits[i]; });
+    for (size_t i = 0; i < kCount; ++i)
+      EXPECT_EQ(1u, visits[i]) << "index " << i;
+  }
+}
+
+TEST(ParallelForTest, EmptyRange) {
+  bool called = false;
+  hermes::parallelFor(4, 0, [&](size_t) { called = true; });
+  EXPECT_FALSE(called);
+}
+
+} // namespace
@@ -6,6 +6,7 @@
  */
 
 #include "hermes/Regex/Regex.h"
+#include "hermes/Platform/Unicode/CharacterProperties.h"
 #include "hermes/Regex/Executor.h"
 #include "hermes/Regex/RegexTraits.h"
 
@@ -821,4 +822,210 @@ TEST(Regex, NonASCII) {
       constants::matchInputAllAscii));
 }
 
+static bool canSearchInLinearTime(
+    const char16_t *pattern,
+    const char16_t *flags = u"") {
+  return hermes::regex::canSearchInLinearTime(
+      cregex(pattern, flags).compile());
+}
+
+TEST(Regex, LinearTimeSupport) {
+  EXPECT_TRUE(canSearchInLinearTime(u"(a|b)*c"));
+  EXPECT_TRUE(canSearchInLinearTime(u"^(\\w+\\s?)*$", u"m"));
+  EXPECT_TRUE(canSearchInLinearTime(u"(?<y>\\d{4})-(?<m>\\d{2})"));
+  EXPECT_TRUE(canSearchInLinearTime(u"[\xE9-\xFC]+\\b", u"iu"));
+  EXPECT_FALSE(canSearchInLinearTime(u"(a)\\1"));
+  EXPECT_FALSE(canSearchInLinearTime(u"a(?=b)"));
+  EXPECT_FALSE(canSearchInLinearTime(u"(?<!a)b"));
+  // Every combination of loop counts is a separate state.
+  EXPECT_TRUE(canSearchInLinearTime(u"a{0,1000}"));
+  EXPECT_FALSE(canSearchInLinearTime(u"a{0,100000}"));
+  EXPECT_FALSE(canSearchInLinearTime(u"((a{0,100}b){0,100}c){0,100}"));
+  // So is every character of a literal.
+  EXPECT_TRUE(canSearchInLinearTime(std::u16string(1000, u'x').c_str()));
+  EXPECT_FALSE(canSearchInLinearTime(std::u16string(100000, u'x').c_str()));
+}
+
+TEST(Regex, LinearTimeMatchesBacktracking) {
+  const char16_t *patterns[] = {
+      u"a([0-9]+)b",
+      u"(a|ab)(c|bcd)(d*)",
+      u"(z)((a+)?(b+)?(c))*",
+      u"(a*)*b",
+      u"(a*|b)*",
+      u"(?:(a)|b)*",
+      u"(a|)+",
+      u"(a?){2,4}b",
+      u"(?:(a)|(b)){1,3}",
+      u"(ab|abc|a)*c",
+      u"(a|b)*?b",
+      u"(a{1,2}){2}",
+      u"\\w{1,3}\\d{0,2}",
+      u"\\bb\\w*",
+      u"^a|b$",
+  };
+  const char16_t *inputs[] = {
+      u"",
+      u"a0b",
+      u"abcd",
+      u"zaacbbbcac",
+      u"aaab",
+      u"ababcbcd",
+      u"b aab ab1 abc99",
+      u"ba\nab",
+  };
+  for (const char16_t *pattern : patterns) {
+    for (const char16_t *flags : {u"", u"i", u"m", u"u"}) {
+      cregex re(pattern, flags);
+      auto bytecode = re.compile();
+      ASSERT_TRUE(hermes::regex::canSearchInLinearTime(bytecode));
+      // The linear time program is built once for all the searches below.
+      const SearchAnalysis analysis{bytecode, true};
+      for (const char16_t *input : inputs) {
+        size_t length = std::char_traits<char16_t>::length(input);
+        for (uint32_t start = 0; start <= length; ++start) {
+          cmatch expected, actual;
+          auto expectedRes = searchWithBytecode(
+              bytecode,
+              input,
+              start,
+              length,
+              &expected,
+              constants::matchDefault);
+          auto actualRes = searchWithBytecode(
+              bytecode,
+              input,
+              start,
+              length,
+              &actual,
+              constants::matchLinearTime,
+              &analysis);
+          ASSERT_EQ(expectedRes, actualRes);
+          if (expectedRes == MatchRuntimeResult::Match) {
+            EXPECT_EQ(flatten(expected), flatten(actual));
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(Regex, LinearTimePathological) {
+  // These take exponential time when backtracking.
+  const std::u16string input(5000, u'a');
+  cmatch matchRanges;
+  const auto flags = constants::matchLinearTime;
+  EXPECT_FALSE(search(input, matchRanges, cregex(u"(a|a)*b"), flags));
+  EXPECT_FALSE(search(input, matchRanges, cregex(u"(a*)*b"), flags));
+  EXPECT_TRUE(search(input, matchRanges, cregex(u"^(a|aa)+$"), flags));
+  EXPECT_EQ("(0-5000) (4999-5000)", flatten(matchRanges));
+}
+
+/// Search \p input from \p start by trying a match at each position in
+/// turn, which is done without the prefilter.
+static MatchRuntimeResult searchEachPosition(
+    llvh::ArrayRef<uint8_t> bytecode,
+    const std::u16string &input,
+    uint32_t start,
+    cmatch *m,
+    bool unicode) {
+  for (uint32_t pos = start; pos <= input.size();) {
+    auto res = searchWithBytecode(
+        bytecode,
+        input.data(),
+        pos,
+        input.size(),
+        m,
+        constants::matchOnlyAtStart);
+    if (res != MatchRuntimeResult::NoMatch)
+      return res;
+    bool pair = unicode && pos + 1 < input.size() &&
+        hermes::isHighSurrogate(input[pos]) &&
+        hermes::isLowSurrogate(input[pos + 1]);
+    pos += pair ? 2 : 1;
+  }
+  return MatchRuntimeResult::NoMatch;
+}
+
+TEST(Regex, PrefilterMatchesEachPosition) {
+  const char16_t *patterns[] = {
+      u"foo\\d+",
+      u"(?:cat|dog)s?",
+      u"[xyz]+",
+      u"[^a-y ]",
+      u"\\s\\w",
+      u"\\bbar",
+      u"(?=o)o+d",
+      u"(?<=a)b",
+      u"a*b",
+      u"(a|\\d)c",
+      u"(?:ab)+c",
+      u"K",
+      u"S",
+      u"\\uDE00",
+      u"[\\uDC00-\\uDFFF]",
+      u"\\S\\S",
+      u"x{2,}y?",
+  };
+  const std::u16string inputs[] = {
+      u"the food is foo42 and foo7 and FOO99, K",
+      u"cats and dogs and catdogs, xyzzy",
+      u"aaaaaaaaaaaaaaaaaaaaab bar kettle \u017Ftop ababc",
+      // Surrogate pairs, and lone surrogates.
+      std::u16string{
+          0xD83D, 0xDE00, ' ', 0xD83D, 0xDE00, 0xDE00, ' ', 0xD83D, 0xD83D,
+          0xDE00, ' ', 0xDE00} +
+          u" end of input",
+      u"                                   ",
+      u"0123456789abcdefghijklmnopqrstuvwxyz",
+  };
+  for (const char16_t *pattern : patterns) {
+    for (const char16_t *flags : {u"", u"i", u"u", u"iu"}) {
+      cregex re(pattern, flags);
+      auto bytecode = re.compile();
+      // The analysis is shared by every search of the regex below.
+      const SearchAnalysis analysis{bytecode, true};
+      bool unicode = std::u16string(flags).find(u'u') != std::u16string::npos;
+      for (const std::u16string &input : inputs) {
+        std::string ascii(input.begin(), input.end());
+        bool isAscii = std::u16string(ascii.begin(), ascii.end()) == input;
+        for (uint32_t start = 0; start <= input.size(); ++start) {
+          cmatch expected, actual;
+          auto expectedRes =
+              searchEachPosition(bytecode, input, start, &expected, unicode);
+          for (auto matchFlags :
+               {constants::matchDefault, constants::matchLinearTime}) {
+            auto actualRes = searchWithBytecode(
+                bytecode,
+                input.data(),
+                start,
+                input.size(),
+                &actual,
+                matchFlags,
+                &analysis);
+            ASSERT_EQ(expectedRes, actualRes);
+            if (expectedRes == MatchRuntimeResult::Match) {
+              EXPECT_EQ(flatten(expected), flatten(actual));
+            }
+            if (!isAscii)
+              continue;
+            actualRes = searchWithBytecode(
+                bytecode,
+                ascii.data(),
+                start,
+                ascii.size(),
+                &actual,
+                matchFlags | constants::matchInputAllAscii,
+                &analysis);
+            ASSERT_EQ(expectedRes, actualRes);
+            if (expectedRes == MatchRuntimeResult::Match) {
+              EXPECT_EQ(flatten(expected), flatten(actual));
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 } // end anonymous namespace
@@ -148,6 +148,22 @@ TEST(StringTest, IsAllASCIITest) {
   }
 }
 
+TEST(StringTest, IsAllASCIIUTF16Test) {
+  std::u16string ascii(40, u'a');
+  EXPECT_TRUE(isAllASCII(ascii.data(), ascii.data() + ascii.size()));
+  // Put a non-ASCII character at every position, so that it is found both in
+  // the vectorized part and the tail, for every length.
+  for (char16_t nonASCII : {u'\x80', u'\u4e2d', u'\uFFFF'}) {
+    for (size_t i = 0; i < ascii.size(); ++i) {
+      std::u16string str = ascii;
+      str[i] = nonASCII;
+      for (size_t len = 0; len <= str.size(); ++len) {
+        EXPECT_EQ(len <= i, isAllASCII(str.data(), str.data() + len));
+      }
+    }
+  }
+}
+
 TEST(UTF16StreamTest, EmptyUTF16InputTest) {
   UTF16Stream stream(llvh::ArrayRef<char16_t>{});
   EXPECT_FALSE(stream.hasChar());
@@ -624,4 +624,109 @@ TEST(LargeAllocationBigHeapTest, SuperLargeAlloc) {
   ASSERT_EQ(heapInfo.allocatedBytes, (uint64_t)size1 + size2);
 }
 
+#if HERMESVM_GCKIND == _HERMESVM_GCVALUE_HADES
+/// Test that long-lived allocations are bump allocated out of a chunk, and
+/// only rarely go back to the OG freelist.
+TEST(GCAllocChunkTest, LongLivedAllocsRefillRarely) {
+  auto runtime = DummyRuntime::create(kTestGCConfigLarge);
+  DummyRuntime &rt = *runtime;
+  GC &gc = rt.getHeap();
+
+  struct : Locals {
+    PinnedValue<DummyObject> head;
+  } lv;
+  DummyLocalsRAII lraii{rt, &lv};
+
+  GCBase::HeapInfo before;
+  gc.getHeapInfo(before);
+  static constexpr size_t kNumAllocs = 10000;
+  for (size_t i = 0; i < kNumAllocs; ++i) {
+    auto *obj = DummyObject::createLongLived(gc);
+    obj->setPointer(gc, lv.head.get());
+    lv.head = obj;
+  }
+  GCBase::HeapInfo after;
+  gc.getHeapInfo(after);
+
+  const uint64_t numAllocs =
+      after.numOldGenAllocations - before.numOldGenAllocations;
+  const uint64_t numRefills =
+      after.numOldGenAllocChunkRefills - before.numOldGenAllocChunkRefills;
+  EXPECT_GE(numAllocs, kNumAllocs);
+  EXPECT_GT(numRefills, 0u);
+  // Each chunk should hold many objects.
+  EXPECT_LT(numRefills * 50, numAllocs);
+
+  size_t length = 0;
+  for (DummyObject *obj = lv.head.get(); obj; obj = obj->other.get(rt))
+    ++length;
+  EXPECT_EQ(kNumAllocs, length);
+}
+
+/// Test that small allocations take free cells of exactly their size before
+/// refilling the chunk.
+TEST(GCAllocChunkTest, ExactFitsBeforeRefill) {
+  auto runtime = DummyRuntime::create(kTestGCConfigLarge);
+  DummyRuntime &rt = *runtime;
+  GC &gc = rt.getHeap();
+
+  struct : Locals {
+    PinnedValue<DummyObject> head;
+  } lv;
+  DummyLocalsRAII lraii{rt, &lv};
+
+  static constexpr size_t kNumAllocs = 1000;
+  for (size_t i = 0; i < 2 * kNumAllocs; ++i) {
+    auto *obj = DummyObject::createLongLived(gc);
+    obj->setPointer(gc, lv.head.get());
+    lv.head = obj;
+  }
+  // Unlink every other object, so that each of them leaves a free cell of
+  // exactly its size between two live objects.
+  for (DummyObject *obj = lv.head.get(); obj; obj = obj->other.get(rt)) {
+    DummyObject *dead = obj->other.get(rt);
+    obj->setPointer(gc, dead ? dead->other.get(rt) : nullptr);
+  }
+  rt.collect();
+
+  // Only take half of the freed cells, since a few of them may have been
+  // coalesced with neighbouring free space.
+  GCBase::HeapInfo before;
+  gc.getHeapInfo(before);
+  for (size_t i = 0; i < kNumAllocs / 2; ++i) {
+    auto *obj = DummyObject::createLongLived(gc);
+    obj->setPointer(gc, lv.head.get());
+    lv.head = obj;
+  }
+  GCBase::HeapInfo after;
+  gc.getHeapInfo(after);
+  EXPECT_GE(
+      after.numOldGenAllocations - before.numOldGenAllocations,
+      kNumAllocs / 2);
+  EXPECT_EQ(
+      before.numOldGenAllocChunkRefills, after.numOldGenAllocChunkRefills);
+}
+
+/// Test that allocations too large for the exact size buckets don't refill
+/// the chunk.
+TEST(GCAllocChunkTest, LargeAllocsDoNotRefill) {
+  auto runtime = DummyRuntime::create(kTestGCConfigLarge);
+  DummyRuntime &rt = *runtime;
+  GC &gc = rt.getHeap();
+
+  using LargeCell = EmptyCell<1024>;
+  GCBase::HeapInfo before;
+  gc.getHeapInfo(before);
+  static constexpr size_t kNumAllocs = 100;
+  for (size_t i = 0; i < kNumAllocs; ++i)
+    LargeCell::createLongLived(rt);
+  GCBase::HeapInfo after;
+  gc.getHeapInfo(after);
+  EXPECT_GE(
+      after.numOldGenAllocations - before.numOldGenAllocations, kNumAllocs);
+  EXPECT_EQ(
+      before.numOldGenAllocChunkRefills, after.numOldGenAllocChunkRefills);
+}
+#endif
+
 } // namespace
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "gtest/gtest.h"
+
+#include "GCTestHelpers.h"
+#include "VMRuntimeTestHelpers.h"
+#include "hermes/VM/DummyObject.h"
+#include "hermes/VM/GC.h"
+
+using namespace hermes::vm;
+
+namespace {
+
+using testhelpers::DummyObject;
+
+#if HERMESVM_GCKIND == _HERMESVM_GCVALUE_HADES
+
+static const GCConfig kParallelGCConfig =
+    GCConfig::Builder(kTestGCConfigLarge)
+        .withYoungGenEvacuationThreads(4)
+        .build();
+
+TEST(GCParallelEvacuationTest, ChainsFromRoots) {
+  auto runtime = DummyRuntime::create(kParallelGCConfig);
+  DummyRuntime &rt = *runtime;
+  GC &gc = rt.getHeap();
+
+  static constexpr size_t kNumChains = 32;
+  static constexpr size_t kChainLength = 2000;
+  struct : Locals {
+    PinnedValue<DummyObject> chains[kNumChains];
+  } lv;
+  DummyLocalsRAII lraii{rt, &lv};
+
+  // Interleave the chains, so that each YG collection finds many partially
+  // built chains with objects spread across the YG.
+  for (size_t i = 0; i < kChainLength; ++i) {
+    for (size_t j = 0; j < kNumChains; ++j) {
+      auto *obj = DummyObject::create(gc, rt);
+      obj->setPointer(gc, lv.chains[j].get());
+      lv.chains[j] = obj;
+    }
+  }
+  rt.collect();
+  // The workers only exist when Hades runs concurrently.
+  if (kConcurrentGC) {
+    EXPECT_LT(0u, gc.getNumParallelYoungCollections());
+    // Embedders can see how the copying was split between the workers.
+    GCBase::HeapInfo info;
+    gc.getHeapInfo(info);
+    EXPECT_EQ(
+        gc.getNumParallelYoungCollections(), info.numParallelYoungCollections);
+    ASSERT_EQ(4u, info.youngGenEvacuatedBytesPerWorker.size());
+    uint64_t evacuatedBytes = 0;
+    for (uint64_t bytes : info.youngGenEvacuatedBytesPerWorker)
+      evacuatedBytes += bytes;
+    EXPECT_LT(0u, evacuatedBytes);
+  }
+
+  for (size_t j = 0; j < kNumChains; ++j)
+    EXPECT_EQ(kChainLength, dummyChainLength(rt, lv.chains[j].get()));
+}
+
+TEST(GCParallelEvacuationTest, OldToYoungPointers) {
+  auto runtime = DummyRuntime::create(kParallelGCConfig);
+  DummyRuntime &rt = *runtime;
+  GC &gc = rt.getHeap();
+
+  static constexpr size_t kNumOld = 256;
+  static constexpr size_t kChainLength = 100;
+  struct : Locals {
+    PinnedValue<DummyObject> olds[kNumOld];
+    PinnedValue<DummyObject> young;
+  } lv;
+  DummyLocalsRAII lraii{rt, &lv};
+
+  for (size_t i = 0; i < kNumOld; ++i)
+    lv.olds[i] = DummyObject::createLongLived(gc);
+
+  // Each young chain is only reachable through a dirty card in the OG.
+  for (size_t i = 0; i < kNumOld; ++i) {
+    lv.young = nullptr;
+    for (size_t j = 0; j < kChainLength; ++j) {
+      auto *obj = DummyObject::create(gc, rt);
+      obj->setPointer(gc, lv.young.get());
+      lv.young = obj;
+    }
+    lv.olds[i]->setPointer(gc, lv.young.get());
+  }
+  lv.young = nullptr;
+  rt.collect();
+  if (kConcurrentGC)
+    EXPECT_LT(0u, gc.getNumParallelYoungCollections());
+
+  for (size_t i = 0; i < kNumOld; ++i)
+    EXPECT_EQ(kChainLength + 1, dummyChainLength(rt, lv.olds[i].get()));
+}
+
+#endif
+
+} // namespace
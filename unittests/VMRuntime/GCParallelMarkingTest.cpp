@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "gtest/gtest.h"
+
+#include "GCTestHelpers.h"
+#include "VMRuntimeTestHelpers.h"
+#include "hermes/VM/DummyObject.h"
+#include "hermes/VM/GC.h"
+
+using namespace hermes::vm;
+
+namespace {
+
+using testhelpers::DummyObject;
+
+#if HERMESVM_GCKIND == _HERMESVM_GCVALUE_HADES
+
+static const GCConfig kParallelGCConfig =
+    GCConfig::Builder(kTestGCConfigLarge)
+        .withOldGenMarkingThreads(4)
+        .build();
+
+TEST(GCParallelMarkingTest, ManyChains) {
+  auto runtime = DummyRuntime::create(kParallelGCConfig);
+  DummyRuntime &rt = *runtime;
+  GC &gc = rt.getHeap();
+
+  // Enough chains that marking starts with more than one batch of work.
+  static constexpr size_t kNumChains = 256;
+  static constexpr size_t kChainLength = 200;
+  struct : Locals {
+    PinnedValue<DummyObject> chains[kNumChains];
+  } lv;
+  DummyLocalsRAII lraii{rt, &lv};
+
+  for (size_t i = 0; i < kChainLength; ++i) {
+    for (size_t j = 0; j < kNumChains; ++j) {
+      auto *obj = DummyObject::createLongLived(gc);
+      obj->setPointer(gc, lv.chains[j].get());
+      lv.chains[j] = obj;
+    }
+  }
+
+  // Drop every other chain, and check that only those are freed.
+  for (size_t j = 0; j < kNumChains; j += 2)
+    lv.chains[j] = nullptr;
+  GCBase::HeapInfo before;
+  gc.getHeapInfo(before);
+  rt.collect();
+  GCBase::HeapInfo after;
+  gc.getHeapInfo(after);
+  EXPECT_LT(after.allocatedBytes, before.allocatedBytes);
+  // The workers only exist when Hades runs concurrently.
+  if (kConcurrentGC)
+    EXPECT_LT(0u, gc.getNumParallelMarkRounds());
+
+  for (size_t j = 1; j < kNumChains; j += 2)
+    EXPECT_EQ(kChainLength, dummyChainLength(rt, lv.chains[j].get()));
+
+  // Collect again, to make sure that nothing reachable was freed by the first
+  // collection.
+  rt.collect();
+  for (size_t j = 1; j < kNumChains; j += 2)
+    EXPECT_EQ(kChainLength, dummyChainLength(rt, lv.chains[j].get()));
+}
+
+#endif
+
+} // namespace
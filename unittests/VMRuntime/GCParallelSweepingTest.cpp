@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "gtest/gtest.h"
+
+#include "GCTestHelpers.h"
+#include "VMRuntimeTestHelpers.h"
+#include "hermes/VM/DummyObject.h"
+#include "hermes/VM/GC.h"
+
+using namespace hermes::vm;
+
+namespace {
+
+using testhelpers::DummyObject;
+
+#if HERMESVM_GCKIND == _HERMESVM_GCVALUE_HADES
+
+/// Fill several OG segments with interleaved chains, free every other chain,
+/// and then refill the freed memory, checking that the live chains are intact
+/// after each step.
+static void sweepAndReuse(const GCConfig &config) {
+  auto runtime = DummyRuntime::create(config);
+  DummyRuntime &rt = *runtime;
+  GC &gc = rt.getHeap();
+
+  static constexpr size_t kNumChains = 64;
+  static constexpr size_t kChainLength = 2000;
+  struct : Locals {
+    PinnedValue<DummyObject> chains[kNumChains];
+  } lv;
+  DummyLocalsRAII lraii{rt, &lv};
+
+  auto fillChains = [&](size_t first) {
+    for (size_t i = 0; i < kChainLength; ++i) {
+      for (size_t j = first; j < kNumChains; j += 2) {
+        auto *obj = DummyObject::createLongLived(gc);
+        obj->setPointer(gc, lv.chains[j].get());
+        lv.chains[j] = obj;
+      }
+    }
+  };
+  fillChains(0);
+  fillChains(1);
+
+  for (size_t j = 0; j < kNumChains; j += 2)
+    lv.chains[j] = nullptr;
+  GCBase::HeapInfo before;
+  gc.getHeapInfo(before);
+  rt.collect();
+  GCBase::HeapInfo after;
+  gc.getHeapInfo(after);
+  EXPECT_LT(after.allocatedBytes, before.allocatedBytes);
+  // The workers only exist when Hades runs concurrently.
+  if (kConcurrentGC)
+    EXPECT_LT(0u, gc.getNumParallelSweepRounds());
+  for (size_t j = 1; j < kNumChains; j += 2)
+    EXPECT_EQ(kChainLength, dummyChainLength(rt, lv.chains[j].get()));
+
+  fillChains(0);
+  rt.collect();
+  for (size_t j = 0; j < kNumChains; ++j)
+    EXPECT_EQ(kChainLength, dummyChainLength(rt, lv.chains[j].get()));
+}
+
+TEST(GCParallelSweepingTest, ParallelSweep) {
+  sweepAndReuse(GCConfig::Builder(kTestGCConfigExtremeLarge)
+                    .withOldGenSweepingThreads(4)
+                    .build());
+}
+
+TEST(GCParallelSweepingTest, SweepOnAllocation) {
+  sweepAndReuse(GCConfig::Builder(kTestGCConfigExtremeLarge)
+                    .withOldGenSweepingThreads(4)
+                    .withSweepOnAllocation(true)
+                    .build());
+}
+
+#endif
+
+} // namespace
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_UNITTESTS_VMRUNTIME_GCTESTHELPERS_H
+#define HERMES_UNITTESTS_VMRUNTIME_GCTESTHELPERS_H
+
+#include "hermes/VM/DummyObject.h"
+
+#include "gtest/gtest.h"
+
+namespace hermes {
+namespace vm {
+
+/// Follow the chain of DummyObjects linked through their \c other field,
+/// starting at \p obj, and check that every object in it is intact.
+/// \return the number of objects in the chain.
+inline size_t dummyChainLength(
+    PointerBase &base,
+    testhelpers::DummyObject *obj) {
+  size_t n = 0;
+  for (; obj; obj = obj->other.get(base)) {
+    if (!vmisa<testhelpers::DummyObject>(obj)) {
+      ADD_FAILURE() << "Link " << n << " of the chain is not a DummyObject";
+      break;
+    }
+    EXPECT_EQ(1u, obj->x);
+    EXPECT_EQ(2u, obj->y);
+    EXPECT_EQ(3.14, obj->hvDouble.getNumber());
+    ++n;
+  }
+  return n;
+}
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_UNITTESTS_VMRUNTIME_GCTESTHELPERS_H
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JIT/JIT.h"
+
+// Only the x86-64 backend compiles in the background.
+#if HERMESVM_JIT && (defined(__x86_64__) || defined(_M_X64))
+
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/JSObject.h"
+#include "hermes/VM/Runtime.h"
+
+#include "../VMRuntimeTestHelpers.h"
+#include "gtest/gtest.h"
+
+using namespace hermes::vm;
+
+namespace {
+
+/// Compile every function on its first call, on the background thread, with
+/// at most \p queueLimit functions in flight.
+RuntimeConfig backgroundConfig(uint32_t queueLimit) {
+  return RuntimeConfig::Builder()
+      .withGCConfig(kTestGCConfigLarge)
+      .withEnableJIT(true)
+      .withForceJIT(true)
+      .withJITBackground(true)
+      .withJITQueueLimit(queueLimit)
+      .build();
+}
+
+/// Run \p src and \return its result, which must be a number.
+double runNumber(Runtime &runtime, const char *src) {
+  hermes::hbc::CompileFlags flags;
+  auto res = runtime.run(src, "", flags);
+  EXPECT_EQ(ExecutionStatus::RETURNED, res.getStatus());
+  return res->getNumber();
+}
+
+/// \return the CodeBlock of the global function \p name.
+CodeBlock *getFunctionCodeBlock(Runtime &runtime, const char *name) {
+  GCScope gcScope{runtime};
+  auto sym = runtime.getIdentifierTable().getSymbolHandle(
+      runtime, createASCIIRef(name));
+  EXPECT_EQ(ExecutionStatus::RETURNED, sym.getStatus());
+  auto propRes =
+      JSObject::getNamed_RJS(runtime.getGlobal(), runtime, *sym.getValue());
+  EXPECT_EQ(ExecutionStatus::RETURNED, propRes.getStatus());
+  auto *func = dyn_vmcast<JSFunction>(propRes->get());
+  EXPECT_TRUE(func);
+  return func ? func->getCodeBlock() : nullptr;
+}
+
+TEST(BackgroundCompileTest, FullQueueKeepsInterpreting) {
+  auto rt = Runtime::create(backgroundConfig(0));
+  Runtime &runtime = *rt;
+  JITContext &jc = runtime.getJITContext();
+  ASSERT_TRUE(jc.getBackgroundCompile());
+
+  // Every request is rejected, so the code runs in the interpreter.
+  EXPECT_EQ(
+      5,
+      runNumber(
+          runtime,
+          "function f(x) { return x + 1; }\n"
+          "var r = 0;\n"
+          "for (var i = 0; i < 5; ++i) r = f(i);\n"
+          "r;"));
+  jc.waitForBackgroundCompiles();
+
+  const auto &stats = jc.getBackgroundCompileStats();
+  EXPECT_EQ(0, stats.numQueued);
+  // The global function and every call of f.
+  EXPECT_EQ(6, stats.numRejected);
+  EXPECT_EQ(0, stats.numCompiled);
+  CodeBlock *codeBlock = getFunctionCodeBlock(runtime, "f");
+  ASSERT_TRUE(codeBlock);
+  EXPECT_FALSE(codeBlock->getJITCompiled());
+  EXPECT_FALSE(codeBlock->getJITQueued());
+}
+
+TEST(BackgroundCompileTest, RetryAfterFullQueue) {
+  auto rt = Runtime::create(backgroundConfig(0));
+  Runtime &runtime = *rt;
+  JITContext &jc = runtime.getJITContext();
+
+  EXPECT_EQ(3, runNumber(runtime, "function f(x) { return x + 1; }\nf(2);"));
+  CodeBlock *codeBlock = getFunctionCodeBlock(runtime, "f");
+  ASSERT_TRUE(codeBlock);
+  EXPECT_FALSE(codeBlock->getJITQueued());
+
+  // Once there is room in the queue, the next call queues f again.
+  jc.setMaxQueuedCompiles(16);
+  EXPECT_EQ(4, runNumber(runtime, "f(3);"));
+  jc.waitForBackgroundCompiles();
+  EXPECT_FALSE(codeBlock->getJITQueued());
+  EXPECT_TRUE(codeBlock->getJITCompiled());
+
+  // The installed code is used by the following calls.
+  EXPECT_EQ(42, runNumber(runtime, "f(41);"));
+  jc.waitForBackgroundCompiles();
+
+  const auto &stats = jc.getBackgroundCompileStats();
+  // The first global function and f were rejected.
+  EXPECT_EQ(2, stats.numRejected);
+  // f and the two later global functions.
+  EXPECT_EQ(3, stats.numQueued);
+  EXPECT_EQ(3, stats.numCompiled);
+  EXPECT_EQ(0, stats.numFailed);
+  EXPECT_LE(stats.maxQueueDelay, stats.totalQueueDelay);
+  EXPECT_LE(stats.maxCompileTime, stats.totalCompileTime);
+
+  std::string dump;
+  llvh::raw_string_ostream os{dump};
+  jc.dumpBackgroundCompileStats(os);
+  os.flush();
+  EXPECT_NE(std::string::npos, dump.find("queued: 3\n"));
+  EXPECT_NE(std::string::npos, dump.find("rejected: 2\n"));
+  EXPECT_NE(std::string::npos, dump.find("compiled: 3\n"));
+  EXPECT_NE(std::string::npos, dump.find("failed: 0\n"));
+}
+
+} // namespace
+
+#endif // HERMESVM_JIT && x86-64
@@ -976,7 +976,7 @@ TEST_F(JSLibTest, SmallSortTest) {
        "seven",
        "eight",
        "nine"});
-  ASSERT_EQ(ExecutionStatus::RETURNED, quickSort(&sbl, 0, sbl.v.size()));
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&sbl, 0, sbl.v.size()));
   std::vector<std::string> expected = {
       "one",
       "two",
@@ -996,7 +996,7 @@ TEST_F(JSLibTest, SmallSortTest) {
     vs[i] = std::string(i, 'x');
   do {
     StringByLength sm(vs);
-    ASSERT_EQ(ExecutionStatus::RETURNED, quickSort(&sm, 0, vs.size()));
+    ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&sm, 0, vs.size()));
     for (unsigned i = 0; i < vs.size(); ++i)
       EXPECT_EQ(i, sm.v[i].size());
   } while (std::next_permutation(vs.begin(), vs.end()));
@@ -1025,7 +1025,7 @@ TEST_F(JSLibTest, HugeSortTest) {
   for (uint64_t i = 0; i < size; ++i)
     v[i] |= i;
   Uint64ByHigh32 ubh(v);
-  ASSERT_EQ(ExecutionStatus::RETURNED, quickSort(&ubh, 0, ubh.v.size()));
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&ubh, 0, ubh.v.size()));
   for (uint64_t i = 0; i < size; ++i) {
     auto cur = ubh.v[i];
     EXPECT_EQ(i / 10, cur >> 32);
@@ -1049,7 +1049,68 @@ TEST_F(JSLibTest, HugeSortTest) {
     }
   };
   RandomLess rl;
-  ASSERT_EQ(ExecutionStatus::RETURNED, quickSort(&rl, 0, 1000 * 1000));
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&rl, 0, 1000 * 1000));
+}
+
+TEST_F(JSLibTest, AdaptiveSortTest) {
+  struct CountingSort : public SortModel {
+    std::vector<int> v;
+    unsigned compares = 0;
+    unsigned swaps = 0;
+    /// Fail the comparison with this number, if non-zero.
+    unsigned failAt = 0;
+    CountingSort(std::vector<int> _v) : v(std::move(_v)) {}
+    ExecutionStatus swap(uint32_t a, uint32_t b) override {
+      ++swaps;
+      std::swap(v[a], v[b]);
+      return ExecutionStatus::RETURNED;
+    }
+    CallResult<int> compare(uint32_t a, uint32_t b) override {
+      if (++compares == failAt)
+        return ExecutionStatus::EXCEPTION;
+      return v[a] - v[b];
+    }
+  };
+  std::vector<int> ascending(1000);
+  for (unsigned i = 0; i < ascending.size(); ++i)
+    ascending[i] = i / 2;
+  std::vector<int> descending(ascending.rbegin(), ascending.rend());
+
+  // Sorted input is recognized as a single run.
+  CountingSort sorted(ascending);
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&sorted, 0, 1000));
+  EXPECT_EQ(999u, sorted.compares);
+  EXPECT_EQ(0u, sorted.swaps);
+  EXPECT_EQ(ascending, sorted.v);
+
+  // A descending run is reversed, but equal elements keep their order.
+  std::vector<int> strictlyDescending(1000);
+  for (unsigned i = 0; i < strictlyDescending.size(); ++i)
+    strictlyDescending[i] = 1000 - i;
+  CountingSort reversed(strictlyDescending);
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&reversed, 0, 1000));
+  EXPECT_EQ(999u, reversed.compares);
+  EXPECT_EQ(500u, reversed.swaps);
+  EXPECT_TRUE(std::is_sorted(reversed.v.begin(), reversed.v.end()));
+  CountingSort pairs(descending);
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&pairs, 0, 1000));
+  EXPECT_EQ(ascending, pairs.v);
+
+  // Sorting a subrange leaves the rest alone.
+  CountingSort middle(descending);
+  ASSERT_EQ(ExecutionStatus::RETURNED, timSort(&middle, 100, 900));
+  EXPECT_TRUE(std::is_sorted(middle.v.begin() + 100, middle.v.begin() + 900));
+  EXPECT_TRUE(std::equal(
+      middle.v.begin(), middle.v.begin() + 100, descending.begin()));
+  EXPECT_TRUE(std::equal(
+      middle.v.begin() + 900, middle.v.end(), descending.begin() + 900));
+
+  // A failed comparison stops the sort before any element moves.
+  CountingSort failing(descending);
+  failing.failAt = 2000;
+  ASSERT_EQ(ExecutionStatus::EXCEPTION, timSort(&failing, 0, 1000));
+  EXPECT_EQ(2000u, failing.compares);
+  EXPECT_EQ(descending, failing.v);
 }
 
 class JSLibMockedEnvironmentTest : public RuntimeTestFixtureBase {
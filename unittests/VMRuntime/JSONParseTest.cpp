@@ -9,8 +9,11 @@
 
 #include "hermes/Support/UTF16Stream.h"
 #include "hermes/VM/JSLib/RuntimeJSONParse.h"
+#include "hermes/VM/SmallXString.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <string>
 
 using namespace hermes::vm;
@@ -177,4 +180,85 @@ TEST_F(RuntimeJSONUtilsTest, LongUTF8StringValWithConversions) {
   }
 }
 
+/// \return \p src as an array of UTF-8 bytes.
+static llvh::ArrayRef<uint8_t> utf8Ref(const std::string &src) {
+  return llvh::ArrayRef<uint8_t>(
+      reinterpret_cast<const uint8_t *>(src.data()), src.size());
+}
+
+TEST_F(RuntimeJSONUtilsTest, UTF8BufferASCII) {
+  // Only the slice without the trailing garbage is parsed.
+  std::string src = R"({"prop1": 45, "x": "hi\n", "arr": [1, null]}garbage)";
+  auto srcRef = utf8Ref(src).drop_back(strlen("garbage"));
+  CallResult<HermesValue> parsedObj = runtimeJSONParseUTF8(runtime, srcRef);
+  ASSERT_FALSE(isException(parsedObj));
+  // The buffer is parsed in place, but the values must not refer to it.
+  std::fill(src.begin(), src.end(), 'X');
+
+  auto obj = Handle<JSObject>::vmcast(runtime, *parsedObj);
+  ASSERT_EQ(3, obj->getClass(runtime)->getNumProperties());
+  EXPECT_EQ(
+      45,
+      obj->getNamed_RJS(obj, runtime, symbolFor("prop1"))
+          ->getHermesValue()
+          .getDouble());
+  SmallU16String<8> x;
+  obj->getNamed_RJS(obj, runtime, symbolFor("x"))
+      ->getHermesValue()
+      .getString()
+      ->appendUTF16String(x);
+  EXPECT_EQ(createUTF16Ref(u"hi\n"), x.arrayRef());
+  auto arr = Handle<JSArray>::vmcast(
+      runtime,
+      obj->getNamed_RJS(obj, runtime, symbolFor("arr"))->getHermesValue());
+  EXPECT_EQ(2, JSArray::getLength(*arr, runtime));
+}
+
+TEST_F(RuntimeJSONUtilsTest, UTF8BufferNonASCII) {
+  // "café 😀" with a two byte and a four byte sequence.
+  std::string src = "\"caf\xc3\xa9 \xf0\x9f\x98\x80\"";
+  CallResult<HermesValue> parsedStr =
+      runtimeJSONParseUTF8(runtime, utf8Ref(src));
+  ASSERT_FALSE(isException(parsedStr));
+  SmallU16String<8> str;
+  parsedStr->getString()->appendUTF16String(str);
+  EXPECT_EQ(createUTF16Ref(u"café \U0001f600"), str.arrayRef());
+}
+
+TEST_F(RuntimeJSONUtilsTest, UTF8BufferRecords) {
+  // Many records of the same shape, through both the ASCII and UTF-8 paths.
+  for (const char *nonASCII : {"", "\xc3\xa9"}) {
+    std::string src = "[";
+    for (int i = 0; i < 100; ++i)
+      src += std::string(i ? "," : "") + "{\"id\":" + std::to_string(i) +
+          ",\"name\":\"n" + nonASCII + "\"}";
+    src += "]";
+    CallResult<HermesValue> parsedArr =
+        runtimeJSONParseUTF8(runtime, utf8Ref(src));
+    ASSERT_FALSE(isException(parsedArr));
+    auto arr = Handle<JSArray>::vmcast(runtime, *parsedArr);
+    ASSERT_EQ(100, JSArray::getLength(*arr, runtime));
+    auto last = runtime.makeHandle(
+        vmcast<JSObject>(arr->at(runtime, 99).unboxToHV(runtime)));
+    EXPECT_EQ(
+        99,
+        last->getNamed_RJS(last, runtime, symbolFor("id"))
+            ->getHermesValue()
+            .getDouble());
+  }
+}
+
+TEST_F(RuntimeJSONUtilsTest, UTF8BufferErrors) {
+  EXPECT_TRUE(isException(runtimeJSONParseUTF8(runtime, utf8Ref("{\"a\": }"))));
+  runtime.clearThrownValue();
+  EXPECT_TRUE(
+      isException(runtimeJSONParseUTF8(runtime, utf8Ref("[\"\xc3\xa9\""))));
+  runtime.clearThrownValue();
+  // The input ends before the closing bracket.
+  std::string src = "[1, 2]";
+  EXPECT_TRUE(isException(
+      runtimeJSONParseUTF8(runtime, utf8Ref(src).drop_back(1))));
+  runtime.clearThrownValue();
+}
+
 } // namespace
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "VMRuntimeTestHelpers.h"
+
+#include "hermes/Support/UTF8.h"
+#include "hermes/VM/JSLib/RuntimeJSONStringify.h"
+
+#include <string>
+#include <vector>
+
+using namespace hermes::vm;
+
+namespace {
+
+class JSONStringifyToSinkTest : public LargeHeapRuntimeTestFixture {
+ public:
+  /// Run \p src and \return its result.
+  Handle<> eval(const char *src) {
+    hermes::hbc::CompileFlags flags;
+    CallResult<HermesValue> res = runtime.run(src, "", flags);
+    EXPECT_FALSE(isException(res));
+    return runtime.makeHandle(*res);
+  }
+
+  /// \return the output of JSON.stringify for \p value and \p replacer, as
+  /// UTF-8.
+  std::string stringify(Handle<> value, Handle<> replacer) {
+    CallResult<HermesValue> res = runtimeJSONStringify(
+        runtime, value, replacer, Runtime::getUndefinedValue());
+    EXPECT_FALSE(isException(res));
+    llvh::SmallVector<char16_t, 32> utf16;
+    res->getString()->appendUTF16String(utf16);
+    std::string utf8;
+    hermes::convertUTF16ToUTF8WithReplacements(utf8, utf16);
+    return utf8;
+  }
+
+  /// Stringify \p value with \p replacer into a sink that records each chunk
+  /// in chunks.
+  CallResult<bool> stringifyToSink(
+      Handle<> value,
+      Handle<> replacer,
+      size_t chunkSize) {
+    chunks.clear();
+    return runtimeJSONStringifyToSink(
+        runtime,
+        value,
+        replacer,
+        Runtime::getUndefinedValue(),
+        [this](llvh::StringRef chunk) { chunks.push_back(chunk.str()); },
+        chunkSize);
+  }
+
+  /// \return the concatenation of the chunks passed to the sink.
+  std::string joinChunks() const {
+    std::string out;
+    for (const std::string &chunk : chunks)
+      out += chunk;
+    return out;
+  }
+
+  std::vector<std::string> chunks;
+};
+
+/// Records whose serialization is mostly rolled back properties and non-ASCII
+/// text.
+const char *kRecordsSrc = R"(
+var records = [];
+for (var i = 0; i < 2000; ++i)
+  records.push({
+    id: i,
+    skip: undefined,
+    name: 'café 😀',
+    fn: function() {},
+    nested: {a: [i, undefined, null], b: {c: undefined}},
+  });
+records;
+)";
+
+TEST_F(JSONStringifyToSinkTest, ChunksMatchStringify) {
+  Handle<> records = eval(kRecordsSrc);
+  std::string expected = stringify(records, Runtime::getUndefinedValue());
+
+  for (size_t chunkSize : {1u, 100u, 4096u, 1u << 30}) {
+    auto res =
+        stringifyToSink(records, Runtime::getUndefinedValue(), chunkSize);
+    ASSERT_FALSE(isException(res));
+    EXPECT_TRUE(*res);
+    EXPECT_EQ(expected, joinChunks());
+    // Every chunk ends right after a committed element, so it reaches the
+    // chunk size, except possibly for the last one.
+    for (size_t i = 0; i + 1 < chunks.size(); ++i)
+      EXPECT_LE(chunkSize, chunks[i].size());
+    if (chunkSize < expected.size())
+      EXPECT_LT(1u, chunks.size());
+  }
+}
+
+TEST_F(JSONStringifyToSinkTest, ReplacerRollback) {
+  Handle<> records = eval(kRecordsSrc);
+  // Drop every other record's name, and everything in the last record, after
+  // the preceding records may already have been flushed.
+  Handle<> replacer = eval(R"(
+(function(key, value) {
+  if (this === records[records.length - 1] && key !== '') return undefined;
+  return key === 'name' && this.id % 2 ? undefined : value;
+});
+)");
+  std::string expected = stringify(records, replacer);
+  EXPECT_NE(std::string::npos, expected.find("{\"id\":0,\"name\""));
+  EXPECT_NE(std::string::npos, expected.find("{\"id\":1,\"nested\""));
+  EXPECT_EQ(",{}]", expected.substr(expected.size() - 4));
+
+  auto res = stringifyToSink(records, replacer, 64);
+  ASSERT_FALSE(isException(res));
+  EXPECT_EQ(expected, joinChunks());
+}
+
+TEST_F(JSONStringifyToSinkTest, ThrowInTheMiddle) {
+  Handle<> records = eval(kRecordsSrc);
+  std::string expected = stringify(records, Runtime::getUndefinedValue());
+  Handle<> replacer = eval(R"(
+(function(key, value) {
+  if (key === 'nested' && this.id === 1500) throw new Error('stop');
+  return value;
+});
+)");
+
+  auto res = stringifyToSink(records, replacer, 256);
+  ASSERT_TRUE(isException(res));
+  runtime.clearThrownValue();
+  // The output before the exception was flushed, and is a prefix of the full
+  // output.
+  std::string partial = joinChunks();
+  EXPECT_LT(0u, partial.size());
+  EXPECT_EQ(0u, expected.compare(0, partial.size(), partial));
+
+  // The next call starts from scratch.
+  res = stringifyToSink(records, Runtime::getUndefinedValue(), 256);
+  ASSERT_FALSE(isException(res));
+  EXPECT_EQ(expected, joinChunks());
+}
+
+TEST_F(JSONStringifyToSinkTest, NoRepresentation) {
+  auto res = stringifyToSink(
+      Runtime::getUndefinedValue(), Runtime::getUndefinedValue(), 1);
+  ASSERT_FALSE(isException(res));
+  EXPECT_FALSE(*res);
+  EXPECT_TRUE(chunks.empty());
+}
+
+} // namespace
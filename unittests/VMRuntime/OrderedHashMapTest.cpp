@@ -9,6 +9,8 @@
 
 #include "VMRuntimeTestHelpers.h"
 
+#include <algorithm>
+
 using namespace hermes::vm;
 
 namespace {
@@ -232,4 +234,80 @@ TEST_F(OrderedHashMapTest, IteratorAdjustmentNormalCase) {
   EXPECT_EQ(newEntry, visited[expectedCount - 1]);
 }
 
+/// Test a rehash that only compacts the data table: when at least half of the
+/// entries are deleted, the buckets are renumbered in place and iterators are
+/// adjusted as in any other rehash.
+TEST_F(OrderedHashMapTest, IteratorAdjustmentOnCompaction) {
+  auto set = createSet(runtime);
+
+  for (uint32_t i = 0; i < kInitialRehashThreshold; ++i) {
+    setAdd(set, runtime, i);
+  }
+
+  // Advance the iterator to entry 2.
+  auto iterCtx = set->newIterator(runtime);
+  for (uint32_t i = 0; i <= 2; ++i) {
+    ASSERT_TRUE(set->advanceIterator(runtime, iterCtx));
+  }
+  EXPECT_EQ(2.0, set->iteratorKey(runtime, iterCtx).getNumber());
+
+  // Delete the even entries, which is half of them, then insert a new entry.
+  for (uint32_t i = 0; i < kInitialRehashThreshold; i += 2) {
+    ASSERT_TRUE(setDelete(set, runtime, i));
+  }
+  const double newEntry = 100;
+  setAdd(set, runtime, newEntry);
+
+  std::vector<double> visited;
+  while (set->advanceIterator(runtime, iterCtx)) {
+    visited.push_back(set->iteratorKey(runtime, iterCtx).getNumber());
+  }
+  std::vector<double> expected;
+  for (uint32_t i = 3; i < kInitialRehashThreshold; i += 2) {
+    expected.push_back(i);
+  }
+  expected.push_back(newEntry);
+  EXPECT_EQ(expected, visited);
+}
+
+/// Insert and delete keys at random, and check that lookups and the iteration
+/// order agree with a simple model, across deletions, compactions, and grow
+/// and shrink rehashes.
+TEST_F(OrderedHashMapTest, RandomOperations) {
+  auto set = createSet(runtime);
+  // The keys in insertion order.
+  std::vector<double> model;
+  uint32_t seed = 1;
+  for (uint32_t op = 0; op < 20000; ++op) {
+    seed = seed * 1103515245 + 12345;
+    // Bias towards insertion for the first half, then towards deletion.
+    const bool insert = (seed >> 16) % 8 < (op < 10000 ? 5u : 3u);
+    const double key = (seed >> 4) % 512;
+    auto it = std::find(model.begin(), model.end(), key);
+    if (insert) {
+      setAdd(set, runtime, key);
+      if (it == model.end())
+        model.push_back(key);
+    } else {
+      EXPECT_EQ(it != model.end(), setDelete(set, runtime, key));
+      if (it != model.end())
+        model.erase(it);
+    }
+    if (op % 1000 == 0) {
+      ASSERT_EQ(model.size(), set->size());
+      for (uint32_t k = 0; k < 512; ++k) {
+        EXPECT_EQ(
+            std::find(model.begin(), model.end(), k) != model.end(),
+            set->has(runtime, HermesValue::encodeTrustedNumberValue(k)));
+      }
+      std::vector<double> visited;
+      auto iterCtx = set->newIterator(runtime);
+      while (set->advanceIterator(runtime, iterCtx)) {
+        visited.push_back(set->iteratorKey(runtime, iterCtx).getNumber());
+      }
+      EXPECT_EQ(model, visited);
+    }
+  }
+}
+
 } // namespace
@@ -7,6 +7,8 @@
 
 #include "hermes/VM/PropertyCache.h"
 
+#include "VMRuntimeTestHelpers.h"
+
 #include "gtest/gtest.h"
 
 using namespace hermes::vm;
@@ -29,4 +31,72 @@ TEST(PropertyCacheTest, WritePropertyCacheTest) {
   EXPECT_EQ(0x5abacc, entry.getAddCacheIndex());
 }
 
+using PolymorphicPropertyCacheTest = RuntimeTestFixture;
+
+static CallResult<HermesValue> eval(Runtime &runtime, llvh::StringRef code) {
+  hermes::hbc::CompileFlags flags;
+  return runtime.run(code, "", flags);
+}
+
+TEST_F(PolymorphicPropertyCacheTest, PolymorphicSites) {
+  static const char *const kCode = R"(
+    function get(o) { return o.x; }
+    function set(o, v) { o.x = v; }
+    var objs = [{x: 0}, {a: 0, x: 0}, {b: 0, x: 0}];
+    var sum = 0;
+    for (var i = 0; i < 300; ++i) {
+      var o = objs[i % 3];
+      set(o, i);
+      sum += get(o);
+    }
+    sum;
+  )";
+  auto res = eval(runtime, kCode);
+  ASSERT_EQ(ExecutionStatus::RETURNED, res.getStatus());
+  EXPECT_EQ(44850, res->getNumber());
+
+  auto stats = runtime.getPolyPropCache().getStats();
+  // Both the read and the write of o.x see three classes.
+  EXPECT_GE(stats.numPolymorphicSites, 2u);
+  EXPECT_EQ(0u, stats.numMegamorphicSites);
+  EXPECT_GE(stats.polyHits, 2u * 190);
+}
+
+TEST_F(PolymorphicPropertyCacheTest, MegamorphicSites) {
+  static const char *const kCode = R"(
+    function make(k) {
+      var o = {};
+      o['p' + k] = 0;
+      o.x = 0;
+      return o;
+    }
+    function get(o) { return o.x; }
+    function set(o, v) { o.x = v; }
+    var objs = [];
+    for (var k = 0; k < 16; ++k)
+      objs.push(make(k));
+    var sum = 0;
+    for (var i = 0; i < 1600; ++i) {
+      var o = objs[i % 16];
+      set(o, 1);
+      sum += get(o);
+    }
+    sum;
+  )";
+  auto res = eval(runtime, kCode);
+  ASSERT_EQ(ExecutionStatus::RETURNED, res.getStatus());
+  EXPECT_EQ(1600, res->getNumber());
+
+  auto stats = runtime.getPolyPropCache().getStats();
+  EXPECT_GE(stats.numMegamorphicSites, 2u);
+  EXPECT_GT(stats.megaHits, 0u);
+
+  // The caches only hold classes weakly, and must remain valid after the
+  // classes they hold have been collected.
+  runtime.collect("test");
+  res = eval(runtime, kCode);
+  ASSERT_EQ(ExecutionStatus::RETURNED, res.getStatus());
+  EXPECT_EQ(1600, res->getNumber());
+}
+
 } // namespace
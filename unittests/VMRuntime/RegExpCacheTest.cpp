@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/RegExpCache.h"
+#include "hermes/VM/JSArray.h"
+#include "hermes/VM/JSRegExp.h"
+
+#include "VMRuntimeTestHelpers.h"
+
+#include "gtest/gtest.h"
+
+using namespace hermes::vm;
+
+namespace {
+
+static RegExpCache::Entry makeEntry(uint8_t tag) {
+  RegExpCache::Entry entry;
+  entry.bytecode = SharedRegExpBytecode::fromVector({tag, tag, tag});
+  return entry;
+}
+
+TEST(RegExpCacheTest, LookupAndEvict) {
+  RegExpCache cache{2};
+  llvh::ArrayRef<char16_t> a{u"a", 1}, b{u"b", 1}, c{u"c", 1};
+
+  EXPECT_EQ(nullptr, cache.lookup(a, 0));
+  ASSERT_NE(nullptr, cache.insert(a, 0, makeEntry(1)));
+  ASSERT_NE(nullptr, cache.insert(a, 1, makeEntry(2)));
+  EXPECT_EQ(2u, cache.size());
+
+  // The same pattern with different flags is a different entry.
+  EXPECT_EQ(1, cache.lookup(a, 0)->bytecode.get()[0]);
+  EXPECT_EQ(2, cache.lookup(a, 1)->bytecode.get()[0]);
+
+  // (a, 0) is now the least recently used, and is evicted first.
+  ASSERT_NE(nullptr, cache.insert(b, 0, makeEntry(3)));
+  EXPECT_EQ(nullptr, cache.lookup(a, 0));
+  ASSERT_NE(nullptr, cache.lookup(a, 1));
+  ASSERT_NE(nullptr, cache.insert(c, 0, makeEntry(4)));
+  EXPECT_EQ(nullptr, cache.lookup(b, 0));
+  EXPECT_EQ(4, cache.lookup(c, 0)->bytecode.get()[0]);
+  EXPECT_EQ(2u, cache.size());
+
+  auto &stats = cache.getStats();
+  EXPECT_EQ(4u, stats.hits);
+  EXPECT_EQ(3u, stats.misses);
+  EXPECT_EQ(2u, stats.evictions);
+  EXPECT_GT(cache.getMemorySize(), 0u);
+}
+
+TEST(RegExpCacheTest, LongPatternsAreNotCached) {
+  RegExpCache cache;
+  std::u16string pattern(RegExpCache::kMaxPatternLength + 1, u'x');
+  auto entry = makeEntry(1);
+  EXPECT_EQ(
+      nullptr,
+      cache.insert({pattern.data(), pattern.size()}, 0, std::move(entry)));
+  // The entry is left for the caller to use.
+  EXPECT_EQ(3u, entry.bytecode.size);
+  EXPECT_EQ(0u, cache.size());
+}
+
+using RegExpCacheRuntimeTest = RuntimeTestFixture;
+
+TEST_F(RegExpCacheRuntimeTest, ConstructorSharesCompiledPatterns) {
+  auto &cache = runtime.getRegExpCache();
+  auto statsBefore = cache.getStats();
+  hermes::hbc::CompileFlags flags;
+  auto res = runtime.run(
+      R"(
+        var count = 0;
+        for (var i = 0; i < 100; ++i) {
+          var re = new RegExp('(?<word>\\w+)-' + (i % 4), 'g');
+          var m = re.exec('abc-' + (i % 4));
+          if (m && m.groups.word === 'abc') ++count;
+        }
+        count;
+      )",
+      "",
+      flags);
+  ASSERT_EQ(ExecutionStatus::RETURNED, res.getStatus());
+  EXPECT_EQ(100, res->getNumber());
+
+  // Each of the four patterns is compiled once.
+  auto &stats = cache.getStats();
+  EXPECT_EQ(4u, stats.misses - statsBefore.misses);
+  EXPECT_EQ(96u, stats.hits - statsBefore.hits);
+}
+
+TEST_F(RegExpCacheRuntimeTest, RegExpsShareBytecode) {
+  hermes::hbc::CompileFlags flags;
+  auto res = runtime.run(
+      R"(
+        function literal() { return /c+d/g; }
+        [new RegExp('a+b', 'g'), new RegExp('a+b', 'g'), literal(), literal()];
+      )",
+      "",
+      flags);
+  ASSERT_EQ(ExecutionStatus::RETURNED, res.getStatus());
+  auto *arr = vmcast<JSArray>(*res);
+  auto bytecode = [&](uint32_t i) {
+    return JSRegExp::getBytecode(
+               vmcast<JSRegExp>(arr->at(runtime, i).getObject(runtime)))
+        .data();
+  };
+
+  // Neither the cached pattern nor the literal is copied per RegExp.
+  EXPECT_EQ(bytecode(0), bytecode(1));
+  EXPECT_EQ(bytecode(2), bytecode(3));
+  EXPECT_NE(bytecode(0), bytecode(2));
+}
+
+} // namespace
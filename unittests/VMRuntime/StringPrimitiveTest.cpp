@@ -5,6 +5,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include "hermes/VM/Operations.h"
 #include "hermes/VM/StringPrimitive.h"
 #include "hermes/VM/StringView.h"
 
@@ -279,11 +280,9 @@ TEST_F(StringPrimTest, FastConcatTest) {
   // Append some the first result again.
   cr = StringPrimitive::concat(runtime, resASCII_1, b);
   ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
-  auto resASCII_3 = runtime.makeHandle<BufferedASCIIStringPrimitive>(*cr);
 
-  // The buffer cannot be reused.
-  EXPECT_TRUE(
-      resASCII_3->testGetConcatBuffer() != resASCII_1->testGetConcatBuffer());
+  // The buffer cannot be reused, so a rope is created instead.
+  auto resASCII_3 = runtime.makeHandle<RopeASCIIStringPrimitive>(*cr);
 
   std::string asciiStr3 = asciiStr1 + strB;
   asciiRef = resASCII_3->getStringRef<char>();
@@ -325,15 +324,137 @@ TEST_F(StringPrimTest, FastConcatTest) {
   // Add some more UTF16 to resUTF_1
   cr = StringPrimitive::concat(runtime, resUTF_1, b);
   ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
-  auto resUTF_3 = runtime.makeHandle<BufferedUTF16StringPrimitive>(*cr);
 
-  // The buffer cannot be reused.
-  EXPECT_TRUE(
-      resUTF_1->testGetConcatBuffer() != resUTF_3->testGetConcatBuffer());
+  // The buffer cannot be reused, so a rope is created instead.
+  auto resUTF_3 = runtime.makeHandle<RopeUTF16StringPrimitive>(*cr);
 
   std::u16string utfStr3 = utfStr1 + strC;
   utf16Ref = resUTF_3->getStringRef<char16_t>();
   EXPECT_TRUE(utf16Ref.size() == utfStr3.size());
   EXPECT_TRUE(std::equal(utfStr3.begin(), utfStr3.end(), utf16Ref.begin()));
 }
+
+TEST_F(StringPrimTest, RopeConcatTest) {
+  auto concat = [this](
+                    Handle<StringPrimitive> a,
+                    Handle<StringPrimitive> b) -> Handle<StringPrimitive> {
+    auto cr = StringPrimitive::concat(runtime, a, b);
+    EXPECT_NE(ExecutionStatus::EXCEPTION, cr);
+    return runtime.makeHandle<StringPrimitive>(*cr);
+  };
+  std::string bigStr(300, 'a');
+  auto big = StringPrimitive::createNoThrow(runtime, bigStr);
+  auto small = StringPrimitive::createNoThrow(runtime, "xy");
+
+  //=======================================
+  // Prepending a short string to a long one creates a rope.
+  auto rope = concat(small, big);
+  ASSERT_TRUE(vmisa<RopeASCIIStringPrimitive>(rope.get()));
+  EXPECT_FALSE(rope->isFlat());
+
+  // Prepending to and appending to a rope create deeper ropes.
+  std::string expected = "xy" + bigStr;
+  for (int i = 0; i < 10; ++i) {
+    rope = concat(small, rope);
+    rope = concat(rope, small);
+    expected = "xy" + expected + "xy";
+  }
+  auto *ropeCell = vmcast<RopeASCIIStringPrimitive>(rope.get());
+  EXPECT_EQ(21u, ropeCell->getDepth());
+
+  // Accessing the characters flattens the rope.
+  EXPECT_EQ(expected.size(), rope->getStringLength());
+  EXPECT_EQ('x', rope->at(expected.size() - 2));
+  EXPECT_TRUE(rope->isFlat());
+  EXPECT_EQ(0u, ropeCell->getDepth());
+  auto ref = rope->getStringRef<char>();
+  EXPECT_EQ(expected, std::string(ref.begin(), ref.end()));
+
+  // A flattened rope is a leaf when concatenated.
+  auto rope2 = concat(small, rope);
+  EXPECT_EQ(1u, vmcast<RopeASCIIStringPrimitive>(rope2.get())->getDepth());
+  StringPrimitive::ensureFlat(runtime, rope2);
+  EXPECT_TRUE(rope2->isFlat());
+
+  //=======================================
+  // Mixing ASCII and UTF16 creates a UTF16 rope.
+  std::u16string utf16Str(u"\u1234z");
+  auto utf16 = StringPrimitive::createNoThrow(
+      runtime, UTF16Ref(utf16Str.data(), utf16Str.size()));
+  auto utf16Rope = concat(utf16, concat(small, big));
+  ASSERT_TRUE(vmisa<RopeUTF16StringPrimitive>(utf16Rope.get()));
+  std::u16string utf16Expected = utf16Str + u"xy";
+  utf16Expected.append(bigStr.begin(), bigStr.end());
+  auto utf16Ref = utf16Rope->getStringRef<char16_t>();
+  EXPECT_EQ(utf16Expected, std::u16string(utf16Ref.begin(), utf16Ref.end()));
+
+  //=======================================
+  // Ropes don't grow deeper than MAX_ROPE_DEPTH.
+  MutableHandle<StringPrimitive> deep{runtime, concat(small, big).get()};
+  std::string deepExpected = "xy" + bigStr;
+  for (uint32_t i = 0; i < StringPrimitive::MAX_ROPE_DEPTH + 10; ++i) {
+    GCScopeMarkerRAII marker{runtime};
+    deep = concat(small, deep).get();
+    deepExpected = "xy" + deepExpected;
+    if (auto *cell = dyn_vmcast<RopeASCIIStringPrimitive>(deep.get())) {
+      EXPECT_LE(cell->getDepth(), StringPrimitive::MAX_ROPE_DEPTH);
+    }
+  }
+  ref = deep->getStringRef<char>();
+  EXPECT_EQ(deepExpected, std::string(ref.begin(), ref.end()));
+}
+
+TEST_F(StringPrimTest, RopeFlattenedBeforeCompare) {
+  auto concat = [this](
+                    Handle<StringPrimitive> a,
+                    Handle<StringPrimitive> b) -> Handle<StringPrimitive> {
+    auto cr = StringPrimitive::concat(runtime, a, b);
+    EXPECT_NE(ExecutionStatus::EXCEPTION, cr);
+    return runtime.makeHandle<StringPrimitive>(*cr);
+  };
+  auto externalBytes = [this]() {
+    GCBase::HeapInfo info;
+    runtime.getHeap().getHeapInfo(info);
+    return info.externalBytes;
+  };
+  std::string bigStr(300, 'a');
+  auto big = StringPrimitive::createNoThrow(runtime, bigStr);
+  auto small = StringPrimitive::createNoThrow(runtime, "xy");
+  auto flat = StringPrimitive::createNoThrow(runtime, "xy" + bigStr);
+
+  // Comparing with a runtime flattens the ropes first, crediting the buffers
+  // as external memory.
+  auto rope1 = concat(small, big);
+  auto rope2 = concat(small, big);
+  ASSERT_FALSE(rope1->isFlat());
+  ASSERT_FALSE(rope2->isFlat());
+  auto before = externalBytes();
+  EXPECT_TRUE(strictEqualityTest(
+      runtime, rope1.getHermesValue(), rope2.getHermesValue()));
+  EXPECT_TRUE(rope1->isFlat());
+  EXPECT_TRUE(rope2->isFlat());
+  EXPECT_GE(externalBytes(), before + 2 * (bigStr.size() + 2));
+
+  auto rope3 = concat(small, big);
+  before = externalBytes();
+  EXPECT_EQ(0, rope3->compare(runtime, flat.get()));
+  EXPECT_TRUE(rope3->isFlat());
+  EXPECT_GE(externalBytes(), before + bigStr.size() + 2);
+
+  auto rope4 = concat(small, big);
+  before = externalBytes();
+  EXPECT_TRUE(flat->equals(runtime, rope4.get()));
+  EXPECT_TRUE(rope4->isFlat());
+  EXPECT_GE(externalBytes(), before + bigStr.size() + 2);
+
+  // A rope flattened by a const accessor is accounted for by the next
+  // ensureFlat().
+  auto rope5 = concat(small, big);
+  before = externalBytes();
+  EXPECT_EQ('x', rope5->at(0));
+  EXPECT_TRUE(rope5->isFlat());
+  EXPECT_EQ(before, externalBytes());
+  StringPrimitive::ensureFlat(runtime, rope5);
+  EXPECT_GE(externalBytes(), before + bigStr.size() + 2);
+}
 } // namespace